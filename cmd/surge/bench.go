@@ -0,0 +1,363 @@
+package main
+
+import (
+	"bytes"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"time"
+
+	"github.com/spf13/cobra"
+
+	"surge/internal/buildpipeline"
+	"surge/internal/project"
+)
+
+// benchDefaultTimeoutSeconds replaces the global 30 second --timeout default for surge
+// bench, which builds and runs every probe several times.
+const benchDefaultTimeoutSeconds = 1800
+
+// benchConfig is the optional [bench] section of a probe's surge.toml.
+type benchConfig struct {
+	Args []string `toml:"args"`
+	Env  []string `toml:"env"`
+	Skip string   `toml:"skip"`
+}
+
+var benchCmd = &cobra.Command{
+	Use:   "bench [flags] [probe...]",
+	Short: "Run native benchmark probes and compare them with a baseline",
+	Long: `Build every probe directory under --dir in release mode with the LLVM backend, run
+each one --warmup times unmeasured and --runs times measured, and write per-metric
+percentiles with machine metadata as JSON. When a baseline report exists, the p50 of
+each metric is compared with it and the command fails if any metric regressed beyond
+its threshold. Probes print timings as "name_us=N", "| name | iter | us | ns_op |"
+rows, or "word key=value ... us=N" records.`,
+	Args: cobra.ArbitraryArgs,
+	RunE: benchExecution,
+}
+
+func init() {
+	benchCmd.Flags().String("dir", filepath.Join("benchmarks", "native"), "directory that holds the probe projects")
+	benchCmd.Flags().Int("runs", 5, "measured runs per probe")
+	benchCmd.Flags().Int("warmup", 1, "unmeasured runs per probe before measuring")
+	benchCmd.Flags().String("out", filepath.Join("target", "bench", "native.json"), "write the JSON report to this path")
+	benchCmd.Flags().String("baseline", "", "baseline report to compare against (default <dir>/baseline.json)")
+	benchCmd.Flags().Bool("save-baseline", false, "write this run as the new baseline instead of comparing")
+	benchCmd.Flags().Float64("threshold", 10, "allowed p50 regression in percent")
+	benchCmd.Flags().StringArray("metric-threshold", nil, "per-metric threshold <probe/metric=percent> (repeatable)")
+	benchCmd.Flags().Float64("min-delta-us", 50, "ignore p50 changes smaller than this many microseconds")
+	benchCmd.Flags().String("lto", "off", "link the native runtime as bitcode with LTO (off, thin, full)")
+}
+
+type benchOptions struct {
+	dir          string
+	probes       []string
+	runs         int
+	warmup       int
+	outPath      string
+	baselinePath string
+	saveBaseline bool
+	lto          buildpipeline.LTOMode
+	limits       benchThresholds
+}
+
+func benchExecution(cmd *cobra.Command, args []string) error {
+	opts, err := readBenchOptions(cmd, args)
+	if err != nil {
+		return err
+	}
+	out := cmd.OutOrStdout()
+
+	dirs, err := discoverBenchProbes(opts.dir, opts.probes)
+	if err != nil {
+		return err
+	}
+	report := &benchReport{
+		Version: benchReportVersion,
+		Machine: collectBenchMachine(),
+		Config:  benchRunConfig{Runs: opts.runs, Warmup: opts.warmup, LTO: string(opts.lto)},
+		Probes:  make([]benchProbeResult, 0, len(dirs)),
+	}
+	for _, dir := range dirs {
+		result, runErr := runBenchProbe(cmd, out, dir, &opts)
+		if runErr != nil {
+			return runErr
+		}
+		report.Probes = append(report.Probes, result)
+	}
+
+	if err = writeBenchReport(opts.outPath, report); err != nil {
+		return fmt.Errorf("failed to write bench report: %w", err)
+	}
+	if _, err = fmt.Fprintf(out, "wrote %s\n", opts.outPath); err != nil {
+		return err
+	}
+
+	if opts.saveBaseline {
+		if err = writeBenchReport(opts.baselinePath, report); err != nil {
+			return fmt.Errorf("failed to write baseline: %w", err)
+		}
+		_, err = fmt.Fprintf(out, "saved baseline %s\n", opts.baselinePath)
+		return err
+	}
+	baseline, err := readBenchReport(opts.baselinePath)
+	if errors.Is(err, os.ErrNotExist) {
+		_, err = fmt.Fprintf(out, "no baseline at %s; rerun with --save-baseline to record one\n", opts.baselinePath)
+		return err
+	}
+	if err != nil {
+		return err
+	}
+	if baseline.Machine.CPUModel != report.Machine.CPUModel || baseline.Machine.CPUs != report.Machine.CPUs {
+		if _, err = fmt.Fprintf(out, "warning: baseline was recorded on %q with %d CPUs\n",
+			baseline.Machine.CPUModel, baseline.Machine.CPUs); err != nil {
+			return err
+		}
+	}
+	deltas := compareBenchReports(baseline, report, opts.limits)
+	if err = renderBenchDeltas(out, deltas); err != nil {
+		return err
+	}
+	if n := countBenchRegressions(deltas); n > 0 {
+		return fmt.Errorf("%d benchmark metric(s) regressed against %s", n, opts.baselinePath)
+	}
+	return nil
+}
+
+func readBenchOptions(cmd *cobra.Command, args []string) (benchOptions, error) {
+	flags := cmd.Flags()
+	opts := benchOptions{probes: args}
+	var err error
+	if opts.dir, err = flags.GetString("dir"); err != nil {
+		return opts, err
+	}
+	if opts.runs, err = flags.GetInt("runs"); err != nil {
+		return opts, err
+	}
+	if opts.warmup, err = flags.GetInt("warmup"); err != nil {
+		return opts, err
+	}
+	if opts.outPath, err = flags.GetString("out"); err != nil {
+		return opts, err
+	}
+	if opts.baselinePath, err = flags.GetString("baseline"); err != nil {
+		return opts, err
+	}
+	if opts.saveBaseline, err = flags.GetBool("save-baseline"); err != nil {
+		return opts, err
+	}
+	if opts.limits.Default, err = flags.GetFloat64("threshold"); err != nil {
+		return opts, err
+	}
+	if opts.limits.MinDelta, err = flags.GetFloat64("min-delta-us"); err != nil {
+		return opts, err
+	}
+	overrides, err := flags.GetStringArray("metric-threshold")
+	if err != nil {
+		return opts, err
+	}
+	if opts.limits.PerKey, err = parseBenchThresholdOverrides(overrides); err != nil {
+		return opts, err
+	}
+	ltoValue, err := flags.GetString("lto")
+	if err != nil {
+		return opts, err
+	}
+	if opts.lto, err = readLTOMode(ltoValue); err != nil {
+		return opts, err
+	}
+
+	if opts.runs < 1 {
+		return opts, fmt.Errorf("--runs must be at least 1")
+	}
+	if opts.warmup < 0 {
+		return opts, fmt.Errorf("--warmup must not be negative")
+	}
+	if opts.limits.Default < 0 || opts.limits.MinDelta < 0 {
+		return opts, fmt.Errorf("--threshold and --min-delta-us must not be negative")
+	}
+	if opts.baselinePath == "" {
+		opts.baselinePath = filepath.Join(opts.dir, "baseline.json")
+	}
+	return opts, nil
+}
+
+// discoverBenchProbes returns the probe directories under dir, those that hold a
+// surge.toml, sorted by name. A non-empty selection restricts the list and must name
+// existing probes.
+func discoverBenchProbes(dir string, selected []string) ([]string, error) {
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read bench dir: %w", err)
+	}
+	available := make(map[string]string)
+	names := make([]string, 0, len(entries))
+	for _, entry := range entries {
+		if !entry.IsDir() {
+			continue
+		}
+		probeDir := filepath.Join(dir, entry.Name())
+		if _, statErr := os.Stat(filepath.Join(probeDir, "surge.toml")); statErr != nil {
+			continue
+		}
+		available[entry.Name()] = probeDir
+		names = append(names, entry.Name())
+	}
+	sort.Strings(names)
+	if len(selected) == 0 {
+		dirs := make([]string, 0, len(names))
+		for _, name := range names {
+			dirs = append(dirs, available[name])
+		}
+		return dirs, nil
+	}
+	dirs := make([]string, 0, len(selected))
+	for _, name := range selected {
+		probeDir, ok := available[name]
+		if !ok {
+			return nil, fmt.Errorf("unknown probe %q (available: %s)", name, strings.Join(names, ", "))
+		}
+		dirs = append(dirs, probeDir)
+	}
+	return dirs, nil
+}
+
+func runBenchProbe(cmd *cobra.Command, out io.Writer, dir string, opts *benchOptions) (benchProbeResult, error) {
+	manifest, found, err := loadProjectManifest(dir)
+	if err != nil {
+		return benchProbeResult{}, err
+	}
+	if !found {
+		return benchProbeResult{}, fmt.Errorf("%s: %s", dir, noSurgeTomlMessage)
+	}
+	name := manifest.Config.Package.Name
+	result := benchProbeResult{Name: name}
+	cfg := manifest.Config.Bench
+	if strings.TrimSpace(cfg.Skip) != "" {
+		result.Skipped = strings.TrimSpace(cfg.Skip)
+		_, err = fmt.Fprintf(out, "skip %s: %s\n", name, result.Skipped)
+		return result, err
+	}
+
+	binary, err := buildBenchProbe(cmd, manifest, opts.lto)
+	if err != nil {
+		return result, fmt.Errorf("%s: build failed: %w", name, err)
+	}
+	runs := make([][]benchObservation, 0, opts.runs)
+	for i := range opts.warmup + opts.runs {
+		stdout, runErr := runBenchBinary(cmd, binary, manifest.Root, cfg)
+		if runErr != nil {
+			return result, fmt.Errorf("%s: run %d failed: %w", name, i+1, runErr)
+		}
+		obs := parseBenchOutput(stdout)
+		if len(obs) == 0 {
+			return result, fmt.Errorf("%s: probe printed no timings", name)
+		}
+		if i >= opts.warmup {
+			runs = append(runs, obs)
+		}
+	}
+	result.Metrics = collectBenchMetrics(runs)
+	for _, m := range result.Metrics {
+		if _, printErr := fmt.Fprintf(out, "%s %s p50=%.0fus p90=%.0fus min=%.0fus max=%.0fus\n",
+			name, m.Name, m.Stats.P50, m.Stats.P90, m.Stats.Min, m.Stats.Max); printErr != nil {
+			return result, printErr
+		}
+	}
+	return result, nil
+}
+
+func buildBenchProbe(cmd *cobra.Command, manifest *projectManifest, lto buildpipeline.LTOMode) (string, error) {
+	targetPath, dirInfo, err := resolveProjectRunTarget(manifest)
+	if err != nil {
+		return "", err
+	}
+	maxDiagnostics, err := cmd.Root().PersistentFlags().GetInt("max-diagnostics")
+	if err != nil {
+		return "", fmt.Errorf("failed to get max-diagnostics flag: %w", err)
+	}
+	files, fileErr := collectProjectFiles(targetPath, dirInfo)
+	if fileErr != nil && len(files) == 0 {
+		files = []string{targetPath}
+	}
+	req := buildpipeline.BuildRequest{
+		CompileRequest: buildpipeline.CompileRequest{
+			TargetPath:     targetPath,
+			BaseDir:        manifest.Root,
+			RootKind:       project.ModuleKindBinary,
+			MaxDiagnostics: maxDiagnostics,
+			DirInfo:        toPipelineDirInfo(dirInfo),
+			Files:          displayFileList(files, manifest.Root),
+			Backend:        buildpipeline.BackendLLVM,
+		},
+		OutputName:    manifest.Config.Package.Name,
+		OutputRoot:    manifest.Root,
+		Profile:       "release",
+		Backend:       buildpipeline.BackendLLVM,
+		LTO:           lto,
+		ManifestRoot:  manifest.Root,
+		ManifestFound: true,
+	}
+	res, err := buildpipeline.Build(cmd.Context(), &req)
+	if err != nil {
+		return "", err
+	}
+	return res.OutputPath, nil
+}
+
+func runBenchBinary(cmd *cobra.Command, binary, workDir string, cfg benchConfig) (string, error) {
+	// #nosec G204 -- binary is the probe executable just built and args come from its surge.toml.
+	run := exec.CommandContext(cmd.Context(), binary, cfg.Args...)
+	run.Env = append(os.Environ(), cfg.Env...)
+	run.Dir = workDir
+	var stdout, stderr bytes.Buffer
+	run.Stdout = &stdout
+	run.Stderr = &stderr
+	if err := run.Run(); err != nil {
+		if msg := strings.TrimSpace(stderr.String()); msg != "" {
+			return "", fmt.Errorf("%w: %s", err, msg)
+		}
+		return "", err
+	}
+	return stdout.String(), nil
+}
+
+func collectBenchMachine() benchMachine {
+	host, err := os.Hostname()
+	if err != nil {
+		host = ""
+	}
+	return benchMachine{
+		OS:        runtime.GOOS,
+		Arch:      runtime.GOARCH,
+		CPUs:      runtime.NumCPU(),
+		CPUModel:  readCPUModel(),
+		Hostname:  host,
+		Surge:     collectVersionInfo().Version,
+		GoVersion: runtime.Version(),
+		Timestamp: time.Now().UTC().Format(time.RFC3339),
+	}
+}
+
+// readCPUModel reads the first "model name" from /proc/cpuinfo; other platforms report
+// an empty model.
+func readCPUModel() string {
+	data, err := os.ReadFile("/proc/cpuinfo")
+	if err != nil {
+		return ""
+	}
+	for _, line := range strings.Split(string(data), "\n") {
+		key, value, ok := strings.Cut(line, ":")
+		if ok && strings.TrimSpace(key) == "model name" {
+			return strings.TrimSpace(value)
+		}
+	}
+	return ""
+}
@@ -0,0 +1,384 @@
+package main
+
+import (
+	"encoding/json"
+	"fmt"
+	"io"
+	"math"
+	"os"
+	"path/filepath"
+	"regexp"
+	"sort"
+	"strconv"
+	"strings"
+)
+
+const benchReportVersion = 1
+
+// benchReport is the JSON document written by surge bench and read back as a baseline.
+type benchReport struct {
+	Version int                `json:"version"`
+	Machine benchMachine       `json:"machine"`
+	Config  benchRunConfig     `json:"config"`
+	Probes  []benchProbeResult `json:"probes"`
+}
+
+type benchMachine struct {
+	OS        string `json:"os"`
+	Arch      string `json:"arch"`
+	CPUs      int    `json:"cpus"`
+	CPUModel  string `json:"cpu_model,omitempty"`
+	Hostname  string `json:"hostname,omitempty"`
+	Surge     string `json:"surge"`
+	GoVersion string `json:"go_version"`
+	Timestamp string `json:"timestamp"`
+}
+
+type benchRunConfig struct {
+	Runs   int    `json:"runs"`
+	Warmup int    `json:"warmup"`
+	LTO    string `json:"lto"`
+}
+
+type benchProbeResult struct {
+	Name    string        `json:"name"`
+	Skipped string        `json:"skipped,omitempty"`
+	Metrics []benchMetric `json:"metrics,omitempty"`
+}
+
+type benchMetric struct {
+	Name    string     `json:"name"`
+	Unit    string     `json:"unit"`
+	Samples []float64  `json:"samples"`
+	Stats   benchStats `json:"stats"`
+}
+
+type benchStats struct {
+	Min    float64 `json:"min"`
+	P50    float64 `json:"p50"`
+	P90    float64 `json:"p90"`
+	P99    float64 `json:"p99"`
+	Max    float64 `json:"max"`
+	Mean   float64 `json:"mean"`
+	Stddev float64 `json:"stddev"`
+}
+
+// benchObservation is one timing printed by a probe run.
+type benchObservation struct {
+	Name string
+	US   float64
+}
+
+var (
+	benchUSField  = regexp.MustCompile(`^([a-z][a-z0-9_]*)_us=(\d+)$`)
+	benchTableRow = regexp.MustCompile(`^\|\s*([a-z][a-z0-9_]*)\s*\|\s*\d+\s*\|\s*(\d+)\s*\|\s*\d+\s*\|$`)
+)
+
+// parseBenchOutput extracts timings from probe stdout. Three line shapes are recognized:
+// "name_us=N ..." fields, "| name | iterations | us | ns_op |" table rows, and
+// "word key=value ... us=N" records, which are named "word{key=value,...}" from the
+// fields that precede us=.
+func parseBenchOutput(out string) []benchObservation {
+	var obs []benchObservation
+	for _, raw := range strings.Split(out, "\n") {
+		line := strings.TrimSpace(raw)
+		if line == "" {
+			continue
+		}
+		if m := benchTableRow.FindStringSubmatch(line); m != nil {
+			if us, err := strconv.ParseFloat(m[2], 64); err == nil {
+				obs = append(obs, benchObservation{Name: m[1], US: us})
+			}
+			continue
+		}
+		fields := strings.Fields(line)
+		found := false
+		for _, field := range fields {
+			m := benchUSField.FindStringSubmatch(field)
+			if m == nil {
+				continue
+			}
+			if us, err := strconv.ParseFloat(m[2], 64); err == nil {
+				obs = append(obs, benchObservation{Name: m[1], US: us})
+				found = true
+			}
+		}
+		if found || strings.Contains(fields[0], "=") {
+			continue
+		}
+		if o, ok := parseBenchRecord(fields); ok {
+			obs = append(obs, o)
+		}
+	}
+	return obs
+}
+
+func parseBenchRecord(fields []string) (benchObservation, bool) {
+	keys := make([]string, 0, len(fields))
+	for _, field := range fields[1:] {
+		key, value, ok := strings.Cut(field, "=")
+		if !ok {
+			return benchObservation{}, false
+		}
+		if key == "us" {
+			us, err := strconv.ParseFloat(value, 64)
+			if err != nil {
+				return benchObservation{}, false
+			}
+			return benchObservation{Name: fields[0] + "{" + strings.Join(keys, ",") + "}", US: us}, true
+		}
+		keys = append(keys, field)
+	}
+	return benchObservation{}, false
+}
+
+// collectBenchMetrics groups observations from every measured run by name, keeping the
+// order in which names first appeared.
+func collectBenchMetrics(runs [][]benchObservation) []benchMetric {
+	index := make(map[string]int)
+	var metrics []benchMetric
+	for _, run := range runs {
+		for _, o := range run {
+			i, ok := index[o.Name]
+			if !ok {
+				i = len(metrics)
+				index[o.Name] = i
+				metrics = append(metrics, benchMetric{Name: o.Name, Unit: "us"})
+			}
+			metrics[i].Samples = append(metrics[i].Samples, o.US)
+		}
+	}
+	for i := range metrics {
+		metrics[i].Stats = computeBenchStats(metrics[i].Samples)
+	}
+	return metrics
+}
+
+// computeBenchStats uses nearest-rank percentiles, so every reported value is a sample.
+func computeBenchStats(samples []float64) benchStats {
+	if len(samples) == 0 {
+		return benchStats{}
+	}
+	sorted := append([]float64(nil), samples...)
+	sort.Float64s(sorted)
+	sum := 0.0
+	for _, v := range sorted {
+		sum += v
+	}
+	mean := sum / float64(len(sorted))
+	variance := 0.0
+	for _, v := range sorted {
+		variance += (v - mean) * (v - mean)
+	}
+	variance /= float64(len(sorted))
+	return benchStats{
+		Min:    sorted[0],
+		P50:    benchPercentile(sorted, 50),
+		P90:    benchPercentile(sorted, 90),
+		P99:    benchPercentile(sorted, 99),
+		Max:    sorted[len(sorted)-1],
+		Mean:   mean,
+		Stddev: math.Sqrt(variance),
+	}
+}
+
+func benchPercentile(sorted []float64, p float64) float64 {
+	rank := int(math.Ceil(p / 100 * float64(len(sorted))))
+	if rank < 1 {
+		rank = 1
+	}
+	return sorted[rank-1]
+}
+
+// benchDelta compares one metric's p50 against the baseline.
+type benchDelta struct {
+	Probe     string
+	Metric    string
+	Base      float64
+	Current   float64
+	Percent   float64
+	Threshold float64
+	Status    string
+}
+
+const (
+	benchStatusOK        = "ok"
+	benchStatusImproved  = "improved"
+	benchStatusRegressed = "regressed"
+	benchStatusNew       = "new"
+	benchStatusMissing   = "missing"
+)
+
+// benchThresholds holds the default regression threshold in percent, per-metric overrides
+// keyed by "probe/metric", and an absolute floor in microseconds below which a slowdown
+// is treated as noise.
+type benchThresholds struct {
+	Default  float64
+	PerKey   map[string]float64
+	MinDelta float64
+}
+
+func (t benchThresholds) forKey(key string) float64 {
+	if v, ok := t.PerKey[key]; ok {
+		return v
+	}
+	return t.Default
+}
+
+func compareBenchReports(base, cur *benchReport, limits benchThresholds) []benchDelta {
+	baseMetrics := make(map[string]benchMetric)
+	for _, probe := range base.Probes {
+		for _, m := range probe.Metrics {
+			baseMetrics[probe.Name+"/"+m.Name] = m
+		}
+	}
+	seen := make(map[string]bool)
+	var deltas []benchDelta
+	for _, probe := range cur.Probes {
+		for _, m := range probe.Metrics {
+			key := probe.Name + "/" + m.Name
+			seen[key] = true
+			d := benchDelta{
+				Probe:     probe.Name,
+				Metric:    m.Name,
+				Current:   m.Stats.P50,
+				Threshold: limits.forKey(key),
+			}
+			b, ok := baseMetrics[key]
+			if !ok {
+				d.Status = benchStatusNew
+				deltas = append(deltas, d)
+				continue
+			}
+			d.Base = b.Stats.P50
+			d.Status = benchStatusOK
+			if d.Base > 0 {
+				d.Percent = (d.Current - d.Base) / d.Base * 100
+			}
+			switch {
+			case d.Percent > d.Threshold && d.Current-d.Base > limits.MinDelta:
+				d.Status = benchStatusRegressed
+			case d.Percent < -d.Threshold && d.Base-d.Current > limits.MinDelta:
+				d.Status = benchStatusImproved
+			}
+			deltas = append(deltas, d)
+		}
+	}
+	for _, probe := range base.Probes {
+		if benchProbeSelected(cur, probe.Name) {
+			for _, m := range probe.Metrics {
+				key := probe.Name + "/" + m.Name
+				if !seen[key] {
+					deltas = append(deltas, benchDelta{
+						Probe:  probe.Name,
+						Metric: m.Name,
+						Base:   m.Stats.P50,
+						Status: benchStatusMissing,
+					})
+				}
+			}
+		}
+	}
+	return deltas
+}
+
+// benchProbeSelected reports whether the current run measured the probe, so a run limited
+// to a few probes does not flag every other baseline metric as missing.
+func benchProbeSelected(cur *benchReport, name string) bool {
+	for _, probe := range cur.Probes {
+		if probe.Name == name {
+			return probe.Skipped == ""
+		}
+	}
+	return false
+}
+
+func countBenchRegressions(deltas []benchDelta) int {
+	n := 0
+	for _, d := range deltas {
+		if d.Status == benchStatusRegressed {
+			n++
+		}
+	}
+	return n
+}
+
+func renderBenchDeltas(out io.Writer, deltas []benchDelta) error {
+	if _, err := fmt.Fprintln(out, "| probe | metric | base p50 us | p50 us | delta | status |"); err != nil {
+		return err
+	}
+	if _, err := fmt.Fprintln(out, "| --- | --- | ---: | ---: | ---: | --- |"); err != nil {
+		return err
+	}
+	for _, d := range deltas {
+		delta := "-"
+		if d.Status != benchStatusNew && d.Status != benchStatusMissing {
+			delta = fmt.Sprintf("%+.1f%%", d.Percent)
+		}
+		status := d.Status
+		if d.Status == benchStatusRegressed {
+			status = fmt.Sprintf("%s (> %.0f%%)", d.Status, d.Threshold)
+		}
+		if _, err := fmt.Fprintf(out, "| %s | %s | %s | %s | %s | %s |\n",
+			d.Probe, d.Metric, formatBenchUS(d.Base, d.Status == benchStatusNew),
+			formatBenchUS(d.Current, d.Status == benchStatusMissing), delta, status); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+func formatBenchUS(v float64, absent bool) string {
+	if absent {
+		return "-"
+	}
+	return strconv.FormatFloat(v, 'f', 0, 64)
+}
+
+// parseBenchThresholdOverrides reads repeated "probe/metric=percent" flag values.
+func parseBenchThresholdOverrides(values []string) (map[string]float64, error) {
+	out := make(map[string]float64, len(values))
+	for _, value := range values {
+		key, pct, ok := strings.Cut(value, "=")
+		key = strings.TrimSpace(key)
+		if !ok || !strings.Contains(key, "/") {
+			return nil, fmt.Errorf("invalid --metric-threshold %q (want probe/metric=percent)", value)
+		}
+		v, err := strconv.ParseFloat(strings.TrimSpace(pct), 64)
+		if err != nil || v < 0 {
+			return nil, fmt.Errorf("invalid --metric-threshold %q: percent must be a non-negative number", value)
+		}
+		out[key] = v
+	}
+	return out, nil
+}
+
+func readBenchReport(path string) (*benchReport, error) {
+	// #nosec G304 -- path comes from user-provided CLI flag
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, err
+	}
+	var report benchReport
+	if err := json.Unmarshal(data, &report); err != nil {
+		return nil, fmt.Errorf("%s: %w", path, err)
+	}
+	if report.Version != benchReportVersion {
+		return nil, fmt.Errorf("%s: unsupported bench report version %d", path, report.Version)
+	}
+	return &report, nil
+}
+
+func writeBenchReport(path string, report *benchReport) error {
+	data, err := json.MarshalIndent(report, "", "  ")
+	if err != nil {
+		return err
+	}
+	if dir := filepath.Dir(path); dir != "" {
+		if err := os.MkdirAll(dir, 0o750); err != nil {
+			return err
+		}
+	}
+	// #nosec G703 -- path comes from user-provided CLI flag
+	return os.WriteFile(path, append(data, '\n'), 0o600)
+}
@@ -0,0 +1,193 @@
+package main
+
+import (
+	"bytes"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func TestParseBenchOutputRecognizesProbeShapes(t *testing.T) {
+	out := strings.Join([]string{
+		"rounds=200 lines=256 width=32 bytes=8448",
+		"string_line_us=1830 checksum=1638400",
+		"| channel_ping_pong | 20000 | 5120 | 256 |",
+		"bignum op=mul bits=512 rounds=20000 us=742 checksum=5100000",
+		"channel_batch mode=single capacity=16 producers=4 values=200000 us=9100",
+		"impossible",
+		"",
+	}, "\n")
+	got := parseBenchOutput(out)
+	want := []benchObservation{
+		{Name: "string_line", US: 1830},
+		{Name: "channel_ping_pong", US: 5120},
+		{Name: "bignum{op=mul,bits=512,rounds=20000}", US: 742},
+		{Name: "channel_batch{mode=single,capacity=16,producers=4,values=200000}", US: 9100},
+	}
+	if len(got) != len(want) {
+		t.Fatalf("parseBenchOutput = %+v, want %+v", got, want)
+	}
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("observation %d = %+v, want %+v", i, got[i], want[i])
+		}
+	}
+}
+
+func TestComputeBenchStatsUsesNearestRank(t *testing.T) {
+	samples := []float64{50, 10, 40, 20, 30, 100, 90, 80, 70, 60}
+	got := computeBenchStats(samples)
+	want := benchStats{Min: 10, P50: 50, P90: 90, P99: 100, Max: 100, Mean: 55}
+	if got.Min != want.Min || got.P50 != want.P50 || got.P90 != want.P90 ||
+		got.P99 != want.P99 || got.Max != want.Max || got.Mean != want.Mean {
+		t.Fatalf("computeBenchStats = %+v, want %+v", got, want)
+	}
+	if got.Stddev < 28.7 || got.Stddev > 28.8 {
+		t.Fatalf("stddev = %f, want about 28.72", got.Stddev)
+	}
+	if samples[0] != 50 {
+		t.Fatalf("computeBenchStats reordered its input")
+	}
+}
+
+func TestCollectBenchMetricsGroupsRunsByName(t *testing.T) {
+	metrics := collectBenchMetrics([][]benchObservation{
+		{{Name: "b", US: 3}, {Name: "a", US: 10}},
+		{{Name: "b", US: 1}, {Name: "a", US: 30}},
+		{{Name: "b", US: 2}, {Name: "a", US: 20}},
+	})
+	if len(metrics) != 2 || metrics[0].Name != "b" || metrics[1].Name != "a" {
+		t.Fatalf("metrics = %+v, want b then a", metrics)
+	}
+	if metrics[0].Stats.P50 != 2 || metrics[1].Stats.P50 != 20 || len(metrics[1].Samples) != 3 {
+		t.Fatalf("metrics = %+v", metrics)
+	}
+}
+
+func TestCompareBenchReportsAppliesThresholds(t *testing.T) {
+	base := benchReportWith(map[string]float64{
+		"steady": 1000, "slower": 1000, "faster": 1000, "noisy": 100, "custom": 1000, "gone": 1000,
+	})
+	cur := benchReportWith(map[string]float64{
+		"steady": 1050, "slower": 1200, "faster": 700, "noisy": 140, "custom": 1200, "added": 5,
+	})
+	deltas := compareBenchReports(base, cur, benchThresholds{
+		Default:  10,
+		PerKey:   map[string]float64{"probe/custom": 25},
+		MinDelta: 50,
+	})
+	status := make(map[string]string)
+	for _, d := range deltas {
+		status[d.Metric] = d.Status
+	}
+	want := map[string]string{
+		"steady": benchStatusOK,
+		"slower": benchStatusRegressed,
+		"faster": benchStatusImproved,
+		"noisy":  benchStatusOK,
+		"custom": benchStatusOK,
+		"added":  benchStatusNew,
+		"gone":   benchStatusMissing,
+	}
+	for metric, s := range want {
+		if status[metric] != s {
+			t.Fatalf("%s status = %q, want %q (all: %v)", metric, status[metric], s, status)
+		}
+	}
+	if n := countBenchRegressions(deltas); n != 1 {
+		t.Fatalf("regressions = %d, want 1", n)
+	}
+
+	var out bytes.Buffer
+	if err := renderBenchDeltas(&out, deltas); err != nil {
+		t.Fatalf("renderBenchDeltas: %v", err)
+	}
+	if !strings.Contains(out.String(), "| probe | slower | 1000 | 1200 | +20.0% | regressed (> 10%) |") {
+		t.Fatalf("missing regression row:\n%s", out.String())
+	}
+}
+
+func TestCompareBenchReportsIgnoresUnselectedProbes(t *testing.T) {
+	base := benchReportWith(map[string]float64{"x": 1000})
+	base.Probes = append(base.Probes, benchProbeResult{
+		Name:    "other",
+		Metrics: []benchMetric{{Name: "y", Stats: benchStats{P50: 10}}},
+	})
+	cur := benchReportWith(map[string]float64{"x": 1000})
+	for _, d := range compareBenchReports(base, cur, benchThresholds{Default: 10}) {
+		if d.Probe == "other" {
+			t.Fatalf("unselected probe reported: %+v", d)
+		}
+	}
+}
+
+func TestParseBenchThresholdOverrides(t *testing.T) {
+	got, err := parseBenchThresholdOverrides([]string{"timers/timer_chain=40", " map_ops/map_int_lookup = 5 "})
+	if err != nil {
+		t.Fatalf("parseBenchThresholdOverrides: %v", err)
+	}
+	if got["timers/timer_chain"] != 40 || got["map_ops/map_int_lookup"] != 5 {
+		t.Fatalf("overrides = %v", got)
+	}
+	for _, bad := range []string{"timer_chain=40", "timers/timer_chain", "timers/timer_chain=-1"} {
+		if _, err := parseBenchThresholdOverrides([]string{bad}); err == nil {
+			t.Fatalf("parseBenchThresholdOverrides(%q) succeeded", bad)
+		}
+	}
+}
+
+func TestBenchReportRoundTrip(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "nested", "report.json")
+	report := benchReportWith(map[string]float64{"x": 12})
+	report.Machine = benchMachine{OS: "linux", Arch: "amd64", CPUs: 8, Surge: "dev"}
+	if err := writeBenchReport(path, report); err != nil {
+		t.Fatalf("writeBenchReport: %v", err)
+	}
+	got, err := readBenchReport(path)
+	if err != nil {
+		t.Fatalf("readBenchReport: %v", err)
+	}
+	if got.Machine.CPUs != 8 || len(got.Probes) != 1 || got.Probes[0].Metrics[0].Stats.P50 != 12 {
+		t.Fatalf("round trip = %+v", got)
+	}
+}
+
+func TestDiscoverBenchProbes(t *testing.T) {
+	dir := t.TempDir()
+	for _, name := range []string{"zeta", "alpha"} {
+		if err := os.MkdirAll(filepath.Join(dir, name), 0o750); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(filepath.Join(dir, name, "surge.toml"), []byte("[package]\n"), 0o600); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := os.MkdirAll(filepath.Join(dir, "notes"), 0o750); err != nil {
+		t.Fatal(err)
+	}
+
+	all, err := discoverBenchProbes(dir, nil)
+	if err != nil {
+		t.Fatalf("discoverBenchProbes: %v", err)
+	}
+	if len(all) != 2 || filepath.Base(all[0]) != "alpha" || filepath.Base(all[1]) != "zeta" {
+		t.Fatalf("probes = %v, want alpha and zeta", all)
+	}
+	if _, err := discoverBenchProbes(dir, []string{"notes"}); err == nil {
+		t.Fatalf("selecting a directory without surge.toml succeeded")
+	}
+}
+
+func benchReportWith(p50 map[string]float64) *benchReport {
+	probe := benchProbeResult{Name: "probe"}
+	for name, v := range p50 {
+		probe.Metrics = append(probe.Metrics, benchMetric{
+			Name:    name,
+			Unit:    "us",
+			Samples: []float64{v},
+			Stats:   benchStats{Min: v, P50: v, P90: v, P99: v, Max: v, Mean: v},
+		})
+	}
+	return &benchReport{Version: benchReportVersion, Probes: []benchProbeResult{probe}}
+}
@@ -54,6 +54,10 @@ func buildExecution(cmd *cobra.Command, args []string) error {
 	if err != nil {
 		return err
 	}
+	ltoValue, err := cmd.Flags().GetString("lto")
+	if err != nil {
+		return err
+	}
 
 	if release && dev {
 		return fmt.Errorf("--release and --dev are mutually exclusive")
@@ -61,6 +65,13 @@ func buildExecution(cmd *cobra.Command, args []string) error {
 	if emitLLVM && backendValue != string(buildpipeline.BackendLLVM) {
 		return fmt.Errorf("--emit-llvm requires --backend=llvm")
 	}
+	lto, err := readLTOMode(ltoValue)
+	if err != nil {
+		return err
+	}
+	if lto != buildpipeline.LTOOff && backendValue != string(buildpipeline.BackendLLVM) {
+		return fmt.Errorf("--lto requires --backend=llvm")
+	}
 
 	uiModeValue, err := readUIMode(uiValue)
 	if err != nil {
@@ -134,6 +145,7 @@ func buildExecution(cmd *cobra.Command, args []string) error {
 		OutputRoot:     outputRoot,
 		Profile:        profile,
 		Backend:        buildpipeline.Backend(backendValue),
+		LTO:            lto,
 		EmitMIR:        emitMIR,
 		EmitLLVM:       emitLLVM,
 		KeepTmp:        keepTmpFlag,
@@ -183,6 +195,19 @@ func formatPathForOutput(root, path string) string {
 	return filepath.ToSlash(rel)
 }
 
+func readLTOMode(value string) (buildpipeline.LTOMode, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "off":
+		return buildpipeline.LTOOff, nil
+	case "thin":
+		return buildpipeline.LTOThin, nil
+	case "full":
+		return buildpipeline.LTOFull, nil
+	default:
+		return buildpipeline.LTOOff, fmt.Errorf("unsupported --lto mode: %s (supported: off, thin, full)", value)
+	}
+}
+
 func init() {
 	buildCmd.Flags().Bool("release", false, "optimize for release")
 	buildCmd.Flags().Bool("dev", false, "development build with extra checks")
@@ -192,4 +217,5 @@ func init() {
 	buildCmd.Flags().Bool("emit-llvm", false, "emit LLVM IR to target/.tmp (llvm backend only)")
 	buildCmd.Flags().Bool("keep-tmp", false, "preserve target/.tmp contents")
 	buildCmd.Flags().Bool("print-commands", false, "print LLVM build commands")
+	buildCmd.Flags().String("lto", "off", "link the native runtime as bitcode with LTO (off, thin, full)")
 }
@@ -48,6 +48,7 @@ func main() {
 	rootCmd.AddCommand(philosophyCmd)
 	rootCmd.AddCommand(moduleCmd)
 	rootCmd.AddCommand(doctorCmd)
+	rootCmd.AddCommand(benchCmd)
 
 	// Глобальные флаги
 	rootCmd.PersistentFlags().String("color", "auto", "colorize output (auto|on|off)")
@@ -89,6 +90,9 @@ func applyTimeout(cmd *cobra.Command, _ []string) (err error) {
 	if secs <= 0 {
 		return fmt.Errorf("timeout must be greater than zero")
 	}
+	if cmd.Name() == "bench" && !cmd.Root().PersistentFlags().Changed("timeout") {
+		secs = benchDefaultTimeoutSeconds
+	}
 
 	timeoutDuration = time.Duration(secs) * time.Second
 	ctx, cancel := context.WithTimeout(cmd.Context(), timeoutDuration)
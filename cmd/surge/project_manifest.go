@@ -23,6 +23,7 @@ type projectManifest struct {
 type projectConfig struct {
 	Package packageConfig `toml:"package"`
 	Run     runConfig     `toml:"run"`
+	Bench   benchConfig   `toml:"bench"`
 }
 
 type packageConfig struct {
@@ -22,7 +22,17 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_array_append_raw_bytes", ret: "void", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_byte_array_append_range", ret: "void", params: []string{"ptr", "ptr", "i64", "i64"}},
 		{name: "rt_byte_array_drop_prefix", ret: "void", params: []string{"ptr", "i64"}},
+		{name: "rt_byte_array_reserve_tail", ret: "i64", params: []string{"ptr", "i64", "i64"}},
 		{name: "rt_byte_parse_uint64_token", ret: "i1", params: []string{"ptr", "i64", "i64", "ptr", "ptr"}},
+		{name: "rt_byte_find", ret: "i64", params: []string{"ptr", "i64", "i64", "i8"}},
+		{name: "rt_byte_find2", ret: "i64", params: []string{"ptr", "i64", "i64", "i8", "i8"}},
+		{name: "rt_byte_find3", ret: "i64", params: []string{"ptr", "i64", "i64", "i8", "i8", "i8"}},
+		{name: "rt_byte_find_set", ret: "i64", params: []string{"ptr", "i64", "i64", "ptr"}},
+		{name: "rt_byte_count", ret: "i64", params: []string{"ptr", "i64", "i64", "i8"}},
+		{name: "rt_byte_skip_ascii_ws", ret: "i64", params: []string{"ptr", "i64", "i64"}},
+		{name: "rt_byte_find_ascii_ws", ret: "i64", params: []string{"ptr", "i64", "i64"}},
+		{name: "rt_json_scan_string", ret: "i64", params: []string{"ptr", "i64", "i64"}},
+		{name: "rt_json_structural_index", ret: "i64", params: []string{"ptr", "i64", "i64", "ptr"}},
 		{name: "rt_write_stdout", ret: "i64", params: []string{"ptr", "i64"}},
 		{name: "rt_write_stderr", ret: "i64", params: []string{"ptr", "i64"}},
 		{name: "rt_entropy_bytes", ret: "ptr", params: []string{"i64"}},
@@ -51,6 +61,8 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_fs_seek", ret: "ptr", params: []string{"ptr", "i64", "i64"}},
 		{name: "rt_fs_flush", ret: "ptr", params: []string{"ptr"}},
 		{name: "rt_fs_read_file", ret: "ptr", params: []string{"ptr"}},
+		{name: "rt_fs_map_file", ret: "ptr", params: []string{"ptr"}},
+		{name: "rt_fs_read_into", ret: "ptr", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_fs_write_file", ret: "ptr", params: []string{"ptr", "ptr", "i64", "i32"}},
 		{name: "rt_fs_file_name", ret: "ptr", params: []string{"ptr"}},
 		{name: "rt_fs_file_type", ret: "ptr", params: []string{"ptr"}},
@@ -63,7 +75,10 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_net_read", ret: "ptr", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_net_write", ret: "ptr", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_net_read_bytes", ret: "ptr", params: []string{"ptr", "i64"}},
+		{name: "rt_net_read_into", ret: "ptr", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_net_write_bytes", ret: "ptr", params: []string{"ptr", "ptr", "i64", "i64"}},
+		{name: "rt_net_write_vectored", ret: "ptr", params: []string{"ptr", "ptr", "i64"}},
+		{name: "rt_net_send_file", ret: "ptr", params: []string{"ptr", "ptr", "i64", "i64"}},
 		{name: "rt_net_wait_accept", ret: "i1", params: []string{"ptr"}},
 		{name: "rt_net_wait_readable", ret: "i1", params: []string{"ptr"}},
 		{name: "rt_net_wait_writable", ret: "i1", params: []string{"ptr"}},
@@ -74,6 +89,9 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_monotonic_now", ret: "i64", params: nil},
 		{name: "rt_worker_count", ret: "i64", params: nil},
 		{name: "rt_heap_stats", ret: "ptr", params: nil},
+		{name: "rt_metrics_json", ret: "ptr", params: nil},
+		{name: "rt_metrics_prometheus", ret: "ptr", params: nil},
+		{name: "rt_metrics_value", ret: "i64", params: []string{"ptr"}},
 		{name: "rt_string_from_bytes", ret: "ptr", params: []string{"ptr", "i64"}},
 		{name: "rt_string_from_utf16", ret: "ptr", params: []string{"ptr", "i64"}},
 		{name: "rt_utf8_valid", ret: "i1", params: []string{"ptr", "i64"}},
@@ -83,6 +101,7 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_string_index", ret: "i32", params: []string{"ptr", "i64"}},
 		{name: "rt_string_slice", ret: "ptr", params: []string{"ptr", "ptr"}},
 		{name: "rt_string_concat", ret: "ptr", params: []string{"ptr", "ptr"}},
+		{name: "rt_string_concat_n", ret: "ptr", params: []string{"ptr", "i64"}},
 		{name: "rt_string_repeat", ret: "ptr", params: []string{"ptr", "i64"}},
 		{name: "rt_string_eq", ret: "i1", params: []string{"ptr", "ptr"}},
 		{name: "rt_string_bytes_view", ret: "ptr", params: []string{"ptr"}},
@@ -163,6 +182,9 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_async_yield", ret: "void", params: []string{"ptr"}},
 		{name: "rt_async_return", ret: "void", params: []string{"ptr", "i64"}},
 		{name: "rt_async_return_cancelled", ret: "void", params: []string{"ptr"}},
+		{name: "rt_async_register_poll_fns", ret: "void", params: []string{"ptr", "i64"}},
+		{name: "rt_async_register_poll_names", ret: "void", params: []string{"ptr", "i64"}},
+		{name: "rt_task_frame_alloc", ret: "ptr", params: []string{"i64", "i64"}},
 		{name: "rt_channel_new", ret: "ptr", params: []string{"i64"}},
 		{name: "rt_channel_send", ret: "i1", params: []string{"ptr", "i64"}},
 		{name: "rt_channel_send_yield", ret: "i1", params: []string{"ptr", "i64"}},
@@ -171,6 +193,7 @@ func runtimeDecls() []builtinDecl {
 		{name: "rt_channel_recv_blocking", ret: "i8", params: []string{"ptr", "ptr"}},
 		{name: "rt_channel_try_send", ret: "i1", params: []string{"ptr", "i64"}},
 		{name: "rt_channel_try_recv", ret: "i1", params: []string{"ptr", "ptr"}},
+		{name: "rt_channel_send_many", ret: "i64", params: []string{"ptr", "ptr", "i64"}},
 		{name: "rt_channel_close", ret: "void", params: []string{"ptr"}},
 		{name: "rt_map_new", ret: "ptr", params: []string{"i64"}},
 		{name: "rt_map_len", ret: "i64", params: []string{"ptr"}},
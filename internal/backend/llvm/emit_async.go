@@ -72,9 +72,78 @@ func (e *Emitter) emitPollDispatch() error {
 	}
 	fmt.Fprintf(&e.buf, "  unreachable\n")
 	fmt.Fprintf(&e.buf, "}\n\n")
+	return e.emitPollTable(pollIDs)
+}
+
+// emitPollTable emits a void thunk per poll function and a table of them indexed by
+// poll function id, registered with the runtime from a global constructor. The runtime
+// stores the thunk in rt_task and calls it directly; async terminators then record the
+// outcome and return instead of longjmp-ing out of __surge_poll_call. A parallel table
+// of Surge function names lets the runtime task profiler report polls by name.
+func (e *Emitter) emitPollTable(pollIDs []mir.FuncID) error {
+	if len(pollIDs) == 0 {
+		return nil
+	}
+	for _, id := range pollIDs {
+		sig, ok := e.funcSigs[id]
+		if !ok {
+			return fmt.Errorf("missing poll function signature for %s", e.mod.Funcs[id].Name)
+		}
+		fmt.Fprintf(&e.buf, "define internal void @__surge_poll_thunk.%d() {\n", id)
+		fmt.Fprintf(&e.buf, "entry:\n")
+		if sig.ret == "void" {
+			fmt.Fprintf(&e.buf, "  call void @%s()\n", e.funcNames[id])
+		} else {
+			fmt.Fprintf(&e.buf, "  call %s @%s()\n", sig.ret, e.funcNames[id])
+		}
+		fmt.Fprintf(&e.buf, "  ret void\n")
+		fmt.Fprintf(&e.buf, "}\n\n")
+	}
+
+	tableLen := int(pollIDs[len(pollIDs)-1]) + 1
+	entries := make([]string, tableLen)
+	for i := range entries {
+		entries[i] = "ptr null"
+	}
+	for _, id := range pollIDs {
+		entries[id] = fmt.Sprintf("ptr @__surge_poll_thunk.%d", id)
+	}
+	fmt.Fprintf(&e.buf, "@__surge_poll_fns = internal constant [%d x ptr] [%s]\n\n", tableLen, strings.Join(entries, ", "))
+	names := make([]string, tableLen)
+	for i := range names {
+		names[i] = "ptr null"
+	}
+	for _, id := range pollIDs {
+		name := []byte(strings.TrimSuffix(e.mod.Funcs[id].Name, "$poll"))
+		fmt.Fprintf(&e.buf, "@__surge_poll_name.%d = private unnamed_addr constant [%d x i8] %s\n", id, len(name)+1, formatLLVMBytes(name, len(name)+1))
+		names[id] = fmt.Sprintf("ptr @__surge_poll_name.%d", id)
+	}
+	fmt.Fprintf(&e.buf, "@__surge_poll_names = internal constant [%d x ptr] [%s]\n\n", tableLen, strings.Join(names, ", "))
+	fmt.Fprintf(&e.buf, "define internal void @__surge_register_poll_fns() {\n")
+	fmt.Fprintf(&e.buf, "entry:\n")
+	fmt.Fprintf(&e.buf, "  call void @rt_async_register_poll_fns(ptr @__surge_poll_fns, i64 %d)\n", tableLen)
+	fmt.Fprintf(&e.buf, "  call void @rt_async_register_poll_names(ptr @__surge_poll_names, i64 %d)\n", tableLen)
+	fmt.Fprintf(&e.buf, "  ret void\n")
+	fmt.Fprintf(&e.buf, "}\n\n")
+	fmt.Fprintf(&e.buf, "@llvm.global_ctors = appending global [1 x { i32, ptr, ptr }] [{ i32, ptr, ptr } { i32 65535, ptr @__surge_register_poll_fns, ptr null }]\n\n")
 	return nil
 }
 
+// emitPollTerminatorReturn ends a block after an async terminator call. Under the
+// direct poll protocol the terminator returns, and the poll function returns to the
+// runtime right away; its return value is never read.
+func (fe *funcEmitter) emitPollTerminatorReturn() {
+	ret := "void"
+	if sig, ok := fe.emitter.funcSigs[fe.f.ID]; ok {
+		ret = sig.ret
+	}
+	if ret == "void" {
+		fmt.Fprintf(&fe.emitter.buf, "  ret void\n")
+		return
+	}
+	fmt.Fprintf(&fe.emitter.buf, "  ret %s zeroinitializer\n", ret)
+}
+
 func (e *Emitter) emitBlockingDispatch() error {
 	if e == nil || e.mod == nil {
 		return nil
@@ -633,7 +702,7 @@ func (fe *funcEmitter) emitTermAsyncYield(term *mir.Terminator) error {
 		return fmt.Errorf("async_yield expects state pointer, got %s", stateTy)
 	}
 	fmt.Fprintf(&fe.emitter.buf, "  call void @rt_async_yield(ptr %s)\n", stateVal)
-	fmt.Fprintf(&fe.emitter.buf, "  unreachable\n")
+	fe.emitPollTerminatorReturn()
 	return nil
 }
 
@@ -667,7 +736,7 @@ func (fe *funcEmitter) emitTermAsyncReturn(term *mir.Terminator) error {
 		bitsVal = bits
 	}
 	fmt.Fprintf(&fe.emitter.buf, "  call void @rt_async_return(ptr %s, i64 %s)\n", stateVal, bitsVal)
-	fmt.Fprintf(&fe.emitter.buf, "  unreachable\n")
+	fe.emitPollTerminatorReturn()
 	return nil
 }
 
@@ -683,6 +752,6 @@ func (fe *funcEmitter) emitTermAsyncReturnCancelled(term *mir.Terminator) error
 		return fmt.Errorf("async_cancel expects state pointer, got %s", stateTy)
 	}
 	fmt.Fprintf(&fe.emitter.buf, "  call void @rt_async_return_cancelled(ptr %s)\n", stateVal)
-	fmt.Fprintf(&fe.emitter.buf, "  unreachable\n")
+	fe.emitPollTerminatorReturn()
 	return nil
 }
@@ -0,0 +1,48 @@
+package llvm
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+)
+
+func TestEmitPollFramesUseTaskFrameArena(t *testing.T) {
+	sourceCode := `async fn twice(x: int) -> int {
+    checkpoint().await();
+    let y: int = x + 1;
+    checkpoint().await();
+    return y + 1;
+}
+
+@entrypoint
+fn main() -> int {
+    compare twice(1).await() {
+        Success(v) => return v;
+        Cancelled() => return 9;
+    };
+}
+`
+
+	mirMod, result := lowerMIRFromSource(t, sourceCode)
+	poll := findMIRFunc(t, mirMod, "twice$poll")
+	ctor := findMIRFunc(t, mirMod, "twice")
+	ir, err := EmitModule(mirMod, result.Sema.TypeInterner, result.Symbols.Table)
+	if err != nil {
+		t.Fatalf("emit LLVM IR: %v", err)
+	}
+
+	// Each suspension rebuilds the payload and the state struct.
+	pollBody := findLLVMFuncBody(t, ir, fmt.Sprintf("fn.%d", poll.ID))
+	if got := strings.Count(pollBody, "call ptr @rt_task_frame_alloc("); got < 4 {
+		t.Fatalf("poll function should build both frames in the task arena, got %d calls:\n%s", got, pollBody)
+	}
+
+	// The constructor runs before its task exists, so its frame must stay on the heap.
+	ctorBody := findLLVMFuncBody(t, ir, fmt.Sprintf("fn.%d", ctor.ID))
+	if strings.Contains(ctorBody, "@rt_task_frame_alloc(") {
+		t.Fatalf("constructor must not allocate from the current task's arena:\n%s", ctorBody)
+	}
+	if !strings.Contains(ctorBody, "call ptr @rt_alloc(") {
+		t.Fatalf("constructor should heap-allocate the initial frame:\n%s", ctorBody)
+	}
+}
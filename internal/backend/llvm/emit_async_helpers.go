@@ -35,6 +35,17 @@ func (fe *funcEmitter) taskResultInfo(resultType types.TypeID) (successIdx int,
 	return successCaseIdx, successMeta.PayloadTypes[0], nil
 }
 
+// allocFuncFor names the runtime allocator for a heap value of typeID. A poll function's
+// own state frame and payload go to the task's frame arena; everything else, including
+// the initial frame built by the constructor before the task exists, uses rt_alloc.
+func (fe *funcEmitter) allocFuncFor(typeID types.TypeID) string {
+	if fe.f != nil && typeID != types.NoTypeID &&
+		(typeID == fe.f.AsyncStateType || typeID == fe.f.AsyncPayloadType) {
+		return "rt_task_frame_alloc"
+	}
+	return "rt_alloc"
+}
+
 func (fe *funcEmitter) emitValueToI64(val, valTy string, typeID types.TypeID) (string, error) {
 	switch valTy {
 	case "i64":
@@ -0,0 +1,57 @@
+package llvm
+
+import (
+	"fmt"
+	"regexp"
+	"strings"
+	"testing"
+)
+
+func TestEmitPollFunctionsUseDirectReturnTable(t *testing.T) {
+	sourceCode := `async fn tick(x: int) -> int {
+    checkpoint().await();
+    return x + 1;
+}
+
+@entrypoint
+fn main() -> int {
+    compare tick(1).await() {
+        Success(v) => return v;
+        Cancelled() => return 9;
+    };
+}
+`
+
+	mirMod, result := lowerMIRFromSource(t, sourceCode)
+	poll := findMIRFunc(t, mirMod, "tick$poll")
+	ir, err := EmitModule(mirMod, result.Sema.TypeInterner, result.Symbols.Table)
+	if err != nil {
+		t.Fatalf("emit LLVM IR: %v", err)
+	}
+
+	body := findLLVMFuncBody(t, ir, fmt.Sprintf("fn.%d", poll.ID))
+	terminator := regexp.MustCompile(`call void @rt_async_(yield|return|return_cancelled)\([^)]*\)\n  (\S+)`)
+	matches := terminator.FindAllStringSubmatch(body, -1)
+	if len(matches) == 0 {
+		t.Fatalf("poll function has no async terminators:\n%s", body)
+	}
+	for _, m := range matches {
+		if m[2] != "ret" {
+			t.Fatalf("async terminator must be followed by ret, got %q:\n%s", m[2], body)
+		}
+	}
+
+	for _, want := range []string{
+		fmt.Sprintf("define internal void @__surge_poll_thunk.%d()", poll.ID),
+		fmt.Sprintf("ptr @__surge_poll_thunk.%d", poll.ID),
+		"@__surge_poll_fns = internal constant",
+		"call void @rt_async_register_poll_fns(ptr @__surge_poll_fns, i64 ",
+		fmt.Sprintf("@__surge_poll_name.%d = private unnamed_addr constant [5 x i8] %s", poll.ID, formatLLVMBytes([]byte("tick"), 5)),
+		"call void @rt_async_register_poll_names(ptr @__surge_poll_names, i64 ",
+		"@llvm.global_ctors = appending global",
+	} {
+		if !strings.Contains(ir, want) {
+			t.Fatalf("module missing %q:\n%s", want, ir)
+		}
+	}
+}
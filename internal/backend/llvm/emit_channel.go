@@ -240,6 +240,31 @@ func (fe *funcEmitter) emitChannelIntrinsic(call *mir.CallInstr) (bool, error) {
 			fmt.Fprintf(&fe.emitter.buf, "  store %s %s, ptr %s\n", dstTy, okVal, ptr)
 		}
 		return true, nil
+	case "send_many":
+		if len(call.Args) != 2 {
+			return true, fmt.Errorf("send_many expects 2 arguments")
+		}
+		if !isChannelType(fe.emitter.types, call.Args[0].Type) {
+			return false, nil
+		}
+		chVal, err := fe.emitChannelHandle(&call.Args[0])
+		if err != nil {
+			return true, err
+		}
+		sentVal, err := fe.emitChannelSendMany(chVal, &call.Args[1])
+		if err != nil {
+			return true, err
+		}
+		if call.HasDst {
+			dstType, err := fe.placeBaseType(call.Dst)
+			if err != nil {
+				return true, err
+			}
+			if err := fe.emitLenStore(call.Dst, dstType, sentVal); err != nil {
+				return true, err
+			}
+		}
+		return true, nil
 	case "try_recv":
 		if len(call.Args) != 1 {
 			return true, fmt.Errorf("try_recv expects 1 argument")
@@ -315,6 +340,82 @@ func (fe *funcEmitter) emitChannelIntrinsic(call *mir.CallInstr) (bool, error) {
 	}
 }
 
+// emitChannelSendMany hands the elements of values to rt_channel_send_many and returns
+// the i64 count it sent. Elements that are already 64-bit values are passed in place;
+// narrower ones are widened into a scratch buffer first.
+func (fe *funcEmitter) emitChannelSendMany(chVal string, values *mir.Operand) (string, error) {
+	elemType, elemLLVM, stride, _, err := fe.arrayElemLayout(values)
+	if err != nil {
+		return "", err
+	}
+	if !fe.emitter.types.IsCopy(resolveAliasAndOwn(fe.emitter.types, elemType)) {
+		return "", fmt.Errorf("send_many requires a Copy element type")
+	}
+	handlePtr, err := fe.emitHandleOperandPtr(values)
+	if err != nil {
+		return "", err
+	}
+	head := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = load ptr, ptr %s\n", head, handlePtr)
+	lenPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = getelementptr inbounds i8, ptr %s, i64 %d\n", lenPtr, head, arrayLenOffset)
+	lenVal := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = load i64, ptr %s\n", lenVal, lenPtr)
+	dataPtrPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = getelementptr inbounds i8, ptr %s, i64 %d\n", dataPtrPtr, head, arrayDataOffset)
+	dataPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = load ptr, ptr %s\n", dataPtr, dataPtrPtr)
+	sentVal := fe.nextTemp()
+	switch elemLLVM {
+	case "i64", "ptr", "double":
+		fmt.Fprintf(&fe.emitter.buf, "  %s = call i64 @rt_channel_send_many(ptr %s, ptr %s, i64 %s)\n", sentVal, chVal, dataPtr, lenVal)
+		return sentVal, nil
+	}
+
+	bytes := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = mul i64 %s, 8\n", bytes, lenVal)
+	bitsBuf := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_alloc(i64 %s, i64 8)\n", bitsBuf, bytes)
+	idxPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = alloca i64\n", idxPtr)
+	fmt.Fprintf(&fe.emitter.buf, "  store i64 0, ptr %s\n", idxPtr)
+	loopBB := fe.nextInlineBlock()
+	bodyBB := fe.nextInlineBlock()
+	doneBB := fe.nextInlineBlock()
+	fmt.Fprintf(&fe.emitter.buf, "  br label %%%s\n", loopBB)
+
+	fmt.Fprintf(&fe.emitter.buf, "%s:\n", loopBB)
+	idx := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = load i64, ptr %s\n", idx, idxPtr)
+	atEnd := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = icmp uge i64 %s, %s\n", atEnd, idx, lenVal)
+	fmt.Fprintf(&fe.emitter.buf, "  br i1 %s, label %%%s, label %%%s\n", atEnd, doneBB, bodyBB)
+
+	fmt.Fprintf(&fe.emitter.buf, "%s:\n", bodyBB)
+	off := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = mul i64 %s, %d\n", off, idx, stride)
+	elemPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = getelementptr inbounds i8, ptr %s, i64 %s\n", elemPtr, dataPtr, off)
+	elemVal := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = load %s, ptr %s\n", elemVal, elemLLVM, elemPtr)
+	bitsVal, err := fe.emitValueToI64(elemVal, elemLLVM, elemType)
+	if err != nil {
+		return "", err
+	}
+	slotPtr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = getelementptr inbounds i64, ptr %s, i64 %s\n", slotPtr, bitsBuf, idx)
+	fmt.Fprintf(&fe.emitter.buf, "  store i64 %s, ptr %s\n", bitsVal, slotPtr)
+	next := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = add i64 %s, 1\n", next, idx)
+	fmt.Fprintf(&fe.emitter.buf, "  store i64 %s, ptr %s\n", next, idxPtr)
+	fmt.Fprintf(&fe.emitter.buf, "  br label %%%s\n", loopBB)
+
+	fmt.Fprintf(&fe.emitter.buf, "%s:\n", doneBB)
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call i64 @rt_channel_send_many(ptr %s, ptr %s, i64 %s)\n", sentVal, chVal, bitsBuf, lenVal)
+	fmt.Fprintf(&fe.emitter.buf, "  call void @rt_free(ptr %s, i64 %s, i64 8)\n", bitsBuf, bytes)
+	return sentVal, nil
+}
+
 func (fe *funcEmitter) emitInstrChanSend(ins *mir.Instr) error {
 	if ins == nil {
 		return nil
@@ -10,13 +10,25 @@ func (fe *funcEmitter) emitStringConcat(left, right string) string {
 	return tmp
 }
 
+// emitStringConcatAll joins parts with a single runtime call once there are more than two,
+// so the result is sized and copied once instead of once per intermediate string.
 func (fe *funcEmitter) emitStringConcatAll(parts ...string) (string, error) {
-	if len(parts) == 0 {
+	switch len(parts) {
+	case 0:
 		return "", fmt.Errorf("string concat requires at least one part")
+	case 1:
+		return parts[0], nil
+	case 2:
+		return fe.emitStringConcat(parts[0], parts[1]), nil
 	}
-	out := parts[0]
-	for i := 1; i < len(parts); i++ {
-		out = fe.emitStringConcat(out, parts[i])
+	arr := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = alloca [%d x ptr]\n", arr, len(parts))
+	for i, part := range parts {
+		slot := fe.nextTemp()
+		fmt.Fprintf(&fe.emitter.buf, "  %s = getelementptr inbounds [%d x ptr], ptr %s, i64 0, i64 %d\n", slot, len(parts), arr, i)
+		fmt.Fprintf(&fe.emitter.buf, "  store ptr %s, ptr %s\n", part, slot)
 	}
-	return out, nil
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_string_concat_n(ptr %s, i64 %d)\n", tmp, arr, len(parts))
+	return tmp, nil
 }
@@ -0,0 +1,33 @@
+package llvm
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestEmitParseErrorMessageJoinsPartsInOneCall(t *testing.T) {
+	sourceCode := `@entrypoint
+fn main() -> int {
+    let text: string = "x";
+    let parsed = compare uint64.from_str(&text) {
+        Success(v) => v;
+        _ => {
+            return 1;
+        }
+    };
+    if parsed == 0:uint64 {
+        return 0;
+    }
+    return 2;
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+
+	if !strings.Contains(ir, "call ptr @rt_string_concat_n(ptr ") || !strings.Contains(ir, ", i64 5)") {
+		t.Fatalf("expected parse error message to be joined by one rt_string_concat_n call:\n%s", ir)
+	}
+	if !strings.Contains(ir, "declare ptr @rt_string_concat_n(ptr, i64)") {
+		t.Fatalf("expected rt_string_concat_n declaration in IR:\n%s", ir)
+	}
+}
@@ -190,7 +190,7 @@ func (fe *funcEmitter) emitTagValue(typeID types.TypeID, tagName string, tagSym
 		align = 1
 	}
 	mem := fe.nextTemp()
-	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_alloc(i64 %d, i64 %d)\n", mem, size, align)
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @%s(i64 %d, i64 %d)\n", mem, fe.allocFuncFor(typeID), size, align)
 	fmt.Fprintf(&fe.emitter.buf, "  store i32 %d, ptr %s\n", caseIdx, mem)
 
 	if len(meta.PayloadTypes) == 0 {
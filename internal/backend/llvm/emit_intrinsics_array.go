@@ -35,8 +35,22 @@ func (fe *funcEmitter) emitArrayIntrinsic(call *mir.CallInstr) (bool, error) {
 		return true, fe.emitByteArrayAppendRange(call)
 	case "rt_byte_array_drop_prefix":
 		return true, fe.emitByteArrayDropPrefix(call)
+	case "rt_byte_array_reserve_tail":
+		return true, fe.emitByteArrayReserveTail(call)
 	case "rt_byte_parse_uint64_token":
 		return true, fe.emitByteParseUint64Token(call)
+	case "rt_byte_find", "rt_byte_count":
+		return true, fe.emitByteScan(call, name, byteScanByte)
+	case "rt_byte_find2":
+		return true, fe.emitByteScan(call, name, byteScanByte, byteScanByte)
+	case "rt_byte_find3":
+		return true, fe.emitByteScan(call, name, byteScanByte, byteScanByte, byteScanByte)
+	case "rt_byte_find_set":
+		return true, fe.emitByteScan(call, name, byteScanSet)
+	case "rt_byte_skip_ascii_ws", "rt_byte_find_ascii_ws", "rt_json_scan_string":
+		return true, fe.emitByteScan(call, name)
+	case "rt_json_structural_index":
+		return true, fe.emitByteScan(call, name, byteScanSlot)
 	default:
 		return false, nil
 	}
@@ -546,6 +560,38 @@ func (fe *funcEmitter) emitByteArrayDropPrefix(call *mir.CallInstr) error {
 	return nil
 }
 
+func (fe *funcEmitter) emitByteArrayReserveTail(call *mir.CallInstr) error {
+	if len(call.Args) != 3 {
+		return fmt.Errorf("rt_byte_array_reserve_tail requires 3 arguments")
+	}
+	slot, err := fe.emitHandleOperandPtr(&call.Args[0])
+	if err != nil {
+		return err
+	}
+	start64, err := fe.emitUintOperandToI64(&call.Args[1], "byte queue start out of range")
+	if err != nil {
+		return err
+	}
+	spare64, err := fe.emitUintOperandToI64(&call.Args[2], "byte reserve spare out of range")
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call i64 @rt_byte_array_reserve_tail(ptr %s, i64 %s, i64 %s)\n", tmp, slot, start64, spare64)
+	if !call.HasDst {
+		return nil
+	}
+	ptr, dstTy, err := fe.emitPlacePtr(call.Dst)
+	if err != nil {
+		return err
+	}
+	if dstTy != "i64" {
+		dstTy = "i64"
+	}
+	fmt.Fprintf(&fe.emitter.buf, "  store %s %s, ptr %s\n", dstTy, tmp, ptr)
+	return nil
+}
+
 func (fe *funcEmitter) emitByteParseUint64Token(call *mir.CallInstr) error {
 	if len(call.Args) != 5 {
 		return fmt.Errorf("rt_byte_parse_uint64_token requires 5 arguments")
@@ -592,6 +638,70 @@ func (fe *funcEmitter) emitByteParseUint64Token(call *mir.CallInstr) error {
 	return nil
 }
 
+// byteScanArg is the kind of an argument that follows data, start, and end in a byte
+// scanning intrinsic.
+type byteScanArg int
+
+const (
+	byteScanByte byteScanArg = iota // byte needle, passed as i8
+	byteScanSet                     // &byte[] needle set, passed as the array handle
+	byteScanSlot                    // &mut array out param, passed as the slot
+)
+
+// emitByteScan lowers the rt_byte_*/rt_json_* scanners, which all take (data: &byte[],
+// start: uint64, end: uint64, extra...) and return a uint64 offset or count.
+func (fe *funcEmitter) emitByteScan(call *mir.CallInstr, name string, extra ...byteScanArg) error {
+	if len(call.Args) != 3+len(extra) {
+		return fmt.Errorf("%s requires %d arguments", name, 3+len(extra))
+	}
+	dataHead, err := fe.emitByteArrayHandle(&call.Args[0])
+	if err != nil {
+		return err
+	}
+	start64, err := fe.emitUint64BitsOperand(&call.Args[1])
+	if err != nil {
+		return err
+	}
+	end64, err := fe.emitUint64BitsOperand(&call.Args[2])
+	if err != nil {
+		return err
+	}
+	args := fmt.Sprintf("ptr %s, i64 %s, i64 %s", dataHead, start64, end64)
+	for i, kind := range extra {
+		op := &call.Args[3+i]
+		var val string
+		switch kind {
+		case byteScanByte:
+			var ty string
+			val, ty, err = fe.emitValueOperand(op)
+			if err == nil && ty != "i8" {
+				err = fmt.Errorf("%s byte argument must be i8, got %s", name, ty)
+			}
+			args += ", i8 " + val
+		case byteScanSet:
+			val, err = fe.emitByteArrayHandle(op)
+			args += ", ptr " + val
+		case byteScanSlot:
+			val, err = fe.emitHandleOperandPtr(op)
+			args += ", ptr " + val
+		}
+		if err != nil {
+			return err
+		}
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call i64 @%s(%s)\n", tmp, name, args)
+	if !call.HasDst {
+		return nil
+	}
+	ptr, _, err := fe.emitPlacePtr(call.Dst)
+	if err != nil {
+		return err
+	}
+	fmt.Fprintf(&fe.emitter.buf, "  store i64 %s, ptr %s\n", tmp, ptr)
+	return nil
+}
+
 func (fe *funcEmitter) emitUint64BitsOperand(op *mir.Operand) (string, error) {
 	val, ty, err := fe.emitValueOperand(op)
 	if err != nil {
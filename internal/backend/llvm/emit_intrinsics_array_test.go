@@ -31,8 +31,9 @@ fn main() -> int {
     let mut out: byte[] = [];
     append_range(&mut out, &source);
     rt_byte_array_drop_prefix(&mut out, 1:uint64);
+    let dropped: uint64 = rt_byte_array_reserve_tail(&mut out, 1:uint64, 64:uint64);
     let _ = parse_token(&source);
-    return out.__len() to int;
+    return (out.__len() + (dropped to uint)) to int;
 }
 `
 
@@ -55,6 +56,9 @@ fn main() -> int {
 	if !regexp.MustCompile(`call void @rt_byte_array_drop_prefix\(`).MatchString(ir) {
 		t.Fatalf("expected byte drop-prefix intrinsic in IR:\n%s", ir)
 	}
+	if !regexp.MustCompile(`%t\d+ = call i64 @rt_byte_array_reserve_tail\(ptr [^,]+, i64 [^,]+, i64 [^)]+\)`).MatchString(ir) {
+		t.Fatalf("expected byte reserve-tail intrinsic returning the dropped count in IR:\n%s", ir)
+	}
 	if !regexp.MustCompile(`call i1 @rt_byte_parse_uint64_token\(`).MatchString(ir) {
 		t.Fatalf("expected byte uint64 token parse intrinsic in IR:\n%s", ir)
 	}
@@ -67,3 +71,55 @@ fn main() -> int {
 		t.Fatalf("rt_byte_parse_uint64_token source was not loaded as an array handle:\n%s", ir)
 	}
 }
+
+func TestEmitByteScanIntrinsicsPassArrayHandles(t *testing.T) {
+	repoRoot, err := filepath.Abs("../../..")
+	if err != nil {
+		t.Fatalf("resolve repo root: %v", err)
+	}
+	t.Setenv("SURGE_STDLIB", repoRoot)
+
+	sourceCode := `fn scan(src: &byte[], needles: &byte[]) -> uint64 {
+    let end: uint64 = src.__len() to uint64;
+    let mut total: uint64 = rt_byte_find(src, 0:uint64, end, 10:byte);
+    total = total + rt_byte_find2(src, 0:uint64, end, 13:byte, 10:byte);
+    total = total + rt_byte_find3(src, 0:uint64, end, 34:byte, 92:byte, 10:byte);
+    total = total + rt_byte_find_set(src, 0:uint64, end, needles);
+    total = total + rt_byte_count(src, 0:uint64, end, 10:byte);
+    total = total + rt_byte_skip_ascii_ws(src, 0:uint64, end);
+    total = total + rt_byte_find_ascii_ws(src, 0:uint64, end);
+    total = total + rt_json_scan_string(src, 0:uint64, end);
+    let mut index: uint64[] = [];
+    return total + rt_json_structural_index(src, 0:uint64, end, &mut index);
+}
+
+@entrypoint
+fn main() -> int {
+    let source: byte[] = "{\"a\": [1, 2]}\n" to byte[];
+    let delims: byte[] = ",:" to byte[];
+    return scan(&source, &delims) to int;
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+
+	for _, call := range []string{
+		`call i64 @rt_byte_find\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, i8 [^,)]+\)`,
+		`call i64 @rt_byte_find2\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, i8 [^,)]+, i8 [^,)]+\)`,
+		`call i64 @rt_byte_find3\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, i8 [^,)]+, i8 [^,)]+, i8 [^,)]+\)`,
+		`call i64 @rt_byte_find_set\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, ptr %t\d+\)`,
+		`call i64 @rt_byte_count\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, i8 [^,)]+\)`,
+		`call i64 @rt_byte_skip_ascii_ws\(ptr (%t\d+), i64 [^,]+, i64 [^)]+\)`,
+		`call i64 @rt_byte_find_ascii_ws\(ptr (%t\d+), i64 [^,]+, i64 [^)]+\)`,
+		`call i64 @rt_json_scan_string\(ptr (%t\d+), i64 [^,]+, i64 [^)]+\)`,
+		`call i64 @rt_json_structural_index\(ptr (%t\d+), i64 [^,]+, i64 [^,]+, ptr [^)]+\)`,
+	} {
+		matches := regexp.MustCompile(call).FindStringSubmatch(ir)
+		if len(matches) != 2 {
+			t.Fatalf("expected %s in IR:\n%s", call, ir)
+		}
+		if !strings.Contains(ir, matches[1]+" = load ptr, ptr ") {
+			t.Fatalf("%s source was not loaded as an array handle:\n%s", call, ir)
+		}
+	}
+}
@@ -30,7 +30,11 @@ func (fe *funcEmitter) emitFsIntrinsic(call *mir.CallInstr) (bool, error) {
 	case "rt_fs_flush":
 		return true, fe.emitFsUnary(call, "rt_fs_flush")
 	case "rt_fs_read_file":
-		return true, fe.emitFsReadFile(call)
+		return true, fe.emitFsPathUnary(call, "rt_fs_read_file")
+	case "rt_fs_map_file":
+		return true, fe.emitFsPathUnary(call, "rt_fs_map_file")
+	case "rt_fs_read_into":
+		return true, fe.emitFsReadInto(call)
 	case "rt_fs_write_file":
 		return true, fe.emitFsWriteFile(call)
 	case "rt_fs_file_name":
@@ -132,16 +136,37 @@ func (fe *funcEmitter) emitFsSeek(call *mir.CallInstr) error {
 	return fe.storePtrResult(call, tmp)
 }
 
-func (fe *funcEmitter) emitFsReadFile(call *mir.CallInstr) error {
+func (fe *funcEmitter) emitFsPathUnary(call *mir.CallInstr, name string) error {
 	if len(call.Args) != 1 {
-		return fmt.Errorf("rt_fs_read_file requires 1 argument")
+		return fmt.Errorf("%s requires 1 argument", name)
 	}
 	pathVal, err := fe.emitHandleOperandPtr(&call.Args[0])
 	if err != nil {
 		return err
 	}
 	tmp := fe.nextTemp()
-	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_fs_read_file(ptr %s)\n", tmp, pathVal)
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @%s(ptr %s)\n", tmp, name, pathVal)
+	return fe.storePtrResult(call, tmp)
+}
+
+func (fe *funcEmitter) emitFsReadInto(call *mir.CallInstr) error {
+	if len(call.Args) != 3 {
+		return fmt.Errorf("rt_fs_read_into requires 3 arguments")
+	}
+	fileVal, err := fe.emitFsFileHandle(&call.Args[0])
+	if err != nil {
+		return err
+	}
+	bufSlot, err := fe.emitHandleOperandPtr(&call.Args[1])
+	if err != nil {
+		return err
+	}
+	cap64, err := fe.emitUintOperandToI64(&call.Args[2], "fs read cap out of range")
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_fs_read_into(ptr %s, ptr %s, i64 %s)\n", tmp, fileVal, bufSlot, cap64)
 	return fe.storePtrResult(call, tmp)
 }
 
@@ -0,0 +1,33 @@
+package llvm
+
+import (
+	"regexp"
+	"testing"
+)
+
+func TestEmitFsMapFileAndReadIntoCallRuntime(t *testing.T) {
+	sourceCode := `@entrypoint
+fn main() -> int {
+    let path: string = "data.txt";
+    let file: File = { __opaque: 0 };
+    let mut buf: byte[] = [];
+    let map_res: Erring<BytesView, FsError> = rt_fs_map_file(&path);
+    let _ = map_res;
+    let read_res: Erring<uint, FsError> = rt_fs_read_into(&file, &mut buf, 4096:uint);
+    let _ = read_res;
+    return 0;
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+
+	if !regexp.MustCompile(`call ptr @rt_fs_map_file\(ptr [^)]+\)`).MatchString(ir) {
+		t.Fatalf("expected rt_fs_map_file call in IR:\n%s", ir)
+	}
+	if !regexp.MustCompile(`call ptr @rt_fs_read_into\(ptr [^,]+, ptr [^,]+, i64 4096\)`).MatchString(ir) {
+		t.Fatalf("expected rt_fs_read_into call in IR:\n%s", ir)
+	}
+	if !regexp.MustCompile(`declare ptr @rt_fs_read_into\(ptr, ptr, i64\)`).MatchString(ir) {
+		t.Fatalf("expected rt_fs_read_into declaration in IR:\n%s", ir)
+	}
+}
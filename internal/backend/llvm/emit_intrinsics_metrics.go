@@ -0,0 +1,60 @@
+package llvm
+
+import (
+	"fmt"
+
+	"surge/internal/mir"
+)
+
+// emitRtMetricsText lowers rt_metrics_json and rt_metrics_prometheus, which render the
+// current runtime metrics snapshot into a fresh string.
+func (fe *funcEmitter) emitRtMetricsText(call *mir.CallInstr, name string) error {
+	if call == nil {
+		return nil
+	}
+	if len(call.Args) != 0 {
+		return fmt.Errorf("%s requires 0 arguments", name)
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @%s()\n", tmp, name)
+	if !call.HasDst {
+		return nil
+	}
+	ptr, dstTy, err := fe.emitPlacePtr(call.Dst)
+	if err != nil {
+		return err
+	}
+	if dstTy != "ptr" {
+		dstTy = "ptr"
+	}
+	fmt.Fprintf(&fe.emitter.buf, "  store %s %s, ptr %s\n", dstTy, tmp, ptr)
+	return nil
+}
+
+// emitRtMetricsValue lowers rt_metrics_value; the runtime returns -1 for unknown names.
+func (fe *funcEmitter) emitRtMetricsValue(call *mir.CallInstr) error {
+	if call == nil {
+		return nil
+	}
+	if len(call.Args) != 1 {
+		return fmt.Errorf("rt_metrics_value requires 1 argument")
+	}
+	namePtr, err := fe.emitHandleOperandPtr(&call.Args[0])
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call i64 @rt_metrics_value(ptr %s)\n", tmp, namePtr)
+	if !call.HasDst {
+		return nil
+	}
+	ptr, dstTy, err := fe.emitPlacePtr(call.Dst)
+	if err != nil {
+		return err
+	}
+	if dstTy != "i64" {
+		return fmt.Errorf("rt_metrics_value requires int64 destination, got %s", dstTy)
+	}
+	fmt.Fprintf(&fe.emitter.buf, "  store i64 %s, ptr %s\n", tmp, ptr)
+	return nil
+}
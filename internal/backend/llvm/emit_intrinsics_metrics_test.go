@@ -0,0 +1,34 @@
+package llvm
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestEmitMetricsIntrinsicsCallRuntime(t *testing.T) {
+	t.Setenv("SURGE_STDLIB", repoRootFromLLVMTest(t))
+
+	sourceCode := `import stdlib/metrics as metrics;
+
+@entrypoint
+fn main() -> int {
+    let _ = metrics.json();
+    let _ = metrics.prometheus();
+    compare metrics.value("task_polls") {
+        Some(_) => return 0;
+        nothing => return 1;
+    };
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+	for _, want := range []string{
+		"call ptr @rt_metrics_json()",
+		"call ptr @rt_metrics_prometheus()",
+		"call i64 @rt_metrics_value(ptr ",
+	} {
+		if !strings.Contains(ir, want) {
+			t.Fatalf("expected %q in emitted IR:\n%s", want, ir)
+		}
+	}
+}
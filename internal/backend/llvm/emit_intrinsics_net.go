@@ -33,8 +33,14 @@ func (fe *funcEmitter) emitNetIntrinsic(call *mir.CallInstr) (bool, error) {
 		return true, fe.emitNetWrite(call)
 	case "rt_net_read_bytes":
 		return true, fe.emitNetReadBytes(call)
+	case "rt_net_read_into":
+		return true, fe.emitNetReadInto(call)
 	case "rt_net_write_bytes":
 		return true, fe.emitNetWriteBytes(call)
+	case "rt_net_write_vectored":
+		return true, fe.emitNetWriteVectored(call)
+	case "rt_net_send_file":
+		return true, fe.emitNetSendFile(call)
 	case "rt_net_wait_accept":
 		return true, fe.emitNetWait(call, "rt_net_wait_accept", "TcpListener")
 	case "rt_net_wait_readable":
@@ -158,6 +164,27 @@ func (fe *funcEmitter) emitNetReadBytes(call *mir.CallInstr) error {
 	return fe.storePtrResult(call, tmp)
 }
 
+func (fe *funcEmitter) emitNetReadInto(call *mir.CallInstr) error {
+	if len(call.Args) != 3 {
+		return fmt.Errorf("rt_net_read_into requires 3 arguments")
+	}
+	connVal, err := fe.emitNetHandle(&call.Args[0], "TcpConn")
+	if err != nil {
+		return err
+	}
+	bufSlot, err := fe.emitHandleOperandPtr(&call.Args[1])
+	if err != nil {
+		return err
+	}
+	cap64, err := fe.emitUintOperandToI64(&call.Args[2], "net read cap out of range")
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_net_read_into(ptr %s, ptr %s, i64 %s)\n", tmp, connVal, bufSlot, cap64)
+	return fe.storePtrResult(call, tmp)
+}
+
 func (fe *funcEmitter) emitNetWriteBytes(call *mir.CallInstr) error {
 	if len(call.Args) != 4 {
 		return fmt.Errorf("rt_net_write_bytes requires 4 arguments")
@@ -183,6 +210,52 @@ func (fe *funcEmitter) emitNetWriteBytes(call *mir.CallInstr) error {
 	return fe.storePtrResult(call, tmp)
 }
 
+func (fe *funcEmitter) emitNetWriteVectored(call *mir.CallInstr) error {
+	if len(call.Args) != 3 {
+		return fmt.Errorf("rt_net_write_vectored requires 3 arguments")
+	}
+	connVal, err := fe.emitNetHandle(&call.Args[0], "TcpConn")
+	if err != nil {
+		return err
+	}
+	partsVal, err := fe.emitByteArrayHandle(&call.Args[1])
+	if err != nil {
+		return err
+	}
+	offset64, err := fe.emitUintOperandToI64(&call.Args[2], "net write offset out of range")
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_net_write_vectored(ptr %s, ptr %s, i64 %s)\n", tmp, connVal, partsVal, offset64)
+	return fe.storePtrResult(call, tmp)
+}
+
+func (fe *funcEmitter) emitNetSendFile(call *mir.CallInstr) error {
+	if len(call.Args) != 4 {
+		return fmt.Errorf("rt_net_send_file requires 4 arguments")
+	}
+	connVal, err := fe.emitNetHandle(&call.Args[0], "TcpConn")
+	if err != nil {
+		return err
+	}
+	fileVal, err := fe.emitFsFileHandle(&call.Args[1])
+	if err != nil {
+		return err
+	}
+	offset64, err := fe.emitUintOperandToI64(&call.Args[2], "net send file offset out of range")
+	if err != nil {
+		return err
+	}
+	len64, err := fe.emitUintOperandToI64(&call.Args[3], "net send file length out of range")
+	if err != nil {
+		return err
+	}
+	tmp := fe.nextTemp()
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_net_send_file(ptr %s, ptr %s, i64 %s, i64 %s)\n", tmp, connVal, fileVal, offset64, len64)
+	return fe.storePtrResult(call, tmp)
+}
+
 func (fe *funcEmitter) emitNetUnary(call *mir.CallInstr, name, kind string) error {
 	if len(call.Args) != 1 {
 		return fmt.Errorf("%s requires 1 argument", name)
@@ -52,3 +52,51 @@ fn main() -> int {
 		t.Fatalf("net wait must not materialize a Task handle:\n%s", ir)
 	}
 }
+
+func TestEmitNetReadIntoCallsRuntime(t *testing.T) {
+	sourceCode := `@entrypoint
+fn main() -> int {
+    let conn: TcpConn = { __opaque: 0 };
+    let mut buf: byte[] = [];
+    let read_res: NetResult<uint> = rt_net_read_into(&conn, &mut buf, 64:uint);
+    let _ = read_res;
+    return 0;
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+
+	if !regexp.MustCompile(`call ptr @rt_net_read_into\(ptr [^,]+, ptr [^,]+, i64 64\)`).MatchString(ir) {
+		t.Fatalf("expected rt_net_read_into call in IR:\n%s", ir)
+	}
+	if !regexp.MustCompile(`declare ptr @rt_net_read_into\(ptr, ptr, i64\)`).MatchString(ir) {
+		t.Fatalf("expected rt_net_read_into declaration in IR:\n%s", ir)
+	}
+}
+
+func TestEmitNetGatherAndSendFileCallRuntime(t *testing.T) {
+	sourceCode := `@entrypoint
+fn main() -> int {
+    let conn: TcpConn = { __opaque: 0 };
+    let file: File = { __opaque: 0 };
+    let parts: byte[][] = [];
+    let write_res: NetResult<uint> = rt_net_write_vectored(&conn, &parts, 3:uint);
+    let send_res: NetResult<uint> = rt_net_send_file(&conn, &file, 5:uint, 7:uint);
+    let _ = write_res;
+    let _ = send_res;
+    return 0;
+}
+`
+
+	ir := emitLLVMFromSource(t, sourceCode)
+
+	if !regexp.MustCompile(`call ptr @rt_net_write_vectored\(ptr [^,]+, ptr [^,]+, i64 3\)`).MatchString(ir) {
+		t.Fatalf("expected rt_net_write_vectored call in IR:\n%s", ir)
+	}
+	if !regexp.MustCompile(`call ptr @rt_net_send_file\(ptr [^,]+, ptr [^,]+, i64 5, i64 7\)`).MatchString(ir) {
+		t.Fatalf("expected rt_net_send_file call in IR:\n%s", ir)
+	}
+	if !regexp.MustCompile(`declare ptr @rt_net_send_file\(ptr, ptr, i64, i64\)`).MatchString(ir) {
+		t.Fatalf("expected rt_net_send_file declaration in IR:\n%s", ir)
+	}
+}
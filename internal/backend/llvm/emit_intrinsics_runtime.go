@@ -81,6 +81,10 @@ func (fe *funcEmitter) emitRuntimeIntrinsic(call *mir.CallInstr) (bool, error) {
 		return true, fe.emitRtMonotonicNow(call)
 	case "rt_worker_count":
 		return true, fe.emitRtWorkerCount(call)
+	case "rt_metrics_json", "rt_metrics_prometheus":
+		return true, fe.emitRtMetricsText(call, name)
+	case "rt_metrics_value":
+		return true, fe.emitRtMetricsValue(call)
 	case "rt_exit":
 		return true, fe.emitRtExit(call)
 	case "rt_string_index":
@@ -21,7 +21,7 @@ func (fe *funcEmitter) emitStructLit(lit *mir.StructLit) (val, ty string, err er
 		align = 1
 	}
 	mem := fe.nextTemp()
-	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @rt_alloc(i64 %d, i64 %d)\n", mem, size, align)
+	fmt.Fprintf(&fe.emitter.buf, "  %s = call ptr @%s(i64 %d, i64 %d)\n", mem, fe.allocFuncFor(lit.TypeID), size, align)
 	for i := range lit.Fields {
 		field := &lit.Fields[i]
 		fieldIdx, fieldType, err := fe.structFieldInfo(lit.TypeID, mir.PlaceProj{Kind: mir.PlaceProjField, FieldName: field.Name, FieldIdx: -1})
@@ -27,6 +27,7 @@ type BuildRequest struct {
 	OutputRoot    string
 	Profile       string
 	Backend       Backend
+	LTO           LTOMode
 	EmitMIR       bool
 	EmitLLVM      bool
 	KeepTmp       bool
@@ -148,7 +149,7 @@ func Build(ctx context.Context, req *BuildRequest) (BuildResult, error) {
 
 		linkStart := time.Now()
 		emitStage(req.Progress, req.Files, StageLink, StatusWorking, nil, 0)
-		if err := buildLLVMOutput(tmpDir, outputPath, req.PrintCommands); err != nil {
+		if err := buildLLVMOutput(tmpDir, outputPath, req.LTO, req.PrintCommands); err != nil {
 			emitStage(req.Progress, req.Files, StageLink, StatusError, err, 0)
 			return result, err
 		}
@@ -210,25 +211,28 @@ func ensureClangAvailable() error {
 	return nil
 }
 
-func buildLLVMOutput(tmpDir, outputPath string, printCommands bool) error {
-	runtimeDir, runtimeSources, err := extractNativeRuntime(tmpDir)
-	if err != nil {
-		return err
-	}
-	runtimeObjs, err := compileRuntime(runtimeDir, runtimeSources, printCommands)
-	if err != nil {
-		return err
-	}
-	libPath, err := archiveRuntime(runtimeDir, runtimeObjs, printCommands)
+func buildLLVMOutput(tmpDir, outputPath string, lto LTOMode, printCommands bool) error {
+	libPath, err := nativeRuntimeArchive(tmpDir, lto, printCommands)
 	if err != nil {
 		return err
 	}
 	objPath := filepath.Join(tmpDir, "out.o")
 	llPath := filepath.Join(tmpDir, "out.ll")
-	if err := compileLLVMIR(printCommands, llPath, objPath); err != nil {
+	if lto != LTOOff {
+		// out.o stays bitcode so the linker can inline runtime helpers into it.
+		if err := runCommand(printCommands, "clang", "-c", "-x", "ir", "-O3", "-flto="+string(lto), llPath, "-o", objPath); err != nil {
+			return err
+		}
+	} else if err := compileLLVMIR(printCommands, llPath, objPath); err != nil {
 		return err
 	}
 	args := []string{objPath, libPath, "-o", outputPath}
+	if lto != LTOOff {
+		args = append([]string{"-O3", "-flto=" + string(lto)}, args...)
+		if runtime.GOOS == "linux" {
+			args = append(args, "-fuse-ld=lld")
+		}
+	}
 	if runtime.GOOS != "windows" {
 		args = append(args, "-pthread")
 	}
@@ -334,31 +338,18 @@ func runtimeFileAllowed(entryPath string) bool {
 	return true
 }
 
-func compileRuntime(runtimeDir string, sources []string, printCommands bool) ([]string, error) {
-	objs := make([]string, 0, len(sources))
-	for _, src := range sources {
-		base := strings.TrimSuffix(filepath.Base(src), filepath.Ext(src))
-		obj := filepath.Join(runtimeDir, base+".o")
-		args := []string{"-c", "-std=c11"}
-		if runtime.GOOS != "windows" {
-			args = append(args, "-pthread")
-		}
-		args = append(args, src, "-o", obj)
-		if err := runCommand(printCommands, "clang", args...); err != nil {
-			return nil, err
-		}
-		objs = append(objs, obj)
+func archiveRuntime(runtimeDir string, objs []string, lto LTOMode, printCommands bool) (string, error) {
+	// Only llvm-ar can write a symbol index for bitcode members.
+	tool := "ar"
+	if lto != LTOOff {
+		tool = "llvm-ar"
 	}
-	return objs, nil
-}
-
-func archiveRuntime(runtimeDir string, objs []string, printCommands bool) (string, error) {
-	if _, err := exec.LookPath("ar"); err != nil {
-		return "", fmt.Errorf("ar not found; install with: sudo apt-get update && sudo apt-get install -y clang llvm lld")
+	if _, err := exec.LookPath(tool); err != nil {
+		return "", fmt.Errorf("%s not found; install with: sudo apt-get update && sudo apt-get install -y clang llvm lld", tool)
 	}
-	libPath := filepath.Join(runtimeDir, "libruntime_native.a")
+	libPath := filepath.Join(runtimeDir, runtimeArchiveName)
 	args := append([]string{"rcs", libPath}, objs...)
-	if err := runCommand(printCommands, "ar", args...); err != nil {
+	if err := runCommand(printCommands, tool, args...); err != nil {
 		return "", err
 	}
 	return libPath, nil
@@ -0,0 +1,207 @@
+package buildpipeline
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"io"
+	"io/fs"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"runtime"
+	"strings"
+
+	"golang.org/x/sync/errgroup"
+
+	runtimeembed "surge/runtime"
+)
+
+// runtimeCacheSchema is mixed into every runtime cache key; bump it when the
+// archive layout or the way it is produced changes.
+const runtimeCacheSchema = "surge-native-runtime-v1"
+
+const runtimeArchiveName = "libruntime_native.a"
+
+// runtimeCompileFlags are the clang flags every runtime source is compiled with.
+// They are part of the cache key. LTO builds emit optimized bitcode instead of
+// native objects.
+func runtimeCompileFlags(lto LTOMode) []string {
+	flags := []string{"-c", "-std=c11"}
+	if lto != LTOOff {
+		flags = append(flags, "-O3", "-flto="+string(lto))
+	}
+	if runtime.GOOS != "windows" {
+		flags = append(flags, "-pthread")
+	}
+	return flags
+}
+
+// nativeRuntimeArchive returns the path of a runtime archive for this compiler,
+// clang, and target. Warm builds link the archive straight from the cache dir;
+// a miss compiles the runtime into tmpDir and stores the result. Setting
+// SURGE_RUNTIME_CACHE=off always compiles.
+func nativeRuntimeArchive(tmpDir string, lto LTOMode, printCommands bool) (string, error) {
+	cacheDir := runtimeCacheDir()
+	var key string
+	if cacheDir != "" {
+		var err error
+		key, err = runtimeCacheKey(lto)
+		if err != nil {
+			cacheDir = ""
+		}
+	}
+	var cached string
+	if cacheDir != "" {
+		cached = filepath.Join(cacheDir, key, runtimeArchiveName)
+		if info, err := os.Stat(cached); err == nil && info.Mode().IsRegular() {
+			if printCommands {
+				if _, printErr := fmt.Fprintf(os.Stdout, "note: using cached native runtime %s\n", cached); printErr != nil {
+					return "", fmt.Errorf("failed to print command: %w", printErr)
+				}
+			}
+			return cached, nil
+		}
+	}
+
+	runtimeDir, runtimeSources, err := extractNativeRuntime(tmpDir)
+	if err != nil {
+		return "", err
+	}
+	runtimeObjs, err := compileRuntime(runtimeDir, runtimeSources, lto, printCommands)
+	if err != nil {
+		return "", err
+	}
+	libPath, err := archiveRuntime(runtimeDir, runtimeObjs, lto, printCommands)
+	if err != nil {
+		return "", err
+	}
+	if cached != "" {
+		// A cache that cannot be written only costs the next build a recompile.
+		if storeErr := storeRuntimeArchive(libPath, cached); storeErr == nil {
+			return cached, nil
+		}
+	}
+	return libPath, nil
+}
+
+// runtimeCacheDir returns the runtime cache root, or "" when caching is off or
+// no cache location is available.
+func runtimeCacheDir() string {
+	switch strings.ToLower(strings.TrimSpace(os.Getenv("SURGE_RUNTIME_CACHE"))) {
+	case "0", "off", "false", "no":
+		return ""
+	}
+	base := os.Getenv("XDG_CACHE_HOME")
+	if base == "" {
+		home, err := os.UserHomeDir()
+		if err != nil {
+			return ""
+		}
+		base = filepath.Join(home, ".cache")
+	}
+	return filepath.Join(base, "surge", "runtime")
+}
+
+// runtimeCacheKey hashes everything that changes the archive: the embedded
+// runtime sources selected for this OS, the clang version, the target triple,
+// and the compile flags.
+func runtimeCacheKey(lto LTOMode) (string, error) {
+	versionOut, err := exec.Command("clang", "--version").Output()
+	if err != nil {
+		return "", err
+	}
+	return runtimeCacheKeyFor(strings.TrimSpace(string(versionOut)), hostTripleFromClang(),
+		runtimeCompileFlags(lto), runtimeembed.NativeRuntimeFS())
+}
+
+// runtimeCacheKeyFor computes the key from explicit inputs; fsys holds the
+// runtime sources under "native".
+func runtimeCacheKeyFor(clangVersion, triple string, flags []string, fsys fs.FS) (string, error) {
+	h := sha256.New()
+	writeField := func(s string) {
+		_, _ = fmt.Fprintf(h, "%d:%s\n", len(s), s)
+	}
+	writeField(runtimeCacheSchema)
+	writeField(clangVersion)
+	writeField(triple)
+	writeField(runtime.GOOS + "/" + runtime.GOARCH)
+	writeField(strings.Join(flags, " "))
+
+	walkErr := fs.WalkDir(fsys, "native", func(entryPath string, d fs.DirEntry, err error) error {
+		if err != nil {
+			return err
+		}
+		if d.IsDir() || !runtimeFileAllowed(entryPath) {
+			return nil
+		}
+		data, errReadFile := fs.ReadFile(fsys, entryPath)
+		if errReadFile != nil {
+			return errReadFile
+		}
+		writeField(entryPath)
+		writeField(string(data))
+		return nil
+	})
+	if walkErr != nil {
+		return "", walkErr
+	}
+	return hex.EncodeToString(h.Sum(nil)), nil
+}
+
+// storeRuntimeArchive copies a freshly built archive into the cache. The copy
+// lands under a temp name and is renamed into place, so concurrent builds never
+// link a partial archive.
+func storeRuntimeArchive(libPath, cached string) (err error) {
+	dir := filepath.Dir(cached)
+	// #nosec G703 -- dir is rooted under the user's cache directory for this application.
+	if err = os.MkdirAll(dir, 0o750); err != nil {
+		return err
+	}
+	// #nosec G304 -- libPath is the archive this build just produced
+	src, err := os.Open(libPath)
+	if err != nil {
+		return err
+	}
+	defer func() {
+		if closeErr := src.Close(); closeErr != nil && err == nil {
+			err = closeErr
+		}
+	}()
+	tmp, err := os.CreateTemp(dir, "tmp-*")
+	if err != nil {
+		return err
+	}
+	tmpName := tmp.Name()
+	if _, err = io.Copy(tmp, src); err != nil {
+		return errors.Join(err, tmp.Close(), os.Remove(tmpName))
+	}
+	if err = tmp.Close(); err != nil {
+		return errors.Join(err, os.Remove(tmpName))
+	}
+	if err = os.Rename(tmpName, cached); err != nil {
+		return errors.Join(err, os.Remove(tmpName))
+	}
+	return nil
+}
+
+// compileRuntime compiles the runtime sources in parallel, one clang per CPU.
+func compileRuntime(runtimeDir string, sources []string, lto LTOMode, printCommands bool) ([]string, error) {
+	objs := make([]string, len(sources))
+	var g errgroup.Group
+	g.SetLimit(runtime.GOMAXPROCS(0))
+	for i, src := range sources {
+		base := strings.TrimSuffix(filepath.Base(src), filepath.Ext(src))
+		obj := filepath.Join(runtimeDir, base+".o")
+		objs[i] = obj
+		g.Go(func() error {
+			args := append(runtimeCompileFlags(lto), src, "-o", obj)
+			return runCommand(printCommands, "clang", args...)
+		})
+	}
+	if err := g.Wait(); err != nil {
+		return nil, err
+	}
+	return objs, nil
+}
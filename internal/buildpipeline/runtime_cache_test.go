@@ -0,0 +1,163 @@
+package buildpipeline
+
+import (
+	"bytes"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"testing"
+	"testing/fstest"
+
+	runtimeembed "surge/runtime"
+)
+
+func testRuntimeSources() fstest.MapFS {
+	return fstest.MapFS{
+		"native/rt.h":       {Data: []byte("void rt_init(void);\n")},
+		"native/rt_alloc.c": {Data: []byte("void rt_init(void) {}\n")},
+	}
+}
+
+func mustRuntimeCacheKey(t *testing.T, version string, flags []string, fsys fstest.MapFS) string {
+	t.Helper()
+	key, err := runtimeCacheKeyFor(version, "x86_64-unknown-linux-gnu", flags, fsys)
+	if err != nil {
+		t.Fatalf("runtimeCacheKeyFor: %v", err)
+	}
+	return key
+}
+
+func TestRuntimeCacheKeyIsStable(t *testing.T) {
+	flags := runtimeCompileFlags(LTOOff)
+	first := mustRuntimeCacheKey(t, "clang 18", flags, testRuntimeSources())
+	if second := mustRuntimeCacheKey(t, "clang 18", flags, testRuntimeSources()); second != first {
+		t.Fatalf("same inputs gave different keys: %s and %s", first, second)
+	}
+
+	embedded := runtimeembed.NativeRuntimeFS()
+	a, errA := runtimeCacheKeyFor("clang 18", "", flags, embedded)
+	b, errB := runtimeCacheKeyFor("clang 18", "", flags, embedded)
+	if errA != nil || errB != nil {
+		t.Fatalf("embedded runtime: %v, %v", errA, errB)
+	}
+	if a != b {
+		t.Fatalf("embedded runtime gave different keys: %s and %s", a, b)
+	}
+}
+
+func TestRuntimeCacheKeyChangesWithInputs(t *testing.T) {
+	flags := runtimeCompileFlags(LTOOff)
+	base := mustRuntimeCacheKey(t, "clang 18", flags, testRuntimeSources())
+
+	edited := testRuntimeSources()
+	edited["native/rt_alloc.c"] = &fstest.MapFile{Data: []byte("void rt_init(void) { }\n")}
+	added := testRuntimeSources()
+	added["native/rt_net.c"] = &fstest.MapFile{Data: []byte("int rt_net;\n")}
+	renamed := testRuntimeSources()
+	renamed["native/rt_heap.c"] = renamed["native/rt_alloc.c"]
+	delete(renamed, "native/rt_alloc.c")
+
+	variants := map[string]string{
+		"lto flags":     mustRuntimeCacheKey(t, "clang 18", runtimeCompileFlags(LTOThin), testRuntimeSources()),
+		"extra flag":    mustRuntimeCacheKey(t, "clang 18", append(flags, "-DNDEBUG"), testRuntimeSources()),
+		"clang version": mustRuntimeCacheKey(t, "clang 19", flags, testRuntimeSources()),
+		"edited source": mustRuntimeCacheKey(t, "clang 18", flags, edited),
+		"added source":  mustRuntimeCacheKey(t, "clang 18", flags, added),
+		"renamed file":  mustRuntimeCacheKey(t, "clang 18", flags, renamed),
+	}
+	for name, key := range variants {
+		if key == base {
+			t.Errorf("%s did not change the key", name)
+		}
+	}
+}
+
+func TestRuntimeCacheDirHonorsOff(t *testing.T) {
+	for _, value := range []string{"off", "OFF", " off ", "0", "false", "no"} {
+		t.Setenv("SURGE_RUNTIME_CACHE", value)
+		if dir := runtimeCacheDir(); dir != "" {
+			t.Errorf("SURGE_RUNTIME_CACHE=%q: got cache dir %q, want caching off", value, dir)
+		}
+	}
+
+	cacheHome := t.TempDir()
+	t.Setenv("SURGE_RUNTIME_CACHE", "")
+	t.Setenv("XDG_CACHE_HOME", cacheHome)
+	if dir, want := runtimeCacheDir(), filepath.Join(cacheHome, "surge", "runtime"); dir != want {
+		t.Fatalf("got cache dir %q, want %q", dir, want)
+	}
+}
+
+func TestStoreRuntimeArchiveReplacesAtomically(t *testing.T) {
+	tmp := t.TempDir()
+	archives := make([][]byte, 2)
+	paths := make([]string, 2)
+	for i := range archives {
+		archives[i] = bytes.Repeat([]byte{byte('a' + i)}, 1<<20)
+		paths[i] = filepath.Join(tmp, string(rune('a'+i))+".a")
+		if err := os.WriteFile(paths[i], archives[i], 0o600); err != nil {
+			t.Fatal(err)
+		}
+	}
+	cached := filepath.Join(tmp, "cache", "key", runtimeArchiveName)
+
+	// Readers racing the stores must only ever see a whole archive.
+	stop := make(chan struct{})
+	var readers sync.WaitGroup
+	var torn sync.Once
+	var tornErr string
+	for r := 0; r < 4; r++ {
+		readers.Add(1)
+		go func() {
+			defer readers.Done()
+			for {
+				select {
+				case <-stop:
+					return
+				default:
+				}
+				data, err := os.ReadFile(cached)
+				if err != nil {
+					continue
+				}
+				if !bytes.Equal(data, archives[0]) && !bytes.Equal(data, archives[1]) {
+					torn.Do(func() { tornErr = "reader saw a partial archive" })
+				}
+			}
+		}()
+	}
+	for round := 0; round < 50; round++ {
+		if err := storeRuntimeArchive(paths[round%2], cached); err != nil {
+			close(stop)
+			readers.Wait()
+			t.Fatalf("store round %d: %v", round, err)
+		}
+	}
+	close(stop)
+	readers.Wait()
+	if tornErr != "" {
+		t.Fatal(tornErr)
+	}
+
+	data, err := os.ReadFile(cached)
+	if err != nil || !bytes.Equal(data, archives[1]) {
+		t.Fatalf("cached archive does not match the last store (err %v)", err)
+	}
+	entries, err := os.ReadDir(filepath.Dir(cached))
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, entry := range entries {
+		if strings.HasPrefix(entry.Name(), "tmp-") {
+			t.Errorf("temp file %s left in the cache dir", entry.Name())
+		}
+	}
+
+	if err := storeRuntimeArchive(filepath.Join(tmp, "missing.a"), cached); err == nil {
+		t.Fatal("storing a missing archive succeeded")
+	}
+	if data, err := os.ReadFile(cached); err != nil || !bytes.Equal(data, archives[1]) {
+		t.Fatal("a failed store disturbed the cached archive")
+	}
+}
@@ -58,6 +58,18 @@ const (
 	BackendLLVM Backend = "llvm"
 )
 
+// LTOMode selects link-time optimization for LLVM builds.
+type LTOMode string
+
+const (
+	// LTOOff links the emitted object against the runtime as native code.
+	LTOOff LTOMode = ""
+	// LTOThin compiles the runtime to bitcode and links it with ThinLTO.
+	LTOThin LTOMode = "thin"
+	// LTOFull compiles the runtime to bitcode and links it with full LTO.
+	LTOFull LTOMode = "full"
+)
+
 // Timings holds stage durations.
 type Timings struct {
 	stages map[Stage]time.Duration
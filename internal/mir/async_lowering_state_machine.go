@@ -160,6 +160,8 @@ func lowerAsyncStateMachineFunc(m *Module, f *Func, typesIn *types.Interner, sem
 	payloadLocal := addLocal(pollFn, "__payload", payloadType, localFlagsFor(typesIn, semaRes, payloadType))
 	entryBB := buildAsyncPollEntry(pollFn, stateLocal, pcLocal, payloadLocal, variants, pollFn.ScopeLocal, pollFn.Failfast, typesIn.Builtins().Bool, typesIn.Builtins().Int)
 	pollFn.Entry = entryBB
+	pollFn.AsyncStateType = stateType
+	pollFn.AsyncPayloadType = payloadType
 
 	if err := buildAsyncPendingBlocks(pollFn, stateLocal, payloadLocal, sites, variants, typesIn.Builtins().Int); err != nil {
 		return err
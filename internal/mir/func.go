@@ -24,4 +24,10 @@ type Func struct {
 	Entry  BlockID
 
 	ScopeLocal LocalID
+
+	// AsyncStateType and AsyncPayloadType are set on state-machine poll functions: the
+	// frame rebuilt at each suspension, which the backend allocates from the task's
+	// frame arena.
+	AsyncStateType   types.TypeID
+	AsyncPayloadType types.TypeID
 }
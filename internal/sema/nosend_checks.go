@@ -82,6 +82,34 @@ func (tc *typeChecker) checkChannelSendValue(valueExpr ast.ExprID, span source.S
 	return false
 }
 
+// checkChannelSendManyValues checks the array handed to ch.send_many(values). The
+// values are borrowed and the channel receives bitwise copies, so the element type must
+// be a builtin Copy type. Generic elements are checked once they are instantiated.
+func (tc *typeChecker) checkChannelSendManyValues(valuesExpr ast.ExprID, span source.Span) bool {
+	if !valuesExpr.IsValid() || tc.types == nil {
+		return false
+	}
+	valuesType := tc.result.ExprTypes[valuesExpr]
+	if valuesType == types.NoTypeID {
+		return false
+	}
+	elemType, ok := tc.arrayElemType(tc.valueType(valuesType))
+	if !ok || elemType == types.NoTypeID {
+		return false
+	}
+	resolved := tc.resolveAlias(elemType)
+	if tt, ok := tc.types.Lookup(resolved); ok && tt.Kind == types.KindGenericParam {
+		return false
+	}
+	if !tc.types.IsCopy(resolved) {
+		tc.report(diag.SemaChannelTypeMismatch, span,
+			"send_many sends copies of its values and needs a Copy element type, got '%s'",
+			tc.typeLabel(elemType))
+		return true
+	}
+	return false
+}
+
 // checkNestedNosendWith recursively checks struct fields for @nosend attribute.
 // This is a unified implementation used by both task and channel send checking.
 //
@@ -167,6 +167,7 @@ func (tc *typeChecker) checkArrayViewResizeCall(name string, args []callArg, spa
 	switch name {
 	case "rt_array_reserve", "rt_array_push", "rt_array_pop",
 		"rt_array_append_raw_bytes", "rt_byte_array_append_range", "rt_byte_array_drop_prefix",
+		"rt_byte_array_reserve_tail",
 		"array_reserve", "array_push", "array_pop":
 	default:
 		return
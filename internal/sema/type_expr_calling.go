@@ -53,6 +53,12 @@ func (tc *typeChecker) typeExprCall(id ast.ExprID, span source.Span, call *ast.E
 					return types.NoTypeID
 				}
 			}
+			if !receiverIsType && tc.isChannelType(receiverType) &&
+				methodName == "send_many" && len(call.Args) > 0 {
+				if tc.checkChannelSendManyValues(call.Args[0].Value, tc.exprSpan(call.Args[0].Value)) {
+					return types.NoTypeID
+				}
+			}
 			if !receiverIsType && methodName == "push" && len(argTypes) > 0 &&
 				tc.isTaskType(argTypes[0]) && tc.isTaskContainerType(receiverType) {
 				if place, ok := tc.taskContainerPlace(member.Target); ok {
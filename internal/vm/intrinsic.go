@@ -77,6 +77,15 @@ func (vm *VM) callIntrinsic(frame *Frame, call *mir.CallInstr, writes *[]LocalWr
 	case "rt_worker_count":
 		return vm.handleWorkerCount(frame, call, writes)
 
+	case "rt_metrics_json":
+		return vm.handleMetricsText(frame, call, writes, false)
+
+	case "rt_metrics_prometheus":
+		return vm.handleMetricsText(frame, call, writes, true)
+
+	case "rt_metrics_value":
+		return vm.handleMetricsValue(frame, call, writes)
+
 	case "rt_range_int_new":
 		return vm.handleRangeIntNew(frame, call, writes)
 
@@ -120,8 +129,13 @@ func (vm *VM) callIntrinsic(frame *Frame, call *mir.CallInstr, writes *[]LocalWr
 		return vm.handleByteArrayAppendRange(frame, call, writes)
 	case "rt_byte_array_drop_prefix":
 		return vm.handleByteArrayDropPrefix(frame, call, writes)
+	case "rt_byte_array_reserve_tail":
+		return vm.handleByteArrayReserveTail(frame, call, writes)
 	case "rt_byte_parse_uint64_token":
 		return vm.handleByteParseUint64Token(frame, call, writes)
+	case "rt_byte_find", "rt_byte_find2", "rt_byte_find3", "rt_byte_find_set", "rt_byte_count",
+		"rt_byte_skip_ascii_ws", "rt_byte_find_ascii_ws", "rt_json_scan_string", "rt_json_structural_index":
+		return vm.handleByteScan(frame, call, name, writes)
 
 	case "rt_map_new":
 		return vm.handleMapNew(frame, call, writes)
@@ -173,6 +187,8 @@ func (vm *VM) callIntrinsic(frame *Frame, call *mir.CallInstr, writes *[]LocalWr
 		return vm.handleChannelTrySend(frame, call, writes)
 	case "try_recv":
 		return vm.handleChannelTryRecv(frame, call, writes)
+	case "send_many":
+		return vm.handleChannelSendMany(frame, call, writes)
 	case "close":
 		return vm.handleChannelClose(frame, call)
 
@@ -226,6 +242,10 @@ func (vm *VM) callIntrinsic(frame *Frame, call *mir.CallInstr, writes *[]LocalWr
 		return vm.handleFsFlush(frame, call, writes)
 	case "rt_fs_read_file":
 		return vm.handleFsReadFile(frame, call, writes)
+	case "rt_fs_map_file":
+		return vm.handleFsMapFile(frame, call, writes)
+	case "rt_fs_read_into":
+		return vm.handleFsReadInto(frame, call, writes)
 	case "rt_fs_write_file":
 		return vm.handleFsWriteFile(frame, call, writes)
 	case "rt_fs_file_name":
@@ -250,8 +270,14 @@ func (vm *VM) callIntrinsic(frame *Frame, call *mir.CallInstr, writes *[]LocalWr
 		return vm.handleNetWrite(frame, call, writes)
 	case "rt_net_read_bytes":
 		return vm.handleNetReadBytes(frame, call, writes)
+	case "rt_net_read_into":
+		return vm.handleNetReadInto(frame, call, writes)
 	case "rt_net_write_bytes":
 		return vm.handleNetWriteBytes(frame, call, writes)
+	case "rt_net_write_vectored":
+		return vm.handleNetWriteVectored(frame, call, writes)
+	case "rt_net_send_file":
+		return vm.handleNetSendFile(frame, call, writes)
 
 	case "rt_exit":
 		return vm.handleRtExit(frame, call)
@@ -422,6 +422,80 @@ func (vm *VM) handleByteArrayDropPrefix(frame *Frame, call *mir.CallInstr, write
 	return nil
 }
 
+// handleByteArrayReserveTail mirrors the native policy: the dead prefix before start is
+// dropped only once the array cannot take spare more bytes, and the dropped count is returned.
+func (vm *VM) handleByteArrayReserveTail(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if len(call.Args) != 3 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_byte_array_reserve_tail requires 3 arguments")
+	}
+	arrVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(arrVal)
+	startVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(startVal)
+	spareVal, vmErr := vm.evalOperand(frame, &call.Args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(spareVal)
+
+	start, vmErr := vm.uintValueToInt(startVal, "byte array reserve tail start out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+	spare, vmErr := vm.uintValueToInt(spareVal, "byte array reserve tail spare out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+	arrObj, vmErr := vm.arrayOwnedFromValue(arrVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	length := len(arrObj.Arr)
+	if start > length {
+		return vm.eb.outOfBounds(start, length)
+	}
+	dropped := 0
+	if spare > cap(arrObj.Arr)-length {
+		dropped = start
+		live := length - start
+		for i := range start {
+			vm.dropValue(arrObj.Arr[i])
+		}
+		if live+spare > cap(arrObj.Arr) {
+			next := make([]Value, live, growArrayCapacity(cap(arrObj.Arr), live+spare))
+			copy(next, arrObj.Arr[start:])
+			arrObj.Arr = next
+		} else {
+			copy(arrObj.Arr, arrObj.Arr[start:])
+			for i := live; i < length; i++ {
+				arrObj.Arr[i] = Value{}
+			}
+			arrObj.Arr = arrObj.Arr[:live]
+		}
+	}
+	if call.HasDst {
+		dstLocal := call.Dst.Local
+		res := MakeInt(int64(dropped), frame.Locals[dstLocal].TypeID)
+		if vmErr := vm.writeLocal(frame, dstLocal, res); vmErr != nil {
+			return vmErr
+		}
+		if writes != nil {
+			*writes = append(*writes, LocalWrite{
+				LocalID: dstLocal,
+				Name:    frame.Locals[dstLocal].Name,
+				Value:   res,
+			})
+		}
+	}
+	return nil
+}
+
 func (vm *VM) handleByteParseUint64Token(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if len(call.Args) != 5 {
 		return vm.eb.makeError(PanicTypeMismatch, "rt_byte_parse_uint64_token requires 5 arguments")
@@ -0,0 +1,222 @@
+package vm
+
+import (
+	"fmt"
+
+	"surge/internal/mir"
+	"surge/internal/types"
+)
+
+// byteScanExtraArgs is the number of arguments each byte scanner takes after
+// (data, start, end).
+var byteScanExtraArgs = map[string]int{
+	"rt_byte_find":             1,
+	"rt_byte_find2":            2,
+	"rt_byte_find3":            3,
+	"rt_byte_find_set":         1,
+	"rt_byte_count":            1,
+	"rt_byte_skip_ascii_ws":    0,
+	"rt_byte_find_ascii_ws":    0,
+	"rt_json_scan_string":      0,
+	"rt_json_structural_index": 1,
+}
+
+// handleByteScan runs the rt_byte_*/rt_json_* scanners byte by byte. Results match the
+// native kernels: an offset into data, or end when nothing matches or the range is invalid
+// (counts are 0 for an invalid range).
+func (vm *VM) handleByteScan(frame *Frame, call *mir.CallInstr, name string, writes *[]LocalWrite) *VMError {
+	extra := byteScanExtraArgs[name]
+	if len(call.Args) != 3+extra {
+		return vm.eb.makeError(PanicTypeMismatch, fmt.Sprintf("%s requires %d arguments", name, 3+extra))
+	}
+	args := make([]Value, 0, len(call.Args))
+	defer func() {
+		for _, v := range args {
+			vm.dropValue(v)
+		}
+	}()
+	for i := range call.Args {
+		v, vmErr := vm.evalOperand(frame, &call.Args[i])
+		if vmErr != nil {
+			return vmErr
+		}
+		args = append(args, v)
+	}
+
+	end64, vmErr := vm.toUint64ForCast(args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	result := end64
+	if name == "rt_byte_count" {
+		result = 0
+	}
+	view, start, end, ok, vmErr := vm.byteScanRange(args[0], args[1], args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	if ok {
+		var found int
+		switch name {
+		case "rt_json_structural_index":
+			found, vmErr = vm.byteScanStructuralIndex(view, start, end, args[3])
+		case "rt_byte_count":
+			found, vmErr = vm.byteScanCount(view, start, end, args[3])
+		default:
+			var match func(byte) bool
+			match, vmErr = vm.byteScanMatcher(name, args[3:])
+			if vmErr == nil {
+				found, vmErr = vm.byteScanFind(view, start, end, match)
+			}
+		}
+		if vmErr != nil {
+			return vmErr
+		}
+		result = uint64(found) //nolint:gosec // found is a non-negative offset or count.
+	}
+
+	if call.HasDst {
+		dstLocal := call.Dst.Local
+		res := MakeInt(asInt64(result), frame.Locals[dstLocal].TypeID)
+		if vmErr := vm.writeLocal(frame, dstLocal, res); vmErr != nil {
+			return vmErr
+		}
+		if writes != nil {
+			*writes = append(*writes, LocalWrite{
+				LocalID: dstLocal,
+				Name:    frame.Locals[dstLocal].Name,
+				Value:   res,
+			})
+		}
+	}
+	return nil
+}
+
+// byteScanRange resolves data[start:end]; ok is false for an empty or out-of-range span.
+func (vm *VM) byteScanRange(dataVal, startVal, endVal Value) (view arrayView, start, end int, ok bool, vmErr *VMError) {
+	start, startErr := vm.uintValueToInt(startVal, "byte scan start out of range")
+	end, endErr := vm.uintValueToInt(endVal, "byte scan end out of range")
+	if startErr != nil || endErr != nil || start >= end {
+		return arrayView{}, 0, 0, false, nil
+	}
+	if dataVal.Kind == VKRef || dataVal.Kind == VKRefMut {
+		dataVal, vmErr = vm.loadLocationRaw(dataVal.Loc)
+		if vmErr != nil {
+			return arrayView{}, 0, 0, false, vmErr
+		}
+	}
+	if dataVal.Kind != VKHandleArray {
+		return arrayView{}, 0, 0, false, vm.eb.typeMismatch("byte[]", dataVal.Kind.String())
+	}
+	view, vmErr = vm.arrayViewFromHandle(dataVal.H)
+	if vmErr != nil {
+		return arrayView{}, 0, 0, false, vmErr
+	}
+	return view, start, end, end <= view.length, nil
+}
+
+func (vm *VM) byteScanMatcher(name string, extra []Value) (func(byte) bool, *VMError) {
+	switch name {
+	case "rt_byte_skip_ascii_ws":
+		return func(b byte) bool { return !isByteScanASCIIWS(b) }, nil
+	case "rt_byte_find_ascii_ws":
+		return isByteScanASCIIWS, nil
+	case "rt_json_scan_string":
+		return func(b byte) bool { return b == '"' || b == '\\' || b < 0x20 }, nil
+	case "rt_byte_find_set":
+		set, vmErr := vm.bytesFromArrayValue(extra[0])
+		if vmErr != nil {
+			return nil, vmErr
+		}
+		var table [256]bool
+		for _, b := range set {
+			table[b] = true
+		}
+		return func(b byte) bool { return table[b] }, nil
+	}
+	var table [256]bool
+	for _, v := range extra {
+		b, vmErr := vm.valueToUint8(v)
+		if vmErr != nil {
+			return nil, vmErr
+		}
+		table[b] = true
+	}
+	return func(b byte) bool { return table[b] }, nil
+}
+
+func isByteScanASCIIWS(b byte) bool {
+	return b == ' ' || b == '\t' || b == '\n' || b == '\r'
+}
+
+func (vm *VM) byteScanFind(view arrayView, start, end int, match func(byte) bool) (int, *VMError) {
+	for i := start; i < end; i++ {
+		b, vmErr := vm.valueToUint8(view.baseObj.Arr[view.start+i])
+		if vmErr != nil {
+			return 0, vmErr
+		}
+		if match(b) {
+			return i, nil
+		}
+	}
+	return end, nil
+}
+
+func (vm *VM) byteScanCount(view arrayView, start, end int, needleVal Value) (int, *VMError) {
+	needle, vmErr := vm.valueToUint8(needleVal)
+	if vmErr != nil {
+		return 0, vmErr
+	}
+	count := 0
+	for i := start; i < end; i++ {
+		b, convErr := vm.valueToUint8(view.baseObj.Arr[view.start+i])
+		if convErr != nil {
+			return 0, convErr
+		}
+		if b == needle {
+			count++
+		}
+	}
+	return count, nil
+}
+
+// byteScanStructuralIndex appends the offsets of unescaped quotes and of {}[]:, outside
+// strings to the index array. Like the native stage-1 scan, a backslash escapes the next
+// byte wherever it appears. It returns end, or the opening quote of an unterminated string.
+func (vm *VM) byteScanStructuralIndex(view arrayView, start, end int, indexRef Value) (int, *VMError) {
+	arrObj, vmErr := vm.arrayOwnedFromValue(indexRef)
+	if vmErr != nil {
+		return 0, vmErr
+	}
+	elemType := types.NoTypeID
+	if vm.Types != nil {
+		elemType = vm.Types.Builtins().Uint64
+	}
+	inString := false
+	escaped := false
+	open := end
+	for i := start; i < end; i++ {
+		b, convErr := vm.valueToUint8(view.baseObj.Arr[view.start+i])
+		if convErr != nil {
+			return 0, convErr
+		}
+		wasEscaped := escaped
+		escaped = b == '\\' && !wasEscaped
+		switch {
+		case b == '"' && !wasEscaped:
+			inString = !inString
+			if inString {
+				open = i
+			}
+		case inString:
+			continue
+		case b != '{' && b != '}' && b != '[' && b != ']' && b != ':' && b != ',':
+			continue
+		}
+		arrObj.Arr = append(arrObj.Arr, MakeInt(int64(i), elemType))
+	}
+	if inString {
+		return open, nil
+	}
+	return end, nil
+}
@@ -1,6 +1,11 @@
 package vm
 
-import "surge/internal/mir"
+import (
+	"fortio.org/safecast"
+
+	"surge/internal/mir"
+	"surge/internal/vm/bignum"
+)
 
 func (vm *VM) handleChannelNew(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if call == nil || !call.HasDst {
@@ -240,6 +245,80 @@ func (vm *VM) handleChannelTrySend(frame *Frame, call *mir.CallInstr, writes *[]
 	return nil
 }
 
+// handleChannelSendMany try_sends copies of the elements of values in order, stopping
+// at the first one that does not fit, and returns how many were sent.
+func (vm *VM) handleChannelSendMany(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if call == nil || !call.HasDst {
+		return vm.eb.makeError(PanicUnimplemented, "send_many missing destination")
+	}
+	if len(call.Args) != 2 {
+		return vm.eb.makeError(PanicUnimplemented, "send_many expects 2 arguments")
+	}
+	exec := vm.ensureExecutor()
+	if exec == nil {
+		return vm.eb.makeError(PanicUnimplemented, "async executor missing")
+	}
+
+	chVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	chID, vmErr := vm.channelIDFromValue(chVal)
+	vm.dropValue(chVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	arrVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(arrVal)
+	if arrVal.Kind == VKRef || arrVal.Kind == VKRefMut {
+		loaded, loadErr := vm.loadLocationRaw(arrVal.Loc)
+		if loadErr != nil {
+			return loadErr
+		}
+		arrVal = loaded
+	}
+	if arrVal.Kind != VKHandleArray {
+		return vm.eb.typeMismatch("array", arrVal.Kind.String())
+	}
+	view, vmErr := vm.arrayViewFromHandle(arrVal.H)
+	if vmErr != nil {
+		return vmErr
+	}
+
+	sent := 0
+	for sent < view.length {
+		val, vmErr := vm.cloneForShare(view.baseObj.Arr[view.start+sent])
+		if vmErr != nil {
+			return vmErr
+		}
+		if !exec.ChanTrySend(chID, val) {
+			vm.dropValue(val)
+			break
+		}
+		sent++
+	}
+	u64, err := safecast.Conv[uint64](sent)
+	if err != nil {
+		return vm.eb.invalidNumericConversion("send_many count out of range")
+	}
+	dstType := frame.Locals[call.Dst.Local].TypeID
+	res := vm.makeBigUint(dstType, bignum.UintFromUint64(u64))
+	if vmErr := vm.writeLocal(frame, call.Dst.Local, res); vmErr != nil {
+		return vmErr
+	}
+	if writes != nil {
+		*writes = append(*writes, LocalWrite{
+			LocalID: call.Dst.Local,
+			Name:    frame.Locals[call.Dst.Local].Name,
+			Value:   res,
+		})
+	}
+	return nil
+}
+
 func (vm *VM) handleChannelTryRecv(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if call == nil || !call.HasDst {
 		return vm.eb.makeError(PanicUnimplemented, "try_recv missing destination")
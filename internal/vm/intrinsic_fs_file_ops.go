@@ -5,6 +5,7 @@ import (
 	"os"
 
 	"surge/internal/mir"
+	"surge/internal/types"
 	"surge/internal/vm/bignum"
 )
 
@@ -453,6 +454,144 @@ func (vm *VM) handleFsReadFile(frame *Frame, call *mir.CallInstr, writes *[]Loca
 	return vm.fsWriteSuccess(frame, dstLocal, dstType, arrVal, writes)
 }
 
+// handleFsMapFile handles rt_fs_map_file. The VM has no mappings, so the view is backed by
+// a string holding the file bytes unchanged.
+func (vm *VM) handleFsMapFile(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 1 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_fs_map_file requires 1 argument")
+	}
+	pathVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(pathVal)
+	strVal, vmErr := vm.extractStringValue(pathVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	path := vm.stringBytes(vm.Heap.Get(strVal.H))
+
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	errType, vmErr := vm.erringErrorType(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+	if fsInvalidPath(path) {
+		return vm.fsWriteError(frame, dstLocal, errType, fsErrInvalidPath, writes)
+	}
+	// #nosec G304 -- path is provided by the program input.
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return vm.fsWriteError(frame, dstLocal, errType, fsErrorCodeFromErr(err), writes)
+	}
+
+	layout, vmErr := vm.tagLayoutFor(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+	tc, ok := layout.CaseByName("Success")
+	if !ok || len(tc.PayloadTypes) != 1 {
+		return vm.eb.makeError(PanicTypeMismatch, "Erring missing Success tag payload")
+	}
+	viewType := tc.PayloadTypes[0]
+	info, vmErr := vm.bytesViewLayout(viewType)
+	if vmErr != nil {
+		return vmErr
+	}
+	if !info.ok {
+		return vm.eb.makeError(PanicTypeMismatch, "invalid BytesView layout")
+	}
+	ownerType := info.layout.FieldTypes[info.ownerIdx]
+	owner := vm.Heap.AllocString(ownerType, string(data))
+	fields := make([]Value, len(info.layout.FieldNames))
+	fields[info.ownerIdx] = MakeHandleString(owner, ownerType)
+	fields[info.ptrIdx] = MakePtr(Location{Kind: LKStringBytes, Handle: owner}, info.layout.FieldTypes[info.ptrIdx])
+	// #nosec G115 -- slice lengths are non-negative.
+	fields[info.lenIdx] = vm.makeBigUint(info.layout.FieldTypes[info.lenIdx], bignum.UintFromUint64(uint64(len(data))))
+	viewVal := MakeHandleStruct(vm.Heap.AllocStruct(info.layout.TypeID, fields), viewType)
+	return vm.fsWriteSuccess(frame, dstLocal, dstType, viewVal, writes)
+}
+
+// handleFsReadInto handles rt_fs_read_into, appending up to cap bytes to a caller-owned array.
+func (vm *VM) handleFsReadInto(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 3 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_fs_read_into requires 3 arguments")
+	}
+	fileVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(fileVal)
+	handle, vmErr := vm.fileHandleFromValue(fileVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	bufVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(bufVal)
+	capVal, vmErr := vm.evalOperand(frame, &call.Args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(capVal)
+	capacity, vmErr := vm.uintValueToInt(capVal, "fs read cap out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	errType, vmErr := vm.erringErrorType(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+	entry := vm.fsFiles[handle]
+	if entry == nil {
+		return vm.fsWriteError(frame, dstLocal, errType, fsErrIo, writes)
+	}
+	bufObj, vmErr := vm.arrayOwnedFromValue(bufVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	n := 0
+	if capacity > 0 {
+		data := make([]byte, capacity)
+		var err error
+		n, err = entry.file.Read(data)
+		if err != nil && err != io.EOF && n == 0 {
+			return vm.fsWriteError(frame, dstLocal, errType, fsErrorCodeFromErr(err), writes)
+		}
+		elemType := types.NoTypeID
+		if vm.Types != nil {
+			elemType = vm.Types.Builtins().Uint8
+		}
+		for _, b := range data[:n] {
+			bufObj.Arr = append(bufObj.Arr, MakeInt(int64(b), elemType))
+		}
+	}
+
+	layout, vmErr := vm.tagLayoutFor(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+	tc, ok := layout.CaseByName("Success")
+	if !ok || len(tc.PayloadTypes) != 1 {
+		return vm.eb.makeError(PanicTypeMismatch, "Erring missing Success tag payload")
+	}
+	// #nosec G115 -- n is non-negative from io.Reader.
+	count := vm.makeBigUint(tc.PayloadTypes[0], bignum.UintFromUint64(uint64(n)))
+	return vm.fsWriteSuccess(frame, dstLocal, dstType, count, writes)
+}
+
 func (vm *VM) handleFsWriteFile(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if !call.HasDst {
 		return nil
@@ -0,0 +1,145 @@
+package vm
+
+import (
+	"math"
+	"runtime"
+	"strconv"
+	"strings"
+
+	"fortio.org/safecast"
+
+	"surge/internal/mir"
+)
+
+// vmMetricSample is one entry of a stdlib/metrics snapshot. Names and the JSON and
+// Prometheus layouts match the native runtime; the VM reports only the metrics it tracks
+// itself, so scheduler, network, and blocking pool names are absent here.
+type vmMetricSample struct {
+	name    string
+	help    string
+	counter bool
+	value   uint64
+}
+
+func (vm *VM) metricsSnapshot() []vmMetricSample {
+	heap := vm.heapStatsSnapshot()
+	return []vmMetricSample{
+		{name: "worker_count", help: "Executor worker threads.", value: safeUint64FromInt(runtime.NumCPU())},
+		{name: "heap_allocs", help: "Runtime heap allocations.", counter: true, value: heap.allocCount},
+		{name: "heap_frees", help: "Runtime heap frees.", counter: true, value: heap.freeCount},
+		{name: "heap_live_blocks", help: "Live runtime heap blocks.", value: heap.liveBlocks},
+		{name: "heap_live_bytes", help: "Live runtime heap bytes.", value: heap.liveBytes},
+	}
+}
+
+func renderMetricsJSON(samples []vmMetricSample) string {
+	var b strings.Builder
+	b.WriteString(`{"version":1,"counters":{`)
+	writeMetricsJSONKind(&b, samples, true)
+	b.WriteString(`},"gauges":{`)
+	writeMetricsJSONKind(&b, samples, false)
+	b.WriteString("}}\n")
+	return b.String()
+}
+
+func writeMetricsJSONKind(b *strings.Builder, samples []vmMetricSample, counter bool) {
+	first := true
+	for _, s := range samples {
+		if s.counter != counter {
+			continue
+		}
+		if !first {
+			b.WriteByte(',')
+		}
+		b.WriteByte('"')
+		b.WriteString(s.name)
+		b.WriteString(`":`)
+		b.WriteString(strconv.FormatUint(s.value, 10))
+		first = false
+	}
+}
+
+func renderMetricsPrometheus(samples []vmMetricSample) string {
+	var b strings.Builder
+	for _, s := range samples {
+		name := "surge_" + s.name
+		kind := "gauge"
+		if s.counter {
+			name += "_total"
+			kind = "counter"
+		}
+		b.WriteString("# HELP " + name + " " + s.help + "\n")
+		b.WriteString("# TYPE " + name + " " + kind + "\n")
+		b.WriteString(name + " " + strconv.FormatUint(s.value, 10) + "\n")
+	}
+	return b.String()
+}
+
+func (vm *VM) handleMetricsText(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite, prometheus bool) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 0 {
+		return vm.eb.makeError(PanicTypeMismatch, call.Callee.Name+" requires 0 arguments")
+	}
+	samples := vm.metricsSnapshot()
+	text := renderMetricsJSON(samples)
+	if prometheus {
+		text = renderMetricsPrometheus(samples)
+	}
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	h := vm.Heap.AllocString(dstType, text)
+	val := MakeHandleString(h, dstType)
+	if vmErr := vm.writeLocal(frame, dstLocal, val); vmErr != nil {
+		vm.Heap.Release(h)
+		return vmErr
+	}
+	*writes = append(*writes, LocalWrite{
+		LocalID: dstLocal,
+		Name:    frame.Locals[dstLocal].Name,
+		Value:   val,
+	})
+	return nil
+}
+
+func (vm *VM) handleMetricsValue(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 1 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_metrics_value requires 1 argument")
+	}
+	arg, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(arg)
+	strVal, vmErr := vm.extractStringValue(arg)
+	if vmErr != nil {
+		return vmErr
+	}
+	name := vm.stringBytes(vm.Heap.Get(strVal.H))
+	result := int64(-1)
+	for _, s := range vm.metricsSnapshot() {
+		if s.name != name {
+			continue
+		}
+		result = math.MaxInt64
+		if v, err := safecast.Conv[int64](s.value); err == nil {
+			result = v
+		}
+		break
+	}
+	dstLocal := call.Dst.Local
+	val := MakeInt(result, frame.Locals[dstLocal].TypeID)
+	if vmErr := vm.writeLocal(frame, dstLocal, val); vmErr != nil {
+		return vmErr
+	}
+	*writes = append(*writes, LocalWrite{
+		LocalID: dstLocal,
+		Name:    frame.Locals[dstLocal].Name,
+		Value:   val,
+	})
+	return nil
+}
@@ -0,0 +1,53 @@
+package vm_test
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestVMMetricsSnapshot(t *testing.T) {
+	requireVMBackend(t)
+	t.Setenv("SURGE_STDLIB", repoRoot(t))
+
+	sourceCode := `import stdlib/metrics as metrics;
+
+@entrypoint
+fn main() -> int {
+    compare metrics.value("heap_allocs") {
+        Some(n) => {
+            if n == 0:uint64 {
+                return 1;
+            }
+        }
+        nothing => {
+            return 2;
+        }
+    };
+    compare metrics.value("task_polls") {
+        Some(_) => {
+            return 3;
+        }
+        nothing => {
+            print(metrics.json());
+        }
+    };
+    print(metrics.prometheus());
+    return 0;
+}
+`
+
+	result := runProgramFromSource(t, sourceCode, runOptions{})
+	if result.exitCode != 0 {
+		t.Fatalf("expected exit code 0, got %d\nstderr:\n%s", result.exitCode, result.stderr)
+	}
+	for _, want := range []string{
+		`{"version":1,"counters":{"heap_allocs":`,
+		`"gauges":{"worker_count":`,
+		"# TYPE surge_heap_allocs_total counter\nsurge_heap_allocs_total ",
+		"# TYPE surge_heap_live_bytes gauge\nsurge_heap_live_bytes ",
+	} {
+		if !strings.Contains(result.stdout, want) {
+			t.Fatalf("metrics output missing %q:\n%s", want, result.stdout)
+		}
+	}
+}
@@ -1,12 +1,17 @@
 package vm
 
 import (
+	"errors"
+	"io"
 	"syscall"
 
 	"surge/internal/mir"
 	"surge/internal/types"
 )
 
+// netSendFileChunk bounds one VM send_file step, like a single sendfile call.
+const netSendFileChunk = 1 << 16
+
 func (vm *VM) handleNetReadBytes(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if !call.HasDst {
 		return nil
@@ -75,6 +80,78 @@ func (vm *VM) handleNetReadBytes(frame *Frame, call *mir.CallInstr, writes *[]Lo
 	return vm.netWriteSuccess(frame, dstLocal, dstType, arrVal, writes)
 }
 
+func (vm *VM) handleNetReadInto(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 3 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_net_read_into requires 3 arguments")
+	}
+	connVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(connVal)
+	handle, vmErr := vm.netConnHandleFromValue(connVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	bufVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(bufVal)
+	capVal, vmErr := vm.evalOperand(frame, &call.Args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(capVal)
+	capacity, vmErr := vm.uintValueToInt(capVal, "net read cap out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	errType, vmErr := vm.erringErrorType(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+
+	entry := vm.netConns[handle]
+	if entry == nil || entry.closed {
+		return vm.netWriteError(frame, dstLocal, errType, netErrNotConnected, writes)
+	}
+	bufObj, vmErr := vm.arrayOwnedFromValue(bufVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	var n int
+	if capacity > 0 {
+		data := make([]byte, capacity)
+		var err error
+		for {
+			n, err = syscall.Read(entry.fd, data)
+			if err == syscall.EINTR {
+				continue
+			}
+			break
+		}
+		if err != nil {
+			return vm.netWriteError(frame, dstLocal, errType, netErrorCodeFromErr(err), writes)
+		}
+		elemType := types.NoTypeID
+		if vm.Types != nil {
+			elemType = vm.Types.Builtins().Uint8
+		}
+		for _, b := range data[:n] {
+			bufObj.Arr = append(bufObj.Arr, MakeInt(int64(b), elemType))
+		}
+	}
+
+	return vm.netWriteCount(frame, dstLocal, dstType, n, writes)
+}
+
 func (vm *VM) handleNetWriteBytes(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
 	if !call.HasDst {
 		return nil
@@ -166,6 +243,188 @@ func (vm *VM) handleNetWriteBytes(frame *Frame, call *mir.CallInstr, writes *[]L
 		}
 	}
 
+	return vm.netWriteCount(frame, dstLocal, dstType, n, writes)
+}
+
+func (vm *VM) handleNetWriteVectored(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 3 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_net_write_vectored requires 3 arguments")
+	}
+	connVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(connVal)
+	handle, vmErr := vm.netConnHandleFromValue(connVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	partsVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(partsVal)
+	offsetVal, vmErr := vm.evalOperand(frame, &call.Args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(offsetVal)
+	offset, vmErr := vm.uintValueToInt(offsetVal, "net write offset out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	errType, vmErr := vm.erringErrorType(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+
+	entry := vm.netConns[handle]
+	if entry == nil || entry.closed {
+		return vm.netWriteError(frame, dstLocal, errType, netErrNotConnected, writes)
+	}
+	parts, vmErr := vm.netArrayView(partsVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	var data []byte
+	for i := range parts.length {
+		part, partErr := vm.netArrayView(parts.baseObj.Arr[parts.start+i])
+		if partErr != nil {
+			return partErr
+		}
+		for j := range part.length {
+			b, convErr := vm.valueToUint8(part.baseObj.Arr[part.start+j])
+			if convErr != nil {
+				return convErr
+			}
+			data = append(data, b)
+		}
+	}
+	if offset > len(data) {
+		return vm.netWriteError(frame, dstLocal, errType, netErrIo, writes)
+	}
+	data = data[offset:]
+	var n int
+	if len(data) > 0 {
+		var err error
+		for {
+			n, err = syscall.Write(entry.fd, data)
+			if err == syscall.EINTR {
+				continue
+			}
+			break
+		}
+		if err != nil {
+			return vm.netWriteError(frame, dstLocal, errType, netErrorCodeFromErr(err), writes)
+		}
+	}
+	return vm.netWriteCount(frame, dstLocal, dstType, n, writes)
+}
+
+func (vm *VM) handleNetSendFile(frame *Frame, call *mir.CallInstr, writes *[]LocalWrite) *VMError {
+	if !call.HasDst {
+		return nil
+	}
+	if len(call.Args) != 4 {
+		return vm.eb.makeError(PanicTypeMismatch, "rt_net_send_file requires 4 arguments")
+	}
+	connVal, vmErr := vm.evalOperand(frame, &call.Args[0])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(connVal)
+	handle, vmErr := vm.netConnHandleFromValue(connVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	fileVal, vmErr := vm.evalOperand(frame, &call.Args[1])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(fileVal)
+	fileHandle, vmErr := vm.fileHandleFromValue(fileVal)
+	if vmErr != nil {
+		return vmErr
+	}
+	offsetVal, vmErr := vm.evalOperand(frame, &call.Args[2])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(offsetVal)
+	lenVal, vmErr := vm.evalOperand(frame, &call.Args[3])
+	if vmErr != nil {
+		return vmErr
+	}
+	defer vm.dropValue(lenVal)
+	offset, vmErr := vm.uintValueToInt(offsetVal, "net send file offset out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+	length, vmErr := vm.uintValueToInt(lenVal, "net send file length out of range")
+	if vmErr != nil {
+		return vmErr
+	}
+
+	dstLocal := call.Dst.Local
+	dstType := frame.Locals[dstLocal].TypeID
+	errType, vmErr := vm.erringErrorType(dstType)
+	if vmErr != nil {
+		return vmErr
+	}
+
+	entry := vm.netConns[handle]
+	if entry == nil || entry.closed {
+		return vm.netWriteError(frame, dstLocal, errType, netErrNotConnected, writes)
+	}
+	file := vm.fsFiles[fileHandle]
+	if file == nil {
+		return vm.netWriteError(frame, dstLocal, errType, netErrIo, writes)
+	}
+	// The VM copies through a bounded buffer; zero-copy transfer is a native runtime detail.
+	data := make([]byte, min(length, netSendFileChunk))
+	got, readErr := file.file.ReadAt(data, int64(offset))
+	if got == 0 && readErr != nil && !errors.Is(readErr, io.EOF) {
+		return vm.netWriteError(frame, dstLocal, errType, netErrIo, writes)
+	}
+	var n int
+	if got > 0 {
+		var err error
+		for {
+			n, err = syscall.Write(entry.fd, data[:got])
+			if err == syscall.EINTR {
+				continue
+			}
+			break
+		}
+		if err != nil {
+			return vm.netWriteError(frame, dstLocal, errType, netErrorCodeFromErr(err), writes)
+		}
+	}
+	return vm.netWriteCount(frame, dstLocal, dstType, n, writes)
+}
+
+// netArrayView resolves an array value (or a reference to one) to its element view.
+func (vm *VM) netArrayView(val Value) (arrayView, *VMError) {
+	if val.Kind == VKRef || val.Kind == VKRefMut {
+		loaded, loadErr := vm.loadLocationRaw(val.Loc)
+		if loadErr != nil {
+			return arrayView{}, loadErr
+		}
+		val = loaded
+	}
+	if val.Kind != VKHandleArray {
+		return arrayView{}, vm.eb.typeMismatch("byte[]", val.Kind.String())
+	}
+	return vm.arrayViewFromHandle(val.H)
+}
+
+func (vm *VM) netWriteCount(frame *Frame, dstLocal mir.LocalID, dstType types.TypeID, n int, writes *[]LocalWrite) *VMError {
 	layout, vmErr := vm.tagLayoutFor(dstType)
 	if vmErr != nil {
 		return vmErr
@@ -174,7 +433,7 @@ func (vm *VM) handleNetWriteBytes(frame *Frame, call *mir.CallInstr, writes *[]L
 	if !ok || len(tc.PayloadTypes) != 1 {
 		return vm.eb.makeError(PanicTypeMismatch, "Erring missing Success tag payload")
 	}
-	countVal, makeErr := vm.makeUintForType(tc.PayloadTypes[0], uint64(n)) //nolint:gosec // n from syscall.Write is non-negative.
+	countVal, makeErr := vm.makeUintForType(tc.PayloadTypes[0], uint64(n)) //nolint:gosec // n from a syscall result is non-negative.
 	if makeErr != nil {
 		return makeErr
 	}
@@ -963,6 +963,10 @@ func requireNetTracePollCountersForReason(t *testing.T, stderr string, reason st
 		"io_poll_dedup_checks=",
 		"io_waiter_complete_calls=",
 		"io_waiter_completed=",
+		"io_reactor_registrations=",
+		"io_reactor_events=",
+		"io_uring_enters=",
+		"io_poll_backend=",
 	} {
 		if !strings.Contains(line, field) {
 			t.Fatalf("missing %s counter in TRACE_NET\nline:\n%s\nstderr:\n%s", field, line, stderr)
@@ -0,0 +1,147 @@
+package vm_test
+
+import "testing"
+
+func TestNativeArenaAllocatorKeepsCountsAcrossThreads(t *testing.T) {
+	runNativeRuntimeHarness(t, "alloc_arena_harness", allocThreadsHarness, "SURGE_ALLOC=arena", "SURGE_THREADS=1")
+}
+
+func TestNativeSystemAllocatorKeepsCountsAcrossThreads(t *testing.T) {
+	runNativeRuntimeHarness(t, "alloc_system_harness", allocThreadsHarness, "SURGE_ALLOC=system", "SURGE_THREADS=1")
+}
+
+// allocThreadsHarness allocates on some threads and frees on others, and checks block
+// contents, alignment, realloc copies and that the aggregated heap counters balance once
+// every thread has exited, even when arena frees are passed the wrong size.
+const allocThreadsHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { PRODUCERS = 4, BLOCKS = 20000 };
+
+static uint8_t* blocks[PRODUCERS][BLOCKS];
+static uint64_t sizes[PRODUCERS][BLOCKS];
+static _Atomic int bad;
+
+static uint64_t block_size(int p, int i) {
+    static const uint64_t table[] = {0, 1, 7, 16, 24, 40, 64, 100, 256, 511, 512, 513, 4096};
+    return table[(size_t)(p + i) % (sizeof(table) / sizeof(table[0]))];
+}
+
+static uint64_t block_align(int i) {
+    return i % 17 == 0 ? 64 : (i % 5 == 0 ? 16 : 8);
+}
+
+static void* producer_main(void* arg) {
+    int p = (int)(intptr_t)arg;
+    for (int i = 0; i < BLOCKS; i++) {
+        uint64_t size = block_size(p, i);
+        uint8_t* ptr = (uint8_t*)rt_alloc(size, block_align(i));
+        if (ptr == NULL || ((uintptr_t)ptr % block_align(i)) != 0) {
+            atomic_store(&bad, 1);
+            return NULL;
+        }
+        memset(ptr, (int)((p * 31 + i) & 0xff), (size_t)(size == 0 ? 1 : size));
+        blocks[p][i] = ptr;
+        sizes[p][i] = size;
+    }
+    return NULL;
+}
+
+static void* consumer_main(void* arg) {
+    // Frees another thread's blocks, so cross-thread frees show up in the counters.
+    int p = (int)(intptr_t)arg;
+    int owner = (p + 1) % PRODUCERS;
+    for (int i = 0; i < BLOCKS; i++) {
+        uint8_t* ptr = blocks[owner][i];
+        uint64_t size = sizes[owner][i];
+        uint8_t want = (uint8_t)((owner * 31 + i) & 0xff);
+        for (uint64_t j = 0; j < size; j++) {
+            if (ptr[j] != want) {
+                atomic_store(&bad, 1);
+                break;
+            }
+        }
+        rt_free(ptr, size, block_align(i));
+    }
+    return NULL;
+}
+
+int main(void) {
+    uint64_t allocs0 = 0, frees0 = 0, blocks0 = 0, bytes0 = 0;
+    rt_heap_counts(&allocs0, &frees0, &blocks0, &bytes0);
+
+    pthread_t threads[PRODUCERS];
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_create(&threads[p], NULL, producer_main, (void*)(intptr_t)p);
+    }
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+    uint64_t allocs1 = 0, blocks1 = 0, bytes1 = 0;
+    rt_heap_counts(&allocs1, NULL, &blocks1, &bytes1);
+    if (allocs1 - allocs0 != (uint64_t)PRODUCERS * BLOCKS ||
+        blocks1 - blocks0 != (uint64_t)PRODUCERS * BLOCKS) {
+        return fail("exited threads' allocations were not counted");
+    }
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_create(&threads[p], NULL, consumer_main, (void*)(intptr_t)p);
+    }
+    for (int p = 0; p < PRODUCERS; p++) {
+        pthread_join(threads[p], NULL);
+    }
+    if (atomic_load(&bad)) {
+        return fail("a block was misaligned or its contents changed");
+    }
+
+    uint8_t* grow = (uint8_t*)rt_alloc(3, 1);
+    for (int i = 0; i < 3; i++) {
+        grow[i] = (uint8_t)(i + 1);
+    }
+    uint64_t size = 3;
+    static const uint64_t steps[] = {8, 16, 17, 200, 512, 600, 9000, 40, 2};
+    for (size_t s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+        uint64_t next_size = steps[s];
+        grow = (uint8_t*)rt_realloc(grow, size, next_size, 1);
+        if (grow == NULL) {
+            return fail("realloc failed");
+        }
+        uint64_t keep = size < next_size ? size : next_size;
+        for (uint64_t j = 0; j < keep; j++) {
+            if (grow[j] != (uint8_t)(j + 1)) {
+                return fail("realloc did not keep the block contents");
+            }
+        }
+        for (uint64_t j = keep; j < next_size; j++) {
+            grow[j] = (uint8_t)(j + 1);
+        }
+        size = next_size;
+    }
+    rt_free(grow, size, 1);
+
+    const char* mode = getenv("SURGE_ALLOC");
+    if (mode != NULL && strcmp(mode, "arena") == 0) {
+        // Arena blocks carry their size, so callers passing the wrong one must not skew
+        // the live counters.
+        uint8_t* small = (uint8_t*)rt_alloc(100, 8);
+        uint8_t* large = (uint8_t*)rt_alloc(5000, 8);
+        small = (uint8_t*)rt_realloc(small, 1, 120, 8);
+        large = (uint8_t*)rt_realloc(large, 7, 6000, 8);
+        if (small == NULL || large == NULL) {
+            return fail("arena realloc failed");
+        }
+        rt_free(small, 3, 8);
+        rt_free(large, 0, 8);
+    }
+
+    uint64_t allocs2 = 0, frees2 = 0, blocks2 = 0, bytes2 = 0;
+    rt_heap_counts(&allocs2, &frees2, &blocks2, &bytes2);
+    if (allocs2 - allocs0 != frees2 - frees0) {
+        return fail("alloc and free counts do not balance");
+    }
+    if (blocks2 != blocks0 || bytes2 != bytes0) {
+        return fail("live counters did not return to their starting values");
+    }
+    return 0;
+}
+`
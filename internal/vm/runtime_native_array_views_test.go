@@ -0,0 +1,144 @@
+package vm_test
+
+import "testing"
+
+func TestNativeArrayViewsFollowTheirBaseAcrossThreads(t *testing.T) {
+	runNativeRuntimeHarness(t, "array_views_harness", arrayViewsHarness, "SURGE_THREADS=1")
+}
+
+// arrayViewsHarness slices arrays (and slices of slices), grows the base so its data
+// moves, and checks that every live view follows while views and bases are freed in
+// either order, on several threads at once.
+const arrayViewsHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { THREADS = 4, ROUNDS = 5000, VIEWS = 8 };
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} harness_array;
+
+static _Atomic int bad;
+
+static SurgeRange byte_range(int64_t start, int64_t end) {
+    SurgeRange r = {0};
+    r.start = rt_bigint_from_i64(start);
+    r.end = rt_bigint_from_i64(end);
+    r.has_start = 1;
+    r.has_end = 1;
+    return r;
+}
+
+static harness_array* make_array(uint64_t len) {
+    harness_array* a = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    a->len = 0;
+    a->cap = 0;
+    a->data = NULL;
+    uint8_t chunk[64];
+    for (uint64_t i = 0; i < len; i += sizeof(chunk)) {
+        uint64_t n = len - i < sizeof(chunk) ? len - i : sizeof(chunk);
+        for (uint64_t j = 0; j < n; j++) {
+            chunk[j] = (uint8_t)(i + j);
+        }
+        rt_array_append_raw_bytes(&a, chunk, n);
+    }
+    return a;
+}
+
+static harness_array* slice(harness_array* a, int64_t start, int64_t end) {
+    SurgeRange r = byte_range(start, end);
+    return (harness_array*)rt_array_slice(&a, &r, 1);
+}
+
+static void free_header(harness_array* a) {
+    rt_free((uint8_t*)a, sizeof(harness_array), _Alignof(harness_array));
+}
+
+static void free_array(harness_array* a) {
+    rt_free((uint8_t*)a->data, a->cap, 1);
+    free_header(a);
+}
+
+static void grow(harness_array* a, uint64_t extra) {
+    uint8_t zero[256] = {0};
+    while (extra > 0) {
+        uint64_t n = extra < sizeof(zero) ? extra : sizeof(zero);
+        rt_array_append_raw_bytes(&a, zero, n);
+        extra -= n;
+    }
+}
+
+static void* churn_main(void* arg) {
+    uint64_t seed = (uint64_t)(uintptr_t)arg;
+    for (int round = 0; round < ROUNDS; round++) {
+        harness_array* base = make_array(128);
+        harness_array* views[VIEWS];
+        int64_t offsets[VIEWS];
+        for (int i = 0; i < VIEWS; i++) {
+            offsets[i] = (int64_t)((seed + (uint64_t)round + (uint64_t)i * 7) % 64);
+            if (i % 2 == 0) {
+                views[i] = slice(base, offsets[i], offsets[i] + 32);
+            } else {
+                views[i] = slice(views[i - 1], 1, 16);
+                offsets[i] = offsets[i - 1] + 1;
+            }
+        }
+        free_header(views[0]);
+        grow(base, 4096);
+        for (int i = 1; i < VIEWS; i++) {
+            const uint8_t* want = (const uint8_t*)base->data + offsets[i];
+            if (views[i]->data != want || *(const uint8_t*)views[i]->data != (uint8_t)offsets[i]) {
+                atomic_store(&bad, 1);
+            }
+        }
+        if (round % 2 == 0) {
+            free_array(base);
+            for (int i = 1; i < VIEWS; i++) {
+                free_header(views[i]);
+            }
+        } else {
+            for (int i = 1; i < VIEWS; i++) {
+                free_header(views[i]);
+            }
+            free_array(base);
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    harness_array* base = make_array(200);
+    harness_array* outer = slice(base, 10, 100);
+    harness_array* inner = slice(outer, 5, 20);
+    if (outer->len != 90 || inner->len != 15 ||
+        inner->data != (uint8_t*)base->data + 15 || !rt_array_is_view(inner)) {
+        return fail("slice of a slice does not alias the base");
+    }
+    grow(base, 10000);
+    if (outer->data != (uint8_t*)base->data + 10 || inner->data != (uint8_t*)base->data + 15) {
+        return fail("views did not follow the base after it grew");
+    }
+    free_header(outer);
+    grow(base, 100000);
+    if (inner->data != (uint8_t*)base->data + 15 || *(uint8_t*)inner->data != 15) {
+        return fail("freeing one view detached another");
+    }
+    free_array(base);
+    free_header(inner);
+
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, churn_main, (void*)(uintptr_t)(i * 13));
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    if (atomic_load(&bad)) {
+        return fail("a view lost track of its base under concurrent slicing");
+    }
+    return 0;
+}
+`
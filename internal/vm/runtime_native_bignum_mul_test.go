@@ -0,0 +1,100 @@
+package vm_test
+
+import "testing"
+
+func TestNativeBignumMulDivMatchSchoolbook(t *testing.T) {
+	runNativeRuntimeHarness(t, "bignum_mul_harness", bignumMulHarness, "SURGE_THREADS=1")
+}
+
+func TestNativeBignumMulDivMatchSchoolbookWithTinyThresholds(t *testing.T) {
+	runNativeRuntimeHarness(t, "bignum_mul_tiny_harness", bignumMulHarness, "SURGE_THREADS=1",
+		"SURGE_BIGNUM_KARATSUBA=2", "SURGE_BIGNUM_TOOM3=5", "SURGE_BIGNUM_BZ=2")
+}
+
+// bignumMulHarness checks bu_mul against a 32-bit schoolbook product and bu_div_mod through
+// (a * b + r) / b == a, r for random, all-ones, sparse, and power-of-two operands. Run with
+// tiny thresholds, every Karatsuba, Toom-3, and Burnikel-Ziegler branch recurses many times.
+const bignumMulHarness = `
+#include "rt_async_internal.h"
+#include "rt_bignum_internal.h"
+#include "harness.h"
+
+enum { ITERS = 160, MAX_LIMBS = 420 };
+
+static uint64_t rng_state = UINT64_C(0x9e3779b97f4a7c15);
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)rng_state;
+}
+
+static SurgeBigUint* operand(uint32_t len, uint32_t shape) {
+    SurgeBigUint* u = bu_alloc(len, NULL);
+    for (uint32_t i = 0; i < len; i++) {
+        uint32_t v = rng();
+        if (shape == 1) {
+            v = 0xffffffffu;
+        } else if (shape == 2 && rng() % 4 != 0) {
+            v = 0;
+        } else if (shape == 3) {
+            v = 0;
+        }
+        u->limbs[i] = v;
+    }
+    u->limbs[len - 1] |= 1u;
+    return u;
+}
+
+static bool same(const SurgeBigUint* u, const uint32_t* limbs, uint32_t len) {
+    len = trim_len(limbs, len);
+    uint32_t ulen = u != NULL ? u->len : 0;
+    return ulen == len && (len == 0 || memcmp(u->limbs, limbs, (size_t)len * 4) == 0);
+}
+
+int main(void) {
+    for (int it = 0; it < ITERS; it++) {
+        uint32_t alen = 1 + rng() % MAX_LIMBS;
+        uint32_t blen = it % 3 == 0 ? alen : 1 + rng() % MAX_LIMBS;
+        SurgeBigUint* a = operand(alen, rng() % 4);
+        SurgeBigUint* b = operand(blen, rng() % 4);
+        uint32_t* ref = (uint32_t*)calloc(alen + blen, sizeof(uint32_t));
+        for (uint32_t i = 0; i < alen; i++) {
+            uint64_t carry = 0;
+            for (uint32_t j = 0; j < blen; j++) {
+                uint64_t sum = ref[i + j] + (uint64_t)a->limbs[i] * b->limbs[j] + carry;
+                ref[i + j] = (uint32_t)sum;
+                carry = sum >> 32;
+            }
+            ref[i + blen] = (uint32_t)carry;
+        }
+        bn_err err = BN_OK;
+        SurgeBigUint* product = bu_mul(a, b, &err);
+        if (err != BN_OK || !same(product, ref, alen + blen)) {
+            return fail("bu_mul disagrees with the schoolbook product");
+        }
+        SurgeBigUint* r = operand(blen, rng() % 4);
+        if (bu_cmp(r, b) >= 0) {
+            SurgeBigUint* smaller = bu_shr(r, 1 + (int)(bu_bitlen(r) - bu_bitlen(b)), &err);
+            bu_free(r);
+            r = smaller;
+        }
+        SurgeBigUint* n = bu_add(product, r, &err);
+        SurgeBigUint* rem = NULL;
+        SurgeBigUint* q = bu_div_mod(n, b, &rem, &err);
+        if (err != BN_OK || bu_cmp(q, a) != 0 || bu_cmp(rem, r) != 0) {
+            return fail("bu_div_mod does not invert bu_mul");
+        }
+        free(ref);
+        bu_free(a);
+        bu_free(b);
+        bu_free(product);
+        bu_free(r);
+        bu_free(n);
+        bu_free(q);
+        bu_free(rem);
+    }
+    return 0;
+}
+`
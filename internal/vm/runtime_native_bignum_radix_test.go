@@ -0,0 +1,136 @@
+package vm_test
+
+import "testing"
+
+func TestNativeBignumDecimalConversionMatchesChunkLoop(t *testing.T) {
+	runNativeRuntimeHarness(t, "bignum_radix_harness", bignumRadixHarness, "SURGE_THREADS=1")
+}
+
+// bignumRadixHarness formats random, all-nines, and zero-padded values of up to a few
+// thousand limbs, so the divide-and-conquer paths split several levels deep, and checks
+// the digits against a one-chunk-at-a-time 1e9 loop. Each string is parsed back, and the
+// same value is parsed from hex and binary digits.
+const bignumRadixHarness = `
+#include "rt_async_internal.h"
+#include "rt_bignum_internal.h"
+#include "harness.h"
+
+enum { ITERS = 48, MAX_LIMBS = 3000 };
+
+static uint64_t rng_state = UINT64_C(0x2545f4914f6cdd1d);
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)rng_state;
+}
+
+static SurgeBigUint* operand(uint32_t len, uint32_t shape) {
+    SurgeBigUint* u = bu_alloc(len, NULL);
+    for (uint32_t i = 0; i < len; i++) {
+        u->limbs[i] = shape == 1 ? 0xffffffffu : shape == 2 && i + 1 < len ? 0 : rng();
+    }
+    u->limbs[len - 1] |= 1u;
+    return u;
+}
+
+// 10^digits - 1 exercises every chunk boundary with nines.
+static SurgeBigUint* nines(uint32_t digits) {
+    SurgeBigUint* u = bu_pow10((int)digits, NULL);
+    SurgeBigUint* one = bu_from_u64(1, NULL);
+    SurgeBigUint* out = bu_sub(u, one, NULL);
+    bu_free(u);
+    bu_free(one);
+    return out;
+}
+
+static char* reference_format(const SurgeBigUint* u) {
+    size_t cap = (size_t)u->len * 12 + 20;
+    char* out = (char*)malloc(cap);
+    size_t pos = cap - 1;
+    out[pos] = 0;
+    SurgeBigUint* cur = bu_clone(u, NULL);
+    while (cur != NULL) {
+        uint32_t rem = 0;
+        SurgeBigUint* q = bu_div_mod_small(cur, 1000000000u, &rem, NULL);
+        bu_free(cur);
+        cur = q;
+        for (int i = 0; i < 9; i++) {
+            out[--pos] = (char)('0' + rem % 10);
+            rem /= 10;
+        }
+    }
+    while (out[pos] == '0' && out[pos + 1] != 0) {
+        pos++;
+    }
+    memmove(out, out + pos, cap - pos);
+    return out;
+}
+
+static bool parses_back(const char* s, size_t len, bool prefix, const SurgeBigUint* want) {
+    SurgeBigUint* got = NULL;
+    bn_err err = parse_uint_string((const uint8_t*)s, len, false, prefix, &got);
+    bool ok = err == BN_OK && bu_cmp(got, want) == 0;
+    bu_free(got);
+    return ok;
+}
+
+static bool check(const SurgeBigUint* u) {
+    bn_err err = BN_OK;
+    char* got = format_uint(u, &err);
+    char* want = reference_format(u);
+    bool ok = err == BN_OK && got != NULL && strcmp(got, want) == 0 &&
+              parses_back(got, strlen(got), false, u);
+    free(got);
+    free(want);
+    if (!ok) {
+        return false;
+    }
+    // The same value in hex and binary, most significant digit first.
+    size_t bits = bu_bitlen(u);
+    char* hex = (char*)malloc(bits / 4 + 4);
+    char* bin = (char*)malloc(bits + 4);
+    size_t hn = 2;
+    size_t bn = 2;
+    memcpy(hex, "0x", 2);
+    memcpy(bin, "0b", 2);
+    for (size_t i = (bits + 3) / 4; i-- > 0;) {
+        uint32_t nib = (u->limbs[i / 8] >> (4 * (i % 8))) & 15u;
+        hex[hn++] = "0123456789abcdef"[nib];
+    }
+    for (size_t i = bits; i-- > 0;) {
+        bin[bn++] = (char)('0' + ((u->limbs[i / 32] >> (i % 32)) & 1u));
+    }
+    ok = parses_back(hex, hn, true, u) && parses_back(bin, bn, true, u);
+    free(hex);
+    free(bin);
+    return ok;
+}
+
+int main(void) {
+    bn_err err = BN_OK;
+    char* zero = format_uint(NULL, &err);
+    if (err != BN_OK || zero == NULL || strcmp(zero, "0") != 0) {
+        return fail("format_uint(0) is not \"0\"");
+    }
+    free(zero);
+    if (!parses_back("0_000_000_000_000_000_000_000", 29, false, NULL)) {
+        return fail("zero padded with separators does not parse to zero");
+    }
+    for (int it = 0; it < ITERS; it++) {
+        uint32_t len = 1 + rng() % (it < ITERS / 2 ? 80 : MAX_LIMBS);
+        SurgeBigUint* u = operand(len, rng() % 3);
+        if (!check(u)) {
+            return fail("random value does not round-trip");
+        }
+        bu_free(u);
+        SurgeBigUint* n = nines(1 + rng() % (len * 9));
+        if (!check(n)) {
+            return fail("10^k - 1 does not round-trip");
+        }
+        bu_free(n);
+    }
+    return 0;
+}
+`
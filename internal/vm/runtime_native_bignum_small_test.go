@@ -0,0 +1,201 @@
+package vm_test
+
+import "testing"
+
+func TestNativeBignumInlineHandlesMatchLimbPath(t *testing.T) {
+	runNativeRuntimeHarness(t, "bignum_small_harness", bignumSmallHarness, "SURGE_THREADS=1")
+}
+
+// bignumSmallHarness runs every int and uint entry point twice: once on inline handles,
+// which take the fixed-width paths, and once on heap handles holding the same values, which
+// take the limb paths. Results must agree, hash alike, and come back inline whenever they
+// fit. Operands cluster around zero, the inline limits, and 2^32.
+const bignumSmallHarness = `
+#include "rt_async_internal.h"
+#include "rt_bignum_internal.h"
+#include "harness.h"
+
+static uint64_t rng_state = UINT64_C(0x853c49e6748fea9b);
+
+static uint64_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static int64_t pick_int(void) {
+    static const int64_t edges[] = {0, 1, -1, 2, -2, 3, 4294967295, 4294967296, -4294967296,
+                                    BN_SMALL_INT_MAX, BN_SMALL_INT_MIN, BN_SMALL_INT_MAX - 1,
+                                    BN_SMALL_INT_MIN + 1, 3037000499, -3037000499};
+    uint64_t r = rng();
+    switch (r % 4) {
+    case 0:
+        return edges[(r >> 8) % (sizeof(edges) / sizeof(edges[0]))];
+    case 1:
+        return (int64_t)(rng() % 2001) - 1000;
+    case 2:
+        return (int64_t)(rng() >> 34) * ((r >> 8) % 2 ? 1 : -1);
+    default:
+        return (int64_t)rng() >> 2;
+    }
+}
+
+static uint64_t pick_uint(void) {
+    static const uint64_t edges[] = {0, 1, 2, 4294967295u, 4294967296u, BN_SMALL_UINT_MAX,
+                                     BN_SMALL_UINT_MAX - 1, 4294967297u, UINT64_C(3037000499)};
+    uint64_t r = rng();
+    switch (r % 4) {
+    case 0:
+        return edges[(r >> 8) % (sizeof(edges) / sizeof(edges[0]))];
+    case 1:
+        return rng() % 1000;
+    case 2:
+        return rng() >> 33;
+    default:
+        return rng() >> 1;
+    }
+}
+
+static void* heap_int(int64_t v) {
+    return (void*)bi_from_i64(v, NULL);
+}
+
+static void* heap_uint(uint64_t v) {
+    return (void*)bu_from_u64(v, NULL);
+}
+
+static bool int_canonical(void* h) {
+    int64_t v = 0;
+    if (h == NULL || bn_is_small(h)) {
+        return true;
+    }
+    return !bi_to_i64((const SurgeBigInt*)h, &v) || v < BN_SMALL_INT_MIN || v > BN_SMALL_INT_MAX;
+}
+
+static bool uint_canonical(void* h) {
+    uint64_t v = 0;
+    if (h == NULL || bn_is_small(h)) {
+        return true;
+    }
+    return !bu_to_u64((const SurgeBigUint*)h, &v) || v > BN_SMALL_UINT_MAX;
+}
+
+static bool int_same(void* fast, void* slow) {
+    bn_small_buf fb;
+    bn_small_buf sb;
+    return int_canonical(fast) && int_canonical(slow) && rt_bigint_cmp(fast, slow) == 0 &&
+           bi_hash(bi_view(fast, &fb)) == bi_hash(bi_view(slow, &sb));
+}
+
+static bool uint_same(void* fast, void* slow) {
+    bn_small_buf fb;
+    bn_small_buf sb;
+    return uint_canonical(fast) && uint_canonical(slow) && rt_biguint_cmp(fast, slow) == 0 &&
+           bu_hash(bu_view(fast, &fb)) == bu_hash(bu_view(slow, &sb));
+}
+
+typedef void* (*binop)(void*, void*);
+
+static bool check_int_ops(int64_t x, int64_t y) {
+    static const binop ops[] = {rt_bigint_add, rt_bigint_sub, rt_bigint_mul, rt_bigint_bit_and,
+                                rt_bigint_bit_or, rt_bigint_bit_xor};
+    void* a = rt_bigint_from_i64(x);
+    void* b = rt_bigint_from_i64(y);
+    void* ha = heap_int(x);
+    void* hb = heap_int(y);
+    for (size_t k = 0; k < sizeof(ops) / sizeof(ops[0]); k++) {
+        if (!int_same(ops[k](a, b), ops[k](ha, hb))) {
+            return false;
+        }
+    }
+    if (y != 0 && (!int_same(rt_bigint_div(a, b), rt_bigint_div(ha, hb)) ||
+                   !int_same(rt_bigint_mod(a, b), rt_bigint_mod(ha, hb)))) {
+        return false;
+    }
+    int64_t shift = (int64_t)(rng() % 70);
+    void* s = rt_bigint_from_i64(shift);
+    void* hs = heap_int(shift);
+    if (!int_same(rt_bigint_shl(a, s), rt_bigint_shl(ha, hs)) ||
+        !int_same(rt_bigint_shr(a, s), rt_bigint_shr(ha, hs))) {
+        return false;
+    }
+    int64_t back = 0;
+    return int_same(rt_bigint_neg(a), rt_bigint_neg(ha)) &&
+           int_same(rt_bigint_abs(a), rt_bigint_abs(ha)) &&
+           rt_bigint_cmp(a, b) == rt_bigint_cmp(ha, hb) && rt_bigint_to_i64(a, &back) && back == x;
+}
+
+static bool check_uint_ops(uint64_t x, uint64_t y) {
+    static const binop ops[] = {rt_biguint_add, rt_biguint_mul, rt_biguint_bit_and,
+                                rt_biguint_bit_or, rt_biguint_bit_xor};
+    void* a = rt_biguint_from_u64(x);
+    void* b = rt_biguint_from_u64(y);
+    void* ha = heap_uint(x);
+    void* hb = heap_uint(y);
+    for (size_t k = 0; k < sizeof(ops) / sizeof(ops[0]); k++) {
+        if (!uint_same(ops[k](a, b), ops[k](ha, hb))) {
+            return false;
+        }
+    }
+    if (x >= y && !uint_same(rt_biguint_sub(a, b), rt_biguint_sub(ha, hb))) {
+        return false;
+    }
+    if (y != 0 && (!uint_same(rt_biguint_div(a, b), rt_biguint_div(ha, hb)) ||
+                   !uint_same(rt_biguint_mod(a, b), rt_biguint_mod(ha, hb)))) {
+        return false;
+    }
+    uint64_t shift = rng() % 70;
+    void* s = rt_biguint_from_u64(shift);
+    void* hs = heap_uint(shift);
+    uint64_t back = 0;
+    return uint_same(rt_biguint_shl(a, s), rt_biguint_shl(ha, hs)) &&
+           uint_same(rt_biguint_shr(a, s), rt_biguint_shr(ha, hs)) &&
+           rt_biguint_cmp(a, b) == rt_biguint_cmp(ha, hb) && rt_biguint_to_u64(a, &back) &&
+           back == x;
+}
+
+static bool same_text(void* s, const char* want) {
+    size_t n = strlen(want);
+    return rt_string_len_bytes(&s) == n && memcmp(rt_string_ptr(&s), want, n) == 0;
+}
+
+int main(void) {
+    if (rt_bigint_from_i64(0) != NULL || rt_biguint_from_u64(0) != NULL) {
+        return fail("zero is not the NULL handle");
+    }
+    if (!bn_is_small(rt_bigint_from_i64(BN_SMALL_INT_MIN)) ||
+        bn_is_small(rt_bigint_from_i64(BN_SMALL_INT_MIN - 1)) ||
+        !bn_is_small(rt_biguint_from_u64(BN_SMALL_UINT_MAX)) ||
+        bn_is_small(rt_biguint_from_u64(BN_SMALL_UINT_MAX + 1))) {
+        return fail("inline range boundaries are off");
+    }
+    for (int it = 0; it < 20000; it++) {
+        if (!check_int_ops(pick_int(), pick_int())) {
+            return fail("inline int path disagrees with limbs");
+        }
+        if (!check_uint_ops(pick_uint(), pick_uint())) {
+            return fail("inline uint path disagrees with limbs");
+        }
+    }
+    void* lit = rt_biguint_from_literal((const uint8_t*)"0x10", 4);
+    if (!bn_is_small(lit) || !same_text(rt_string_from_biguint(lit), "16")) {
+        return fail("uint literal is not inline");
+    }
+    void* neg = rt_bigint_neg(rt_bigint_from_literal((const uint8_t*)"123456789", 9));
+    if (!bn_is_small(neg) || !same_text(rt_string_from_bigint(neg), "-123456789")) {
+        return fail("int literal is not inline");
+    }
+    void* big = rt_biguint_mul(rt_biguint_from_u64(BN_SMALL_UINT_MAX), rt_biguint_from_u64(4));
+    void* back = rt_biguint_div(big, rt_biguint_from_u64(4));
+    if (bn_is_small(big) || !bn_is_small(back) ||
+        !same_text(rt_string_from_biguint(big), "36893488147419103228")) {
+        return fail("overflowing product does not promote and demote");
+    }
+    void* as_int = rt_biguint_to_bigint(back);
+    if (bn_is_small(as_int) || !bn_is_small(rt_bigint_to_biguint(as_int))) {
+        return fail("int/uint conversion does not follow the inline ranges");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,126 @@
+package vm_test
+
+import "testing"
+
+func TestNativeBlockingPoolGrowsAndShrinks(t *testing.T) {
+	runNativeRuntimeHarness(t, "blocking_pool_harness", blockingPoolHarness,
+		"SURGE_THREADS=2",
+		"SURGE_BLOCKING_THREADS=2",
+		"SURGE_BLOCKING_MAX_THREADS=8",
+		"SURGE_BLOCKING_GROW_US=500",
+		"SURGE_BLOCKING_IDLE_MS=50")
+}
+
+// blockingPoolHarness parks every core pool thread in a job that waits on a gate, so the
+// rest of a burst can only start if the monitor grows the pool. Once the gate opens and
+// the pool sits idle, the extra threads must retire back to the core size. A burst of
+// short jobs then checks that the lock-free job queue delivers every job exactly once,
+// and both latency histograms must account for every job that ran.
+const blockingPoolHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_BLOCKING_CALL
+#include "harness.h"
+
+#include <time.h>
+
+enum { FN_GATED = 1, FN_DOUBLE = 2 };
+enum { CORE = 2, MAX = 8, GATED = MAX, BURST = 5000 };
+
+static _Atomic int gate_open;
+static _Atomic int gated_running;
+
+uint64_t __surge_blocking_call(uint64_t id, void* state) {
+    uint64_t value = state != NULL ? *(const uint64_t*)state : 0;
+    if (id == FN_GATED) {
+        atomic_fetch_add(&gated_running, 1);
+        struct timespec pause = {0, 100000};
+        while (!atomic_load(&gate_open)) {
+            nanosleep(&pause, NULL);
+        }
+        return value;
+    }
+    return value * 2;
+}
+
+static int wait_until(int (*cond)(rt_executor*), rt_executor* ex) {
+    struct timespec pause = {0, 1000000};
+    for (int i = 0; i < 5000; i++) {
+        if (cond(ex)) {
+            return 1;
+        }
+        nanosleep(&pause, NULL);
+    }
+    return 0;
+}
+
+static int all_gated_running(rt_executor* ex) {
+    (void)ex;
+    return atomic_load(&gated_running) == GATED;
+}
+
+static int pool_back_to_core(rt_executor* ex) {
+    pthread_mutex_lock(&ex->blocking_lock);
+    uint32_t live = ex->blocking_live;
+    pthread_mutex_unlock(&ex->blocking_lock);
+    return live == CORE;
+}
+
+static uint64_t hist_total(const atomic_u64* hist) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < RT_LATENCY_HIST_BUCKETS; b++) {
+        total += atomic_load(&hist[b]);
+    }
+    return total;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    static uint64_t gated_values[GATED];
+    void* gated[GATED];
+    for (int i = 0; i < GATED; i++) {
+        gated_values[i] = (uint64_t)i;
+        gated[i] = rt_blocking_submit(FN_GATED, &gated_values[i], 0, 1);
+    }
+    if (!wait_until(all_gated_running, ex)) {
+        return fail("pool did not grow past its busy core threads");
+    }
+    atomic_store(&gate_open, 1);
+    for (int i = 0; i < GATED; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(gated[i], &kind, &bits);
+        if (kind != 1 || bits != (uint64_t)i) {
+            return fail("gated job returned the wrong result");
+        }
+    }
+    if (ex->blocking_peak != MAX) {
+        return fail("pool peak does not match the thread cap");
+    }
+    if (!wait_until(pool_back_to_core, ex)) {
+        return fail("idle threads above the core size did not retire");
+    }
+
+    static uint64_t values[BURST];
+    static void* tasks[BURST];
+    for (int i = 0; i < BURST; i++) {
+        values[i] = (uint64_t)i + 1;
+        tasks[i] = rt_blocking_submit(FN_DOUBLE, &values[i], 0, 1);
+    }
+    for (int i = 0; i < BURST; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(tasks[i], &kind, &bits);
+        if (kind != 1 || bits != values[i] * 2) {
+            return fail("burst job lost or returned the wrong result");
+        }
+    }
+    if (ex->blocking_peak > MAX) {
+        return fail("pool grew past its thread cap");
+    }
+    uint64_t ran = (uint64_t)GATED + BURST;
+    if (hist_total(ex->blocking_wait_hist) != ran || hist_total(ex->blocking_run_hist) != ran) {
+        return fail("latency histograms missed a job");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,104 @@
+package vm_test
+
+import "testing"
+
+func TestNativeByteQueueReclaimsPrefixOnlyWhenTailIsShort(t *testing.T) {
+	runNativeRuntimeHarness(t, "byte_queue_harness", byteQueueHarness, "SURGE_THREADS=1")
+}
+
+// byteQueueHarness drives rt_byte_array_reserve_tail the way a protocol parser does: reads
+// append chunks, frames are consumed by moving a start offset, and the dead prefix must only
+// be reclaimed when the next chunk would not fit, without growing past a couple of chunks.
+const byteQueueHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} harness_array;
+
+enum { CHUNK = 4096, FRAME = 16, ROUNDS = 512 };
+
+static uint8_t stream_byte(uint64_t at) {
+    return (uint8_t)(at * 7 + at / 251);
+}
+
+int main(void) {
+    harness_array* arr = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    arr->len = 0;
+    arr->cap = 0;
+    arr->data = NULL;
+
+    uint8_t seed[64];
+    for (int i = 0; i < 64; i++) {
+        seed[i] = stream_byte((uint64_t)i);
+    }
+    rt_array_append_raw_bytes(&arr, seed, 64);
+    rt_byte_array_reserve_spare(&arr, 64);
+    uint64_t cap_before = arr->cap;
+    void* data_before = arr->data;
+    if (rt_byte_array_reserve_tail(&arr, 8, arr->cap - arr->len) != 0 || arr->len != 64 ||
+        arr->data != data_before) {
+        return fail("reserve_tail moved bytes although the tail had room");
+    }
+    if (rt_byte_array_reserve_tail(&arr, 40, arr->cap - arr->len + 8) != 40 || arr->len != 24 ||
+        arr->cap != cap_before || memcmp(arr->data, seed + 40, 24) != 0) {
+        return fail("mostly consumed buffer was not compacted in place");
+    }
+    if (rt_byte_array_reserve_tail(&arr, 4, arr->cap) != 4 || arr->len != 20 ||
+        arr->cap < 20 + cap_before || memcmp(arr->data, seed + 44, 20) != 0) {
+        return fail("mostly live buffer did not grow and drop its prefix");
+    }
+
+    arr->len = 0;
+    uint64_t start = 0;
+    uint64_t produced = 0;
+    uint64_t consumed = 0;
+    uint64_t reclaims = 0;
+    uint64_t max_cap = 0;
+    uint8_t chunk[CHUNK + FRAME / 2];
+    for (int round = 0; round < ROUNDS; round++) {
+        // Odd-sized chunks leave a partial frame behind, as real reads do.
+        uint64_t n = CHUNK + (uint64_t)(round % 2) * (FRAME / 2);
+        for (uint64_t i = 0; i < n; i++) {
+            chunk[i] = stream_byte(produced + i);
+        }
+        bool short_tail = arr->cap - arr->len < n;
+        uint64_t dropped = rt_byte_array_reserve_tail(&arr, start, n);
+        if (dropped != (short_tail ? start : 0)) {
+            return fail("prefix was reclaimed while the tail still had room");
+        }
+        if (dropped != 0) {
+            reclaims++;
+        }
+        start -= dropped;
+        rt_array_append_raw_bytes(&arr, chunk, n);
+        produced += n;
+        if (arr->cap > max_cap) {
+            max_cap = arr->cap;
+        }
+        while (arr->len - start >= FRAME) {
+            const uint8_t* frame = (const uint8_t*)arr->data + start;
+            for (uint64_t i = 0; i < FRAME; i++) {
+                if (frame[i] != stream_byte(consumed + i)) {
+                    return fail("consumed frame does not match the stream");
+                }
+            }
+            start += FRAME;
+            consumed += FRAME;
+        }
+    }
+    if (consumed + FRAME <= produced) {
+        return fail("frames were lost");
+    }
+    if (max_cap > 4 * CHUNK) {
+        return fail("queue grew instead of reusing its consumed prefix");
+    }
+    if (reclaims == 0) {
+        return fail("prefix was never reclaimed");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,176 @@
+package vm_test
+
+import "testing"
+
+func TestNativeByteScanKernelsMatchReference(t *testing.T) {
+	runNativeRuntimeHarness(t, "byte_scan_harness", byteScanHarness, "SURGE_THREADS=1")
+}
+
+// byteScanHarness compares the rt_byte_* scanners and rt_json_structural_index with
+// byte-at-a-time references on random ranges over a small alphabet, so matches, backslash
+// runs, and quotes land on both sides of every 16-, 32-, and 64-byte block edge.
+const byteScanHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} TestArray;
+
+static uint64_t rng = 0x9e3779b97f4a7c15u;
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)rng;
+}
+
+static const uint8_t alphabet[] = {
+    '"', '\\', '{', '}', '[', ']', ':', ',', 'a', 'b', ' ', '\t', '\n', '\r', 0x1F, 0xFF, 0,
+};
+
+static int ref_in_set(const uint8_t* set, uint64_t n, uint8_t b) {
+    for (uint64_t k = 0; k < n; k++) {
+        if (set[k] == b) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int ref_is_ws(uint8_t b) {
+    return b == ' ' || b == '\t' || b == '\n' || b == '\r';
+}
+
+static uint64_t ref_find(const uint8_t* d, uint64_t s, uint64_t e, const uint8_t* set, uint64_t n) {
+    for (uint64_t i = s; i < e; i++) {
+        if (ref_in_set(set, n, d[i])) {
+            return i;
+        }
+    }
+    return e;
+}
+
+// Escapes are tracked everywhere, as in simdjson: a backslash outside a string still escapes
+// the next byte.
+static uint64_t ref_structural(const uint8_t* d, uint64_t s, uint64_t e, uint64_t* out, uint64_t* n) {
+    static const uint8_t ops[] = {'{', '}', '[', ']', ':', ','};
+    int in_string = 0;
+    int escaped = 0;
+    uint64_t open = e;
+    *n = 0;
+    for (uint64_t i = s; i < e; i++) {
+        int esc = escaped;
+        escaped = 0;
+        if (d[i] == '\\' && !esc) {
+            escaped = 1;
+        }
+        if (d[i] == '"' && !esc) {
+            out[(*n)++] = i;
+            in_string = !in_string;
+            if (in_string) {
+                open = i;
+            }
+            continue;
+        }
+        if (!in_string && ref_in_set(ops, sizeof(ops), d[i])) {
+            out[(*n)++] = i;
+        }
+    }
+    return in_string ? open : e;
+}
+
+static int check_range(TestArray* arr, uint64_t s, uint64_t e) {
+    const uint8_t* d = (const uint8_t*)arr->data;
+    uint8_t set[24];
+    for (uint64_t k = 0; k < sizeof(set); k++) {
+        set[k] = alphabet[next_rand() % sizeof(alphabet)];
+    }
+    if (rt_byte_find(arr, s, e, set[0]) != ref_find(d, s, e, set, 1)) {
+        return fail("rt_byte_find disagrees with the reference");
+    }
+    if (rt_byte_find2(arr, s, e, set[0], set[1]) != ref_find(d, s, e, set, 2)) {
+        return fail("rt_byte_find2 disagrees with the reference");
+    }
+    if (rt_byte_find3(arr, s, e, set[0], set[1], set[2]) != ref_find(d, s, e, set, 3)) {
+        return fail("rt_byte_find3 disagrees with the reference");
+    }
+    uint64_t set_len = 1 + next_rand() % sizeof(set);
+    TestArray set_arr = {set_len, set_len, set};
+    if (rt_byte_find_set(arr, s, e, &set_arr) != ref_find(d, s, e, set, set_len)) {
+        return fail("rt_byte_find_set disagrees with the reference");
+    }
+    uint64_t count = 0;
+    uint64_t skip = e;
+    uint64_t ws = e;
+    uint64_t str = e;
+    for (uint64_t i = e; i > s; i--) {
+        uint8_t b = d[i - 1];
+        count += b == set[0];
+        skip = ref_is_ws(b) ? skip : i - 1;
+        ws = ref_is_ws(b) ? i - 1 : ws;
+        str = (b == '"' || b == '\\' || b < 0x20) ? i - 1 : str;
+    }
+    if (rt_byte_count(arr, s, e, set[0]) != count) {
+        return fail("rt_byte_count disagrees with the reference");
+    }
+    if (rt_byte_skip_ascii_ws(arr, s, e) != skip) {
+        return fail("rt_byte_skip_ascii_ws disagrees with the reference");
+    }
+    if (rt_byte_find_ascii_ws(arr, s, e) != ws) {
+        return fail("rt_byte_find_ascii_ws disagrees with the reference");
+    }
+    if (rt_json_scan_string(arr, s, e) != str) {
+        return fail("rt_json_scan_string disagrees with the reference");
+    }
+
+    static uint64_t want[512];
+    uint64_t want_len = 0;
+    uint64_t want_ret = ref_structural(d, s, e, want, &want_len);
+    TestArray index = {0, 0, NULL};
+    void* slot = &index;
+    if (rt_json_structural_index(arr, s, e, &slot) != want_ret) {
+        return fail("rt_json_structural_index result disagrees with the reference");
+    }
+    if (index.len != want_len) {
+        return fail("rt_json_structural_index length disagrees with the reference");
+    }
+    for (uint64_t k = 0; k < want_len; k++) {
+        if (((uint64_t*)index.data)[k] != want[k]) {
+            return fail("rt_json_structural_index offset disagrees with the reference");
+        }
+    }
+    if (index.data != NULL) {
+        rt_free((uint8_t*)index.data, index.cap * sizeof(uint64_t), sizeof(uint64_t));
+    }
+    return 0;
+}
+
+int main(void) {
+    static uint8_t buf[400];
+    TestArray arr = {0, sizeof(buf), buf};
+    for (int round = 0; round < 20000; round++) {
+        uint64_t len = next_rand() % sizeof(buf);
+        // Mostly plain bytes, so runs between matches cross block edges.
+        uint32_t density = 1 + next_rand() % 16;
+        for (uint64_t i = 0; i < len; i++) {
+            buf[i] = next_rand() % density == 0 ? alphabet[next_rand() % sizeof(alphabet)] : 'x';
+        }
+        arr.len = len;
+        uint64_t s = len == 0 ? 0 : next_rand() % (len + 1);
+        if (check_range(&arr, s, len) != 0 || check_range(&arr, 0, len) != 0) {
+            return 1;
+        }
+    }
+
+    TestArray empty = {0, 0, NULL};
+    if (rt_byte_find(&empty, 0, 0, 'a') != 0 || rt_byte_find(&arr, 5, 2, 'a') != 2 ||
+        rt_byte_count(&arr, 0, arr.len + 1, 'a') != 0 || rt_byte_skip_ascii_ws(NULL, 0, 7) != 7) {
+        return fail("invalid ranges must report end");
+    }
+    return 0;
+}
+`
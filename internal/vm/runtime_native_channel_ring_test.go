@@ -0,0 +1,196 @@
+package vm_test
+
+import "testing"
+
+func TestNativeChannelRingDeliversEachValueOnceInOrder(t *testing.T) {
+	runNativeRuntimeHarness(t, "channel_ring_harness", channelRingHarness, "SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1")
+}
+
+// channelRingHarness runs producers against consumers on buffered channels of several
+// capacities, so values move through the lock-free ring, through handoffs to parked
+// receivers, and through refills from parked senders. Half of the producers send in
+// batches with send_many, falling back to a blocking send when nothing fits, and half of
+// the consumers drain the channel with try_recv after each blocking recv. Every value
+// must arrive exactly once, and each producer's values must reach any one consumer in
+// order. A select task then takes every value of a channel fed by try_send from a plain
+// thread through its recv arm; a lost wakeup or a value handed to the parked select
+// hangs it.
+const channelRingHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_PRODUCER = 1, FN_CONSUMER = 2, FN_SELECT = 3 };
+enum { ARM_CHAN_RECV = 1 }; // SELECT_CHAN_RECV in rt_async_task.c
+enum { PRODUCERS = 4, CONSUMERS = 4, PER_PRODUCER = 20000, SELECTS = 20000, BATCH = 8 };
+
+typedef struct {
+    int phase;
+    void* ch;
+    uint64_t id;
+    uint64_t next;
+    uint64_t got;
+    uint64_t last[PRODUCERS];
+    int batch;
+} harness_state;
+
+static _Atomic uint8_t seen[PRODUCERS * PER_PRODUCER];
+static _Atomic int bad;
+
+static void consume(harness_state* st, uint64_t bits) {
+    uint64_t producer = bits >> 32;
+    uint64_t seq = bits & 0xffffffffu;
+    if (producer >= PRODUCERS || seq == 0 || seq > PER_PRODUCER || seq <= st->last[producer] ||
+        atomic_fetch_add(&seen[producer * PER_PRODUCER + seq - 1], 1) != 0) {
+        atomic_store(&bad, 1);
+    }
+    st->last[producer] = seq;
+    st->got++;
+}
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    uint64_t bits = 0;
+    switch (id) {
+        case FN_PRODUCER:
+            while (st->next <= PER_PRODUCER) {
+                if (st->batch && st->phase == 0) {
+                    uint64_t vals[BATCH];
+                    uint64_t n = 0;
+                    while (n < BATCH && st->next + n <= PER_PRODUCER) {
+                        vals[n] = (st->id << 32) | (st->next + n);
+                        n++;
+                    }
+                    uint64_t sent = rt_channel_send_many(st->ch, vals, n);
+                    if (sent > n) {
+                        atomic_store(&bad, 1);
+                    }
+                    st->next += sent;
+                    if (sent > 0) {
+                        continue;
+                    }
+                    // Nothing fit: park on one plain send, which a re-poll resumes.
+                    st->phase = 1;
+                }
+                if (!rt_channel_send(st->ch, (st->id << 32) | st->next)) {
+                    rt_async_yield(st);
+                }
+                st->phase = 0;
+                st->next++;
+            }
+            rt_async_return(st, 0);
+            break;
+        case FN_CONSUMER:
+            for (;;) {
+                uint8_t status = rt_channel_recv(st->ch, &bits);
+                if (status == 0) {
+                    rt_async_yield(st);
+                }
+                if (status == 2) {
+                    rt_async_return(st, st->got);
+                }
+                consume(st, bits);
+                while (st->batch && rt_channel_try_recv(st->ch, &bits)) {
+                    consume(st, bits);
+                }
+            }
+            break;
+        case FN_SELECT: {
+            uint8_t kinds[1] = {ARM_CHAN_RECV};
+            void* handles[1] = {st->ch};
+            uint64_t values[1] = {0};
+            uint64_t ms[1] = {0};
+            while (st->got < SELECTS) {
+                if (rt_select_poll(1, kinds, handles, values, ms, -1) < 0) {
+                    rt_async_yield(st);
+                }
+                st->got++;
+            }
+            rt_async_return(st, st->got);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static int run_capacity(uint64_t capacity) {
+    memset(seen, 0, sizeof(seen));
+    void* ch = rt_channel_new(capacity);
+    static harness_state producers[PRODUCERS];
+    static harness_state consumers[CONSUMERS];
+    void* producer_tasks[PRODUCERS];
+    void* consumer_tasks[CONSUMERS];
+    for (int i = 0; i < CONSUMERS; i++) {
+        memset(&consumers[i], 0, sizeof(consumers[i]));
+        consumers[i].ch = ch;
+        consumers[i].batch = i % 2;
+        consumer_tasks[i] = __task_create(FN_CONSUMER, &consumers[i]);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        memset(&producers[i], 0, sizeof(producers[i]));
+        producers[i].ch = ch;
+        producers[i].id = (uint64_t)i;
+        producers[i].next = 1;
+        producers[i].batch = i % 2;
+        producer_tasks[i] = __task_create(FN_PRODUCER, &producers[i]);
+    }
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    for (int i = 0; i < PRODUCERS; i++) {
+        rt_task_await(producer_tasks[i], &kind, &bits);
+        if (kind != 1) {
+            return fail("producer did not finish");
+        }
+    }
+    rt_channel_close(ch);
+    uint64_t total = 0;
+    for (int i = 0; i < CONSUMERS; i++) {
+        rt_task_await(consumer_tasks[i], &kind, &bits);
+        if (kind != 1) {
+            return fail("consumer did not finish");
+        }
+        total += bits;
+    }
+    if (atomic_load(&bad)) {
+        return fail("a value was duplicated, corrupted, or reordered");
+    }
+    if (total != (uint64_t)PRODUCERS * PER_PRODUCER) {
+        return fail("a value was lost");
+    }
+    uint64_t extra = 0;
+    if (rt_channel_try_recv(ch, &extra) || rt_channel_try_send(ch, 1) ||
+        rt_channel_send_many(ch, &extra, 1) != 0) {
+        return fail("closed, drained channel still moves values");
+    }
+    return 0;
+}
+
+int main(void) {
+    static const uint64_t capacities[] = {1, 3, 64};
+    for (size_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+        if (run_capacity(capacities[i]) != 0) {
+            return 1;
+        }
+    }
+
+    void* ch = rt_channel_new(4);
+    static harness_state selector;
+    selector.ch = ch;
+    void* task = __task_create(FN_SELECT, &selector);
+    for (uint64_t sent = 0; sent < SELECTS;) {
+        if (rt_channel_try_send(ch, sent)) {
+            sent++;
+        } else {
+            sched_yield();
+        }
+    }
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    rt_task_await(task, &kind, &bits);
+    if (kind != 1 || bits != SELECTS) {
+        return fail("select task missed a value");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,261 @@
+package vm_test
+
+import "testing"
+
+func TestNativeWorkStealingDequeHandsOutEachIdOnce(t *testing.T) {
+	runNativeRuntimeHarness(t, "ws_deque_harness", wsDequeHarness, "SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1")
+}
+
+func TestNativeInjectQueueHandsOutEachIdOnce(t *testing.T) {
+	runNativeRuntimeHarness(t, "mpmc_inject_harness", mpmcInjectHarness, "SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1")
+}
+
+func TestNativeExecutorStealsAcrossWorkers(t *testing.T) {
+	runNativeRuntimeHarness(t, "ws_executor_harness", wsExecutorHarness, "SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1")
+}
+
+// wsDequeHarness races an owner pushing and popping without a lock against thieves and
+// checks that every pushed id is taken once.
+const wsDequeHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { THIEVES = 3, ITEMS = 200000 };
+
+static rt_deque dq;
+static _Atomic uint8_t seen[ITEMS + 1];
+static _Atomic int taken;
+static _Atomic int done_pushing;
+static _Atomic int dup;
+
+static void take(uint64_t id) {
+    if (id == 0 || id > ITEMS || atomic_fetch_add(&seen[id], 1) != 0) {
+        atomic_store(&dup, 1);
+    }
+    atomic_fetch_add(&taken, 1);
+}
+
+static void* thief_main(void* arg) {
+    (void)arg;
+    uint64_t id = 0;
+    for (;;) {
+        if (deque_steal(&dq, &id)) {
+            take(id);
+            continue;
+        }
+        if (atomic_load(&done_pushing) && deque_len(&dq) == 0) {
+            return NULL;
+        }
+    }
+}
+
+int main(void) {
+    pthread_t thieves[THIEVES];
+    for (int i = 0; i < THIEVES; i++) {
+        pthread_create(&thieves[i], NULL, thief_main, NULL);
+    }
+    uint64_t id = 0;
+    for (uint64_t next = 1; next <= ITEMS; next++) {
+        deque_push(&dq, next, "overflow", "alloc");
+        if (next % 3 == 0 && deque_pop(&dq, &id)) {
+            take(id);
+        }
+    }
+    while (deque_pop(&dq, &id)) {
+        take(id);
+    }
+    atomic_store(&done_pushing, 1);
+    for (int i = 0; i < THIEVES; i++) {
+        pthread_join(thieves[i], NULL);
+    }
+    if (atomic_load(&dup)) {
+        return fail("an id was handed out twice");
+    }
+    if (atomic_load(&taken) != ITEMS) {
+        return fail("an id was lost");
+    }
+
+    rt_deque fifo = {0};
+    for (uint64_t i = 1; i <= 100; i++) {
+        deque_push(&fifo, i, "overflow", "alloc");
+    }
+    for (uint64_t i = 1; i <= 50; i++) {
+        if (!deque_steal(&fifo, &id) || id != i) {
+            return fail("steal did not take the oldest entry");
+        }
+    }
+    if (!deque_pop(&fifo, &id) || id != 100) {
+        return fail("owner pop did not take the newest entry");
+    }
+    return 0;
+}
+`
+
+// mpmcInjectHarness races producers against consumers on one inject queue, through enough
+// ring growth to cross several segments, and checks that every id is taken once and that a
+// single thread gets them back in push order.
+const mpmcInjectHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { PRODUCERS = 3, CONSUMERS = 3, PER_PRODUCER = 100000 };
+enum { ITEMS = PRODUCERS * PER_PRODUCER };
+
+static rt_mpmc q;
+static _Atomic uint8_t seen[ITEMS + 1];
+static _Atomic int taken;
+static _Atomic int producers_done;
+static _Atomic int dup;
+
+static void* producer_main(void* arg) {
+    uint64_t base = (uint64_t)(uintptr_t)arg * PER_PRODUCER;
+    for (uint64_t i = 1; i <= PER_PRODUCER; i++) {
+        mpmc_push(&q, base + i, "overflow", "alloc");
+    }
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+static void* consumer_main(void* arg) {
+    (void)arg;
+    uint64_t id = 0;
+    for (;;) {
+        if (mpmc_pop(&q, &id)) {
+            if (id == 0 || id > ITEMS || atomic_fetch_add(&seen[id], 1) != 0) {
+                atomic_store(&dup, 1);
+            }
+            atomic_fetch_add(&taken, 1);
+            continue;
+        }
+        if (atomic_load(&producers_done) == PRODUCERS && mpmc_len(&q) == 0) {
+            return NULL;
+        }
+    }
+}
+
+int main(void) {
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, consumer_main, NULL);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, producer_main, (void*)(uintptr_t)i);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    if (atomic_load(&dup)) {
+        return fail("an id was handed out twice");
+    }
+    if (atomic_load(&taken) != ITEMS) {
+        return fail("an id was lost");
+    }
+
+    rt_mpmc fifo = {0};
+    uint64_t id = 0;
+    for (uint64_t i = 1; i <= 1000; i++) {
+        mpmc_push(&fifo, i, "overflow", "alloc");
+        if (i % 4 == 0 && (!mpmc_pop(&fifo, &id) || id != i / 4)) {
+            return fail("pop did not take the oldest entry");
+        }
+    }
+    for (uint64_t i = 251; i <= 1000; i++) {
+        if (!mpmc_pop(&fifo, &id) || id != i) {
+            return fail("entries came back out of push order");
+        }
+    }
+    if (mpmc_pop(&fifo, &id) || mpmc_len(&fifo) != 0) {
+        return fail("drained queue still hands out entries");
+    }
+    return 0;
+}
+`
+
+// wsExecutorHarness spawns trees of yielding tasks on several workers and checks that
+// each task result arrives once and the executor ends up idle.
+const wsExecutorHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_LEAF = 1, FN_FANOUT = 2 };
+enum { ROOTS = 64, CHILDREN = 32, YIELDS = 3 };
+
+typedef struct {
+    int phase;
+    uint64_t arg;
+    uint64_t sum;
+    void* children[CHILDREN];
+} harness_state;
+
+static _Atomic uint64_t leaf_polls;
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    uint64_t bits = 0;
+    switch (id) {
+        case FN_LEAF:
+            atomic_fetch_add(&leaf_polls, 1);
+            if (st->phase < YIELDS) {
+                st->phase++;
+                rt_async_yield(st);
+            }
+            rt_async_return(st, st->arg);
+            break;
+        case FN_FANOUT:
+            if (st->phase == 0) {
+                for (int i = 0; i < CHILDREN; i++) {
+                    harness_state* child = calloc(1, sizeof(*child));
+                    child->arg = st->arg * CHILDREN + (uint64_t)i;
+                    st->children[i] = __task_create(FN_LEAF, child);
+                }
+                st->phase = 1;
+            }
+            while (st->phase <= CHILDREN) {
+                if (rt_task_poll(st->children[st->phase - 1], &bits) == 0) {
+                    rt_async_yield(st);
+                }
+                st->sum += bits;
+                st->phase++;
+            }
+            rt_async_return(st, st->sum);
+            break;
+        default:
+            break;
+    }
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    static harness_state roots[ROOTS];
+    void* handles[ROOTS];
+    for (int i = 0; i < ROOTS; i++) {
+        roots[i].arg = (uint64_t)i;
+        handles[i] = __task_create(FN_FANOUT, &roots[i]);
+    }
+    for (int i = 0; i < ROOTS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(handles[i], &kind, &bits);
+        uint64_t base = (uint64_t)i * CHILDREN;
+        uint64_t want = base * CHILDREN + (uint64_t)(CHILDREN * (CHILDREN - 1) / 2);
+        if (kind != 1 || bits != want) {
+            return fail("fan-out task returned the wrong sum");
+        }
+    }
+    if (atomic_load(&leaf_polls) != (uint64_t)ROOTS * CHILDREN * (YIELDS + 1)) {
+        return fail("a leaf task was polled the wrong number of times");
+    }
+    rt_lock(ex);
+    int idle = runnable_is_empty(ex);
+    rt_unlock(ex);
+    if (!idle) {
+        return fail("ready queues not empty after every task finished");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,99 @@
+package vm_test
+
+import "testing"
+
+func TestNativeTaskFrameArenaReusesOneChunk(t *testing.T) {
+	runNativeRuntimeHarness(t, "frame_arena_harness", frameArenaHarness, "SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1")
+}
+
+// frameArenaHarness suspends like a generated state machine: each poll reads the frame it
+// resumed from, then builds the next payload and frame with rt_task_frame_alloc and
+// yields it. Frame sizes cycle up to a few KiB, so the arena must grow, rewind past the
+// frame it is replacing without corrupting it, and settle on one head chunk once the
+// largest frame has been seen.
+const frameArenaHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+#define CHECK(round) ((round) * 2654435761u + 1)
+
+enum { FN_FRAMES = 1, TASKS = 16, ROUNDS = 2000, CYCLE = 64, SETTLED = 2 * CYCLE };
+
+typedef struct {
+    uint64_t check;
+} frame_payload;
+
+typedef struct {
+    uint64_t round;
+    uint64_t sum;
+    frame_payload* payload;
+    rt_arena_chunk* head;
+    size_t extra;
+    uint8_t bytes[];
+} frame;
+
+static _Atomic int bad;
+
+static frame* frame_build(uint64_t round, uint64_t sum, rt_arena_chunk* head, int arena) {
+    size_t extra = (size_t)(round % CYCLE) * 40;
+    frame_payload* payload =
+        arena ? (frame_payload*)rt_task_frame_alloc(sizeof(frame_payload), _Alignof(frame_payload))
+              : (frame_payload*)rt_alloc(sizeof(frame_payload), _Alignof(frame_payload));
+    frame* st = arena ? (frame*)rt_task_frame_alloc(sizeof(frame) + extra, _Alignof(frame))
+                      : (frame*)rt_alloc(sizeof(frame) + extra, _Alignof(frame));
+    payload->check = CHECK(round);
+    st->round = round;
+    st->sum = sum;
+    st->payload = payload;
+    st->head = head;
+    st->extra = extra;
+    memset(st->bytes, (int)(round & 0xff), extra);
+    return st;
+}
+
+void __surge_poll_call(uint64_t id) {
+    (void)id;
+    frame* st = (frame*)__task_state();
+    if (st->payload->check != CHECK(st->round)) {
+        atomic_store(&bad, 1);
+    }
+    for (size_t i = 0; i < st->extra; i++) {
+        if (st->bytes[i] != (uint8_t)(st->round & 0xff)) {
+            atomic_store(&bad, 1);
+            break;
+        }
+    }
+    const rt_task* task = rt_current_task();
+    rt_arena_chunk* head = task->frame_arena.head;
+    if (st->round > SETTLED && head != st->head) {
+        atomic_store(&bad, 1);
+    }
+    if (st->round == ROUNDS) {
+        rt_async_return(st, st->sum);
+    }
+    uint64_t round = st->round + 1;
+    frame* next = frame_build(round, st->sum + round, head, 1);
+    rt_async_yield(next);
+}
+
+int main(void) {
+    void* tasks[TASKS];
+    for (int i = 0; i < TASKS; i++) {
+        // Like a generated constructor, the first frame comes from rt_alloc.
+        tasks[i] = __task_create(FN_FRAMES, frame_build(0, 0, NULL, 0));
+    }
+    for (int i = 0; i < TASKS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(tasks[i], &kind, &bits);
+        if (kind != 1 || bits != (uint64_t)ROUNDS * (ROUNDS + 1) / 2) {
+            return fail("task lost a round");
+        }
+    }
+    if (atomic_load(&bad)) {
+        return fail("frame corrupted by a rewind or arena kept growing");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,158 @@
+package vm_test
+
+import "testing"
+
+func TestNativeFsReadsSizedMappedAndChunked(t *testing.T) {
+	runNativeRuntimeHarness(t, "fs_read_harness", fsReadHarness, "SURGE_THREADS=1")
+}
+
+// fsReadHarness reads a temp file whole through rt_fs_read_file, maps it through
+// rt_fs_map_file, and streams it through rt_fs_read_into into one reused array. procfs
+// stands in for sources that report no size, which take the growing path.
+const fsReadHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef struct HarnessFsError {
+    void* message;
+    void* code;
+} HarnessFsError;
+
+typedef struct HarnessFile {
+    int fd;
+    char* path;
+    bool closed;
+} HarnessFile;
+
+typedef struct HarnessView {
+    void* owner;
+    const uint8_t* ptr;
+    void* len;
+} HarnessView;
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} harness_array;
+
+enum { FILE_BYTES = 300000, CHUNK = 4096 };
+
+static void* payload(void* res) {
+    if (res == NULL || *(const uint32_t*)res != 0) {
+        return NULL;
+    }
+    void* out = NULL;
+    memcpy(&out, (const uint8_t*)res + rt_tag_payload_offset(_Alignof(void*)), sizeof(out));
+    return out;
+}
+
+static uint64_t error_code(void* res) {
+    HarnessFsError* err = (HarnessFsError*)res;
+    uint64_t code = 0;
+    if (err == NULL || !rt_biguint_to_u64(err->code, &code)) {
+        return 0;
+    }
+    return code;
+}
+
+static void* str(const char* text) {
+    return rt_string_from_bytes((const uint8_t*)text, (uint64_t)strlen(text));
+}
+
+int main(void) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/surge_fs_read_%d", (int)getpid());
+    static uint8_t content[FILE_BYTES];
+    for (int i = 0; i < FILE_BYTES; i++) {
+        content[i] = (uint8_t)(i * 13 + i / 512);
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0 || write(fd, content, sizeof(content)) != (ssize_t)sizeof(content)) {
+        return fail("temp file setup failed");
+    }
+    close(fd);
+    void* path_str = str(path);
+
+    harness_array* whole = (harness_array*)payload(rt_fs_read_file(&path_str));
+    if (whole == NULL || whole->len != FILE_BYTES || whole->cap != FILE_BYTES ||
+        memcmp(whole->data, content, FILE_BYTES) != 0) {
+        unlink(path);
+        return fail("read_file did not return the file in one exactly sized block");
+    }
+
+    HarnessView* view = (HarnessView*)payload(rt_fs_map_file(&path_str));
+    uint64_t view_len = 0;
+    if (view == NULL || !rt_biguint_to_u64(view->len, &view_len) || view_len != FILE_BYTES ||
+        memcmp(view->ptr, content, FILE_BYTES) != 0) {
+        unlink(path);
+        return fail("map_file did not expose the file bytes");
+    }
+
+    HarnessFile* file = (HarnessFile*)payload(rt_fs_open(&path_str, 1));
+    if (file == NULL) {
+        unlink(path);
+        return fail("open failed");
+    }
+    harness_array* buf = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    buf->len = 0;
+    buf->cap = 0;
+    buf->data = NULL;
+    uint64_t total = 0;
+    uint64_t max_cap = 0;
+    for (;;) {
+        buf->len = 0;
+        void* res = rt_fs_read_into(file, &buf, CHUNK);
+        uint64_t n = 0;
+        if (!rt_biguint_to_u64(payload(res), &n)) {
+            unlink(path);
+            return fail("read_into failed");
+        }
+        if (n == 0) {
+            break;
+        }
+        if (buf->len != n || total + n > FILE_BYTES ||
+            memcmp(buf->data, content + total, (size_t)n) != 0) {
+            unlink(path);
+            return fail("read_into returned the wrong bytes");
+        }
+        total += n;
+        if (buf->cap > max_cap) {
+            max_cap = buf->cap;
+        }
+    }
+    if (total != FILE_BYTES || max_cap > 2 * CHUNK) {
+        unlink(path);
+        return fail("chunked reads did not reuse one small buffer");
+    }
+    void* closed = rt_fs_close(file);
+    unlink(path);
+    if (closed == NULL || *(const uint32_t*)closed != 0) {
+        return fail("close failed");
+    }
+    if (error_code(rt_fs_read_into(file, &buf, CHUNK)) != 9) {
+        return fail("read_into on a closed file did not report Io");
+    }
+
+    void* proc = str("/proc/self/status");
+    harness_array* status = (harness_array*)payload(rt_fs_read_file(&proc));
+    if (status == NULL || status->len == 0 || status->cap < status->len ||
+        memcmp(status->data, "Name:", 5) != 0) {
+        return fail("read_file of a sizeless source lost bytes");
+    }
+    HarnessView* status_view = (HarnessView*)payload(rt_fs_map_file(&proc));
+    uint64_t status_len = 0;
+    if (status_view == NULL || !rt_biguint_to_u64(status_view->len, &status_len) ||
+        status_len == 0 || memcmp(status_view->ptr, "Name:", 5) != 0) {
+        return fail("map_file did not fall back to reading a sizeless source");
+    }
+    void* dir = str("/tmp");
+    if (error_code(rt_fs_map_file(&dir)) != 7) {
+        return fail("map_file of a directory did not report IsDir");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,69 @@
+package vm_test
+
+import (
+	"os"
+	"os/exec"
+	"path/filepath"
+	"sort"
+	"testing"
+)
+
+// runNativeRuntimeHarness compiles a C harness against the native runtime sources
+// (excluding rt_entry.c) and runs it, failing the test on a non-zero exit. Harnesses
+// include runtime/native/testdata/harness.h for the entry-point stubs and shared helpers.
+func runNativeRuntimeHarness(t *testing.T, name, harness string, env ...string) {
+	t.Helper()
+	skipTimeoutTests(t)
+	clang, err := exec.LookPath("clang")
+	if err != nil {
+		t.Skip("clang not installed; skipping native runtime harness test")
+	}
+
+	root := repoRoot(t)
+	tmpDir := t.TempDir()
+	harnessPath := filepath.Join(tmpDir, name+".c")
+	binPath := filepath.Join(tmpDir, name)
+	if writeErr := os.WriteFile(harnessPath, []byte(harness), 0o600); writeErr != nil {
+		t.Fatalf("write harness: %v", writeErr)
+	}
+
+	sources, globErr := filepath.Glob(filepath.Join(root, "runtime", "native", "*.c"))
+	if globErr != nil {
+		t.Fatalf("glob runtime sources: %v", globErr)
+	}
+	sort.Strings(sources)
+
+	args := []string{
+		"-std=c11",
+		"-Wall",
+		"-Wextra",
+		"-Werror",
+		"-pthread",
+		"-I" + filepath.Join(root, "runtime", "native"),
+		"-I" + filepath.Join(root, "runtime", "native", "testdata"),
+		"-o",
+		binPath,
+		harnessPath,
+	}
+	for _, src := range sources {
+		if filepath.Base(src) == "rt_entry.c" {
+			continue
+		}
+		args = append(args, src)
+	}
+	args = append(args, "-lm")
+
+	buildCmd := exec.Command(clang, args...)
+	buildCmd.Dir = root
+	buildOut, buildErr, buildCode := runCommand(t, buildCmd, "")
+	if buildCode != 0 {
+		t.Fatalf("build harness failed (code=%d)\nstdout:\n%s\nstderr:\n%s", buildCode, buildOut, buildErr)
+	}
+
+	runCmd := exec.Command(binPath)
+	runCmd.Env = append(os.Environ(), env...)
+	stdout, stderr, exitCode := runCommand(t, runCmd, "")
+	if exitCode != 0 {
+		t.Fatalf("harness failed (code=%d)\nstdout:\n%s\nstderr:\n%s", exitCode, stdout, stderr)
+	}
+}
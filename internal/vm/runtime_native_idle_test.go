@@ -0,0 +1,200 @@
+package vm_test
+
+import "testing"
+
+func TestNativeIdleWorkersWakeForRequestReply(t *testing.T) {
+	policies := map[string][]string{
+		"park":   {"SURGE_IDLE_SPIN=0", "SURGE_IDLE_YIELD=0"},
+		"spin":   {"SURGE_IDLE_SPIN=100000", "SURGE_IDLE_YIELD=4"},
+		"pinned": {"SURGE_WORKER_AFFINITY=1", "SURGE_IO_CPU=0"},
+	}
+	for name, policy := range policies {
+		t.Run(name, func(t *testing.T) {
+			env := append([]string{"SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1"}, policy...)
+			runNativeRuntimeHarness(t, "idle_workers_harness", idleWorkersHarness, env...)
+		})
+	}
+}
+
+// idleWorkersHarness bounces values between pinger and ponger tasks over capacity-1
+// channels, so every message parks one side and wakes the other while most workers sit
+// idle. Each round trip hands exactly one task to the pool: a push that neither reaches a
+// spinning worker nor wakes a parked one hangs the harness.
+const idleWorkersHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_PING = 1, FN_PONG = 2 };
+enum { PAIRS = 3, ROUNDS = 20000 };
+
+typedef struct {
+    void* req;
+    void* rep;
+    uint64_t round;
+    uint64_t sum;
+    int sent;
+} harness_state;
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    uint64_t bits = 0;
+    switch (id) {
+        case FN_PING:
+            while (st->round < ROUNDS) {
+                if (!st->sent) {
+                    if (!rt_channel_send(st->req, st->round)) {
+                        rt_async_yield(st);
+                    }
+                    st->sent = 1;
+                }
+                uint8_t status = rt_channel_recv(st->rep, &bits);
+                if (status == 0) {
+                    rt_async_yield(st);
+                }
+                if (status == 2) {
+                    rt_async_return(st, 0);
+                }
+                st->sum += bits;
+                st->sent = 0;
+                st->round++;
+            }
+            rt_channel_close(st->req);
+            rt_async_return(st, st->sum);
+            break;
+        case FN_PONG:
+            for (;;) {
+                if (st->sent) {
+                    if (!rt_channel_send(st->rep, st->sum)) {
+                        rt_async_yield(st);
+                    }
+                    st->sent = 0;
+                }
+                uint8_t status = rt_channel_recv(st->req, &bits);
+                if (status == 0) {
+                    rt_async_yield(st);
+                }
+                if (status == 2) {
+                    rt_async_return(st, st->round);
+                }
+                st->sum = bits + 1;
+                st->sent = 1;
+                st->round++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+int main(void) {
+    static harness_state pings[PAIRS];
+    static harness_state pongs[PAIRS];
+    void* ping_tasks[PAIRS];
+    void* pong_tasks[PAIRS];
+    for (int i = 0; i < PAIRS; i++) {
+        void* req = rt_channel_new(1);
+        void* rep = rt_channel_new(1);
+        pings[i].req = req;
+        pings[i].rep = rep;
+        pongs[i].req = req;
+        pongs[i].rep = rep;
+        pong_tasks[i] = __task_create(FN_PONG, &pongs[i]);
+        ping_tasks[i] = __task_create(FN_PING, &pings[i]);
+    }
+    // Each reply is the request plus one, so a pinger's sum is sum(1..ROUNDS).
+    const uint64_t want = (uint64_t)ROUNDS * (ROUNDS + 1) / 2;
+    for (int i = 0; i < PAIRS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(ping_tasks[i], &kind, &bits);
+        if (kind != 1 || bits != want) {
+            return fail("pinger lost a reply");
+        }
+        rt_task_await(pong_tasks[i], &kind, &bits);
+        if (kind != 1 || bits != ROUNDS) {
+            return fail("ponger lost a request");
+        }
+    }
+    return 0;
+}
+`
+
+func TestNativeIdleWorkersWakeForBurst(t *testing.T) {
+	policies := map[string][]string{
+		"park": {"SURGE_IDLE_SPIN=0", "SURGE_IDLE_YIELD=0"},
+		"spin": {"SURGE_IDLE_SPIN=100000", "SURGE_IDLE_YIELD=64"},
+	}
+	for name, policy := range policies {
+		t.Run(name, func(t *testing.T) {
+			env := append([]string{"SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1"}, policy...)
+			runNativeRuntimeHarness(t, "idle_burst_harness", idleBurstHarness, env...)
+		})
+	}
+}
+
+// idleBurstHarness injects bursts of one task per worker into an idle pool. Every task
+// waits until the whole burst is running, so the burst completes only if it wakes all
+// the workers; one that stays parked leaves a task queued and times out the barrier.
+const idleBurstHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+#include <sched.h>
+#include <time.h>
+
+enum { FN_GATE = 1 };
+enum { WORKERS = 4, BURSTS = 200 };
+
+typedef struct {
+    int target;
+} harness_state;
+
+static _Atomic int arrived;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    if (id != FN_GATE) {
+        return;
+    }
+    atomic_fetch_add(&arrived, 1);
+    uint64_t deadline = now_ms() + 2000;
+    while (atomic_load(&arrived) < st->target) {
+        if (now_ms() > deadline) {
+            rt_async_return(st, 0);
+        }
+        (void)sched_yield();
+    }
+    rt_async_return(st, 1);
+}
+
+int main(void) {
+    static harness_state states[WORKERS];
+    void* tasks[WORKERS];
+    for (int burst = 0; burst < BURSTS; burst++) {
+        // Vary the gap so bursts land on spinning, yielding, and parked workers.
+        struct timespec gap = {0, (long)(burst % 4) * 500000L};
+        nanosleep(&gap, NULL);
+        for (int i = 0; i < WORKERS; i++) {
+            states[i].target = (burst + 1) * WORKERS;
+            tasks[i] = __task_create(FN_GATE, &states[i]);
+        }
+        for (int i = 0; i < WORKERS; i++) {
+            uint8_t kind = 0;
+            uint64_t bits = 0;
+            rt_task_await(tasks[i], &kind, &bits);
+            if (kind != 1 || bits != 1) {
+                return fail("a burst task waited for a worker that never woke");
+            }
+        }
+    }
+    return 0;
+}
+`
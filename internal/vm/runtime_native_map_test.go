@@ -0,0 +1,111 @@
+package vm_test
+
+import "testing"
+
+func TestNativeMapHashedIndexMatchesReference(t *testing.T) {
+	runNativeRuntimeHarness(t, "map_index_harness", mapIndexHarness)
+}
+
+const mapIndexHarness = `
+#include "rt.h"
+#include "harness.h"
+
+enum { KEY_SPACE = 4096, OPS = 200000 };
+
+static uint64_t ref_value[KEY_SPACE];
+static unsigned char ref_present[KEY_SPACE];
+
+static uint64_t next_rand(uint64_t* state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return *state >> 33;
+}
+
+static void* make_key_string(uint64_t i) {
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "route/%llu", (unsigned long long)i);
+    return rt_string_from_bytes((const uint8_t*)buf, (uint64_t)n);
+}
+
+int main(void) {
+    void* ints = rt_map_new(2);
+    uint64_t rng = 1;
+    uint64_t live = 0;
+    for (uint64_t op = 0; op < OPS; op++) {
+        uint64_t key = next_rand(&rng) % KEY_SPACE;
+        uint64_t prev = 0;
+        if (next_rand(&rng) % 3 != 0) {
+            bool had = rt_map_insert(ints, key, op, &prev);
+            if (had != (ref_present[key] != 0) || (had && prev != ref_value[key])) {
+                return fail("insert disagrees with reference");
+            }
+            if (!had) {
+                live++;
+            }
+            ref_present[key] = 1;
+            ref_value[key] = op;
+        } else {
+            bool had = rt_map_remove(ints, key, &prev);
+            if (had != (ref_present[key] != 0) || (had && prev != ref_value[key])) {
+                return fail("remove disagrees with reference");
+            }
+            if (had) {
+                live--;
+            }
+            ref_present[key] = 0;
+        }
+        if (rt_map_len(ints) != live) {
+            return fail("length disagrees with reference");
+        }
+    }
+    for (uint64_t key = 0; key < KEY_SPACE; key++) {
+        uint64_t ref = 0;
+        bool found = rt_map_get_ref(ints, key, &ref);
+        if (found != (ref_present[key] != 0)) {
+            return fail("lookup disagrees with reference");
+        }
+        if (found && *(const uint64_t*)(uintptr_t)ref != ref_value[key]) {
+            return fail("lookup returned wrong value");
+        }
+    }
+
+    void* strings = rt_map_new(1);
+    for (uint64_t i = 0; i < 1000; i++) {
+        rt_map_insert(strings, (uint64_t)(uintptr_t)make_key_string(i), i, NULL);
+    }
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t ref = 0;
+        if (!rt_map_get_ref(strings, (uint64_t)(uintptr_t)make_key_string(i), &ref) ||
+            *(const uint64_t*)(uintptr_t)ref != i) {
+            return fail("string key lookup failed");
+        }
+    }
+    typedef struct {
+        uint64_t len;
+        uint64_t cap;
+        void* data;
+    } keys_header;
+    const keys_header* keys = (const keys_header*)rt_map_keys(strings, 8, 8);
+    if (keys == NULL || keys->len != 1000) {
+        return fail("keys length mismatch");
+    }
+    for (uint64_t i = 0; i < keys->len; i++) {
+        void* want = make_key_string(i);
+        void* got = ((void**)keys->data)[i];
+        if (!rt_string_eq(&want, &got)) {
+            return fail("keys lost insertion order");
+        }
+    }
+
+    void* bigs = rt_map_new(4);
+    for (int64_t i = -500; i < 500; i++) {
+        rt_map_insert(bigs, (uint64_t)(uintptr_t)rt_bigint_from_i64(i * 1000003), (uint64_t)i, NULL);
+    }
+    for (int64_t i = -500; i < 500; i++) {
+        void* key = rt_bigint_from_i64(i * 1000003);
+        if (!rt_map_contains(bigs, (uint64_t)(uintptr_t)key)) {
+            return fail("bigint key lookup failed");
+        }
+    }
+    return 0;
+}
+`
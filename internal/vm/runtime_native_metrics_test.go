@@ -0,0 +1,137 @@
+package vm_test
+
+import (
+	"path/filepath"
+	"testing"
+)
+
+func TestNativeRuntimeMetricsSnapshotAndExport(t *testing.T) {
+	metricsPath := filepath.Join(t.TempDir(), "runtime.prom")
+	runNativeRuntimeHarness(t, "metrics_harness", metricsHarness,
+		"SURGE_THREADS=4",
+		"SURGE_BLOCKING_THREADS=1",
+		"SURGE_METRICS_FILE="+metricsPath,
+		"SURGE_METRICS_INTERVAL_MS=20")
+}
+
+// metricsHarness runs a batch of yielding tasks and checks that the always-on counters
+// saw them, then bumps one counter from several generations of short-lived threads: each
+// generation adopts the blocks the previous one left behind, and the total must still
+// come out exact. Both renderings must carry the stable names, and the exporter thread
+// must have written a Prometheus snapshot to SURGE_METRICS_FILE.
+const metricsHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+#include <time.h>
+
+enum { FN_WORK = 1, TASKS = 64, YIELDS = 8, THREADS = 8, GENERATIONS = 3, BUMPS = 100000 };
+
+typedef struct {
+    uint64_t left;
+} work_state;
+
+void __surge_poll_call(uint64_t id) {
+    (void)id;
+    work_state* st = (work_state*)__task_state();
+    if (st->left > 0) {
+        st->left--;
+        rt_async_yield(st);
+    }
+    rt_async_return(st, 0);
+}
+
+static void* bump_main(void* arg) {
+    (void)arg;
+    for (int i = 0; i < BUMPS; i++) {
+        rt_metric_inc(RT_METRIC_NET_POLL_DEDUP_CHECKS);
+    }
+    return NULL;
+}
+
+static int64_t value_of(const char* name) {
+    void* s = rt_string_from_bytes((const uint8_t*)name, (uint64_t)strlen(name));
+    return rt_metrics_value(&s);
+}
+
+static int text_contains(void* s, const char* needle) {
+    static char text[65536];
+    uint64_t len = rt_string_len_bytes(&s);
+    if (len >= sizeof(text)) {
+        return 0;
+    }
+    memcpy(text, rt_string_ptr(&s), (size_t)len);
+    text[len] = '\0';
+    return strstr(text, needle) != NULL;
+}
+
+static int exported_contains(const char* path, const char* needle) {
+    static char text[65536];
+    struct timespec pause = {0, 10000000};
+    for (int i = 0; i < 500; i++) {
+        FILE* f = fopen(path, "r");
+        if (f != NULL) {
+            size_t n = fread(text, 1, sizeof(text) - 1, f);
+            fclose(f);
+            text[n] = '\0';
+            if (strstr(text, needle) != NULL) {
+                return 1;
+            }
+        }
+        nanosleep(&pause, NULL);
+    }
+    return 0;
+}
+
+int main(void) {
+    static work_state states[TASKS];
+    void* tasks[TASKS];
+    for (int i = 0; i < TASKS; i++) {
+        states[i].left = YIELDS;
+        tasks[i] = __task_create(FN_WORK, &states[i]);
+    }
+    for (int i = 0; i < TASKS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(tasks[i], &kind, &bits);
+    }
+    if (value_of("tasks_created") < TASKS || value_of("task_polls") < TASKS * (YIELDS + 1)) {
+        return fail("scheduler counters missed tasks or polls");
+    }
+    if (value_of("worker_count") != 4 || value_of("heap_allocs") <= 0) {
+        return fail("gauges do not reflect the executor and heap");
+    }
+    if (value_of("no_such_metric") != -1) {
+        return fail("unknown metric name should read as -1");
+    }
+
+    for (int g = 0; g < GENERATIONS; g++) {
+        pthread_t threads[THREADS];
+        for (int i = 0; i < THREADS; i++) {
+            pthread_create(&threads[i], NULL, bump_main, NULL);
+        }
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    if (value_of("net_poll_dedup_checks") != (int64_t)GENERATIONS * THREADS * BUMPS) {
+        return fail("per-thread counter blocks lost counts across thread exits");
+    }
+
+    if (!text_contains(rt_metrics_json(), "{\"version\":1,\"counters\":{\"tasks_created\":") ||
+        !text_contains(rt_metrics_json(), "\"gauges\":{\"worker_count\":4,")) {
+        return fail("json snapshot layout changed");
+    }
+    if (!text_contains(rt_metrics_prometheus(),
+                       "# TYPE surge_task_polls_total counter\nsurge_task_polls_total ") ||
+        !text_contains(rt_metrics_prometheus(), "# TYPE surge_heap_live_bytes gauge\n")) {
+        return fail("prometheus snapshot layout changed");
+    }
+    if (!exported_contains(getenv("SURGE_METRICS_FILE"),
+                           "surge_net_poll_dedup_checks_total 2400000\n")) {
+        return fail("exporter did not write a current snapshot");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,151 @@
+package vm_test
+
+import "testing"
+
+func TestNativeNetReadIntoReusesBuffersAndCountResults(t *testing.T) {
+	runNativeRuntimeHarness(t, "net_buffers_harness", netBuffersHarness, "SURGE_THREADS=1")
+}
+
+// netBuffersHarness reads into a caller-owned byte array over a socketpair, checks that
+// the bytes land after the existing contents, and that a warmed-up echo loop through
+// rt_net_read_into and rt_net_write_bytes performs no heap allocations.
+const netBuffersHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct HarnessConn {
+    int fd;
+    bool closed;
+} HarnessConn;
+
+typedef struct HarnessNetError {
+    void* message;
+    void* code;
+} HarnessNetError;
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} harness_array;
+
+enum { ECHO_ROUNDS = 2000, BIG = 20000 };
+
+static HarnessConn conn;
+static HarnessConn* borrowed = &conn;
+
+static int success_count(void* res, uint64_t* out) {
+    // Success results carry tag 0 and the biguint count in the payload slot.
+    if (res == NULL || *(const uint32_t*)res != 0) {
+        return 0;
+    }
+    void* count = NULL;
+    memcpy(&count, (const uint8_t*)res + rt_tag_payload_offset(_Alignof(void*)), sizeof(count));
+    return rt_biguint_to_u64(count, out);
+}
+
+static harness_array* empty_array(void) {
+    harness_array* a = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    a->len = 0;
+    a->cap = 0;
+    a->data = NULL;
+    return a;
+}
+
+static int put(int fd, const char* text) {
+    size_t len = strlen(text);
+    return write(fd, text, len) == (ssize_t)len;
+}
+
+int main(void) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        return fail("socketpair failed");
+    }
+    (void)fcntl(pair[0], F_SETFL, O_NONBLOCK);
+    conn.fd = pair[0];
+    conn.closed = false;
+
+    harness_array* buf = empty_array();
+    uint64_t n = 0;
+    if (!put(pair[1], "hello") || !success_count(rt_net_read_into(&borrowed, &buf, 64), &n) ||
+        n != 5 || buf->len != 5 || buf->cap < 64 || memcmp(buf->data, "hello", 5) != 0) {
+        return fail("read_into did not fill an empty array");
+    }
+    if (!put(pair[1], "world") || !success_count(rt_net_read_into(&borrowed, &buf, 3), &n) ||
+        n != 3 || buf->len != 8 || memcmp(buf->data, "hellowor", 8) != 0) {
+        return fail("read_into did not append after the existing bytes");
+    }
+    if (!success_count(rt_net_read_into(&borrowed, &buf, 64), &n) || n != 2 || buf->len != 10) {
+        return fail("read_into lost the rest of a partial read");
+    }
+    HarnessNetError* err = (HarnessNetError*)rt_net_read_into(&borrowed, &buf, 64);
+    uint64_t code = 0;
+    if (err == NULL || !rt_biguint_to_u64(err->code, &code) || code != 1 || buf->len != 10) {
+        return fail("read_into on an idle conn did not report WouldBlock");
+    }
+
+    if (!put(pair[1], "abc")) {
+        return fail("write failed");
+    }
+    harness_array* bytes = NULL;
+    void* res = rt_net_read_bytes(&borrowed, 4096);
+    memcpy(&bytes, (const uint8_t*)res + rt_tag_payload_offset(_Alignof(void*)), sizeof(bytes));
+    if (bytes == NULL || bytes->len != 3 || bytes->cap != 3 || memcmp(bytes->data, "abc", 3) != 0) {
+        return fail("read_bytes did not size its result by the bytes read");
+    }
+
+    uint64_t allocs0 = 0, allocs1 = 0;
+    for (int round = 0; round < ECHO_ROUNDS; round++) {
+        if (round == ECHO_ROUNDS / 2) {
+            rt_heap_counts(&allocs0, NULL, NULL, NULL);
+        }
+        buf->len = 0;
+        char byte = (char)('a' + round % 26);
+        char back = 0;
+        if (write(pair[1], &byte, 1) != 1 ||
+            !success_count(rt_net_read_into(&borrowed, &buf, 4096), &n) || n != 1 ||
+            !success_count(rt_net_write_bytes(&borrowed, buf, 0, 1), &n) || n != 1 ||
+            read(pair[1], &back, 1) != 1 || back != byte) {
+            return fail("echo round trip failed");
+        }
+    }
+    rt_heap_counts(&allocs1, NULL, NULL, NULL);
+    if (allocs1 != allocs0) {
+        return fail("steady-state echo allocated");
+    }
+
+    harness_array* big = empty_array();
+    for (int i = 0; i < BIG; i++) {
+        uint8_t b = (uint8_t)i;
+        rt_array_append_raw_bytes(&big, &b, 1);
+    }
+    uint64_t sent = 0;
+    if (!success_count(rt_net_write_bytes(&borrowed, big, 0, BIG), &sent) || sent == 0) {
+        return fail("large write failed");
+    }
+    uint64_t seen = 0;
+    uint8_t sink[4096];
+    while (seen < sent) {
+        ssize_t got = read(pair[1], sink, sizeof(sink));
+        if (got <= 0) {
+            return fail("large write lost bytes");
+        }
+        seen += (uint64_t)got;
+    }
+    if (seen != sent) {
+        return fail("large write count disagrees with the peer");
+    }
+
+    close(pair[1]);
+    if (!success_count(rt_net_read_into(&borrowed, &buf, 16), &n) || n != 0) {
+        return fail("read_into at EOF did not report zero bytes");
+    }
+    close(pair[0]);
+    return 0;
+}
+`
@@ -0,0 +1,201 @@
+package vm_test
+
+import "testing"
+
+func TestNativeNetGatherWritesAndSendsFiles(t *testing.T) {
+	runNativeRuntimeHarness(t, "net_gather_harness", netGatherHarness, "SURGE_THREADS=1")
+}
+
+// netGatherHarness writes lists of byte arrays through rt_net_write_vectored, resuming
+// from partial counts, and streams a file range through rt_net_send_file while the peer
+// drains the socketpair, checking the bytes that arrive and the file position.
+const netGatherHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct HarnessConn {
+    int fd;
+    bool closed;
+} HarnessConn;
+
+typedef struct HarnessFile {
+    int fd;
+    char* path;
+    bool closed;
+} HarnessFile;
+
+typedef struct HarnessNetError {
+    void* message;
+    void* code;
+} HarnessNetError;
+
+typedef struct {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} harness_array;
+
+enum { MANY = 100, FILE_BYTES = 300000 };
+
+static HarnessConn conn;
+static HarnessConn* borrowed = &conn;
+static int peer = -1;
+
+static int success_count(void* res, uint64_t* out) {
+    if (res == NULL || *(const uint32_t*)res != 0) {
+        return 0;
+    }
+    void* count = NULL;
+    memcpy(&count, (const uint8_t*)res + rt_tag_payload_offset(_Alignof(void*)), sizeof(count));
+    return rt_biguint_to_u64(count, out);
+}
+
+static uint64_t error_code(void* res) {
+    HarnessNetError* err = (HarnessNetError*)res;
+    uint64_t code = 0;
+    if (err == NULL || !rt_biguint_to_u64(err->code, &code)) {
+        return 0;
+    }
+    return code;
+}
+
+static harness_array* bytes_of(const char* text) {
+    harness_array* a = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    a->len = 0;
+    a->cap = 0;
+    a->data = NULL;
+    rt_array_append_raw_bytes(&a, (const uint8_t*)text, (uint64_t)strlen(text));
+    return a;
+}
+
+static harness_array* list_of(harness_array** parts, int count) {
+    harness_array* list = (harness_array*)rt_alloc(sizeof(harness_array), _Alignof(harness_array));
+    list->len = 0;
+    list->cap = 0;
+    list->data = NULL;
+    rt_array_append_raw_bytes(&list, (const uint8_t*)parts, (uint64_t)count * sizeof(void*));
+    list->len = (uint64_t)count;
+    return list;
+}
+
+static int drain(uint8_t* out, uint64_t want) {
+    uint64_t got = 0;
+    while (got < want) {
+        ssize_t n = read(peer, out + got, (size_t)(want - got));
+        if (n <= 0) {
+            return 0;
+        }
+        got += (uint64_t)n;
+    }
+    return 1;
+}
+
+int main(void) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        return fail("socketpair failed");
+    }
+    (void)fcntl(pair[0], F_SETFL, O_NONBLOCK);
+    conn.fd = pair[0];
+    conn.closed = false;
+    peer = pair[1];
+
+    harness_array* parts[] = {bytes_of("HTTP/1.1 200 OK\r\n"), bytes_of(""),
+                              bytes_of("Content-Length: 5\r\n\r\n"), bytes_of("hello")};
+    harness_array* list = list_of(parts, 4);
+    const char* want = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+    uint64_t n = 0;
+    uint8_t got[256];
+    if (!success_count(rt_net_write_vectored(&borrowed, list, 0), &n) || n != strlen(want) ||
+        !drain(got, n) || memcmp(got, want, (size_t)n) != 0) {
+        return fail("gather write sent the wrong bytes");
+    }
+    if (!success_count(rt_net_write_vectored(&borrowed, list, 20), &n) ||
+        n != strlen(want) - 20 || !drain(got, n) || memcmp(got, want + 20, (size_t)n) != 0) {
+        return fail("gather write did not resume from its offset");
+    }
+    if (!success_count(rt_net_write_vectored(&borrowed, list, strlen(want)), &n) || n != 0) {
+        return fail("gather write past the last byte did not report zero");
+    }
+    if (error_code(rt_net_write_vectored(&borrowed, list, strlen(want) + 1)) != 8) {
+        return fail("gather write beyond the parts did not report Io");
+    }
+
+    harness_array* many[MANY];
+    char expect[MANY];
+    for (int i = 0; i < MANY; i++) {
+        char text[2] = {(char)('A' + i % 26), 0};
+        many[i] = bytes_of(text);
+        expect[i] = text[0];
+    }
+    harness_array* long_list = list_of(many, MANY);
+    uint64_t sent = 0;
+    while (sent < MANY) {
+        if (!success_count(rt_net_write_vectored(&borrowed, long_list, sent), &n) || n == 0) {
+            return fail("gather write over many parts stalled");
+        }
+        sent += n;
+    }
+    if (sent != MANY || !drain(got, MANY) || memcmp(got, expect, MANY) != 0) {
+        return fail("gather write over many parts lost bytes");
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/surge_send_file_%d", (int)getpid());
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return fail("temp file open failed");
+    }
+    unlink(path);
+    static uint8_t content[FILE_BYTES];
+    for (int i = 0; i < FILE_BYTES; i++) {
+        content[i] = (uint8_t)(i * 7 + i / 256);
+    }
+    if (write(fd, content, sizeof(content)) != (ssize_t)sizeof(content) ||
+        lseek(fd, 0, SEEK_SET) != 0) {
+        return fail("temp file setup failed");
+    }
+    HarnessFile file = {fd, path, false};
+    static uint8_t received[FILE_BYTES];
+    uint64_t start = 1000;
+    uint64_t length = FILE_BYTES - 2000;
+    uint64_t done = 0;
+    uint64_t seen = 0;
+    while (done < length) {
+        void* res = rt_net_send_file(&borrowed, &file, start + done, length - done);
+        if (success_count(res, &n)) {
+            if (n == 0) {
+                return fail("send_file stopped before the range ended");
+            }
+            done += n;
+        } else if (error_code(res) != 1) {
+            return fail("send_file failed");
+        }
+        ssize_t r = read(peer, received + seen, sizeof(received) - seen);
+        if (r > 0) {
+            seen += (uint64_t)r;
+        }
+    }
+    if (!drain(received + seen, length - seen) || memcmp(received, content + start, length) != 0) {
+        return fail("send_file sent the wrong bytes");
+    }
+    if (lseek(fd, 0, SEEK_CUR) != 0) {
+        return fail("send_file moved the file position");
+    }
+    if (!success_count(rt_net_send_file(&borrowed, &file, FILE_BYTES, 10), &n) || n != 0) {
+        return fail("send_file at end of file did not report zero");
+    }
+    file.closed = true;
+    if (error_code(rt_net_send_file(&borrowed, &file, 0, 10)) != 8) {
+        return fail("send_file from a closed file did not report Io");
+    }
+    close(fd);
+    close(pair[0]);
+    close(pair[1]);
+    return 0;
+}
+`
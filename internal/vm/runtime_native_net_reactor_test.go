@@ -0,0 +1,588 @@
+package vm_test
+
+import "testing"
+
+func TestNativeNetReactorWakesOnlyReadyWaiters(t *testing.T) {
+	for _, backend := range []string{"reactor", "poll", "uring"} {
+		t.Run(backend, func(t *testing.T) {
+			env := []string{"SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1"}
+			if backend != "reactor" {
+				env = append(env, "SURGE_NET_POLL="+backend)
+			}
+			runNativeRuntimeHarness(t, "net_reactor_harness", netReactorHarness, env...)
+		})
+	}
+}
+
+func TestNativeNetUringCompletesSocketIO(t *testing.T) {
+	runNativeRuntimeHarness(t, "net_uring_io_harness", netUringIOHarness,
+		"SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1", "SURGE_NET_POLL=uring")
+}
+
+func TestNativeNetUringDropsCompletionsOfClosedFds(t *testing.T) {
+	runNativeRuntimeHarness(t, "net_uring_gen_harness", netUringGenerationHarness,
+		"SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1", "SURGE_NET_POLL=uring")
+}
+
+const netReactorHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct HarnessConn {
+    int fd;
+    bool closed;
+} HarnessConn;
+
+bool rt_net_wait_readable(const void* conn);
+void* rt_net_close_conn(void* conn);
+
+enum { CONNS = 200, STRIDE = 50, ROUNDS = 3 };
+
+static int pairs[CONNS][2];
+static HarnessConn conns[CONNS];
+static rt_task* tasks[CONNS];
+
+// Parks task on conn readability the way a lowered rt_net_wait_readable poll does.
+static int park_readable(rt_executor* ex, rt_task* task, HarnessConn* conn) {
+    HarnessConn* borrowed = conn;
+    rt_set_current_task(task);
+    task_status_store(task, TASK_RUNNING);
+    (void)task_wake_token_exchange(task, 0);
+    if (rt_net_wait_readable(&borrowed)) {
+        rt_set_current_task(NULL);
+        return 0;
+    }
+    rt_lock(ex);
+    park_current(ex, pending_key);
+    pending_key = waker_none();
+    rt_unlock(ex);
+    rt_set_current_task(NULL);
+    return task_status_load(task) == TASK_WAITING;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    if (ex == NULL) {
+        return fail("missing executor");
+    }
+    rt_lock(ex);
+    for (int i = 0; i < CONNS; i++) {
+        tasks[i] = harness_task_new(ex, TASK_RUNNING);
+        if (tasks[i] == NULL) {
+            rt_unlock(ex);
+            return fail("task allocation failed");
+        }
+    }
+    rt_unlock(ex);
+    for (int i = 0; i < CONNS; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pairs[i]) != 0) {
+            return fail("socketpair failed");
+        }
+        (void)fcntl(pairs[i][0], F_SETFL, O_NONBLOCK);
+        conns[i].fd = pairs[i][0];
+        conns[i].closed = false;
+    }
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < CONNS; i++) {
+            if (!park_readable(ex, tasks[i], &conns[i])) {
+                return fail("idle conn did not park");
+            }
+        }
+        int expected = 0;
+        for (int i = round; i < CONNS; i += STRIDE) {
+            char byte = 'x';
+            if (write(pairs[i][1], &byte, 1) != 1) {
+                return fail("write failed");
+            }
+            expected++;
+        }
+        rt_lock(ex);
+        int ready = 0;
+        for (int attempt = 0; attempt < 16 && ready < expected; attempt++) {
+            (void)poll_net_waiters(ex, attempt == 0 ? 1000 : 10);
+            ready = 0;
+            for (int i = 0; i < CONNS; i++) {
+                if (task_status_load(tasks[i]) == TASK_READY) {
+                    ready++;
+                }
+            }
+        }
+        for (int i = 0; i < CONNS; i++) {
+            if (task_status_load(tasks[i]) == TASK_READY) {
+                if ((i - round) % STRIDE != 0) {
+                    rt_unlock(ex);
+                    return fail("idle conn was woken");
+                }
+                char byte = 0;
+                if (read(pairs[i][0], &byte, 1) != 1) {
+                    rt_unlock(ex);
+                    return fail("read failed");
+                }
+            } else {
+                remove_task_waiters(ex, tasks[i]);
+            }
+        }
+        uint64_t id = 0;
+        while (ready_pop(ex, &id)) {
+        }
+        rt_unlock(ex);
+        if (ready != expected) {
+            return fail("ready conns were not all woken");
+        }
+    }
+
+    for (int i = 0; i < CONNS; i++) {
+        (void)rt_net_close_conn(&conns[i]);
+        // The registration must not keep the socket open: the peer has to see EOF.
+        struct pollfd peer = {.fd = pairs[i][1], .events = POLLIN};
+        char byte = 0;
+        if (poll(&peer, 1, 1000) != 1 || read(pairs[i][1], &byte, 1) != 0) {
+            return fail("closed conn did not release its socket");
+        }
+        close(pairs[i][1]);
+    }
+    return 0;
+}
+`
+
+// netUringGenerationHarness leaves a readiness completion queued for a conn, closes it, hands
+// the fd number to a new socket and checks that the stale completion does not wake the task
+// parked on the new one.
+const netUringGenerationHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct HarnessConn {
+    int fd;
+    bool closed;
+} HarnessConn;
+
+bool rt_net_wait_readable(const void* conn);
+void* rt_net_close_conn(void* conn);
+
+static int park_readable(rt_executor* ex, rt_task* task, HarnessConn* conn) {
+    HarnessConn* borrowed = conn;
+    rt_set_current_task(task);
+    task_status_store(task, TASK_RUNNING);
+    (void)task_wake_token_exchange(task, 0);
+    if (rt_net_wait_readable(&borrowed)) {
+        rt_set_current_task(NULL);
+        return 0;
+    }
+    rt_lock(ex);
+    park_current(ex, pending_key);
+    pending_key = waker_none();
+    rt_unlock(ex);
+    rt_set_current_task(NULL);
+    return task_status_load(task) == TASK_WAITING;
+}
+
+static int open_conn(HarnessConn* conn, int* peer) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return 0;
+    }
+    (void)fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    conn->fd = fds[0];
+    conn->closed = false;
+    *peer = fds[1];
+    return 1;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    if (ex == NULL) {
+        return fail("missing executor");
+    }
+    rt_lock(ex);
+    rt_task* old_task = harness_task_new(ex, TASK_RUNNING);
+    rt_task* new_task = harness_task_new(ex, TASK_RUNNING);
+    rt_unlock(ex);
+    if (old_task == NULL || new_task == NULL) {
+        return fail("task allocation failed");
+    }
+
+    HarnessConn old_conn;
+    int old_peer = -1;
+    if (!open_conn(&old_conn, &old_peer) || !park_readable(ex, old_task, &old_conn)) {
+        return fail("first conn did not park");
+    }
+    // Submit the poll, then make the conn readable so a completion is queued for it.
+    rt_lock(ex);
+    (void)poll_net_waiters(ex, 0);
+    rt_unlock(ex);
+    char byte = 'x';
+    if (write(old_peer, &byte, 1) != 1) {
+        return fail("write failed");
+    }
+    int reused = old_conn.fd;
+    (void)rt_net_close_conn(&old_conn);
+    close(old_peer);
+
+    HarnessConn new_conn;
+    int new_peer = -1;
+    if (!open_conn(&new_conn, &new_peer) || new_conn.fd != reused) {
+        return fail("the closed fd number was not reused");
+    }
+    if (!park_readable(ex, new_task, &new_conn)) {
+        return fail("second conn did not park");
+    }
+    rt_lock(ex);
+    for (int attempt = 0; attempt < 3; attempt++) {
+        (void)poll_net_waiters(ex, 20);
+    }
+    int stale_wake = task_status_load(new_task) != TASK_WAITING;
+    rt_unlock(ex);
+    if (stale_wake) {
+        return fail("a completion for the closed fd woke the new owner");
+    }
+
+    if (write(new_peer, &byte, 1) != 1) {
+        return fail("write failed");
+    }
+    rt_lock(ex);
+    for (int attempt = 0; attempt < 16 && task_status_load(new_task) != TASK_READY; attempt++) {
+        (void)poll_net_waiters(ex, 100);
+    }
+    int woke = task_status_load(new_task) == TASK_READY;
+    uint64_t id = 0;
+    while (ready_pop(ex, &id)) {
+    }
+    rt_unlock(ex);
+    if (!woke) {
+        return fail("the new owner was not woken by its own readiness");
+    }
+    (void)rt_net_close_conn(&new_conn);
+    close(new_peer);
+    return 0;
+}
+`
+
+// netUringIOHarness drives accept, read and write through the io_uring completion path: the
+// ring takes the connection and the bytes before the task runs again, a write that finds the
+// socket full parks until the ring has sent it and only then reports its count, and closing a
+// conn cancels a pending send and releases a pending receive.
+const netUringIOHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include "rt_net_uring_linux.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct HarnessConn {
+    int fd;
+    bool closed;
+} HarnessConn;
+
+typedef struct HarnessNetError {
+    void* message;
+    void* code;
+} HarnessNetError;
+
+void* rt_net_accept(const void* listener);
+void* rt_net_read(const void* conn, uint8_t* buf, uint64_t cap);
+void* rt_net_write(const void* conn, const uint8_t* buf, uint64_t len);
+void* rt_net_close_conn(void* conn);
+bool rt_net_wait_accept(const void* listener);
+bool rt_net_wait_readable(const void* conn);
+bool rt_net_wait_writable(const void* conn);
+
+enum { CHUNK = 65536, SMALL_BUF = 16384 };
+
+static uint8_t chunk[CHUNK];
+
+static int success_ptr(void* res, void** out) {
+    if (res == NULL || *(const uint32_t*)res != 0) {
+        return 0;
+    }
+    memcpy(out, (const uint8_t*)res + rt_tag_payload_offset(_Alignof(void*)), sizeof(*out));
+    return 1;
+}
+
+static int success_count(void* res, uint64_t* out) {
+    void* count = NULL;
+    return success_ptr(res, &count) && rt_biguint_to_u64(count, out);
+}
+
+static int would_block(void* res) {
+    HarnessNetError* err = (HarnessNetError*)res;
+    uint64_t code = 0;
+    return err != NULL && rt_biguint_to_u64(err->code, &code) && code == 1;
+}
+
+static int park(rt_executor* ex, rt_task* task, bool (*wait)(const void*), void* handle) {
+    void* borrowed = handle;
+    rt_set_current_task(task);
+    task_status_store(task, TASK_RUNNING);
+    (void)task_wake_token_exchange(task, 0);
+    if (wait(&borrowed)) {
+        rt_set_current_task(NULL);
+        return 0;
+    }
+    rt_lock(ex);
+    park_current(ex, pending_key);
+    pending_key = waker_none();
+    rt_unlock(ex);
+    rt_set_current_task(NULL);
+    return task_status_load(task) == TASK_WAITING;
+}
+
+// Runs the reactor until task is woken, reading whatever reached drain_fd (when >= 0) so
+// pending sends can make progress. Returns the bytes drained, or -1 on timeout.
+static long run_until_woken(rt_executor* ex, rt_task* task, int drain_fd, long* checked) {
+    long drained = 0;
+    rt_lock(ex);
+    for (int attempt = 0; attempt < 500 && task_status_load(task) != TASK_READY; attempt++) {
+        (void)poll_net_waiters(ex, 10);
+        uint8_t buf[4096];
+        ssize_t n = 0;
+        while (drain_fd >= 0 && (n = read(drain_fd, buf, sizeof(buf))) > 0) {
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] != (uint8_t)((*checked + i) % 251)) {
+                    rt_unlock(ex);
+                    return -1;
+                }
+            }
+            *checked += n;
+            drained += n;
+        }
+    }
+    int woke = task_status_load(task) == TASK_READY;
+    uint64_t id = 0;
+    while (ready_pop(ex, &id)) {
+    }
+    rt_unlock(ex);
+    return woke ? drained : -1;
+}
+
+// Writes the byte pattern until a write would block, which leaves the ring sending the last
+// chunk. Returns the bytes written before that.
+static long fill(HarnessConn* conn, long sent) {
+    HarnessConn* borrowed = conn;
+    long start = sent;
+    for (int i = 0; i < 100000; i++) {
+        for (int j = 0; j < CHUNK; j++) {
+            chunk[j] = (uint8_t)((sent + j) % 251);
+        }
+        void* res = rt_net_write(&borrowed, chunk, CHUNK);
+        uint64_t n = 0;
+        if (success_count(res, &n)) {
+            sent += (long)n;
+            continue;
+        }
+        return would_block(res) ? sent - start : -1;
+    }
+    return -1;
+}
+
+// Reads the pattern from fd until end of stream and returns the byte count, or -1.
+static long read_to_eof(int fd, long checked) {
+    long total = 0;
+    uint8_t buf[4096];
+    for (;;) {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        if (poll(&pfd, 1, 5000) != 1) {
+            return -1;
+        }
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n == 0) {
+            return total;
+        }
+        if (n < 0) {
+            return -1;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] != (uint8_t)((checked + total + i) % 251)) {
+                return -1;
+            }
+        }
+        total += n;
+    }
+}
+
+static int listen_local(struct sockaddr_in* addr) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(*addr);
+    if (fd < 0 || bind(fd, (struct sockaddr*)addr, len) != 0 || listen(fd, 16) != 0 ||
+        getsockname(fd, (struct sockaddr*)addr, &len) != 0) {
+        return -1;
+    }
+    (void)fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+static int dial(const struct sockaddr_in* addr) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int size = SMALL_BUF;
+    (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    if (fd < 0 || connect(fd, (const struct sockaddr*)addr, sizeof(*addr)) != 0) {
+        return -1;
+    }
+    return fd;
+}
+
+static HarnessConn* accept_conn(rt_executor* ex, rt_task* task, HarnessConn* listener) {
+    HarnessConn* borrowed = listener;
+    HarnessConn* conn = NULL;
+    long checked = 0;
+    for (int i = 0; i < 10; i++) {
+        void* res = rt_net_accept(&borrowed);
+        if (success_ptr(res, (void**)&conn)) {
+            int size = SMALL_BUF;
+            (void)setsockopt(conn->fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+            return conn;
+        }
+        if (!would_block(res) || (park(ex, task, rt_net_wait_accept, listener) &&
+                                  run_until_woken(ex, task, -1, &checked) < 0)) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    if (ex == NULL) {
+        return fail("missing executor");
+    }
+    rt_lock(ex);
+    rt_task* task = harness_task_new(ex, TASK_RUNNING);
+    rt_unlock(ex);
+    struct sockaddr_in addr;
+    int lfd = listen_local(&addr);
+    if (task == NULL || lfd < 0) {
+        return fail("setup failed");
+    }
+    HarnessConn listener = {.fd = lfd, .closed = false};
+    HarnessConn* borrowed_listener = &listener;
+    long checked = 0;
+
+    // Accept: the would-block call leaves an accept in the ring, which takes the connection.
+    if (!would_block(rt_net_accept(&borrowed_listener))) {
+        return fail("accept did not block");
+    }
+    if (!net_uring_io_enabled()) {
+        // Kernels before 5.19 or without io_uring keep the readiness reactors.
+        close(lfd);
+        return 0;
+    }
+    if (!park(ex, task, rt_net_wait_accept, &listener)) {
+        return fail("accept did not park");
+    }
+    int peer = dial(&addr);
+    if (peer < 0 || run_until_woken(ex, task, -1, &checked) < 0) {
+        return fail("accept completion did not wake the task");
+    }
+    if (accept(lfd, NULL, NULL) >= 0 || errno != EAGAIN) {
+        return fail("the connection was not accepted by the ring");
+    }
+    HarnessConn* conn = accept_conn(ex, task, &listener);
+    if (conn == NULL || (fcntl(conn->fd, F_GETFL) & O_NONBLOCK) == 0) {
+        return fail("accept did not hand out the ring's nonblocking connection");
+    }
+    HarnessConn* borrowed = conn;
+
+    // Read: the receive completes into a ring buffer and is copied out over two reads.
+    uint8_t buf[64];
+    if (!would_block(rt_net_read(&borrowed, buf, sizeof(buf))) ||
+        !park(ex, task, rt_net_wait_readable, conn)) {
+        return fail("read did not park");
+    }
+    if (write(peer, "hello", 5) != 5 || run_until_woken(ex, task, -1, &checked) < 0) {
+        return fail("receive completion did not wake the task");
+    }
+    (void)fcntl(conn->fd, F_SETFL, O_NONBLOCK);
+    if (recv(conn->fd, buf, sizeof(buf), MSG_PEEK) >= 0 || errno != EAGAIN) {
+        return fail("the bytes were not received by the ring");
+    }
+    uint64_t n = 0;
+    if (!success_count(rt_net_read(&borrowed, buf, 3), &n) || n != 3 ||
+        memcmp(buf, "hel", 3) != 0 ||
+        !success_count(rt_net_read(&borrowed, buf, sizeof(buf)), &n) || n != 2 ||
+        memcmp(buf, "lo", 2) != 0) {
+        return fail("received bytes were not handed out in order");
+    }
+
+    // Write: once the socket is full the ring sends the next write, and the writer learns how
+    // much of it went out only after the send completes.
+    (void)fcntl(peer, F_SETFL, O_NONBLOCK);
+    long sent = fill(conn, 0);
+    if (sent <= 0 || !park(ex, task, rt_net_wait_writable, conn)) {
+        return fail("write did not park on its send");
+    }
+    if (run_until_woken(ex, task, peer, &checked) < 0) {
+        return fail("send completion did not wake the writer");
+    }
+    if (!success_count(rt_net_write(&borrowed, chunk, CHUNK), &n) || n == 0 || n > CHUNK) {
+        return fail("the retried write did not report its completed send");
+    }
+    sent += (long)n;
+
+    // Close with a send in flight: the send is cancelled, so the peer gets at most that chunk
+    // past the bytes already reported, then end of stream.
+    long more = fill(conn, sent);
+    if (more < 0) {
+        return fail("write after the completed send failed");
+    }
+    sent += more;
+    rt_lock(ex);
+    (void)poll_net_waiters(ex, 0);
+    rt_unlock(ex);
+    (void)rt_net_close_conn(conn);
+    rt_lock(ex);
+    (void)poll_net_waiters(ex, 10);
+    rt_unlock(ex);
+    (void)fcntl(peer, F_SETFL, 0);
+    long rest = read_to_eof(peer, checked);
+    if (rest < 0 || checked + rest < sent || checked + rest > sent + CHUNK) {
+        return fail("closing the conn did not end its pending send");
+    }
+    close(peer);
+
+    // Close with a receive in flight: the ring must let go of the socket.
+    peer = dial(&addr);
+    conn = peer >= 0 ? accept_conn(ex, task, &listener) : NULL;
+    if (conn == NULL) {
+        return fail("second accept failed");
+    }
+    borrowed = conn;
+    if (!would_block(rt_net_read(&borrowed, buf, sizeof(buf))) ||
+        !park(ex, task, rt_net_wait_readable, conn)) {
+        return fail("second read did not park");
+    }
+    rt_lock(ex);
+    (void)poll_net_waiters(ex, 0);
+    rt_unlock(ex);
+    (void)rt_net_close_conn(conn);
+    if (run_until_woken(ex, task, -1, &checked) < 0) {
+        return fail("closing the conn did not wake its reader");
+    }
+    struct pollfd pfd = {.fd = peer, .events = POLLIN};
+    if (poll(&pfd, 1, 1000) != 1 || read(peer, buf, 1) != 0) {
+        return fail("a pending receive kept the closed socket open");
+    }
+    close(peer);
+    close(lfd);
+    return 0;
+}
+`
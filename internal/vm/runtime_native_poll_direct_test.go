@@ -0,0 +1,89 @@
+package vm_test
+
+import "testing"
+
+func TestNativeDirectPollTasksReturnWithoutLongjmp(t *testing.T) {
+	runNativeRuntimeHarness(t, "poll_direct_harness", pollDirectHarness, "SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1")
+}
+
+// pollDirectHarness registers a direct-return poll entry for one poll id and leaves the
+// other to the setjmp dispatcher, then runs both kinds of task side by side. Direct
+// entries return after each terminator the way generated code does; the dispatcher must
+// never see their id, and both kinds must yield repeatedly and finish with their result.
+const pollDirectHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_LEGACY = 1, FN_DIRECT = 2, TASKS = 64, ROUNDS = 200 };
+
+typedef struct {
+    void* ch;
+    uint64_t round;
+    uint64_t sum;
+} harness_state;
+
+static _Atomic int bad;
+
+static void step(harness_state* st, int direct) {
+    while (st->round < ROUNDS) {
+        uint64_t bits = 0;
+        st->round++;
+        if (st->round % 2 == 0) {
+            rt_async_yield(st);
+            if (direct) {
+                return;
+            }
+            continue;
+        }
+        if (rt_channel_try_recv(st->ch, &bits)) {
+            st->sum += bits;
+        }
+    }
+    rt_async_return(st, st->sum + 1);
+    if (!direct) {
+        atomic_store(&bad, 1);
+    }
+}
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    if (id != FN_LEGACY) {
+        atomic_store(&bad, 1);
+    }
+    step(st, 0);
+}
+
+static void direct_poll(void) {
+    harness_state* st = (harness_state*)__task_state();
+    step(st, 1);
+}
+
+static void (*const poll_fns[])(void) = {NULL, NULL, direct_poll};
+
+int main(void) {
+    rt_async_register_poll_fns(poll_fns, sizeof(poll_fns) / sizeof(poll_fns[0]));
+    static harness_state states[TASKS];
+    void* tasks[TASKS];
+    void* ch = rt_channel_new(16);
+    for (int i = 0; i < TASKS; i++) {
+        states[i].ch = ch;
+        tasks[i] = __task_create(i % 2 ? FN_DIRECT : FN_LEGACY, &states[i]);
+    }
+    for (uint64_t v = 1; v <= 100; v++) {
+        (void)rt_channel_try_send(ch, v);
+    }
+    for (int i = 0; i < TASKS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(tasks[i], &kind, &bits);
+        if (kind != 1 || bits != states[i].sum + 1 || states[i].round != ROUNDS) {
+            return fail("task did not run to its return");
+        }
+    }
+    if (atomic_load(&bad)) {
+        return fail("a terminator fell through or a direct task reached the dispatcher");
+    }
+    return 0;
+}
+`
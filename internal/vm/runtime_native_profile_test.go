@@ -0,0 +1,132 @@
+package vm_test
+
+import (
+	"path/filepath"
+	"testing"
+)
+
+func TestNativeRuntimeProfileAttributesPollsToFunctions(t *testing.T) {
+	foldedPath := filepath.Join(t.TempDir(), "profile.folded")
+	runNativeRuntimeHarness(t, "profile_harness", profileHarness,
+		"SURGE_THREADS=2",
+		"SURGE_BLOCKING_THREADS=1",
+		"SURGE_PROFILE_OUT="+foldedPath,
+		"SURGE_PROFILE_HZ=1000")
+}
+
+// profileHarness registers names for two poll functions: hot_loop burns CPU on every poll
+// and yields, napper awaits a sleep and so parks on its join key. The PROFILE report must
+// count every hot_loop poll under its name, rank it first by self time, and record napper's
+// park reason and the [sleep] task; the folded file written for SURGE_PROFILE_OUT must
+// carry SIGPROF samples for hot_loop.
+const profileHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+#include <unistd.h>
+
+enum { FN_HOT = 1, FN_NAPPER = 2, HOT_TASKS = 4, HOT_YIELDS = 20, NAPPERS = 4 };
+enum { BURN_NS = 2000000 };
+
+static const char* const poll_names[] = {NULL, "hot_loop", "napper"};
+
+typedef struct {
+    uint64_t left;
+    void* sleep;
+} work_state;
+
+void __surge_poll_call(uint64_t id) {
+    work_state* st = (work_state*)__task_state();
+    if (id == FN_HOT) {
+        int64_t start = rt_monotonic_now();
+        while (rt_monotonic_now() - start < BURN_NS) {
+        }
+        if (st->left > 0) {
+            st->left--;
+            rt_async_yield(st);
+        }
+        rt_async_return(st, 0);
+        return;
+    }
+    if (st->sleep == NULL) {
+        st->sleep = rt_sleep(1);
+    }
+    uint64_t bits = 0;
+    if (rt_task_poll(st->sleep, &bits) == 0) {
+        rt_async_yield(st);
+    }
+    rt_async_return(st, 0);
+}
+
+static char report[65536];
+static char folded[4096];
+
+static size_t read_all(FILE* f, char* buf, size_t cap) {
+    rewind(f);
+    size_t n = fread(buf, 1, cap - 1, f);
+    buf[n] = '\0';
+    return n;
+}
+
+int main(void) {
+    rt_async_register_poll_names(poll_names, 3);
+    static work_state hot[HOT_TASKS];
+    static work_state nappers[NAPPERS];
+    void* tasks[HOT_TASKS + NAPPERS];
+    for (int i = 0; i < HOT_TASKS; i++) {
+        hot[i].left = HOT_YIELDS;
+        tasks[i] = __task_create(FN_HOT, &hot[i]);
+    }
+    for (int i = 0; i < NAPPERS; i++) {
+        tasks[HOT_TASKS + i] = __task_create(FN_NAPPER, &nappers[i]);
+    }
+    for (int i = 0; i < HOT_TASKS + NAPPERS; i++) {
+        uint8_t kind = 0;
+        uint64_t bits = 0;
+        rt_task_await(tasks[i], &kind, &bits);
+    }
+
+    FILE* captured = tmpfile();
+    if (captured == NULL) {
+        return fail("tmpfile failed");
+    }
+    int saved_stderr = dup(STDERR_FILENO);
+    dup2(fileno(captured), STDERR_FILENO);
+    rt_profile_dump_exit();
+    dup2(saved_stderr, STDERR_FILENO);
+    read_all(captured, report, sizeof(report));
+    fclose(captured);
+
+    const char* summary = strstr(report, "PROFILE_SUMMARY hz=1000 ");
+    const char* first = strstr(report, "\nPROFILE fn=");
+    if (summary != report || first == NULL) {
+        return fail(report);
+    }
+    if (strncmp(first, "\nPROFILE fn=hot_loop polls=84 ", 30) != 0) {
+        return fail("hot_loop should lead the report with every poll counted");
+    }
+    const char* hot_wake = strstr(first, " wake_us=");
+    if (hot_wake == NULL || hot_wake[9] == '-') {
+        return fail("yielded hot_loop polls should record wake-to-run latency");
+    }
+    const char* napper = strstr(report, "\nPROFILE fn=napper ");
+    if (napper == NULL || strstr(napper, " parks=join:") == NULL) {
+        return fail("napper should park on its sleep task's join key");
+    }
+    if (strstr(report, "\nPROFILE fn=[sleep] polls=") == NULL) {
+        return fail("builtin sleep tasks should have their own slot");
+    }
+
+    FILE* f = fopen(getenv("SURGE_PROFILE_OUT"), "r");
+    if (f == NULL) {
+        return fail("folded profile was not written");
+    }
+    read_all(f, folded, sizeof(folded));
+    fclose(f);
+    if (strncmp(folded, "hot_loop ", 9) != 0 || folded[9] < '1' || folded[9] > '9') {
+        return fail(folded);
+    }
+    return 0;
+}
+`
@@ -0,0 +1,145 @@
+package vm_test
+
+import "testing"
+
+func TestNativeScopeFanOutTracksChildrenInConstantTime(t *testing.T) {
+	runNativeRuntimeHarness(t, "scope_fanout_harness", scopeFanOutHarness, "SURGE_THREADS=4", "SURGE_BLOCKING_THREADS=1")
+}
+
+// scopeFanOutHarness registers a large fan-out in one scope while workers finish children
+// in whatever order they get to them, so nearly every completion unlinks from the middle
+// of the child list; with per-completion scans this runs quadratic under ex->lock. The
+// owner then parks a second batch on a channel nobody sends to and cancels the scope:
+// every sleeper must end cancelled and both the scope and the owner's own child list
+// must be empty once the join returns.
+const scopeFanOutHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_OWNER = 1, FN_CHILD = 2, FN_SLEEPER = 3 };
+enum { FANOUT = 100000, SLEEPERS = 1000 };
+
+typedef struct {
+    uint64_t value;
+    uint64_t yields;
+} child_state;
+
+typedef struct {
+    void* ch;
+} sleeper_state;
+
+typedef struct {
+    int phase;
+    void* scope;
+    uint64_t spawned;
+    void* ch;
+} owner_state;
+
+static child_state children[FANOUT];
+static sleeper_state sleepers[SLEEPERS];
+static void* sleeper_tasks[SLEEPERS];
+static _Atomic uint64_t child_sum;
+static _Atomic int bad;
+
+static int owner_lists_empty(const void* scope_handle) {
+    rt_executor* ex = ensure_exec();
+    rt_lock(ex);
+    const rt_scope* scope = get_scope(ex, (uint64_t)(uintptr_t)scope_handle);
+    const rt_task* owner = rt_current_task();
+    int empty = scope != NULL && scope->children == NULL && scope->active_children == 0 &&
+                owner != NULL && owner->children == NULL;
+    rt_unlock(ex);
+    return empty;
+}
+
+void __surge_poll_call(uint64_t id) {
+    void* raw = __task_state();
+    switch (id) {
+        case FN_CHILD: {
+            child_state* st = (child_state*)raw;
+            if (st->yields > 0) {
+                st->yields--;
+                rt_async_yield(st);
+            }
+            atomic_fetch_add(&child_sum, st->value);
+            rt_async_return(st, st->value);
+            break;
+        }
+        case FN_SLEEPER: {
+            sleeper_state* st = (sleeper_state*)raw;
+            uint64_t bits = 0;
+            if (rt_channel_recv(st->ch, &bits) == 0) {
+                rt_async_yield(st);
+            }
+            atomic_store(&bad, 1);
+            rt_async_return(st, 0);
+            break;
+        }
+        case FN_OWNER: {
+            owner_state* st = (owner_state*)raw;
+            if (st->phase == 0) {
+                st->scope = rt_scope_enter(false);
+                for (uint64_t i = 0; i < FANOUT; i++) {
+                    children[i].value = i + 1;
+                    children[i].yields = (i * 7919) % 4;
+                    rt_scope_register_child(st->scope, __task_create(FN_CHILD, &children[i]));
+                }
+                st->phase = 1;
+            }
+            if (st->phase == 1) {
+                if (!rt_scope_join_all(st->scope, NULL, NULL)) {
+                    rt_async_yield(st);
+                }
+                if (!owner_lists_empty(st->scope)) {
+                    atomic_store(&bad, 1);
+                }
+                st->ch = rt_channel_new(1);
+                for (int i = 0; i < SLEEPERS; i++) {
+                    sleepers[i].ch = st->ch;
+                    sleeper_tasks[i] = __task_create(FN_SLEEPER, &sleepers[i]);
+                    rt_scope_register_child(st->scope, sleeper_tasks[i]);
+                }
+                st->phase = 2;
+                rt_async_yield(st);
+            }
+            if (st->phase == 2) {
+                rt_scope_cancel_all(st->scope);
+                st->phase = 3;
+            }
+            if (!rt_scope_join_all(st->scope, NULL, NULL)) {
+                rt_async_yield(st);
+            }
+            if (!owner_lists_empty(st->scope)) {
+                atomic_store(&bad, 1);
+            }
+            rt_scope_exit(st->scope);
+            rt_async_return(st, atomic_load(&child_sum));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int main(void) {
+    static owner_state owner;
+    void* task = __task_create(FN_OWNER, &owner);
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    rt_task_await(task, &kind, &bits);
+    if (kind != 1 || bits != (uint64_t)FANOUT * (FANOUT + 1) / 2) {
+        return fail("fan-out scope lost a child");
+    }
+    for (int i = 0; i < SLEEPERS; i++) {
+        rt_task_await(sleeper_tasks[i], &kind, &bits);
+        if (kind != 2) {
+            return fail("sleeper survived scope cancellation");
+        }
+    }
+    if (atomic_load(&bad)) {
+        return fail("child lists not empty after join or a sleeper woke without cancel");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,118 @@
+package vm_test
+
+import "testing"
+
+func TestNativeSlotPoolsReuseIdsAndRejectStaleOnes(t *testing.T) {
+	runNativeRuntimeHarness(t, "slot_pool_harness", slotPoolHarness, "SURGE_THREADS=2", "SURGE_BLOCKING_THREADS=1")
+}
+
+// slotPoolHarness churns tasks, scopes and blocking jobs and checks that freed slots come
+// back with a new generation while the slot tables and record pools stay bounded. It runs
+// with two workers because main awaits blocking jobs directly, outside any task.
+const slotPoolHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_LEAF = 1, FN_SCOPE = 2 };
+enum { ROUNDS = 20000, BATCH = 32 };
+
+typedef struct {
+    uint64_t arg;
+} harness_state;
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    switch (id) {
+        case FN_LEAF:
+            rt_async_return(st, st->arg);
+            break;
+        case FN_SCOPE: {
+            void* scope = rt_scope_enter(false);
+            rt_scope_exit(scope);
+            rt_async_return(st, (uint64_t)(uintptr_t)scope);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static uint64_t run_task(uint64_t fn, harness_state* st) {
+    void* t = __task_create(fn, st);
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    rt_task_await(t, &kind, &bits);
+    return bits;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    harness_state st = {0};
+
+    void* first = __task_create(FN_LEAF, &st);
+    uint64_t first_id = ((rt_task*)first)->id;
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    rt_task_await(first, &kind, &bits);
+    void* second = __task_create(FN_LEAF, &st);
+    uint64_t second_id = ((rt_task*)second)->id;
+    rt_lock(ex);
+    int stale_hit = get_task(ex, first_id) != NULL;
+    int live_hit = get_task(ex, second_id) == (rt_task*)second;
+    rt_unlock(ex);
+    if ((first_id & RT_SLOT_INDEX_MASK) != (second_id & RT_SLOT_INDEX_MASK) ||
+        first_id == second_id) {
+        return fail("freed task slot was not reused with a new generation");
+    }
+    if (stale_hit || !live_hit) {
+        return fail("task lookup did not reject the stale id");
+    }
+    rt_task_await(second, &kind, &bits);
+
+    uint64_t scope_a = run_task(FN_SCOPE, &st);
+    uint64_t scope_b = run_task(FN_SCOPE, &st);
+    rt_lock(ex);
+    int stale_scope = get_scope(ex, scope_a) != NULL || get_scope(ex, scope_b) != NULL;
+    rt_unlock(ex);
+    if (scope_a == scope_b || (scope_a & RT_SLOT_INDEX_MASK) != (scope_b & RT_SLOT_INDEX_MASK)) {
+        return fail("freed scope slot was not reused with a new generation");
+    }
+    if (stale_scope) {
+        return fail("scope lookup did not reject an exited scope");
+    }
+
+    harness_state batch_states[BATCH];
+    void* handles[BATCH];
+    for (int round = 0; round < ROUNDS / BATCH; round++) {
+        for (int i = 0; i < BATCH; i++) {
+            batch_states[i].arg = (uint64_t)i;
+            handles[i] = (i % 4 == 0) ? rt_blocking_submit(0, NULL, 0, 1)
+                                      : __task_create(i % 4 == 1 ? FN_SCOPE : FN_LEAF,
+                                                      &batch_states[i]);
+        }
+        for (int i = 0; i < BATCH; i++) {
+            rt_task_await(handles[i], &kind, &bits);
+            if (i % 4 >= 2 && bits != (uint64_t)i) {
+                return fail("pooled task returned the wrong result");
+            }
+        }
+    }
+
+    rt_lock(ex);
+    size_t tasks_cap = ex->tasks_cap;
+    size_t scopes_cap = ex->scopes_cap;
+    size_t task_records = ex->task_slab.records;
+    rt_unlock(ex);
+    pthread_mutex_lock(&ex->blocking_lock);
+    size_t job_records = ex->blocking_job_slab.records;
+    pthread_mutex_unlock(&ex->blocking_lock);
+    if (tasks_cap > 4 * BATCH || scopes_cap > 4 * BATCH) {
+        return fail("slot tables grew with churn instead of the live high water");
+    }
+    if (task_records > 1024 || job_records > 1024) {
+        return fail("record pools grew with churn instead of the live high water");
+    }
+    return 0;
+}
+`
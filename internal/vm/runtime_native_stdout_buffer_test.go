@@ -0,0 +1,225 @@
+package vm_test
+
+import "testing"
+
+func TestNativeStdoutBuffersAndFlushesInOrder(t *testing.T) {
+	runNativeRuntimeHarness(t, "stdout_buffer_harness", stdoutBufferHarness, "SURGE_THREADS=1")
+}
+
+func TestNativeStdoutLineModeFlushesFinishedLines(t *testing.T) {
+	runNativeRuntimeHarness(t, "stdout_line_harness", stdoutBufferHarness, "SURGE_THREADS=1", "SURGE_STDOUT=line")
+}
+
+// stdoutBufferHarness points stdout at temp files and checks that small writes stay
+// buffered until a flush, a full buffer, or exit, that large writes and stderr writes
+// keep program order, and that lines printed from several threads come out whole. With
+// SURGE_STDOUT=line it checks instead that each finished line is written at once.
+const stdoutBufferHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+enum { THREADS = 4, RECORDS = 2000, BIG = 100000 };
+
+static int temp_file(const char* tag) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/surge_stdout_%s_%d", tag, (int)getpid());
+    int fd = open(path, O_RDWR | O_APPEND | O_CREAT | O_TRUNC, 0600);
+    if (fd >= 0) {
+        unlink(path);
+    }
+    return fd;
+}
+
+static long file_size(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return -1;
+    }
+    return (long)st.st_size;
+}
+
+// Files are opened with O_APPEND, so moving the shared offset here never redirects writes.
+static int read_at(int fd, void* out, size_t len, long at) {
+    return lseek(fd, (off_t)at, SEEK_SET) == (off_t)at && read(fd, out, len) == (ssize_t)len;
+}
+
+static int file_ends_with(int fd, const char* want) {
+    size_t len = strlen(want);
+    long size = file_size(fd);
+    char got[64];
+    if (size < (long)len || len > sizeof(got) ||
+        !read_at(fd, got, len, size - (long)len)) {
+        return 0;
+    }
+    return memcmp(got, want, len) == 0;
+}
+
+static void put(const char* text) {
+    rt_write_stdout((const uint8_t*)text, (uint64_t)strlen(text));
+}
+
+// Runs body in a child whose stdout is fd and reports the child's exit status.
+static int in_child(int fd, int (*body)(int)) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(fd, STDOUT_FILENO);
+        _exit(body(fd));
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+static int line_mode_child(int fd) {
+    put("part");
+    if (file_size(fd) != 0) {
+        return 2;
+    }
+    put("ial\n");
+    if (file_size(fd) != 8) {
+        return 3;
+    }
+    put("tail");
+    rt_exit(0);
+    return 4;
+}
+
+static int exit_child(int fd) {
+    (void)fd;
+    put("bye");
+    exit(0);
+}
+
+static void* printer_main(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < RECORDS; i++) {
+        char line[32];
+        int n = snprintf(line, sizeof(line), "t%d:%05d\n", id, i);
+        rt_write_stdout((const uint8_t*)line, (uint64_t)n);
+    }
+    return NULL;
+}
+
+static int check_threads(int fd, long start) {
+    long size = file_size(fd);
+    long want = (long)THREADS * RECORDS * 9;
+    if (size - start != want) {
+        return 0;
+    }
+    char* text = (char*)malloc((size_t)want + 1);
+    if (text == NULL || !read_at(fd, text, (size_t)want, start)) {
+        free(text);
+        return 0;
+    }
+    text[want] = 0;
+    int next[THREADS] = {0};
+    int ok = 1;
+    for (long at = 0; ok && at < want; at += 9) {
+        int id = 0;
+        int seq = 0;
+        if (sscanf(text + at, "t%d:%5d", &id, &seq) != 2 || text[at + 8] != '\n' || id < 0 ||
+            id >= THREADS || seq != next[id]) {
+            ok = 0;
+            break;
+        }
+        next[id]++;
+    }
+    free(text);
+    return ok;
+}
+
+int main(void) {
+    const char* mode = getenv("SURGE_STDOUT");
+    if (mode != NULL && strcmp(mode, "line") == 0) {
+        int line_fd = temp_file("line");
+        if (line_fd < 0) {
+            return fail("temp file open failed");
+        }
+        int status = in_child(line_fd, line_mode_child);
+        if (status == 2) {
+            return fail("line mode wrote a partial line");
+        }
+        if (status == 3) {
+            return fail("line mode held back a finished line");
+        }
+        if (status != 0 || !file_ends_with(line_fd, "partial\ntail")) {
+            return fail("rt_exit did not flush stdout");
+        }
+        return 0;
+    }
+    int exit_fd = temp_file("exit");
+    int fd = temp_file("block");
+    if (exit_fd < 0 || fd < 0) {
+        return fail("temp file open failed");
+    }
+    if (in_child(exit_fd, exit_child) != 0 || !file_ends_with(exit_fd, "bye")) {
+        return fail("exit() did not flush stdout");
+    }
+
+    int saved_stdout = dup(STDOUT_FILENO);
+    int saved_stderr = dup(STDERR_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    for (int i = 0; i < 1000; i++) {
+        put("ab\n");
+    }
+    long buffered = file_size(fd);
+    rt_flush_stdout();
+    long flushed = file_size(fd);
+    for (int i = 0; i < 30000; i++) {
+        put("ab\n");
+    }
+    long filled = file_size(fd);
+    rt_flush_stdout();
+    long refilled = file_size(fd);
+
+    static uint8_t big[BIG];
+    memset(big, 'B', sizeof(big));
+    put("z");
+    rt_write_stdout(big, BIG);
+    long after_big = file_size(fd);
+    uint8_t head = 0;
+    int big_ordered = read_at(fd, &head, 1, refilled) && head == 'z';
+
+    dup2(fd, STDERR_FILENO);
+    put("o");
+    rt_write_stderr((const uint8_t*)"e", 1);
+    dup2(saved_stderr, STDERR_FILENO);
+    int stderr_ordered = file_ends_with(fd, "oe");
+
+    long before_threads = file_size(fd);
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, printer_main, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    rt_flush_stdout();
+    int threads_ok = check_threads(fd, before_threads);
+    dup2(saved_stdout, STDOUT_FILENO);
+
+    if (buffered != 0 || flushed != 3000) {
+        return fail("block mode did not hold small writes until flush");
+    }
+    if (filled <= flushed || filled >= 93000 || refilled != 93000) {
+        return fail("full buffer did not spill to the file");
+    }
+    if (after_big != refilled + BIG + 1 || !big_ordered) {
+        return fail("large write skipped ahead of buffered bytes");
+    }
+    if (!stderr_ordered) {
+        return fail("stderr overtook buffered stdout");
+    }
+    if (!threads_ok) {
+        return fail("concurrent prints interleaved inside a line");
+    }
+    return 0;
+}
+`
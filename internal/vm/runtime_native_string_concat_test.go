@@ -0,0 +1,116 @@
+package vm_test
+
+import "testing"
+
+func TestNativeStringConcatAppendsInPlaceWithoutSharingTails(t *testing.T) {
+	runNativeRuntimeHarness(t, "string_concat_harness", stringConcatHarness, "SURGE_THREADS=1")
+}
+
+// stringConcatHarness builds long strings by repeated concatenation, forks them from a
+// shared prefix (also from several threads at once), and checks that every result keeps
+// its own bytes and that long append chains reuse their buffer instead of copying.
+const stringConcatHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { APPENDS = 200000, THREADS = 4, FORKS = 2000 };
+
+static void* str(const char* text) {
+    return rt_string_from_bytes((const uint8_t*)text, (uint64_t)strlen(text));
+}
+
+static int has_bytes(void* s, const char* want, uint64_t len) {
+    return rt_string_len_bytes(&s) == len && memcmp(rt_string_ptr(&s), want, (size_t)len) == 0;
+}
+
+static void* shared_prefix;
+
+static void* fork_main(void* arg) {
+    char tag = (char)('a' + (int)(intptr_t)arg);
+    char piece[2] = {tag, 0};
+    void* suffix = str(piece);
+    uint64_t base_len = rt_string_len_bytes(&shared_prefix);
+    for (int i = 0; i < FORKS; i++) {
+        void* s = rt_string_concat(&shared_prefix, &suffix);
+        s = rt_string_concat(&s, &suffix);
+        const uint8_t* p = rt_string_ptr(&s);
+        if (rt_string_len_bytes(&s) != base_len + 2 || p[base_len] != (uint8_t)tag ||
+            p[base_len + 1] != (uint8_t)tag || memcmp(p, rt_string_ptr(&shared_prefix), 128) != 0) {
+            return (void*)1;
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    void* piece = str("ha");
+    void* s = str("");
+    uint64_t allocs0 = 0, bytes0 = 0;
+    rt_heap_counts(&allocs0, NULL, NULL, &bytes0);
+    for (int i = 0; i < APPENDS; i++) {
+        s = rt_string_concat(&s, &piece);
+    }
+    uint64_t allocs1 = 0, bytes1 = 0;
+    rt_heap_counts(&allocs1, NULL, NULL, &bytes1);
+    if (rt_string_len(&s) != 2u * APPENDS || rt_string_len_bytes(&s) != 2u * APPENDS) {
+        return fail("appended string has the wrong length");
+    }
+    const uint8_t* p = rt_string_ptr(&s);
+    for (uint64_t i = 0; i < 2u * APPENDS; i += 2) {
+        if (p[i] != 'h' || p[i + 1] != 'a') {
+            return fail("appended string has the wrong bytes");
+        }
+    }
+    if (bytes1 - bytes0 > (uint64_t)APPENDS * 64 + 8u * 2u * APPENDS) {
+        return fail("append chain copied its prefix instead of extending the buffer");
+    }
+
+    // Two results forked from one prefix must not overwrite each other.
+    void* base = rt_string_repeat(&piece, 100);
+    void* x = str("x");
+    void* y = str("y");
+    void* a = rt_string_concat(&base, &x);
+    void* bx = rt_string_concat(&a, &x);
+    void* b = rt_string_concat(&a, &y);
+    if (rt_string_len_bytes(&bx) != 202 || rt_string_len_bytes(&b) != 202) {
+        return fail("forked concat has the wrong length");
+    }
+    const uint8_t* pa = rt_string_ptr(&a);
+    const uint8_t* pbx = rt_string_ptr(&bx);
+    const uint8_t* pb = rt_string_ptr(&b);
+    if (rt_string_len_bytes(&a) != 201 || pa[200] != 'x' || pbx[201] != 'x' || pb[201] != 'y' ||
+        memcmp(pb, pa, 201) != 0) {
+        return fail("forked concat results share or lost bytes");
+    }
+
+    void* parts[5] = {str("failed to parse \""), str("abc"), str("\" as int"), NULL, str("!")};
+    void* joined = rt_string_concat_n(parts, 5);
+    if (!has_bytes(joined, "failed to parse \"abc\" as int!", 29) || rt_string_len(&joined) != 29) {
+        return fail("rt_string_concat_n joined the wrong bytes");
+    }
+    void* empty = rt_string_concat_n(NULL, 0);
+    if (rt_string_len_bytes(&empty) != 0) {
+        return fail("rt_string_concat_n of nothing is not empty");
+    }
+    void* cafe = str("caf\xc3\xa9");
+    void* tail = rt_string_concat(&s, &cafe);
+    if (rt_string_len(&tail) != 2u * APPENDS + 4 || rt_string_index(&tail, -1) != 0xE9) {
+        return fail("codepoint count did not carry through an in-place append");
+    }
+
+    shared_prefix = rt_string_repeat(&piece, 200);
+    shared_prefix = rt_string_concat(&shared_prefix, &x);
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, fork_main, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        void* res = NULL;
+        pthread_join(threads[i], &res);
+        if (res != NULL) {
+            return fail("concurrent concat from one prefix mixed up bytes");
+        }
+    }
+    return 0;
+}
+`
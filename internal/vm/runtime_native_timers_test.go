@@ -0,0 +1,141 @@
+package vm_test
+
+import "testing"
+
+func TestNativeTimerHeapDrivesSleepsAndTimeouts(t *testing.T) {
+	runNativeRuntimeHarness(t, "timer_heap_harness", timerHeapHarness, "SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1")
+}
+
+// timerHeapHarness drives real user tasks through its own poll dispatcher: sleepers
+// await rt_sleep handles, and timeout/select tasks race a sleeper against a deadline.
+const timerHeapHarness = `
+#include "rt_async_internal.h"
+#define HARNESS_POLL_CALL
+#include "harness.h"
+
+enum { FN_SLEEPER = 1, FN_TIMEOUT = 2, FN_SELECT = 3 };
+enum { SLEEPERS = 2000 };
+
+typedef struct {
+    int phase;
+    void* handle;
+    uint64_t arg;
+    uint64_t arg2;
+    uint64_t done_at;
+} harness_state;
+
+static harness_state sleepers[SLEEPERS];
+
+void __surge_poll_call(uint64_t id) {
+    harness_state* st = (harness_state*)__task_state();
+    uint64_t bits = 0;
+    switch (id) {
+        case FN_SLEEPER:
+            if (st->phase == 0) {
+                st->handle = rt_sleep(st->arg);
+                st->phase = 1;
+            }
+            if (rt_task_poll(st->handle, &bits) == 0) {
+                rt_async_yield(st);
+            }
+            st->done_at = exec_state.now_ms;
+            rt_async_return(st, st->arg);
+            break;
+        case FN_TIMEOUT: {
+            if (st->phase == 0) {
+                harness_state* w = calloc(1, sizeof(*w));
+                w->arg = st->arg;
+                st->handle = __task_create(FN_SLEEPER, w);
+                st->phase = 1;
+            }
+            uint8_t kind = rt_timeout_poll(st->handle, st->arg2, &bits);
+            if (kind == 0) {
+                rt_async_yield(st);
+            }
+            st->done_at = exec_state.now_ms;
+            rt_async_return(st, kind);
+            break;
+        }
+        case FN_SELECT: {
+            if (st->phase == 0) {
+                harness_state* w = calloc(1, sizeof(*w));
+                w->arg = st->arg;
+                st->handle = __task_create(FN_SLEEPER, w);
+                st->phase = 1;
+            }
+            uint8_t kinds[1] = {3};
+            void* handles[1] = {st->handle};
+            uint64_t ms[1] = {st->arg2};
+            int64_t sel = rt_select_poll(1, kinds, handles, NULL, ms, -1);
+            if (sel < 0) {
+                rt_async_yield(st);
+            }
+            st->done_at = exec_state.now_ms;
+            rt_async_return(st, (uint64_t)(sel + 1));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static uint64_t run_task(uint64_t fn, harness_state* st, uint8_t* kind) {
+    void* t = __task_create(fn, st);
+    uint64_t bits = 0;
+    rt_task_await(t, kind, &bits);
+    return bits;
+}
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    uint8_t kind = 0;
+    harness_state a = {0};
+    a.arg = 30;
+    a.arg2 = 5;
+    uint64_t start = ex->now_ms;
+    uint64_t r = run_task(FN_TIMEOUT, &a, &kind);
+    if (r != 2 || a.done_at - start != 5) {
+        return fail("timeout did not cancel the slower task at its deadline");
+    }
+    harness_state b = {0};
+    b.arg = 3;
+    b.arg2 = 10;
+    start = ex->now_ms;
+    r = run_task(FN_TIMEOUT, &b, &kind);
+    if (r != 1 || b.done_at - start != 3) {
+        return fail("timeout did not let the faster task finish");
+    }
+    harness_state c = {0};
+    c.arg = 50;
+    c.arg2 = 5;
+    start = ex->now_ms;
+    r = run_task(FN_SELECT, &c, &kind);
+    if (r != 1 || c.done_at - start != 5) {
+        return fail("select timeout arm did not fire at its deadline");
+    }
+
+    start = ex->now_ms;
+    void* handles[SLEEPERS];
+    uint64_t rng = 7;
+    for (int i = 0; i < SLEEPERS; i++) {
+        rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        sleepers[i].arg = (rng >> 33) % 1000;
+        handles[i] = __task_create(FN_SLEEPER, &sleepers[i]);
+    }
+    for (int i = 0; i < SLEEPERS; i++) {
+        uint64_t bits = 0;
+        rt_task_await(handles[i], &kind, &bits);
+        uint64_t at = sleepers[i].done_at - start;
+        if (at < sleepers[i].arg || at > sleepers[i].arg + 2) {
+            return fail("sleep fired at the wrong virtual time");
+        }
+    }
+    rt_lock(ex);
+    size_t pending = ex->timers_len;
+    rt_unlock(ex);
+    if (pending != 0) {
+        return fail("timers left in the heap after every owner finished");
+    }
+    return 0;
+}
+`
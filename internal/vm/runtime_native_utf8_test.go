@@ -0,0 +1,177 @@
+package vm_test
+
+import "testing"
+
+func TestNativeUTF8KernelsMatchReferenceDecoder(t *testing.T) {
+	runNativeRuntimeHarness(t, "utf8_kernel_harness", utf8KernelHarness, "SURGE_THREADS=1")
+}
+
+// utf8KernelHarness compares rt_utf8_valid and rt_utf8_count with a byte-at-a-time
+// reference on random text that mixes ASCII runs, multi-byte sequences, and corruptions
+// placed around the vector block boundaries, then checks ASCII string indexing.
+const utf8KernelHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+static uint64_t rng = 0x9e3779b97f4a7c15u;
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)rng;
+}
+
+static int ref_is_cont(uint8_t c) {
+    return (c & 0xC0) == 0x80;
+}
+
+static uint64_t ref_seq_len(const uint8_t* d, uint64_t len, uint64_t i) {
+    // Length of the valid sequence at i, or 0.
+    uint8_t c0 = d[i];
+    if (c0 < 0x80) {
+        return 1;
+    }
+    uint64_t n = c0 >= 0xF0 ? 4 : (c0 >= 0xE0 ? 3 : 2);
+    if (c0 < 0xC2 || c0 > 0xF4 || i + n > len) {
+        return 0;
+    }
+    for (uint64_t k = 1; k < n; k++) {
+        if (!ref_is_cont(d[i + k])) {
+            return 0;
+        }
+    }
+    uint8_t c1 = d[i + 1];
+    if ((c0 == 0xE0 && c1 < 0xA0) || (c0 == 0xED && c1 >= 0xA0) ||
+        (c0 == 0xF0 && c1 < 0x90) || (c0 == 0xF4 && c1 >= 0x90)) {
+        return 0;
+    }
+    return n;
+}
+
+static int ref_scan(const uint8_t* d, uint64_t len, uint64_t* count) {
+    int valid = 1;
+    uint64_t n = 0;
+    for (uint64_t i = 0; i < len; n++) {
+        uint64_t step = ref_seq_len(d, len, i);
+        if (step == 0) {
+            valid = 0;
+            step = 1;
+        }
+        i += step;
+    }
+    *count = n;
+    return valid;
+}
+
+static uint64_t put_cp(uint8_t* out, uint32_t cp) {
+    if (cp < 0x80) {
+        out[0] = (uint8_t)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (uint8_t)(0xC0 | (cp >> 6));
+        out[1] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (uint8_t)(0xE0 | (cp >> 12));
+        out[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (uint8_t)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (uint8_t)(0xF0 | (cp >> 18));
+    out[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (uint8_t)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+static uint64_t fill_text(uint8_t* buf, uint64_t cap) {
+    uint64_t len = 0;
+    while (len + 4 <= cap) {
+        uint32_t pick = next_rand() % 8;
+        uint32_t cp = 0;
+        if (pick < 4) {
+            cp = 0x20 + next_rand() % 0x5F;
+        } else if (pick == 4) {
+            cp = 0x80 + next_rand() % 0x780;
+        } else if (pick == 5 || pick == 6) {
+            do {
+                cp = 0x800 + next_rand() % 0xF800;
+            } while (cp >= 0xD800 && cp < 0xE000);
+        } else {
+            cp = 0x10000 + next_rand() % 0x100000;
+        }
+        len += put_cp(buf + len, cp);
+    }
+    return len;
+}
+
+static int check(const uint8_t* buf, uint64_t len) {
+    uint64_t want_count = 0;
+    int want_valid = ref_scan(buf, len, &want_count);
+    if ((int)rt_utf8_valid(buf, len) != want_valid) {
+        return fail("rt_utf8_valid disagrees with the reference decoder");
+    }
+    if (rt_utf8_count(buf, len) != want_count) {
+        return fail("rt_utf8_count disagrees with the reference decoder");
+    }
+    return 0;
+}
+
+int main(void) {
+    static uint8_t buf[300];
+    static const uint8_t bad[] = {0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xE0, 0xED, 0xF0, 0xF4, 0xF5, 0xFF};
+    for (int round = 0; round < 20000; round++) {
+        uint64_t cap = 1 + next_rand() % (sizeof(buf) - 1);
+        uint64_t len = fill_text(buf, cap);
+        if (round % 3 == 0) {
+            for (uint64_t i = 0; i < len; i++) {
+                buf[i] = (uint8_t)(0x20 + next_rand() % 0x5F);
+            }
+        }
+        if (check(buf, len) != 0) {
+            return 1;
+        }
+        if (len == 0) {
+            continue;
+        }
+        uint32_t edits = 1 + next_rand() % 3;
+        for (uint32_t e = 0; e < edits; e++) {
+            uint64_t at = next_rand() % len;
+            if (next_rand() % 2 == 0) {
+                // Aim near 16- and 32-byte block edges.
+                at = (at & ~(uint64_t)15) + (next_rand() % 2 == 0 ? 15 : 0);
+                at = at < len ? at : len - 1;
+            }
+            buf[at] = bad[next_rand() % sizeof(bad)];
+        }
+        if (check(buf, len) != 0) {
+            return 1;
+        }
+        if (check(buf, len - next_rand() % (len < 4 ? len : 4)) != 0) {
+            return 1;
+        }
+    }
+
+    const char* text = "plain ascii text that is long enough for a vector block";
+    void* s = rt_string_from_bytes((const uint8_t*)text, (uint64_t)strlen(text));
+    if (rt_string_len(&s) != strlen(text)) {
+        return fail("ASCII codepoint count is wrong");
+    }
+    for (int64_t i = 0; i < (int64_t)strlen(text); i++) {
+        if (rt_string_index(&s, i) != (uint32_t)(uint8_t)text[i] ||
+            rt_string_index(&s, -1 - i) != (uint32_t)(uint8_t)text[strlen(text) - 1 - (size_t)i]) {
+            return fail("ASCII string indexing returned the wrong codepoint");
+        }
+    }
+    const char* mixed = "caf\xc3\xa9 \xe2\x82\xac";
+    void* m = rt_string_from_bytes((const uint8_t*)mixed, (uint64_t)strlen(mixed));
+    if (rt_string_len(&m) != 6 || rt_string_index(&m, 3) != 0xE9 ||
+        rt_string_index(&m, 5) != 0x20AC) {
+        return fail("multi-byte string indexing returned the wrong codepoint");
+    }
+    return 0;
+}
+`
@@ -0,0 +1,96 @@
+package vm_test
+
+import "testing"
+
+func TestNativeWaiterIndexKeepsPerKeyFIFO(t *testing.T) {
+	runNativeRuntimeHarness(t, "waiter_index_harness", waiterIndexHarness, "SURGE_THREADS=1", "SURGE_BLOCKING_THREADS=1")
+}
+
+const waiterIndexHarness = `
+#include "rt_async_internal.h"
+#include "harness.h"
+
+enum { TASKS = 512, KEYS = 97 };
+
+static rt_task* tasks[TASKS];
+
+int main(void) {
+    rt_executor* ex = ensure_exec();
+    if (ex == NULL) {
+        return fail("missing executor");
+    }
+    rt_lock(ex);
+    for (int i = 0; i < TASKS; i++) {
+        tasks[i] = harness_task_new(ex, TASK_WAITING);
+        if (tasks[i] == NULL) {
+            rt_unlock(ex);
+            return fail("task allocation failed");
+        }
+    }
+    for (int i = 0; i < TASKS; i++) {
+        add_waiter(ex, channel_recv_key((rt_channel*)(uintptr_t)(0x1000 + (i % KEYS) * 64)),
+                   tasks[i]->id);
+        add_waiter(ex, join_key(tasks[(i + 1) % TASKS]->id), tasks[i]->id);
+    }
+    if (ex->waiters_len != 2 * TASKS || ex->waiters_by_kind[WAKER_CHAN_RECV] != TASKS ||
+        ex->waiters_by_kind[WAKER_JOIN] != TASKS) {
+        rt_unlock(ex);
+        return fail("waiter counts mismatch after registration");
+    }
+
+    // Every task of key 0 except the first one is removed; later ones are marked done.
+    waker_key key0 = channel_recv_key((rt_channel*)(uintptr_t)0x1000);
+    remove_waiter(ex, key0, tasks[0]->id);
+    task_status_store(tasks[KEYS], TASK_DONE);
+    uint64_t got = 0;
+    if (!pop_waiter(ex, key0, &got) || got != tasks[2 * KEYS]->id) {
+        rt_unlock(ex);
+        return fail("pop_waiter did not skip removed and done waiters in FIFO order");
+    }
+    task_status_store(tasks[KEYS], TASK_WAITING);
+
+    // Remaining registrations of each key must come back in registration order.
+    for (int k = 1; k < KEYS; k++) {
+        waker_key key = channel_recv_key((rt_channel*)(uintptr_t)(0x1000 + k * 64));
+        for (int i = k; i < TASKS; i += KEYS) {
+            if (!take_waiter(ex, key, &got) || got != tasks[i]->id) {
+                rt_unlock(ex);
+                return fail("per-key FIFO order broken");
+            }
+        }
+        if (take_waiter(ex, key, &got)) {
+            rt_unlock(ex);
+            return fail("drained key still has waiters");
+        }
+    }
+
+    for (int i = 0; i < TASKS; i++) {
+        remove_task_waiters(ex, tasks[i]);
+        if (tasks[i]->waiters != NULL) {
+            rt_unlock(ex);
+            return fail("task still owns waiters after teardown");
+        }
+    }
+    if (ex->waiters_len != 0 || ex->wait_queues_len != 0 || ex->waiters_by_kind[WAKER_JOIN] != 0 ||
+        ex->waiters_by_kind[WAKER_CHAN_RECV] != 0) {
+        rt_unlock(ex);
+        return fail("index not empty after teardown");
+    }
+
+    waker_key net = {WAKER_NET_READ, 7};
+    add_waiter(ex, net, tasks[0]->id);
+    add_waiter(ex, net, tasks[1]->id);
+    if (!has_net_waiters(ex) || ex->net_wait_queues == NULL || ex->net_wait_queues->head == NULL) {
+        rt_unlock(ex);
+        return fail("net waiter not listed");
+    }
+    remove_waiter(ex, net, tasks[0]->id);
+    remove_waiter(ex, net, tasks[1]->id);
+    if (has_net_waiters(ex)) {
+        rt_unlock(ex);
+        return fail("net waiter list not cleared");
+    }
+    rt_unlock(ex);
+    return 0;
+}
+`
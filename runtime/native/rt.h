@@ -24,14 +24,28 @@ void rt_byte_array_append_range(void* dst_slot,
                                 const void* src_array,
                                 uint64_t start,
                                 uint64_t len);
+void rt_byte_array_reserve_spare(void* array_slot, uint64_t spare);
 void rt_byte_array_drop_prefix(void* array_slot, uint64_t count);
+uint64_t rt_byte_array_reserve_tail(void* array_slot, uint64_t start, uint64_t spare);
 bool rt_byte_parse_uint64_token(
     const void* array, uint64_t start, uint64_t end, uint64_t* value_out, uint64_t* next_out);
+uint64_t rt_byte_find(const void* array, uint64_t start, uint64_t end, uint8_t needle);
+uint64_t rt_byte_find2(const void* array, uint64_t start, uint64_t end, uint8_t a, uint8_t b);
+uint64_t
+rt_byte_find3(const void* array, uint64_t start, uint64_t end, uint8_t a, uint8_t b, uint8_t c);
+uint64_t rt_byte_find_set(const void* array, uint64_t start, uint64_t end, const void* set);
+uint64_t rt_byte_count(const void* array, uint64_t start, uint64_t end, uint8_t needle);
+uint64_t rt_byte_skip_ascii_ws(const void* array, uint64_t start, uint64_t end);
+uint64_t rt_byte_find_ascii_ws(const void* array, uint64_t start, uint64_t end);
+uint64_t rt_json_scan_string(const void* array, uint64_t start, uint64_t end);
+uint64_t rt_json_structural_index(const void* array, uint64_t start, uint64_t end, void* out_slot);
 size_t rt_tag_payload_offset(size_t payload_align);
 void* rt_tag_alloc(uint32_t tag, size_t payload_align, size_t payload_size);
 
 uint64_t rt_write_stdout(const uint8_t* ptr, uint64_t length);
 uint64_t rt_write_stderr(const uint8_t* ptr, uint64_t length);
+void rt_flush_stdout(void);
+bool rt_stdout_pending(void);
 void* rt_entropy_bytes(uint64_t len);
 void rt_term_enter_alt_screen(void);
 void rt_term_exit_alt_screen(void);
@@ -50,8 +64,17 @@ void rt_panic_bounds(uint64_t kind, int64_t index, int64_t length);
 int64_t rt_monotonic_now(void);
 uint64_t rt_worker_count(void);
 void* rt_heap_stats(void);
+void rt_heap_counts(uint64_t* alloc_count,
+                    uint64_t* free_count,
+                    uint64_t* live_blocks,
+                    uint64_t* live_bytes);
 void rt_exec_trace_dump(void);
 void rt_sched_trace_dump(void);
+void* rt_metrics_json(void);
+void* rt_metrics_prometheus(void);
+int64_t rt_metrics_value(void* name);
+void rt_metrics_export_exit(void);
+void rt_profile_dump_exit(void);
 
 void* rt_argv(void);
 void* rt_stdin_read_all(void);
@@ -69,7 +92,10 @@ void* rt_fs_write(void* file, const uint8_t* buf, uint64_t len);
 void* rt_fs_seek(void* file, int64_t offset, int64_t whence);
 void* rt_fs_flush(void* file);
 void* rt_fs_read_file(void* path);
+void* rt_fs_map_file(void* path);
+void* rt_fs_read_into(void* file, void* array_slot, uint64_t cap);
 void* rt_fs_write_file(void* path, const uint8_t* data, uint64_t len, uint32_t flags);
+int rt_fs_file_fd(const void* file);
 void* rt_fs_file_name(const void* file);
 void* rt_fs_file_type(const void* file);
 void* rt_fs_file_metadata(void* file);
@@ -82,7 +108,10 @@ void* rt_net_accept(const void* listener);
 void* rt_net_read(const void* conn, uint8_t* buf, uint64_t cap);
 void* rt_net_write(const void* conn, const uint8_t* buf, uint64_t len);
 void* rt_net_read_bytes(const void* conn, uint64_t cap);
+void* rt_net_read_into(const void* conn, void* array_slot, uint64_t cap);
 void* rt_net_write_bytes(const void* conn, const void* bytes, uint64_t offset, uint64_t len);
+void* rt_net_write_vectored(const void* conn, const void* parts, uint64_t offset);
+void* rt_net_send_file(const void* conn, const void* file, uint64_t offset, uint64_t len);
 bool rt_net_wait_accept(const void* listener);
 bool rt_net_wait_readable(const void* conn);
 bool rt_net_wait_writable(const void* conn);
@@ -98,6 +127,7 @@ typedef struct SurgeRange {
 
 void* rt_string_from_bytes(const uint8_t* ptr, uint64_t len);
 bool rt_utf8_valid(const uint8_t* ptr, uint64_t len);
+uint64_t rt_utf8_count(const uint8_t* ptr, uint64_t len);
 const uint8_t* rt_string_ptr(void* s);
 uint64_t rt_string_len(void* s);
 uint64_t rt_string_len_bytes(void* s);
@@ -105,6 +135,7 @@ uint32_t rt_string_index(void* s, int64_t index);
 void* rt_string_slice(void* s, void* r);
 void* rt_string_bytes_view(void* s);
 void* rt_string_concat(void* a, void* b);
+void* rt_string_concat_n(void* parts, uint64_t count);
 void* rt_string_repeat(void* s, int64_t count);
 bool rt_string_eq(void* a, void* b);
 void* rt_string_from_int(int64_t value);
@@ -193,6 +224,15 @@ int64_t rt_select_poll(uint64_t count,
 void rt_async_yield(void* state);
 void rt_async_return(void* state, uint64_t bits);
 void rt_async_return_cancelled(void* state);
+// Registers the direct-return poll entries of generated code, indexed by poll function id.
+// Tasks whose entry is registered are polled without setjmp, and the terminators above
+// return to the poll function instead of longjmp-ing.
+void rt_async_register_poll_fns(void (*const* fns)(void), uint64_t len);
+// Registers the Surge names of the same poll functions for the task profiler.
+void rt_async_register_poll_names(const char* const* names, uint64_t len);
+// Allocates an async state frame from the current task's frame arena. Frames built by one
+// poll stay valid until the task's next poll builds a new one or the task is freed.
+void* rt_task_frame_alloc(uint64_t size, uint64_t align);
 
 void* rt_channel_new(uint64_t capacity);
 bool rt_channel_send(void* channel, uint64_t value_bits);
@@ -201,6 +241,7 @@ uint8_t rt_channel_recv(void* channel, uint64_t* out_bits);
 void rt_channel_send_blocking(void* channel, uint64_t value_bits);
 uint8_t rt_channel_recv_blocking(void* channel, uint64_t* out_bits);
 bool rt_channel_try_send(void* channel, uint64_t value_bits);
+uint64_t rt_channel_send_many(void* channel, const uint64_t* values_bits, uint64_t count);
 bool rt_channel_try_recv(void* channel, uint64_t* out_bits);
 void rt_channel_close(void* channel);
 
@@ -3,7 +3,9 @@
 #endif
 
 #include "rt.h"
+#include "rt_thread_block.h"
 
+#include <pthread.h>
 #include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,10 +19,84 @@ typedef struct SurgeHeapStats {
     void* rc_decrements;
 } SurgeHeapStats;
 
-static _Atomic uint64_t heap_alloc_count;
-static _Atomic uint64_t heap_free_count;
-static _Atomic uint64_t heap_live_blocks;
-static _Atomic uint64_t heap_live_bytes;
+// Heap counters.
+//
+// Every thread updates its own counter block (rt_thread_block.h) with plain relaxed stores,
+// so allocating on several workers does not bounce one shared cache line. rt_heap_stats sums
+// the blocks on heap_threads plus heap_retired, which absorbs the counts of threads that
+// have exited.
+// A block freed on another thread lowers that thread's live counts instead; the counters
+// wrap modulo 2^64, so the sums still come out right.
+//
+// Allocator modes.
+//
+// system (the default) hands every request to malloc/posix_memalign. arena serves small
+// requests (up to ALLOC_SMALL_MAX bytes, alignment up to 16) from per-thread size-class
+// free lists refilled in batches from shared depots carved out of ALLOC_CHUNK_BYTES
+// chunks, and keeps a 16-byte header in front of every block so rt_free does not have to
+// trust the caller's size. SURGE_ALLOC=arena|system picks the mode at startup; building the
+// runtime with -DSURGE_RT_ALLOC_ARENA makes arena the default. The mode is latched by the
+// first allocation and never changes afterwards.
+
+enum {
+    ALLOC_MODE_UNSET = 0,
+    ALLOC_MODE_SYSTEM = 1,
+    ALLOC_MODE_ARENA = 2,
+};
+
+#ifdef SURGE_RT_ALLOC_ARENA
+#define ALLOC_MODE_DEFAULT ALLOC_MODE_ARENA
+#else
+#define ALLOC_MODE_DEFAULT ALLOC_MODE_SYSTEM
+#endif
+
+#define ALLOC_HEADER 16u
+#define ALLOC_CLASS_STEP 16u
+#define ALLOC_CLASSES 32u
+#define ALLOC_SMALL_MAX (ALLOC_CLASSES * ALLOC_CLASS_STEP)
+#define ALLOC_CACHE_MAX 64u
+#define ALLOC_BATCH 32u
+#define ALLOC_CHUNK_BYTES 65536u
+
+typedef struct {
+    uint32_t offset;     // bytes from the start of the underlying allocation to the block
+    uint32_t size_class; // 0 for blocks that came straight from malloc
+    uint64_t size;
+} alloc_header;
+
+typedef struct alloc_free_node {
+    struct alloc_free_node* next;
+} alloc_free_node;
+
+typedef struct {
+    alloc_free_node* head;
+    uint32_t count;
+} alloc_list;
+
+typedef struct {
+    _Atomic uint64_t alloc_count;
+    _Atomic uint64_t free_count;
+    _Atomic uint64_t live_blocks;
+    _Atomic uint64_t live_bytes;
+} heap_counters;
+
+typedef struct alloc_thread {
+    rt_thread_block block;
+    heap_counters counters;
+    alloc_list caches[ALLOC_CLASSES];
+} alloc_thread;
+
+static void alloc_thread_retire(rt_thread_block* block);
+
+static _Atomic uint8_t alloc_mode;
+static heap_counters heap_retired;
+static rt_thread_blocks heap_threads = RT_THREAD_BLOCKS_INIT(alloc_thread, alloc_thread_retire);
+static _Thread_local rt_thread_slot tls_alloc_slot;
+
+// alloc_depot_lock guards the depots and the chunk list; threads take it once per batch.
+static pthread_mutex_t alloc_depot_lock = PTHREAD_MUTEX_INITIALIZER;
+static alloc_list alloc_depots[ALLOC_CLASSES];
+static void* alloc_chunks;
 
 static uint64_t min_u64(uint64_t a, uint64_t b) {
     return a < b ? a : b;
@@ -30,35 +106,273 @@ static uint64_t alloc_size(uint64_t size) {
     return size == 0 ? 1 : size;
 }
 
+static uint8_t alloc_mode_get(void) {
+    uint8_t mode = atomic_load_explicit(&alloc_mode, memory_order_acquire);
+    if (mode != ALLOC_MODE_UNSET) {
+        return mode;
+    }
+    uint8_t want = ALLOC_MODE_DEFAULT;
+    const char* value = getenv("SURGE_ALLOC");
+    if (value != NULL && strcmp(value, "arena") == 0) {
+        want = ALLOC_MODE_ARENA;
+    } else if (value != NULL && strcmp(value, "system") == 0) {
+        want = ALLOC_MODE_SYSTEM;
+    }
+    uint8_t expected = ALLOC_MODE_UNSET;
+    if (!atomic_compare_exchange_strong_explicit(
+            &alloc_mode, &expected, want, memory_order_acq_rel, memory_order_acquire)) {
+        return expected;
+    }
+    return want;
+}
+
+static void counter_move(_Atomic uint64_t* from, _Atomic uint64_t* to) {
+    uint64_t value = atomic_exchange_explicit(from, 0, memory_order_relaxed);
+    (void)atomic_fetch_add_explicit(to, value, memory_order_relaxed);
+}
+
+static void counters_fold_into_retired(heap_counters* c) {
+    counter_move(&c->alloc_count, &heap_retired.alloc_count);
+    counter_move(&c->free_count, &heap_retired.free_count);
+    counter_move(&c->live_blocks, &heap_retired.live_blocks);
+    counter_move(&c->live_bytes, &heap_retired.live_bytes);
+}
+
+static void
+depot_put_chain(uint32_t cls, alloc_free_node* head, alloc_free_node* tail, uint32_t n) {
+    pthread_mutex_lock(&alloc_depot_lock);
+    alloc_list* depot = &alloc_depots[cls - 1];
+    tail->next = depot->head;
+    depot->head = head;
+    depot->count += n;
+    pthread_mutex_unlock(&alloc_depot_lock);
+}
+
+static void alloc_thread_retire(rt_thread_block* block) {
+    // Runs on the exiting thread: hand cached blocks back and retire its counters.
+    alloc_thread* t = (alloc_thread*)(void*)block;
+    for (uint32_t cls = 1; cls <= ALLOC_CLASSES; cls++) {
+        alloc_list* cache = &t->caches[cls - 1];
+        if (cache->head == NULL) {
+            continue;
+        }
+        alloc_free_node* tail = cache->head;
+        while (tail->next != NULL) {
+            tail = tail->next;
+        }
+        depot_put_chain(cls, cache->head, tail, cache->count);
+        cache->head = NULL;
+        cache->count = 0;
+    }
+    counters_fold_into_retired(&t->counters);
+}
+
+static alloc_thread* alloc_thread_current(void) {
+    return (alloc_thread*)(void*)rt_thread_block_get(&heap_threads, &tls_alloc_slot);
+}
+
+static void record_delta(uint64_t allocs, uint64_t frees, uint64_t blocks, uint64_t bytes) {
+    alloc_thread* t = alloc_thread_current();
+    if (t == NULL) {
+        // Exited thread or no memory for a counter block: fall back to shared counters.
+        (void)atomic_fetch_add_explicit(&heap_retired.alloc_count, allocs, memory_order_relaxed);
+        (void)atomic_fetch_add_explicit(&heap_retired.free_count, frees, memory_order_relaxed);
+        (void)atomic_fetch_add_explicit(&heap_retired.live_blocks, blocks, memory_order_relaxed);
+        (void)atomic_fetch_add_explicit(&heap_retired.live_bytes, bytes, memory_order_relaxed);
+        return;
+    }
+    rt_thread_counter_add(&t->counters.alloc_count, allocs);
+    rt_thread_counter_add(&t->counters.free_count, frees);
+    rt_thread_counter_add(&t->counters.live_blocks, blocks);
+    rt_thread_counter_add(&t->counters.live_bytes, bytes);
+}
+
 static void record_alloc(uint64_t size) {
-    (void)atomic_fetch_add_explicit(&heap_alloc_count, 1, memory_order_relaxed);
-    (void)atomic_fetch_add_explicit(&heap_live_blocks, 1, memory_order_relaxed);
-    (void)atomic_fetch_add_explicit(&heap_live_bytes, alloc_size(size), memory_order_relaxed);
+    record_delta(1, 0, 1, alloc_size(size));
 }
 
 static void record_free(uint64_t size) {
-    (void)atomic_fetch_add_explicit(&heap_free_count, 1, memory_order_relaxed);
-    (void)atomic_fetch_sub_explicit(&heap_live_blocks, 1, memory_order_relaxed);
-    (void)atomic_fetch_sub_explicit(&heap_live_bytes, alloc_size(size), memory_order_relaxed);
+    record_delta(0, 1, (uint64_t)0 - 1, (uint64_t)0 - alloc_size(size));
 }
 
 static void record_realloc(uint64_t old_size, uint64_t new_size) {
-    uint64_t old_actual = alloc_size(old_size);
-    uint64_t new_actual = alloc_size(new_size);
-    (void)atomic_fetch_add_explicit(&heap_alloc_count, 1, memory_order_relaxed);
-    (void)atomic_fetch_add_explicit(&heap_free_count, 1, memory_order_relaxed);
-    if (new_actual >= old_actual) {
-        (void)atomic_fetch_add_explicit(
-            &heap_live_bytes, new_actual - old_actual, memory_order_relaxed);
-    } else {
-        (void)atomic_fetch_sub_explicit(
-            &heap_live_bytes, old_actual - new_actual, memory_order_relaxed);
+    record_delta(1, 1, 0, alloc_size(new_size) - alloc_size(old_size));
+}
+
+static alloc_header* block_header(uint8_t* ptr) {
+    return (alloc_header*)(void*)(ptr - ALLOC_HEADER);
+}
+
+static uint32_t size_class_for(uint64_t size, uint64_t align) {
+    if (align > ALLOC_HEADER || size > ALLOC_SMALL_MAX) {
+        return 0;
+    }
+    uint64_t actual = alloc_size(size);
+    return (uint32_t)((actual + ALLOC_CLASS_STEP - 1) / ALLOC_CLASS_STEP);
+}
+
+static int depot_refill(alloc_list* cache, uint32_t cls) {
+    // Moves up to ALLOC_BATCH blocks from the depot, or carves a fresh chunk, into cache.
+    size_t block_size = ALLOC_HEADER + (size_t)cls * ALLOC_CLASS_STEP;
+    pthread_mutex_lock(&alloc_depot_lock);
+    alloc_list* depot = &alloc_depots[cls - 1];
+    if (depot->head != NULL) {
+        uint32_t moved = 0;
+        while (depot->head != NULL && moved < ALLOC_BATCH) {
+            alloc_free_node* node = depot->head;
+            depot->head = node->next;
+            node->next = cache->head;
+            cache->head = node;
+            moved++;
+        }
+        depot->count -= moved;
+        cache->count += moved;
+        pthread_mutex_unlock(&alloc_depot_lock);
+        return 1;
+    }
+    uint8_t* chunk = (uint8_t*)malloc(ALLOC_CHUNK_BYTES);
+    if (chunk == NULL) {
+        pthread_mutex_unlock(&alloc_depot_lock);
+        return 0;
+    }
+    // The first header-sized slot links the chunk list; blocks follow it.
+    memcpy(chunk, &alloc_chunks, sizeof(void*));
+    alloc_chunks = chunk;
+    pthread_mutex_unlock(&alloc_depot_lock);
+    for (size_t off = ALLOC_HEADER; off + block_size <= ALLOC_CHUNK_BYTES; off += block_size) {
+        alloc_header* h = (alloc_header*)(void*)(chunk + off);
+        h->offset = 0;
+        h->size_class = cls;
+        h->size = 0;
+        alloc_free_node* node = (alloc_free_node*)(void*)(chunk + off + ALLOC_HEADER);
+        node->next = cache->head;
+        cache->head = node;
+        cache->count++;
+    }
+    return 1;
+}
+
+static void* arena_alloc_small(uint64_t size, uint32_t cls) {
+    alloc_thread* t = alloc_thread_current();
+    alloc_list local = {NULL, 0};
+    alloc_list* cache = t != NULL ? &t->caches[cls - 1] : &local;
+    if (cache->head == NULL && !depot_refill(cache, cls)) {
+        return NULL;
+    }
+    alloc_free_node* node = cache->head;
+    cache->head = node->next;
+    cache->count--;
+    if (cache == &local && local.head != NULL) {
+        // No thread cache to keep the rest of the batch in; return it to the depot.
+        alloc_free_node* tail = local.head;
+        while (tail->next != NULL) {
+            tail = tail->next;
+        }
+        depot_put_chain(cls, local.head, tail, local.count);
     }
+    block_header((uint8_t*)node)->size = size;
+    return node;
+}
+
+static void arena_free_small(uint8_t* ptr, uint32_t cls) {
+    alloc_free_node* node = (alloc_free_node*)(void*)ptr;
+    alloc_thread* t = alloc_thread_current();
+    if (t == NULL) {
+        node->next = NULL;
+        depot_put_chain(cls, node, node, 1);
+        return;
+    }
+    alloc_list* cache = &t->caches[cls - 1];
+    node->next = cache->head;
+    cache->head = node;
+    cache->count++;
+    if (cache->count <= ALLOC_CACHE_MAX) {
+        return;
+    }
+    // Spill a batch so one thread freeing what others allocated does not hoard blocks.
+    alloc_free_node* head = cache->head;
+    alloc_free_node* tail = head;
+    for (uint32_t i = 1; i < ALLOC_BATCH; i++) {
+        tail = tail->next;
+    }
+    cache->head = tail->next;
+    cache->count -= ALLOC_BATCH;
+    depot_put_chain(cls, head, tail, ALLOC_BATCH);
+}
+
+static void* arena_alloc_large(uint64_t size, uint64_t align) {
+    uint64_t pad = align > ALLOC_HEADER ? align : ALLOC_HEADER;
+    if (size > (uint64_t)SIZE_MAX - pad) {
+        return NULL;
+    }
+    void* raw = NULL;
+    if (align <= ALLOC_HEADER) {
+        raw = malloc((size_t)(pad + size));
+    } else if (posix_memalign(&raw, (size_t)align, (size_t)(pad + size)) != 0) {
+        raw = NULL;
+    }
+    if (raw == NULL) {
+        return NULL;
+    }
+    uint8_t* ptr = (uint8_t*)raw + pad;
+    alloc_header* h = block_header(ptr);
+    h->offset = (uint32_t)pad;
+    h->size_class = 0;
+    h->size = size;
+    return ptr;
+}
+
+static void arena_free(uint8_t* ptr) {
+    const alloc_header* h = block_header(ptr);
+    if (h->size_class != 0) {
+        arena_free_small(ptr, h->size_class);
+        return;
+    }
+    free(ptr - h->offset);
+}
+
+static void* arena_realloc(uint8_t* ptr, uint64_t new_size, uint64_t align) {
+    // The header's size is what rt_alloc counted; callers' old sizes are not trusted.
+    alloc_header* h = block_header(ptr);
+    uint64_t old_size = h->size;
+    uint32_t cls = size_class_for(new_size, align);
+    if (h->size_class != 0 && cls == h->size_class) {
+        h->size = new_size;
+        record_realloc(old_size, new_size);
+        return ptr;
+    }
+    if (h->size_class == 0 && cls == 0 && h->offset == ALLOC_HEADER && align <= ALLOC_HEADER &&
+        new_size <= (uint64_t)SIZE_MAX - ALLOC_HEADER) {
+        uint8_t* raw = (uint8_t*)realloc(ptr - ALLOC_HEADER, (size_t)(ALLOC_HEADER + new_size));
+        if (raw == NULL) {
+            return NULL;
+        }
+        uint8_t* next = raw + ALLOC_HEADER;
+        block_header(next)->size = new_size;
+        record_realloc(old_size, new_size);
+        return next;
+    }
+    uint64_t keep = min_u64(h->size, new_size);
+    void* next = rt_alloc(new_size, align);
+    if (next == NULL) {
+        return NULL;
+    }
+    rt_memcpy((uint8_t*)next, ptr, keep);
+    rt_free(ptr, old_size, align);
+    return next;
 }
 
 void* rt_alloc(uint64_t size, uint64_t align) {
     size = alloc_size(size);
     void* ptr = NULL;
+    if (alloc_mode_get() == ALLOC_MODE_ARENA) {
+        uint32_t cls = size_class_for(size, align);
+        ptr = cls != 0 ? arena_alloc_small(size, cls) : arena_alloc_large(size, align);
+        if (ptr != NULL) {
+            record_alloc(size);
+        }
+        return ptr;
+    }
     if (align <= sizeof(void*)) {
         ptr = malloc((size_t)size);
         if (ptr != NULL) {
@@ -75,10 +389,16 @@ void* rt_alloc(uint64_t size, uint64_t align) {
 
 void rt_free(uint8_t* ptr, uint64_t size, uint64_t align) {
     (void)align;
-    if (ptr != NULL) {
-        rt_array_forget_allocation(ptr);
-        record_free(size);
+    if (ptr == NULL) {
+        return;
+    }
+    rt_array_forget_allocation(ptr);
+    if (alloc_mode_get() == ALLOC_MODE_ARENA) {
+        record_free(block_header(ptr)->size);
+        arena_free(ptr);
+        return;
     }
+    record_free(size);
     free(ptr);
 }
 
@@ -87,14 +407,13 @@ void* rt_realloc(uint8_t* ptr, uint64_t old_size, uint64_t new_size, uint64_t al
         rt_free(ptr, old_size, align);
         return NULL;
     }
-    if (align <= sizeof(void*)) {
+    if (ptr != NULL && alloc_mode_get() == ALLOC_MODE_ARENA) {
+        return arena_realloc(ptr, new_size, align);
+    }
+    if (ptr != NULL && align <= sizeof(void*)) {
         void* next = realloc(ptr, (size_t)alloc_size(new_size));
         if (next != NULL) {
-            if (ptr == NULL) {
-                record_alloc(new_size);
-            } else {
-                record_realloc(old_size, new_size);
-            }
+            record_realloc(old_size, new_size);
         }
         return next;
     }
@@ -109,11 +428,41 @@ void* rt_realloc(uint8_t* ptr, uint64_t old_size, uint64_t new_size, uint64_t al
     return next;
 }
 
+void rt_heap_counts(uint64_t* alloc_count,
+                    uint64_t* free_count,
+                    uint64_t* live_blocks,
+                    uint64_t* live_bytes) {
+    uint64_t allocs = atomic_load_explicit(&heap_retired.alloc_count, memory_order_relaxed);
+    uint64_t frees = atomic_load_explicit(&heap_retired.free_count, memory_order_relaxed);
+    uint64_t blocks = atomic_load_explicit(&heap_retired.live_blocks, memory_order_relaxed);
+    uint64_t bytes = atomic_load_explicit(&heap_retired.live_bytes, memory_order_relaxed);
+    for (const rt_thread_block* b = rt_thread_blocks_first(&heap_threads); b != NULL; b = b->next) {
+        const alloc_thread* t = (const alloc_thread*)(const void*)b;
+        allocs += atomic_load_explicit(&t->counters.alloc_count, memory_order_relaxed);
+        frees += atomic_load_explicit(&t->counters.free_count, memory_order_relaxed);
+        blocks += atomic_load_explicit(&t->counters.live_blocks, memory_order_relaxed);
+        bytes += atomic_load_explicit(&t->counters.live_bytes, memory_order_relaxed);
+    }
+    if (alloc_count != NULL) {
+        *alloc_count = allocs;
+    }
+    if (free_count != NULL) {
+        *free_count = frees;
+    }
+    if (live_blocks != NULL) {
+        *live_blocks = blocks;
+    }
+    if (live_bytes != NULL) {
+        *live_bytes = bytes;
+    }
+}
+
 void* rt_heap_stats(void) {
-    uint64_t alloc_count = atomic_load_explicit(&heap_alloc_count, memory_order_relaxed);
-    uint64_t free_count = atomic_load_explicit(&heap_free_count, memory_order_relaxed);
-    uint64_t live_blocks = atomic_load_explicit(&heap_live_blocks, memory_order_relaxed);
-    uint64_t live_bytes = atomic_load_explicit(&heap_live_bytes, memory_order_relaxed);
+    uint64_t alloc_count = 0;
+    uint64_t free_count = 0;
+    uint64_t live_blocks = 0;
+    uint64_t live_bytes = 0;
+    rt_heap_counts(&alloc_count, &free_count, &live_blocks, &live_bytes);
 
     SurgeHeapStats* stats = (SurgeHeapStats*)rt_alloc((uint64_t)sizeof(SurgeHeapStats),
                                                       (uint64_t) _Alignof(SurgeHeapStats));
@@ -1,6 +1,8 @@
 #include "rt.h"
 
+#include <pthread.h>
 #include <stdalign.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -13,14 +15,45 @@ typedef struct SurgeArrayHeader {
     void* data;
 } SurgeArrayHeader;
 
+// View registry: which slice views alias which base array.
+//
+// Links are indexed twice: by view header, so slicing a view and freeing it find the link
+// directly, and by base header, whose entry chains that base's views so sync and free walk
+// only those. rt_free asks the registry about every pointer it releases, so an empty
+// registry is answered from array_view_links without taking the lock. The lock makes the
+// registry safe for slices taken and freed on different executor workers.
+//
+// Links and base entries are recycled through free lists rather than freed, because
+// rt_free re-enters rt_array_forget_allocation and would deadlock on the held lock.
+
 typedef struct SurgeArrayViewLink {
     SurgeArrayHeader* base;
     SurgeArrayHeader* view;
     uint64_t byte_offset;
-    struct SurgeArrayViewLink* next;
+    struct SurgeArrayViewLink* bucket_next;
+    struct SurgeArrayViewLink* sibling_prev;
+    struct SurgeArrayViewLink* sibling_next;
 } SurgeArrayViewLink;
 
-static SurgeArrayViewLink* array_views = NULL;
+typedef struct SurgeArrayViewBase {
+    SurgeArrayHeader* base;
+    SurgeArrayViewLink* views;
+    struct SurgeArrayViewBase* bucket_next;
+} SurgeArrayViewBase;
+
+typedef struct SurgeArrayViewRegistry {
+    SurgeArrayViewLink** view_buckets;
+    SurgeArrayViewBase** base_buckets;
+    size_t buckets_cap; // shared by both tables, power of two
+    size_t links_len;
+    size_t bases_len;
+    SurgeArrayViewLink* free_links;
+    SurgeArrayViewBase* free_bases;
+} SurgeArrayViewRegistry;
+
+static pthread_mutex_t array_views_lock = PTHREAD_MUTEX_INITIALIZER;
+static SurgeArrayViewRegistry array_views;
+static _Atomic size_t array_view_links;
 
 static void array_panic(const char* msg) {
     rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
@@ -48,69 +81,242 @@ bool rt_array_is_view(const void* header) {
     return array_is_view((const SurgeArrayHeader*)header);
 }
 
-static const SurgeArrayViewLink* array_find_view(const SurgeArrayHeader* header) {
-    for (const SurgeArrayViewLink* link = array_views; link != NULL; link = link->next) {
-        if (link->view == header) {
-            return link;
+static size_t array_ptr_bucket(const void* ptr, size_t cap) {
+    uint64_t z = (uint64_t)(uintptr_t)ptr;
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return (size_t)((z ^ (z >> 31)) & (uint64_t)(cap - 1));
+}
+
+static SurgeArrayViewLink** array_view_slot(const SurgeArrayHeader* view) {
+    SurgeArrayViewLink** slot =
+        &array_views.view_buckets[array_ptr_bucket(view, array_views.buckets_cap)];
+    while (*slot != NULL && (*slot)->view != view) {
+        slot = &(*slot)->bucket_next;
+    }
+    return slot;
+}
+
+static SurgeArrayViewBase** array_base_slot(const SurgeArrayHeader* base) {
+    SurgeArrayViewBase** slot =
+        &array_views.base_buckets[array_ptr_bucket(base, array_views.buckets_cap)];
+    while (*slot != NULL && (*slot)->base != base) {
+        slot = &(*slot)->bucket_next;
+    }
+    return slot;
+}
+
+static SurgeArrayViewLink* array_find_view(const SurgeArrayHeader* header) {
+    // Caller holds array_views_lock.
+    if (array_views.buckets_cap == 0) {
+        return NULL;
+    }
+    return *array_view_slot(header);
+}
+
+static SurgeArrayViewBase* array_find_base(const SurgeArrayHeader* header) {
+    // Caller holds array_views_lock.
+    if (array_views.buckets_cap == 0) {
+        return NULL;
+    }
+    return *array_base_slot(header);
+}
+
+static bool array_views_grow(void** old_views, void** old_bases, size_t* old_cap) {
+    // Caller holds array_views_lock and frees the tables handed back in old_* after
+    // unlocking: the replaced ones on success, or whichever new one was allocated when the
+    // other was not. rt_free takes array_views_lock, so neither can be freed here.
+    size_t next_cap = array_views.buckets_cap == 0 ? 64 : array_views.buckets_cap * 2;
+    if (next_cap > SIZE_MAX / sizeof(void*)) {
+        return false;
+    }
+    uint64_t size = (uint64_t)(next_cap * sizeof(void*));
+    SurgeArrayViewLink** views =
+        (SurgeArrayViewLink**)rt_alloc(size, (uint64_t)alignof(SurgeArrayViewLink*));
+    SurgeArrayViewBase** bases =
+        (SurgeArrayViewBase**)rt_alloc(size, (uint64_t)alignof(SurgeArrayViewBase*));
+    if (views == NULL || bases == NULL) {
+        *old_views = views;
+        *old_bases = bases;
+        *old_cap = next_cap;
+        return false;
+    }
+    memset(views, 0, (size_t)size);
+    memset(bases, 0, (size_t)size);
+    for (size_t i = 0; i < array_views.buckets_cap; i++) {
+        SurgeArrayViewLink* link = array_views.view_buckets[i];
+        while (link != NULL) {
+            SurgeArrayViewLink* follow = link->bucket_next;
+            size_t idx = array_ptr_bucket(link->view, next_cap);
+            link->bucket_next = views[idx];
+            views[idx] = link;
+            link = follow;
+        }
+        SurgeArrayViewBase* entry = array_views.base_buckets[i];
+        while (entry != NULL) {
+            SurgeArrayViewBase* follow = entry->bucket_next;
+            size_t idx = array_ptr_bucket(entry->base, next_cap);
+            entry->bucket_next = bases[idx];
+            bases[idx] = entry;
+            entry = follow;
         }
     }
-    return NULL;
+    *old_views = array_views.view_buckets;
+    *old_bases = array_views.base_buckets;
+    *old_cap = array_views.buckets_cap;
+    array_views.view_buckets = views;
+    array_views.base_buckets = bases;
+    array_views.buckets_cap = next_cap;
+    return true;
+}
+
+static void array_release_link(SurgeArrayViewBase* entry, SurgeArrayViewLink* link) {
+    // Caller holds array_views_lock and has already unhooked link from its view bucket.
+    if (link->sibling_prev != NULL) {
+        link->sibling_prev->sibling_next = link->sibling_next;
+    } else {
+        entry->views = link->sibling_next;
+    }
+    if (link->sibling_next != NULL) {
+        link->sibling_next->sibling_prev = link->sibling_prev;
+    }
+    link->bucket_next = array_views.free_links;
+    array_views.free_links = link;
+    array_views.links_len--;
+    atomic_store_explicit(&array_view_links, array_views.links_len, memory_order_relaxed);
+    if (entry->views == NULL) {
+        SurgeArrayViewBase** slot = array_base_slot(entry->base);
+        *slot = entry->bucket_next;
+        entry->bucket_next = array_views.free_bases;
+        array_views.free_bases = entry;
+        array_views.bases_len--;
+    }
 }
 
 static SurgeArrayHeader* array_base_for_slice(SurgeArrayHeader* header, uint64_t* base_offset) {
     *base_offset = 0;
+    pthread_mutex_lock(&array_views_lock);
     const SurgeArrayViewLink* link = array_find_view(header);
-    if (link == NULL) {
-        return header;
+    SurgeArrayHeader* base = header;
+    if (link != NULL) {
+        *base_offset = link->byte_offset;
+        base = link->base;
     }
-    *base_offset = link->byte_offset;
-    return link->base;
+    pthread_mutex_unlock(&array_views_lock);
+    return base;
 }
 
 static void
 array_register_view(SurgeArrayHeader* base, SurgeArrayHeader* view, uint64_t byte_offset) {
-    SurgeArrayViewLink* link = (SurgeArrayViewLink*)rt_alloc((uint64_t)sizeof(SurgeArrayViewLink),
-                                                             (uint64_t)alignof(SurgeArrayViewLink));
+    void* old_views = NULL;
+    void* old_bases = NULL;
+    size_t old_cap = 0;
+    bool ok = true;
+    pthread_mutex_lock(&array_views_lock);
+    if (array_views.links_len >= array_views.buckets_cap) {
+        ok = array_views_grow(&old_views, &old_bases, &old_cap);
+    }
+    SurgeArrayViewBase* entry = ok ? array_find_base(base) : NULL;
+    if (ok && entry == NULL) {
+        entry = array_views.free_bases;
+        if (entry != NULL) {
+            array_views.free_bases = entry->bucket_next;
+        } else {
+            entry = (SurgeArrayViewBase*)rt_alloc((uint64_t)sizeof(SurgeArrayViewBase),
+                                                  (uint64_t)alignof(SurgeArrayViewBase));
+        }
+        if (entry != NULL) {
+            SurgeArrayViewBase** slot =
+                &array_views.base_buckets[array_ptr_bucket(base, array_views.buckets_cap)];
+            entry->base = base;
+            entry->views = NULL;
+            entry->bucket_next = *slot;
+            *slot = entry;
+            array_views.bases_len++;
+        }
+    }
+    SurgeArrayViewLink* link = NULL;
+    if (entry != NULL) {
+        link = array_views.free_links;
+        if (link != NULL) {
+            array_views.free_links = link->bucket_next;
+        } else {
+            link = (SurgeArrayViewLink*)rt_alloc((uint64_t)sizeof(SurgeArrayViewLink),
+                                                 (uint64_t)alignof(SurgeArrayViewLink));
+        }
+    }
+    if (link != NULL) {
+        SurgeArrayViewLink** slot =
+            &array_views.view_buckets[array_ptr_bucket(view, array_views.buckets_cap)];
+        link->base = base;
+        link->view = view;
+        link->byte_offset = byte_offset;
+        link->bucket_next = *slot;
+        *slot = link;
+        link->sibling_prev = NULL;
+        link->sibling_next = entry->views;
+        if (entry->views != NULL) {
+            entry->views->sibling_prev = link;
+        }
+        entry->views = link;
+        array_views.links_len++;
+        atomic_store_explicit(&array_view_links, array_views.links_len, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&array_views_lock);
+    if (old_views != NULL || old_bases != NULL) {
+        rt_free((uint8_t*)old_views,
+                (uint64_t)(old_cap * sizeof(void*)),
+                (uint64_t)alignof(SurgeArrayViewLink*));
+        rt_free((uint8_t*)old_bases,
+                (uint64_t)(old_cap * sizeof(void*)),
+                (uint64_t)alignof(SurgeArrayViewBase*));
+    }
     if (link == NULL) {
         array_panic("array allocation failed");
-        return;
     }
-    link->base = base;
-    link->view = view;
-    link->byte_offset = byte_offset;
-    link->next = array_views;
-    array_views = link;
 }
 
 void rt_array_forget_allocation(const void* ptr) {
-    if (ptr == NULL) {
+    if (ptr == NULL || atomic_load_explicit(&array_view_links, memory_order_relaxed) == 0) {
         return;
     }
     const SurgeArrayHeader* header = (const SurgeArrayHeader*)ptr;
-    SurgeArrayViewLink** cursor = &array_views;
-    while (*cursor != NULL) {
-        SurgeArrayViewLink* link = *cursor;
-        if (link->view == header || link->base == header) {
-            *cursor = link->next;
-            rt_free((uint8_t*)link,
-                    (uint64_t)sizeof(SurgeArrayViewLink),
-                    (uint64_t)alignof(SurgeArrayViewLink));
-            continue;
+    pthread_mutex_lock(&array_views_lock);
+    if (array_views.buckets_cap != 0) {
+        SurgeArrayViewLink** slot = array_view_slot(header);
+        SurgeArrayViewLink* link = *slot;
+        if (link != NULL) {
+            *slot = link->bucket_next;
+            array_release_link(array_find_base(link->base), link);
+        }
+        SurgeArrayViewBase* entry = array_find_base(header);
+        while (entry != NULL && entry->views != NULL) {
+            // Releasing the last view also releases entry itself.
+            link = entry->views;
+            bool last = link->sibling_next == NULL;
+            slot = array_view_slot(link->view);
+            *slot = link->bucket_next;
+            array_release_link(entry, link);
+            if (last) {
+                break;
+            }
         }
-        cursor = &link->next;
     }
+    pthread_mutex_unlock(&array_views_lock);
 }
 
 void rt_array_sync_views(void* array_header) {
     SurgeArrayHeader* base = (SurgeArrayHeader*)array_header;
-    if (base == NULL) {
+    if (base == NULL || atomic_load_explicit(&array_view_links, memory_order_relaxed) == 0) {
         return;
     }
-    for (const SurgeArrayViewLink* link = array_views; link != NULL; link = link->next) {
-        if (link->base == base && link->view != NULL) {
-            link->view->data = base->data == NULL ? NULL : (uint8_t*)base->data + link->byte_offset;
-        }
+    pthread_mutex_lock(&array_views_lock);
+    const SurgeArrayViewBase* entry = array_find_base(base);
+    for (const SurgeArrayViewLink* link = entry == NULL ? NULL : entry->views; link != NULL;
+         link = link->sibling_next) {
+        link->view->data = base->data == NULL ? NULL : (uint8_t*)base->data + link->byte_offset;
     }
+    pthread_mutex_unlock(&array_views_lock);
 }
 
 static int64_t normalize_range_index(int64_t n, int64_t length) {
@@ -354,6 +560,41 @@ void rt_byte_array_append_range(void* dst_slot,
     rt_array_append_raw_bytes(dst_slot, (const uint8_t*)src->data + start, len);
 }
 
+void rt_byte_array_reserve_spare(void* array_slot, uint64_t spare) {
+    if (array_slot == NULL) {
+        array_panic("byte array reserve received null pointer");
+        return;
+    }
+
+    SurgeArrayHeader* header = *(SurgeArrayHeader**)array_slot;
+    if (header == NULL) {
+        array_panic("byte array reserve received null array");
+        return;
+    }
+    if (array_is_view(header)) {
+        array_panic("array view is not resizable");
+        return;
+    }
+    if (spare > UINT64_MAX - header->len) {
+        array_panic("array length out of range");
+        return;
+    }
+    uint64_t min_cap = header->len + spare;
+    if (min_cap <= header->cap) {
+        return;
+    }
+    uint64_t new_cap = array_grow_cap(header->cap, min_cap);
+    void* data =
+        rt_realloc((uint8_t*)header->data, header->cap, new_cap, (uint64_t)alignof(uint8_t));
+    if (data == NULL) {
+        array_panic("array allocation failed");
+        return;
+    }
+    header->data = data;
+    header->cap = new_cap;
+    rt_array_sync_views(header);
+}
+
 void rt_byte_array_drop_prefix(void* array_slot, uint64_t count) {
     if (count == 0) {
         return;
@@ -390,6 +631,58 @@ void rt_byte_array_drop_prefix(void* array_slot, uint64_t count) {
     header->len = new_len;
 }
 
+// Queue callers keep a start offset into the array and consume by moving it, so the dead
+// prefix is only reclaimed here, once the tail cannot take spare more bytes. The live bytes
+// move down when the dead prefix is at least as large as them, so each move is paid for by
+// bytes already consumed; otherwise the live bytes are copied once into a fresh, larger
+// buffer and the dead prefix is left behind with the old one.
+uint64_t rt_byte_array_reserve_tail(void* array_slot, uint64_t start, uint64_t spare) {
+    if (array_slot == NULL) {
+        array_panic("byte array reserve tail received null pointer");
+        return 0;
+    }
+
+    SurgeArrayHeader* header = *(SurgeArrayHeader**)array_slot;
+    if (header == NULL) {
+        array_panic("byte array reserve tail received null array");
+        return 0;
+    }
+    if (array_is_view(header)) {
+        array_panic("array view is not resizable");
+        return 0;
+    }
+    if (start > header->len) {
+        array_panic("byte array reserve tail start out of range");
+        return 0;
+    }
+    if (spare <= header->cap - header->len) {
+        return 0;
+    }
+    uint64_t live = header->len - start;
+    if (start >= live) {
+        rt_byte_array_drop_prefix(array_slot, start);
+        rt_byte_array_reserve_spare(array_slot, spare);
+        return start;
+    }
+    if (spare > UINT64_MAX - live) {
+        array_panic("array length out of range");
+        return 0;
+    }
+    uint64_t new_cap = array_grow_cap(header->cap, live + spare);
+    uint8_t* data = (uint8_t*)rt_alloc(new_cap, (uint64_t)alignof(uint8_t));
+    if (data == NULL) {
+        array_panic("array allocation failed");
+        return 0;
+    }
+    rt_memcpy(data, (const uint8_t*)header->data + start, live);
+    rt_free((uint8_t*)header->data, header->cap, (uint64_t)alignof(uint8_t));
+    header->data = data;
+    header->cap = new_cap;
+    header->len = live;
+    rt_array_sync_views(header);
+    return start;
+}
+
 bool rt_byte_parse_uint64_token(
     const void* array, uint64_t start, uint64_t end, uint64_t* value_out, uint64_t* next_out) {
     if (value_out != NULL) {
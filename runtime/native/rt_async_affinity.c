@@ -0,0 +1,109 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
+#include "rt_async_internal.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Optional CPU pinning for executor threads.
+//
+// SURGE_WORKER_AFFINITY=1 pins worker i to the i-th CPU the process was allowed to run on
+// at startup, wrapping around when there are more workers than CPUs. Compensation workers
+// share a worker id and therefore its CPU; the worker they stand in for is blocked.
+// SURGE_IO_CPU=<n> pins the I/O thread to the n-th allowed CPU. Pinning is a hint: it is
+// skipped on platforms without thread affinity and a failed call leaves the thread
+// unpinned.
+
+static pthread_once_t affinity_once = PTHREAD_ONCE_INIT;
+static int affinity_workers;
+static int64_t affinity_io_cpu = -1;
+
+#if defined(__linux__)
+// Snapshot of the process mask taken before any executor thread pins itself; threads
+// created later by a pinned worker would otherwise inherit a single-CPU mask.
+static cpu_set_t affinity_allowed;
+static uint32_t affinity_allowed_count;
+#endif
+
+static int affinity_env_flag(const char* name) {
+    const char* value = getenv(name);
+    return value != NULL && value[0] != '\0' && !(value[0] == '0' && value[1] == '\0');
+}
+
+static int64_t affinity_env_cpu(const char* name) {
+    const char* value = getenv(name);
+    if (value == NULL || value[0] == '\0') {
+        return -1;
+    }
+    errno = 0;
+    char* end = NULL;
+    long parsed = strtol(value, &end, 10);
+    if (end == value || errno != 0 || parsed < 0) {
+        return -1;
+    }
+    return (int64_t)parsed;
+}
+
+static void affinity_init_once(void) {
+    affinity_workers = affinity_env_flag("SURGE_WORKER_AFFINITY");
+    affinity_io_cpu = affinity_env_cpu("SURGE_IO_CPU");
+#if defined(__linux__)
+    CPU_ZERO(&affinity_allowed);
+    if (sched_getaffinity(0, sizeof(affinity_allowed), &affinity_allowed) == 0) {
+        int count = CPU_COUNT(&affinity_allowed);
+        affinity_allowed_count = count > 0 ? (uint32_t)count : 0;
+    }
+#endif
+}
+
+void rt_affinity_init(void) {
+    pthread_once(&affinity_once, affinity_init_once);
+}
+
+static int affinity_pin_nth(uint64_t nth) {
+#if defined(__linux__)
+    if (affinity_allowed_count == 0) {
+        return 0;
+    }
+    uint64_t want = nth % affinity_allowed_count;
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &affinity_allowed)) {
+            continue;
+        }
+        if (want > 0) {
+            want--;
+            continue;
+        }
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        return sched_setaffinity(0, sizeof(one), &one) == 0;
+    }
+    return 0;
+#else
+    (void)nth;
+    return 0;
+#endif
+}
+
+int rt_affinity_pin_worker(uint32_t worker_id) {
+    rt_affinity_init();
+    if (!affinity_workers) {
+        return 0;
+    }
+    return affinity_pin_nth(worker_id);
+}
+
+int rt_affinity_pin_io(void) {
+    rt_affinity_init();
+    if (affinity_io_cpu < 0) {
+        return 0;
+    }
+    return affinity_pin_nth((uint64_t)affinity_io_cpu);
+}
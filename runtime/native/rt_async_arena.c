@@ -0,0 +1,125 @@
+#include "rt_async_internal.h"
+
+// Per-task frame arena.
+//
+// A generated poll function rebuilds its state frame, the __AsyncState struct and its
+// payload union, at every suspension. The frame is reachable only through task->state,
+// and the poll that resumes from it copies every saved local out before it can build the
+// next one. Poll functions therefore bump frames out of the task's own arena: the first
+// frame allocation after __task_state rewinds the arena, so a task that keeps suspending
+// reuses one chunk, and free_task releases the arena wholesale. The constructor's initial
+// frame is built before the task exists and stays on rt_alloc.
+
+#define ARENA_MIN_CHUNK 256u
+#define ARENA_CHUNK_ALIGN 16u
+
+struct rt_arena_chunk {
+    rt_arena_chunk* next;
+    size_t cap;
+};
+
+// Chunk data starts here so it is ARENA_CHUNK_ALIGN-aligned like the chunk itself.
+#define ARENA_HEADER_SIZE \
+    ((sizeof(rt_arena_chunk) + ARENA_CHUNK_ALIGN - 1) & ~(size_t)(ARENA_CHUNK_ALIGN - 1))
+
+static uint8_t* arena_chunk_data(rt_arena_chunk* chunk) {
+    return (uint8_t*)chunk + ARENA_HEADER_SIZE;
+}
+
+static void arena_chunk_free(rt_arena_chunk* chunk) {
+    rt_free((uint8_t*)chunk, (uint64_t)(ARENA_HEADER_SIZE + chunk->cap), ARENA_CHUNK_ALIGN);
+}
+
+static void* arena_bump(rt_arena* arena, size_t size, size_t align) {
+    rt_arena_chunk* chunk = arena->head;
+    if (chunk == NULL) {
+        return NULL;
+    }
+    uintptr_t base = (uintptr_t)arena_chunk_data(chunk);
+    uintptr_t at = (base + arena->used + (align - 1)) & ~(uintptr_t)(align - 1);
+    size_t offset = (size_t)(at - base);
+    if (offset > chunk->cap || size > chunk->cap - offset) {
+        return NULL;
+    }
+    arena->used = offset + size;
+    return arena_chunk_data(chunk) + offset;
+}
+
+void* rt_arena_alloc(rt_arena* arena, size_t size, size_t align) {
+    if (arena == NULL) {
+        return NULL;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    if (align == 0 || (align & (align - 1)) != 0) {
+        align = 1;
+    }
+    void* mem = arena_bump(arena, size, align);
+    if (mem != NULL) {
+        return mem;
+    }
+    // Grow geometrically so a task whose frames outgrow the chunk settles after a few
+    // rewinds; the old head stays linked because it may still hold live allocations.
+    if (size > SIZE_MAX / 2 - ARENA_HEADER_SIZE - align) {
+        panic_msg("async: frame arena allocation failed");
+        return NULL;
+    }
+    size_t cap = arena->head != NULL ? arena->head->cap * 2 : ARENA_MIN_CHUNK;
+    if (cap < size + align) {
+        cap = size + align;
+    }
+    rt_arena_chunk* chunk =
+        (rt_arena_chunk*)rt_alloc((uint64_t)(ARENA_HEADER_SIZE + cap), ARENA_CHUNK_ALIGN);
+    if (chunk == NULL) {
+        panic_msg("async: frame arena allocation failed");
+        return NULL;
+    }
+    chunk->next = arena->head;
+    chunk->cap = cap;
+    arena->head = chunk;
+    arena->used = 0;
+    return arena_bump(arena, size, align);
+}
+
+void rt_arena_rewind(rt_arena* arena) {
+    // Keeps the head chunk, the largest one, and frees everything behind it.
+    if (arena == NULL || arena->head == NULL) {
+        return;
+    }
+    rt_arena_chunk* chunk = arena->head->next;
+    arena->head->next = NULL;
+    while (chunk != NULL) {
+        rt_arena_chunk* next = chunk->next;
+        arena_chunk_free(chunk);
+        chunk = next;
+    }
+    arena->used = 0;
+}
+
+void rt_arena_release(rt_arena* arena) {
+    if (arena == NULL) {
+        return;
+    }
+    rt_arena_chunk* chunk = arena->head;
+    while (chunk != NULL) {
+        rt_arena_chunk* next = chunk->next;
+        arena_chunk_free(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->used = 0;
+}
+
+void* rt_task_frame_alloc(uint64_t size, uint64_t align) {
+    // Only the thread polling the task touches its arena until free_task, so no lock.
+    rt_task* task = rt_current_task();
+    if (task == NULL) {
+        return rt_alloc(size, align);
+    }
+    if (task->frame_rewind) {
+        task->frame_rewind = 0;
+        rt_arena_rewind(&task->frame_arena);
+    }
+    return rt_arena_alloc(&task->frame_arena, (size_t)size, (size_t)align);
+}
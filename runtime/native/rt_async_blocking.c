@@ -1,8 +1,16 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
 #include "rt_async_internal.h"
 
+#include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 
-static void blocking_job_release(rt_blocking_job* job) {
+static void blocking_job_release(rt_executor* ex, rt_blocking_job* job) {
     if (job == NULL) {
         return;
     }
@@ -17,39 +25,165 @@ static void blocking_job_release(rt_blocking_job* job) {
     if (job->state != NULL && job->state_size > 0) {
         rt_free((uint8_t*)job->state, job->state_size, job->state_align);
     }
-    rt_free((uint8_t*)job, sizeof(rt_blocking_job), _Alignof(rt_blocking_job));
+    blocking_job_free(ex, job);
 }
 
 static void blocking_queue_push(rt_executor* ex, rt_blocking_job* job) {
+    // Caller holds ex->lock, which makes it the queue's only pusher.
     if (ex == NULL || job == NULL) {
         return;
     }
+    job->submitted_ns = rt_monotonic_now();
+    (void)deque_push(&ex->blocking_queue,
+                     (uint64_t)(uintptr_t)job,
+                     "async: blocking queue overflow",
+                     "async: blocking queue allocation failed");
+    // Pairs with the fence in blocking_wait_for_job and blocking_monitor_main: either the
+    // sleeper sees this job when it re-checks the queue, or this sees it sleeping.
+    atomic_thread_fence(memory_order_seq_cst);
+    uint32_t idle = atomic_load_explicit(&ex->blocking_idle, memory_order_relaxed);
+    uint8_t monitor = atomic_load_explicit(&ex->blocking_monitor_waiting, memory_order_relaxed);
+    if (idle == 0 && monitor == 0) {
+        return;
+    }
     pthread_mutex_lock(&ex->blocking_lock);
-    job->next = NULL;
-    if (ex->blocking_tail != NULL) {
-        ex->blocking_tail->next = job;
+    if (idle > 0) {
+        pthread_cond_signal(&ex->blocking_cv);
     } else {
-        ex->blocking_head = job;
+        pthread_cond_signal(&ex->blocking_monitor_cv);
     }
-    ex->blocking_tail = job;
-    pthread_cond_signal(&ex->blocking_cv);
     pthread_mutex_unlock(&ex->blocking_lock);
 }
 
-static rt_blocking_job* blocking_queue_pop(rt_executor* ex) {
-    if (ex == NULL) {
+static rt_blocking_job* blocking_queue_take(rt_executor* ex) {
+    uint64_t bits = 0;
+    if (!deque_steal(&ex->blocking_queue, &bits)) {
         return NULL;
     }
-    rt_blocking_job* job = ex->blocking_head;
-    if (job == NULL) {
-        return NULL;
+    (void)atomic_fetch_add_explicit(&ex->blocking_taken, 1, memory_order_relaxed);
+    // The monitor sleeps while some thread is idle. If that was this one and jobs are
+    // still queued behind the one it took, no submit may come along to wake the monitor.
+    if (atomic_load_explicit(&ex->blocking_monitor_waiting, memory_order_relaxed) != 0 &&
+        atomic_load_explicit(&ex->blocking_idle, memory_order_relaxed) == 0 &&
+        deque_len(&ex->blocking_queue) > 0) {
+        pthread_mutex_lock(&ex->blocking_lock);
+        pthread_cond_signal(&ex->blocking_monitor_cv);
+        pthread_mutex_unlock(&ex->blocking_lock);
+    }
+    return (rt_blocking_job*)(uintptr_t)bits;
+}
+
+static size_t latency_hist_bucket(int64_t ns) {
+    uint64_t us = ns > 0 ? (uint64_t)ns / 1000U : 0;
+    size_t bucket = 0;
+    while (us > 0 && bucket + 1 < RT_LATENCY_HIST_BUCKETS) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void rt_latency_hist_record(atomic_u64* hist, int64_t ns) {
+    (void)atomic_fetch_add_explicit(&hist[latency_hist_bucket(ns)], 1, memory_order_relaxed);
+}
+
+// Absolute CLOCK_REALTIME deadline for pthread_cond_timedwait, ns from now.
+static struct timespec blocking_deadline(uint64_t ns) {
+    struct timespec ts = {0};
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t nsec = (uint64_t)ts.tv_nsec + ns % 1000000000U;
+    ts.tv_sec += (time_t)(ns / 1000000000U + nsec / 1000000000U);
+    ts.tv_nsec = (long)(nsec % 1000000000U); // NOLINT(runtime/int)
+    return ts;
+}
+
+static void* rt_blocking_worker_main(void* arg);
+
+static int blocking_spawn_locked(rt_executor* ex) {
+    // Caller holds blocking_lock.
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, rt_blocking_worker_main, ex) != 0) {
+        return 0;
     }
-    ex->blocking_head = job->next;
-    if (ex->blocking_head == NULL) {
-        ex->blocking_tail = NULL;
+    (void)pthread_detach(thread);
+    ex->blocking_live++;
+    if (ex->blocking_live > ex->blocking_peak) {
+        ex->blocking_peak = ex->blocking_live;
     }
-    job->next = NULL;
-    return job;
+    (void)atomic_fetch_add_explicit(&ex->blocking_spawned, 1, memory_order_relaxed);
+    return 1;
+}
+
+static int blocking_wait_for_job(rt_executor* ex) {
+    // Sleeps until a job is queued. Returns 0 when this thread should exit: the pool is
+    // shutting down, or it sat idle for blocking_idle_ns above the core size.
+    int keep = 1;
+    pthread_mutex_lock(&ex->blocking_lock);
+    (void)atomic_fetch_add_explicit(&ex->blocking_idle, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    struct timespec deadline = blocking_deadline(ex->blocking_idle_ns);
+    while (deque_len(&ex->blocking_queue) == 0) {
+        if (ex->blocking_shutdown) {
+            keep = 0;
+            break;
+        }
+        int rc = pthread_cond_timedwait(&ex->blocking_cv, &ex->blocking_lock, &deadline);
+        if (rc == ETIMEDOUT && deque_len(&ex->blocking_queue) == 0) {
+            if (ex->blocking_live > ex->blocking_count) {
+                keep = 0;
+                break;
+            }
+            deadline = blocking_deadline(ex->blocking_idle_ns);
+        }
+    }
+    (void)atomic_fetch_sub_explicit(&ex->blocking_idle, 1, memory_order_relaxed);
+    if (!keep) {
+        ex->blocking_live--;
+        (void)atomic_fetch_add_explicit(&ex->blocking_retired, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&ex->blocking_lock);
+    return keep;
+}
+
+static void* rt_blocking_monitor_main(void* arg) {
+    // Grows the pool when queued jobs stop moving: if the queue stays non-empty with no
+    // idle thread and nothing taken for blocking_grow_ns, every thread is stuck in a slow
+    // call and the oldest job has waited at least that long.
+    rt_executor* ex = (rt_executor*)arg;
+    pthread_mutex_lock(&ex->blocking_lock);
+    uint64_t stall_taken = 0;
+    int64_t stall_start = -1;
+    while (!ex->blocking_shutdown) {
+        if (ex->blocking_live >= ex->blocking_max ||
+            atomic_load_explicit(&ex->blocking_idle, memory_order_relaxed) > 0 ||
+            deque_len(&ex->blocking_queue) == 0) {
+            atomic_store_explicit(&ex->blocking_monitor_waiting, 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            if (ex->blocking_live >= ex->blocking_max ||
+                atomic_load_explicit(&ex->blocking_idle, memory_order_relaxed) > 0 ||
+                deque_len(&ex->blocking_queue) == 0) {
+                pthread_cond_wait(&ex->blocking_monitor_cv, &ex->blocking_lock);
+            }
+            atomic_store_explicit(&ex->blocking_monitor_waiting, 0, memory_order_relaxed);
+            stall_start = -1;
+            continue;
+        }
+        uint64_t taken = atomic_load_explicit(&ex->blocking_taken, memory_order_relaxed);
+        int64_t now = rt_monotonic_now();
+        if (stall_start < 0 || taken != stall_taken) {
+            stall_taken = taken;
+            stall_start = now;
+        } else if ((uint64_t)(now - stall_start) >= ex->blocking_grow_ns) {
+            (void)blocking_spawn_locked(ex);
+            stall_start = -1;
+            continue;
+        }
+        uint64_t left = ex->blocking_grow_ns - (uint64_t)(now - stall_start);
+        struct timespec deadline = blocking_deadline(left);
+        (void)pthread_cond_timedwait(&ex->blocking_monitor_cv, &ex->blocking_lock, &deadline);
+    }
+    pthread_mutex_unlock(&ex->blocking_lock);
+    return NULL;
 }
 
 static void* rt_blocking_worker_main(void* arg) {
@@ -58,19 +192,15 @@ static void* rt_blocking_worker_main(void* arg) {
         return NULL;
     }
     for (;;) {
-        pthread_mutex_lock(&ex->blocking_lock);
-        while (ex->blocking_head == NULL && !ex->blocking_shutdown) {
-            pthread_cond_wait(&ex->blocking_cv, &ex->blocking_lock);
-        }
-        if (ex->blocking_shutdown && ex->blocking_head == NULL) {
-            pthread_mutex_unlock(&ex->blocking_lock);
-            return NULL;
-        }
-        rt_blocking_job* job = blocking_queue_pop(ex);
-        pthread_mutex_unlock(&ex->blocking_lock);
+        rt_blocking_job* job = blocking_queue_take(ex);
         if (job == NULL) {
+            if (!blocking_wait_for_job(ex)) {
+                return NULL;
+            }
             continue;
         }
+        int64_t started_ns = rt_monotonic_now();
+        rt_latency_hist_record(ex->blocking_wait_hist, started_ns - job->submitted_ns);
         rt_async_debug_printf("async blocking pop task=%llu fn=%llu state=%p status=%u\n",
                               (unsigned long long)job->task_id,
                               (unsigned long long)job->fn_id,
@@ -82,7 +212,7 @@ static void* rt_blocking_worker_main(void* arg) {
             rt_async_debug_printf("async blocking cancelled task=%llu fn=%llu\n",
                                   (unsigned long long)job->task_id,
                                   (unsigned long long)job->fn_id);
-            blocking_job_release(job);
+            blocking_job_release(ex, job);
             continue;
         }
 
@@ -96,6 +226,7 @@ static void* rt_blocking_worker_main(void* arg) {
                               (unsigned long long)job->task_id,
                               (unsigned long long)job->fn_id,
                               (unsigned long long)result);
+        rt_latency_hist_record(ex->blocking_run_hist, rt_monotonic_now() - started_ns);
         (void)atomic_fetch_sub_explicit(&ex->blocking_running, 1, memory_order_relaxed);
         (void)atomic_fetch_add_explicit(&ex->blocking_completed, 1, memory_order_relaxed);
 
@@ -110,7 +241,7 @@ static void* rt_blocking_worker_main(void* arg) {
             wake_key_all(ex, blocking_key(job->task_id));
             rt_unlock(ex);
         }
-        blocking_job_release(job);
+        blocking_job_release(ex, job);
     }
 }
 
@@ -120,8 +251,7 @@ void rt_blocking_init(rt_executor* ex) {
     }
     pthread_mutex_init(&ex->blocking_lock, NULL);
     pthread_cond_init(&ex->blocking_cv, NULL);
-    ex->blocking_head = NULL;
-    ex->blocking_tail = NULL;
+    pthread_cond_init(&ex->blocking_monitor_cv, NULL);
     ex->blocking_shutdown = 0;
     atomic_store_explicit(&ex->blocking_running, 0, memory_order_relaxed);
     atomic_store_explicit(&ex->blocking_submitted, 0, memory_order_relaxed);
@@ -133,23 +263,102 @@ void rt_blocking_init(rt_executor* ex) {
         count = 1;
         ex->blocking_count = count;
     }
-    pthread_t* threads =
-        (pthread_t*)rt_alloc((uint64_t)count * (uint64_t)sizeof(pthread_t), _Alignof(pthread_t));
-    if (threads == NULL) {
-        panic_msg("async: blocking worker allocation failed");
-        return;
+    if (ex->blocking_max < count) {
+        ex->blocking_max = count;
     }
-    ex->blocking_workers = threads;
+    pthread_mutex_lock(&ex->blocking_lock);
     for (uint32_t i = 0; i < count; i++) {
-        if (pthread_create(&threads[i], NULL, rt_blocking_worker_main, ex) != 0) {
+        if (!blocking_spawn_locked(ex)) {
+            pthread_mutex_unlock(&ex->blocking_lock);
             panic_msg("async: blocking worker start failed");
             return;
         }
-        (void)pthread_detach(threads[i]);
+    }
+    pthread_mutex_unlock(&ex->blocking_lock);
+    if (ex->blocking_max > count) {
+        pthread_t monitor;
+        if (pthread_create(&monitor, NULL, rt_blocking_monitor_main, ex) != 0) {
+            panic_msg("async: blocking monitor start failed");
+            return;
+        }
+        (void)pthread_detach(monitor);
     }
     ex->blocking_started = 1;
 }
 
+void rt_trace_advance(size_t* pos, size_t cap, int n) {
+    // snprintf reports the untruncated length; keep pos on the terminating NUL at most.
+    if (n <= 0) {
+        return;
+    }
+    size_t next = *pos + (size_t)n;
+    *pos = next < cap ? next : cap - 1;
+}
+
+void rt_latency_hist_append(char* buf, size_t* pos, size_t cap, const atomic_u64* hist) {
+    // Non-empty buckets as <upper bound in us>:<count>, comma separated.
+    int first = 1;
+    for (size_t b = 0; b < RT_LATENCY_HIST_BUCKETS; b++) {
+        uint64_t count = atomic_load_explicit(&hist[b], memory_order_relaxed);
+        if (count == 0 || *pos + 1 >= cap) {
+            continue;
+        }
+        int n;
+        if (b + 1 == RT_LATENCY_HIST_BUCKETS) {
+            n = snprintf(buf + *pos, cap - *pos, "%sinf:%llu", first ? "" : ",",
+                         (unsigned long long)count);
+        } else {
+            n = snprintf(buf + *pos, cap - *pos, "%s%llu:%llu", first ? "" : ",",
+                         (unsigned long long)(UINT64_C(1) << b), (unsigned long long)count);
+        }
+        rt_trace_advance(pos, cap, n);
+        first = 0;
+    }
+    if (first && *pos + 1 < cap) {
+        buf[(*pos)++] = '-';
+    }
+}
+
+void rt_blocking_trace_dump(rt_executor* ex, const char* reason) {
+    if (ex == NULL || !ex->blocking_started) {
+        return;
+    }
+    if (reason == NULL || reason[0] == '\0') {
+        reason = "unknown";
+    }
+    pthread_mutex_lock(&ex->blocking_lock);
+    uint32_t live = ex->blocking_live;
+    uint32_t peak = ex->blocking_peak;
+    pthread_mutex_unlock(&ex->blocking_lock);
+
+    char buf[1024];
+    int n = snprintf(buf,
+                     sizeof(buf),
+                     "TRACE_BLOCKING reason=%s threads=%u peak=%u core=%u max=%u spawned=%u "
+                     "retired=%u idle=%u queued=%llu wait_us=",
+                     reason,
+                     (unsigned)live,
+                     (unsigned)peak,
+                     (unsigned)ex->blocking_count,
+                     (unsigned)ex->blocking_max,
+                     (unsigned)atomic_load_explicit(&ex->blocking_spawned, memory_order_relaxed),
+                     (unsigned)atomic_load_explicit(&ex->blocking_retired, memory_order_relaxed),
+                     (unsigned)atomic_load_explicit(&ex->blocking_idle, memory_order_relaxed),
+                     (unsigned long long)deque_len(&ex->blocking_queue));
+    if (n < 0) {
+        return;
+    }
+    size_t pos = 0;
+    rt_trace_advance(&pos, sizeof(buf), n);
+    rt_latency_hist_append(buf, &pos, sizeof(buf), ex->blocking_wait_hist);
+    rt_trace_advance(&pos, sizeof(buf), snprintf(buf + pos, sizeof(buf) - pos, " run_us="));
+    rt_latency_hist_append(buf, &pos, sizeof(buf), ex->blocking_run_hist);
+    if (pos + 1 < sizeof(buf)) {
+        buf[pos++] = '\n';
+    }
+    (void)write(STDERR_FILENO, buf, pos);
+}
+
 void rt_blocking_request_cancel(rt_executor* ex, rt_task* task) {
     if (ex == NULL || task == NULL || task->kind != TASK_KIND_BLOCKING) {
         return;
@@ -182,7 +391,7 @@ poll_outcome poll_blocking_task(rt_executor* ex, rt_task* task) {
     }
     if (task_cancelled_load(task) != 0) {
         rt_blocking_request_cancel(ex, task);
-        blocking_job_release(job);
+        blocking_job_release(ex, job);
         task->state = NULL;
         out.kind = POLL_DONE_CANCELLED;
         return out;
@@ -191,13 +400,13 @@ poll_outcome poll_blocking_task(rt_executor* ex, rt_task* task) {
     if (status == BLOCKING_JOB_DONE) {
         out.kind = POLL_DONE_SUCCESS;
         out.value_bits = job->result_bits;
-        blocking_job_release(job);
+        blocking_job_release(ex, job);
         task->state = NULL;
         return out;
     }
     if (status == BLOCKING_JOB_CANCELLED) {
         out.kind = POLL_DONE_CANCELLED;
-        blocking_job_release(job);
+        blocking_job_release(ex, job);
         task->state = NULL;
         return out;
     }
@@ -215,16 +424,13 @@ void* rt_blocking_submit(uint64_t fn_id, void* state, uint64_t state_size, uint6
         return NULL;
     }
     rt_lock(ex);
-    uint64_t id = ex->next_id++;
-    ensure_task_cap(ex, id);
-    rt_task* task = (rt_task*)rt_alloc(sizeof(rt_task), _Alignof(rt_task));
+    rt_task* task = task_slot_alloc(ex);
     if (task == NULL) {
         rt_unlock(ex);
         panic_msg("async: blocking task allocation failed");
         return NULL;
     }
-    memset(task, 0, sizeof(rt_task));
-    task->id = id;
+    uint64_t id = task->id;
     task->poll_fn_id = -1;
     task->state = NULL;
     task_status_store(task, TASK_READY);
@@ -233,22 +439,14 @@ void* rt_blocking_submit(uint64_t fn_id, void* state, uint64_t state_size, uint6
     task_enqueued_store(task, 0);
     (void)task_wake_token_exchange(task, 0);
     atomic_store_explicit(&task->handle_refs, 1, memory_order_relaxed);
-    ex->tasks[id] = task;
-    rt_task* parent = rt_current_task();
-    if (parent != NULL) {
-        task_add_child(parent, id);
-    }
 
-    rt_blocking_job* job =
-        (rt_blocking_job*)rt_alloc(sizeof(rt_blocking_job), _Alignof(rt_blocking_job));
+    rt_blocking_job* job = blocking_job_alloc(ex);
     if (job == NULL) {
-        ex->tasks[id] = NULL;
-        rt_free((uint8_t*)task, sizeof(rt_task), _Alignof(rt_task));
+        task_slot_free(ex, task);
         rt_unlock(ex);
         panic_msg("async: blocking job allocation failed");
         return NULL;
     }
-    memset(job, 0, sizeof(rt_blocking_job));
     job->task_id = id;
     job->fn_id = fn_id;
     job->state = state;
@@ -258,6 +456,10 @@ void* rt_blocking_submit(uint64_t fn_id, void* state, uint64_t state_size, uint6
     atomic_store_explicit(&job->cancel_requested, 0, memory_order_relaxed);
     atomic_store_explicit(&job->refs, 2, memory_order_relaxed);
     task->state = job;
+    rt_task* parent = rt_current_task();
+    if (parent != NULL) {
+        task_add_child(parent, task);
+    }
 
     (void)atomic_fetch_add_explicit(&ex->blocking_submitted, 1, memory_order_relaxed);
     rt_async_debug_printf("async blocking submit task=%llu fn=%llu state=%p size=%llu align=%llu\n",
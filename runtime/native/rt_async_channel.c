@@ -1,13 +1,39 @@
 #include "rt_async_internal.h"
 
 // Async runtime channel support.
+//
+// Buffered channels keep their values in a bounded MPMC ring (per-slot stamps, as in
+// Vyukov's queue, with lap counters so a capacity of one works). Send and recv push and
+// pop the ring without ex->lock; the lock is taken only to hand values to parked tasks,
+// to pull values from parked senders, or to park. send_many claims a run of slots with a
+// single CAS on tail.
+//
+// waiting mirrors which of the channel's waiter keys may have parked tasks. Bits are set
+// under ex->lock before a task registers and cleared under the lock once pop_waiter
+// finds the key empty, so a clear bit means nobody is parked. Lost wakeups are ruled out
+// Dekker-style: a fast path publishes its ring change, issues a seq_cst fence, then
+// reads waiting; a parking task sets its bit, fences, then re-reads the ring and backs
+// out if the ring already changed. Unbuffered channels have no ring and always hand
+// values over under the lock.
+
+enum {
+    CHAN_WAIT_RECV = 1u,
+    CHAN_WAIT_SEND = 2u,
+};
+
+typedef struct rt_channel_slot {
+    _Atomic uint64_t stamp;
+    uint64_t value;
+} rt_channel_slot;
 
 struct rt_channel {
     uint64_t capacity;
-    uint8_t closed;
-    uint64_t* buf;
-    size_t buf_len;
-    size_t buf_head;
+    uint64_t one_lap;
+    rt_channel_slot* slots;
+    _Atomic uint8_t closed;
+    _Atomic uint32_t waiting;
+    _Alignas(64) _Atomic uint64_t head;
+    _Alignas(64) _Atomic uint64_t tail;
 };
 
 static uint64_t channel_align_up(uint64_t size, uint64_t align) {
@@ -27,7 +53,7 @@ static uint64_t channel_align_up(uint64_t size, uint64_t align) {
 }
 
 static uint64_t channel_buffer_offset(void) {
-    return channel_align_up((uint64_t)sizeof(rt_channel), (uint64_t) _Alignof(uint64_t));
+    return channel_align_up((uint64_t)sizeof(rt_channel), (uint64_t) _Alignof(rt_channel_slot));
 }
 
 static uint64_t channel_alloc_size(uint64_t capacity) {
@@ -35,11 +61,11 @@ static uint64_t channel_alloc_size(uint64_t capacity) {
         return (uint64_t)sizeof(rt_channel);
     }
     uint64_t offset = channel_buffer_offset();
-    if (capacity > (UINT64_MAX - offset) / (uint64_t)sizeof(uint64_t)) {
+    if (capacity > (UINT64_MAX / 4 - offset) / (uint64_t)sizeof(rt_channel_slot)) {
         panic_msg("async: channel allocation overflow");
         return 0;
     }
-    return offset + capacity * (uint64_t)sizeof(uint64_t);
+    return offset + capacity * (uint64_t)sizeof(rt_channel_slot);
 }
 
 static rt_channel* channel_from_handle(void* handle) {
@@ -50,50 +76,325 @@ static rt_channel* channel_from_handle(void* handle) {
     return (rt_channel*)handle;
 }
 
+static int channel_closed(const rt_channel* ch) {
+    return atomic_load_explicit(&ch->closed, memory_order_acquire) != 0;
+}
+
+// Head and tail are stamps: the low bits index a slot, the bits from one_lap up count
+// laps. A slot's stamp equals the tail stamp that may fill it next, or that tail stamp
+// plus one while it holds a value.
+static uint64_t ring_next(const rt_channel* ch, uint64_t stamp) {
+    uint64_t index = stamp & (ch->one_lap - 1);
+    if (index + 1 < ch->capacity) {
+        return stamp + 1;
+    }
+    return (stamp & ~(ch->one_lap - 1)) + ch->one_lap;
+}
+
 static int buf_push(rt_channel* ch, uint64_t value_bits) {
-    if (ch == NULL || ch->capacity == 0 || ch->buf_len >= ch->capacity || ch->buf == NULL) {
+    if (ch->capacity == 0) {
         return 0;
     }
-    size_t idx = (ch->buf_head + ch->buf_len) % ch->capacity;
-    ch->buf[idx] = value_bits;
-    ch->buf_len++;
-    return 1;
+    uint64_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    for (;;) {
+        rt_channel_slot* slot = &ch->slots[tail & (ch->one_lap - 1)];
+        uint64_t stamp = atomic_load_explicit(&slot->stamp, memory_order_acquire);
+        if (stamp == tail) {
+            if (atomic_compare_exchange_weak_explicit(&ch->tail,
+                                                      &tail,
+                                                      ring_next(ch, tail),
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->value = value_bits;
+                atomic_store_explicit(&slot->stamp, tail + 1, memory_order_release);
+                return 1;
+            }
+        } else if (stamp + ch->one_lap == tail + 1) {
+            // The slot still holds last lap's value: full unless a pop is mid-flight.
+            atomic_thread_fence(memory_order_seq_cst);
+            uint64_t head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+            if (head + ch->one_lap == tail) {
+                return 0;
+            }
+            tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+        } else {
+            tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+        }
+    }
+}
+
+// Claims a run of up to count free slots from tail with one CAS and fills them in order.
+// The run ends at the first slot whose stamp says it is not free for this lap, so a slot
+// still held by a mid-flight pop is never claimed. Returns how many values were pushed.
+static uint64_t buf_push_many(rt_channel* ch, const uint64_t* values_bits, uint64_t count) {
+    if (ch->capacity == 0 || count == 0) {
+        return 0;
+    }
+    uint64_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    for (;;) {
+        uint64_t end = tail;
+        uint64_t claimed = 0;
+        uint64_t first = 0;
+        while (claimed < count) {
+            rt_channel_slot* slot = &ch->slots[end & (ch->one_lap - 1)];
+            uint64_t stamp = atomic_load_explicit(&slot->stamp, memory_order_acquire);
+            if (claimed == 0) {
+                first = stamp;
+            }
+            if (stamp != end) {
+                break;
+            }
+            end = ring_next(ch, end);
+            claimed++;
+        }
+        if (claimed > 0) {
+            if (!atomic_compare_exchange_weak_explicit(
+                    &ch->tail, &tail, end, memory_order_relaxed, memory_order_relaxed)) {
+                continue;
+            }
+            uint64_t stamp = tail;
+            for (uint64_t i = 0; i < claimed; i++) {
+                rt_channel_slot* slot = &ch->slots[stamp & (ch->one_lap - 1)];
+                slot->value = values_bits[i];
+                atomic_store_explicit(&slot->stamp, stamp + 1, memory_order_release);
+                stamp = ring_next(ch, stamp);
+            }
+            return claimed;
+        }
+        if (first + ch->one_lap == tail + 1) {
+            atomic_thread_fence(memory_order_seq_cst);
+            uint64_t head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+            if (head + ch->one_lap == tail) {
+                return 0;
+            }
+        }
+        tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    }
 }
 
 static int buf_pop(rt_channel* ch, uint64_t* out_bits) {
-    if (ch == NULL || ch->buf_len == 0 || ch->buf == NULL) {
+    if (ch->capacity == 0) {
+        return 0;
+    }
+    uint64_t head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    for (;;) {
+        rt_channel_slot* slot = &ch->slots[head & (ch->one_lap - 1)];
+        uint64_t stamp = atomic_load_explicit(&slot->stamp, memory_order_acquire);
+        if (stamp == head + 1) {
+            if (atomic_compare_exchange_weak_explicit(&ch->head,
+                                                      &head,
+                                                      ring_next(ch, head),
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                if (out_bits != NULL) {
+                    *out_bits = slot->value;
+                }
+                atomic_store_explicit(&slot->stamp, head + ch->one_lap, memory_order_release);
+                return 1;
+            }
+        } else if (stamp == head) {
+            // The slot is empty: the ring is empty unless a push is mid-flight.
+            atomic_thread_fence(memory_order_seq_cst);
+            uint64_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+            if (tail == head) {
+                return 0;
+            }
+            head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+        } else {
+            head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+        }
+    }
+}
+
+static int buf_has_value(const rt_channel* ch) {
+    if (ch->capacity == 0) {
+        return 0;
+    }
+    return atomic_load_explicit(&ch->head, memory_order_relaxed) !=
+           atomic_load_explicit(&ch->tail, memory_order_relaxed);
+}
+
+static int buf_has_room(const rt_channel* ch) {
+    if (ch->capacity == 0) {
+        return 0;
+    }
+    uint64_t tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    return atomic_load_explicit(&ch->head, memory_order_relaxed) + ch->one_lap != tail;
+}
+
+// Fast-path side of the waiting handshake: called after a ring push or pop.
+static uint32_t channel_waiting_after_update(const rt_channel* ch) {
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&ch->waiting, memory_order_relaxed);
+}
+
+static waker_key channel_wait_key(const rt_channel* ch, uint32_t bit) {
+    return bit == CHAN_WAIT_RECV ? channel_recv_key(ch) : channel_send_key(ch);
+}
+
+// Caller holds ex->lock. Parking side of the handshake: marks bit before the caller
+// registers, then reports whether the ring changed in a way the caller must not sleep
+// through.
+static int channel_mark_waiting(rt_channel* ch, uint32_t bit) {
+    atomic_fetch_or_explicit(&ch->waiting, bit, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (bit == CHAN_WAIT_RECV) {
+        return buf_has_value(ch);
+    }
+    return buf_has_room(ch);
+}
+
+// Caller holds ex->lock. pop_waiter restricted to keys whose bit is set; an empty key
+// clears its bit.
+static int channel_pop_waiter(rt_executor* ex, rt_channel* ch, uint32_t bit, uint64_t* out_id) {
+    if ((atomic_load_explicit(&ch->waiting, memory_order_relaxed) & bit) == 0) {
+        return 0;
+    }
+    if (pop_waiter(ex, channel_wait_key(ch, bit), out_id)) {
+        return 1;
+    }
+    atomic_fetch_and_explicit(&ch->waiting, ~bit, memory_order_relaxed);
+    return 0;
+}
+
+// Caller holds ex->lock. A task parked in select is registered under every arm's key
+// (listed in wait_keys) and polls all arms again when woken, so it cannot take a value
+// or an ack through resume_kind. Such a waiter is only woken; it finds the value, the
+// free slot, or this task parked on the channel when it polls.
+static int wake_select_waiter(rt_executor* ex, rt_task* task, int signal) {
+    if (task->wait_keys_len == 0) {
         return 0;
     }
-    if (out_bits != NULL) {
-        *out_bits = ch->buf[ch->buf_head];
+    task->resume_kind = RESUME_NONE;
+    task->resume_bits = 0;
+    if (signal) {
+        wake_channel_task(ex, task->id, 1);
+    } else {
+        wake_channel_task_no_signal(ex, task->id, 1);
     }
-    ch->buf_head = (ch->buf_head + 1) % ch->capacity;
-    ch->buf_len--;
     return 1;
 }
 
-static void refill_buffer_from_sender(rt_executor* ex, rt_channel* ch, int signal_sender) {
-    if (ch == NULL || ch->capacity == 0 || ch->buf_len >= ch->capacity) {
-        return;
+// Caller holds ex->lock. Hands buffered values to parked receivers, oldest value first.
+// A receiver whose value was taken by a concurrent lock-free pop is woken empty-handed
+// and polls again.
+static void feed_receivers(rt_executor* ex, rt_channel* ch, int signal) {
+    uint64_t recv_id = 0;
+    while (buf_has_value(ch) && channel_pop_waiter(ex, ch, CHAN_WAIT_RECV, &recv_id)) {
+        rt_task* recv_task = get_task(ex, recv_id);
+        if (recv_task == NULL || task_status_load(recv_task) == TASK_DONE ||
+            wake_select_waiter(ex, recv_task, signal)) {
+            continue;
+        }
+        uint64_t val = 0;
+        int got = buf_pop(ch, &val);
+        recv_task->resume_kind = got ? RESUME_CHAN_RECV_VALUE : RESUME_NONE;
+        recv_task->resume_bits = got ? val : 0;
+        if (signal) {
+            wake_channel_task(ex, recv_id, 1);
+        } else {
+            wake_channel_task_no_signal(ex, recv_id, 1);
+        }
+        if (!got) {
+            return;
+        }
     }
+}
+
+// Caller holds ex->lock. Moves values of parked senders into freed ring slots, oldest
+// sender first. A sender that lost its slot to a concurrent lock-free push is woken
+// without an ack and sends again.
+static void refill_buffer_from_senders(rt_executor* ex, rt_channel* ch, int signal_sender) {
     uint64_t sender_id = 0;
-    if (!pop_waiter(ex, channel_send_key(ch), &sender_id)) {
-        return;
+    while (buf_has_room(ch) && channel_pop_waiter(ex, ch, CHAN_WAIT_SEND, &sender_id)) {
+        rt_task* sender = get_task(ex, sender_id);
+        if (sender == NULL || task_status_load(sender) == TASK_DONE ||
+            wake_select_waiter(ex, sender, signal_sender)) {
+            continue;
+        }
+        int pushed = buf_push(ch, sender->resume_bits);
+        sender->resume_kind = pushed ? RESUME_CHAN_SEND_ACK : RESUME_NONE;
+        sender->resume_bits = 0;
+        if (signal_sender) {
+            wake_channel_task(ex, sender_id, 1);
+        } else {
+            wake_channel_task_no_signal(ex, sender_id, 1);
+        }
+        if (!pushed) {
+            return;
+        }
     }
-    rt_task* sender = get_task(ex, sender_id);
-    if (sender == NULL || task_status_load(sender) == TASK_DONE) {
-        return;
+}
+
+// Caller holds ex->lock. Takes the value of the oldest parked sender, if any.
+static int take_from_sender(rt_executor* ex, rt_channel* ch, uint64_t* out_bits, int signal) {
+    uint64_t sender_id = 0;
+    while (channel_pop_waiter(ex, ch, CHAN_WAIT_SEND, &sender_id)) {
+        rt_task* sender = get_task(ex, sender_id);
+        if (sender == NULL || task_status_load(sender) == TASK_DONE ||
+            wake_select_waiter(ex, sender, signal)) {
+            continue;
+        }
+        if (out_bits != NULL) {
+            *out_bits = sender->resume_bits;
+        }
+        sender->resume_kind = RESUME_CHAN_SEND_ACK;
+        sender->resume_bits = 0;
+        if (signal) {
+            wake_channel_task(ex, sender_id, 1);
+        } else {
+            wake_channel_task_no_signal(ex, sender_id, 1);
+        }
+        return 1;
     }
-    if (!buf_push(ch, sender->resume_bits)) {
-        return;
+    return 0;
+}
+
+// Caller holds ex->lock. Pops the oldest parked plain receiver, waking select waiters
+// met on the way. Buffered values are older than any new one, so this is used only
+// while the ring is empty.
+static int pop_plain_receiver(rt_executor* ex, rt_channel* ch, int signal, uint64_t* out_id) {
+    uint64_t recv_id = 0;
+    while (!buf_has_value(ch) && channel_pop_waiter(ex, ch, CHAN_WAIT_RECV, &recv_id)) {
+        rt_task* recv_task = get_task(ex, recv_id);
+        if (recv_task == NULL || task_status_load(recv_task) == TASK_DONE ||
+            wake_select_waiter(ex, recv_task, signal)) {
+            continue;
+        }
+        *out_id = recv_id;
+        return 1;
     }
-    sender->resume_kind = RESUME_CHAN_SEND_ACK;
-    sender->resume_bits = 0;
-    if (signal_sender) {
-        wake_channel_task(ex, sender_id, 1);
-    } else {
-        wake_channel_task_no_signal(ex, sender_id, 1);
+    return 0;
+}
+
+// Lock-free send: only while nobody is parked on the channel, so parked senders keep
+// their place and handoffs to parked receivers keep their wake policy.
+static int channel_send_fast(rt_executor* ex, rt_channel* ch, uint64_t value_bits) {
+    if (ch->capacity == 0 || channel_closed(ch) ||
+        atomic_load_explicit(&ch->waiting, memory_order_relaxed) != 0) {
+        return 0;
+    }
+    if (!buf_push(ch, value_bits)) {
+        return 0;
     }
+    if (channel_waiting_after_update(ch) & CHAN_WAIT_RECV) {
+        rt_lock(ex);
+        feed_receivers(ex, ch, 1);
+        rt_unlock(ex);
+    }
+    return 1;
+}
+
+static int channel_recv_fast(rt_executor* ex, rt_channel* ch, uint64_t* out_bits, int signal) {
+    if (!buf_pop(ch, out_bits)) {
+        return 0;
+    }
+    if (channel_waiting_after_update(ch) & CHAN_WAIT_SEND) {
+        rt_lock(ex);
+        refill_buffer_from_senders(ex, ch, signal);
+        rt_unlock(ex);
+    }
+    return 1;
 }
 
 static int prepare_channel_send_yield(rt_task* task) {
@@ -120,7 +421,15 @@ void* rt_channel_new(uint64_t capacity) {
     memset(ch, 0, sizeof(rt_channel));
     ch->capacity = capacity;
     if (capacity > 0) {
-        ch->buf = (uint64_t*)((uint8_t*)ch + channel_buffer_offset());
+        ch->one_lap = 1;
+        while (ch->one_lap <= capacity) {
+            ch->one_lap <<= 1;
+        }
+        ch->slots = (rt_channel_slot*)((uint8_t*)ch + channel_buffer_offset());
+        for (uint64_t i = 0; i < capacity; i++) {
+            atomic_init(&ch->slots[i].stamp, i);
+            ch->slots[i].value = 0;
+        }
     }
     rt_async_debug_printf(
         "async chan new ch=%p cap=%llu\n", (void*)ch, (unsigned long long)capacity);
@@ -133,13 +442,17 @@ static bool rt_channel_send_inner(void* channel, uint64_t value_bits, int yield_
     if (ex == NULL || ch == NULL) {
         return 1;
     }
+    rt_task* task = rt_current_task();
+    if (task != NULL && task->resume_kind == RESUME_NONE && task_cancelled_load(task) == 0 &&
+        channel_send_fast(ex, ch, value_bits)) {
+        return 1;
+    }
     rt_lock(ex);
     if (rt_current_task_id() == 0) {
         rt_unlock(ex);
         panic_msg("async channel send outside task");
         return 1;
     }
-    rt_task* task = rt_current_task();
     if (task == NULL) {
         rt_unlock(ex);
         panic_msg("async: missing current task");
@@ -164,16 +477,15 @@ static bool rt_channel_send_inner(void* channel, uint64_t value_bits, int yield_
         panic_msg("send on closed channel");
         return 1;
     }
-    if (ch->closed) {
+    if (channel_closed(ch)) {
         rt_unlock(ex);
         panic_msg("send on closed channel");
         return 1;
     }
-    uint64_t recv_id = 0;
-    waker_key recv_key = channel_recv_key(ch);
-    if (pop_waiter(ex, recv_key, &recv_id)) {
-        rt_task* recv_task = get_task(ex, recv_id);
-        if (recv_task != NULL && task_status_load(recv_task) != TASK_DONE) {
+    for (;;) {
+        uint64_t recv_id = 0;
+        if (pop_plain_receiver(ex, ch, !yield_after_handoff, &recv_id)) {
+            rt_task* recv_task = get_task(ex, recv_id);
             recv_task->resume_kind = RESUME_CHAN_RECV_VALUE;
             recv_task->resume_bits = value_bits;
             if (yield_after_handoff) {
@@ -185,21 +497,25 @@ static bool rt_channel_send_inner(void* channel, uint64_t value_bits, int yield_
                 rt_unlock(ex);
                 return 0;
             }
+            rt_unlock(ex);
+            return 1;
         }
+        if (buf_push(ch, value_bits)) {
+            feed_receivers(ex, ch, 1);
+            rt_unlock(ex);
+            return 1;
+        }
+        if (channel_mark_waiting(ch, CHAN_WAIT_SEND)) {
+            continue;
+        }
+        task->resume_kind = RESUME_NONE;
+        task->resume_bits = value_bits;
+        waker_key send_key = channel_send_key(ch);
+        prepare_park(ex, task, send_key, 0);
+        pending_key = send_key;
         rt_unlock(ex);
-        return 1;
-    }
-    if (ch->capacity > 0 && ch->buf_len < ch->capacity && buf_push(ch, value_bits)) {
-        rt_unlock(ex);
-        return 1;
+        return 0;
     }
-    task->resume_kind = RESUME_NONE;
-    task->resume_bits = value_bits;
-    waker_key send_key = channel_send_key(ch);
-    prepare_park(ex, task, send_key, 0);
-    pending_key = send_key;
-    rt_unlock(ex);
-    return 0;
 }
 
 bool rt_channel_send(void* channel, uint64_t value_bits) {
@@ -216,13 +532,17 @@ uint8_t rt_channel_recv(void* channel, uint64_t* out_bits) {
     if (ex == NULL || ch == NULL) {
         return 2;
     }
+    rt_task* task = rt_current_task();
+    if (task != NULL && task->resume_kind == RESUME_NONE && task_cancelled_load(task) == 0 &&
+        channel_recv_fast(ex, ch, out_bits, 0)) {
+        return 1;
+    }
     rt_lock(ex);
     if (rt_current_task_id() == 0) {
         rt_unlock(ex);
         panic_msg("async channel recv outside task");
         return 2;
     }
-    rt_task* task = rt_current_task();
     if (task == NULL) {
         rt_unlock(ex);
         panic_msg("async: missing current task");
@@ -246,72 +566,89 @@ uint8_t rt_channel_recv(void* channel, uint64_t* out_bits) {
     if (task->resume_kind == RESUME_CHAN_RECV_CLOSED) {
         task->resume_kind = RESUME_NONE;
         task->resume_bits = 0;
+        // A lock-free send that raced with close may still have landed in the ring.
+        uint8_t status = buf_pop(ch, out_bits) ? 1 : 2;
         rt_unlock(ex);
-        return 2;
+        return status;
     }
-    uint64_t val = 0;
-    if (buf_pop(ch, &val)) {
-        if (out_bits != NULL) {
-            *out_bits = val;
+    for (;;) {
+        if (buf_pop(ch, out_bits)) {
+            refill_buffer_from_senders(ex, ch, 0);
+            rt_unlock(ex);
+            return 1;
         }
-        refill_buffer_from_sender(ex, ch, 0);
-        rt_unlock(ex);
-        return 1;
-    }
-    uint64_t sender_id = 0;
-    waker_key send_key = channel_send_key(ch);
-    if (pop_waiter(ex, send_key, &sender_id)) {
-        rt_task* sender = get_task(ex, sender_id);
-        if (sender != NULL && task_status_load(sender) != TASK_DONE) {
-            if (out_bits != NULL) {
-                *out_bits = sender->resume_bits;
-            }
-            sender->resume_kind = RESUME_CHAN_SEND_ACK;
-            sender->resume_bits = 0;
-            wake_channel_task_no_signal(ex, sender_id, 1);
+        if (take_from_sender(ex, ch, out_bits, 0)) {
+            rt_unlock(ex);
+            return 1;
+        }
+        if (channel_closed(ch)) {
+            rt_unlock(ex);
+            return 2;
+        }
+        if (channel_mark_waiting(ch, CHAN_WAIT_RECV)) {
+            continue;
         }
+        task->resume_kind = RESUME_NONE;
+        task->resume_bits = 0;
+        waker_key recv_key = channel_recv_key(ch);
+        prepare_park(ex, task, recv_key, 0);
+        pending_key = recv_key;
         rt_unlock(ex);
-        return 1;
+        return 0;
     }
-    if (ch->closed) {
-        rt_unlock(ex);
-        return 2;
+}
+
+bool rt_channel_try_send(void* channel, uint64_t value_bits) {
+    rt_executor* ex = ensure_exec();
+    rt_channel* ch = channel_from_handle(channel);
+    if (ex == NULL || ch == NULL || channel_closed(ch)) {
+        return 0;
     }
-    task->resume_kind = RESUME_NONE;
-    task->resume_bits = 0;
-    waker_key recv_key = channel_recv_key(ch);
-    prepare_park(ex, task, recv_key, 0);
-    pending_key = recv_key;
+    if (channel_send_fast(ex, ch, value_bits)) {
+        return 1;
+    }
+    rt_lock(ex);
+    uint8_t status = rt_channel_try_send_status_locked(ex, ch, value_bits);
     rt_unlock(ex);
-    return 0;
+    return status == 1;
 }
 
-bool rt_channel_try_send(void* channel, uint64_t value_bits) {
+// rt_channel_send_many is a batched try_send: it sends values_bits in order without
+// waiting and returns how many went out, leaving the rest to the caller. Values that land
+// in the ring are claimed with one CAS, and parked receivers are fed once per call rather
+// than once per value.
+uint64_t rt_channel_send_many(void* channel, const uint64_t* values_bits, uint64_t count) {
     rt_executor* ex = ensure_exec();
     rt_channel* ch = channel_from_handle(channel);
-    if (ex == NULL || ch == NULL || ch->closed) {
+    if (ex == NULL || ch == NULL || count == 0 || channel_closed(ch)) {
         return 0;
     }
+    if (ch->capacity > 0 && atomic_load_explicit(&ch->waiting, memory_order_relaxed) == 0) {
+        uint64_t sent = buf_push_many(ch, values_bits, count);
+        if (sent > 0) {
+            if (channel_waiting_after_update(ch) & CHAN_WAIT_RECV) {
+                rt_lock(ex);
+                feed_receivers(ex, ch, 1);
+                rt_unlock(ex);
+            }
+            return sent;
+        }
+    }
+    uint64_t sent = 0;
     rt_lock(ex);
-    uint64_t recv_id = 0;
-    if (pop_waiter(ex, channel_recv_key(ch), &recv_id)) {
-        rt_task* recv_task = get_task(ex, recv_id);
-        if (recv_task != NULL && task_status_load(recv_task) != TASK_DONE) {
+    if (!channel_closed(ch)) {
+        uint64_t recv_id = 0;
+        while (sent < count && pop_plain_receiver(ex, ch, 1, &recv_id)) {
+            rt_task* recv_task = get_task(ex, recv_id);
             recv_task->resume_kind = RESUME_CHAN_RECV_VALUE;
-            recv_task->resume_bits = value_bits;
+            recv_task->resume_bits = values_bits[sent++];
             wake_channel_task(ex, recv_id, 1);
         }
-        rt_unlock(ex);
-        return 1;
-    }
-    if (ch->capacity > 0 && ch->buf_len < ch->capacity) {
-        if (buf_push(ch, value_bits)) {
-            rt_unlock(ex);
-            return 1;
-        }
+        sent += buf_push_many(ch, values_bits + sent, count - sent);
+        feed_receivers(ex, ch, 1);
     }
     rt_unlock(ex);
-    return 0;
+    return sent;
 }
 
 bool rt_channel_try_recv(void* channel, uint64_t* out_bits) {
@@ -320,32 +657,17 @@ bool rt_channel_try_recv(void* channel, uint64_t* out_bits) {
     if (ex == NULL || ch == NULL) {
         return 0;
     }
-    rt_lock(ex);
-    uint64_t val = 0;
-    if (buf_pop(ch, &val)) {
-        if (out_bits != NULL) {
-            *out_bits = val;
-        }
-        refill_buffer_from_sender(ex, ch, 1);
-        rt_unlock(ex);
+    if (channel_recv_fast(ex, ch, out_bits, 1)) {
         return 1;
     }
-    uint64_t sender_id = 0;
-    if (pop_waiter(ex, channel_send_key(ch), &sender_id)) {
-        rt_task* sender = get_task(ex, sender_id);
-        if (sender != NULL && task_status_load(sender) != TASK_DONE) {
-            if (out_bits != NULL) {
-                *out_bits = sender->resume_bits;
-            }
-            sender->resume_kind = RESUME_CHAN_SEND_ACK;
-            sender->resume_bits = 0;
-            wake_channel_task(ex, sender_id, 1);
-        }
-        rt_unlock(ex);
-        return 1;
+    // The ring was empty; only a parked sender could still supply a value.
+    if ((atomic_load_explicit(&ch->waiting, memory_order_relaxed) & CHAN_WAIT_SEND) == 0) {
+        return 0;
     }
+    rt_lock(ex);
+    uint8_t status = rt_channel_try_recv_status_locked(ex, ch, out_bits);
     rt_unlock(ex);
-    return 0;
+    return status == 1;
 }
 
 // rt_channel_try_recv_status_locked is the locked, non-blocking recv with closed status.
@@ -355,28 +677,14 @@ uint8_t rt_channel_try_recv_status_locked(rt_executor* ex, void* channel, uint64
     if (ex == NULL || ch == NULL) {
         return 0;
     }
-    uint64_t val = 0;
-    if (buf_pop(ch, &val)) {
-        if (out_bits != NULL) {
-            *out_bits = val;
-        }
-        refill_buffer_from_sender(ex, ch, 1);
+    if (buf_pop(ch, out_bits)) {
+        refill_buffer_from_senders(ex, ch, 1);
         return 1;
     }
-    uint64_t sender_id = 0;
-    if (pop_waiter(ex, channel_send_key(ch), &sender_id)) {
-        rt_task* sender = get_task(ex, sender_id);
-        if (sender != NULL && task_status_load(sender) != TASK_DONE) {
-            if (out_bits != NULL) {
-                *out_bits = sender->resume_bits;
-            }
-            sender->resume_kind = RESUME_CHAN_SEND_ACK;
-            sender->resume_bits = 0;
-            wake_channel_task(ex, sender_id, 1);
-        }
+    if (take_from_sender(ex, ch, out_bits, 1)) {
         return 1;
     }
-    if (ch->closed) {
+    if (channel_closed(ch)) {
         return 2;
     }
     return 0;
@@ -389,25 +697,36 @@ uint8_t rt_channel_try_send_status_locked(rt_executor* ex, void* channel, uint64
     if (ex == NULL || ch == NULL) {
         return 0;
     }
-    if (ch->closed) {
+    if (channel_closed(ch)) {
         return 2;
     }
     uint64_t recv_id = 0;
-    if (pop_waiter(ex, channel_recv_key(ch), &recv_id)) {
+    if (pop_plain_receiver(ex, ch, 1, &recv_id)) {
         rt_task* recv_task = get_task(ex, recv_id);
-        if (recv_task != NULL && task_status_load(recv_task) != TASK_DONE) {
-            recv_task->resume_kind = RESUME_CHAN_RECV_VALUE;
-            recv_task->resume_bits = value_bits;
-            wake_channel_task(ex, recv_id, 1);
-        }
+        recv_task->resume_kind = RESUME_CHAN_RECV_VALUE;
+        recv_task->resume_bits = value_bits;
+        wake_channel_task(ex, recv_id, 1);
         return 1;
     }
-    if (ch->capacity > 0 && ch->buf_len < ch->capacity && buf_push(ch, value_bits)) {
+    if (buf_push(ch, value_bits)) {
+        feed_receivers(ex, ch, 1);
         return 1;
     }
     return 0;
 }
 
+// rt_channel_select_waiter_locked marks that the current select is about to register on
+// the channel's send or recv key and reports whether that arm may already be ready, in
+// which case the select must poll again instead of sleeping.
+int rt_channel_select_waiter_locked(void* channel, uint8_t send) {
+    rt_channel* ch = channel_from_handle(channel);
+    if (ch == NULL) {
+        return 0;
+    }
+    int ready = channel_mark_waiting(ch, send ? CHAN_WAIT_SEND : CHAN_WAIT_RECV);
+    return ready || channel_closed(ch);
+}
+
 static void channel_blocking_yield(void) {
     rt_executor* ex = ensure_exec();
     rt_task* current = rt_current_task();
@@ -512,22 +831,25 @@ void rt_channel_close(void* channel) {
     if (ch == NULL) {
         return;
     }
-    if (ch->closed) {
+    if (channel_closed(ch)) {
         return;
     }
     rt_async_debug_printf("async chan close ch=%p\n", (void*)ch);
     rt_lock(ex);
-    ch->closed = 1;
+    atomic_store_explicit(&ch->closed, 1, memory_order_release);
     if (ex == NULL) {
         rt_unlock(ex);
         return;
     }
 
+    // Values already buffered still reach receivers that were parked before the close.
+    feed_receivers(ex, ch, 1);
+
     uint64_t task_id = 0;
-    waker_key recv_key = channel_recv_key(ch);
-    while (pop_waiter(ex, recv_key, &task_id)) {
+    while (channel_pop_waiter(ex, ch, CHAN_WAIT_RECV, &task_id)) {
         rt_task* task = get_task(ex, task_id);
-        if (task == NULL || task_status_load(task) == TASK_DONE) {
+        if (task == NULL || task_status_load(task) == TASK_DONE ||
+            wake_select_waiter(ex, task, 1)) {
             continue;
         }
         task->resume_kind = RESUME_CHAN_RECV_CLOSED;
@@ -535,10 +857,10 @@ void rt_channel_close(void* channel) {
         wake_channel_task(ex, task_id, 1);
     }
 
-    waker_key send_key = channel_send_key(ch);
-    while (pop_waiter(ex, send_key, &task_id)) {
+    while (channel_pop_waiter(ex, ch, CHAN_WAIT_SEND, &task_id)) {
         rt_task* task = get_task(ex, task_id);
-        if (task == NULL || task_status_load(task) == TASK_DONE) {
+        if (task == NULL || task_status_load(task) == TASK_DONE ||
+            wake_select_waiter(ex, task, 1)) {
             continue;
         }
         task->resume_kind = RESUME_CHAN_SEND_CLOSED;
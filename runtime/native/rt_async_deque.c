@@ -0,0 +1,397 @@
+#include "rt_async_internal.h"
+
+// Ready queues: Chase-Lev work-stealing deques and an MPMC queue of task ids.
+//
+// A deque's push/pop end (bottom) belongs to a single owner at a time; steal takes the
+// oldest entry from the top with a CAS and is safe from any thread. Worker-local queues
+// are pushed and popped LIFO by their own worker without a lock. The blocking pool's
+// queue is owned by whoever holds ex->lock.
+//
+// Growing replaces the buffer while thieves may still be reading the old one, so
+// replaced buffers are retired onto a per-deque list instead of being freed.
+//
+// The inject queue is pushed by any thread and popped FIFO by any worker, so it is an
+// MPMC queue instead: a chain of bounded rings with a sequence number per cell
+// (Vyukov's bounded MPMC queue). A ring that fills is frozen and a ring twice its size
+// is linked after it. Consumers move to the next ring once the frozen one is drained,
+// and drained rings stay linked from first because a slow thread may still be reading
+// one.
+
+struct rt_deque_buf {
+    size_t mask;
+    struct rt_deque_buf* retired_next;
+    _Atomic uint64_t cells[];
+};
+
+#define DEQUE_INITIAL_CAP 64u
+
+static rt_deque_buf*
+deque_buf_alloc(size_t cap, const char* overflow_msg, const char* alloc_msg) {
+    if (cap > (SIZE_MAX - sizeof(rt_deque_buf)) / sizeof(uint64_t)) {
+        panic_msg(overflow_msg);
+        return NULL;
+    }
+    size_t size = sizeof(rt_deque_buf) + cap * sizeof(uint64_t);
+    rt_deque_buf* buf = (rt_deque_buf*)rt_alloc((uint64_t)size, _Alignof(rt_deque_buf));
+    if (buf == NULL) {
+        panic_msg(alloc_msg);
+        return NULL;
+    }
+    buf->mask = cap - 1;
+    buf->retired_next = NULL;
+    return buf;
+}
+
+static uint64_t deque_cell_load(const rt_deque_buf* buf, int64_t idx) {
+    return atomic_load_explicit(&buf->cells[(size_t)((uint64_t)idx & (uint64_t)buf->mask)],
+                                memory_order_relaxed);
+}
+
+static void deque_cell_store(rt_deque_buf* buf, int64_t idx, uint64_t id) {
+    atomic_store_explicit(
+        &buf->cells[(size_t)((uint64_t)idx & (uint64_t)buf->mask)], id, memory_order_relaxed);
+}
+
+static rt_deque_buf* deque_grow(rt_deque* dq,
+                                rt_deque_buf* old,
+                                int64_t top,
+                                int64_t bottom,
+                                const char* overflow_msg,
+                                const char* alloc_msg) {
+    size_t cap = old == NULL ? DEQUE_INITIAL_CAP : (old->mask + 1);
+    if (old != NULL) {
+        if (cap > SIZE_MAX / 2) {
+            panic_msg(overflow_msg);
+            return NULL;
+        }
+        cap *= 2;
+    }
+    rt_deque_buf* next = deque_buf_alloc(cap, overflow_msg, alloc_msg);
+    if (next == NULL) {
+        return NULL;
+    }
+    if (old != NULL) {
+        for (int64_t i = top; i < bottom; i++) {
+            deque_cell_store(next, i, deque_cell_load(old, i));
+        }
+        old->retired_next = dq->retired;
+        dq->retired = old;
+    }
+    atomic_store_explicit(&dq->buf, next, memory_order_release);
+    return next;
+}
+
+int deque_push(rt_deque* dq, uint64_t id, const char* overflow_msg, const char* alloc_msg) {
+    // Owner side.
+    if (dq == NULL) {
+        return 0;
+    }
+    int64_t bottom = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&dq->top, memory_order_acquire);
+    rt_deque_buf* buf = atomic_load_explicit(&dq->buf, memory_order_relaxed);
+    if (buf == NULL || (uint64_t)(bottom - top) > (uint64_t)buf->mask) {
+        buf = deque_grow(dq, buf, top, bottom, overflow_msg, alloc_msg);
+        if (buf == NULL) {
+            return 0;
+        }
+    }
+    deque_cell_store(buf, bottom, id);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, bottom + 1, memory_order_relaxed);
+    return 1;
+}
+
+int deque_reserve(rt_deque* dq, const char* overflow_msg, const char* alloc_msg) {
+    // Owner side. Allocates and touches the first buffer from the
+    // calling thread, so a pinned worker's queue lands on its own NUMA node under a
+    // first-touch policy instead of wherever the first push happened to run.
+    if (dq == NULL) {
+        return 0;
+    }
+    if (atomic_load_explicit(&dq->buf, memory_order_relaxed) != NULL) {
+        return 1;
+    }
+    rt_deque_buf* buf = deque_grow(dq, NULL, 0, 0, overflow_msg, alloc_msg);
+    if (buf == NULL) {
+        return 0;
+    }
+    for (int64_t i = 0; i <= (int64_t)buf->mask; i++) {
+        deque_cell_store(buf, i, 0);
+    }
+    return 1;
+}
+
+int deque_pop(rt_deque* dq, uint64_t* out_id) {
+    // Owner side; takes the newest entry.
+    if (dq == NULL) {
+        return 0;
+    }
+    rt_deque_buf* buf = atomic_load_explicit(&dq->buf, memory_order_relaxed);
+    if (buf == NULL) {
+        return 0;
+    }
+    int64_t bottom = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&dq->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&dq->top, memory_order_relaxed);
+    if (top > bottom) {
+        atomic_store_explicit(&dq->bottom, bottom + 1, memory_order_relaxed);
+        return 0;
+    }
+    uint64_t id = deque_cell_load(buf, bottom);
+    if (top == bottom) {
+        // Last entry: race thieves for it through top.
+        int won = atomic_compare_exchange_strong_explicit(
+            &dq->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&dq->bottom, bottom + 1, memory_order_relaxed);
+        if (!won) {
+            return 0;
+        }
+    }
+    if (out_id != NULL) {
+        *out_id = id;
+    }
+    return 1;
+}
+
+int deque_steal(rt_deque* dq, uint64_t* out_id) {
+    // Any thread; takes the oldest entry. Retries only while entries remain.
+    if (dq == NULL) {
+        return 0;
+    }
+    for (;;) {
+        int64_t top = atomic_load_explicit(&dq->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t bottom = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+        if (top >= bottom) {
+            return 0;
+        }
+        const rt_deque_buf* buf = atomic_load_explicit(&dq->buf, memory_order_acquire);
+        uint64_t id = deque_cell_load(buf, top);
+        if (atomic_compare_exchange_strong_explicit(
+                &dq->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            if (out_id != NULL) {
+                *out_id = id;
+            }
+            return 1;
+        }
+    }
+}
+
+size_t deque_len(const rt_deque* dq) {
+    // Exact while neither the owner nor a thief is active; otherwise a snapshot that may
+    // already be stale.
+    if (dq == NULL) {
+        return 0;
+    }
+    int64_t top = atomic_load_explicit(&dq->top, memory_order_acquire);
+    int64_t bottom = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+typedef struct {
+    _Atomic int64_t seq;
+    _Atomic uint64_t id;
+} rt_mpmc_cell;
+
+struct rt_mpmc_seg {
+    _Alignas(64) _Atomic int64_t head;
+    _Alignas(64) _Atomic int64_t tail;
+    _Atomic(rt_mpmc_seg*) next;
+    size_t mask;
+    rt_mpmc_cell cells[];
+};
+
+#define MPMC_INITIAL_CAP 64u
+// Set in a ring's tail once the next ring is about to be linked; pushes that see it fail.
+#define MPMC_FROZEN ((int64_t)1 << 62)
+
+static rt_mpmc_seg* mpmc_seg_alloc(size_t cap, const char* overflow_msg, const char* alloc_msg) {
+    if (cap > (SIZE_MAX - sizeof(rt_mpmc_seg)) / sizeof(rt_mpmc_cell)) {
+        panic_msg(overflow_msg);
+        return NULL;
+    }
+    size_t size = sizeof(rt_mpmc_seg) + cap * sizeof(rt_mpmc_cell);
+    rt_mpmc_seg* seg = (rt_mpmc_seg*)rt_alloc((uint64_t)size, _Alignof(rt_mpmc_seg));
+    if (seg == NULL) {
+        panic_msg(alloc_msg);
+        return NULL;
+    }
+    atomic_init(&seg->head, 0);
+    atomic_init(&seg->tail, 0);
+    atomic_init(&seg->next, NULL);
+    seg->mask = cap - 1;
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(&seg->cells[i].seq, (int64_t)i);
+        atomic_init(&seg->cells[i].id, 0);
+    }
+    return seg;
+}
+
+static void mpmc_seg_free(rt_mpmc_seg* seg) {
+    size_t size = sizeof(rt_mpmc_seg) + (seg->mask + 1) * sizeof(rt_mpmc_cell);
+    rt_free((uint8_t*)seg, (uint64_t)size, _Alignof(rt_mpmc_seg));
+}
+
+static int mpmc_seg_push(rt_mpmc_seg* seg, uint64_t id) {
+    // Fails when the ring is full or frozen.
+    int64_t pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+    for (;;) {
+        if ((pos & MPMC_FROZEN) != 0) {
+            return 0;
+        }
+        rt_mpmc_cell* cell = &seg->cells[(size_t)pos & seg->mask];
+        int64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &seg->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                atomic_store_explicit(&cell->id, id, memory_order_relaxed);
+                atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+                return 1;
+            }
+        } else if (seq < pos) {
+            // The cell still holds the entry from the previous lap.
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+        }
+    }
+}
+
+static int mpmc_seg_pop(rt_mpmc_seg* seg, uint64_t* out_id) {
+    int64_t pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+    for (;;) {
+        rt_mpmc_cell* cell = &seg->cells[(size_t)pos & seg->mask];
+        int64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq == pos + 1) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &seg->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                uint64_t id = atomic_load_explicit(&cell->id, memory_order_relaxed);
+                // Free the cell for the push one lap later.
+                int64_t next_lap = pos + (int64_t)seg->mask + 1;
+                atomic_store_explicit(&cell->seq, next_lap, memory_order_release);
+                if (out_id != NULL) {
+                    *out_id = id;
+                }
+                return 1;
+            }
+        } else if (seq < pos + 1) {
+            int64_t tail = atomic_load_explicit(&seg->tail, memory_order_acquire) & ~MPMC_FROZEN;
+            if (tail <= pos) {
+                return 0;
+            }
+            // A push has claimed pos and is about to publish its id.
+            pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+        } else {
+            pos = atomic_load_explicit(&seg->head, memory_order_relaxed);
+        }
+    }
+}
+
+static int mpmc_start(rt_mpmc* q, const char* overflow_msg, const char* alloc_msg) {
+    rt_mpmc_seg* head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == NULL) {
+        rt_mpmc_seg* fresh = mpmc_seg_alloc(MPMC_INITIAL_CAP, overflow_msg, alloc_msg);
+        if (fresh == NULL) {
+            return 0;
+        }
+        if (atomic_compare_exchange_strong_explicit(
+                &q->head, &head, fresh, memory_order_acq_rel, memory_order_acquire)) {
+            q->first = fresh;
+            head = fresh;
+        } else {
+            mpmc_seg_free(fresh);
+        }
+    }
+    // Nothing was pushed while tail was unset, so head is still the first ring.
+    rt_mpmc_seg* unset = NULL;
+    (void)atomic_compare_exchange_strong_explicit(
+        &q->tail, &unset, head, memory_order_acq_rel, memory_order_acquire);
+    return 1;
+}
+
+int mpmc_push(rt_mpmc* q, uint64_t id, const char* overflow_msg, const char* alloc_msg) {
+    // Any thread; appends id.
+    if (q == NULL) {
+        return 0;
+    }
+    for (;;) {
+        rt_mpmc_seg* seg = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (seg == NULL) {
+            if (!mpmc_start(q, overflow_msg, alloc_msg)) {
+                return 0;
+            }
+            continue;
+        }
+        if (mpmc_seg_push(seg, id)) {
+            return 1;
+        }
+        rt_mpmc_seg* next = atomic_load_explicit(&seg->next, memory_order_acquire);
+        if (next == NULL) {
+            size_t cap = seg->mask + 1;
+            if (cap > SIZE_MAX / 2) {
+                panic_msg(overflow_msg);
+                return 0;
+            }
+            rt_mpmc_seg* fresh = mpmc_seg_alloc(cap * 2, overflow_msg, alloc_msg);
+            if (fresh == NULL) {
+                return 0;
+            }
+            // Freeze before linking: a consumer that finds next set knows no push can
+            // still land in seg, so once seg reads empty it stays empty.
+            (void)atomic_fetch_or_explicit(&seg->tail, MPMC_FROZEN, memory_order_seq_cst);
+            if (atomic_compare_exchange_strong_explicit(
+                    &seg->next, &next, fresh, memory_order_acq_rel, memory_order_acquire)) {
+                next = fresh;
+            } else {
+                mpmc_seg_free(fresh);
+            }
+        }
+        (void)atomic_compare_exchange_strong_explicit(
+            &q->tail, &seg, next, memory_order_acq_rel, memory_order_acquire);
+    }
+}
+
+int mpmc_pop(rt_mpmc* q, uint64_t* out_id) {
+    // Any thread; takes the oldest entry.
+    if (q == NULL) {
+        return 0;
+    }
+    rt_mpmc_seg* seg = atomic_load_explicit(&q->head, memory_order_acquire);
+    while (seg != NULL) {
+        if (mpmc_seg_pop(seg, out_id)) {
+            return 1;
+        }
+        rt_mpmc_seg* next = atomic_load_explicit(&seg->next, memory_order_acquire);
+        if (next == NULL) {
+            return 0;
+        }
+        // seg was frozen before next was linked; entries pushed before that are still
+        // taken first.
+        if (mpmc_seg_pop(seg, out_id)) {
+            return 1;
+        }
+        (void)atomic_compare_exchange_strong_explicit(
+            &q->head, &seg, next, memory_order_acq_rel, memory_order_acquire);
+        seg = atomic_load_explicit(&q->head, memory_order_acquire);
+    }
+    return 0;
+}
+
+size_t mpmc_len(const rt_mpmc* q) {
+    // Snapshot that may already be stale; counts pushes that are still publishing.
+    if (q == NULL) {
+        return 0;
+    }
+    size_t len = 0;
+    const rt_mpmc_seg* seg = atomic_load_explicit(&q->head, memory_order_acquire);
+    while (seg != NULL) {
+        int64_t head = atomic_load_explicit(&seg->head, memory_order_acquire);
+        int64_t tail = atomic_load_explicit(&seg->tail, memory_order_acquire) & ~MPMC_FROZEN;
+        if (tail > head) {
+            len += (size_t)(tail - head);
+        }
+        seg = atomic_load_explicit(&seg->next, memory_order_acquire);
+    }
+    return len;
+}
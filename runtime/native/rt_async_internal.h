@@ -65,6 +65,10 @@ typedef enum {
     WAKER_BLOCKING = 9,
 } waker_kind;
 
+enum {
+    WAKER_KIND_COUNT = 10,
+};
+
 typedef enum {
     SCHED_PARALLEL = 0,
     SCHED_SEEDED = 1,
@@ -75,10 +79,39 @@ typedef struct {
     uint64_t id;
 } waker_key;
 
-typedef struct {
+typedef struct rt_wait_queue rt_wait_queue;
+
+// One registration of a task behind a waker key. Nodes are linked FIFO into the key's
+// queue and into the owning task's registration list, so removal never scans.
+typedef struct rt_waiter {
+    uint64_t task_id;
+    rt_wait_queue* queue;
+    struct rt_waiter* prev;
+    struct rt_waiter* next;
+    struct rt_waiter* task_prev;
+    struct rt_waiter* task_next;
+} rt_waiter;
+
+// Per-key FIFO of waiters, reachable from the executor's key hash. Non-empty net queues
+// are also linked together so the poller only visits sockets that have waiters.
+struct rt_wait_queue {
     waker_key key;
+    rt_waiter* head;
+    rt_waiter* tail;
+    rt_wait_queue* bucket_next;
+    rt_wait_queue* net_prev;
+    rt_wait_queue* net_next;
+};
+
+// Deadline registration in the executor timer heap. A timer wakes task_id once now_ms reaches
+// deadline; the owner keeps the pointer until timer_release, so expiry can be re-checked on
+// the next poll after the heap has dropped it.
+typedef struct rt_timer {
+    uint64_t deadline;
     uint64_t task_id;
-} waiter;
+    size_t heap_index;
+    struct rt_timer* next_free;
+} rt_timer;
 
 typedef enum {
     BLOCKING_JOB_PENDING = 0,
@@ -86,21 +119,57 @@ typedef enum {
     BLOCKING_JOB_CANCELLED = 2,
 } blocking_job_status;
 
+typedef _Atomic uint8_t atomic_u8;
+typedef _Atomic uint32_t atomic_u32;
+typedef _Atomic uint64_t atomic_u64;
+
+// Latency histograms (blocking pool, task profiler) use log2 buckets of microseconds.
+// Bucket 0 counts durations under 1us, bucket b counts [2^(b-1), 2^b) us, and the last
+// bucket also takes everything longer.
+enum {
+    RT_LATENCY_HIST_BUCKETS = 24,
+};
+
+typedef struct rt_deque_buf rt_deque_buf;
+
+// Chase-Lev work-stealing deque of task ids (see rt_async_deque.c). top and bottom sit on
+// separate cache lines so thieves and the owner do not false-share.
 typedef struct {
-    uint64_t* buf;
-    size_t cap;
-    size_t head;
-    size_t len;
+    _Alignas(64) _Atomic int64_t top;
+    _Alignas(64) _Atomic int64_t bottom;
+    _Atomic(rt_deque_buf*) buf;
+    rt_deque_buf* retired;
 } rt_deque;
 
-typedef _Atomic uint8_t atomic_u8;
-typedef _Atomic uint32_t atomic_u32;
+typedef struct rt_mpmc_seg rt_mpmc_seg;
+
+// Unbounded MPMC FIFO of task ids (see rt_async_deque.c): a chain of ring segments that
+// any thread may push to or pop from without a lock. first keeps drained segments
+// reachable; they are never freed.
+typedef struct {
+    _Alignas(64) _Atomic(rt_mpmc_seg*) head;
+    _Alignas(64) _Atomic(rt_mpmc_seg*) tail;
+    rt_mpmc_seg* first;
+} rt_mpmc;
 
 typedef struct rt_worker_ctx rt_worker_ctx;
 
+typedef struct rt_arena_chunk rt_arena_chunk;
+
+// Bump region (see rt_async_arena.c). Allocations come from the head chunk; older chunks
+// only wait for the next rewind or release, which hand all of them back at once.
+typedef struct {
+    rt_arena_chunk* head;
+    size_t used;
+} rt_arena;
+
+// Direct-return poll entry registered by generated code (see rt_async_register_poll_fns).
+typedef void (*rt_poll_fn)(void);
+
 typedef struct rt_task {
     uint64_t id;
     int64_t poll_fn_id;
+    rt_poll_fn poll_fn; // NULL: poll through __surge_poll_call under setjmp
     void* state;
     uint64_t result_bits;
     uint8_t result_kind;
@@ -116,7 +185,9 @@ typedef struct rt_task {
     uint8_t park_prepared;
     uint8_t scope_registered;
     uint8_t cancel_pending;
+    uint8_t frame_rewind; // next frame allocation rewinds frame_arena (set by __task_state)
     atomic_u32 handle_refs;
+    int64_t ready_ns; // profiler: when the task was last queued, 0 when not stamped
     uint64_t resume_bits;
     uint64_t sleep_delay;
     uint64_t sleep_deadline;
@@ -126,13 +197,21 @@ typedef struct rt_task {
     waker_key* wait_keys;
     size_t wait_keys_len;
     size_t wait_keys_cap;
-    uint64_t timeout_task_id;
-    uint64_t* select_timers;
+    rt_timer* sleep_timer;
+    rt_timer* timeout_timer;
+    rt_timer** select_timers;
     size_t select_timers_len;
     size_t select_timers_cap;
-    uint64_t* children;
-    size_t children_len;
-    size_t children_cap;
+    // Intrusive child links: a task heads the list of its live spawned children and sits
+    // in its parent's list and in its scope's list, so linking and unlinking are O(1).
+    struct rt_task* parent;
+    struct rt_task* children;
+    struct rt_task* sibling_prev;
+    struct rt_task* sibling_next;
+    struct rt_task* scope_prev;
+    struct rt_task* scope_next;
+    rt_waiter* waiters;
+    rt_arena frame_arena;
 } rt_task;
 
 typedef struct {
@@ -142,24 +221,55 @@ typedef struct {
     uint8_t failfast_triggered;
     uint64_t failfast_child;
     size_t active_children;
-    uint64_t* children;
-    size_t children_len;
-    size_t children_cap;
+    rt_task* children; // registered children that are not done yet, via scope_prev/next
 } rt_scope;
 
+// Fixed-size record pool: chunks of elem_size records, recycled through an intrusive free
+// list. Records are never handed back to the heap, so a pool only grows to its high water.
+typedef struct {
+    size_t elem_size;
+    size_t elem_align;
+    void* free_list;
+    size_t records;
+} rt_slab;
+
+// Slot ids are (generation << 32) | index. Index 0 is never used, so id 0 stays "none";
+// a freed slot is reused with the next generation, which makes stale ids miss in lookups.
+#define RT_SLOT_INDEX_BITS 32
+#define RT_SLOT_INDEX_MASK ((UINT64_C(1) << RT_SLOT_INDEX_BITS) - 1)
+
+typedef struct {
+    uint64_t* ids;
+    size_t len;
+    size_t cap;
+} rt_slot_ids;
+
 typedef struct {
     uint64_t next_id;
     uint64_t next_scope_id;
     uint64_t now_ms;
     rt_task** tasks;
     size_t tasks_cap;
-    rt_deque inject;
+    rt_slot_ids free_task_ids;
+    rt_slab task_slab;
+    rt_mpmc inject;
     rt_deque* local_queues;
     rt_scope** scopes;
     size_t scopes_cap;
-    waiter* waiters;
+    rt_slot_ids free_scope_ids;
+    rt_slab scope_slab;
+    rt_wait_queue** wait_buckets;
+    size_t wait_buckets_cap;
+    size_t wait_queues_len;
+    rt_wait_queue* net_wait_queues;
+    rt_wait_queue* free_wait_queues;
+    rt_waiter* free_waiters;
     size_t waiters_len;
-    size_t waiters_cap;
+    size_t waiters_by_kind[WAKER_KIND_COUNT];
+    rt_timer** timer_heap;
+    size_t timers_len;
+    size_t timers_cap;
+    rt_timer* free_timers;
     pthread_mutex_t lock;
     pthread_cond_t ready_cv;
     pthread_cond_t io_cv;
@@ -168,7 +278,13 @@ typedef struct {
     rt_worker_ctx* worker_ctxs;
     uint32_t worker_count;
     uint32_t running_count;
+    atomic_u32 running_probes;
+    atomic_u32 inflight_steals;
     uint32_t channel_blocked_workers;
+    uint32_t spinning_workers;
+    rt_worker_ctx* parked_workers;
+    uint32_t idle_spin;
+    uint32_t idle_yield;
     uint8_t worker_net_polling;
     uint32_t compensation_count;
     uint32_t compensation_high_water;
@@ -179,37 +295,87 @@ typedef struct {
     uint64_t sched_seed;
     pthread_mutex_t blocking_lock;
     pthread_cond_t blocking_cv;
-    pthread_t* blocking_workers;
+    pthread_cond_t blocking_monitor_cv;
+    rt_deque blocking_queue;
     uint32_t blocking_count;
+    uint32_t blocking_max;
+    uint32_t blocking_live;
+    uint32_t blocking_peak;
+    uint64_t blocking_grow_ns;
+    uint64_t blocking_idle_ns;
     uint8_t blocking_started;
     uint8_t blocking_shutdown;
+    atomic_u32 blocking_idle;
+    atomic_u8 blocking_monitor_waiting;
+    atomic_u64 blocking_taken;
+    atomic_u32 blocking_spawned;
+    atomic_u32 blocking_retired;
     atomic_u32 blocking_running;
     atomic_u32 blocking_submitted;
     atomic_u32 blocking_completed;
     atomic_u32 blocking_cancel_requested;
-    struct rt_blocking_job* blocking_head;
-    struct rt_blocking_job* blocking_tail;
+    atomic_u64 blocking_wait_hist[RT_LATENCY_HIST_BUCKETS];
+    atomic_u64 blocking_run_hist[RT_LATENCY_HIST_BUCKETS];
+    rt_slab blocking_job_slab;
 } rt_executor;
 
 // Executor invariants:
-// - ex->lock owns tasks[], scopes[], waiters, inject/local queues, running_count,
-//   worker_net_polling, channel_blocked_workers, compensation_count/high-water, timer state, and
+// - ex->lock owns tasks[], scopes[], their free slot ids and record pools, waiters,
+//   running_count, worker_net_polling, channel_blocked_workers,
+//   spinning_workers, parked_workers, compensation_count/high-water, timer state, and
 //   shutdown flags.
 // - task status is atomic so external helpers can observe it, but transitions that
 //   touch queues or waiters still happen under ex->lock.
-// - waiters is a FIFO-by-key registration list. prepare_park may pre-register a
-//   waiter before the task stores TASK_WAITING; wake_task uses wake_token to close
+// - task and scope ids carry a slot generation; get_task/get_scope return NULL for ids
+//   whose slot was freed or reused. blocking_job_slab is guarded by blocking_lock because
+//   blocking workers drop the last job reference without ex->lock.
+// - timers live in a min-heap ordered by deadline: arm and release are O(log n) and the
+//   next deadline is the heap root. Expired timers leave the heap when they fire.
+// - waiters are indexed by waker_key: each key owns a FIFO queue of rt_waiter nodes, and
+//   each task links the nodes it registered. prepare_park may pre-register a waiter
+//   before the task stores TASK_WAITING; wake_task uses wake_token to close
 //   wake-before-park races.
 // - ready queues hold task ids whose enqueued flag is set. Worker threads pop local
-//   queues first, then inject, then steal; non-worker threads inject globally.
+//   queues first, then inject, then steal; non-worker threads and compensation workers
+//   inject globally.
+// - each worker's local queue is a Chase-Lev deque that only that worker pushes and pops;
+//   inject is an MPMC queue. Neither needs ex->lock: ready_push still runs under it for
+//   the task state it changes, but in parallel mode a worker pops its own queue, inject,
+//   and other workers' queues before it takes the lock. It counts itself in
+//   running_probes before its first queue load and moves an id it took into
+//   inflight_steals before it stops counting, so an id is always in a queue or counted.
+//   The id is claimed under ex->lock. runnable_is_empty waits out running probes, which
+//   never wait for ex->lock, so its answer holds for the moment it read the queues.
 // - running_count counts tasks currently being polled. User tasks may poll without
 //   ex->lock, but the increment/decrement around that poll is protected by ex->lock.
 // - channel_blocked_workers counts executor workers parked inside sync channel
 //   helpers after temporarily leaving running_count. Compensation workers are a
 //   fallback for that path, not a normal async parking mechanism.
+// - blocking_queue holds rt_blocking_job pointers. rt_blocking_submit pushes under
+//   ex->lock and pool threads steal FIFO without any lock. blocking_lock guards
+//   blocking_live/peak, blocking_job_slab, and the sleeps on blocking_cv and
+//   blocking_monitor_cv. A pool thread counts itself in blocking_idle, and the monitor
+//   sets blocking_monitor_waiting, before each re-checks the queue under blocking_lock.
+//   Submitters read both after their push, so a job is never left queued while every
+//   thread sleeps.
+// - The pool keeps blocking_count threads. The monitor adds a thread, up to blocking_max,
+//   when jobs have queued with no thread taking one for blocking_grow_ns. A thread above
+//   blocking_count exits after blocking_idle_ns without work.
+// - buffered channels push and pop a lock-free ring and take ex->lock only when the
+//   channel's waiting bits say a task may be parked on it. Anything that registers a
+//   waiter under a channel key must set the bit first (rt_channel_select_waiter_locked
+//   for select) and re-check the channel afterwards.
 // - The I/O thread is signaled when the executor becomes idle, when net waiters are
-//   registered, or when shutdown changes. Workers sleep on ready_cv only after they
-//   fail to find local, injected, stealable, or immediately pollable net work.
+//   registered, or when shutdown changes. Workers park only after they fail to find
+//   local, injected, stealable, or immediately pollable net work, and after their idle
+//   spin. An idle worker counts itself in spinning_workers while it spins without
+//   ex->lock and re-checks the queues under the lock before it parks, so a push that
+//   skips waking a parked worker because someone is spinning cannot be lost.
+// - Parked workers wait on their own idle_cv and are linked on parked_workers; a push
+//   wakes one of them instead of signaling a shared condition. A worker that spun or
+//   parked and then claims a task wakes one more parked worker when work is still queued
+//   and nobody spins, so the wakes a burst skipped are passed along one at a time.
+//   ready_cv is left to workers blocked inside sync channel helpers.
 
 typedef struct rt_channel rt_channel;
 
@@ -227,10 +393,10 @@ typedef struct rt_blocking_job {
     uint64_t state_size;
     uint64_t state_align;
     uint64_t result_bits;
+    int64_t submitted_ns;
     atomic_u8 status;
     atomic_u8 cancel_requested;
     atomic_u32 refs;
-    struct rt_blocking_job* next;
 } rt_blocking_job;
 
 void panic_msg(const char* msg);
@@ -241,6 +407,54 @@ void rt_trace_channel_task_blocking_send(void);
 void rt_trace_channel_task_blocking_recv(void);
 void rt_trace_channel_handoff_yield(void);
 
+// Always-on runtime counters (rt_metrics.c). Each thread bumps its own counter block, so
+// hot paths never touch a shared cache line; rt_metric_total and the metrics snapshot
+// sum the blocks. The order here is the export order.
+typedef enum {
+    RT_METRIC_TASKS_CREATED,
+    RT_METRIC_TASK_POLLS,
+    RT_METRIC_STEALS,
+    RT_METRIC_WAKE_CALLED,
+    RT_METRIC_WAKE_ENQUEUED,
+    RT_METRIC_WAKE_IGNORED_COMPLETED,
+    RT_METRIC_PARK_ATTEMPT,
+    RT_METRIC_PARK_COMMITTED,
+    RT_METRIC_WORKER_SLEEP,
+    RT_METRIC_WORKER_WAKE,
+    RT_METRIC_WORKER_SPIN,
+    RT_METRIC_WORKER_SPIN_HIT,
+    RT_METRIC_CHANNEL_BLOCKING_WAIT,
+    RT_METRIC_CHANNEL_TASK_BLOCKING_SEND,
+    RT_METRIC_CHANNEL_TASK_BLOCKING_RECV,
+    RT_METRIC_CHANNEL_HANDOFF_YIELD,
+    RT_METRIC_COMPENSATION_STARTED,
+    RT_METRIC_NET_POLL_CALLS,
+    RT_METRIC_NET_POLL_TIMEOUTS,
+    RT_METRIC_NET_POLL_WAKE_FD,
+    RT_METRIC_NET_POLL_READY,
+    RT_METRIC_NET_POLL_ERRORS,
+    RT_METRIC_NET_POLL_WAITERS,
+    RT_METRIC_NET_DIRECT_WAIT,
+    RT_METRIC_NET_WAITER_SCAN_ENTRIES,
+    RT_METRIC_NET_WAITER_NET_ENTRIES,
+    RT_METRIC_NET_POLL_REBUILDS,
+    RT_METRIC_NET_POLL_ALLOCS,
+    RT_METRIC_NET_POLL_DEDUP_CHECKS,
+    RT_METRIC_NET_WAITER_COMPLETE_CALLS,
+    RT_METRIC_NET_WAITER_COMPLETED,
+    RT_METRIC_NET_REACTOR_REGISTRATIONS,
+    RT_METRIC_NET_REACTOR_EVENTS,
+    RT_METRIC_COUNTER_COUNT,
+} rt_metric_counter;
+
+void rt_metric_add(rt_metric_counter id, uint64_t delta);
+uint64_t rt_metric_total(rt_metric_counter id);
+void rt_metrics_init(void);
+
+static inline void rt_metric_inc(rt_metric_counter id) {
+    rt_metric_add(id, 1);
+}
+
 static inline uint8_t task_status_load(const rt_task* task) {
     return task == NULL ? TASK_DONE : atomic_load_explicit(&task->status, memory_order_acquire);
 }
@@ -305,6 +519,7 @@ extern uint64_t __surge_blocking_call(uint64_t id, void* state);
 extern rt_executor exec_state;
 extern _Thread_local jmp_buf* poll_env;
 extern _Thread_local int poll_active;
+extern _Thread_local int poll_direct;
 extern _Thread_local poll_outcome poll_result;
 extern _Thread_local waker_key pending_key;
 extern _Thread_local uint64_t tls_current_id;
@@ -330,14 +545,26 @@ void rt_lock(rt_executor* ex);
 void rt_unlock(rt_executor* ex);
 void rt_blocking_init(rt_executor* ex);
 void rt_blocking_request_cancel(rt_executor* ex, rt_task* task);
+void rt_blocking_trace_dump(rt_executor* ex, const char* reason);
+void rt_latency_hist_record(atomic_u64* hist, int64_t ns);
+void rt_latency_hist_append(char* buf, size_t* pos, size_t cap, const atomic_u64* hist);
+void rt_trace_advance(size_t* pos, size_t cap, int n);
 rt_task* get_task(rt_executor* ex, uint64_t id);
 rt_scope* get_scope(rt_executor* ex, uint64_t id);
 
+void* rt_arena_alloc(rt_arena* arena, size_t size, size_t align);
+void rt_arena_rewind(rt_arena* arena);
+void rt_arena_release(rt_arena* arena);
+
+rt_task* task_slot_alloc(rt_executor* ex);
+void task_slot_free(rt_executor* ex, rt_task* task);
+rt_scope* scope_slot_alloc(rt_executor* ex);
+void scope_slot_free(rt_executor* ex, rt_scope* scope);
+struct rt_blocking_job* blocking_job_alloc(rt_executor* ex);
+void blocking_job_free(rt_executor* ex, struct rt_blocking_job* job);
+
 void ensure_task_cap(rt_executor* ex, uint64_t id);
 void ensure_scope_cap(rt_executor* ex, uint64_t id);
-void ensure_waiter_cap(rt_executor* ex);
-void ensure_child_cap(rt_task* task, size_t want);
-void ensure_scope_child_cap(rt_scope* scope, size_t want);
 
 void remove_waiter(rt_executor* ex, waker_key key, uint64_t task_id);
 void add_waiter(rt_executor* ex, waker_key key, uint64_t task_id);
@@ -345,12 +572,30 @@ void clear_wait_keys(rt_executor* ex, rt_task* task);
 void add_wait_key(rt_executor* ex, rt_task* task, waker_key key);
 void prepare_park(rt_executor* ex, rt_task* task, waker_key key, int already_added);
 int pop_waiter(rt_executor* ex, waker_key key, uint64_t* out_id);
+int take_waiter(rt_executor* ex, waker_key key, uint64_t* out_id);
+void remove_task_waiters(rt_executor* ex, rt_task* task);
+int has_net_waiters(const rt_executor* ex);
 uint8_t rt_channel_try_recv_status_locked(rt_executor* ex, void* channel, uint64_t* out_bits);
 uint8_t rt_channel_try_send_status_locked(rt_executor* ex, void* channel, uint64_t value_bits);
+int rt_channel_select_waiter_locked(void* channel, uint8_t send);
 void clear_select_timers(rt_executor* ex, rt_task* task);
+rt_timer* timer_arm(rt_executor* ex, uint64_t task_id, uint64_t deadline);
+void timer_release(rt_executor* ex, rt_timer* timer);
+int timer_expired(const rt_executor* ex, const rt_timer* timer);
+int timer_next_deadline(const rt_executor* ex, uint64_t* out_deadline);
+int timer_fire_due(rt_executor* ex);
+int deque_push(rt_deque* dq, uint64_t id, const char* overflow_msg, const char* alloc_msg);
+int deque_pop(rt_deque* dq, uint64_t* out_id);
+int deque_steal(rt_deque* dq, uint64_t* out_id);
+size_t deque_len(const rt_deque* dq);
+int deque_reserve(rt_deque* dq, const char* overflow_msg, const char* alloc_msg);
+int mpmc_push(rt_mpmc* q, uint64_t id, const char* overflow_msg, const char* alloc_msg);
+int mpmc_pop(rt_mpmc* q, uint64_t* out_id);
+size_t mpmc_len(const rt_mpmc* q);
 void ready_push(rt_executor* ex, uint64_t id);
 int ready_take_current_local_tail(rt_executor* ex, uint64_t id);
 int ready_pop(rt_executor* ex, uint64_t* out_id);
+int runnable_is_empty(const rt_executor* ex);
 void wake_task(rt_executor* ex, uint64_t id, int remove_waiter_flag);
 void wake_channel_task(rt_executor* ex, uint64_t id, int remove_waiter_flag);
 void wake_channel_task_no_signal(rt_executor* ex, uint64_t id, int remove_waiter_flag);
@@ -363,11 +608,11 @@ int next_ready(rt_executor* ex, uint64_t* out_id);
 rt_task* task_from_handle(void* handle);
 uint64_t task_id_from_handle(void* handle);
 
-void task_add_child(rt_task* parent, uint64_t child_id);
-void scope_add_child(rt_scope* scope, uint64_t child_id);
-int scope_remove_child(rt_scope* scope, uint64_t child_id);
+void task_add_child(rt_task* parent, rt_task* child);
+void scope_add_child(rt_scope* scope, rt_task* child);
+int scope_remove_child(rt_scope* scope, rt_task* child);
 void scope_cancel_children_locked(rt_executor* ex, const rt_scope* scope);
-void scope_child_done_locked(rt_executor* ex, rt_scope* scope, uint64_t child_id);
+void scope_child_done_locked(rt_executor* ex, rt_scope* scope, rt_task* child);
 void scope_exit_locked(rt_executor* ex, rt_scope* scope);
 
 void task_add_ref(rt_task* task);
@@ -378,6 +623,7 @@ bool rt_channel_send(void* channel, uint64_t value_bits);
 bool rt_channel_send_yield(void* channel, uint64_t value_bits);
 uint8_t rt_channel_recv(void* channel, uint64_t* out_bits);
 bool rt_channel_try_send(void* channel, uint64_t value_bits);
+uint64_t rt_channel_send_many(void* channel, const uint64_t* values_bits, uint64_t count);
 bool rt_channel_try_recv(void* channel, uint64_t* out_bits);
 void rt_channel_close(void* channel);
 
@@ -386,14 +632,38 @@ void cancel_task(rt_executor* ex, uint64_t id);
 void mark_done(rt_executor* ex, rt_task* task, uint8_t result_kind, uint64_t result_bits);
 void apply_poll_outcome(rt_executor* ex, rt_task* task, poll_outcome outcome);
 
+// Async task profiler (rt_async_profile.c). rt_profile_on is set once, before any worker
+// starts, when SURGE_PROFILE or SURGE_PROFILE_OUT is set; poll_task brackets each poll
+// with begin/end only then, so the disabled cost is one load and branch.
+typedef struct {
+    size_t slot;
+    size_t saved_slot;
+    int64_t start_ns;
+    uint64_t saved_child_ns;
+} rt_profile_frame;
+
+extern int rt_profile_on;
+
+static inline int rt_profile_active(void) {
+    return rt_profile_on;
+}
+
+void rt_profile_init(void);
+void rt_profile_poll_begin(rt_task* task, rt_profile_frame* frame);
+void rt_profile_poll_end(const rt_profile_frame* frame, const poll_outcome* out);
+
 poll_outcome poll_task(rt_executor* ex, rt_task* task);
 poll_outcome poll_blocking_task(rt_executor* ex, rt_task* task);
 int poll_net_waiters(rt_executor* ex, int timeout_ms);
 void rt_net_wake_poll(void);
+void rt_net_poll_set_changed(void);
 void rt_net_trace_dump(const char* reason);
 void rt_trace_drain_signal_dump(void);
 int run_ready_one(rt_executor* ex);
 void run_until_done(rt_executor* ex, const rt_task* task, uint8_t* out_kind, uint64_t* out_bits);
 int rt_wait_current_worker_wakeup(rt_executor* ex, rt_task* task);
+void rt_affinity_init(void);
+int rt_affinity_pin_worker(uint32_t worker_id);
+int rt_affinity_pin_io(void);
 
 #endif
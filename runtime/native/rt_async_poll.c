@@ -21,7 +21,7 @@ static poll_outcome poll_checkpoint_task(const rt_executor* ex, rt_task* task) {
     return out;
 }
 
-static poll_outcome poll_sleep_task(const rt_executor* ex, rt_task* task) {
+static poll_outcome poll_sleep_task(rt_executor* ex, rt_task* task) {
     poll_outcome out = {POLL_NONE, waker_none(), NULL, 0};
     if (ex == NULL || task == NULL) {
         out.kind = POLL_DONE_CANCELLED;
@@ -34,6 +34,7 @@ static poll_outcome poll_sleep_task(const rt_executor* ex, rt_task* task) {
     if (!task->sleep_armed) {
         task->sleep_deadline = ex->now_ms + task->sleep_delay;
         task->sleep_armed = 1;
+        task->sleep_timer = timer_arm(ex, task->id, task->sleep_deadline);
         out.kind = POLL_PARKED;
         out.park_key = timer_key(task->id);
         return out;
@@ -49,25 +50,57 @@ static poll_outcome poll_sleep_task(const rt_executor* ex, rt_task* task) {
 
 static void restore_poll_context(jmp_buf* saved_env,
                                  int saved_active,
+                                 int saved_direct,
                                  poll_outcome saved_result,
                                  waker_key saved_pending) {
     poll_env = saved_env;
     poll_active = saved_active;
+    poll_direct = saved_direct;
     poll_result = saved_result;
     pending_key = saved_pending;
 }
 
+// Direct-return protocol: the terminators record poll_result and return, and the
+// generated poll function returns right after them, so no setjmp is needed.
+static poll_outcome poll_user_task_direct(const rt_task* task) {
+    jmp_buf* saved_env = poll_env;
+    int saved_active = poll_active;
+    int saved_direct = poll_direct;
+    poll_outcome saved_result = poll_result;
+    waker_key saved_pending = pending_key;
+    pending_key = waker_none();
+    poll_result.kind = POLL_NONE;
+    poll_result.park_key = waker_none();
+    poll_result.state = NULL;
+    poll_result.value_bits = 0;
+    poll_env = NULL;
+    poll_active = 1;
+    poll_direct = 1;
+    task->poll_fn();
+    poll_outcome out = poll_result;
+    restore_poll_context(saved_env, saved_active, saved_direct, saved_result, saved_pending);
+    if (out.kind == POLL_NONE) {
+        panic_msg("async poll returned without terminator");
+        out.kind = POLL_DONE_CANCELLED;
+    }
+    return out;
+}
+
 static poll_outcome poll_user_task(const rt_executor* ex, const rt_task* task) {
     poll_outcome out = {POLL_NONE, waker_none(), NULL, 0};
     if (ex == NULL || task == NULL) {
         out.kind = POLL_DONE_CANCELLED;
         return out;
     }
+    if (task->poll_fn != NULL) {
+        return poll_user_task_direct(task);
+    }
     // Single-thread awaits can poll another task while an async poll is already active.
     // Keep the outer poll terminator target intact for when the outer task resumes.
     jmp_buf env;
     jmp_buf* saved_env = poll_env;
     int saved_active = poll_active;
+    int saved_direct = poll_direct;
     poll_outcome saved_result = poll_result;
     waker_key saved_pending = pending_key;
     pending_key = waker_none();
@@ -77,18 +110,32 @@ static poll_outcome poll_user_task(const rt_executor* ex, const rt_task* task) {
     poll_result.value_bits = 0;
     poll_env = &env;
     poll_active = 1;
+    poll_direct = 0;
     if (setjmp(env) == 0) {
         __surge_poll_call((uint64_t)task->poll_fn_id);
-        restore_poll_context(saved_env, saved_active, saved_result, saved_pending);
+        restore_poll_context(saved_env, saved_active, saved_direct, saved_result, saved_pending);
         panic_msg("async poll returned without terminator");
         out.kind = POLL_DONE_CANCELLED;
         return out;
     }
     out = poll_result;
-    restore_poll_context(saved_env, saved_active, saved_result, saved_pending);
+    restore_poll_context(saved_env, saved_active, saved_direct, saved_result, saved_pending);
     return out;
 }
 
+static poll_outcome poll_task_kind(rt_executor* ex, rt_task* task) {
+    switch (task->kind) {
+        case TASK_KIND_CHECKPOINT:
+            return poll_checkpoint_task(ex, task);
+        case TASK_KIND_SLEEP:
+            return poll_sleep_task(ex, task);
+        case TASK_KIND_BLOCKING:
+            return poll_blocking_task(ex, task);
+        default:
+            return poll_user_task(ex, task);
+    }
+}
+
 poll_outcome poll_task(rt_executor* ex, rt_task* task) {
     poll_outcome out = {POLL_NONE, waker_none(), NULL, 0};
     if (task == NULL) {
@@ -130,16 +177,15 @@ poll_outcome poll_task(rt_executor* ex, rt_task* task) {
         out.kind = POLL_DONE_CANCELLED;
         return out;
     }
-    switch (task->kind) {
-        case TASK_KIND_CHECKPOINT:
-            return poll_checkpoint_task(ex, task);
-        case TASK_KIND_SLEEP:
-            return poll_sleep_task(ex, task);
-        case TASK_KIND_BLOCKING:
-            return poll_blocking_task(ex, task);
-        default:
-            return poll_user_task(ex, task);
+    rt_metric_inc(RT_METRIC_TASK_POLLS);
+    if (!rt_profile_active()) {
+        return poll_task_kind(ex, task);
     }
+    rt_profile_frame frame;
+    rt_profile_poll_begin(task, &frame);
+    out = poll_task_kind(ex, task);
+    rt_profile_poll_end(&frame, &out);
+    return out;
 }
 
 int run_ready_one(rt_executor* ex) {
@@ -262,8 +308,17 @@ void run_until_done(rt_executor* ex, const rt_task* task, uint8_t* out_kind, uin
     }
 }
 
+// Ends the current poll: returns to the generated poll function under the direct
+// protocol, or unwinds to poll_user_task otherwise.
+static void poll_leave(void) {
+    if (poll_direct) {
+        return;
+    }
+    longjmp(*poll_env, 1);
+}
+
 void rt_async_yield(void* state) {
-    if (!poll_active || poll_env == NULL) {
+    if (!poll_active || (poll_env == NULL && !poll_direct)) {
         panic_msg("async_yield outside poll");
         return;
     }
@@ -273,7 +328,8 @@ void rt_async_yield(void* state) {
         poll_result.kind = POLL_DONE_CANCELLED;
         poll_result.park_key = waker_none();
         pending_key = waker_none();
-        longjmp(*poll_env, 1);
+        poll_leave();
+        return;
     }
     if (waker_valid(pending_key)) {
         poll_result.kind = POLL_PARKED;
@@ -283,11 +339,11 @@ void rt_async_yield(void* state) {
         poll_result.park_key = waker_none();
     }
     pending_key = waker_none();
-    longjmp(*poll_env, 1);
+    poll_leave();
 }
 
 void rt_async_return(void* state, uint64_t bits) {
-    if (!poll_active || poll_env == NULL) {
+    if (!poll_active || (poll_env == NULL && !poll_direct)) {
         panic_msg("async_return outside poll");
         return;
     }
@@ -296,11 +352,11 @@ void rt_async_return(void* state, uint64_t bits) {
     poll_result.kind = POLL_DONE_SUCCESS;
     poll_result.park_key = waker_none();
     pending_key = waker_none();
-    longjmp(*poll_env, 1);
+    poll_leave();
 }
 
 void rt_async_return_cancelled(void* state) {
-    if (!poll_active || poll_env == NULL) {
+    if (!poll_active || (poll_env == NULL && !poll_direct)) {
         panic_msg("async_cancel outside poll");
         return;
     }
@@ -309,5 +365,5 @@ void rt_async_return_cancelled(void* state) {
     poll_result.kind = POLL_DONE_CANCELLED;
     poll_result.park_key = waker_none();
     pending_key = waker_none();
-    longjmp(*poll_env, 1);
+    poll_leave();
 }
@@ -0,0 +1,376 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
+#include "rt_async_internal.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// Async task profiler.
+//
+// SURGE_PROFILE=1 turns it on for the whole run. Every poll is attributed to a slot: the
+// task's poll function id for user tasks, or one runtime slot per builtin task kind. A
+// slot counts polls, self time (nested inline polls of other tasks are subtracted), the
+// longest poll, park requests by waker kind, and how long the task sat in a ready queue
+// before the poll started. rt_exit prints one PROFILE line per slot to stderr, sorted by
+// self time, with names from the table generated code registers.
+//
+// SURGE_PROFILE_HZ (default 99, 0 disables) also arms an ITIMER_PROF timer. Its SIGPROF
+// handler charges the slot the interrupted thread is polling, or [runtime] outside a poll.
+// SURGE_PROFILE_OUT=<path> implies SURGE_PROFILE and writes those samples to path as
+// folded stacks, one "<function> <samples>" line each, for flamegraph.pl or speedscope.
+
+#define PROFILE_NO_SLOT SIZE_MAX
+
+enum {
+    PROFILE_HZ_DEFAULT = 99,
+    PROFILE_HZ_MAX = 1000,
+    PROFILE_FN_SLOTS_DEFAULT = 64,
+    PROFILE_LINE_MAX = 1024,
+};
+
+// Slots past the poll function ids.
+enum {
+    PROFILE_EXTRA_CHECKPOINT,
+    PROFILE_EXTRA_SLEEP,
+    PROFILE_EXTRA_BLOCKING,
+    PROFILE_EXTRA_UNREGISTERED,
+    PROFILE_EXTRA_RUNTIME,
+    PROFILE_EXTRA_COUNT,
+};
+
+static const char* const profile_extra_names[PROFILE_EXTRA_COUNT] = {
+    "[checkpoint]",
+    "[sleep]",
+    "[blocking]",
+    "[unregistered]",
+    "[runtime]",
+};
+
+static const char* const profile_waker_names[WAKER_KIND_COUNT] = {
+    "none",
+    "join",
+    "timer",
+    "chan_send",
+    "chan_recv",
+    "net_accept",
+    "net_read",
+    "net_write",
+    "scope",
+    "blocking",
+};
+
+typedef struct {
+    atomic_u64 polls;
+    atomic_u64 self_ns;
+    atomic_u64 max_ns;
+    atomic_u64 samples;
+    atomic_u64 parks[WAKER_KIND_COUNT];
+    atomic_u64 wake_hist[RT_LATENCY_HIST_BUCKETS];
+} profile_slot;
+
+int rt_profile_on;
+
+static const char* const* poll_names;
+static uint64_t poll_names_len;
+static profile_slot* profile_slots;
+static size_t profile_fn_slots;
+static uint32_t profile_hz;
+static const char* profile_out_path;
+static atomic_int profile_dumped;
+
+// Slot of the poll running on this thread, read by the SIGPROF handler on the same thread.
+static _Thread_local volatile size_t profile_current_slot = PROFILE_NO_SLOT;
+// Wall time spent in polls nested inside the current one, subtracted from its self time.
+static _Thread_local uint64_t profile_child_ns;
+
+void rt_async_register_poll_names(const char* const* names, uint64_t len) {
+    // Called once from a global constructor, before any task exists.
+    poll_names = names;
+    poll_names_len = names != NULL ? len : 0;
+}
+
+static int profile_env_flag(const char* name) {
+    const char* value = getenv(name);
+    return value != NULL && value[0] != '\0' && !(value[0] == '0' && value[1] == '\0');
+}
+
+static uint32_t profile_env_hz(void) {
+    const char* value = getenv("SURGE_PROFILE_HZ");
+    if (value == NULL || value[0] == '\0') {
+        return PROFILE_HZ_DEFAULT;
+    }
+    char* end = NULL;
+    long parsed = strtol(value, &end, 10); // NOLINT(runtime/int)
+    if (end == value || parsed < 0) {
+        return PROFILE_HZ_DEFAULT;
+    }
+    return parsed > PROFILE_HZ_MAX ? PROFILE_HZ_MAX : (uint32_t)parsed;
+}
+
+static void profile_sigprof(int sig) {
+    (void)sig;
+    size_t slot = profile_current_slot;
+    if (slot == PROFILE_NO_SLOT) {
+        slot = profile_fn_slots + PROFILE_EXTRA_RUNTIME;
+    }
+    (void)atomic_fetch_add_explicit(&profile_slots[slot].samples, 1, memory_order_relaxed);
+}
+
+static void profile_set_timer(uint32_t hz) {
+#if defined(SIGPROF) && defined(ITIMER_PROF)
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    if (hz > 0) {
+        timer.it_interval.tv_usec = (suseconds_t)(1000000U / hz);
+        timer.it_value = timer.it_interval;
+    }
+    (void)setitimer(ITIMER_PROF, &timer, NULL);
+#else
+    (void)hz;
+#endif
+}
+
+static void profile_start_sampling(void) {
+#if defined(SIGPROF) && defined(ITIMER_PROF)
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = profile_sigprof;
+    sigemptyset(&action.sa_mask);
+    // Runtime syscalls retry on EINTR; SA_RESTART covers the rest.
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, NULL) != 0) {
+        profile_hz = 0;
+        return;
+    }
+    profile_set_timer(profile_hz);
+#else
+    profile_hz = 0;
+#endif
+}
+
+void rt_profile_init(void) {
+    // Called from exec_init_once before any worker starts.
+    profile_out_path = getenv("SURGE_PROFILE_OUT");
+    if (profile_out_path != NULL && profile_out_path[0] == '\0') {
+        profile_out_path = NULL;
+    }
+    if (profile_out_path == NULL && !profile_env_flag("SURGE_PROFILE")) {
+        return;
+    }
+    profile_fn_slots = poll_names_len > 0 ? (size_t)poll_names_len : PROFILE_FN_SLOTS_DEFAULT;
+    profile_slots =
+        (profile_slot*)calloc(profile_fn_slots + PROFILE_EXTRA_COUNT, sizeof(profile_slot));
+    if (profile_slots == NULL) {
+        return;
+    }
+    profile_hz = profile_env_hz();
+    rt_profile_on = 1;
+    if (profile_hz > 0) {
+        profile_start_sampling();
+    }
+}
+
+static size_t profile_slot_for(const rt_task* task) {
+    switch (task->kind) {
+        case TASK_KIND_CHECKPOINT:
+            return profile_fn_slots + PROFILE_EXTRA_CHECKPOINT;
+        case TASK_KIND_SLEEP:
+            return profile_fn_slots + PROFILE_EXTRA_SLEEP;
+        case TASK_KIND_BLOCKING:
+            return profile_fn_slots + PROFILE_EXTRA_BLOCKING;
+        default:
+            break;
+    }
+    if (task->poll_fn_id < 0 || (uint64_t)task->poll_fn_id >= profile_fn_slots) {
+        return profile_fn_slots + PROFILE_EXTRA_UNREGISTERED;
+    }
+    return (size_t)task->poll_fn_id;
+}
+
+void rt_profile_poll_begin(rt_task* task, rt_profile_frame* frame) {
+    int64_t now = rt_monotonic_now();
+    size_t slot = profile_slot_for(task);
+    if (task->ready_ns != 0) {
+        rt_latency_hist_record(profile_slots[slot].wake_hist, now - task->ready_ns);
+        task->ready_ns = 0;
+    }
+    frame->slot = slot;
+    frame->saved_slot = profile_current_slot;
+    frame->start_ns = now;
+    frame->saved_child_ns = profile_child_ns;
+    profile_child_ns = 0;
+    profile_current_slot = slot;
+}
+
+void rt_profile_poll_end(const rt_profile_frame* frame, const poll_outcome* out) {
+    int64_t now = rt_monotonic_now();
+    uint64_t elapsed = now > frame->start_ns ? (uint64_t)(now - frame->start_ns) : 0;
+    uint64_t self = elapsed > profile_child_ns ? elapsed - profile_child_ns : 0;
+    profile_slot* s = &profile_slots[frame->slot];
+    (void)atomic_fetch_add_explicit(&s->polls, 1, memory_order_relaxed);
+    (void)atomic_fetch_add_explicit(&s->self_ns, self, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&s->max_ns, memory_order_relaxed);
+    while (self > max &&
+           !atomic_compare_exchange_weak_explicit(
+               &s->max_ns, &max, self, memory_order_relaxed, memory_order_relaxed)) {
+    }
+    if (out->kind == POLL_PARKED && out->park_key.kind < WAKER_KIND_COUNT) {
+        (void)atomic_fetch_add_explicit(&s->parks[out->park_key.kind], 1, memory_order_relaxed);
+    }
+    profile_current_slot = frame->saved_slot;
+    profile_child_ns = frame->saved_child_ns + elapsed;
+}
+
+static const char* profile_slot_name(size_t slot, char* buf, size_t cap) {
+    if (slot >= profile_fn_slots) {
+        return profile_extra_names[slot - profile_fn_slots];
+    }
+    if (slot < poll_names_len && poll_names[slot] != NULL) {
+        return poll_names[slot];
+    }
+    (void)snprintf(buf, cap, "poll#%llu", (unsigned long long)slot);
+    return buf;
+}
+
+static uint64_t profile_load(const atomic_u64* value) {
+    return atomic_load_explicit(value, memory_order_relaxed);
+}
+
+static int profile_slot_cmp(const void* a, const void* b) {
+    const profile_slot* sa = &profile_slots[*(const size_t*)a];
+    const profile_slot* sb = &profile_slots[*(const size_t*)b];
+    uint64_t na = profile_load(&sa->self_ns);
+    uint64_t nb = profile_load(&sb->self_ns);
+    if (na != nb) {
+        return na < nb ? 1 : -1;
+    }
+    uint64_t pa = profile_load(&sa->polls);
+    uint64_t pb = profile_load(&sb->polls);
+    if (pa != pb) {
+        return pa < pb ? 1 : -1;
+    }
+    size_t ia = *(const size_t*)a;
+    size_t ib = *(const size_t*)b;
+    return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+static void profile_append_parks(char* buf, size_t* pos, size_t cap, const profile_slot* s) {
+    // Non-zero park requests as <waker kind>:<count>, comma separated.
+    int first = 1;
+    for (size_t k = 0; k < WAKER_KIND_COUNT; k++) {
+        uint64_t count = profile_load(&s->parks[k]);
+        if (count == 0 || *pos + 1 >= cap) {
+            continue;
+        }
+        rt_trace_advance(pos,
+                         cap,
+                         snprintf(buf + *pos,
+                                  cap - *pos,
+                                  "%s%s:%llu",
+                                  first ? "" : ",",
+                                  profile_waker_names[k],
+                                  (unsigned long long)count));
+        first = 0;
+    }
+    if (first && *pos + 1 < cap) {
+        buf[(*pos)++] = '-';
+    }
+}
+
+static void profile_report(const size_t* order, size_t len) {
+    char buf[PROFILE_LINE_MAX];
+    uint64_t polls = 0;
+    uint64_t samples = 0;
+    for (size_t i = 0; i < profile_fn_slots + PROFILE_EXTRA_COUNT; i++) {
+        polls += profile_load(&profile_slots[i].polls);
+        samples += profile_load(&profile_slots[i].samples);
+    }
+    int n = snprintf(buf,
+                     sizeof(buf),
+                     "PROFILE_SUMMARY hz=%u polls=%llu samples=%llu slots=%llu\n",
+                     (unsigned)profile_hz,
+                     (unsigned long long)polls,
+                     (unsigned long long)samples,
+                     (unsigned long long)len);
+    if (n > 0) {
+        (void)write(STDERR_FILENO, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+    }
+    for (size_t i = 0; i < len; i++) {
+        const profile_slot* s = &profile_slots[order[i]];
+        char name_buf[32];
+        const char* name = profile_slot_name(order[i], name_buf, sizeof(name_buf));
+        n = snprintf(buf,
+                     sizeof(buf),
+                     "PROFILE fn=%s polls=%llu self_us=%llu max_us=%llu samples=%llu parks=",
+                     name,
+                     (unsigned long long)profile_load(&s->polls),
+                     (unsigned long long)(profile_load(&s->self_ns) / 1000U),
+                     (unsigned long long)(profile_load(&s->max_ns) / 1000U),
+                     (unsigned long long)profile_load(&s->samples));
+        if (n < 0) {
+            continue;
+        }
+        size_t pos = 0;
+        rt_trace_advance(&pos, sizeof(buf), n);
+        profile_append_parks(buf, &pos, sizeof(buf), s);
+        rt_trace_advance(&pos, sizeof(buf), snprintf(buf + pos, sizeof(buf) - pos, " wake_us="));
+        rt_latency_hist_append(buf, &pos, sizeof(buf), s->wake_hist);
+        if (pos + 1 < sizeof(buf)) {
+            buf[pos++] = '\n';
+        }
+        (void)write(STDERR_FILENO, buf, pos);
+    }
+}
+
+static void profile_write_folded(const size_t* order, size_t len) {
+    FILE* f = fopen(profile_out_path, "w");
+    if (f == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        uint64_t samples = profile_load(&profile_slots[order[i]].samples);
+        if (samples == 0) {
+            continue;
+        }
+        char name_buf[32];
+        const char* name = profile_slot_name(order[i], name_buf, sizeof(name_buf));
+        // Spaces and semicolons separate counts and frames in the folded format.
+        for (const char* c = name; *c != '\0'; c++) {
+            (void)fputc(*c == ' ' || *c == ';' ? '_' : *c, f);
+        }
+        (void)fprintf(f, " %llu\n", (unsigned long long)samples);
+    }
+    (void)fclose(f);
+}
+
+void rt_profile_dump_exit(void) {
+    if (!rt_profile_on || atomic_exchange_explicit(&profile_dumped, 1, memory_order_relaxed)) {
+        return;
+    }
+    if (profile_hz > 0) {
+        profile_set_timer(0);
+    }
+    size_t total = profile_fn_slots + PROFILE_EXTRA_COUNT;
+    size_t* order = (size_t*)malloc(total * sizeof(size_t));
+    if (order == NULL) {
+        return;
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < total; i++) {
+        const profile_slot* s = &profile_slots[i];
+        if (profile_load(&s->polls) != 0 || profile_load(&s->samples) != 0) {
+            order[len++] = i;
+        }
+    }
+    qsort(order, len, sizeof(size_t), profile_slot_cmp);
+    profile_report(order, len);
+    if (profile_out_path != NULL) {
+        profile_write_folded(order, len);
+    }
+    free(order);
+}
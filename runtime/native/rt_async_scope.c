@@ -13,22 +13,18 @@ void* rt_scope_enter(bool failfast) {
         panic_msg("rt_scope_enter without current task");
         return NULL;
     }
-    uint64_t id = ex->next_scope_id++;
-    ensure_scope_cap(ex, id);
-    rt_scope* scope = (rt_scope*)rt_alloc(sizeof(rt_scope), _Alignof(rt_scope));
+    rt_scope* scope = scope_slot_alloc(ex);
     if (scope == NULL) {
         rt_unlock(ex);
         panic_msg("async: scope allocation failed");
         return NULL;
     }
-    memset(scope, 0, sizeof(rt_scope));
-    scope->id = id;
+    uint64_t id = scope->id;
     scope->owner = rt_current_task_id();
     scope->failfast = failfast ? 1 : 0;
     scope->failfast_triggered = 0;
     scope->failfast_child = 0;
     scope->active_children = 0;
-    ex->scopes[id] = scope;
     rt_task* owner = rt_current_task();
     if (owner != NULL) {
         owner->scope_id = id;
@@ -60,7 +56,7 @@ void rt_scope_register_child(const void* scope_handle, void* task) {
         return;
     }
     if (task_status_load(child) != TASK_DONE) {
-        scope_add_child(scope, child_id);
+        scope_add_child(scope, child);
         child->parent_scope_id = scope_id;
         child->scope_registered = 1;
         scope->active_children++;
@@ -158,13 +154,5 @@ void scope_exit_locked(rt_executor* ex, rt_scope* scope) {
             owner->scope_id = 0;
         }
     }
-    if (scope->children != NULL && scope->children_cap > 0) {
-        rt_free((uint8_t*)scope->children,
-                (uint64_t)scope->children_cap * (uint64_t)sizeof(uint64_t),
-                _Alignof(uint64_t));
-    }
-    rt_free((uint8_t*)scope, sizeof(rt_scope), _Alignof(rt_scope));
-    if (scope_id < ex->scopes_cap) {
-        ex->scopes[scope_id] = NULL;
-    }
+    scope_slot_free(ex, scope);
 }
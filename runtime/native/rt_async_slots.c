@@ -0,0 +1,187 @@
+#include "rt_async_internal.h"
+
+// Slot pools: record recycling and generational ids for tasks, scopes and blocking jobs.
+//
+// Task and scope records come from executor slabs and go back there when freed. Their ids
+// pack a slot index with a generation; a freed slot pushes its next-generation id onto a
+// LIFO stack, so churn reuses recently touched slots and tasks[]/scopes[] stay bounded by
+// the live high water rather than by the number of records ever created. Holding a stale
+// id is safe: lookups compare the full id and miss once the slot has moved on.
+//
+// Task and scope pools run under ex->lock. The blocking job pool is guarded by
+// blocking_lock, because blocking workers drop the last job reference without ex->lock.
+
+#define SLAB_CHUNK_BYTES 16384u
+#define SLOT_GENERATION_MAX ((UINT64_C(1) << (64 - RT_SLOT_INDEX_BITS)) - 1)
+
+static void* slab_take(rt_slab* slab, size_t elem_size, size_t elem_align, const char* alloc_msg) {
+    if (slab->elem_size == 0) {
+        slab->elem_size = elem_size;
+        slab->elem_align = elem_align;
+    }
+    if (slab->free_list == NULL) {
+        size_t per_chunk = SLAB_CHUNK_BYTES / elem_size;
+        if (per_chunk == 0) {
+            per_chunk = 1;
+        }
+        uint8_t* chunk =
+            (uint8_t*)rt_alloc((uint64_t)(per_chunk * elem_size), (uint64_t)elem_align);
+        if (chunk == NULL) {
+            panic_msg(alloc_msg);
+            return NULL;
+        }
+        for (size_t i = per_chunk; i > 0; i--) {
+            void* rec = chunk + (i - 1) * elem_size;
+            memcpy(rec, &slab->free_list, sizeof(void*));
+            slab->free_list = rec;
+        }
+        slab->records += per_chunk;
+    }
+    void* rec = slab->free_list;
+    memcpy(&slab->free_list, rec, sizeof(void*));
+    memset(rec, 0, elem_size);
+    return rec;
+}
+
+static void slab_put(rt_slab* slab, void* rec) {
+    memcpy(rec, &slab->free_list, sizeof(void*));
+    slab->free_list = rec;
+}
+
+static uint64_t slot_id_take(rt_slot_ids* free_ids, uint64_t* next_id, const char* overflow_msg) {
+    if (free_ids->len > 0) {
+        return free_ids->ids[--free_ids->len];
+    }
+    if (*next_id == 0 || *next_id > RT_SLOT_INDEX_MASK) {
+        panic_msg(overflow_msg);
+        return 0;
+    }
+    return (*next_id)++;
+}
+
+static void slot_id_put(rt_slot_ids* free_ids, uint64_t id, const char* alloc_msg) {
+    uint64_t generation = id >> RT_SLOT_INDEX_BITS;
+    if (generation >= SLOT_GENERATION_MAX) {
+        // The slot has used every generation; retire it instead of letting ids wrap.
+        return;
+    }
+    if (free_ids->len >= free_ids->cap) {
+        size_t next_cap = free_ids->cap == 0 ? 64 : free_ids->cap * 2;
+        if (next_cap > SIZE_MAX / sizeof(uint64_t)) {
+            panic_msg(alloc_msg);
+            return;
+        }
+        uint64_t* next = (uint64_t*)rt_realloc((uint8_t*)free_ids->ids,
+                                               (uint64_t)(free_ids->cap * sizeof(uint64_t)),
+                                               (uint64_t)(next_cap * sizeof(uint64_t)),
+                                               _Alignof(uint64_t));
+        if (next == NULL) {
+            panic_msg(alloc_msg);
+            return;
+        }
+        free_ids->ids = next;
+        free_ids->cap = next_cap;
+    }
+    free_ids->ids[free_ids->len++] = ((generation + 1) << RT_SLOT_INDEX_BITS) |
+                                     (id & RT_SLOT_INDEX_MASK);
+}
+
+rt_task* task_slot_alloc(rt_executor* ex) {
+    // Caller holds ex->lock; returns a zeroed record already published under its id.
+    if (ex == NULL) {
+        return NULL;
+    }
+    uint64_t id = slot_id_take(&ex->free_task_ids, &ex->next_id, "async: task capacity overflow");
+    if (id == 0) {
+        return NULL;
+    }
+    ensure_task_cap(ex, id);
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (idx >= ex->tasks_cap) {
+        return NULL;
+    }
+    rt_task* task = (rt_task*)slab_take(
+        &ex->task_slab, sizeof(rt_task), _Alignof(rt_task), "async: task allocation failed");
+    if (task == NULL) {
+        return NULL;
+    }
+    task->id = id;
+    ex->tasks[idx] = task;
+    rt_metric_inc(RT_METRIC_TASKS_CREATED);
+    return task;
+}
+
+void task_slot_free(rt_executor* ex, rt_task* task) {
+    // Caller holds ex->lock and has already released everything the task owns.
+    if (ex == NULL || task == NULL) {
+        return;
+    }
+    size_t idx = (size_t)(task->id & RT_SLOT_INDEX_MASK);
+    if (idx != 0 && idx < ex->tasks_cap && ex->tasks[idx] == task) {
+        ex->tasks[idx] = NULL;
+        slot_id_put(&ex->free_task_ids, task->id, "async: task allocation failed");
+    }
+    task->id = 0;
+    slab_put(&ex->task_slab, task);
+}
+
+rt_scope* scope_slot_alloc(rt_executor* ex) {
+    // Caller holds ex->lock; returns a zeroed record already published under its id.
+    if (ex == NULL) {
+        return NULL;
+    }
+    uint64_t id =
+        slot_id_take(&ex->free_scope_ids, &ex->next_scope_id, "async: scope capacity overflow");
+    if (id == 0) {
+        return NULL;
+    }
+    ensure_scope_cap(ex, id);
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (idx >= ex->scopes_cap) {
+        return NULL;
+    }
+    rt_scope* scope = (rt_scope*)slab_take(
+        &ex->scope_slab, sizeof(rt_scope), _Alignof(rt_scope), "async: scope allocation failed");
+    if (scope == NULL) {
+        return NULL;
+    }
+    scope->id = id;
+    ex->scopes[idx] = scope;
+    return scope;
+}
+
+void scope_slot_free(rt_executor* ex, rt_scope* scope) {
+    // Caller holds ex->lock and the scope has no registered children left.
+    if (ex == NULL || scope == NULL) {
+        return;
+    }
+    size_t idx = (size_t)(scope->id & RT_SLOT_INDEX_MASK);
+    if (idx != 0 && idx < ex->scopes_cap && ex->scopes[idx] == scope) {
+        ex->scopes[idx] = NULL;
+        slot_id_put(&ex->free_scope_ids, scope->id, "async: scope allocation failed");
+    }
+    scope->id = 0;
+    slab_put(&ex->scope_slab, scope);
+}
+
+rt_blocking_job* blocking_job_alloc(rt_executor* ex) {
+    if (ex == NULL) {
+        return NULL;
+    }
+    pthread_mutex_lock(&ex->blocking_lock);
+    rt_blocking_job* job = (rt_blocking_job*)slab_take(&ex->blocking_job_slab,
+                                                       sizeof(rt_blocking_job),
+                                                       _Alignof(rt_blocking_job),
+                                                       "async: blocking job allocation failed");
+    pthread_mutex_unlock(&ex->blocking_lock);
+    return job;
+}
+
+void blocking_job_free(rt_executor* ex, rt_blocking_job* job) {
+    if (ex == NULL || job == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&ex->blocking_lock);
+    slab_put(&ex->blocking_job_slab, job);
+    pthread_mutex_unlock(&ex->blocking_lock);
+}
@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -25,17 +26,50 @@
 rt_executor exec_state;
 _Thread_local jmp_buf* poll_env;
 _Thread_local int poll_active = 0;
+_Thread_local int poll_direct = 0;
 _Thread_local poll_outcome poll_result;
 _Thread_local waker_key pending_key;
 _Thread_local uint64_t tls_current_id;
 _Thread_local rt_task* tls_current_task;
 _Thread_local int tls_worker_id = -1;
+// The current worker's own ready queue; NULL on compensation workers and non-worker threads.
+static _Thread_local rt_deque* tls_local_queue;
 static pthread_once_t exec_once = PTHREAD_ONCE_INIT;
 
 struct rt_worker_ctx {
     rt_executor* ex;
     uint32_t worker_id;
+    // &ex->local_queues[worker_id], or NULL on a compensation worker: those share
+    // worker_id with the worker they stand in for and push to inject instead.
+    rt_deque* local;
     uint64_t sched_rng;
+    // Idle state, guarded by ex->lock. A parked worker waits on idle_cv while linked on
+    // ex->parked_workers; whoever unlinks it clears parked and signals idle_cv.
+    pthread_cond_t idle_cv;
+    rt_worker_ctx* next_parked;
+    uint8_t parked;
+    // Current spin length, between IDLE_SPIN_FLOOR and ex->idle_spin: doubled when a spin
+    // finds work and halved when it ends in a park.
+    uint32_t spin_budget;
+};
+
+// Default idle policy: checks for work spun through before yielding, and sched_yield
+// rounds before parking. SURGE_IDLE_SPIN and SURGE_IDLE_YIELD override them; 0 and 0
+// park as soon as the queues are empty.
+enum {
+    IDLE_SPIN_DEFAULT = 256,
+    IDLE_YIELD_DEFAULT = 1,
+    IDLE_SPIN_FLOOR = 16,
+};
+
+// Elastic blocking pool defaults: hard thread cap, how long queued jobs may sit with
+// every pool thread busy before the pool grows, and how long a thread above the core
+// size stays idle before it exits. SURGE_BLOCKING_MAX_THREADS, SURGE_BLOCKING_GROW_US,
+// and SURGE_BLOCKING_IDLE_MS override them.
+enum {
+    BLOCKING_MAX_DEFAULT = 512,
+    BLOCKING_GROW_US_DEFAULT = 1000,
+    BLOCKING_IDLE_MS_DEFAULT = 10000,
 };
 
 enum {
@@ -46,18 +80,6 @@ enum {
 
 static volatile sig_atomic_t trace_exec_enabled_flag = 0;
 static volatile sig_atomic_t trace_sched_enabled_flag = 0;
-static _Atomic uint64_t trace_wake_called_total;
-static _Atomic uint64_t trace_wake_enqueued_total;
-static _Atomic uint64_t trace_wake_ignored_completed_total;
-static _Atomic uint64_t trace_park_attempt_total;
-static _Atomic uint64_t trace_park_committed_total;
-static _Atomic uint64_t trace_worker_sleep_total;
-static _Atomic uint64_t trace_worker_wake_total;
-static _Atomic uint64_t trace_channel_blocking_wait_total;
-static _Atomic uint64_t trace_channel_task_blocking_send_total;
-static _Atomic uint64_t trace_channel_task_blocking_recv_total;
-static _Atomic uint64_t trace_channel_handoff_yield_total;
-static _Atomic uint64_t trace_compensation_started_total;
 static uint64_t trace_sched_hash;
 static uint64_t trace_sched_events;
 static uint64_t trace_sched_local_pops;
@@ -120,23 +142,16 @@ static int trace_sched_enabled(void) {
     return trace_sched_enabled_flag != 0;
 }
 
-static void trace_exec_inc(_Atomic uint64_t* counter) {
-    if (!rt_exec_trace_enabled() || counter == NULL) {
-        return;
-    }
-    (void)atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
-}
-
 void rt_trace_channel_task_blocking_send(void) {
-    trace_exec_inc(&trace_channel_task_blocking_send_total);
+    rt_metric_inc(RT_METRIC_CHANNEL_TASK_BLOCKING_SEND);
 }
 
 void rt_trace_channel_task_blocking_recv(void) {
-    trace_exec_inc(&trace_channel_task_blocking_recv_total);
+    rt_metric_inc(RT_METRIC_CHANNEL_TASK_BLOCKING_RECV);
 }
 
 void rt_trace_channel_handoff_yield(void) {
-    trace_exec_inc(&trace_channel_handoff_yield_total);
+    rt_metric_inc(RT_METRIC_CHANNEL_HANDOFF_YIELD);
 }
 
 static void
@@ -178,77 +193,39 @@ static void trace_exec_dump(const char* reason) {
         pos = trace_exec_append_literal(buf, pos, sizeof(buf), " ");
     }
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), "wake_called=");
-    pos =
-        trace_exec_append_u64(buf,
-                              pos,
-                              sizeof(buf),
-                              atomic_load_explicit(&trace_wake_called_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WAKE_CALLED));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " wake_enqueued=");
-    pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_wake_enqueued_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WAKE_ENQUEUED));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " wake_ignored_completed=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_wake_ignored_completed_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WAKE_IGNORED_COMPLETED));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " park_attempt=");
-    pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_park_attempt_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_PARK_ATTEMPT));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " park_committed=");
-    pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_park_committed_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_PARK_COMMITTED));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " worker_sleep=");
-    pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_worker_sleep_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WORKER_SLEEP));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " worker_wake=");
-    pos =
-        trace_exec_append_u64(buf,
-                              pos,
-                              sizeof(buf),
-                              atomic_load_explicit(&trace_worker_wake_total, memory_order_relaxed));
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WORKER_WAKE));
+    pos = trace_exec_append_literal(buf, pos, sizeof(buf), " worker_spin=");
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WORKER_SPIN));
+    pos = trace_exec_append_literal(buf, pos, sizeof(buf), " worker_spin_hit=");
+    pos = trace_exec_append_u64(buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_WORKER_SPIN_HIT));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " channel_blocking_wait=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_channel_blocking_wait_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_CHANNEL_BLOCKING_WAIT));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " channel_task_blocking_send=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_channel_task_blocking_send_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_CHANNEL_TASK_BLOCKING_SEND));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " channel_task_blocking_recv=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_channel_task_blocking_recv_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_CHANNEL_TASK_BLOCKING_RECV));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " channel_handoff_yield=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_channel_handoff_yield_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_CHANNEL_HANDOFF_YIELD));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " compensation_started=");
     pos = trace_exec_append_u64(
-        buf,
-        pos,
-        sizeof(buf),
-        atomic_load_explicit(&trace_compensation_started_total, memory_order_relaxed));
+        buf, pos, sizeof(buf), rt_metric_total(RT_METRIC_COMPENSATION_STARTED));
     pos = trace_exec_append_literal(buf, pos, sizeof(buf), " blocking_submitted=");
     pos = trace_exec_append_u64(
         buf,
@@ -321,7 +298,7 @@ static void trace_exec_snapshot_dump(const char* reason) {
     rt_lock(ex);
     if (ex->local_queues != NULL) {
         for (uint32_t i = 0; i < ex->worker_count; i++) {
-            uint64_t len = (uint64_t)ex->local_queues[i].len;
+            uint64_t len = (uint64_t)deque_len(&ex->local_queues[i]);
             local_total += len;
             if (len > local_max) {
                 local_max = len;
@@ -380,33 +357,15 @@ static void trace_exec_snapshot_dump(const char* reason) {
                 break;
         }
     }
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        switch ((waker_kind)ex->waiters[i].key.kind) {
-            case WAKER_JOIN:
-            case WAKER_SCOPE:
-            case WAKER_BLOCKING:
-                waiters_join++;
-                break;
-            case WAKER_TIMER:
-                waiters_timer++;
-                break;
-            case WAKER_CHAN_SEND:
-                waiters_chan_send++;
-                break;
-            case WAKER_CHAN_RECV:
-                waiters_chan_recv++;
-                break;
-            case WAKER_NET_ACCEPT:
-            case WAKER_NET_READ:
-            case WAKER_NET_WRITE:
-                waiters_net++;
-                break;
-            case WAKER_NONE:
-            default:
-                waiters_other++;
-                break;
-        }
-    }
+    waiters_join = (uint64_t)(ex->waiters_by_kind[WAKER_JOIN] + ex->waiters_by_kind[WAKER_SCOPE] +
+                              ex->waiters_by_kind[WAKER_BLOCKING]);
+    waiters_timer = (uint64_t)ex->waiters_by_kind[WAKER_TIMER];
+    waiters_chan_send = (uint64_t)ex->waiters_by_kind[WAKER_CHAN_SEND];
+    waiters_chan_recv = (uint64_t)ex->waiters_by_kind[WAKER_CHAN_RECV];
+    waiters_net =
+        (uint64_t)(ex->waiters_by_kind[WAKER_NET_ACCEPT] + ex->waiters_by_kind[WAKER_NET_READ] +
+                   ex->waiters_by_kind[WAKER_NET_WRITE]);
+    waiters_other = (uint64_t)ex->waiters_by_kind[WAKER_NONE];
 
     char buf[1800];
     size_t pos = 0;
@@ -423,7 +382,8 @@ static void trace_exec_snapshot_dump(const char* reason) {
         buf, &pos, sizeof(buf), "compensation", (uint64_t)ex->compensation_count);
     trace_exec_append_kv_u64(
         buf, &pos, sizeof(buf), "compensation_high_water", (uint64_t)ex->compensation_high_water);
-    trace_exec_append_kv_u64(buf, &pos, sizeof(buf), "inject_len", (uint64_t)ex->inject.len);
+    trace_exec_append_kv_u64(
+        buf, &pos, sizeof(buf), "inject_len", (uint64_t)mpmc_len(&ex->inject));
     trace_exec_append_kv_u64(buf, &pos, sizeof(buf), "local_total", local_total);
     trace_exec_append_kv_u64(buf, &pos, sizeof(buf), "local_max", local_max);
     trace_exec_append_kv_u64(buf, &pos, sizeof(buf), "waiters", (uint64_t)ex->waiters_len);
@@ -480,6 +440,7 @@ static void trace_dump_all(const char* reason) {
     trace_exec_dump(reason);
     if (rt_exec_trace_enabled()) {
         rt_net_trace_dump(reason);
+        rt_blocking_trace_dump(&exec_state, reason);
     }
     trace_exec_snapshot_dump(reason);
 }
@@ -632,6 +593,24 @@ static uint32_t rt_env_blocking_count(void) {
     return (uint32_t)parsed;
 }
 
+// rt_env_u32 reads a non-negative count; 0 is a valid setting, unlike the thread counts.
+static uint32_t rt_env_u32(const char* name, uint32_t fallback) {
+    const char* value = getenv(name);
+    if (value == NULL || value[0] == '\0') {
+        return fallback;
+    }
+    errno = 0;
+    char* end = NULL;
+    long parsed = strtol(value, &end, 10);
+    if (end == value || errno != 0 || parsed < 0) {
+        return fallback;
+    }
+    if ((unsigned long)parsed > UINT32_MAX) { // NOLINT(runtime/int)
+        return UINT32_MAX;
+    }
+    return (uint32_t)parsed;
+}
+
 // Seeded scheduler mode provides deterministic scheduler choices given the same seed and the same
 // arrival order of external events; it does not control I/O timing or OS thread interleavings.
 static uint8_t rt_env_sched_mode(void) {
@@ -697,10 +676,12 @@ static uint32_t rt_default_blocking_count(uint32_t workers) {
 }
 
 static void rt_start_workers(rt_executor* ex);
+static void worker_ctx_init_idle(const rt_executor* ex, rt_worker_ctx* ctx);
+static int wake_parked_worker_locked(rt_executor* ex);
 static void* rt_worker_main(void* arg);
 static void* rt_io_main(void* arg);
-static int runnable_is_empty(const rt_executor* ex);
-static int worker_next_ready(rt_executor* ex, uint32_t worker_id, uint64_t* out_id);
+static int worker_next_ready(rt_executor* ex, rt_worker_ctx* ctx, uint64_t* out_id);
+static void cpu_relax(void);
 static void maybe_start_compensation_worker_locked(rt_executor* ex);
 static void move_current_local_to_inject_locked(rt_executor* ex);
 static void trace_exec_init(void);
@@ -716,11 +697,15 @@ static void exec_init_once(void) {
     pthread_cond_init(&ex->done_cv, NULL);
     trace_exec_init();
     trace_sched_init();
+    rt_profile_init();
     uint32_t threads = rt_env_worker_count();
     if (threads == 0) {
         threads = rt_default_worker_count();
     }
     ex->worker_count = threads;
+    ex->idle_spin = rt_env_u32("SURGE_IDLE_SPIN", IDLE_SPIN_DEFAULT);
+    ex->idle_yield = rt_env_u32("SURGE_IDLE_YIELD", IDLE_YIELD_DEFAULT);
+    rt_affinity_init();
     ex->sched_mode = rt_env_sched_mode();
     ex->sched_seed = rt_env_sched_seed();
     channel_wake_force_inject = rt_env_channel_wake_force_inject();
@@ -729,6 +714,11 @@ static void exec_init_once(void) {
         blocking_threads = rt_default_blocking_count(ex->worker_count);
     }
     ex->blocking_count = blocking_threads;
+    ex->blocking_max = rt_env_u32("SURGE_BLOCKING_MAX_THREADS", BLOCKING_MAX_DEFAULT);
+    ex->blocking_grow_ns =
+        (uint64_t)rt_env_u32("SURGE_BLOCKING_GROW_US", BLOCKING_GROW_US_DEFAULT) * UINT64_C(1000);
+    ex->blocking_idle_ns = (uint64_t)rt_env_u32("SURGE_BLOCKING_IDLE_MS", BLOCKING_IDLE_MS_DEFAULT) *
+                           UINT64_C(1000000);
     if (ex->worker_count > 0) {
         ex->local_queues = (rt_deque*)rt_alloc(
             (uint64_t)ex->worker_count * (uint64_t)sizeof(rt_deque), _Alignof(rt_deque));
@@ -743,6 +733,7 @@ static void exec_init_once(void) {
     }
     rt_blocking_init(ex);
     ex->initialized = 1;
+    rt_metrics_init();
 }
 
 rt_executor* ensure_exec(void) {
@@ -755,22 +746,41 @@ uint64_t rt_worker_count(void) {
     return (uint64_t)ex->worker_count;
 }
 
-static int runnable_is_empty(const rt_executor* ex) {
+static int ready_queues_empty(const rt_executor* ex) {
+    if (mpmc_len(&ex->inject) > 0) {
+        return 0;
+    }
+    if (ex->local_queues != NULL) {
+        for (uint32_t i = 0; i < ex->worker_count; i++) {
+            if (deque_len(&ex->local_queues[i]) > 0) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+int runnable_is_empty(const rt_executor* ex) {
+    // Caller holds ex->lock.
     if (ex == NULL) {
         return 1;
     }
-    if (ex->inject.len > 0) {
+    if (!ready_queues_empty(ex)) {
         return 0;
     }
-    if (ex->local_queues == NULL || ex->worker_count == 0) {
-        return 1;
-    }
-    for (uint32_t i = 0; i < ex->worker_count; i++) {
-        if (ex->local_queues[i].len > 0) {
-            return 0;
+    // An id that left a queue before the reads above belongs to a probe that was counted
+    // in running_probes first. Probes never wait for ex->lock, so they finish soon and
+    // leave the id in inflight_steals, where it stays until it is claimed under the lock.
+    for (uint32_t spins = 0;
+         atomic_load_explicit(&ex->running_probes, memory_order_seq_cst) != 0;
+         spins++) {
+        if (spins < 64) {
+            cpu_relax();
+        } else {
+            (void)sched_yield();
         }
     }
-    return 1;
+    return atomic_load_explicit(&ex->inflight_steals, memory_order_seq_cst) == 0;
 }
 
 static void trace_exec_init(void) {
@@ -864,7 +874,9 @@ static void rt_start_workers(rt_executor* ex) {
     for (uint32_t i = 0; i < count; i++) {
         ctxs[i].ex = ex;
         ctxs[i].worker_id = i;
+        ctxs[i].local = ex->local_queues != NULL ? &ex->local_queues[i] : NULL;
         ctxs[i].sched_rng = ex->sched_seed + UINT64_C(0x9e3779b97f4a7c15) * (uint64_t)(i + 1);
+        worker_ctx_init_idle(ex, &ctxs[i]);
         if (pthread_create(&threads[i + 1], NULL, rt_worker_main, &ctxs[i]) != 0) {
             panic_msg("async: worker start failed");
             return;
@@ -874,17 +886,28 @@ static void rt_start_workers(rt_executor* ex) {
 }
 
 rt_task* get_task(rt_executor* ex, uint64_t id) {
-    if (ex == NULL || id == 0 || id >= ex->tasks_cap) {
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (ex == NULL || idx == 0 || idx >= ex->tasks_cap) {
         return NULL;
     }
-    return ex->tasks[id];
+    rt_task* task = ex->tasks[idx];
+    if (task == NULL || task->id != id) {
+        // The slot is empty or was reused by a newer generation.
+        return NULL;
+    }
+    return task;
 }
 
 rt_scope* get_scope(rt_executor* ex, uint64_t id) {
-    if (ex == NULL || id == 0 || id >= ex->scopes_cap) {
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (ex == NULL || idx == 0 || idx >= ex->scopes_cap) {
+        return NULL;
+    }
+    rt_scope* scope = ex->scopes[idx];
+    if (scope == NULL || scope->id != id) {
         return NULL;
     }
-    return ex->scopes[id];
+    return scope;
 }
 
 static int ensure_ptr_array_cap(void** array,
@@ -941,166 +964,19 @@ static int ensure_ptr_array_cap(void** array,
     return 1;
 }
 
-static int
-deque_reserve(rt_deque* dq, size_t want, const char* overflow_msg, const char* alloc_msg) {
-    if (dq == NULL) {
-        return 0;
-    }
-    if (want <= dq->cap) {
-        return 1;
-    }
-    size_t next_cap = dq->cap == 0 ? 16 : dq->cap;
-    while (next_cap < want) {
-        if (next_cap > SIZE_MAX / 2) {
-            panic_msg(overflow_msg);
-            return 0;
-        }
-        next_cap *= 2;
-    }
-    if (next_cap > SIZE_MAX / sizeof(uint64_t)) {
-        panic_msg(overflow_msg);
-        return 0;
-    }
-    size_t old_size = dq->cap * sizeof(uint64_t);
-    size_t new_size = next_cap * sizeof(uint64_t);
-    if (old_size > UINT64_MAX || new_size > UINT64_MAX) {
-        panic_msg(overflow_msg);
-        return 0;
-    }
-    uint64_t* next = (uint64_t*)rt_alloc((uint64_t)new_size, _Alignof(uint64_t));
-    if (next == NULL) {
-        panic_msg(alloc_msg);
-        return 0;
-    }
-    if (dq->len > 0 && dq->buf != NULL) {
-        memcpy(next, dq->buf + dq->head, dq->len * sizeof(uint64_t));
-    }
-    if (dq->buf != NULL && dq->cap > 0) {
-        rt_free((uint8_t*)dq->buf, (uint64_t)old_size, _Alignof(uint64_t));
-    }
-    dq->buf = next;
-    dq->cap = next_cap;
-    dq->head = 0;
-    return 1;
-}
-
-static int
-deque_ensure_space(rt_deque* dq, size_t extra, const char* overflow_msg, const char* alloc_msg) {
-    if (dq == NULL) {
-        return 0;
-    }
-    if (dq->len == 0) {
-        dq->head = 0;
-    }
-    if (dq->head > SIZE_MAX - dq->len) {
-        panic_msg(overflow_msg);
-        return 0;
-    }
-    size_t used = dq->head + dq->len;
-    if (extra > SIZE_MAX - used) {
-        panic_msg(overflow_msg);
-        return 0;
-    }
-    size_t want = used + extra;
-    if (want <= dq->cap) {
-        return 1;
-    }
-    if (dq->head > 0 && dq->len > 0 && dq->buf != NULL) {
-        memmove(dq->buf, dq->buf + dq->head, dq->len * sizeof(uint64_t));
-        dq->head = 0;
-        used = dq->len;
-        if (extra > SIZE_MAX - used) {
-            panic_msg(overflow_msg);
-            return 0;
-        }
-        want = used + extra;
-        if (want <= dq->cap) {
-            return 1;
-        }
-    }
-    return deque_reserve(dq, want, overflow_msg, alloc_msg);
-}
-
-static int
-deque_push_tail(rt_deque* dq, uint64_t id, const char* overflow_msg, const char* alloc_msg) {
-    if (dq == NULL) {
-        return 0;
-    }
-    if (!deque_ensure_space(dq, 1, overflow_msg, alloc_msg)) {
-        return 0;
-    }
-    dq->buf[dq->head + dq->len] = id;
-    dq->len++;
-    return 1;
-}
-
-static int
-deque_push_head(rt_deque* dq, uint64_t id, const char* overflow_msg, const char* alloc_msg) {
-    if (dq == NULL) {
-        return 0;
-    }
-    if (dq->len == 0) {
-        return deque_push_tail(dq, id, overflow_msg, alloc_msg);
-    }
-    if (dq->head > 0) {
-        dq->head--;
-        dq->buf[dq->head] = id;
-        dq->len++;
-        return 1;
-    }
-    if (!deque_ensure_space(dq, 1, overflow_msg, alloc_msg)) {
-        return 0;
-    }
-    memmove(dq->buf + 1, dq->buf, dq->len * sizeof(uint64_t));
-    dq->buf[0] = id;
-    dq->len++;
-    return 1;
-}
-
-static int deque_pop_head(rt_deque* dq, uint64_t* out_id) {
-    if (dq == NULL || dq->len == 0) {
-        return 0;
-    }
-    uint64_t id = dq->buf[dq->head];
-    dq->head++;
-    dq->len--;
-    if (dq->len == 0) {
-        dq->head = 0;
-    }
-    if (out_id != NULL) {
-        *out_id = id;
-    }
-    return 1;
-}
-
-static int deque_pop_tail(rt_deque* dq, uint64_t* out_id) {
-    if (dq == NULL || dq->len == 0) {
-        return 0;
-    }
-    size_t idx = dq->head + dq->len - 1;
-    uint64_t id = dq->buf[idx];
-    dq->len--;
-    if (dq->len == 0) {
-        dq->head = 0;
-    }
-    if (out_id != NULL) {
-        *out_id = id;
-    }
-    return 1;
-}
-
 void ensure_task_cap(rt_executor* ex, uint64_t id) {
     if (ex == NULL) {
         return;
     }
-    if (id < ex->tasks_cap) {
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (idx < ex->tasks_cap) {
         return;
     }
-    if (id >= SIZE_MAX) {
+    if (idx >= SIZE_MAX) {
         panic_msg("async: task capacity overflow");
         return;
     }
-    size_t want = (size_t)id + 1;
+    size_t want = idx + 1;
     (void)ensure_ptr_array_cap((void**)&ex->tasks,
                                sizeof(rt_task*),
                                &ex->tasks_cap,
@@ -1114,14 +990,15 @@ void ensure_scope_cap(rt_executor* ex, uint64_t id) {
     if (ex == NULL) {
         return;
     }
-    if (id < ex->scopes_cap) {
+    size_t idx = (size_t)(id & RT_SLOT_INDEX_MASK);
+    if (idx < ex->scopes_cap) {
         return;
     }
-    if (id >= SIZE_MAX) {
+    if (idx >= SIZE_MAX) {
         panic_msg("async: scope capacity overflow");
         return;
     }
-    size_t want = (size_t)id + 1;
+    size_t want = idx + 1;
     (void)ensure_ptr_array_cap((void**)&ex->scopes,
                                sizeof(rt_scope*),
                                &ex->scopes_cap,
@@ -1131,72 +1008,6 @@ void ensure_scope_cap(rt_executor* ex, uint64_t id) {
                                "async: scope allocation failed");
 }
 
-void ensure_waiter_cap(rt_executor* ex) {
-    if (ex == NULL) {
-        return;
-    }
-    if (ex->waiters_len < ex->waiters_cap) {
-        return;
-    }
-    size_t next_cap = ex->waiters_cap == 0 ? 16 : ex->waiters_cap * 2;
-    size_t old_size = ex->waiters_cap * sizeof(waiter);
-    size_t new_size = next_cap * sizeof(waiter);
-    waiter* next = (waiter*)rt_realloc(
-        (uint8_t*)ex->waiters, (uint64_t)old_size, (uint64_t)new_size, _Alignof(waiter));
-    if (next == NULL) {
-        panic_msg("async: waiter allocation failed");
-        return;
-    }
-    ex->waiters = next;
-    ex->waiters_cap = next_cap;
-}
-
-void ensure_child_cap(rt_task* task, size_t want) {
-    if (task == NULL) {
-        return;
-    }
-    if (task->children_cap >= want) {
-        return;
-    }
-    size_t next_cap = task->children_cap == 0 ? 4 : task->children_cap;
-    while (next_cap < want) {
-        next_cap *= 2;
-    }
-    size_t old_size = task->children_cap * sizeof(uint64_t);
-    size_t new_size = next_cap * sizeof(uint64_t);
-    uint64_t* next = (uint64_t*)rt_realloc(
-        (uint8_t*)task->children, (uint64_t)old_size, (uint64_t)new_size, _Alignof(uint64_t));
-    if (next == NULL) {
-        panic_msg("async: child allocation failed");
-        return;
-    }
-    task->children = next;
-    task->children_cap = next_cap;
-}
-
-void ensure_scope_child_cap(rt_scope* scope, size_t want) {
-    if (scope == NULL) {
-        return;
-    }
-    if (scope->children_cap >= want) {
-        return;
-    }
-    size_t next_cap = scope->children_cap == 0 ? 4 : scope->children_cap;
-    while (next_cap < want) {
-        next_cap *= 2;
-    }
-    size_t old_size = scope->children_cap * sizeof(uint64_t);
-    size_t new_size = next_cap * sizeof(uint64_t);
-    uint64_t* next = (uint64_t*)rt_realloc(
-        (uint8_t*)scope->children, (uint64_t)old_size, (uint64_t)new_size, _Alignof(uint64_t));
-    if (next == NULL) {
-        panic_msg("async: scope child allocation failed");
-        return;
-    }
-    scope->children = next;
-    scope->children_cap = next_cap;
-}
-
 static void ensure_wait_keys_cap(rt_task* task, size_t want) {
     if (task == NULL) {
         return;
@@ -1220,31 +1031,6 @@ static void ensure_wait_keys_cap(rt_task* task, size_t want) {
     task->wait_keys_cap = next_cap;
 }
 
-void remove_waiter(rt_executor* ex, waker_key key, uint64_t task_id) {
-    // Caller holds ex->lock; compaction preserves relative order of other waiters.
-    if (ex == NULL || ex->waiters_len == 0) {
-        return;
-    }
-    size_t out = 0;
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        waiter w = ex->waiters[i];
-        if (w.task_id == task_id && w.key.kind == key.kind && w.key.id == key.id) {
-            continue;
-        }
-        ex->waiters[out++] = w;
-    }
-    ex->waiters_len = out;
-}
-
-void add_waiter(rt_executor* ex, waker_key key, uint64_t task_id) {
-    // Caller holds ex->lock; waiters are consumed FIFO per key by pop_waiter.
-    if (ex == NULL || !waker_valid(key)) {
-        return;
-    }
-    ensure_waiter_cap(ex);
-    ex->waiters[ex->waiters_len++] = (waiter){key, task_id};
-}
-
 void clear_wait_keys(rt_executor* ex, rt_task* task) {
     if (ex == NULL || task == NULL || task->wait_keys_len == 0) {
         return;
@@ -1260,16 +1046,10 @@ void clear_select_timers(rt_executor* ex, rt_task* task) {
         return;
     }
     for (size_t i = 0; i < task->select_timers_len; i++) {
-        uint64_t timer_id = task->select_timers[i];
-        if (timer_id == 0) {
-            continue;
-        }
-        rt_task* timer = get_task(ex, timer_id);
-        if (timer != NULL) {
-            cancel_task(ex, timer_id);
-            task_release(ex, timer);
+        if (task->select_timers[i] != NULL) {
+            timer_release(ex, task->select_timers[i]);
+            task->select_timers[i] = NULL;
         }
-        task->select_timers[i] = 0;
     }
     task->select_timers_len = 0;
 }
@@ -1289,8 +1069,8 @@ void add_wait_key(rt_executor* ex, rt_task* task, waker_key key) {
 // NOTES (MT iteration 2):
 // - prepare_park pre-registers waiters under ex->lock to avoid wake-before-park races for user
 // tasks.
-// - Channel waiters now share the executor waiters list (FIFO per key via pop_waiter), so wake is
-// O(n).
+// - Channel waiters share the executor waiter index (FIFO per key via pop_waiter), so wake is
+// O(1) per woken task.
 // - Documented primitives like Semaphore/Condition/Mutex/RwLock have no native runtime impl yet.
 void prepare_park(rt_executor* ex, rt_task* task, waker_key key, int already_added) {
     if (ex == NULL || task == NULL || !waker_valid(key)) {
@@ -1306,45 +1086,30 @@ void prepare_park(rt_executor* ex, rt_task* task, waker_key key, int already_add
     task->park_prepared = 1;
 }
 
-int pop_waiter(rt_executor* ex, waker_key key, uint64_t* out_id) {
-    // Caller holds ex->lock; stale/done/cancelled waiters are dropped while scanning.
-    if (ex == NULL || !waker_valid(key) || ex->waiters_len == 0) {
-        return 0;
-    }
-    size_t out = 0;
-    int found = 0;
-    uint64_t found_id = 0;
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        waiter w = ex->waiters[i];
-        if (w.key.kind == key.kind && w.key.id == key.id) {
-            const rt_task* task = get_task(ex, w.task_id);
-            if (task == NULL || task_status_load(task) == TASK_DONE ||
-                task_cancelled_load(task) != 0) {
-                continue;
-            }
-            if (!found) {
-                found = 1;
-                found_id = w.task_id;
-                continue;
-            }
-        }
-        ex->waiters[out++] = w;
-    }
-    ex->waiters_len = out;
-    if (found && out_id != NULL) {
-        *out_id = found_id;
+static rt_deque* current_local_queue(const rt_executor* ex) {
+    if (ex == NULL || ex->local_queues == NULL) {
+        return NULL;
     }
-    return found;
+    return tls_local_queue;
 }
 
-static rt_deque* current_local_queue(rt_executor* ex) {
-    if (ex == NULL || ex->local_queues == NULL || ex->worker_count == 0) {
-        return NULL;
+static int accept_popped_task(rt_executor* ex, uint64_t id, uint8_t source) {
+    // Caller holds ex->lock; id has just left a ready queue.
+    rt_task* task = get_task(ex, id);
+    uint8_t status = task_status_load(task);
+    if (task == NULL || status == TASK_DONE || status == TASK_RUNNING) {
+        if (task != NULL) {
+            // Clear stale enqueue flags for discarded entries (e.g., duplicates).
+            task_enqueued_store(task, 0);
+        }
+        return 0;
     }
-    if (tls_worker_id < 0 || (uint32_t)tls_worker_id >= ex->worker_count) {
-        return NULL;
+    task_enqueued_store(task, 0);
+    if (source == SCHED_SRC_STEAL) {
+        rt_metric_inc(RT_METRIC_STEALS);
     }
-    return &ex->local_queues[(uint32_t)tls_worker_id];
+    trace_sched_record(source, id);
+    return 1;
 }
 
 static int
@@ -1352,38 +1117,43 @@ pop_task_from_deque(rt_executor* ex, rt_deque* dq, int lifo, uint64_t* out_id, u
     if (ex == NULL || dq == NULL) {
         return 0;
     }
-    while (dq->len > 0) {
+    for (;;) {
         uint64_t id = 0;
-        if (lifo) {
-            if (!deque_pop_tail(dq, &id)) {
-                return 0;
-            }
-        } else {
-            if (!deque_pop_head(dq, &id)) {
-                return 0;
-            }
+        int ok = lifo ? deque_pop(dq, &id) : deque_steal(dq, &id);
+        if (!ok) {
+            return 0;
         }
-        rt_task* task = get_task(ex, id);
-        uint8_t status = task_status_load(task);
-        if (task == NULL || status == TASK_DONE || status == TASK_RUNNING) {
-            if (task != NULL) {
-                // Clear stale enqueue flags for discarded entries (e.g., duplicates).
-                task_enqueued_store(task, 0);
-            }
+        if (!accept_popped_task(ex, id, source)) {
             continue;
         }
-        task_enqueued_store(task, 0);
-        trace_sched_record(source, id);
         if (out_id != NULL) {
             *out_id = id;
         }
         return 1;
     }
-    return 0;
 }
 
-static int ready_push_with_policy(
-    rt_executor* ex, uint64_t id, int force_inject, int front, int signal_ready) {
+static int pop_task_from_inject(rt_executor* ex, uint64_t* out_id) {
+    if (ex == NULL) {
+        return 0;
+    }
+    for (;;) {
+        uint64_t id = 0;
+        if (!mpmc_pop(&ex->inject, &id)) {
+            return 0;
+        }
+        if (!accept_popped_task(ex, id, SCHED_SRC_INJECT)) {
+            continue;
+        }
+        if (out_id != NULL) {
+            *out_id = id;
+        }
+        return 1;
+    }
+}
+
+static int
+ready_push_with_policy(rt_executor* ex, uint64_t id, int force_inject, int signal_ready) {
     // Caller holds ex->lock; enqueued prevents duplicate ready-queue entries.
     if (ex == NULL) {
         return 0;
@@ -1401,7 +1171,8 @@ static int ready_push_with_policy(
     }
     // Injection policy:
     // - Worker thread: enqueue locally (LIFO pop) to keep cache locality.
-    // - Non-worker thread (main/I/O/external): enqueue on the global injection queue.
+    // - Non-worker thread (main/I/O/external) or compensation worker: enqueue on the
+    //   global injection queue.
     // No last-worker affinity is tracked; wake/spawn follows the current thread.
     rt_deque* local = NULL;
     if (!force_inject) {
@@ -1410,40 +1181,41 @@ static int ready_push_with_policy(
     int signal_ready_now = signal_ready;
     if (local != NULL) {
         // Local queues are popped from the tail, so tail insertion is the local priority path.
-        int ok = deque_push_tail(
+        int ok = deque_push(
             local, id, "async: local queue overflow", "async: local queue allocation failed");
         if (!ok) {
             return 0;
         }
         // A single local continuation is usually consumed by the current worker on its
         // next scheduler turn; waking another worker often just creates steal/sleep churn.
-        signal_ready_now = signal_ready && local->len > 1;
+        signal_ready_now = signal_ready && deque_len(local) > 1;
     } else {
-        int ok = front ? deque_push_head(&ex->inject,
-                                         id,
-                                         "async: inject queue overflow",
-                                         "async: inject queue allocation failed")
-                       : deque_push_tail(&ex->inject,
-                                         id,
-                                         "async: inject queue overflow",
-                                         "async: inject queue allocation failed");
+        int ok = mpmc_push(&ex->inject,
+                           id,
+                           "async: inject queue overflow",
+                           "async: inject queue allocation failed");
         if (!ok) {
             return 0;
         }
     }
     task_enqueued_store(task, 1);
     task_status_store(task, TASK_READY);
+    if (rt_profile_active()) {
+        task->ready_ns = rt_monotonic_now();
+    }
     if (ex->channel_blocked_workers > 0) {
         maybe_start_compensation_worker_locked(ex);
     }
-    if (signal_ready_now) {
-        pthread_cond_signal(&ex->ready_cv);
+    if (signal_ready_now && ex->spinning_workers == 0) {
+        // A spinning worker re-checks the queues under ex->lock before it parks, so it
+        // will take this id; otherwise hand it to one parked worker.
+        (void)wake_parked_worker_locked(ex);
     }
     return 1;
 }
 
 static int ready_push_inner(rt_executor* ex, uint64_t id, int force_inject) {
-    return ready_push_with_policy(ex, id, force_inject, 0, 1);
+    return ready_push_with_policy(ex, id, force_inject, 1);
 }
 
 void ready_push(rt_executor* ex, uint64_t id) {
@@ -1455,66 +1227,80 @@ int ready_take_current_local_tail(rt_executor* ex, uint64_t id) {
     // Caller holds ex->lock. This is intentionally narrow: it only removes the
     // fresh child task that __task_create just pushed onto the current worker.
     rt_deque* local = current_local_queue(ex);
-    if (local == NULL || local->len == 0 || local->buf == NULL) {
+    uint64_t newest = 0;
+    if (local == NULL || !deque_pop(local, &newest)) {
         return 0;
     }
-    size_t idx = local->head + local->len - 1;
-    if (local->buf[idx] != id) {
+    if (newest != id) {
+        // Something else was pushed after the child; put it back where it was.
+        (void)deque_push(
+            local, newest, "async: local queue overflow", "async: local queue allocation failed");
         return 0;
     }
-    local->len--;
-    if (local->len == 0) {
-        local->head = 0;
-    }
     return 1;
 }
 
 static int ready_push_yielded_task(rt_executor* ex, uint64_t id) {
     // A yielding worker immediately re-enters the scheduler loop, so waking another
     // worker here mostly creates condvar churn for task-to-task handoffs.
-    return ready_push_with_policy(ex, id, 1, 0, 0);
+    return ready_push_with_policy(ex, id, 1, 0);
 }
 
 int ready_pop(rt_executor* ex, uint64_t* out_id) {
     // Caller holds ex->lock; worker_next_ready adds local and steal paths.
-    return pop_task_from_deque(ex, &ex->inject, 0, out_id, SCHED_SRC_INJECT);
+    return pop_task_from_inject(ex, out_id);
 }
 
-static int worker_next_ready(rt_executor* ex, uint32_t worker_id, uint64_t* out_id) {
-    if (ex == NULL) {
+static int steal_from_other_workers(rt_executor* ex,
+                                    const rt_deque* local,
+                                    uint32_t start,
+                                    uint64_t* out_id) {
+    // Caller holds ex->lock. Tries every worker queue but local, starting at start.
+    if (ex->local_queues == NULL) {
+        return 0;
+    }
+    for (uint32_t offset = 0; offset < ex->worker_count; offset++) {
+        uint32_t victim = (start + offset) % ex->worker_count;
+        if (&ex->local_queues[victim] == local) {
+            continue;
+        }
+        if (pop_task_from_deque(ex, &ex->local_queues[victim], 0, out_id, SCHED_SRC_STEAL)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int worker_next_ready(rt_executor* ex, rt_worker_ctx* ctx, uint64_t* out_id) {
+    if (ex == NULL || ctx == NULL) {
         return 0;
     }
+    uint32_t worker_id = ctx->worker_id;
+    rt_deque* local = ctx->local;
     if (ex->sched_mode == SCHED_SEEDED) {
-        rt_worker_ctx* ctx = ex->worker_ctxs != NULL && worker_id < ex->worker_count
-                                 ? &ex->worker_ctxs[worker_id]
-                                 : NULL;
-        rt_deque* local = ex->local_queues != NULL && worker_id < ex->worker_count
-                              ? &ex->local_queues[worker_id]
-                              : NULL;
-        int local_has = local != NULL && local->len > 0;
-        int inject_has = ex->inject.len > 0;
+        int local_has = local != NULL && deque_len(local) > 0;
+        int inject_has = mpmc_len(&ex->inject) > 0;
         int others_have = 0;
-        if (ex->local_queues != NULL && ex->worker_count > 1) {
+        if (ex->local_queues != NULL) {
             for (uint32_t i = 0; i < ex->worker_count; i++) {
-                if (i == worker_id) {
-                    continue;
-                }
-                if (ex->local_queues[i].len > 0) {
+                if (&ex->local_queues[i] != local && deque_len(&ex->local_queues[i]) > 0) {
                     others_have = 1;
                     break;
                 }
             }
         }
+        // The steal order starts at a random worker other than this one.
+        uint32_t span = ex->worker_count > 1 ? ex->worker_count - 1 : 1;
         if (local_has && inject_has) {
             if ((sched_next_u64(ctx) & 1U) == 0U) {
                 if (pop_task_from_deque(ex, local, 1, out_id, SCHED_SRC_LOCAL)) {
                     return 1;
                 }
-                if (pop_task_from_deque(ex, &ex->inject, 0, out_id, SCHED_SRC_INJECT)) {
+                if (pop_task_from_inject(ex, out_id)) {
                     return 1;
                 }
             } else {
-                if (pop_task_from_deque(ex, &ex->inject, 0, out_id, SCHED_SRC_INJECT)) {
+                if (pop_task_from_inject(ex, out_id)) {
                     return 1;
                 }
                 if (pop_task_from_deque(ex, local, 1, out_id, SCHED_SRC_LOCAL)) {
@@ -1527,86 +1313,68 @@ static int worker_next_ready(rt_executor* ex, uint32_t worker_id, uint64_t* out_
             }
         } else if (inject_has) {
             if (others_have && (sched_next_u64(ctx) & 1U) != 0U) {
-                if (ex->worker_count > 1) {
-                    uint32_t span = ex->worker_count - 1;
-                    uint32_t start =
-                        (worker_id + 1 + (uint32_t)(sched_next_u64(ctx) % span)) % ex->worker_count;
-                    for (uint32_t offset = 0; offset < span; offset++) {
-                        uint32_t victim = start + offset;
-                        if (victim >= ex->worker_count) {
-                            victim -= ex->worker_count;
-                        }
-                        if (victim == worker_id) {
-                            continue;
-                        }
-                        if (pop_task_from_deque(
-                                ex, &ex->local_queues[victim], 0, out_id, SCHED_SRC_STEAL)) {
-                            return 1;
-                        }
-                    }
+                uint32_t start = worker_id + 1 + (uint32_t)(sched_next_u64(ctx) % span);
+                if (steal_from_other_workers(ex, local, start, out_id)) {
+                    return 1;
                 }
             }
-            if (pop_task_from_deque(ex, &ex->inject, 0, out_id, SCHED_SRC_INJECT)) {
+            if (pop_task_from_inject(ex, out_id)) {
                 return 1;
             }
         }
         if (ex->local_queues == NULL || ex->worker_count <= 1) {
             return 0;
         }
-        uint32_t span = ex->worker_count - 1;
-        uint32_t start =
-            (worker_id + 1 + (uint32_t)(sched_next_u64(ctx) % span)) % ex->worker_count;
-        for (uint32_t offset = 0; offset < span; offset++) {
-            uint32_t victim = start + offset;
-            if (victim >= ex->worker_count) {
-                victim -= ex->worker_count;
-            }
-            if (victim == worker_id) {
-                continue;
-            }
-            if (pop_task_from_deque(ex, &ex->local_queues[victim], 0, out_id, SCHED_SRC_STEAL)) {
-                return 1;
-            }
-        }
-        return 0;
+        uint32_t start = worker_id + 1 + (uint32_t)(sched_next_u64(ctx) % span);
+        return steal_from_other_workers(ex, local, start, out_id);
     }
-    if (ex->local_queues != NULL && worker_id < ex->worker_count) {
-        if (pop_task_from_deque(ex, &ex->local_queues[worker_id], 1, out_id, SCHED_SRC_LOCAL)) {
-            return 1;
-        }
+    if (local != NULL && pop_task_from_deque(ex, local, 1, out_id, SCHED_SRC_LOCAL)) {
+        return 1;
+    }
+    if (pop_task_from_inject(ex, out_id)) {
+        return 1;
+    }
+    return steal_from_other_workers(ex, local, worker_id + 1, out_id);
+}
+
+static int worker_probe_unlocked(rt_executor* ex,
+                                 const rt_worker_ctx* ctx,
+                                 uint64_t* out_id,
+                                 uint8_t* out_source) {
+    // Lock-free pass over the worker's own queue, inject and the other workers' queues,
+    // in worker_next_ready's parallel order. The caller counts itself in running_probes
+    // around it and claims the id under ex->lock.
+    if (ctx->local != NULL && deque_pop(ctx->local, out_id)) {
+        *out_source = SCHED_SRC_LOCAL;
+        return 1;
     }
-    if (pop_task_from_deque(ex, &ex->inject, 0, out_id, SCHED_SRC_INJECT)) {
+    if (mpmc_pop(&ex->inject, out_id)) {
+        *out_source = SCHED_SRC_INJECT;
         return 1;
     }
-    if (ex->local_queues == NULL || ex->worker_count <= 1) {
+    if (ex->local_queues == NULL) {
         return 0;
     }
-    for (uint32_t offset = 1; offset < ex->worker_count; offset++) {
-        uint32_t victim = (worker_id + offset) % ex->worker_count;
-        if (victim == worker_id) {
-            continue;
-        }
-        if (pop_task_from_deque(ex, &ex->local_queues[victim], 0, out_id, SCHED_SRC_STEAL)) {
+    for (uint32_t offset = 1; offset <= ex->worker_count; offset++) {
+        rt_deque* victim = &ex->local_queues[(ctx->worker_id + offset) % ex->worker_count];
+        if (victim != ctx->local && deque_steal(victim, out_id)) {
+            *out_source = SCHED_SRC_STEAL;
             return 1;
         }
     }
     return 0;
 }
 
-static void wake_task_with_policy(rt_executor* ex,
-                                  uint64_t id,
-                                  int remove_waiter_flag,
-                                  int force_inject,
-                                  int front,
-                                  int signal_ready) {
+static void wake_task_with_policy(
+    rt_executor* ex, uint64_t id, int remove_waiter_flag, int force_inject, int signal_ready) {
     // Caller holds ex->lock; wake_token handles a wake that races with park_current.
     if (ex == NULL) {
         return;
     }
-    trace_exec_inc(&trace_wake_called_total);
+    rt_metric_inc(RT_METRIC_WAKE_CALLED);
     rt_task* task = get_task(ex, id);
     if (task == NULL || task_status_load(task) == TASK_DONE) {
-        trace_exec_inc(&trace_wake_ignored_completed_total);
+        rt_metric_inc(RT_METRIC_WAKE_IGNORED_COMPLETED);
         return;
     }
     if (remove_waiter_flag && waker_valid(task->park_key)) {
@@ -1615,19 +1383,19 @@ static void wake_task_with_policy(rt_executor* ex,
     task->park_key = waker_none();
     task->park_prepared = 0;
     (void)task_wake_token_exchange(task, 1);
-    if (ready_push_with_policy(ex, id, force_inject, front, signal_ready)) {
-        trace_exec_inc(&trace_wake_enqueued_total);
+    if (ready_push_with_policy(ex, id, force_inject, signal_ready)) {
+        rt_metric_inc(RT_METRIC_WAKE_ENQUEUED);
     } else if (ex->channel_blocked_workers > 0) {
         pthread_cond_broadcast(&ex->ready_cv);
     }
 }
 
 void wake_task(rt_executor* ex, uint64_t id, int remove_waiter_flag) {
-    wake_task_with_policy(ex, id, remove_waiter_flag, 0, 0, 1);
+    wake_task_with_policy(ex, id, remove_waiter_flag, 0, 1);
 }
 
 void wake_channel_task(rt_executor* ex, uint64_t id, int remove_waiter_flag) {
-    wake_task_with_policy(ex, id, remove_waiter_flag, channel_wake_force_inject != 0, 0, 1);
+    wake_task_with_policy(ex, id, remove_waiter_flag, channel_wake_force_inject != 0, 1);
 }
 
 void wake_channel_task_no_signal(rt_executor* ex, uint64_t id, int remove_waiter_flag) {
@@ -1635,7 +1403,7 @@ void wake_channel_task_no_signal(rt_executor* ex, uint64_t id, int remove_waiter
     // active and can drain the injected continuation after the current poll yields,
     // parks, or completes. Generic external/net/timer wakes must signal sleepers.
     // Force inject keeps handoff order predictable and avoids local LIFO ping-pong.
-    wake_task_with_policy(ex, id, remove_waiter_flag, 1, 0, 0);
+    wake_task_with_policy(ex, id, remove_waiter_flag, 1, 0);
 }
 
 static void ready_push_for_waker_key(rt_executor* ex, uint64_t id, waker_key key) {
@@ -1645,24 +1413,14 @@ static void ready_push_for_waker_key(rt_executor* ex, uint64_t id, waker_key key
     (void)ready_push_inner(ex, id, force_inject);
 }
 
-static void wake_key_all_with_policy(rt_executor* ex, waker_key key, int front) {
+void wake_key_all(rt_executor* ex, waker_key key) {
     if (ex == NULL || !waker_valid(key)) {
         return;
     }
-    size_t out = 0;
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        waiter w = ex->waiters[i];
-        if (w.key.kind == key.kind && w.key.id == key.id) {
-            wake_task_with_policy(ex, w.task_id, 0, 0, front, 1);
-            continue;
-        }
-        ex->waiters[out++] = w;
+    uint64_t task_id = 0;
+    while (take_waiter(ex, key, &task_id)) {
+        wake_task_with_policy(ex, task_id, 0, 0, 1);
     }
-    ex->waiters_len = out;
-}
-
-void wake_key_all(rt_executor* ex, waker_key key) {
-    wake_key_all_with_policy(ex, key, 0);
 }
 
 void park_current(rt_executor* ex, waker_key key) {
@@ -1673,7 +1431,7 @@ void park_current(rt_executor* ex, waker_key key) {
     if (task == NULL || task_status_load(task) == TASK_DONE) {
         return;
     }
-    trace_exec_inc(&trace_park_attempt_total);
+    rt_metric_inc(RT_METRIC_PARK_ATTEMPT);
     if (task_wake_token_exchange(task, 0) != 0) {
         task->park_prepared = 0;
         task->park_key = waker_none();
@@ -1694,10 +1452,10 @@ void park_current(rt_executor* ex, waker_key key) {
         ready_push_for_waker_key(ex, task->id, key);
         return;
     }
-    trace_exec_inc(&trace_park_committed_total);
+    rt_metric_inc(RT_METRIC_PARK_COMMITTED);
     waker_kind kind = (waker_kind)key.kind;
     if (kind == WAKER_NET_ACCEPT || kind == WAKER_NET_READ || kind == WAKER_NET_WRITE) {
-        rt_net_wake_poll();
+        rt_net_poll_set_changed();
     }
     pthread_cond_signal(&ex->io_cv);
 }
@@ -1707,56 +1465,7 @@ void tick_virtual(rt_executor* ex) {
         return;
     }
     ex->now_ms++;
-    if (ex->tasks_cap == 0) {
-        return;
-    }
-    for (size_t i = 1; i < ex->tasks_cap; i++) {
-        const rt_task* task = ex->tasks[i];
-        if (task == NULL || task->kind != TASK_KIND_SLEEP ||
-            task_status_load(task) != TASK_WAITING || !task->sleep_armed) {
-            continue;
-        }
-        if (task->sleep_deadline <= ex->now_ms) {
-            wake_task(ex, task->id, 1);
-        }
-    }
-}
-
-static int has_net_waiters(const rt_executor* ex) {
-    if (ex == NULL || ex->waiters_len == 0) {
-        return 0;
-    }
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        waker_kind kind = (waker_kind)ex->waiters[i].key.kind;
-        if (kind == WAKER_NET_ACCEPT || kind == WAKER_NET_READ || kind == WAKER_NET_WRITE) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-static int next_sleep_deadline(const rt_executor* ex, uint64_t* out_deadline) {
-    if (ex == NULL) {
-        return 0;
-    }
-    uint64_t next_deadline = UINT64_MAX;
-    for (size_t i = 1; i < ex->tasks_cap; i++) {
-        const rt_task* task = ex->tasks[i];
-        if (task == NULL || task->kind != TASK_KIND_SLEEP ||
-            task_status_load(task) != TASK_WAITING || !task->sleep_armed) {
-            continue;
-        }
-        if (task->sleep_deadline < next_deadline) {
-            next_deadline = task->sleep_deadline;
-        }
-    }
-    if (next_deadline == UINT64_MAX) {
-        return 0;
-    }
-    if (out_deadline != NULL) {
-        *out_deadline = next_deadline;
-    }
-    return 1;
+    (void)timer_fire_due(ex);
 }
 
 int advance_time_to_next_timer(rt_executor* ex) {
@@ -1764,20 +1473,13 @@ int advance_time_to_next_timer(rt_executor* ex) {
         return 0;
     }
     uint64_t next_deadline = 0;
-    if (!next_sleep_deadline(ex, &next_deadline)) {
+    if (!timer_next_deadline(ex, &next_deadline)) {
         return 0;
     }
-    ex->now_ms = next_deadline;
-    for (size_t i = 1; i < ex->tasks_cap; i++) {
-        const rt_task* task = ex->tasks[i];
-        if (task == NULL || task->kind != TASK_KIND_SLEEP ||
-            task_status_load(task) != TASK_WAITING || !task->sleep_armed) {
-            continue;
-        }
-        if (task->sleep_deadline <= ex->now_ms) {
-            wake_task(ex, task->id, 1);
-        }
+    if (next_deadline > ex->now_ms) {
+        ex->now_ms = next_deadline;
     }
+    (void)timer_fire_due(ex);
     return 1;
 }
 
@@ -1790,7 +1492,7 @@ int next_ready(rt_executor* ex, uint64_t* out_id) {
             continue;
         }
         uint64_t next_deadline = 0;
-        int have_timer = next_sleep_deadline(ex, &next_deadline);
+        int have_timer = timer_next_deadline(ex, &next_deadline);
         if (have_timer) {
             if (has_net_waiters(ex)) {
                 uint64_t now = ex->now_ms;
@@ -1833,55 +1535,96 @@ uint64_t task_id_from_handle(void* handle) {
     return task->id;
 }
 
-void task_add_child(rt_task* parent, uint64_t child_id) {
-    if (parent == NULL || child_id == 0) {
+void task_add_child(rt_task* parent, rt_task* child) {
+    if (parent == NULL || child == NULL || child->parent != NULL) {
         return;
     }
-    ensure_child_cap(parent, parent->children_len + 1);
-    parent->children[parent->children_len++] = child_id;
+    child->parent = parent;
+    child->sibling_prev = NULL;
+    child->sibling_next = parent->children;
+    if (parent->children != NULL) {
+        parent->children->sibling_prev = child;
+    }
+    parent->children = child;
+}
+
+static void task_unlink_children(rt_task* task) {
+    // Caller holds ex->lock. A done task drops out of its parent's list and releases its
+    // own children: cancelling a finished task never reaches them, so neither link is
+    // needed once the task is done, and none may outlive the record.
+    rt_task* parent = task->parent;
+    if (parent != NULL) {
+        if (task->sibling_prev != NULL) {
+            task->sibling_prev->sibling_next = task->sibling_next;
+        } else {
+            parent->children = task->sibling_next;
+        }
+        if (task->sibling_next != NULL) {
+            task->sibling_next->sibling_prev = task->sibling_prev;
+        }
+        task->parent = NULL;
+        task->sibling_prev = NULL;
+        task->sibling_next = NULL;
+    }
+    rt_task* child = task->children;
+    while (child != NULL) {
+        rt_task* next = child->sibling_next;
+        child->parent = NULL;
+        child->sibling_prev = NULL;
+        child->sibling_next = NULL;
+        child = next;
+    }
+    task->children = NULL;
 }
 
-void scope_add_child(rt_scope* scope, uint64_t child_id) {
-    if (scope == NULL || child_id == 0) {
+void scope_add_child(rt_scope* scope, rt_task* child) {
+    if (scope == NULL || child == NULL) {
         return;
     }
-    ensure_scope_child_cap(scope, scope->children_len + 1);
-    scope->children[scope->children_len++] = child_id;
+    child->scope_prev = NULL;
+    child->scope_next = scope->children;
+    if (scope->children != NULL) {
+        scope->children->scope_prev = child;
+    }
+    scope->children = child;
 }
 
-int scope_remove_child(rt_scope* scope, uint64_t child_id) {
-    if (scope == NULL || child_id == 0 || scope->children_len == 0) {
+int scope_remove_child(rt_scope* scope, rt_task* child) {
+    if (scope == NULL || child == NULL) {
         return 0;
     }
-    for (size_t i = 0; i < scope->children_len; i++) {
-        if (scope->children[i] != child_id) {
-            continue;
-        }
-        size_t last = scope->children_len - 1;
-        if (i != last) {
-            scope->children[i] = scope->children[last];
-        }
-        scope->children[last] = 0;
-        scope->children_len--;
-        return 1;
+    if (child->scope_prev != NULL) {
+        child->scope_prev->scope_next = child->scope_next;
+    } else if (scope->children == child) {
+        scope->children = child->scope_next;
+    } else {
+        return 0;
     }
-    return 0;
+    if (child->scope_next != NULL) {
+        child->scope_next->scope_prev = child->scope_prev;
+    }
+    child->scope_prev = NULL;
+    child->scope_next = NULL;
+    return 1;
 }
 
+static void cancel_task_locked(rt_executor* ex, rt_task* task);
+
 void scope_cancel_children_locked(rt_executor* ex, const rt_scope* scope) {
     if (ex == NULL || scope == NULL) {
         return;
     }
-    for (size_t i = 0; i < scope->children_len; i++) {
-        cancel_task(ex, scope->children[i]);
+    // Cancelling only flags and wakes children; none of them leaves the list here.
+    for (rt_task* child = scope->children; child != NULL; child = child->scope_next) {
+        cancel_task_locked(ex, child);
     }
 }
 
-void scope_child_done_locked(rt_executor* ex, rt_scope* scope, uint64_t child_id) {
+void scope_child_done_locked(rt_executor* ex, rt_scope* scope, rt_task* child) {
     if (ex == NULL || scope == NULL) {
         return;
     }
-    (void)scope_remove_child(scope, child_id);
+    (void)scope_remove_child(scope, child);
     if (scope->active_children > 0) {
         scope->active_children--;
     }
@@ -1897,6 +1640,18 @@ void task_add_ref(rt_task* task) {
     (void)atomic_fetch_add_explicit(&task->handle_refs, 1, memory_order_relaxed);
 }
 
+static void release_task_timers(rt_executor* ex, rt_task* task) {
+    // Caller holds ex->lock; a finished task must not keep deadlines in the timer heap.
+    if (task->sleep_timer != NULL) {
+        timer_release(ex, task->sleep_timer);
+        task->sleep_timer = NULL;
+    }
+    if (task->timeout_timer != NULL) {
+        timer_release(ex, task->timeout_timer);
+        task->timeout_timer = NULL;
+    }
+}
+
 static void free_task(rt_executor* ex, rt_task* task) {
     if (ex == NULL || task == NULL) {
         return;
@@ -1904,25 +1659,23 @@ static void free_task(rt_executor* ex, rt_task* task) {
     if (task->wait_keys_len > 0) {
         clear_wait_keys(ex, task);
     }
+    remove_task_waiters(ex, task);
     if (task->wait_keys != NULL && task->wait_keys_cap > 0) {
         rt_free((uint8_t*)task->wait_keys,
                 (uint64_t)task->wait_keys_cap * (uint64_t)sizeof(waker_key),
                 _Alignof(waker_key));
     }
+    if (task->select_timers_len > 0) {
+        clear_select_timers(ex, task);
+    }
+    release_task_timers(ex, task);
     if (task->select_timers != NULL && task->select_timers_cap > 0) {
         rt_free((uint8_t*)task->select_timers,
-                (uint64_t)task->select_timers_cap * (uint64_t)sizeof(uint64_t),
-                _Alignof(uint64_t));
-    }
-    if (task->children != NULL && task->children_cap > 0) {
-        rt_free((uint8_t*)task->children,
-                (uint64_t)task->children_cap * (uint64_t)sizeof(uint64_t),
-                _Alignof(uint64_t));
-    }
-    if (task->id < ex->tasks_cap) {
-        ex->tasks[task->id] = NULL;
+                (uint64_t)task->select_timers_cap * (uint64_t)sizeof(rt_timer*),
+                _Alignof(rt_timer*));
     }
-    rt_free((uint8_t*)task, sizeof(rt_task), _Alignof(rt_task));
+    rt_arena_release(&task->frame_arena);
+    task_slot_free(ex, task);
 }
 
 void task_release(rt_executor* ex, rt_task* task) {
@@ -1951,7 +1704,14 @@ void cancel_task(rt_executor* ex, uint64_t id) {
         return;
     }
     rt_task* task = get_task(ex, id);
-    if (task == NULL || task_status_load(task) == TASK_DONE) {
+    if (task == NULL) {
+        return;
+    }
+    cancel_task_locked(ex, task);
+}
+
+static void cancel_task_locked(rt_executor* ex, rt_task* task) {
+    if (task_status_load(task) == TASK_DONE) {
         return;
     }
     if (task_cancelled_load(task) != 0) {
@@ -1964,8 +1724,8 @@ void cancel_task(rt_executor* ex, uint64_t id) {
     if (task_status_load(task) == TASK_WAITING) {
         wake_task(ex, task->id, 1);
     }
-    for (size_t i = 0; i < task->children_len; i++) {
-        cancel_task(ex, task->children[i]);
+    for (rt_task* child = task->children; child != NULL; child = child->sibling_next) {
+        cancel_task_locked(ex, child);
     }
 }
 
@@ -1979,6 +1739,7 @@ void mark_done(rt_executor* ex, rt_task* task, uint8_t result_kind, uint64_t res
     if (task->select_timers_len > 0) {
         clear_select_timers(ex, task);
     }
+    release_task_timers(ex, task);
     if (waker_valid(task->park_key)) {
         remove_waiter(ex, task->park_key, task->id);
     }
@@ -1989,6 +1750,7 @@ void mark_done(rt_executor* ex, rt_task* task, uint8_t result_kind, uint64_t res
     task->result_kind = result_kind;
     task->result_bits = result_bits;
     task->state = NULL;
+    task_unlink_children(task);
     rt_scope* scope = NULL;
     if (task->parent_scope_id != 0) {
         scope = get_scope(ex, task->parent_scope_id);
@@ -2005,11 +1767,11 @@ void mark_done(rt_executor* ex, rt_task* task, uint8_t result_kind, uint64_t res
             }
         }
         if (task->scope_registered) {
-            scope_child_done_locked(ex, scope, task->id);
+            scope_child_done_locked(ex, scope, task);
             task->scope_registered = 0;
         }
     }
-    wake_key_all_with_policy(ex, join_key(task->id), 0);
+    wake_key_all(ex, join_key(task->id));
     pthread_cond_broadcast(&ex->done_cv);
     if (atomic_load_explicit(&task->handle_refs, memory_order_relaxed) == 0) {
         free_task(ex, task);
@@ -2081,18 +1843,21 @@ static void maybe_start_compensation_worker_locked(rt_executor* ex) {
     memset(ctx, 0, sizeof(rt_worker_ctx));
     ctx->ex = ex;
     ctx->worker_id = ex->compensation_count % ex->worker_count;
+    ctx->local = NULL;
     ctx->sched_rng =
         ex->sched_seed +
         UINT64_C(0x9e3779b97f4a7c15) * (uint64_t)(ex->worker_count + ex->compensation_count + 1U);
+    worker_ctx_init_idle(ex, ctx);
 
     pthread_t thread;
     if (pthread_create(&thread, NULL, rt_worker_main, ctx) != 0) {
+        pthread_cond_destroy(&ctx->idle_cv);
         rt_free((uint8_t*)ctx, sizeof(rt_worker_ctx), _Alignof(rt_worker_ctx));
         panic_msg("async: compensation worker start failed");
         return;
     }
     (void)pthread_detach(thread);
-    trace_exec_inc(&trace_compensation_started_total);
+    rt_metric_inc(RT_METRIC_COMPENSATION_STARTED);
     ex->compensation_count++;
     if (ex->compensation_count > ex->compensation_high_water) {
         ex->compensation_high_water = ex->compensation_count;
@@ -2100,23 +1865,23 @@ static void maybe_start_compensation_worker_locked(rt_executor* ex) {
 }
 
 static void move_current_local_to_inject_locked(rt_executor* ex) {
-    if (ex == NULL || tls_worker_id < 0 || (uint32_t)tls_worker_id >= ex->worker_count ||
-        ex->local_queues == NULL) {
+    rt_deque* local = current_local_queue(ex);
+    if (local == NULL) {
         return;
     }
-    rt_deque* local = &ex->local_queues[(uint32_t)tls_worker_id];
     uint64_t id = 0;
-    int moved = 0;
-    while (deque_pop_head(local, &id)) {
-        if (deque_push_tail(&ex->inject,
-                            id,
-                            "async: inject queue overflow",
-                            "async: inject queue allocation failed")) {
-            moved = 1;
+    uint32_t moved = 0;
+    // Oldest first, the order thieves would have taken them.
+    while (deque_steal(local, &id)) {
+        if (mpmc_push(&ex->inject,
+                      id,
+                      "async: inject queue overflow",
+                      "async: inject queue allocation failed")) {
+            moved++;
         }
     }
-    if (moved) {
-        pthread_cond_broadcast(&ex->ready_cv);
+    while (moved > 0 && wake_parked_worker_locked(ex)) {
+        moved--;
     }
 }
 
@@ -2124,7 +1889,7 @@ int rt_wait_current_worker_wakeup(rt_executor* ex, rt_task* task) {
     if (ex == NULL || task == NULL || tls_worker_id < 0) {
         return 0;
     }
-    trace_exec_inc(&trace_channel_blocking_wait_total);
+    rt_metric_inc(RT_METRIC_CHANNEL_BLOCKING_WAIT);
     rt_lock(ex);
     move_current_local_to_inject_locked(ex);
     // This sync helper parks the OS worker, so it stops contributing to scheduler progress.
@@ -2152,6 +1917,113 @@ int rt_wait_current_worker_wakeup(rt_executor* ex, rt_task* task) {
     return 1;
 }
 
+static void worker_ctx_init_idle(const rt_executor* ex, rt_worker_ctx* ctx) {
+    pthread_cond_init(&ctx->idle_cv, NULL);
+    ctx->next_parked = NULL;
+    ctx->parked = 0;
+    ctx->spin_budget = ex->idle_spin;
+}
+
+static int wake_parked_worker_locked(rt_executor* ex) {
+    // Caller holds ex->lock. Wakes the most recently parked worker: its caches are the
+    // warmest and the others can keep sleeping.
+    rt_worker_ctx* ctx = ex->parked_workers;
+    if (ctx == NULL) {
+        return 0;
+    }
+    ex->parked_workers = ctx->next_parked;
+    ctx->next_parked = NULL;
+    ctx->parked = 0;
+    pthread_cond_signal(&ctx->idle_cv);
+    return 1;
+}
+
+static void worker_park_locked(rt_executor* ex, rt_worker_ctx* ctx) {
+    // Caller holds ex->lock and has found every queue empty under it.
+    ctx->parked = 1;
+    ctx->next_parked = ex->parked_workers;
+    ex->parked_workers = ctx;
+    rt_metric_inc(RT_METRIC_WORKER_SLEEP);
+    while (ctx->parked && !ex->shutdown) {
+        pthread_cond_wait(&ctx->idle_cv, &ex->lock);
+    }
+    if (ctx->parked) {
+        rt_worker_ctx** link = &ex->parked_workers;
+        while (*link != NULL && *link != ctx) {
+            link = &(*link)->next_parked;
+        }
+        if (*link == ctx) {
+            *link = ctx->next_parked;
+        }
+        ctx->next_parked = NULL;
+        ctx->parked = 0;
+    }
+    rt_metric_inc(RT_METRIC_WORKER_WAKE);
+}
+
+static void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static int worker_sees_work_unlocked(const rt_executor* ex) {
+    // Snapshot only: a hit sends the caller back under ex->lock to claim the work.
+    if (mpmc_len(&ex->inject) > 0) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < ex->worker_count; i++) {
+        if (deque_len(&ex->local_queues[i]) > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void worker_spin_for_work(rt_executor* ex, rt_worker_ctx* ctx) {
+    // Called without ex->lock while counted in spinning_workers. Spins for up to
+    // spin_budget checks or until work shows up, then yields the CPU idle_yield times; the
+    // caller re-checks the queues under ex->lock either way. The budget adapts: spins that
+    // end in a park shrink the next one, so a worker facing long idle gaps stops burning
+    // CPU, and hits grow it back.
+    rt_metric_inc(RT_METRIC_WORKER_SPIN);
+    int found = 0;
+    for (uint32_t i = 0; i < ctx->spin_budget && !found; i++) {
+        cpu_relax();
+        found = worker_sees_work_unlocked(ex);
+    }
+    for (uint32_t i = 0; i < ex->idle_yield && !found; i++) {
+        (void)sched_yield();
+        found = worker_sees_work_unlocked(ex);
+    }
+    uint32_t floor = ex->idle_spin < IDLE_SPIN_FLOOR ? ex->idle_spin : IDLE_SPIN_FLOOR;
+    if (found) {
+        rt_metric_inc(RT_METRIC_WORKER_SPIN_HIT);
+        ctx->spin_budget =
+            ctx->spin_budget > ex->idle_spin / 2 ? ex->idle_spin : ctx->spin_budget * 2;
+        if (ctx->spin_budget < floor) {
+            ctx->spin_budget = floor;
+        }
+    } else {
+        ctx->spin_budget = ctx->spin_budget / 2 < floor ? floor : ctx->spin_budget / 2;
+    }
+}
+
+static int worker_may_spin_locked(const rt_executor* ex) {
+    // Caller holds ex->lock. At most half of the workers spin at once, and at least one
+    // may, so a burst of pushes finds someone awake without every idle core spinning.
+    if (ex->local_queues == NULL || (ex->idle_spin == 0 && ex->idle_yield == 0)) {
+        return 0;
+    }
+    uint32_t max_spinning = ex->worker_count / 2;
+    if (max_spinning == 0) {
+        max_spinning = 1;
+    }
+    return ex->spinning_workers < max_spinning;
+}
+
 static void* rt_worker_main(void* arg) {
     rt_worker_ctx* ctx = (rt_worker_ctx*)arg;
     rt_executor* ex = ctx != NULL ? ctx->ex : NULL;
@@ -2161,12 +2033,40 @@ static void* rt_worker_main(void* arg) {
         return NULL;
     }
     tls_worker_id = (int)worker_id;
+    tls_local_queue = ctx->local;
     rt_set_current_task(NULL);
+    if (rt_affinity_pin_worker(worker_id) && ctx->local != NULL) {
+        (void)deque_reserve(
+            ctx->local, "async: local queue overflow", "async: local queue allocation failed");
+    }
     for (;;) {
         rt_trace_drain_signal_dump();
-        rt_lock(ex);
         uint64_t id = 0;
-        while (!ex->shutdown && !worker_next_ready(ex, worker_id, &id)) {
+        int spun = 0;
+        int idled = 0;
+        int probed = 0;
+        uint8_t probed_source = SCHED_SRC_INJECT;
+        if (ex->sched_mode != SCHED_SEEDED && ex->local_queues != NULL) {
+            // Take local, injected or stealable work before taking the lock; seeded mode
+            // keeps every queue decision under ex->lock so runs stay reproducible. The id
+            // moves into inflight_steals before the probe stops counting itself.
+            (void)atomic_fetch_add_explicit(&ex->running_probes, 1, memory_order_seq_cst);
+            probed = worker_probe_unlocked(ex, ctx, &id, &probed_source);
+            if (probed) {
+                (void)atomic_fetch_add_explicit(&ex->inflight_steals, 1, memory_order_seq_cst);
+            }
+            (void)atomic_fetch_sub_explicit(&ex->running_probes, 1, memory_order_seq_cst);
+        }
+        rt_lock(ex);
+        if (probed) {
+            probed = accept_popped_task(ex, id, probed_source);
+            (void)atomic_fetch_sub_explicit(&ex->inflight_steals, 1, memory_order_seq_cst);
+            if (!probed && ex->running_count == 0 && runnable_is_empty(ex)) {
+                // The I/O thread may have seen the stale id as pending work and be waiting.
+                pthread_cond_signal(&ex->io_cv);
+            }
+        }
+        while (!probed && !ex->shutdown && !worker_next_ready(ex, ctx, &id)) {
             if (has_net_waiters(ex) && !ex->worker_net_polling) {
                 // Avoid routing every idle-worker socket wake through the I/O thread
                 // and ready_cv. A short worker-side poll keeps single-client TCP
@@ -2179,19 +2079,38 @@ static void* rt_worker_main(void* arg) {
                 if (woke_net) {
                     continue;
                 }
-                if (ex->shutdown || worker_next_ready(ex, worker_id, &id)) {
+                if (ex->shutdown || worker_next_ready(ex, ctx, &id)) {
                     break;
                 }
             }
-            // Sleep only after local, inject, and steal queues have been checked under ex->lock.
-            trace_exec_inc(&trace_worker_sleep_total);
-            pthread_cond_wait(&ex->ready_cv, &ex->lock);
-            trace_exec_inc(&trace_worker_wake_total);
+            if (!spun && worker_may_spin_locked(ex)) {
+                // Spin, then yield, before paying for a park and the futex wake that
+                // ends it; the loop condition re-checks the queues under ex->lock.
+                spun = 1;
+                idled = 1;
+                ex->spinning_workers++;
+                rt_unlock(ex);
+                worker_spin_for_work(ex, ctx);
+                rt_lock(ex);
+                ex->spinning_workers--;
+                continue;
+            }
+            // Park only after local, inject, and steal queues have been checked under
+            // ex->lock.
+            idled = 1;
+            worker_park_locked(ex, ctx);
         }
         if (ex->shutdown) {
             rt_unlock(ex);
             break;
         }
+        if (idled && ex->spinning_workers == 0 && !runnable_is_empty(ex)) {
+            // Pushes made while a worker spun skipped their wakes, and a burst may have
+            // woken only this worker. Each worker that leaves idle with work still queued
+            // wakes the next parked one, so the wake chains along until the queues drain
+            // or every worker is busy.
+            (void)wake_parked_worker_locked(ex);
+        }
         rt_task* task = get_task(ex, id);
         if (task == NULL || task_status_load(task) == TASK_DONE) {
             rt_unlock(ex);
@@ -2242,6 +2161,7 @@ static void* rt_io_main(void* arg) {
         return NULL;
     }
     const int poll_slice_ms = 50;
+    (void)rt_affinity_pin_io();
     rt_lock(ex);
     for (;;) {
         if (atomic_load_explicit(&trace_dump_requested_flag, memory_order_relaxed) != 0) {
@@ -2253,9 +2173,17 @@ static void* rt_io_main(void* arg) {
             break;
         }
         uint64_t deadline = 0;
-        int have_timer = next_sleep_deadline(ex, &deadline);
+        int have_timer = timer_next_deadline(ex, &deadline);
         int have_net = has_net_waiters(ex);
         int idle = ex->running_count == 0 && runnable_is_empty(ex);
+        if (idle && rt_stdout_pending()) {
+            // Nothing is running, so output printed before the program started waiting on
+            // sockets or timers would otherwise sit in the buffer until exit.
+            rt_unlock(ex);
+            rt_flush_stdout();
+            rt_lock(ex);
+            continue;
+        }
 
         if (!have_net && (!have_timer || !idle)) {
             pthread_cond_wait(&ex->io_cv, &ex->lock);
@@ -15,6 +15,15 @@ enum {
     SELECT_DEFAULT = 4,
 };
 
+static void (*const* registered_poll_fns)(void);
+static uint64_t registered_poll_fns_len;
+
+void rt_async_register_poll_fns(void (*const* fns)(void), uint64_t len) {
+    // Called once from a global constructor, before any task exists.
+    registered_poll_fns = fns;
+    registered_poll_fns_len = fns != NULL ? len : 0;
+}
+
 void* __task_create(
     uint64_t poll_fn_id,
     void* state) { // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
@@ -23,17 +32,16 @@ void* __task_create(
         return NULL;
     }
     rt_lock(ex);
-    uint64_t id = ex->next_id++;
-    ensure_task_cap(ex, id);
-    rt_task* task = (rt_task*)rt_alloc(sizeof(rt_task), _Alignof(rt_task));
+    rt_task* task = task_slot_alloc(ex);
     if (task == NULL) {
         rt_unlock(ex);
         panic_msg("async: task allocation failed");
         return NULL;
     }
-    memset(task, 0, sizeof(rt_task));
-    task->id = id;
+    uint64_t id = task->id;
     task->poll_fn_id = (int64_t)poll_fn_id;
+    task->poll_fn =
+        poll_fn_id < registered_poll_fns_len ? registered_poll_fns[poll_fn_id] : NULL;
     task->state = state;
     task_status_store(task, TASK_READY);
     task->kind = TASK_KIND_USER;
@@ -41,10 +49,9 @@ void* __task_create(
     task_enqueued_store(task, 0);
     (void)task_wake_token_exchange(task, 0);
     atomic_store_explicit(&task->handle_refs, 1, memory_order_relaxed);
-    ex->tasks[id] = task;
     rt_task* parent = rt_current_task();
     if (parent != NULL) {
-        task_add_child(parent, id);
+        task_add_child(parent, task);
     }
     ready_push(ex, id);
     rt_unlock(ex);
@@ -59,6 +66,8 @@ void* __task_state(void) { // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,c
     }
     void* state = task->state;
     task->state = NULL;
+    // Frames from earlier suspensions die once this poll builds its next one.
+    task->frame_rewind = 1;
     return state;
 }
 
@@ -256,22 +265,8 @@ uint8_t rt_timeout_poll(void* task, uint64_t ms, uint64_t* out_bits) {
         return 2;
     }
 
-    uint64_t timeout_id = current->timeout_task_id;
-    rt_task* timeout_task = NULL;
-    if (timeout_id != 0) {
-        timeout_task = get_task(ex, timeout_id);
-        if (timeout_task == NULL) {
-            timeout_id = 0;
-            current->timeout_task_id = 0;
-        }
-    }
-    if (timeout_id == 0) {
-        timeout_task = spawn_sleep_task_locked(ex, ms);
-        if (timeout_task == NULL) {
-            rt_unlock(ex);
-            return 2;
-        }
-        current->timeout_task_id = timeout_task->id;
+    if (current->timeout_timer == NULL) {
+        current->timeout_timer = timer_arm(ex, current->id, ex->now_ms + ms);
     }
 
     if (task_status_load(target) == TASK_DONE) {
@@ -279,22 +274,20 @@ uint8_t rt_timeout_poll(void* task, uint64_t ms, uint64_t* out_bits) {
         if (out_bits != NULL) {
             *out_bits = target->result_bits;
         }
-        current->timeout_task_id = 0;
-        if (timeout_task != NULL) {
-            task_release(ex, timeout_task);
-        }
+        timer_release(ex, current->timeout_timer);
+        current->timeout_timer = NULL;
         task_release(ex, target);
         pending_key = waker_none();
         rt_unlock(ex);
         return kind;
     }
-    if (timeout_task != NULL && task_status_load(timeout_task) == TASK_DONE) {
+    if (timer_expired(ex, current->timeout_timer)) {
         cancel_task(ex, target->id);
         if (out_bits != NULL) {
             *out_bits = 0;
         }
-        current->timeout_task_id = 0;
-        task_release(ex, timeout_task);
+        timer_release(ex, current->timeout_timer);
+        current->timeout_timer = NULL;
         task_release(ex, target);
         pending_key = waker_none();
         rt_unlock(ex);
@@ -304,11 +297,8 @@ uint8_t rt_timeout_poll(void* task, uint64_t ms, uint64_t* out_bits) {
     if (task_status_load(target) != TASK_WAITING) {
         wake_task(ex, target->id, 1);
     }
-    if (timeout_task != NULL && task_status_load(timeout_task) != TASK_WAITING &&
-        task_status_load(timeout_task) != TASK_DONE) {
-        wake_task(ex, timeout_task->id, 1);
-    }
 
+    // The timeout timer wakes the current task directly; only the join needs a waiter.
     waker_key first_key = join_key(target->id);
     int first_added = 0;
     {
@@ -316,9 +306,6 @@ uint8_t rt_timeout_poll(void* task, uint64_t ms, uint64_t* out_bits) {
         add_wait_key(ex, current, first_key);
         first_added = current->wait_keys_len > prev_len;
     }
-    if (timeout_task != NULL) {
-        add_wait_key(ex, current, join_key(timeout_task->id));
-    }
     prepare_park(ex, current, first_key, first_added);
     pending_key = first_key;
     rt_unlock(ex);
@@ -463,7 +450,7 @@ int64_t rt_select_poll(uint64_t count,
         current->select_timers_len = (size_t)count;
         if (current->select_timers != NULL) {
             for (uint64_t i = 0; i < count; i++) {
-                current->select_timers[i] = 0;
+                current->select_timers[i] = NULL;
             }
         }
     }
@@ -526,16 +513,11 @@ int64_t rt_select_poll(uint64_t count,
                     selected = (int64_t)i;
                     break;
                 }
-                if (current->select_timers_len == count && current->select_timers != NULL) {
-                    uint64_t timer_id = current->select_timers[i];
-                    if (timer_id != 0) {
-                        const rt_task* timer_task = get_task(ex, timer_id);
-                        if (timer_task != NULL && task_status_load(timer_task) == TASK_DONE) {
-                            selected = (int64_t)i;
-                            selected_timeout = 1;
-                            selected_task_id = target->id;
-                        }
-                    }
+                if (current->select_timers_len == count && current->select_timers != NULL &&
+                    timer_expired(ex, current->select_timers[i])) {
+                    selected = (int64_t)i;
+                    selected_timeout = 1;
+                    selected_task_id = target->id;
                 }
                 break;
             }
@@ -564,6 +546,7 @@ int64_t rt_select_poll(uint64_t count,
 
     waker_key first_key = waker_none();
     int first_added = 0;
+    int channel_ready = 0;
     for (uint64_t i = 0; i < count; i++) {
         uint8_t kind = kinds != NULL ? kinds[i] : SELECT_TASK;
         void* handle = handles != NULL ? handles[i] : NULL;
@@ -587,6 +570,9 @@ int64_t rt_select_poll(uint64_t count,
             }
             case SELECT_CHAN_RECV: {
                 waker_key key = channel_recv_key((rt_channel*)handle);
+                if (rt_channel_select_waiter_locked(handle, 0)) {
+                    channel_ready = 1;
+                }
                 if (!waker_valid(first_key)) {
                     size_t prev_len = current->wait_keys_len;
                     add_wait_key(ex, current, key);
@@ -599,6 +585,9 @@ int64_t rt_select_poll(uint64_t count,
             }
             case SELECT_CHAN_SEND: {
                 waker_key key = channel_send_key((rt_channel*)handle);
+                if (rt_channel_select_waiter_locked(handle, 1)) {
+                    channel_ready = 1;
+                }
                 if (!waker_valid(first_key)) {
                     size_t prev_len = current->wait_keys_len;
                     add_wait_key(ex, current, key);
@@ -625,32 +614,11 @@ int64_t rt_select_poll(uint64_t count,
                     add_wait_key(ex, current, key);
                 }
 
-                uint64_t timer_id = 0;
-                if (current->select_timers_len == count && current->select_timers != NULL) {
-                    timer_id = current->select_timers[i];
-                }
-                if (timer_id == 0) {
+                // The arm's timer wakes the current task directly once it expires.
+                if (current->select_timers != NULL && current->select_timers_len == count &&
+                    current->select_timers[i] == NULL) {
                     uint64_t delay = ms != NULL ? ms[i] : 0;
-                    const rt_task* timer_task = spawn_sleep_task_locked(ex, delay);
-                    if (timer_task != NULL && current->select_timers != NULL &&
-                        current->select_timers_len == count) {
-                        current->select_timers[i] = timer_task->id;
-                        timer_id = timer_task->id;
-                    }
-                }
-                if (timer_id != 0) {
-                    const rt_task* timer_task = get_task(ex, timer_id);
-                    if (timer_task != NULL) {
-                        waker_key timer_key_join = join_key(timer_task->id);
-                        if (!waker_valid(first_key)) {
-                            size_t prev_timer_len = current->wait_keys_len;
-                            add_wait_key(ex, current, timer_key_join);
-                            first_key = timer_key_join;
-                            first_added = current->wait_keys_len > prev_timer_len;
-                        } else {
-                            add_wait_key(ex, current, timer_key_join);
-                        }
-                    }
+                    current->select_timers[i] = timer_arm(ex, current->id, ex->now_ms + delay);
                 }
                 break;
             }
@@ -663,6 +631,11 @@ int64_t rt_select_poll(uint64_t count,
     if (waker_valid(first_key)) {
         prepare_park(ex, current, first_key, first_added);
     }
+    if (channel_ready) {
+        // A lock-free channel operation slipped in after the arms were polled and before
+        // it could see this registration; park_current requeues instead of sleeping.
+        (void)task_wake_token_exchange(current, 1);
+    }
     pending_key = first_key;
     rt_unlock(ex);
     return -1;
@@ -672,22 +645,18 @@ static rt_task* spawn_checkpoint_task_locked(rt_executor* ex) {
     if (ex == NULL) {
         return NULL;
     }
-    uint64_t id = ex->next_id++;
-    ensure_task_cap(ex, id);
-    rt_task* task = (rt_task*)rt_alloc(sizeof(rt_task), _Alignof(rt_task));
+    rt_task* task = task_slot_alloc(ex);
     if (task == NULL) {
         panic_msg("async: task allocation failed");
         return NULL;
     }
-    memset(task, 0, sizeof(rt_task));
-    task->id = id;
+    uint64_t id = task->id;
     task_status_store(task, TASK_READY);
     task->kind = TASK_KIND_CHECKPOINT;
     task_cancelled_store(task, 0);
     task_enqueued_store(task, 0);
     (void)task_wake_token_exchange(task, 0);
     atomic_store_explicit(&task->handle_refs, 1, memory_order_relaxed);
-    ex->tasks[id] = task;
     ready_push(ex, id);
     return task;
 }
@@ -696,15 +665,12 @@ static rt_task* spawn_sleep_task_locked(rt_executor* ex, uint64_t delay) {
     if (ex == NULL) {
         return NULL;
     }
-    uint64_t id = ex->next_id++;
-    ensure_task_cap(ex, id);
-    rt_task* task = (rt_task*)rt_alloc(sizeof(rt_task), _Alignof(rt_task));
+    rt_task* task = task_slot_alloc(ex);
     if (task == NULL) {
         panic_msg("async: task allocation failed");
         return NULL;
     }
-    memset(task, 0, sizeof(rt_task));
-    task->id = id;
+    uint64_t id = task->id;
     task_status_store(task, TASK_READY);
     task->kind = TASK_KIND_SLEEP;
     task->sleep_delay = delay;
@@ -712,7 +678,6 @@ static rt_task* spawn_sleep_task_locked(rt_executor* ex, uint64_t delay) {
     task_enqueued_store(task, 0);
     (void)task_wake_token_exchange(task, 0);
     atomic_store_explicit(&task->handle_refs, 1, memory_order_relaxed);
-    ex->tasks[id] = task;
     ready_push(ex, id);
     return task;
 }
@@ -728,10 +693,10 @@ static void ensure_select_timers_cap(rt_task* task, size_t want) {
     while (next_cap < want) {
         next_cap *= 2;
     }
-    size_t old_size = task->select_timers_cap * sizeof(uint64_t);
-    size_t new_size = next_cap * sizeof(uint64_t);
-    uint64_t* next = (uint64_t*)rt_realloc(
-        (uint8_t*)task->select_timers, (uint64_t)old_size, (uint64_t)new_size, _Alignof(uint64_t));
+    size_t old_size = task->select_timers_cap * sizeof(rt_timer*);
+    size_t new_size = next_cap * sizeof(rt_timer*);
+    rt_timer** next = (rt_timer**)rt_realloc(
+        (uint8_t*)task->select_timers, (uint64_t)old_size, (uint64_t)new_size, _Alignof(rt_timer*));
     if (next == NULL) {
         panic_msg("async: select timer allocation failed");
         return;
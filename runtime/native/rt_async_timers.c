@@ -0,0 +1,163 @@
+#include "rt_async_internal.h"
+
+// Timer heap: binary min-heap of rt_timer pointers ordered by deadline.
+//
+// All functions here run under ex->lock. Each timer stores its heap position, so release
+// removes it without searching, and timer records are recycled through ex->free_timers.
+// Sleep tasks, timeout polls, and select timeout arms all register here, which keeps the
+// next deadline at the heap root instead of behind a scan of every task slot.
+
+#define TIMER_NOT_QUEUED SIZE_MAX
+
+static int timer_before(const rt_timer* a, const rt_timer* b) {
+    // Ties fire in task id order, matching the order sleep tasks were woken by slot scans.
+    if (a->deadline != b->deadline) {
+        return a->deadline < b->deadline;
+    }
+    return a->task_id < b->task_id;
+}
+
+static void timer_heap_place(rt_executor* ex, size_t idx, rt_timer* timer) {
+    ex->timer_heap[idx] = timer;
+    timer->heap_index = idx;
+}
+
+static void timer_sift_up(rt_executor* ex, size_t idx) {
+    rt_timer* timer = ex->timer_heap[idx];
+    while (idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if (!timer_before(timer, ex->timer_heap[parent])) {
+            break;
+        }
+        timer_heap_place(ex, idx, ex->timer_heap[parent]);
+        idx = parent;
+    }
+    timer_heap_place(ex, idx, timer);
+}
+
+static void timer_sift_down(rt_executor* ex, size_t idx) {
+    rt_timer* timer = ex->timer_heap[idx];
+    size_t len = ex->timers_len;
+    for (;;) {
+        size_t child = idx * 2 + 1;
+        if (child >= len) {
+            break;
+        }
+        if (child + 1 < len && timer_before(ex->timer_heap[child + 1], ex->timer_heap[child])) {
+            child++;
+        }
+        if (!timer_before(ex->timer_heap[child], timer)) {
+            break;
+        }
+        timer_heap_place(ex, idx, ex->timer_heap[child]);
+        idx = child;
+    }
+    timer_heap_place(ex, idx, timer);
+}
+
+static void timer_heap_remove(rt_executor* ex, rt_timer* timer) {
+    size_t idx = timer->heap_index;
+    if (idx == TIMER_NOT_QUEUED || idx >= ex->timers_len || ex->timer_heap[idx] != timer) {
+        return;
+    }
+    timer->heap_index = TIMER_NOT_QUEUED;
+    ex->timers_len--;
+    if (idx == ex->timers_len) {
+        return;
+    }
+    timer_heap_place(ex, idx, ex->timer_heap[ex->timers_len]);
+    if (idx > 0 && timer_before(ex->timer_heap[idx], ex->timer_heap[(idx - 1) / 2])) {
+        timer_sift_up(ex, idx);
+    } else {
+        timer_sift_down(ex, idx);
+    }
+}
+
+static void ensure_timer_heap_cap(rt_executor* ex) {
+    if (ex->timers_len < ex->timers_cap) {
+        return;
+    }
+    size_t next_cap = ex->timers_cap == 0 ? 16 : ex->timers_cap * 2;
+    if (next_cap > SIZE_MAX / sizeof(rt_timer*)) {
+        panic_msg("async: timer heap overflow");
+        return;
+    }
+    size_t old_size = ex->timers_cap * sizeof(rt_timer*);
+    size_t new_size = next_cap * sizeof(rt_timer*);
+    rt_timer** next = (rt_timer**)rt_realloc(
+        (uint8_t*)ex->timer_heap, (uint64_t)old_size, (uint64_t)new_size, _Alignof(rt_timer*));
+    if (next == NULL) {
+        panic_msg("async: timer allocation failed");
+        return;
+    }
+    ex->timer_heap = next;
+    ex->timers_cap = next_cap;
+}
+
+rt_timer* timer_arm(rt_executor* ex, uint64_t task_id, uint64_t deadline) {
+    // Caller holds ex->lock; the timer wakes task_id once now_ms reaches deadline.
+    if (ex == NULL) {
+        return NULL;
+    }
+    ensure_timer_heap_cap(ex);
+    if (ex->timers_len >= ex->timers_cap) {
+        return NULL;
+    }
+    rt_timer* timer = ex->free_timers;
+    if (timer != NULL) {
+        ex->free_timers = timer->next_free;
+    } else {
+        timer = (rt_timer*)rt_alloc(sizeof(rt_timer), _Alignof(rt_timer));
+        if (timer == NULL) {
+            panic_msg("async: timer allocation failed");
+            return NULL;
+        }
+    }
+    timer->deadline = deadline;
+    timer->task_id = task_id;
+    timer->next_free = NULL;
+    size_t idx = ex->timers_len++;
+    timer_heap_place(ex, idx, timer);
+    timer_sift_up(ex, idx);
+    return timer;
+}
+
+void timer_release(rt_executor* ex, rt_timer* timer) {
+    // Caller holds ex->lock; drops a pending or already fired timer owned by the caller.
+    if (ex == NULL || timer == NULL) {
+        return;
+    }
+    timer_heap_remove(ex, timer);
+    timer->task_id = 0;
+    timer->next_free = ex->free_timers;
+    ex->free_timers = timer;
+}
+
+int timer_expired(const rt_executor* ex, const rt_timer* timer) {
+    return ex != NULL && timer != NULL && timer->deadline <= ex->now_ms;
+}
+
+int timer_next_deadline(const rt_executor* ex, uint64_t* out_deadline) {
+    if (ex == NULL || ex->timers_len == 0) {
+        return 0;
+    }
+    if (out_deadline != NULL) {
+        *out_deadline = ex->timer_heap[0]->deadline;
+    }
+    return 1;
+}
+
+int timer_fire_due(rt_executor* ex) {
+    // Caller holds ex->lock; wakes the owner of every timer whose deadline has passed.
+    if (ex == NULL) {
+        return 0;
+    }
+    int fired = 0;
+    while (ex->timers_len > 0 && ex->timer_heap[0]->deadline <= ex->now_ms) {
+        rt_timer* timer = ex->timer_heap[0];
+        timer_heap_remove(ex, timer);
+        wake_task(ex, timer->task_id, 1);
+        fired++;
+    }
+    return fired;
+}
@@ -0,0 +1,284 @@
+#include "rt_async_internal.h"
+
+// Waiter index: waker_key -> FIFO of parked registrations.
+//
+// All functions here run under ex->lock. Keys hash into chained buckets; each bucket entry
+// is an rt_wait_queue that exists only while it has waiters. Nodes and queues are recycled
+// through executor free lists, so steady-state park/wake does not allocate. Every node is
+// also linked into its task's registration list, which keeps removal by (key, task) and
+// task teardown proportional to the task's own keys rather than to all parked waiters.
+
+static uint64_t waiter_key_hash(waker_key key) {
+    uint64_t z = key.id ^ ((uint64_t)key.kind << 56);
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+static int waiter_key_eq(waker_key a, waker_key b) {
+    return a.kind == b.kind && a.id == b.id;
+}
+
+static int waiter_key_is_net(waker_key key) {
+    return key.kind == WAKER_NET_ACCEPT || key.kind == WAKER_NET_READ ||
+           key.kind == WAKER_NET_WRITE;
+}
+
+static rt_wait_queue** wait_bucket_slot(const rt_executor* ex, waker_key key) {
+    size_t idx = (size_t)(waiter_key_hash(key) & (uint64_t)(ex->wait_buckets_cap - 1));
+    return &ex->wait_buckets[idx];
+}
+
+static rt_wait_queue* wait_queue_find(const rt_executor* ex, waker_key key) {
+    if (ex->wait_buckets_cap == 0) {
+        return NULL;
+    }
+    for (rt_wait_queue* q = *wait_bucket_slot(ex, key); q != NULL; q = q->bucket_next) {
+        if (waiter_key_eq(q->key, key)) {
+            return q;
+        }
+    }
+    return NULL;
+}
+
+static void wait_buckets_grow(rt_executor* ex) {
+    size_t next_cap = ex->wait_buckets_cap == 0 ? 64 : ex->wait_buckets_cap * 2;
+    if (next_cap > SIZE_MAX / sizeof(rt_wait_queue*)) {
+        panic_msg("async: waiter index overflow");
+        return;
+    }
+    rt_wait_queue** next = (rt_wait_queue**)rt_alloc((uint64_t)(next_cap * sizeof(rt_wait_queue*)),
+                                                     _Alignof(rt_wait_queue*));
+    if (next == NULL) {
+        panic_msg("async: waiter allocation failed");
+        return;
+    }
+    memset(next, 0, next_cap * sizeof(rt_wait_queue*));
+    for (size_t i = 0; i < ex->wait_buckets_cap; i++) {
+        rt_wait_queue* q = ex->wait_buckets[i];
+        while (q != NULL) {
+            rt_wait_queue* follow = q->bucket_next;
+            size_t idx = (size_t)(waiter_key_hash(q->key) & (uint64_t)(next_cap - 1));
+            q->bucket_next = next[idx];
+            next[idx] = q;
+            q = follow;
+        }
+    }
+    if (ex->wait_buckets != NULL) {
+        rt_free((uint8_t*)ex->wait_buckets,
+                (uint64_t)(ex->wait_buckets_cap * sizeof(rt_wait_queue*)),
+                _Alignof(rt_wait_queue*));
+    }
+    ex->wait_buckets = next;
+    ex->wait_buckets_cap = next_cap;
+}
+
+static rt_wait_queue* wait_queue_get_or_add(rt_executor* ex, waker_key key) {
+    rt_wait_queue* q = wait_queue_find(ex, key);
+    if (q != NULL) {
+        return q;
+    }
+    if (ex->wait_queues_len >= ex->wait_buckets_cap) {
+        wait_buckets_grow(ex);
+    }
+    q = ex->free_wait_queues;
+    if (q != NULL) {
+        ex->free_wait_queues = q->bucket_next;
+    } else {
+        q = (rt_wait_queue*)rt_alloc(sizeof(rt_wait_queue), _Alignof(rt_wait_queue));
+        if (q == NULL) {
+            panic_msg("async: waiter allocation failed");
+            return NULL;
+        }
+    }
+    memset(q, 0, sizeof(*q));
+    q->key = key;
+    rt_wait_queue** slot = wait_bucket_slot(ex, key);
+    q->bucket_next = *slot;
+    *slot = q;
+    ex->wait_queues_len++;
+    if (waiter_key_is_net(key)) {
+        q->net_next = ex->net_wait_queues;
+        if (ex->net_wait_queues != NULL) {
+            ex->net_wait_queues->net_prev = q;
+        }
+        ex->net_wait_queues = q;
+    }
+    return q;
+}
+
+static void wait_queue_release(rt_executor* ex, rt_wait_queue* q) {
+    rt_wait_queue** slot = wait_bucket_slot(ex, q->key);
+    while (*slot != NULL && *slot != q) {
+        slot = &(*slot)->bucket_next;
+    }
+    if (*slot == q) {
+        *slot = q->bucket_next;
+    }
+    if (waiter_key_is_net(q->key)) {
+        if (q->net_prev != NULL) {
+            q->net_prev->net_next = q->net_next;
+        } else {
+            ex->net_wait_queues = q->net_next;
+        }
+        if (q->net_next != NULL) {
+            q->net_next->net_prev = q->net_prev;
+        }
+    }
+    ex->wait_queues_len--;
+    q->bucket_next = ex->free_wait_queues;
+    ex->free_wait_queues = q;
+}
+
+// Unlinks w from its key queue and task list and recycles it. The queue is released
+// once its last waiter leaves.
+static void waiter_unlink(rt_executor* ex, rt_waiter* w, rt_task* task) {
+    rt_wait_queue* q = w->queue;
+    if (w->prev != NULL) {
+        w->prev->next = w->next;
+    } else {
+        q->head = w->next;
+    }
+    if (w->next != NULL) {
+        w->next->prev = w->prev;
+    } else {
+        q->tail = w->prev;
+    }
+    if (w->task_prev != NULL) {
+        w->task_prev->task_next = w->task_next;
+    } else if (task != NULL && task->waiters == w) {
+        task->waiters = w->task_next;
+    }
+    if (w->task_next != NULL) {
+        w->task_next->task_prev = w->task_prev;
+    }
+    ex->waiters_len--;
+    if (q->key.kind < WAKER_KIND_COUNT) {
+        ex->waiters_by_kind[q->key.kind]--;
+    }
+    if (q->head == NULL) {
+        wait_queue_release(ex, q);
+    }
+    w->next = ex->free_waiters;
+    ex->free_waiters = w;
+}
+
+void add_waiter(rt_executor* ex, waker_key key, uint64_t task_id) {
+    // Caller holds ex->lock; waiters are consumed FIFO per key by pop_waiter.
+    if (ex == NULL || !waker_valid(key)) {
+        return;
+    }
+    rt_wait_queue* q = wait_queue_get_or_add(ex, key);
+    if (q == NULL) {
+        return;
+    }
+    rt_waiter* w = ex->free_waiters;
+    if (w != NULL) {
+        ex->free_waiters = w->next;
+    } else {
+        w = (rt_waiter*)rt_alloc(sizeof(rt_waiter), _Alignof(rt_waiter));
+        if (w == NULL) {
+            panic_msg("async: waiter allocation failed");
+            return;
+        }
+    }
+    memset(w, 0, sizeof(*w));
+    w->task_id = task_id;
+    w->queue = q;
+    w->prev = q->tail;
+    if (q->tail != NULL) {
+        q->tail->next = w;
+    } else {
+        q->head = w;
+    }
+    q->tail = w;
+    rt_task* task = get_task(ex, task_id);
+    if (task != NULL) {
+        w->task_next = task->waiters;
+        if (task->waiters != NULL) {
+            task->waiters->task_prev = w;
+        }
+        task->waiters = w;
+    }
+    ex->waiters_len++;
+    if (key.kind < WAKER_KIND_COUNT) {
+        ex->waiters_by_kind[key.kind]++;
+    }
+}
+
+void remove_waiter(rt_executor* ex, waker_key key, uint64_t task_id) {
+    // Caller holds ex->lock; removes every registration of task_id under key.
+    if (ex == NULL || ex->waiters_len == 0) {
+        return;
+    }
+    rt_task* task = get_task(ex, task_id);
+    if (task != NULL) {
+        rt_waiter* w = task->waiters;
+        while (w != NULL) {
+            rt_waiter* follow = w->task_next;
+            if (waiter_key_eq(w->queue->key, key)) {
+                waiter_unlink(ex, w, task);
+            }
+            w = follow;
+        }
+        return;
+    }
+    rt_wait_queue* q = wait_queue_find(ex, key);
+    rt_waiter* w = q != NULL ? q->head : NULL;
+    while (w != NULL) {
+        rt_waiter* follow = w->next;
+        if (w->task_id == task_id) {
+            waiter_unlink(ex, w, NULL);
+        }
+        w = follow;
+    }
+}
+
+void remove_task_waiters(rt_executor* ex, rt_task* task) {
+    // Caller holds ex->lock; drops every registration still owned by task.
+    if (ex == NULL || task == NULL) {
+        return;
+    }
+    while (task->waiters != NULL) {
+        waiter_unlink(ex, task->waiters, task);
+    }
+}
+
+int take_waiter(rt_executor* ex, waker_key key, uint64_t* out_id) {
+    // Caller holds ex->lock; removes the oldest registration under key regardless of state.
+    if (ex == NULL || !waker_valid(key) || ex->waiters_len == 0) {
+        return 0;
+    }
+    rt_wait_queue* q = wait_queue_find(ex, key);
+    if (q == NULL || q->head == NULL) {
+        return 0;
+    }
+    rt_waiter* w = q->head;
+    uint64_t task_id = w->task_id;
+    waiter_unlink(ex, w, get_task(ex, task_id));
+    if (out_id != NULL) {
+        *out_id = task_id;
+    }
+    return 1;
+}
+
+int pop_waiter(rt_executor* ex, waker_key key, uint64_t* out_id) {
+    // Caller holds ex->lock; stale/done/cancelled waiters ahead of the first live one are
+    // dropped as they are reached.
+    uint64_t task_id = 0;
+    while (take_waiter(ex, key, &task_id)) {
+        const rt_task* task = get_task(ex, task_id);
+        if (task == NULL || task_status_load(task) == TASK_DONE || task_cancelled_load(task) != 0) {
+            continue;
+        }
+        if (out_id != NULL) {
+            *out_id = task_id;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+int has_net_waiters(const rt_executor* ex) {
+    return ex != NULL && ex->net_wait_queues != NULL;
+}
@@ -6,7 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Runtime entry points called from LLVM lowering and intrinsics.
+// Runtime entry points called from LLVM lowering and intrinsics. Integer arithmetic and
+// the int/uint handle helpers live in rt_bignum_api_int.c.
 static bool string_span(void* s, const uint8_t** out_ptr, uint64_t* out_len) {
     if (out_ptr != NULL) {
         *out_ptr = NULL;
@@ -51,7 +52,7 @@ void* rt_bigint_from_literal(const uint8_t* ptr, uint64_t len) {
     memcpy(out->limbs, mag->limbs, (size_t)mag->len * sizeof(uint32_t));
     out->len = mag->len;
     bu_free(mag);
-    return (void*)out;
+    return bi_handle(out);
 }
 
 void* rt_biguint_from_literal(const uint8_t* ptr, uint64_t len) {
@@ -61,7 +62,7 @@ void* rt_biguint_from_literal(const uint8_t* ptr, uint64_t len) {
         bignum_panic_err(err);
         return NULL;
     }
-    return (void*)mag;
+    return bu_handle(mag);
 }
 
 void* rt_bigfloat_from_literal(const uint8_t* ptr, uint64_t len) {
@@ -89,7 +90,9 @@ bool rt_parse_bigint(void* s, void** out) {
         return false;
     }
     if (out != NULL) {
-        *out = res;
+        *out = bi_handle(res);
+    } else {
+        bi_free(res);
     }
     return true;
 }
@@ -109,7 +112,9 @@ bool rt_parse_biguint(void* s, void** out) {
         return false;
     }
     if (out != NULL) {
-        *out = res;
+        *out = bu_handle(res);
+    } else {
+        bu_free(res);
     }
     return true;
 }
@@ -135,8 +140,9 @@ bool rt_parse_bigfloat(void* s, void** out) {
 }
 
 void* rt_string_from_bigint(void* v) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    char* s = format_int((const SurgeBigInt*)v, &err);
+    char* s = format_int(bi_view(v, &buf), &err);
     if (err != BN_OK) {
         bignum_panic_err(err);
         return rt_string_from_bytes(NULL, 0);
@@ -152,8 +158,9 @@ void* rt_string_from_bigint(void* v) {
 }
 
 void* rt_string_from_biguint(void* v) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    char* s = format_uint((const SurgeBigUint*)v, &err);
+    char* s = format_uint(bu_view(v, &buf), &err);
     if (err != BN_OK) {
         bignum_panic_err(err);
         return rt_string_from_bytes(NULL, 0);
@@ -185,42 +192,23 @@ void* rt_string_from_bigfloat(void* v) {
     return out;
 }
 
-void* rt_bigint_from_i64(int64_t value) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_from_i64(value, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_from_u64(uint64_t value) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_from_u64(value, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_from_u64(uint64_t value) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_from_u64(value, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
 void* rt_bigfloat_from_i64(int64_t value) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    SurgeBigInt* i = bi_from_i64(value, &err);
+    SurgeBigInt* heap = NULL;
+    const SurgeBigInt* i = NULL;
+    if (value >= BN_SMALL_INT_MIN && value <= BN_SMALL_INT_MAX) {
+        i = bi_view(bi_handle_i64(value), &buf);
+    } else {
+        heap = bi_from_i64(value, &err);
+        i = heap;
+    }
     if (err != BN_OK) {
         bignum_panic_err(err);
         return NULL;
     }
     SurgeBigFloat* f = bf_from_int(i, &err);
-    bi_free(i);
+    bi_free(heap);
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
@@ -228,14 +216,22 @@ void* rt_bigfloat_from_i64(int64_t value) {
 }
 
 void* rt_bigfloat_from_u64(uint64_t value) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    SurgeBigUint* u = bu_from_u64(value, &err);
+    SurgeBigUint* heap = NULL;
+    const SurgeBigUint* u = NULL;
+    if (value <= BN_SMALL_UINT_MAX) {
+        u = bu_view(bu_handle_u64(value), &buf);
+    } else {
+        heap = bu_from_u64(value, &err);
+        u = heap;
+    }
     if (err != BN_OK) {
         bignum_panic_err(err);
         return NULL;
     }
     SurgeBigFloat* f = bf_from_uint(u, &err);
-    bu_free(u);
+    bu_free(heap);
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
@@ -257,14 +253,6 @@ void* rt_bigfloat_from_f64(double value) {
     return rt_bigfloat_from_literal((const uint8_t*)buf, (uint64_t)n);
 }
 
-bool rt_bigint_to_i64(void* v, int64_t* out) {
-    return bi_to_i64((const SurgeBigInt*)v, out);
-}
-
-bool rt_biguint_to_u64(void* v, uint64_t* out) {
-    return bu_to_u64((const SurgeBigUint*)v, out);
-}
-
 bool rt_bigfloat_to_f64(void* v, double* out) {
     if (out != NULL) {
         *out = 0.0;
@@ -288,224 +276,6 @@ bool rt_bigfloat_to_f64(void* v, double* out) {
     return ok;
 }
 
-void* rt_bigint_add(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_add((const SurgeBigInt*)a, (const SurgeBigInt*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_sub(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_sub((const SurgeBigInt*)a, (const SurgeBigInt*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_mul(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_mul((const SurgeBigInt*)a, (const SurgeBigInt*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_div(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_div_mod((const SurgeBigInt*)a, (const SurgeBigInt*)b, NULL, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_mod(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* rem = NULL;
-    bi_div_mod((const SurgeBigInt*)a, (const SurgeBigInt*)b, &rem, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)rem;
-}
-
-void* rt_bigint_neg(void* a) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_neg((const SurgeBigInt*)a, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_abs(void* a) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_abs_val((const SurgeBigInt*)a, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-int32_t rt_bigint_cmp(void* a, void* b) {
-    return (int32_t)bi_cmp((const SurgeBigInt*)a, (const SurgeBigInt*)b);
-}
-
-void* rt_bigint_bit_and(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_bit_op((const SurgeBigInt*)a, (const SurgeBigInt*)b, bu_and, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_bit_or(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_bit_op((const SurgeBigInt*)a, (const SurgeBigInt*)b, bu_or, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_bit_xor(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_bit_op((const SurgeBigInt*)a, (const SurgeBigInt*)b, bu_xor, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_shl(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_shl((const SurgeBigInt*)a, (const SurgeBigInt*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic("integer overflow");
-    }
-    return (void*)out;
-}
-
-void* rt_bigint_shr(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_shr((const SurgeBigInt*)a, (const SurgeBigInt*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic("integer overflow");
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_add(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_add((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_sub(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_sub((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_mul(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_mul((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_div(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_div_mod((const SurgeBigUint*)a, (const SurgeBigUint*)b, NULL, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_mod(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* rem = NULL;
-    bu_div_mod((const SurgeBigUint*)a, (const SurgeBigUint*)b, &rem, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)rem;
-}
-
-int32_t rt_biguint_cmp(void* a, void* b) {
-    return (int32_t)bu_cmp((const SurgeBigUint*)a, (const SurgeBigUint*)b);
-}
-
-void* rt_biguint_bit_and(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_and((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_bit_or(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_or((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_bit_xor(void* a, void* b) {
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_xor((const SurgeBigUint*)a, (const SurgeBigUint*)b, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_shl(void* a, void* b) {
-    int shift = 0;
-    if (!shift_count_from_biguint((const SurgeBigUint*)b, &shift)) {
-        bignum_panic("integer overflow");
-        return NULL;
-    }
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_shl((const SurgeBigUint*)a, shift, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
-void* rt_biguint_shr(void* a, void* b) {
-    int shift = 0;
-    if (!shift_count_from_biguint((const SurgeBigUint*)b, &shift)) {
-        bignum_panic("integer overflow");
-        return NULL;
-    }
-    bn_err err = BN_OK;
-    SurgeBigUint* out = bu_shr((const SurgeBigUint*)a, shift, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-    }
-    return (void*)out;
-}
-
 void* rt_bigfloat_add(void* a, void* b) {
     bn_err err = BN_OK;
     SurgeBigFloat* out = bf_add((const SurgeBigFloat*)a, (const SurgeBigFloat*)b, &err);
@@ -573,35 +343,10 @@ int32_t rt_bigfloat_cmp(void* a, void* b) {
     return (int32_t)bf_cmp((const SurgeBigFloat*)a, (const SurgeBigFloat*)b);
 }
 
-void* rt_bigint_to_biguint(const void* a) {
-    const SurgeBigInt* src = (const SurgeBigInt*)a;
-    if (src != NULL && src->neg && !bi_is_zero(src)) {
-        bignum_panic("cannot convert negative int to uint");
-        return NULL;
-    }
-    return (void*)bu_clone(bi_as_uint(src), NULL);
-}
-
-void* rt_biguint_to_bigint(const void* a) {
-    const SurgeBigUint* src = (const SurgeBigUint*)a;
-    if (src == NULL || src->len == 0) {
-        return NULL;
-    }
-    bn_err err = BN_OK;
-    SurgeBigInt* out = bi_alloc(src->len, &err);
-    if (err != BN_OK) {
-        bignum_panic_err(err);
-        return NULL;
-    }
-    out->neg = 0;
-    memcpy(out->limbs, src->limbs, (size_t)src->len * sizeof(uint32_t));
-    out->len = src->len;
-    return (void*)out;
-}
-
 void* rt_bigint_to_bigfloat(void* a) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    SurgeBigFloat* out = bf_from_int((const SurgeBigInt*)a, &err);
+    SurgeBigFloat* out = bf_from_int(bi_view(a, &buf), &err);
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
@@ -609,8 +354,9 @@ void* rt_bigint_to_bigfloat(void* a) {
 }
 
 void* rt_biguint_to_bigfloat(void* a) {
+    bn_small_buf buf;
     bn_err err = BN_OK;
-    SurgeBigFloat* out = bf_from_uint((const SurgeBigUint*)a, &err);
+    SurgeBigFloat* out = bf_from_uint(bu_view(a, &buf), &err);
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
@@ -623,7 +369,7 @@ void* rt_bigfloat_to_bigint(void* a) {
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
-    return (void*)out;
+    return bi_handle(out);
 }
 
 void* rt_bigfloat_to_biguint(void* a) {
@@ -636,5 +382,5 @@ void* rt_bigfloat_to_biguint(void* a) {
     if (err != BN_OK) {
         bignum_panic_err(err);
     }
-    return (void*)out;
+    return bu_handle(out);
 }
@@ -0,0 +1,496 @@
+#include "rt_bignum_internal.h"
+
+#include <limits.h>
+#include <string.h>
+
+// Integer runtime entry points. Operands that are both inline take a fixed-width path and
+// only results that leave the inline range are allocated; everything else is decoded with
+// bu_view/bi_view, computed on limbs, and normalized back with bu_handle/bi_handle.
+
+const SurgeBigUint* bu_view(const void* h, bn_small_buf* buf) {
+    uint64_t v = 0;
+    if (!bu_inline_value(h, &v)) {
+        return (const SurgeBigUint*)h;
+    }
+    if (v == 0) {
+        return NULL;
+    }
+    SurgeBigUint* u = (SurgeBigUint*)(void*)buf->words;
+    u->limbs[0] = (uint32_t)v;
+    u->limbs[1] = (uint32_t)(v >> 32);
+    u->len = trim_len(u->limbs, 2);
+    return u;
+}
+
+const SurgeBigInt* bi_view(const void* h, bn_small_buf* buf) {
+    int64_t v = 0;
+    if (!bi_inline_value(h, &v)) {
+        return (const SurgeBigInt*)h;
+    }
+    if (v == 0) {
+        return NULL;
+    }
+    uint64_t mag = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+    SurgeBigInt* i = (SurgeBigInt*)(void*)buf->words;
+    memset(buf->words, 0, sizeof(buf->words));
+    i->neg = v < 0 ? 1 : 0;
+    i->limbs[0] = (uint32_t)mag;
+    i->limbs[1] = (uint32_t)(mag >> 32);
+    i->len = trim_len(i->limbs, 2);
+    return i;
+}
+
+void* bu_handle_u64(uint64_t v) {
+    if (v <= BN_SMALL_UINT_MAX) {
+        return (void*)(((uintptr_t)v << 1) | (v != 0 ? BN_SMALL_TAG : 0));
+    }
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_from_u64(v, &err);
+    if (err != BN_OK) {
+        bignum_panic_err(err);
+    }
+    return (void*)out;
+}
+
+void* bi_handle_i64(int64_t v) {
+    if (v >= BN_SMALL_INT_MIN && v <= BN_SMALL_INT_MAX) {
+        return (void*)(((uintptr_t)(intptr_t)v << 1) | (v != 0 ? BN_SMALL_TAG : 0));
+    }
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_from_i64(v, &err);
+    if (err != BN_OK) {
+        bignum_panic_err(err);
+    }
+    return (void*)out;
+}
+
+void* bu_handle(SurgeBigUint* u) {
+    uint64_t v = 0;
+    if (!bu_to_u64(u, &v) || v > BN_SMALL_UINT_MAX) {
+        return (void*)u;
+    }
+    bu_free(u);
+    return bu_handle_u64(v);
+}
+
+void* bi_handle(SurgeBigInt* i) {
+    int64_t v = 0;
+    if (!bi_to_i64(i, &v) || v < BN_SMALL_INT_MIN || v > BN_SMALL_INT_MAX) {
+        return (void*)i;
+    }
+    bi_free(i);
+    return bi_handle_i64(v);
+}
+
+static void* bu_result(SurgeBigUint* out, bn_err err) {
+    if (err != BN_OK) {
+        bignum_panic_err(err);
+    }
+    return bu_handle(out);
+}
+
+static void* bi_result(SurgeBigInt* out, bn_err err) {
+    if (err != BN_OK) {
+        bignum_panic_err(err);
+    }
+    return bi_handle(out);
+}
+
+void* rt_bigint_from_i64(int64_t value) {
+    return bi_handle_i64(value);
+}
+
+void* rt_bigint_from_u64(uint64_t value) {
+    if (value <= (uint64_t)BN_SMALL_INT_MAX) {
+        return bi_handle_i64((int64_t)value);
+    }
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_from_u64(value, &err);
+    return bi_result(out, err);
+}
+
+void* rt_biguint_from_u64(uint64_t value) {
+    return bu_handle_u64(value);
+}
+
+bool rt_bigint_to_i64(void* v, int64_t* out) {
+    if (bi_inline_value(v, out)) {
+        return true;
+    }
+    return bi_to_i64((const SurgeBigInt*)v, out);
+}
+
+bool rt_biguint_to_u64(void* v, uint64_t* out) {
+    if (bu_inline_value(v, out)) {
+        return true;
+    }
+    return bu_to_u64((const SurgeBigUint*)v, out);
+}
+
+void* rt_bigint_add(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return bi_handle_i64(x + y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_add(bi_view(a, &abuf), bi_view(b, &bbuf), &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_sub(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return bi_handle_i64(x - y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_sub(bi_view(a, &abuf), bi_view(b, &bbuf), &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_mul(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t p = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y) && !__builtin_mul_overflow(x, y, &p)) {
+        return bi_handle_i64(p);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_mul(bi_view(a, &abuf), bi_view(b, &bbuf), &err);
+    return bi_result(out, err);
+}
+
+// Inline division truncates toward zero like bi_div_mod; the inline range excludes
+// INT64_MIN, so x / -1 cannot overflow.
+void* rt_bigint_div(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y) && y != 0) {
+        return bi_handle_i64(x / y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_div_mod(bi_view(a, &abuf), bi_view(b, &bbuf), NULL, &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_mod(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y) && y != 0) {
+        return bi_handle_i64(x % y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* rem = NULL;
+    SurgeBigInt* q = bi_div_mod(bi_view(a, &abuf), bi_view(b, &bbuf), &rem, &err);
+    bi_free(q);
+    return bi_result(rem, err);
+}
+
+void* rt_bigint_neg(void* a) {
+    int64_t x = 0;
+    if (bi_inline_value(a, &x)) {
+        return bi_handle_i64(-x);
+    }
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_neg((const SurgeBigInt*)a, &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_abs(void* a) {
+    int64_t x = 0;
+    if (bi_inline_value(a, &x)) {
+        return bi_handle_i64(x < 0 ? -x : x);
+    }
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_abs_val((const SurgeBigInt*)a, &err);
+    return bi_result(out, err);
+}
+
+int32_t rt_bigint_cmp(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return (int32_t)((x > y) - (x < y));
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    return (int32_t)bi_cmp(bi_view(a, &abuf), bi_view(b, &bbuf));
+}
+
+// Fixed-width two's complement agrees with bi_bit_op's sign-extended limbs for inline values.
+void* rt_bigint_bit_and(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return bi_handle_i64(x & y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_bit_op(bi_view(a, &abuf), bi_view(b, &bbuf), bu_and, &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_bit_or(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return bi_handle_i64(x | y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_bit_op(bi_view(a, &abuf), bi_view(b, &bbuf), bu_or, &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_bit_xor(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y)) {
+        return bi_handle_i64(x ^ y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_bit_op(bi_view(a, &abuf), bi_view(b, &bbuf), bu_xor, &err);
+    return bi_result(out, err);
+}
+
+void* rt_bigint_shl(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t p = 0;
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y) && y >= 0 && y < 63 &&
+        !__builtin_mul_overflow(x, (int64_t)1 << y, &p)) {
+        return bi_handle_i64(p);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_shl(bi_view(a, &abuf), bi_view(b, &bbuf), &err);
+    if (err != BN_OK) {
+        bignum_panic("integer overflow");
+    }
+    return bi_handle(out);
+}
+
+void* rt_bigint_shr(void* a, void* b) {
+    int64_t x = 0;
+    int64_t y = 0;
+    // Negative values keep the limb path and its rounding.
+    if (bi_inline_value(a, &x) && bi_inline_value(b, &y) && x >= 0 && y >= 0 && y <= INT_MAX) {
+        return bi_handle_i64(y < 64 ? x >> y : 0);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_shr(bi_view(a, &abuf), bi_view(b, &bbuf), &err);
+    if (err != BN_OK) {
+        bignum_panic("integer overflow");
+    }
+    return bi_handle(out);
+}
+
+void* rt_biguint_add(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y)) {
+        return bu_handle_u64(x + y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_add(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_sub(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && x >= y) {
+        return bu_handle_u64(x - y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_sub(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_mul(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    uint64_t p = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && !__builtin_mul_overflow(x, y, &p)) {
+        return bu_handle_u64(p);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_mul(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_div(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && y != 0) {
+        return bu_handle_u64(x / y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_div_mod(bu_view(a, &abuf), bu_view(b, &bbuf), NULL, &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_mod(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && y != 0) {
+        return bu_handle_u64(x % y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* rem = NULL;
+    SurgeBigUint* q = bu_div_mod(bu_view(a, &abuf), bu_view(b, &bbuf), &rem, &err);
+    bu_free(q);
+    return bu_result(rem, err);
+}
+
+int32_t rt_biguint_cmp(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y)) {
+        return (int32_t)((x > y) - (x < y));
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    return (int32_t)bu_cmp(bu_view(a, &abuf), bu_view(b, &bbuf));
+}
+
+void* rt_biguint_bit_and(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y)) {
+        return bu_handle_u64(x & y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_and(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_bit_or(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y)) {
+        return bu_handle_u64(x | y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_or(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_bit_xor(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y)) {
+        return bu_handle_u64(x ^ y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_xor(bu_view(a, &abuf), bu_view(b, &bbuf), &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_shl(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && y < 64 && (x << y) >> y == x) {
+        return bu_handle_u64(x << y);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    int shift = 0;
+    if (!shift_count_from_biguint(bu_view(b, &bbuf), &shift)) {
+        bignum_panic("integer overflow");
+        return NULL;
+    }
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_shl(bu_view(a, &abuf), shift, &err);
+    return bu_result(out, err);
+}
+
+void* rt_biguint_shr(void* a, void* b) {
+    uint64_t x = 0;
+    uint64_t y = 0;
+    if (bu_inline_value(a, &x) && bu_inline_value(b, &y) && y <= INT_MAX) {
+        return bu_handle_u64(y < 64 ? x >> y : 0);
+    }
+    bn_small_buf abuf;
+    bn_small_buf bbuf;
+    int shift = 0;
+    if (!shift_count_from_biguint(bu_view(b, &bbuf), &shift)) {
+        bignum_panic("integer overflow");
+        return NULL;
+    }
+    bn_err err = BN_OK;
+    SurgeBigUint* out = bu_shr(bu_view(a, &abuf), shift, &err);
+    return bu_result(out, err);
+}
+
+void* rt_bigint_to_biguint(const void* a) {
+    int64_t x = 0;
+    if (bi_inline_value(a, &x)) {
+        if (x < 0) {
+            bignum_panic("cannot convert negative int to uint");
+            return NULL;
+        }
+        return bu_handle_u64((uint64_t)x);
+    }
+    const SurgeBigInt* src = (const SurgeBigInt*)a;
+    if (src->neg && !bi_is_zero(src)) {
+        bignum_panic("cannot convert negative int to uint");
+        return NULL;
+    }
+    return bu_handle(bu_clone(bi_as_uint(src), NULL));
+}
+
+void* rt_biguint_to_bigint(const void* a) {
+    uint64_t x = 0;
+    if (bu_inline_value(a, &x)) {
+        return rt_bigint_from_u64(x);
+    }
+    const SurgeBigUint* src = (const SurgeBigUint*)a;
+    if (src->len == 0) {
+        return NULL;
+    }
+    bn_err err = BN_OK;
+    SurgeBigInt* out = bi_alloc(src->len, &err);
+    if (err != BN_OK) {
+        bignum_panic_err(err);
+        return NULL;
+    }
+    out->neg = 0;
+    memcpy(out->limbs, src->limbs, (size_t)src->len * sizeof(uint32_t));
+    out->len = src->len;
+    return bi_handle(out);
+}
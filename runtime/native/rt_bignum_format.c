@@ -5,107 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Formatting uses base-1e9 chunks for compact decimal conversion.
-char* format_uint(const SurgeBigUint* u, bn_err* err) {
-    if (err != NULL) {
-        *err = BN_OK;
-    }
-    if (u == NULL || u->len == 0) {
-        char* z = (char*)malloc(2);
-        if (z == NULL) {
-            if (err != NULL) {
-                *err = BN_ERR_MAX_LIMBS;
-            }
-            return NULL;
-        }
-        z[0] = '0';
-        z[1] = 0;
-        return z;
-    }
-    const uint32_t base = SURGE_BIGNUM_DEC_BASE;
-    SurgeBigUint* cur = bu_clone(u, err);
-    if (cur == NULL) {
-        if (err != NULL && *err == BN_OK) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        return NULL;
-    }
-    uint32_t* parts = NULL;
-    size_t parts_len = 0;
-    char* out = NULL;
-    while (cur != NULL && cur->len != 0) {
-        uint32_t rem = 0;
-        bn_err tmp_err = BN_OK;
-        SurgeBigUint* q = bu_div_mod_small(cur, base, &rem, &tmp_err);
-        bu_free(cur);
-        cur = NULL;
-        if (tmp_err != BN_OK) {
-            if (err != NULL) {
-                *err = tmp_err;
-            }
-            bu_free(q);
-            goto cleanup;
-        }
-        uint32_t* next = (uint32_t*)realloc(parts, (parts_len + 1) * sizeof(uint32_t));
-        if (next == NULL) {
-            if (err != NULL) {
-                *err = BN_ERR_MAX_LIMBS;
-            }
-            bu_free(q);
-            goto cleanup;
-        }
-        parts = next;
-        parts[parts_len++] = rem;
-        cur = q;
-    }
-    bu_free(cur);
-    if (parts_len == 0) {
-        if (err != NULL && *err == BN_OK) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        goto cleanup;
-    }
-    char first_buf[32];
-    int first_len = snprintf(first_buf, sizeof(first_buf), "%u", parts[parts_len - 1]);
-    if (first_len < 0) {
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        goto cleanup;
-    }
-    size_t total_len = (size_t)first_len + (parts_len - 1) * 9;
-    out = (char*)malloc(total_len + 1);
-    if (out == NULL) {
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        goto cleanup;
-    }
-    memcpy(out, first_buf, (size_t)first_len);
-    size_t offset = (size_t)first_len;
-    for (size_t i = parts_len - 1; i-- > 0;) {
-        char buf[16];
-        int n = snprintf(buf, sizeof(buf), "%09u", parts[i]);
-        if (n < 0) {
-            if (err != NULL) {
-                *err = BN_ERR_MAX_LIMBS;
-            }
-            free(out);
-            out = NULL;
-            goto cleanup;
-        }
-        memcpy(out + offset, buf, (size_t)n);
-        offset += (size_t)n;
-        if (i == 0) {
-            break;
-        }
-    }
-    out[total_len] = 0;
-cleanup:
-    free(parts);
-    return out;
-}
-
+// BigInt and BigFloat formatting; BigUint digits come from rt_bignum_radix.c.
 char* format_int(const SurgeBigInt* i, bn_err* err) {
     if (err != NULL) {
         *err = BN_OK;
@@ -122,36 +22,25 @@ char* format_int(const SurgeBigInt* i, bn_err* err) {
         z[1] = 0;
         return z;
     }
-    SurgeBigUint* u = bu_clone(bi_as_uint(i), err);
-    if (u == NULL) {
-        if (err != NULL && *err == BN_OK) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        return NULL;
-    }
-    char* base = format_uint(u, err);
+    char* base = format_uint(bi_as_uint(i), err);
     if (base == NULL) {
         if (err != NULL && *err == BN_OK) {
             *err = BN_ERR_MAX_LIMBS;
         }
-        bu_free(u);
         return NULL;
     }
     if (!i->neg) {
-        bu_free(u);
         return base;
     }
     size_t len = strlen(base);
     char* out = (char*)malloc(len + 2);
     if (out == NULL) {
         free(base);
-        bu_free(u);
         return NULL;
     }
     out[0] = '-';
     memcpy(out + 1, base, len + 1);
     free(base);
-    bu_free(u);
     return out;
 }
 
@@ -185,6 +185,15 @@ int bi_cmp(const SurgeBigInt* a, const SurgeBigInt* b) {
     return cmp;
 }
 
+uint64_t bi_hash(const SurgeBigInt* i) {
+    // Zero hashes the same for either sign, matching bi_cmp.
+    if (bi_is_zero(i)) {
+        return bu_hash_limbs(NULL, 0);
+    }
+    uint64_t h = bu_hash_limbs(i->limbs, i->len);
+    return i->neg ? ~h : h;
+}
+
 SurgeBigInt* bi_neg(const SurgeBigInt* a, bn_err* err) {
     if (err != NULL) {
         *err = BN_OK;
@@ -12,6 +12,10 @@
 #define SURGE_BIGNUM_LIMB_BITS 32
 #define SURGE_BIGNUM_LIMB_BASE ((uint64_t)1u << SURGE_BIGNUM_LIMB_BITS)
 
+// Multiplication and division kernels work on 64-bit words packed from pairs of limbs.
+typedef uint64_t bn_word;
+#define SURGE_BIGNUM_WORD_BITS 64
+
 // Hard limit to avoid unbounded allocation in runtime operations.
 #define SURGE_BIGNUM_MAX_LIMBS 1000000u
 
@@ -64,6 +68,44 @@ static inline uint32_t trim_len(const uint32_t* limbs, uint32_t len) {
     return len;
 }
 
+// Small-value handles. Runtime entry points pass int and uint values as opaque pointers:
+// NULL is zero, an odd pointer carries the value inline shifted left by one (63 bits for
+// uint, 63-bit two's complement for int on 64-bit targets), and any other pointer is a heap
+// SurgeBigUint or SurgeBigInt. Entry points return every value that fits inline, so each
+// value has exactly one representation. The bu_/bi_ helpers below only see heap layouts;
+// bu_view and bi_view decode a handle into caller storage for them.
+#define BN_SMALL_TAG ((uintptr_t)1)
+#define BN_SMALL_UINT_MAX ((uint64_t)(UINTPTR_MAX >> 1))
+#define BN_SMALL_INT_MAX ((int64_t)(INTPTR_MAX >> 1))
+#define BN_SMALL_INT_MIN (-BN_SMALL_INT_MAX - 1)
+
+static inline bool bn_is_small(const void* h) {
+    return ((uintptr_t)h & BN_SMALL_TAG) != 0;
+}
+
+// Reads a NULL or inline uint handle; false for heap handles.
+static inline bool bu_inline_value(const void* h, uint64_t* out) {
+    if (h != NULL && !bn_is_small(h)) {
+        return false;
+    }
+    *out = (uint64_t)((uintptr_t)h >> 1);
+    return true;
+}
+
+// Reads a NULL or inline int handle; false for heap handles.
+static inline bool bi_inline_value(const void* h, int64_t* out) {
+    if (h != NULL && !bn_is_small(h)) {
+        return false;
+    }
+    *out = (int64_t)((intptr_t)h >> 1);
+    return true;
+}
+
+// Storage for a decoded inline handle: the BigInt header and two limbs.
+typedef struct bn_small_buf {
+    uint32_t words[4];
+} bn_small_buf;
+
 void bignum_panic(const char* msg);
 void bignum_panic_err(bn_err err);
 
@@ -82,6 +124,8 @@ bool bu_is_zero(const SurgeBigUint* u);
 bool bu_is_odd(const SurgeBigUint* u);
 int bu_cmp_limbs(const uint32_t* a, uint32_t alen, const uint32_t* b, uint32_t blen);
 int bu_cmp(const SurgeBigUint* a, const SurgeBigUint* b);
+uint64_t bu_hash_limbs(const uint32_t* limbs, uint32_t len);
+uint64_t bu_hash(const SurgeBigUint* u);
 bool bu_limbs_to_u64(const uint32_t* limbs, uint32_t len, uint64_t* out);
 bool bu_to_u64(const SurgeBigUint* u, uint64_t* out);
 SurgeBigUint* bu_from_u64(uint64_t v, bn_err* err);
@@ -110,6 +154,60 @@ SurgeBigUint* bu_pow5(int n, bn_err* err);
 SurgeBigUint* bu_low_bits(const SurgeBigUint* u, int bits, bn_err* err);
 bool shift_count_from_biguint(const SurgeBigUint* u, int* out);
 
+// Word kernels (rt_bignum_uint_mul.c). Lengths are in words. add and sub may write over a;
+// the multiply kernels need out apart from both inputs.
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 bn_dword;
+
+static inline bn_word bn_word_mul(bn_word a, bn_word b, bn_word* hi) {
+    bn_dword p = (bn_dword)a * b;
+    *hi = (bn_word)(p >> SURGE_BIGNUM_WORD_BITS);
+    return (bn_word)p;
+}
+#else
+static inline bn_word bn_word_mul(bn_word a, bn_word b, bn_word* hi) {
+    uint64_t al = (uint32_t)a;
+    uint64_t ah = a >> 32;
+    uint64_t bl = (uint32_t)b;
+    uint64_t bh = b >> 32;
+    uint64_t ll = al * bl;
+    uint64_t lh = al * bh;
+    uint64_t hl = ah * bl;
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    *hi = ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (uint32_t)ll;
+}
+#endif
+
+static inline uint32_t bn_words_for_limbs(uint32_t limbs) {
+    return (limbs + 1) / 2;
+}
+void bn_words_from_limbs(bn_word* out, const uint32_t* limbs, uint32_t len);
+void bn_words_to_limbs(uint32_t* out, uint32_t out_len, const bn_word* words, uint32_t len);
+bn_word bn_words_add(
+    bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen);
+bn_word bn_words_sub(
+    bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen);
+bn_word bn_words_submul_1(bn_word* out, const bn_word* a, uint32_t len, bn_word m);
+int bn_words_cmp(const bn_word* a, const bn_word* b, uint32_t len);
+// out receives alen + blen words; requires alen >= blen >= 1. Returns false when the scratch
+// allocation fails.
+bool bn_words_mul(bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen);
+// Tuning knobs, in words, read once from SURGE_BIGNUM_KARATSUBA, SURGE_BIGNUM_TOOM3 and
+// SURGE_BIGNUM_BZ so the threshold sweep in benchmarks/native can move them without a rebuild.
+uint32_t bn_threshold_karatsuba(void);
+uint32_t bn_threshold_toom3(void);
+uint32_t bn_threshold_bz(void);
+
+// Handle conversion (rt_bignum_api_int.c). The views alias buf and must not be freed;
+// bu_handle and bi_handle take ownership of their argument and may free it.
+const SurgeBigUint* bu_view(const void* h, bn_small_buf* buf);
+const SurgeBigInt* bi_view(const void* h, bn_small_buf* buf);
+void* bu_handle(SurgeBigUint* u);
+void* bi_handle(SurgeBigInt* i);
+void* bu_handle_u64(uint64_t v);
+void* bi_handle_i64(int64_t v);
+
 // BigInt helpers.
 SurgeBigInt* bi_alloc(uint32_t len, bn_err* err);
 static inline void bi_free(SurgeBigInt* i) {
@@ -125,6 +223,7 @@ bool bi_to_i64(const SurgeBigInt* i, int64_t* out);
 SurgeBigInt* bi_from_i64(int64_t v, bn_err* err);
 SurgeBigInt* bi_from_u64(uint64_t v, bn_err* err);
 int bi_cmp(const SurgeBigInt* a, const SurgeBigInt* b);
+uint64_t bi_hash(const SurgeBigInt* i);
 SurgeBigInt* bi_neg(const SurgeBigInt* a, bn_err* err);
 SurgeBigInt* bi_abs_val(const SurgeBigInt* a, bn_err* err);
 SurgeBigInt* bi_add(const SurgeBigInt* a, const SurgeBigInt* b, bn_err* err);
@@ -168,7 +267,10 @@ bn_err parse_uint_string(
     const uint8_t* data, size_t len, bool allow_plus, bool allow_prefix, SurgeBigUint** out);
 bn_err parse_int_string(const uint8_t* data, size_t len, SurgeBigInt** out);
 bn_err parse_float_string(const uint8_t* data, size_t len, SurgeBigFloat** out);
+// format_uint and bu_from_digits live in rt_bignum_radix.c. digits holds digit values
+// (0..base-1), most significant first; base is 2, 8, 10, or 16.
 char* format_uint(const SurgeBigUint* u, bn_err* err);
+SurgeBigUint* bu_from_digits(const uint8_t* digits, size_t n, uint32_t base, bn_err* err);
 char* format_int(const SurgeBigInt* i, bn_err* err);
 char* format_float(const SurgeBigFloat* f, bn_err* err);
 
@@ -72,7 +72,11 @@ bn_err parse_uint_string(
     if (start >= end) {
         return BN_ERR_NEG_SHIFT;
     }
-    SurgeBigUint* cur = NULL;
+    uint8_t* digits = (uint8_t*)malloc(end - start);
+    if (digits == NULL) {
+        return BN_ERR_MAX_LIMBS;
+    }
+    size_t n = 0;
     for (size_t i = start; i < end; i++) {
         uint8_t ch = data[i];
         if (ch == '_') {
@@ -81,26 +85,22 @@ bn_err parse_uint_string(
         bool ok = false;
         int d = digit_value((char)ch, base, &ok);
         if (!ok) {
+            free(digits);
             return BN_ERR_NEG_SHIFT;
         }
-        bn_err tmp_err = BN_OK;
-        SurgeBigUint* prev = cur;
-        cur = bu_mul_small(prev, base, &tmp_err);
-        if (tmp_err != BN_OK) {
-            bu_free(prev);
-            bu_free(cur);
-            return tmp_err;
-        }
-        prev = cur;
-        cur = bu_add_small(prev, (uint32_t)d, &tmp_err);
-        if (tmp_err != BN_OK) {
-            bu_free(prev);
-            bu_free(cur);
-            return tmp_err;
-        }
+        digits[n++] = (uint8_t)d;
+    }
+    bn_err err = BN_OK;
+    SurgeBigUint* cur = bu_from_digits(digits, n, base, &err);
+    free(digits);
+    if (err != BN_OK) {
+        bu_free(cur);
+        return err;
     }
     if (out != NULL) {
         *out = cur;
+    } else {
+        bu_free(cur);
     }
     return BN_OK;
 }
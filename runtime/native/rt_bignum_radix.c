@@ -0,0 +1,338 @@
+#include "rt_bignum_internal.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// BigUint <-> digit string conversion. Small values go through u64; medium values are
+// converted in one scratch buffer with base-1e9 steps; large values split around cached
+// powers 10^(9 * 2^k), so the cost follows bu_mul and bu_div_mod instead of growing
+// quadratically with the digit count.
+
+// Below this many limbs (~580 digits) the in-place 1e9 loop beats another split.
+#define BN_RADIX_DC_LIMBS 60u
+// Digit strings shorter than this are parsed with the in-place multiply-add loop.
+#define BN_RADIX_DC_DIGITS 576u
+// Enough levels for SURGE_BIGNUM_MAX_LIMBS: 10^(9 * 2^21) has far more limbs than that.
+#define BN_RADIX_POW_LEVELS 22
+
+#define BN_DEC_CHUNK_DIGITS 9u
+
+// Cached powers are built on first use and kept for the life of the process.
+static _Atomic(SurgeBigUint*) pow10_cache[BN_RADIX_POW_LEVELS];
+
+// Returns 10^(9 * 2^level); the result is shared and must not be freed.
+static const SurgeBigUint* radix_pow(int level, bn_err* err) {
+    SurgeBigUint* cached = atomic_load_explicit(&pow10_cache[level], memory_order_acquire);
+    if (cached != NULL) {
+        return cached;
+    }
+    SurgeBigUint* fresh = NULL;
+    if (level == 0) {
+        fresh = bu_from_u64(SURGE_BIGNUM_DEC_BASE, err);
+    } else {
+        const SurgeBigUint* half = radix_pow(level - 1, err);
+        fresh = half != NULL ? bu_mul(half, half, err) : NULL;
+    }
+    if (fresh == NULL) {
+        if (*err == BN_OK) {
+            *err = BN_ERR_MAX_LIMBS;
+        }
+        return NULL;
+    }
+    SurgeBigUint* expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&pow10_cache[level],
+                                                 &expected,
+                                                 fresh,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+        // Another thread published the same value first.
+        bu_free(fresh);
+        return expected;
+    }
+    return fresh;
+}
+
+static uint32_t limbs_div_small_in_place(uint32_t* limbs, uint32_t len, uint32_t d) {
+    uint64_t rem = 0;
+    for (uint32_t i = len; i-- > 0;) {
+        uint64_t cur = (rem << 32) | limbs[i];
+        limbs[i] = (uint32_t)(cur / d);
+        rem = cur % d;
+    }
+    return (uint32_t)rem;
+}
+
+// Writes v as exactly 9 zero-padded digits ending at end.
+static void write_chunk(char* end, uint32_t v) {
+    for (uint32_t i = 0; i < BN_DEC_CHUNK_DIGITS; i++) {
+        *--end = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+
+// Writes the low width digits of limbs[0..len), zero-padded, into out. Destroys limbs.
+static void format_chunks(uint32_t* limbs, uint32_t len, char* out, size_t width) {
+    char* end = out + width;
+    len = trim_len(limbs, len);
+    while (len > 0 && end - out >= (ptrdiff_t)BN_DEC_CHUNK_DIGITS) {
+        write_chunk(end, limbs_div_small_in_place(limbs, len, SURGE_BIGNUM_DEC_BASE));
+        end -= BN_DEC_CHUNK_DIGITS;
+        len = trim_len(limbs, len);
+    }
+    if (len > 0) {
+        uint32_t v = limbs_div_small_in_place(limbs, len, SURGE_BIGNUM_DEC_BASE);
+        while (end > out) {
+            *--end = (char)('0' + v % 10);
+            v /= 10;
+        }
+    }
+    memset(out, '0', (size_t)(end - out));
+}
+
+// Writes u (< 10^width) as exactly width zero-padded digits, splitting at level while the
+// value is large. width is 2 * 9 * 2^level.
+static bool format_split(const SurgeBigUint* u, int level, char* out, size_t width, bn_err* err) {
+    uint32_t len = u != NULL ? trim_len(u->limbs, u->len) : 0;
+    if (len == 0) {
+        memset(out, '0', width);
+        return true;
+    }
+    if (len < BN_RADIX_DC_LIMBS || level < 0) {
+        uint32_t stack[BN_RADIX_DC_LIMBS];
+        uint32_t* scratch = stack;
+        if (len > BN_RADIX_DC_LIMBS) {
+            scratch = (uint32_t*)malloc((size_t)len * sizeof(uint32_t));
+            if (scratch == NULL) {
+                *err = BN_ERR_MAX_LIMBS;
+                return false;
+            }
+        }
+        memcpy(scratch, u->limbs, (size_t)len * sizeof(uint32_t));
+        format_chunks(scratch, len, out, width);
+        if (scratch != stack) {
+            free(scratch);
+        }
+        return true;
+    }
+    const SurgeBigUint* pow = radix_pow(level, err);
+    if (pow == NULL) {
+        return false;
+    }
+    SurgeBigUint* rem = NULL;
+    SurgeBigUint* quot = bu_div_mod(u, pow, &rem, err);
+    size_t half = width / 2;
+    bool ok = *err == BN_OK && format_split(quot, level - 1, out, half, err) &&
+              format_split(rem, level - 1, out + half, half, err);
+    bu_free(quot);
+    bu_free(rem);
+    return ok;
+}
+
+static char* format_u64(uint64_t v) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    do {
+        *--p = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    size_t n = (size_t)(end - p);
+    char* out = (char*)malloc(n + 1);
+    if (out == NULL) {
+        return NULL;
+    }
+    memcpy(out, p, n);
+    out[n] = 0;
+    return out;
+}
+
+char* format_uint(const SurgeBigUint* u, bn_err* err) {
+    bn_err local = BN_OK;
+    if (err == NULL) {
+        err = &local;
+    }
+    *err = BN_OK;
+    uint64_t small = 0;
+    if (u == NULL || bu_to_u64(u, &small)) {
+        char* out = format_u64(small);
+        if (out == NULL) {
+            *err = BN_ERR_MAX_LIMBS;
+        }
+        return out;
+    }
+    uint32_t bits = bu_bitlen(u);
+    int level = -1;
+    size_t width = 0;
+    if (trim_len(u->limbs, u->len) < BN_RADIX_DC_LIMBS) {
+        // 30103 / 100000 rounds log10(2) up, so this bounds the digit count.
+        width = (size_t)((uint64_t)bits * 30103u / 100000u) + 1;
+    } else {
+        // Smallest level whose square exceeds u: u < 2^bits <= pow^2 once bitlen(pow) is
+        // at least bits / 2 + 1.
+        level = 0;
+        for (;;) {
+            const SurgeBigUint* pow = radix_pow(level, err);
+            if (pow == NULL) {
+                return NULL;
+            }
+            if (2 * (uint64_t)bu_bitlen(pow) >= (uint64_t)bits + 2) {
+                break;
+            }
+            level++;
+        }
+        width = (size_t)BN_DEC_CHUNK_DIGITS << (level + 1);
+    }
+    char* out = (char*)malloc(width + 1);
+    if (out == NULL) {
+        *err = BN_ERR_MAX_LIMBS;
+        return NULL;
+    }
+    if (!format_split(u, level, out, width, err)) {
+        free(out);
+        return NULL;
+    }
+    size_t lead = 0;
+    while (lead + 1 < width && out[lead] == '0') {
+        lead++;
+    }
+    memmove(out, out + lead, width - lead);
+    out[width - lead] = 0;
+    return out;
+}
+
+// limbs[0..*len) = limbs * mul + add; cap bounds the growth.
+static void limbs_mul_add_in_place(
+    uint32_t* limbs, uint32_t* len, uint32_t cap, uint32_t mul, uint32_t add) {
+    uint64_t carry = add;
+    for (uint32_t i = 0; i < *len; i++) {
+        uint64_t cur = (uint64_t)limbs[i] * mul + carry;
+        limbs[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    if (carry != 0 && *len < cap) {
+        limbs[(*len)++] = (uint32_t)carry;
+    }
+}
+
+static SurgeBigUint* parse_chunks(const uint8_t* digits, size_t n, bn_err* err) {
+    // 3402 / 1024 rounds log2(10) up.
+    uint64_t limbs = (uint64_t)n * 3402u / 1024u / SURGE_BIGNUM_LIMB_BITS + 2u;
+    if (limbs > SURGE_BIGNUM_MAX_LIMBS) {
+        *err = BN_ERR_MAX_LIMBS;
+        return NULL;
+    }
+    uint32_t cap = (uint32_t)limbs;
+    SurgeBigUint* out = bu_alloc(cap, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    uint32_t len = 0;
+    size_t i = 0;
+    size_t head = n % BN_DEC_CHUNK_DIGITS;
+    while (i < n) {
+        size_t take = head != 0 ? head : BN_DEC_CHUNK_DIGITS;
+        head = 0;
+        uint32_t chunk = 0;
+        uint32_t scale = 1;
+        for (size_t j = 0; j < take; j++) {
+            chunk = chunk * 10 + digits[i + j];
+            scale *= 10;
+        }
+        limbs_mul_add_in_place(out->limbs, &len, cap, scale, chunk);
+        i += take;
+    }
+    out->len = trim_len(out->limbs, out->len);
+    if (out->len == 0) {
+        bu_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+static SurgeBigUint* parse_split(const uint8_t* digits, size_t n, bn_err* err) {
+    while (n > 0 && digits[0] == 0) {
+        digits++;
+        n--;
+    }
+    if (n < BN_RADIX_DC_DIGITS) {
+        return parse_chunks(digits, n, err);
+    }
+    // The low part takes the largest cached power that leaves a nonempty high part.
+    int level = 0;
+    while (level + 1 < BN_RADIX_POW_LEVELS &&
+           ((size_t)BN_DEC_CHUNK_DIGITS << (level + 1)) < n) {
+        level++;
+    }
+    size_t low_n = (size_t)BN_DEC_CHUNK_DIGITS << level;
+    SurgeBigUint* high = parse_split(digits, n - low_n, err);
+    if (*err != BN_OK) {
+        return NULL;
+    }
+    SurgeBigUint* low = parse_split(digits + n - low_n, low_n, err);
+    if (*err != BN_OK) {
+        bu_free(high);
+        return NULL;
+    }
+    const SurgeBigUint* pow = radix_pow(level, err);
+    SurgeBigUint* scaled = pow != NULL ? bu_mul(high, pow, err) : NULL;
+    SurgeBigUint* out = *err == BN_OK ? bu_add(scaled, low, err) : NULL;
+    bu_free(high);
+    bu_free(low);
+    bu_free(scaled);
+    if (*err != BN_OK) {
+        bu_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+// Packs digits of 2^bits_per_digit directly into limbs, least significant digit first.
+static SurgeBigUint*
+parse_pow2(const uint8_t* digits, size_t n, uint32_t bits_per_digit, bn_err* err) {
+    uint64_t total_bits = (uint64_t)n * bits_per_digit;
+    uint64_t limbs = (total_bits + SURGE_BIGNUM_LIMB_BITS - 1) / SURGE_BIGNUM_LIMB_BITS;
+    if (limbs > SURGE_BIGNUM_MAX_LIMBS) {
+        *err = BN_ERR_MAX_LIMBS;
+        return NULL;
+    }
+    SurgeBigUint* out = bu_alloc((uint32_t)limbs, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    uint64_t bit = 0;
+    for (size_t i = n; i-- > 0;) {
+        uint64_t v = (uint64_t)digits[i] << (bit % SURGE_BIGNUM_LIMB_BITS);
+        uint64_t at = bit / SURGE_BIGNUM_LIMB_BITS;
+        out->limbs[at] |= (uint32_t)v;
+        if ((v >> 32) != 0) {
+            out->limbs[at + 1] |= (uint32_t)(v >> 32);
+        }
+        bit += bits_per_digit;
+    }
+    out->len = trim_len(out->limbs, out->len);
+    if (out->len == 0) {
+        bu_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+SurgeBigUint* bu_from_digits(const uint8_t* digits, size_t n, uint32_t base, bn_err* err) {
+    bn_err local = BN_OK;
+    if (err == NULL) {
+        err = &local;
+    }
+    *err = BN_OK;
+    if (base == 2 || base == 8 || base == 16) {
+        return parse_pow2(digits, n, base == 2 ? 1u : base == 8 ? 3u : 4u, err);
+    }
+    if (n <= 19) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < n; i++) {
+            v = v * 10 + digits[i];
+        }
+        return bu_from_u64(v, err);
+    }
+    return parse_split(digits, n, err);
+}
@@ -114,6 +114,25 @@ int bu_cmp(const SurgeBigUint* a, const SurgeBigUint* b) {
     return bu_cmp_limbs(al, alen, bl, blen);
 }
 
+uint64_t bu_hash_limbs(const uint32_t* limbs, uint32_t len) {
+    // Hashes the trimmed magnitude so equal values hash equally regardless of padding.
+    len = limbs != NULL ? trim_len(limbs, len) : 0;
+    uint64_t h = UINT64_C(0x9e3779b97f4a7c15) ^ (uint64_t)len;
+    for (uint32_t i = 0; i < len; i++) {
+        h ^= (uint64_t)limbs[i];
+        h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+uint64_t bu_hash(const SurgeBigUint* u) {
+    if (u == NULL) {
+        return bu_hash_limbs(NULL, 0);
+    }
+    return bu_hash_limbs(u->limbs, u->len);
+}
+
 bool bu_limbs_to_u64(const uint32_t* limbs, uint32_t len, uint64_t* out) {
     if (out != NULL) {
         *out = 0;
@@ -308,59 +327,7 @@ SurgeBigUint* bu_sub(const SurgeBigUint* a, const SurgeBigUint* b, bn_err* err)
     bu_sub_in_place(out->limbs, out->len, b->limbs, blen);
     out->len = trim_len(out->limbs, out->len);
     if (out->len == 0) {
-        return NULL;
-    }
-    return out;
-}
-
-SurgeBigUint* bu_mul(const SurgeBigUint* a, const SurgeBigUint* b, bn_err* err) {
-    if (err != NULL) {
-        *err = BN_OK;
-    }
-    if (a == NULL || b == NULL) {
-        return NULL;
-    }
-    uint32_t alen = trim_len(a->limbs, a->len);
-    uint32_t blen = trim_len(b->limbs, b->len);
-    if (alen == 0 || blen == 0) {
-        return NULL;
-    }
-    if ((uint64_t)alen + (uint64_t)blen > SURGE_BIGNUM_MAX_LIMBS) {
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        return NULL;
-    }
-    SurgeBigUint* out = bu_alloc(alen + blen, err);
-    if (out == NULL) {
-        return NULL;
-    }
-    memset(out->limbs, 0, (size_t)out->len * sizeof(uint32_t));
-    for (uint32_t i = 0; i < alen; i++) {
-        uint64_t ai = a->limbs[i];
-        uint64_t carry = 0;
-        for (uint32_t j = 0; j < blen; j++) {
-            uint32_t k = i + j;
-            uint64_t sum = (uint64_t)out->limbs[k] + ai * (uint64_t)b->limbs[j] + carry;
-            out->limbs[k] = (uint32_t)sum;
-            carry = sum >> 32;
-        }
-        uint32_t k = i + blen;
-        while (carry != 0) {
-            if (k >= out->len) {
-                if (err != NULL) {
-                    *err = BN_ERR_MAX_LIMBS;
-                }
-                return NULL;
-            }
-            uint64_t sum = (uint64_t)out->limbs[k] + carry;
-            out->limbs[k] = (uint32_t)sum;
-            carry = sum >> 32;
-            k++;
-        }
-    }
-    out->len = trim_len(out->limbs, out->len);
-    if (out->len == 0) {
+        bu_free(out);
         return NULL;
     }
     return out;
@@ -49,18 +49,6 @@ SurgeBigUint* bu_div_mod_small(const SurgeBigUint* u, uint32_t d, uint32_t* rem,
     return out;
 }
 
-static void bu_shr1_in_place(uint32_t* limbs, uint32_t len) {
-    uint32_t carry = 0;
-    for (uint32_t i = len; i-- > 0;) {
-        uint32_t v = limbs[i];
-        limbs[i] = (v >> 1) | (carry << 31);
-        carry = v & 1u;
-        if (i == 0) {
-            break;
-        }
-    }
-}
-
 SurgeBigUint* bu_shl(const SurgeBigUint* u, int bits, bn_err* err) {
     if (err != NULL) {
         *err = BN_OK;
@@ -177,143 +165,6 @@ SurgeBigUint* bu_shr(const SurgeBigUint* u, int bits, bn_err* err) {
     return out;
 }
 
-// Long division in base 2^32 with normalization; returns quotient and remainder.
-SurgeBigUint*
-bu_div_mod(const SurgeBigUint* a, const SurgeBigUint* b, SurgeBigUint** out_rem, bn_err* err) {
-    if (err != NULL) {
-        *err = BN_OK;
-    }
-    if (out_rem != NULL) {
-        *out_rem = NULL;
-    }
-    if (b == NULL || b->len == 0) {
-        if (err != NULL) {
-            *err = BN_ERR_DIV_ZERO;
-        }
-        return NULL;
-    }
-    if (a == NULL || a->len == 0) {
-        return NULL;
-    }
-    if (bu_cmp(a, b) < 0) {
-        if (out_rem != NULL) {
-            *out_rem = bu_clone(a, err);
-        }
-        return NULL;
-    }
-    int shift = (int)bu_bitlen(a) - (int)bu_bitlen(b);
-    if (shift < 0) {
-        if (out_rem != NULL) {
-            *out_rem = bu_clone(a, err);
-        }
-        return NULL;
-    }
-    if ((uint32_t)(shift / 32 + 1) > SURGE_BIGNUM_MAX_LIMBS) {
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        return NULL;
-    }
-    bn_err tmp_err = BN_OK;
-    SurgeBigUint* denom_shifted = bu_shl(b, shift, &tmp_err);
-    if (denom_shifted == NULL && tmp_err != BN_OK) {
-        if (err != NULL) {
-            *err = tmp_err;
-        }
-        return NULL;
-    }
-    uint32_t denom_len = denom_shifted ? denom_shifted->len : 0;
-    uint32_t* denom = NULL;
-    if (denom_len > 0) {
-        denom = (uint32_t*)malloc((size_t)denom_len * sizeof(uint32_t));
-        if (denom == NULL) {
-            if (err != NULL) {
-                *err = BN_ERR_MAX_LIMBS;
-            }
-            bu_free(denom_shifted);
-            return NULL;
-        }
-        memcpy(denom, denom_shifted->limbs, (size_t)denom_len * sizeof(uint32_t));
-    }
-    bu_free(denom_shifted);
-    denom_shifted = NULL;
-
-    uint32_t rem_len = a->len;
-    uint32_t* rem = (uint32_t*)malloc((size_t)rem_len * sizeof(uint32_t));
-    if (rem == NULL) {
-        free(denom);
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        return NULL;
-    }
-    memcpy(rem, a->limbs, (size_t)rem_len * sizeof(uint32_t));
-
-    uint32_t quot_len = (uint32_t)(shift / 32 + 1);
-    SurgeBigUint* quot = bu_alloc(quot_len, err);
-    if (quot == NULL) {
-        free(denom);
-        free(rem);
-        return NULL;
-    }
-    memset(quot->limbs, 0, (size_t)quot->len * sizeof(uint32_t));
-
-    for (int i = shift; i >= 0; i--) {
-        uint32_t denom_trim = trim_len(denom, denom_len);
-        uint32_t rem_trim = trim_len(rem, rem_len);
-        if (rem_trim > 0 && denom_trim > 0) {
-            if (bu_cmp_limbs(rem, rem_trim, denom, denom_trim) >= 0) {
-                bu_sub_in_place(rem, rem_len, denom, denom_len);
-                quot->limbs[(uint32_t)i / 32] |= (uint32_t)1 << (i % 32);
-            }
-        }
-        if (denom_len > 0) {
-            bu_shr1_in_place(denom, denom_len);
-        }
-        if (i == 0) {
-            break;
-        }
-    }
-
-    quot->len = trim_len(quot->limbs, quot->len);
-    if (quot->len > SURGE_BIGNUM_MAX_LIMBS) {
-        if (err != NULL) {
-            *err = BN_ERR_MAX_LIMBS;
-        }
-        free(denom);
-        free(rem);
-        bu_free(quot);
-        return NULL;
-    }
-
-    uint32_t rem_trim = trim_len(rem, rem_len);
-    if (out_rem != NULL) {
-        if (rem_trim == 0) {
-            *out_rem = NULL;
-        } else {
-            SurgeBigUint* r = bu_alloc(rem_trim, err);
-            if (r == NULL) {
-                free(denom);
-                free(rem);
-                bu_free(quot);
-                return NULL;
-            }
-            memcpy(r->limbs, rem, (size_t)rem_trim * sizeof(uint32_t));
-            r->len = rem_trim;
-            *out_rem = r;
-        }
-    }
-
-    free(denom);
-    free(rem);
-
-    if (quot->len == 0) {
-        bu_free(quot);
-        return NULL;
-    }
-    return quot;
-}
-
 SurgeBigUint* bu_and(const SurgeBigUint* a, const SurgeBigUint* b, bn_err* err) {
     if (err != NULL) {
         *err = BN_OK;
@@ -0,0 +1,490 @@
+#include "rt_bignum_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// BigUint long division. Knuth's algorithm D runs on 64-bit words for ordinary sizes;
+// Burnikel-Ziegler recursion splits large divisions into half-size ones that end in
+// multiplications, so they inherit Karatsuba and Toom-3 from bu_mul.
+
+// Divides u1:u0 by a normalized v (top bit set); requires u1 < v.
+static bn_word word_div(bn_word u1, bn_word u0, bn_word v, bn_word* rem) {
+#if defined(__SIZEOF_INT128__)
+    bn_dword n = ((bn_dword)u1 << SURGE_BIGNUM_WORD_BITS) | u0;
+    *rem = (bn_word)(n % v);
+    return (bn_word)(n / v);
+#else
+    const bn_word half = (bn_word)1 << 32;
+    bn_word vn1 = v >> 32;
+    bn_word vn0 = (uint32_t)v;
+    bn_word un1 = u0 >> 32;
+    bn_word un0 = (uint32_t)u0;
+    bn_word q1 = u1 / vn1;
+    bn_word rhat = u1 - q1 * vn1;
+    while (q1 >= half || q1 * vn0 > half * rhat + un1) {
+        q1--;
+        rhat += vn1;
+        if (rhat >= half) {
+            break;
+        }
+    }
+    bn_word un21 = u1 * half + un1 - q1 * v;
+    bn_word q0 = un21 / vn1;
+    rhat = un21 - q0 * vn1;
+    while (q0 >= half || q0 * vn0 > half * rhat + un0) {
+        q0--;
+        rhat += vn1;
+        if (rhat >= half) {
+            break;
+        }
+    }
+    *rem = un21 * half + un0 - q0 * v;
+    return q1 * half + q0;
+#endif
+}
+
+static void words_shl_into(bn_word* out, const bn_word* in, uint32_t len, int shift) {
+    if (shift == 0) {
+        memcpy(out, in, (size_t)len * sizeof(bn_word));
+        out[len] = 0;
+        return;
+    }
+    bn_word carry = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        out[i] = (in[i] << shift) | carry;
+        carry = in[i] >> (SURGE_BIGNUM_WORD_BITS - shift);
+    }
+    out[len] = carry;
+}
+
+static void words_shr_in_place(bn_word* w, uint32_t len, int shift) {
+    if (shift == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word hi = i + 1 < len ? w[i + 1] << (SURGE_BIGNUM_WORD_BITS - shift) : 0;
+        w[i] = (w[i] >> shift) | hi;
+    }
+}
+
+// Algorithm D: u has m words, v has n words with a nonzero top word and m >= n. q receives
+// m - n + 1 words and r receives n words. un and vn are scratch of m + 1 and n + 1 words.
+static void words_divmod(bn_word* q,
+                         bn_word* r,
+                         const bn_word* u,
+                         uint32_t m,
+                         const bn_word* v,
+                         uint32_t n,
+                         bn_word* un,
+                         bn_word* vn) {
+    int shift = __builtin_clzll(v[n - 1]);
+    words_shl_into(un, u, m, shift);
+    if (n == 1) {
+        bn_word d = v[0] << shift;
+        bn_word rem = un[m];
+        for (uint32_t j = m; j-- > 0;) {
+            q[j] = word_div(rem, un[j], d, &rem);
+        }
+        q[m] = 0;
+        r[0] = rem >> shift;
+        return;
+    }
+    words_shl_into(vn, v, n, shift);
+    bn_word vtop = vn[n - 1];
+    bn_word vnext = vn[n - 2];
+    for (uint32_t j = m - n + 1; j-- > 0;) {
+        bn_word u2 = un[j + n];
+        bn_word u1 = un[j + n - 1];
+        bn_word u0 = un[j + n - 2];
+        bn_word qhat = 0;
+        bn_word rhat = 0;
+        bool rhat_overflow = false;
+        if (u2 >= vtop) {
+            qhat = ~(bn_word)0;
+            rhat = u1 + vtop;
+            rhat_overflow = rhat < u1;
+        } else {
+            qhat = word_div(u2, u1, vtop, &rhat);
+        }
+        while (!rhat_overflow) {
+            bn_word hi = 0;
+            bn_word lo = bn_word_mul(qhat, vnext, &hi);
+            if (hi < rhat || (hi == rhat && lo <= u0)) {
+                break;
+            }
+            qhat--;
+            bn_word prev = rhat;
+            rhat += vtop;
+            rhat_overflow = rhat < prev;
+        }
+        bn_word borrow = bn_words_submul_1(un + j, vn, n, qhat);
+        bn_word top = un[j + n];
+        un[j + n] = top - borrow;
+        if (top < borrow) {
+            qhat--;
+            un[j + n] += bn_words_add(un + j, un + j, n, vn, n);
+        }
+        q[j] = qhat;
+    }
+    memcpy(r, un, (size_t)n * sizeof(bn_word));
+    words_shr_in_place(r, n, shift);
+}
+
+static SurgeBigUint* bu_from_words(const bn_word* words, uint32_t len, bn_err* err) {
+    uint32_t limbs = 2 * len;
+    while (limbs > 0) {
+        uint32_t limb = (uint32_t)(words[(limbs - 1) / 2] >> (32 * ((limbs - 1) % 2)));
+        if (limb != 0) {
+            break;
+        }
+        limbs--;
+    }
+    if (limbs == 0) {
+        return NULL;
+    }
+    SurgeBigUint* out = bu_alloc(limbs, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    bn_words_to_limbs(out->limbs, limbs, words, len);
+    return out;
+}
+
+static SurgeBigUint* bu_from_limbs(const uint32_t* limbs, uint32_t len, bn_err* err) {
+    len = trim_len(limbs, len);
+    if (len == 0) {
+        return NULL;
+    }
+    SurgeBigUint* out = bu_alloc(len, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    memcpy(out->limbs, limbs, (size_t)len * sizeof(uint32_t));
+    return out;
+}
+
+// Schoolbook division for a >= b > 0; NULL results mean zero.
+static bool bu_div_knuth(const SurgeBigUint* a,
+                         const SurgeBigUint* b,
+                         SurgeBigUint** out_q,
+                         SurgeBigUint** out_r,
+                         bn_err* err) {
+    uint32_t alen = trim_len(a->limbs, a->len);
+    uint32_t blen = trim_len(b->limbs, b->len);
+    if (blen == 1) {
+        uint32_t rem = 0;
+        *out_q = bu_div_mod_small(a, b->limbs[0], &rem, err);
+        if (*err != BN_OK) {
+            return false;
+        }
+        if (rem != 0) {
+            *out_r = bu_from_u64(rem, err);
+        }
+        return *err == BN_OK;
+    }
+    uint32_t m = bn_words_for_limbs(alen);
+    uint32_t n = bn_words_for_limbs(blen);
+    size_t words = (size_t)m + n + (m - n + 1) + n + (m + 1) + (n + 1);
+    bn_word* buf = (bn_word*)malloc(words * sizeof(bn_word));
+    if (buf == NULL) {
+        *err = BN_ERR_MAX_LIMBS;
+        return false;
+    }
+    bn_word* u = buf;
+    bn_word* v = u + m;
+    bn_word* q = v + n;
+    bn_word* r = q + (m - n + 1);
+    bn_word* un = r + n;
+    bn_word* vn = un + m + 1;
+    bn_words_from_limbs(u, a->limbs, alen);
+    bn_words_from_limbs(v, b->limbs, blen);
+    words_divmod(q, r, u, m, v, n, un, vn);
+    *out_q = bu_from_words(q, m - n + 1, err);
+    if (*err == BN_OK) {
+        *out_r = bu_from_words(r, n, err);
+    }
+    free(buf);
+    return *err == BN_OK;
+}
+
+static bool bz_div2n1n(const SurgeBigUint* a,
+                       const SurgeBigUint* b,
+                       int n,
+                       SurgeBigUint** out_q,
+                       SurgeBigUint** out_r,
+                       bn_err* err);
+
+static SurgeBigUint* bu_pred(const SurgeBigUint* u, bn_err* err) {
+    SurgeBigUint* out = bu_clone(u, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    const uint32_t one = 1;
+    bu_sub_in_place(out->limbs, out->len, &one, 1);
+    out->len = trim_len(out->limbs, out->len);
+    if (out->len == 0) {
+        bu_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+// Divides a12 * 2^n + a3 by b = b1 * 2^n + b2 where a12 < b * 2^n, as in Burnikel-Ziegler.
+static bool bz_div3n2n(const SurgeBigUint* a12,
+                       const SurgeBigUint* a3,
+                       const SurgeBigUint* b,
+                       const SurgeBigUint* b1,
+                       const SurgeBigUint* b2,
+                       int n,
+                       SurgeBigUint** out_q,
+                       SurgeBigUint** out_r,
+                       bn_err* err) {
+    SurgeBigUint* q = NULL;
+    SurgeBigUint* r = NULL;
+    SurgeBigUint* top = bu_shr(a12, n, err);
+    bool ok = *err == BN_OK;
+    if (ok && bu_cmp(top, b1) == 0) {
+        // The quotient digit saturates at 2^n - 1 and its remainder needs no division.
+        SurgeBigUint* one = bu_from_u64(1, err);
+        SurgeBigUint* pow = *err == BN_OK ? bu_shl(one, n, err) : NULL;
+        q = *err == BN_OK ? bu_sub(pow, one, err) : NULL;
+        SurgeBigUint* b1_shifted = *err == BN_OK ? bu_shl(b1, n, err) : NULL;
+        SurgeBigUint* sum = *err == BN_OK ? bu_add(a12, b1, err) : NULL;
+        r = *err == BN_OK ? bu_sub(sum, b1_shifted, err) : NULL;
+        bu_free(one);
+        bu_free(pow);
+        bu_free(b1_shifted);
+        bu_free(sum);
+        ok = *err == BN_OK;
+    } else if (ok) {
+        ok = bz_div2n1n(a12, b1, n, &q, &r, err);
+    }
+    bu_free(top);
+    SurgeBigUint* t = NULL;
+    SurgeBigUint* p = NULL;
+    if (ok) {
+        SurgeBigUint* shifted = bu_shl(r, n, err);
+        t = *err == BN_OK ? bu_or(shifted, a3, err) : NULL;
+        p = *err == BN_OK ? bu_mul(q, b2, err) : NULL;
+        bu_free(shifted);
+        ok = *err == BN_OK;
+    }
+    bu_free(r);
+    r = NULL;
+    // The estimate is at most two too large.
+    while (ok && bu_cmp(t, p) < 0) {
+        SurgeBigUint* q_next = bu_pred(q, err);
+        SurgeBigUint* t_next = *err == BN_OK ? bu_add(t, b, err) : NULL;
+        bu_free(q);
+        bu_free(t);
+        q = q_next;
+        t = t_next;
+        ok = *err == BN_OK;
+    }
+    if (ok) {
+        r = bu_sub(t, p, err);
+        ok = *err == BN_OK;
+    }
+    bu_free(t);
+    bu_free(p);
+    if (!ok) {
+        bu_free(q);
+        bu_free(r);
+        return false;
+    }
+    *out_q = q;
+    *out_r = r;
+    return true;
+}
+
+// Divides a < b * 2^n by b with bitlen(b) == n.
+static bool bz_div2n1n(const SurgeBigUint* a,
+                       const SurgeBigUint* b,
+                       int n,
+                       SurgeBigUint** out_q,
+                       SurgeBigUint** out_r,
+                       bn_err* err) {
+    *out_q = NULL;
+    *out_r = NULL;
+    if (bu_cmp(a, b) < 0) {
+        *out_r = bu_clone(a, err);
+        return *err == BN_OK;
+    }
+    if ((int64_t)bu_bitlen(a) - n <= (int64_t)bn_threshold_bz() * SURGE_BIGNUM_WORD_BITS) {
+        return bu_div_knuth(a, b, out_q, out_r, err);
+    }
+    SurgeBigUint* a_pad = NULL;
+    SurgeBigUint* b_pad = NULL;
+    int pad = n & 1;
+    if (pad) {
+        a_pad = bu_shl(a, 1, err);
+        b_pad = *err == BN_OK ? bu_shl(b, 1, err) : NULL;
+        if (*err != BN_OK) {
+            bu_free(a_pad);
+            return false;
+        }
+        a = a_pad;
+        b = b_pad;
+        n++;
+    }
+    int half = n / 2;
+    SurgeBigUint* b1 = bu_shr(b, half, err);
+    SurgeBigUint* b2 = *err == BN_OK ? bu_low_bits(b, half, err) : NULL;
+    SurgeBigUint* a12 = *err == BN_OK ? bu_shr(a, n, err) : NULL;
+    SurgeBigUint* a_mid = *err == BN_OK ? bu_shr(a, half, err) : NULL;
+    SurgeBigUint* a3 = *err == BN_OK ? bu_low_bits(a_mid, half, err) : NULL;
+    SurgeBigUint* a4 = *err == BN_OK ? bu_low_bits(a, half, err) : NULL;
+    SurgeBigUint* q1 = NULL;
+    SurgeBigUint* q2 = NULL;
+    SurgeBigUint* r1 = NULL;
+    SurgeBigUint* r = NULL;
+    bool ok = *err == BN_OK && bz_div3n2n(a12, a3, b, b1, b2, half, &q1, &r1, err) &&
+              bz_div3n2n(r1, a4, b, b1, b2, half, &q2, &r, err);
+    if (ok) {
+        SurgeBigUint* q1_shifted = bu_shl(q1, half, err);
+        *out_q = *err == BN_OK ? bu_or(q1_shifted, q2, err) : NULL;
+        bu_free(q1_shifted);
+        ok = *err == BN_OK;
+    }
+    if (ok && pad) {
+        *out_r = bu_shr(r, 1, err);
+        ok = *err == BN_OK;
+    } else if (ok) {
+        *out_r = r;
+        r = NULL;
+    }
+    bu_free(a_pad);
+    bu_free(b_pad);
+    bu_free(b1);
+    bu_free(b2);
+    bu_free(a12);
+    bu_free(a_mid);
+    bu_free(a3);
+    bu_free(a4);
+    bu_free(q1);
+    bu_free(q2);
+    bu_free(r1);
+    bu_free(r);
+    if (!ok) {
+        bu_free(*out_q);
+        bu_free(*out_r);
+        *out_q = NULL;
+        *out_r = NULL;
+    }
+    return ok;
+}
+
+// Splits a into digits of the normalized divisor's width and feeds them through bz_div2n1n
+// from the top, so every step divides a two-digit value by the one-digit divisor.
+static bool bu_div_bz(const SurgeBigUint* a,
+                      const SurgeBigUint* b,
+                      SurgeBigUint** out_q,
+                      SurgeBigUint** out_r,
+                      bn_err* err) {
+    int shift = (int)((32 - bu_bitlen(b) % 32) % 32);
+    SurgeBigUint* bs = bu_shl(b, shift, err);
+    SurgeBigUint* as = *err == BN_OK ? bu_shl(a, shift, err) : NULL;
+    if (*err != BN_OK) {
+        bu_free(bs);
+        return false;
+    }
+    uint32_t nl = bs->len;
+    uint32_t alen = as->len;
+    uint32_t digits = (alen + nl - 1) / nl;
+    int n = (int)nl * SURGE_BIGNUM_LIMB_BITS;
+    SurgeBigUint* q = bu_alloc(digits * nl, err);
+    SurgeBigUint* cur = *err == BN_OK ? bu_alloc(2 * nl, err) : NULL;
+    SurgeBigUint* r = NULL;
+    bool ok = *err == BN_OK;
+    if (ok) {
+        memset(q->limbs, 0, (size_t)q->len * sizeof(uint32_t));
+    }
+    for (uint32_t i = digits; ok && i-- > 0;) {
+        uint32_t off = i * nl;
+        uint32_t take = alen - off < nl ? alen - off : nl;
+        memset(cur->limbs, 0, (size_t)(2 * nl) * sizeof(uint32_t));
+        memcpy(cur->limbs, as->limbs + off, (size_t)take * sizeof(uint32_t));
+        if (r != NULL) {
+            memcpy(cur->limbs + nl, r->limbs, (size_t)r->len * sizeof(uint32_t));
+        }
+        SurgeBigUint* cur_trim = bu_from_limbs(cur->limbs, 2 * nl, err);
+        SurgeBigUint* qd = NULL;
+        bu_free(r);
+        r = NULL;
+        ok = *err == BN_OK;
+        if (ok && cur_trim != NULL) {
+            ok = bz_div2n1n(cur_trim, bs, n, &qd, &r, err);
+        }
+        if (ok && qd != NULL) {
+            memcpy(q->limbs + off, qd->limbs, (size_t)qd->len * sizeof(uint32_t));
+        }
+        bu_free(cur_trim);
+        bu_free(qd);
+    }
+    SurgeBigUint* rem = NULL;
+    if (ok) {
+        rem = bu_shr(r, shift, err);
+        ok = *err == BN_OK;
+    }
+    SurgeBigUint* quot = ok ? bu_from_limbs(q->limbs, q->len, err) : NULL;
+    ok = ok && *err == BN_OK;
+    bu_free(bs);
+    bu_free(as);
+    bu_free(q);
+    bu_free(cur);
+    bu_free(r);
+    if (!ok) {
+        bu_free(rem);
+        bu_free(quot);
+        return false;
+    }
+    *out_q = quot;
+    *out_r = rem;
+    return true;
+}
+
+// Long division; returns quotient and remainder.
+SurgeBigUint*
+bu_div_mod(const SurgeBigUint* a, const SurgeBigUint* b, SurgeBigUint** out_rem, bn_err* err) {
+    bn_err local = BN_OK;
+    if (err == NULL) {
+        err = &local;
+    }
+    *err = BN_OK;
+    if (out_rem != NULL) {
+        *out_rem = NULL;
+    }
+    if (b == NULL || trim_len(b->limbs, b->len) == 0) {
+        *err = BN_ERR_DIV_ZERO;
+        return NULL;
+    }
+    if (a == NULL || trim_len(a->limbs, a->len) == 0) {
+        return NULL;
+    }
+    if (bu_cmp(a, b) < 0) {
+        if (out_rem != NULL) {
+            *out_rem = bu_clone(a, err);
+        }
+        return NULL;
+    }
+    uint32_t aw = bn_words_for_limbs(trim_len(a->limbs, a->len));
+    uint32_t bw = bn_words_for_limbs(trim_len(b->limbs, b->len));
+    uint32_t bz = bn_threshold_bz();
+    SurgeBigUint* q = NULL;
+    SurgeBigUint* r = NULL;
+    bool ok = false;
+    if (bw >= bz && aw - bw >= bz) {
+        ok = bu_div_bz(a, b, &q, &r, err);
+    } else {
+        ok = bu_div_knuth(a, b, &q, &r, err);
+    }
+    if (!ok) {
+        return NULL;
+    }
+    if (out_rem != NULL) {
+        *out_rem = r;
+    } else {
+        bu_free(r);
+    }
+    return q;
+}
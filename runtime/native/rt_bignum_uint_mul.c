@@ -0,0 +1,525 @@
+#include "rt_bignum_internal.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+// BigUint multiplication. Limbs are packed into 64-bit words and multiplied by schoolbook,
+// Karatsuba, or Toom-3 by operand size; unbalanced operands are cut into balanced blocks.
+// Defaults come from scripts/bench_native_bignum.sh on x86-64 and can be overridden per run.
+#define BN_KARATSUBA_DEFAULT 32u
+#define BN_TOOM3_DEFAULT 200u
+#define BN_BZ_DEFAULT 64u
+
+// Below this many limb products the 32-bit loop beats packing the operands.
+#define BN_SMALL_MUL_LIMBS 64u
+// Packed operands up to this many words live on the stack.
+#define BN_STACK_WORDS 192u
+
+static _Atomic uint32_t threshold_karatsuba;
+static _Atomic uint32_t threshold_toom3;
+static _Atomic uint32_t threshold_bz;
+
+static uint32_t threshold_load(_Atomic uint32_t* slot,
+                               const char* name,
+                               uint32_t fallback,
+                               uint32_t floor) {
+    uint32_t value = atomic_load_explicit(slot, memory_order_relaxed);
+    if (value != 0) {
+        return value;
+    }
+    value = fallback;
+    const char* env = getenv(name);
+    if (env != NULL && env[0] != 0) {
+        char* end = NULL;
+        unsigned long parsed = strtoul(env, &end, 10);
+        if (end != NULL && *end == 0 && parsed >= floor && parsed <= SURGE_BIGNUM_MAX_LIMBS) {
+            value = (uint32_t)parsed;
+        }
+    }
+    // Racing first calls parse the same environment, so the last store wins harmlessly.
+    atomic_store_explicit(slot, value, memory_order_relaxed);
+    return value;
+}
+
+uint32_t bn_threshold_karatsuba(void) {
+    return threshold_load(
+        &threshold_karatsuba, "SURGE_BIGNUM_KARATSUBA", BN_KARATSUBA_DEFAULT, 2u);
+}
+
+uint32_t bn_threshold_toom3(void) {
+    return threshold_load(&threshold_toom3, "SURGE_BIGNUM_TOOM3", BN_TOOM3_DEFAULT, 5u);
+}
+
+uint32_t bn_threshold_bz(void) {
+    return threshold_load(&threshold_bz, "SURGE_BIGNUM_BZ", BN_BZ_DEFAULT, 2u);
+}
+
+void bn_words_from_limbs(bn_word* out, const uint32_t* limbs, uint32_t len) {
+    uint32_t words = bn_words_for_limbs(len);
+    for (uint32_t i = 0; i < words; i++) {
+        uint64_t lo = limbs[2 * i];
+        uint64_t hi = 2 * i + 1 < len ? (uint64_t)limbs[2 * i + 1] : 0;
+        out[i] = lo | (hi << 32);
+    }
+}
+
+void bn_words_to_limbs(uint32_t* out, uint32_t out_len, const bn_word* words, uint32_t len) {
+    for (uint32_t i = 0; i < out_len; i++) {
+        uint32_t w = i / 2;
+        out[i] = w < len ? (uint32_t)(words[w] >> (32 * (i % 2))) : 0;
+    }
+}
+
+bn_word bn_words_add(
+    bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen) {
+    bn_word carry = 0;
+    uint32_t i = 0;
+    for (; i < blen; i++) {
+        bn_word s = a[i] + carry;
+        carry = s < carry;
+        bn_word t = s + b[i];
+        carry += t < s;
+        out[i] = t;
+    }
+    for (; i < alen; i++) {
+        bn_word s = a[i] + carry;
+        carry = s < carry;
+        out[i] = s;
+    }
+    return carry;
+}
+
+bn_word bn_words_sub(
+    bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen) {
+    bn_word borrow = 0;
+    uint32_t i = 0;
+    for (; i < blen; i++) {
+        bn_word ai = a[i];
+        bn_word d = ai - b[i];
+        bn_word next = ai < b[i];
+        next += d < borrow;
+        out[i] = d - borrow;
+        borrow = next;
+    }
+    for (; i < alen; i++) {
+        bn_word ai = a[i];
+        out[i] = ai - borrow;
+        borrow = ai < borrow;
+    }
+    return borrow;
+}
+
+int bn_words_cmp(const bn_word* a, const bn_word* b, uint32_t len) {
+    for (uint32_t i = len; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static bn_word words_mul_1(bn_word* out, const bn_word* a, uint32_t len, bn_word m) {
+    bn_word carry = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word hi = 0;
+        bn_word lo = bn_word_mul(a[i], m, &hi);
+        lo += carry;
+        hi += lo < carry;
+        out[i] = lo;
+        carry = hi;
+    }
+    return carry;
+}
+
+static bn_word words_addmul_1(bn_word* out, const bn_word* a, uint32_t len, bn_word m) {
+    bn_word carry = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word hi = 0;
+        bn_word lo = bn_word_mul(a[i], m, &hi);
+        lo += carry;
+        hi += lo < carry;
+        bn_word t = out[i] + lo;
+        hi += t < lo;
+        out[i] = t;
+        carry = hi;
+    }
+    return carry;
+}
+
+bn_word bn_words_submul_1(bn_word* out, const bn_word* a, uint32_t len, bn_word m) {
+    bn_word borrow = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word hi = 0;
+        bn_word lo = bn_word_mul(a[i], m, &hi);
+        lo += borrow;
+        hi += lo < borrow;
+        bn_word t = out[i];
+        out[i] = t - lo;
+        hi += t < lo;
+        borrow = hi;
+    }
+    return borrow;
+}
+
+static void words_mul_basecase(
+    bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen) {
+    out[alen] = words_mul_1(out, a, alen, b[0]);
+    for (uint32_t j = 1; j < blen; j++) {
+        out[alen + j] = words_addmul_1(out + j, a, alen, b[j]);
+    }
+}
+
+static uint32_t words_trim(const bn_word* w, uint32_t len) {
+    while (len > 0 && w[len - 1] == 0) {
+        len--;
+    }
+    return len;
+}
+
+// out[0..len) += x, where x is trimmed first; the sum of a product's parts never carries out.
+static void words_add_into(bn_word* out, uint32_t len, const bn_word* x, uint32_t xlen) {
+    xlen = words_trim(x, xlen);
+    if (xlen > len) {
+        xlen = len;
+    }
+    (void)bn_words_add(out, out, len, x, xlen);
+}
+
+// out = |x - y| over xn words, with y zero-extended from yn <= xn; true when x < y.
+static bool words_absdiff(
+    bn_word* out, const bn_word* x, uint32_t xn, const bn_word* y, uint32_t yn) {
+    bool x_less = words_trim(x + yn, xn - yn) == 0 && bn_words_cmp(x, y, yn) < 0;
+    if (!x_less) {
+        (void)bn_words_sub(out, x, xn, y, yn);
+        return false;
+    }
+    (void)bn_words_sub(out, y, yn, x, yn);
+    memset(out + yn, 0, (size_t)(xn - yn) * sizeof(bn_word));
+    return true;
+}
+
+static bool words_mul_n(bn_word* out, const bn_word* a, const bn_word* b, uint32_t n, bn_word* scr);
+
+// Scratch words a Karatsuba product of n words needs below it; Toom-3 brings its own.
+static size_t words_scratch(uint32_t n) {
+    size_t total = 0;
+    while (n >= bn_threshold_karatsuba() && n < bn_threshold_toom3()) {
+        uint32_t k = (n + 1) / 2;
+        total += 6 * (size_t)k + 1;
+        n = k;
+    }
+    return total;
+}
+
+// Subtractive Karatsuba: z1 = z0 + z2 -/+ |a0 - a1| * |b0 - b1| never needs a signed carry.
+static bool words_kara(bn_word* out, const bn_word* a, const bn_word* b, uint32_t n, bn_word* scr) {
+    uint32_t k = (n + 1) / 2;
+    uint32_t h = n - k;
+    bn_word* da = scr;
+    bn_word* db = da + k;
+    bn_word* zm = db + k;
+    bn_word* t = zm + 2 * k;
+    bn_word* next = t + 2 * k + 1;
+    bool neg = words_absdiff(da, a, k, a + k, h) != words_absdiff(db, b, k, b + k, h);
+    if (!words_mul_n(out, a, b, k, next) || !words_mul_n(out + 2 * k, a + k, b + k, h, next) ||
+        !words_mul_n(zm, da, db, k, next)) {
+        return false;
+    }
+    memcpy(t, out, (size_t)(2 * k) * sizeof(bn_word));
+    t[2 * k] = 0;
+    (void)bn_words_add(t, t, 2 * k + 1, out + 2 * k, 2 * h);
+    if (neg) {
+        (void)bn_words_add(t, t, 2 * k + 1, zm, 2 * k);
+    } else {
+        (void)bn_words_sub(t, t, 2 * k + 1, zm, 2 * k);
+    }
+    words_add_into(out + k, 2 * n - k, t, 2 * k + 1);
+    return true;
+}
+
+// Signed values in the Toom-3 evaluation and interpolation are a magnitude and a sign flag.
+static bool signed_add(
+    bn_word* out, const bn_word* x, bool xneg, const bn_word* y, bool yneg, uint32_t width) {
+    if (xneg == yneg) {
+        (void)bn_words_add(out, x, width, y, width);
+        return xneg && words_trim(out, width) != 0;
+    }
+    if (bn_words_cmp(x, y, width) >= 0) {
+        (void)bn_words_sub(out, x, width, y, width);
+        return xneg && words_trim(out, width) != 0;
+    }
+    (void)bn_words_sub(out, y, width, x, width);
+    return yneg;
+}
+
+static void words_shl1(bn_word* x, uint32_t len) {
+    bn_word carry = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word v = x[i];
+        x[i] = (v << 1) | carry;
+        carry = v >> (SURGE_BIGNUM_WORD_BITS - 1);
+    }
+}
+
+static void words_shr1(bn_word* x, uint32_t len) {
+    bn_word carry = 0;
+    for (uint32_t i = len; i-- > 0;) {
+        bn_word v = x[i];
+        x[i] = (v >> 1) | (carry << (SURGE_BIGNUM_WORD_BITS - 1));
+        carry = v & 1u;
+    }
+}
+
+// Exact division by 3 via the inverse of 3 modulo 2^64; the input must be a multiple of 3.
+static void words_divexact_3(bn_word* x, uint32_t len) {
+    const bn_word inv3 = UINT64_C(0xAAAAAAAAAAAAAAAB);
+    bn_word borrow = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        bn_word s = x[i];
+        bn_word l = s - borrow;
+        borrow = l > s;
+        bn_word q = l * inv3;
+        x[i] = q;
+        borrow += (bn_word)(q > UINT64_C(0x5555555555555555));
+        borrow += (bn_word)(q > UINT64_C(0xAAAAAAAAAAAAAAAA));
+    }
+}
+
+// Evaluates a0 + a1 x + a2 x^2 at 1, -1 and -2 into e-word values; pad holds 3 * e words.
+static void toom3_eval(const bn_word* a,
+                       uint32_t k,
+                       uint32_t h,
+                       bn_word* p1,
+                       bn_word* pm1,
+                       bool* nm1,
+                       bn_word* pm2,
+                       bool* nm2,
+                       bn_word* pad) {
+    uint32_t e = k + 1;
+    bn_word* a0 = pad;
+    bn_word* a1 = a0 + e;
+    bn_word* a2 = a1 + e;
+    memset(pad, 0, (size_t)(3 * e) * sizeof(bn_word));
+    memcpy(a0, a, (size_t)k * sizeof(bn_word));
+    memcpy(a1, a + k, (size_t)k * sizeof(bn_word));
+    memcpy(a2, a + 2 * k, (size_t)h * sizeof(bn_word));
+    (void)bn_words_add(p1, a0, e, a2, e);
+    *nm1 = signed_add(pm1, p1, false, a1, true, e);
+    (void)bn_words_add(p1, p1, e, a1, e);
+    bool neg = signed_add(pm2, pm1, *nm1, a2, false, e);
+    words_shl1(pm2, e);
+    *nm2 = signed_add(pm2, pm2, neg, a0, true, e);
+}
+
+// Toom-3 over the points 0, 1, -1, -2 and infinity with Bodrato's interpolation sequence.
+static bool words_toom3(bn_word* out, const bn_word* a, const bn_word* b, uint32_t n) {
+    uint32_t k = (n + 2) / 3;
+    uint32_t h = n - 2 * k;
+    uint32_t e = k + 1;
+    uint32_t m = 2 * e + 1;
+    // Scratch does not grow monotonically across the Toom-3 threshold, so size it for all parts.
+    size_t scratch = words_scratch(e);
+    if (words_scratch(k) > scratch) {
+        scratch = words_scratch(k);
+    }
+    if (words_scratch(h) > scratch) {
+        scratch = words_scratch(h);
+    }
+    size_t words = 9 * (size_t)e + 5 * (size_t)m + scratch;
+    bn_word* buf = (bn_word*)malloc(words * sizeof(bn_word));
+    if (buf == NULL) {
+        return false;
+    }
+    bn_word* pa1 = buf;
+    bn_word* pam1 = pa1 + e;
+    bn_word* pam2 = pam1 + e;
+    bn_word* pb1 = pam2 + e;
+    bn_word* pbm1 = pb1 + e;
+    bn_word* pbm2 = pbm1 + e;
+    bn_word* pad = pbm2 + e;
+    bn_word* w0 = pad + 3 * e;
+    bn_word* w1 = w0 + m;
+    bn_word* wm1 = w1 + m;
+    bn_word* wm2 = wm1 + m;
+    bn_word* winf = wm2 + m;
+    bn_word* scr = winf + m;
+    bool nam1 = false;
+    bool nam2 = false;
+    bool nbm1 = false;
+    bool nbm2 = false;
+    toom3_eval(a, k, h, pa1, pam1, &nam1, pam2, &nam2, pad);
+    toom3_eval(b, k, h, pb1, pbm1, &nbm1, pbm2, &nbm2, pad);
+
+    memset(w0, 0, (size_t)(5 * m) * sizeof(bn_word));
+    bool ok = words_mul_n(out, a, b, k, scr) &&
+              words_mul_n(out + 4 * k, a + 2 * k, b + 2 * k, h, scr) &&
+              words_mul_n(w1, pa1, pb1, e, scr) && words_mul_n(wm1, pam1, pbm1, e, scr) &&
+              words_mul_n(wm2, pam2, pbm2, e, scr);
+    if (!ok) {
+        free(buf);
+        return false;
+    }
+    memset(out + 2 * k, 0, (size_t)(2 * k) * sizeof(bn_word));
+    memcpy(w0, out, (size_t)(2 * k) * sizeof(bn_word));
+    memcpy(winf, out + 4 * k, (size_t)(2 * h) * sizeof(bn_word));
+    bool s1 = false;
+    bool sm1 = nam1 != nbm1;
+    bool sm2 = nam2 != nbm2;
+
+    // r3 = (r(-2) - r(1)) / 3, r1 = (r(1) - r(-1)) / 2, r2 = r(-1) - r(0)
+    bool s3 = signed_add(wm2, wm2, sm2, w1, true, m);
+    words_divexact_3(wm2, m);
+    s1 = signed_add(w1, w1, s1, wm1, !sm1, m);
+    words_shr1(w1, m);
+    bool s2 = signed_add(wm1, wm1, sm1, w0, true, m);
+    // r3 = (r2 - r3) / 2 + 2 r(inf), r2 = r2 + r1 - r(inf), r1 = r1 - r3
+    s3 = signed_add(wm2, wm1, s2, wm2, !s3, m);
+    words_shr1(wm2, m);
+    s3 = signed_add(wm2, wm2, s3, winf, false, m);
+    s3 = signed_add(wm2, wm2, s3, winf, false, m);
+    s2 = signed_add(wm1, wm1, s2, w1, s1, m);
+    s2 = signed_add(wm1, wm1, s2, winf, true, m);
+    s1 = signed_add(w1, w1, s1, wm2, !s3, m);
+    (void)s1;
+    (void)s2;
+
+    words_add_into(out + k, 2 * n - k, w1, m);
+    words_add_into(out + 2 * k, 2 * n - 2 * k, wm1, m);
+    words_add_into(out + 3 * k, 2 * n - 3 * k, wm2, m);
+    free(buf);
+    return true;
+}
+
+static bool
+words_mul_n(bn_word* out, const bn_word* a, const bn_word* b, uint32_t n, bn_word* scr) {
+    if (n < bn_threshold_karatsuba()) {
+        words_mul_basecase(out, a, n, b, n);
+        return true;
+    }
+    if (n >= bn_threshold_toom3()) {
+        return words_toom3(out, a, b, n);
+    }
+    return words_kara(out, a, b, n, scr);
+}
+
+bool bn_words_mul(bn_word* out, const bn_word* a, uint32_t alen, const bn_word* b, uint32_t blen) {
+    if (blen < bn_threshold_karatsuba() || blen < 2) {
+        words_mul_basecase(out, a, alen, b, blen);
+        return true;
+    }
+    size_t scratch = words_scratch(blen);
+    size_t words = scratch + (alen == blen ? 0 : 2 * (size_t)blen);
+    bn_word* buf = words == 0 ? NULL : (bn_word*)malloc(words * sizeof(bn_word));
+    if (words != 0 && buf == NULL) {
+        return false;
+    }
+    bool ok = true;
+    if (alen == blen) {
+        ok = words_mul_n(out, a, b, blen, buf);
+    } else {
+        // Multiply b by blen-word blocks of a; each partial product lands at the block offset.
+        bn_word* part = buf + scratch;
+        memset(out, 0, (size_t)(alen + blen) * sizeof(bn_word));
+        for (uint32_t off = 0; ok && off < alen; off += blen) {
+            uint32_t len = alen - off < blen ? alen - off : blen;
+            if (len == blen) {
+                ok = words_mul_n(part, a + off, b, blen, buf);
+            } else {
+                ok = bn_words_mul(part, b, blen, a + off, len);
+            }
+            if (ok) {
+                words_add_into(out + off, alen + blen - off, part, blen + len);
+            }
+        }
+    }
+    free(buf);
+    return ok;
+}
+
+// out receives alen + blen limbs of a * b; both operands are trimmed and non-empty.
+static bool bu_mul_limbs(
+    uint32_t* out, const uint32_t* a, uint32_t alen, const uint32_t* b, uint32_t blen) {
+    if ((uint64_t)alen * (uint64_t)blen <= BN_SMALL_MUL_LIMBS) {
+        memset(out, 0, (size_t)(alen + blen) * sizeof(uint32_t));
+        for (uint32_t i = 0; i < alen; i++) {
+            uint64_t ai = a[i];
+            uint64_t carry = 0;
+            for (uint32_t j = 0; j < blen; j++) {
+                uint64_t sum = (uint64_t)out[i + j] + ai * (uint64_t)b[j] + carry;
+                out[i + j] = (uint32_t)sum;
+                carry = sum >> 32;
+            }
+            out[i + blen] = (uint32_t)carry;
+        }
+        return true;
+    }
+    if (alen < blen) {
+        const uint32_t* tmp = a;
+        a = b;
+        b = tmp;
+        uint32_t tmp_len = alen;
+        alen = blen;
+        blen = tmp_len;
+    }
+    uint32_t aw = bn_words_for_limbs(alen);
+    uint32_t bw = bn_words_for_limbs(blen);
+    size_t words = 2 * ((size_t)aw + (size_t)bw);
+    bn_word stack[BN_STACK_WORDS];
+    bn_word* buf = stack;
+    if (words > BN_STACK_WORDS) {
+        buf = (bn_word*)malloc(words * sizeof(bn_word));
+        if (buf == NULL) {
+            return false;
+        }
+    }
+    bn_word* wa = buf;
+    bn_word* wb = wa + aw;
+    bn_word* wout = wb + bw;
+    bn_words_from_limbs(wa, a, alen);
+    bn_words_from_limbs(wb, b, blen);
+    bool ok = bn_words_mul(wout, wa, aw, wb, bw);
+    if (ok) {
+        bn_words_to_limbs(out, alen + blen, wout, aw + bw);
+    }
+    if (buf != stack) {
+        free(buf);
+    }
+    return ok;
+}
+
+SurgeBigUint* bu_mul(const SurgeBigUint* a, const SurgeBigUint* b, bn_err* err) {
+    if (err != NULL) {
+        *err = BN_OK;
+    }
+    if (a == NULL || b == NULL) {
+        return NULL;
+    }
+    uint32_t alen = trim_len(a->limbs, a->len);
+    uint32_t blen = trim_len(b->limbs, b->len);
+    if (alen == 0 || blen == 0) {
+        return NULL;
+    }
+    if ((uint64_t)alen + (uint64_t)blen > SURGE_BIGNUM_MAX_LIMBS) {
+        if (err != NULL) {
+            *err = BN_ERR_MAX_LIMBS;
+        }
+        return NULL;
+    }
+    SurgeBigUint* out = bu_alloc(alen + blen, err);
+    if (out == NULL) {
+        return NULL;
+    }
+    if (!bu_mul_limbs(out->limbs, a->limbs, alen, b->limbs, blen)) {
+        if (err != NULL) {
+            *err = BN_ERR_MAX_LIMBS;
+        }
+        bu_free(out);
+        return NULL;
+    }
+    out->len = trim_len(out->limbs, out->len);
+    if (out->len == 0) {
+        return NULL;
+    }
+    return out;
+}
@@ -0,0 +1,494 @@
+#include "rt.h"
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Byte scanning for stdlib/bytes and stdlib/json.
+//
+// Every scan classifies its range in 64-byte blocks. A kernel compares one block against a
+// scan_class (up to 16 needle bytes, plus every byte below a bound for JSON control
+// characters) and returns one bit per byte; callers turn the mask into a position with a
+// trailing-zero count or into a count with a population count. Full blocks are read in
+// place. The trailing partial block is copied into a zero-padded buffer and the padding bits
+// are masked off, so no kernel reads past the end of the range. Ranges shorter than
+// SCAN_SHORT_LEN are scanned byte by byte, since a padded block costs more than it saves.
+//
+// rt_json_structural_index follows simdjson's stage 1: escaped characters are found with
+// the branchless odd-backslash-run trick, unescaped quotes are turned into an in-string mask
+// with a prefix xor, and both carry into the next block through one word each.
+//
+// x86-64 picks AVX2 at run time and otherwise uses SSE2, which every x86-64 CPU has;
+// aarch64 always has NEON; every other target uses the scalar kernel. Single-byte search
+// goes to the C library's memchr, which is already vectorized on the platforms we ship.
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define SCAN_BLOCK 64
+#define SCAN_SHORT_LEN 16
+#define SCAN_MAX_NEEDLES 16
+
+typedef struct SurgeArrayHeader {
+    uint64_t len;
+    uint64_t cap;
+    void* data;
+} SurgeArrayHeader;
+
+// A byte matches the class when it equals one of needles[0..count) or, with below nonzero,
+// when it is less than below.
+typedef struct ScanClass {
+    uint8_t needles[SCAN_MAX_NEEDLES];
+    uint32_t count;
+    uint8_t below;
+} ScanClass;
+
+typedef uint64_t (*ScanKernel)(const uint8_t* block, const ScanClass* cls);
+
+static void scan_panic(const char* msg) {
+    rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
+}
+
+static const uint8_t* scan_range(const void* array, uint64_t start, uint64_t end) {
+    if (array == NULL) {
+        return NULL;
+    }
+    const SurgeArrayHeader* header = (const SurgeArrayHeader*)array;
+    if (start >= end || end > header->len || header->data == NULL) {
+        return NULL;
+    }
+    return (const uint8_t*)header->data;
+}
+
+static bool scan_class_has(const ScanClass* cls, uint8_t b) {
+    if (b < cls->below) {
+        return true;
+    }
+    for (uint32_t k = 0; k < cls->count; k++) {
+        if (cls->needles[k] == b) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t scan_valid_mask(uint64_t len) {
+    return len >= SCAN_BLOCK ? UINT64_MAX : (UINT64_C(1) << len) - 1;
+}
+
+static uint64_t scan_ctz(uint64_t mask) {
+    return (uint64_t)__builtin_ctzll(mask);
+}
+
+#if !defined(SCAN_X86) && !defined(SCAN_NEON)
+static uint64_t scan_scalar_block(const uint8_t* block, const ScanClass* cls) {
+    uint64_t mask = 0;
+    for (uint64_t i = 0; i < SCAN_BLOCK; i++) {
+        if (scan_class_has(cls, block[i])) {
+            mask |= UINT64_C(1) << i;
+        }
+    }
+    return mask;
+}
+#endif
+
+#if defined(SCAN_X86)
+static uint64_t scan_sse2_movemask(__m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+    uint64_t r0 = (uint32_t)_mm_movemask_epi8(m0);
+    uint64_t r1 = (uint32_t)_mm_movemask_epi8(m1);
+    uint64_t r2 = (uint32_t)_mm_movemask_epi8(m2);
+    uint64_t r3 = (uint32_t)_mm_movemask_epi8(m3);
+    return r0 | (r1 << 16) | (r2 << 32) | (r3 << 48);
+}
+
+static uint64_t scan_sse2_block(const uint8_t* block, const ScanClass* cls) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(const void*)block);
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(const void*)(block + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(const void*)(block + 32));
+    __m128i v3 = _mm_loadu_si128((const __m128i*)(const void*)(block + 48));
+    __m128i m0 = _mm_setzero_si128();
+    __m128i m1 = _mm_setzero_si128();
+    __m128i m2 = _mm_setzero_si128();
+    __m128i m3 = _mm_setzero_si128();
+    for (uint32_t k = 0; k < cls->count; k++) {
+        __m128i n = _mm_set1_epi8((char)cls->needles[k]);
+        m0 = _mm_or_si128(m0, _mm_cmpeq_epi8(v0, n));
+        m1 = _mm_or_si128(m1, _mm_cmpeq_epi8(v1, n));
+        m2 = _mm_or_si128(m2, _mm_cmpeq_epi8(v2, n));
+        m3 = _mm_or_si128(m3, _mm_cmpeq_epi8(v3, n));
+    }
+    if (cls->below != 0) {
+        // SSE2 has no unsigned compare; b <= limit exactly when min(b, limit) == b.
+        __m128i limit = _mm_set1_epi8((char)(cls->below - 1));
+        m0 = _mm_or_si128(m0, _mm_cmpeq_epi8(_mm_min_epu8(v0, limit), v0));
+        m1 = _mm_or_si128(m1, _mm_cmpeq_epi8(_mm_min_epu8(v1, limit), v1));
+        m2 = _mm_or_si128(m2, _mm_cmpeq_epi8(_mm_min_epu8(v2, limit), v2));
+        m3 = _mm_or_si128(m3, _mm_cmpeq_epi8(_mm_min_epu8(v3, limit), v3));
+    }
+    return scan_sse2_movemask(m0, m1, m2, m3);
+}
+
+__attribute__((target("avx2"))) static uint64_t scan_avx2_block(const uint8_t* block,
+                                                                const ScanClass* cls) {
+    __m256i lo = _mm256_loadu_si256((const __m256i*)(const void*)block);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)(const void*)(block + 32));
+    __m256i mlo = _mm256_setzero_si256();
+    __m256i mhi = _mm256_setzero_si256();
+    for (uint32_t k = 0; k < cls->count; k++) {
+        __m256i n = _mm256_set1_epi8((char)cls->needles[k]);
+        mlo = _mm256_or_si256(mlo, _mm256_cmpeq_epi8(lo, n));
+        mhi = _mm256_or_si256(mhi, _mm256_cmpeq_epi8(hi, n));
+    }
+    if (cls->below != 0) {
+        __m256i limit = _mm256_set1_epi8((char)(cls->below - 1));
+        mlo = _mm256_or_si256(mlo, _mm256_cmpeq_epi8(_mm256_min_epu8(lo, limit), lo));
+        mhi = _mm256_or_si256(mhi, _mm256_cmpeq_epi8(_mm256_min_epu8(hi, limit), hi));
+    }
+    uint64_t rlo = (uint32_t)_mm256_movemask_epi8(mlo);
+    uint64_t rhi = (uint32_t)_mm256_movemask_epi8(mhi);
+    return rlo | (rhi << 32);
+}
+#endif
+
+#if defined(SCAN_NEON)
+static const uint8_t scan_neon_bits[16] = {
+    1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+};
+
+// NEON has no movemask: keep one distinct bit per lane, then three pairwise adds fold the
+// 64 lanes into 64 bits.
+static uint64_t scan_neon_movemask(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) {
+    uint8x16_t bits = vld1q_u8(scan_neon_bits);
+    uint8x16_t s0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+    uint8x16_t s1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+    s0 = vpaddq_u8(s0, s1);
+    s0 = vpaddq_u8(s0, s0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(s0), 0);
+}
+
+static uint64_t scan_neon_block(const uint8_t* block, const ScanClass* cls) {
+    uint8x16_t v0 = vld1q_u8(block);
+    uint8x16_t v1 = vld1q_u8(block + 16);
+    uint8x16_t v2 = vld1q_u8(block + 32);
+    uint8x16_t v3 = vld1q_u8(block + 48);
+    uint8x16_t m0 = vdupq_n_u8(0);
+    uint8x16_t m1 = vdupq_n_u8(0);
+    uint8x16_t m2 = vdupq_n_u8(0);
+    uint8x16_t m3 = vdupq_n_u8(0);
+    for (uint32_t k = 0; k < cls->count; k++) {
+        uint8x16_t n = vdupq_n_u8(cls->needles[k]);
+        m0 = vorrq_u8(m0, vceqq_u8(v0, n));
+        m1 = vorrq_u8(m1, vceqq_u8(v1, n));
+        m2 = vorrq_u8(m2, vceqq_u8(v2, n));
+        m3 = vorrq_u8(m3, vceqq_u8(v3, n));
+    }
+    if (cls->below != 0) {
+        uint8x16_t limit = vdupq_n_u8(cls->below);
+        m0 = vorrq_u8(m0, vcltq_u8(v0, limit));
+        m1 = vorrq_u8(m1, vcltq_u8(v1, limit));
+        m2 = vorrq_u8(m2, vcltq_u8(v2, limit));
+        m3 = vorrq_u8(m3, vcltq_u8(v3, limit));
+    }
+    return scan_neon_movemask(m0, m1, m2, m3);
+}
+#endif
+
+static ScanKernel scan_kernel(void) {
+#if defined(SCAN_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return scan_avx2_block;
+    }
+    return scan_sse2_block;
+#elif defined(SCAN_NEON)
+    return scan_neon_block;
+#else
+    return scan_scalar_block;
+#endif
+}
+
+// scan_block classifies data[i..i+64), padding past end with zero bytes whose bits are
+// cleared, so every kernel may read a full block.
+static uint64_t
+scan_block(ScanKernel kernel, const uint8_t* data, uint64_t i, uint64_t end, const ScanClass* cls) {
+    uint64_t rest = end - i;
+    if (rest >= SCAN_BLOCK) {
+        return kernel(data + i, cls);
+    }
+    uint8_t tail[SCAN_BLOCK] = {0};
+    memcpy(tail, data + i, (size_t)rest);
+    return kernel(tail, cls) & scan_valid_mask(rest);
+}
+
+// scan_find returns the first position in [start, end) whose byte is (or, with negate, is
+// not) in the class, or end.
+static uint64_t
+scan_find(const uint8_t* data, uint64_t start, uint64_t end, const ScanClass* cls, bool negate) {
+    uint64_t i = start;
+    if (end - start < SCAN_SHORT_LEN) {
+        for (; i < end; i++) {
+            if (scan_class_has(cls, data[i]) != negate) {
+                return i;
+            }
+        }
+        return end;
+    }
+    ScanKernel kernel = scan_kernel();
+    for (; i < end; i += SCAN_BLOCK) {
+        uint64_t mask = scan_block(kernel, data, i, end, cls);
+        if (negate) {
+            mask = ~mask & scan_valid_mask(end - i);
+        }
+        if (mask != 0) {
+            return i + scan_ctz(mask);
+        }
+    }
+    return end;
+}
+
+static uint64_t
+scan_count(const uint8_t* data, uint64_t start, uint64_t end, const ScanClass* cls) {
+    uint64_t count = 0;
+    ScanKernel kernel = scan_kernel();
+    for (uint64_t i = start; i < end; i += SCAN_BLOCK) {
+        count += (uint64_t)__builtin_popcountll(scan_block(kernel, data, i, end, cls));
+    }
+    return count;
+}
+
+static const ScanClass scan_ascii_ws = {.needles = {' ', '\t', '\n', '\r'}, .count = 4};
+
+static bool scan_is_ascii_ws(uint8_t b) {
+    return b == ' ' || b == '\t' || b == '\n' || b == '\r';
+}
+
+uint64_t rt_byte_find(const void* array, uint64_t start, uint64_t end, uint8_t needle) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    const void* hit = memchr(data + start, needle, (size_t)(end - start));
+    if (hit == NULL) {
+        return end;
+    }
+    return (uint64_t)((const uint8_t*)hit - data);
+}
+
+uint64_t rt_byte_find2(const void* array, uint64_t start, uint64_t end, uint8_t a, uint8_t b) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    ScanClass cls = {.needles = {a, b}, .count = 2};
+    return scan_find(data, start, end, &cls, false);
+}
+
+uint64_t
+rt_byte_find3(const void* array, uint64_t start, uint64_t end, uint8_t a, uint8_t b, uint8_t c) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    ScanClass cls = {.needles = {a, b, c}, .count = 3};
+    return scan_find(data, start, end, &cls, false);
+}
+
+// Sets of up to 16 distinct bytes go through the vector kernels; larger sets are looked up
+// in a 256-bit table one byte at a time.
+uint64_t rt_byte_find_set(const void* array, uint64_t start, uint64_t end, const void* set) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL || set == NULL) {
+        return end;
+    }
+    const SurgeArrayHeader* set_header = (const SurgeArrayHeader*)set;
+    if (set_header->len == 0 || set_header->data == NULL) {
+        return end;
+    }
+    const uint8_t* set_bytes = (const uint8_t*)set_header->data;
+    uint64_t table[4] = {0};
+    ScanClass cls = {.count = 0};
+    for (uint64_t k = 0; k < set_header->len; k++) {
+        uint8_t b = set_bytes[k];
+        uint64_t bit = UINT64_C(1) << (b & 63);
+        if ((table[b >> 6] & bit) != 0) {
+            continue;
+        }
+        table[b >> 6] |= bit;
+        if (cls.count < SCAN_MAX_NEEDLES) {
+            cls.needles[cls.count] = b;
+        }
+        cls.count++;
+    }
+    if (cls.count <= SCAN_MAX_NEEDLES) {
+        return scan_find(data, start, end, &cls, false);
+    }
+    for (uint64_t i = start; i < end; i++) {
+        uint8_t b = data[i];
+        if ((table[b >> 6] & (UINT64_C(1) << (b & 63))) != 0) {
+            return i;
+        }
+    }
+    return end;
+}
+
+uint64_t rt_byte_count(const void* array, uint64_t start, uint64_t end, uint8_t needle) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return 0;
+    }
+    ScanClass cls = {.needles = {needle}, .count = 1};
+    return scan_count(data, start, end, &cls);
+}
+
+// Whitespace runs between tokens are usually zero or one byte long, so the first byte is
+// checked before a block is set up.
+uint64_t rt_byte_skip_ascii_ws(const void* array, uint64_t start, uint64_t end) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    if (!scan_is_ascii_ws(data[start])) {
+        return start;
+    }
+    return scan_find(data, start + 1, end, &scan_ascii_ws, true);
+}
+
+uint64_t rt_byte_find_ascii_ws(const void* array, uint64_t start, uint64_t end) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    return scan_find(data, start, end, &scan_ascii_ws, false);
+}
+
+// Stops at the first byte a JSON string body cannot copy verbatim: the closing quote, a
+// backslash, or an unescaped control character.
+uint64_t rt_json_scan_string(const void* array, uint64_t start, uint64_t end) {
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+    static const ScanClass cls = {.needles = {'"', '\\'}, .count = 2, .below = 0x20};
+    return scan_find(data, start, end, &cls, false);
+}
+
+// Returns the bits of escaped characters: those preceded by an odd-length backslash run.
+// Runs starting on an odd bit are made to carry across the even bits with one addition, so
+// the parity of every run comes out of a single xor. prev_escaped carries a trailing odd run
+// into the next block.
+static uint64_t json_find_escaped(uint64_t backslash, uint64_t* prev_escaped) {
+    const uint64_t even_bits = UINT64_C(0x5555555555555555);
+    backslash &= ~*prev_escaped;
+    uint64_t follows_escape = (backslash << 1) | *prev_escaped;
+    uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t even_carried = 0;
+    *prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_carried) ? 1 : 0;
+    uint64_t invert = even_carried << 1;
+    return (even_bits ^ invert) & follows_escape;
+}
+
+// Bit i of the result is the xor of bits 0..i: set from an opening quote up to, but not
+// including, its closing quote.
+static uint64_t json_prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Makes room for extra more uint64 elements; index arrays are never views.
+static uint64_t* json_index_reserve(SurgeArrayHeader* out, uint64_t extra) {
+    if (out->cap == UINT64_MAX) {
+        scan_panic("array view is not resizable");
+        return NULL;
+    }
+    if (extra > out->cap - out->len) {
+        uint64_t want = out->len + extra;
+        uint64_t new_cap = out->cap < 8 ? 8 : out->cap;
+        while (new_cap < want) {
+            new_cap *= 2;
+        }
+        if (new_cap > UINT64_MAX / sizeof(uint64_t)) {
+            scan_panic("array capacity out of range");
+            return NULL;
+        }
+        void* data = rt_realloc((uint8_t*)out->data,
+                                out->cap * sizeof(uint64_t),
+                                new_cap * sizeof(uint64_t),
+                                (uint64_t)alignof(uint64_t));
+        if (data == NULL) {
+            scan_panic("array allocation failed");
+            return NULL;
+        }
+        out->data = data;
+        out->cap = new_cap;
+        rt_array_sync_views(out);
+    }
+    return (uint64_t*)out->data + out->len;
+}
+
+// Appends, in order, the offset of every unescaped quote and of every {}[]:, outside a
+// string. Returns end when every string is closed, otherwise the offset of the opening
+// quote of the unterminated one. Scalars, escapes, and control characters are left to the
+// parser, which walks the index.
+uint64_t
+rt_json_structural_index(const void* array, uint64_t start, uint64_t end, void* out_slot) {
+    if (out_slot == NULL || *(SurgeArrayHeader**)out_slot == NULL) {
+        scan_panic("json structural index received null array");
+        return end;
+    }
+    SurgeArrayHeader* out = *(SurgeArrayHeader**)out_slot;
+    const uint8_t* data = scan_range(array, start, end);
+    if (data == NULL) {
+        return end;
+    }
+
+    static const ScanClass quote_cls = {.needles = {'"'}, .count = 1};
+    static const ScanClass backslash_cls = {.needles = {'\\'}, .count = 1};
+    static const ScanClass op_cls = {.needles = {'{', '}', '[', ']', ':', ','}, .count = 6};
+    ScanKernel kernel = scan_kernel();
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t last_open = end;
+    for (uint64_t i = start; i < end; i += SCAN_BLOCK) {
+        const uint8_t* block = data + i;
+        uint8_t tail[SCAN_BLOCK] = {0};
+        if (end - i < SCAN_BLOCK) {
+            // Zero padding matches none of the classes, so no valid mask is needed.
+            memcpy(tail, block, (size_t)(end - i));
+            block = tail;
+        }
+        uint64_t backslash = kernel(block, &backslash_cls);
+        uint64_t quote = kernel(block, &quote_cls) & ~json_find_escaped(backslash, &prev_escaped);
+        uint64_t in_string = json_prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+        uint64_t opening = quote & in_string;
+        if (opening != 0) {
+            last_open = i + 63 - (uint64_t)__builtin_clzll(opening);
+        }
+
+        uint64_t hits = quote | (kernel(block, &op_cls) & ~in_string);
+        if (hits == 0) {
+            continue;
+        }
+        uint64_t* dst = json_index_reserve(out, (uint64_t)__builtin_popcountll(hits));
+        if (dst == NULL) {
+            return end;
+        }
+        uint64_t n = 0;
+        while (hits != 0) {
+            dst[n++] = i + scan_ctz(hits);
+            hits &= hits - 1;
+        }
+        out->len += n;
+    }
+    return prev_in_string != 0 ? last_open : end;
+}
@@ -29,5 +29,6 @@ int main(int argc, char** argv) {
     rt_argc = argc;
     rt_argv_raw = argv;
     __surge_start();
+    rt_flush_stdout();
     return 0;
 }
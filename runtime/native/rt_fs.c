@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -79,6 +80,13 @@ typedef struct SurgeArrayHeader {
     void* data;
 } SurgeArrayHeader;
 
+// Same layout as SurgeBytesView in rt_string.c.
+typedef struct FsBytesView {
+    void* owner;
+    const uint8_t* ptr;
+    void* len;
+} FsBytesView;
+
 static const char* fs_error_message(uint64_t code) {
     switch (code) {
         case FS_ERR_NOT_FOUND:
@@ -400,6 +408,70 @@ static int fs_remove_dir_recursive(const char* path) {
     return err;
 }
 
+// Reads fd to EOF into one rt_alloc block. Regular files are sized from st_size, so reading
+// a file costs one allocation and no copies; a file that grows meanwhile, or a procfs or pipe
+// source that reports no size, grows the block by doubling. Returns 0 or an errno value.
+static int fs_read_fd_all(
+    int fd, const struct stat* st, uint8_t** out, uint64_t* out_len, uint64_t* out_cap) {
+    uint64_t cap = 0;
+    if (S_ISREG(st->st_mode) && st->st_size > 0) {
+        cap = (uint64_t)st->st_size;
+    }
+    uint8_t* data = NULL;
+    if (cap > 0) {
+        data = (uint8_t*)rt_alloc(cap, (uint64_t)alignof(uint8_t));
+        if (data == NULL) {
+            return ENOMEM;
+        }
+    }
+    uint64_t len = 0;
+    for (;;) {
+        // Once the expected size is in, a probe read confirms EOF without growing the block.
+        uint8_t probe[4096];
+        uint8_t* dst = probe;
+        size_t want = sizeof(probe);
+        if (len < cap) {
+            dst = data + len;
+            want = (size_t)(cap - len);
+        }
+        ssize_t n = read(fd, dst, want);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int err = errno;
+            if (data != NULL) {
+                rt_free(data, cap, (uint64_t)alignof(uint8_t));
+            }
+            return err;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (dst == probe) {
+            uint64_t next = cap < 4096 ? 4096 : cap * 2;
+            while (next - len < (uint64_t)n) {
+                next *= 2;
+            }
+            uint8_t* grown = (uint8_t*)rt_realloc(data, cap, next, (uint64_t)alignof(uint8_t));
+            if (grown == NULL) {
+                if (data != NULL) {
+                    rt_free(data, cap, (uint64_t)alignof(uint8_t));
+                }
+                return ENOMEM;
+            }
+            data = grown;
+            cap = next;
+            memcpy(data + len, probe, (size_t)n);
+        }
+        len += (uint64_t)n;
+    }
+    *out = data;
+    *out_len = len;
+    *out_cap = cap;
+    return 0;
+}
+
 void* rt_fs_cwd(void) {
     long path_max = pathconf(".", _PC_PATH_MAX);
     if (path_max <= 0) {
@@ -811,67 +883,103 @@ void* rt_fs_read_file(void* path) {
         free(buf);
         return fs_make_error(FS_ERR_IS_DIR);
     }
-    uint8_t* tmp = NULL;
-    size_t cap = 0;
-    size_t len = 0;
-    int err = 0;
-    for (;;) {
-        if (len == cap) {
-            size_t next = cap == 0 ? 4096 : cap * 2;
-            if (next < cap) {
-                err = ENOMEM;
-                break;
-            }
-            uint8_t* next_buf = (uint8_t*)realloc(tmp, next);
-            if (next_buf == NULL) {
-                err = ENOMEM;
-                break;
-            }
-            tmp = next_buf;
-            cap = next;
-        }
-        ssize_t n = read(fd, tmp + len, cap - len);
-        if (n < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
-            err = errno;
-            break;
-        }
-        if (n == 0) {
-            break;
-        }
-        len += (size_t)n;
-    }
+    uint8_t* data = NULL;
+    uint64_t len = 0;
+    uint64_t cap = 0;
+    int err = fs_read_fd_all(fd, &st, &data, &len, &cap);
     close(fd);
     free(buf);
     if (err != 0) {
-        free(tmp);
         return fs_make_error(fs_error_code_from_errno(err));
     }
-
-    void* data = NULL;
-    if (len > 0) {
-        data = rt_alloc((uint64_t)len, (uint64_t)alignof(uint8_t));
-        if (data == NULL) {
-            free(tmp);
-            return fs_make_error(FS_ERR_IO);
-        }
-        memcpy(data, tmp, len);
-    }
-    free(tmp);
-
     SurgeArrayHeader* header = (SurgeArrayHeader*)rt_alloc((uint64_t)sizeof(SurgeArrayHeader),
                                                            (uint64_t)alignof(SurgeArrayHeader));
     if (header == NULL) {
         return fs_make_error(FS_ERR_IO);
     }
-    header->len = (uint64_t)len;
-    header->cap = (uint64_t)len;
+    header->len = len;
+    header->cap = cap;
     header->data = data;
     return fs_make_success_ptr((void*)header);
 }
 
+void* rt_fs_map_file(void* path) {
+    uint64_t err_code = 0;
+    char* buf = fs_copy_path(path, NULL, &err_code);
+    if (buf == NULL) {
+        return fs_make_error(err_code == 0 ? FS_ERR_INVALID_PATH : err_code);
+    }
+    int fd = open(buf, O_RDONLY, 0666);
+    free(buf);
+    if (fd < 0) {
+        return fs_make_error(fs_error_code_from_errno(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        uint64_t code = fs_error_code_from_errno(errno);
+        close(fd);
+        return fs_make_error(code);
+    }
+    if (S_ISDIR(st.st_mode)) {
+        close(fd);
+        return fs_make_error(FS_ERR_IS_DIR);
+    }
+    const uint8_t* data = NULL;
+    uint64_t len = 0;
+    if (S_ISREG(st.st_mode) && st.st_size > 0 && (uint64_t)st.st_size <= (uint64_t)SIZE_MAX) {
+        void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            data = (const uint8_t*)mapped;
+            len = (uint64_t)st.st_size;
+        }
+    }
+    if (data == NULL) {
+        // Pipes, procfs files and filesystems without mmap support are read into memory instead.
+        uint8_t* owned = NULL;
+        uint64_t cap = 0;
+        int err = fs_read_fd_all(fd, &st, &owned, &len, &cap);
+        if (err != 0) {
+            close(fd);
+            return fs_make_error(fs_error_code_from_errno(err));
+        }
+        data = owned;
+    }
+    close(fd);
+    FsBytesView* view =
+        (FsBytesView*)rt_alloc((uint64_t)sizeof(FsBytesView), (uint64_t)alignof(FsBytesView));
+    if (view == NULL) {
+        return fs_make_error(FS_ERR_IO);
+    }
+    view->owner = rt_string_from_bytes(NULL, 0);
+    view->ptr = data;
+    view->len = rt_biguint_from_u64(len);
+    return fs_make_success_ptr((void*)view);
+}
+
+void* rt_fs_read_into(void* file, void* array_slot, uint64_t cap) {
+    FsFile* f = (FsFile*)file;
+    if (f == NULL || f->closed) {
+        return fs_make_error(FS_ERR_IO);
+    }
+    if (array_slot == NULL || *(void**)array_slot == NULL || cap > (uint64_t)SSIZE_MAX) {
+        return fs_make_error(FS_ERR_INVALID_DATA);
+    }
+    if (cap == 0) {
+        return fs_make_success_ptr(rt_biguint_from_u64(0));
+    }
+    rt_byte_array_reserve_spare(array_slot, cap);
+    SurgeArrayHeader* header = *(SurgeArrayHeader**)array_slot;
+    ssize_t n = -1;
+    do {
+        n = read(f->fd, (uint8_t*)header->data + header->len, (size_t)cap);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return fs_make_error(fs_error_code_from_errno(errno));
+    }
+    header->len += (uint64_t)n;
+    return fs_make_success_ptr(rt_biguint_from_u64((uint64_t)n));
+}
+
 void* rt_fs_write_file(void* path, const uint8_t* data, uint64_t len, uint32_t flags) {
     if (len > 0 && data == NULL) {
         return fs_make_error(FS_ERR_INVALID_DATA);
@@ -923,6 +1031,14 @@ void* rt_fs_write_file(void* path, const uint8_t* data, uint64_t len, uint32_t f
     return fs_make_success_nothing();
 }
 
+int rt_fs_file_fd(const void* file) {
+    const FsFile* f = (const FsFile*)file;
+    if (f == NULL || f->closed) {
+        return -1;
+    }
+    return f->fd;
+}
+
 void* rt_fs_file_name(const void* file) {
     const FsFile* f = (const FsFile*)file;
     if (f == NULL || f->closed || f->path == NULL) {
@@ -5,10 +5,14 @@
 #include "rt.h"
 
 #include <ctype.h>
+#include <errno.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #ifndef alignof
@@ -18,13 +22,33 @@
 extern int rt_argc;
 extern char** rt_argv_raw;
 
-uint64_t rt_write_stdout(const uint8_t* ptr, uint64_t length) {
-    if (ptr == NULL || length == 0) {
-        return 0;
-    }
+// Stdout goes through one process-wide buffer so that many small prints cost one write(2)
+// per buffer instead of one per call. A single mutex keeps the bytes in program order
+// across worker threads. The buffer is line-buffered on a TTY and block-buffered
+// otherwise; SURGE_STDOUT=line|block|unbuffered overrides the choice.
+enum { STDOUT_BUFFER_CAP = 64 * 1024 };
+
+typedef enum StdoutMode {
+    STDOUT_MODE_UNSET = 0,
+    STDOUT_MODE_LINE,
+    STDOUT_MODE_BLOCK,
+    STDOUT_MODE_UNBUFFERED,
+} StdoutMode;
+
+static pthread_mutex_t stdout_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t stdout_buf[STDOUT_BUFFER_CAP];
+static size_t stdout_len;
+static StdoutMode stdout_mode;
+// Mirrors stdout_len != 0 so idle threads can skip the lock when nothing is pending.
+static atomic_bool stdout_dirty;
+
+static uint64_t write_fd_all(int fd, const uint8_t* ptr, uint64_t length) {
     uint64_t written = 0;
     while (written < length) {
-        ssize_t chunk = write(STDOUT_FILENO, ptr + written, (size_t)(length - written));
+        ssize_t chunk = write(fd, ptr + written, (size_t)(length - written));
+        if (chunk < 0 && errno == EINTR) {
+            continue;
+        }
         if (chunk <= 0) {
             break;
         }
@@ -33,22 +57,94 @@ uint64_t rt_write_stdout(const uint8_t* ptr, uint64_t length) {
     return written;
 }
 
-uint64_t rt_write_stderr(const uint8_t* ptr, uint64_t length) {
+static void stdout_flush_at_exit(void) {
+    rt_flush_stdout();
+}
+
+static StdoutMode stdout_mode_locked(void) {
+    if (stdout_mode != STDOUT_MODE_UNSET) {
+        return stdout_mode;
+    }
+    const char* env = getenv("SURGE_STDOUT");
+    if (env != NULL && strcmp(env, "line") == 0) {
+        stdout_mode = STDOUT_MODE_LINE;
+    } else if (env != NULL && strcmp(env, "block") == 0) {
+        stdout_mode = STDOUT_MODE_BLOCK;
+    } else if (env != NULL && strcmp(env, "unbuffered") == 0) {
+        stdout_mode = STDOUT_MODE_UNBUFFERED;
+    } else {
+        stdout_mode = isatty(STDOUT_FILENO) ? STDOUT_MODE_LINE : STDOUT_MODE_BLOCK;
+    }
+    if (stdout_mode != STDOUT_MODE_UNBUFFERED) {
+        // exit() paths that bypass rt_exit (libc exit, return from main) still drain the buffer.
+        atexit(stdout_flush_at_exit);
+    }
+    return stdout_mode;
+}
+
+static void stdout_flush_locked(void) {
+    if (stdout_len == 0) {
+        return;
+    }
+    (void)write_fd_all(STDOUT_FILENO, stdout_buf, (uint64_t)stdout_len);
+    stdout_len = 0;
+    atomic_store_explicit(&stdout_dirty, false, memory_order_relaxed);
+}
+
+uint64_t rt_write_stdout(const uint8_t* ptr, uint64_t length) {
     if (ptr == NULL || length == 0) {
         return 0;
     }
-    uint64_t written = 0;
-    while (written < length) {
-        ssize_t chunk = write(STDERR_FILENO, ptr + written, (size_t)(length - written));
-        if (chunk <= 0) {
-            break;
+    pthread_mutex_lock(&stdout_lock);
+    StdoutMode mode = stdout_mode_locked();
+    uint64_t written = length;
+    if (mode == STDOUT_MODE_UNBUFFERED || length >= STDOUT_BUFFER_CAP) {
+        // Large writes skip the copy; earlier buffered bytes go out first to keep order.
+        stdout_flush_locked();
+        written = write_fd_all(STDOUT_FILENO, ptr, length);
+    } else {
+        if (stdout_len + (size_t)length > STDOUT_BUFFER_CAP) {
+            stdout_flush_locked();
         }
-        written += (uint64_t)chunk;
+        memcpy(stdout_buf + stdout_len, ptr, (size_t)length);
+        stdout_len += (size_t)length;
+        atomic_store_explicit(&stdout_dirty, true, memory_order_relaxed);
+        if (mode == STDOUT_MODE_LINE && memchr(ptr, '\n', (size_t)length) != NULL) {
+            stdout_flush_locked();
+        }
+    }
+    pthread_mutex_unlock(&stdout_lock);
+    return written;
+}
+
+void rt_flush_stdout(void) {
+    if (!atomic_load_explicit(&stdout_dirty, memory_order_relaxed)) {
+        return;
+    }
+    pthread_mutex_lock(&stdout_lock);
+    stdout_flush_locked();
+    pthread_mutex_unlock(&stdout_lock);
+}
+
+bool rt_stdout_pending(void) {
+    return atomic_load_explicit(&stdout_dirty, memory_order_relaxed);
+}
+
+uint64_t rt_write_stderr(const uint8_t* ptr, uint64_t length) {
+    if (ptr == NULL || length == 0) {
+        return 0;
     }
+    // Stderr stays unbuffered, but pending stdout goes first so the two streams interleave
+    // in program order when they share a terminal or log file.
+    pthread_mutex_lock(&stdout_lock);
+    stdout_flush_locked();
+    uint64_t written = write_fd_all(STDERR_FILENO, ptr, length);
+    pthread_mutex_unlock(&stdout_lock);
     return written;
 }
 
 void* rt_readline(void) {
+    rt_flush_stdout();
     char* buf = NULL;
     size_t cap = 0;
     ssize_t n = getline(&buf, &cap, stdin);
@@ -122,13 +218,21 @@ void* rt_argv(void) {
 }
 
 void* rt_stdin_read_all(void) {
+    rt_flush_stdout();
     uint8_t* buf = NULL;
     size_t len = 0;
     size_t cap = 0;
+    // Redirected regular files are read into one block sized up front instead of doubling.
+    size_t first = 4096;
+    struct stat st;
+    if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+        (uint64_t)st.st_size < (uint64_t)SIZE_MAX - 1024) {
+        first = (size_t)st.st_size + 1024;
+    }
 
     for (;;) {
         if (cap - len < 1024) {
-            size_t next = cap == 0 ? 4096 : cap * 2;
+            size_t next = cap == 0 ? first : cap * 2;
             uint8_t* tmp = (uint8_t*)realloc(buf, next);
             if (tmp == NULL) {
                 free(buf);
@@ -159,8 +263,11 @@ void* rt_stdin_read_all(void) {
 }
 
 void rt_exit(int64_t code) {
+    rt_flush_stdout();
     rt_exec_trace_dump();
     rt_sched_trace_dump();
+    rt_metrics_export_exit();
+    rt_profile_dump_exit();
     exit((int)code);
 }
 
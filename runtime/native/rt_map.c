@@ -1,4 +1,5 @@
 #include "rt.h"
+#include "rt_bignum_internal.h"
 
 #include <limits.h>
 #include <stdbool.h>
@@ -10,9 +11,16 @@
 #define alignof(t) __alignof__(t)
 #endif
 
+// Maps keep entries densely packed in insertion order (removal swaps the last entry into
+// the hole) and index them with an open-addressing table of 8-slot groups. Each slot has a
+// control byte holding 7 bits of the key hash, so a probe rejects most non-matching slots
+// with one word compare before touching entries. Small maps skip the index and scan the
+// cached hashes directly.
+
 typedef struct SurgeMapEntry {
     uint64_t key;
     uint64_t value;
+    uint64_t hash;
 } SurgeMapEntry;
 
 typedef struct SurgeMap {
@@ -20,6 +28,10 @@ typedef struct SurgeMap {
     uint64_t cap;
     uint64_t key_kind;
     SurgeMapEntry* entries;
+    uint8_t* ctrl;
+    uint32_t* slots;
+    uint64_t index_cap;
+    uint64_t index_used;
 } SurgeMap;
 
 typedef struct SurgeArrayHeader {
@@ -36,6 +48,17 @@ enum {
     MAP_KEY_BIGUINT = 5,
 };
 
+enum {
+    MAP_GROUP_WIDTH = 8,
+    MAP_LINEAR_MAX = 8,
+    MAP_INDEX_MIN_CAP = 16,
+};
+
+#define MAP_CTRL_EMPTY ((uint8_t)0x80)
+#define MAP_CTRL_DELETED ((uint8_t)0xFE)
+#define MAP_GROUP_LSB UINT64_C(0x0101010101010101)
+#define MAP_GROUP_MSB UINT64_C(0x8080808080808080)
+
 static void map_panic(const char* msg) {
     rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
 }
@@ -84,19 +107,267 @@ static bool map_key_eq(const SurgeMap* map, uint64_t key_bits, uint64_t entry_bi
     }
 }
 
+static uint64_t map_mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= UINT64_C(0xff51afd7ed558ccd);
+    x ^= x >> 33;
+    x *= UINT64_C(0xc4ceb9fe1a85ec53);
+    x ^= x >> 33;
+    return x;
+}
+
+static uint64_t map_hash_bytes(const uint8_t* data, uint64_t len) {
+    uint64_t h = UINT64_C(0x9e3779b97f4a7c15) ^ (len * UINT64_C(0xc2b2ae3d27d4eb4f));
+    uint64_t i = 0;
+    if (data != NULL) {
+        for (; i + 8 <= len; i += 8) {
+            uint64_t word = 0;
+            memcpy(&word, data + i, sizeof(word));
+            h ^= map_mix64(word);
+            h = (h << 27) | (h >> 37);
+            h = h * UINT64_C(5) + UINT64_C(0x52dce729);
+        }
+        uint64_t tail = 0;
+        for (uint64_t shift = 0; i < len; i++, shift += 8) {
+            tail |= (uint64_t)data[i] << shift;
+        }
+        h ^= map_mix64(tail);
+    }
+    return map_mix64(h);
+}
+
+static uint64_t map_hash_key(const SurgeMap* map, uint64_t key_bits) {
+    switch (map->key_kind) {
+        case MAP_KEY_STRING: {
+            void* str = (void*)(uintptr_t)key_bits;
+            return map_hash_bytes(rt_string_ptr((void*)&str), rt_string_len_bytes((void*)&str));
+        }
+        case MAP_KEY_INT:
+        case MAP_KEY_UINT:
+            return map_mix64(key_bits);
+        case MAP_KEY_BIGINT: {
+            bn_small_buf buf;
+            return map_mix64(bi_hash(bi_view((const void*)(uintptr_t)key_bits, &buf)));
+        }
+        case MAP_KEY_BIGUINT: {
+            bn_small_buf buf;
+            return map_mix64(bu_hash(bu_view((const void*)(uintptr_t)key_bits, &buf)));
+        }
+        default:
+            map_panic("map: unsupported key kind");
+            return 0;
+    }
+}
+
+static uint8_t map_h2(uint64_t hash) {
+    return (uint8_t)(hash & 0x7F);
+}
+
+static uint64_t map_h1(uint64_t hash) {
+    return hash >> 7;
+}
+
+static uint64_t map_group_load(const uint8_t* ctrl) {
+    uint64_t group = 0;
+    for (unsigned i = 0; i < MAP_GROUP_WIDTH; i++) {
+        group |= (uint64_t)ctrl[i] << (i * 8U);
+    }
+    return group;
+}
+
+// SWAR byte matches may report a false positive next to a true match; callers always
+// confirm candidates against the cached hash and key.
+static uint64_t map_group_match(uint64_t group, uint8_t h2) {
+    uint64_t x = group ^ (MAP_GROUP_LSB * (uint64_t)h2);
+    return (x - MAP_GROUP_LSB) & ~x & MAP_GROUP_MSB;
+}
+
+static uint64_t map_group_match_empty(uint64_t group) {
+    return group & ~(group << 6) & MAP_GROUP_MSB;
+}
+
+static uint64_t map_group_match_free(uint64_t group) {
+    return group & MAP_GROUP_MSB;
+}
+
+static unsigned map_mask_first(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(mask) / 8U;
+#else
+    unsigned idx = 0;
+    while ((mask & 0x80U) == 0) {
+        mask >>= 8;
+        idx++;
+    }
+    return idx;
+#endif
+}
+
+static bool map_entry_matches(const SurgeMap* map,
+                              const SurgeMapEntry* entry,
+                              uint64_t key_bits,
+                              uint64_t hash) {
+    return entry->hash == hash && map_key_eq(map, key_bits, entry->key);
+}
+
+// Returns the slot holding entry_idx under hash; the entry must be indexed.
+static uint64_t map_slot_of_entry(const SurgeMap* map, uint64_t hash, uint64_t entry_idx) {
+    uint64_t group_mask = map->index_cap / MAP_GROUP_WIDTH - 1;
+    uint64_t g = map_h1(hash) & group_mask;
+    uint8_t h2 = map_h2(hash);
+    for (uint64_t stride = 1; stride <= group_mask + 1; stride++) {
+        uint64_t base = g * MAP_GROUP_WIDTH;
+        uint64_t match = map_group_match(map_group_load(map->ctrl + base), h2);
+        while (match != 0) {
+            uint64_t slot = base + map_mask_first(match);
+            if (map->ctrl[slot] == h2 && map->slots[slot] == entry_idx) {
+                return slot;
+            }
+            match &= match - 1;
+        }
+        g = (g + stride) & group_mask;
+    }
+    map_panic("map: corrupted index");
+    return 0;
+}
+
+static bool map_find_slot(const SurgeMap* map,
+                          uint64_t key_bits,
+                          uint64_t hash,
+                          uint64_t* out_idx,
+                          uint64_t* out_slot) {
+    if (map->ctrl == NULL) {
+        for (uint64_t i = 0; i < map->len; i++) {
+            if (map_entry_matches(map, &map->entries[i], key_bits, hash)) {
+                *out_idx = i;
+                *out_slot = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+    uint64_t group_mask = map->index_cap / MAP_GROUP_WIDTH - 1;
+    uint64_t g = map_h1(hash) & group_mask;
+    uint8_t h2 = map_h2(hash);
+    for (uint64_t stride = 1; stride <= group_mask + 1; stride++) {
+        uint64_t base = g * MAP_GROUP_WIDTH;
+        uint64_t group = map_group_load(map->ctrl + base);
+        uint64_t match = map_group_match(group, h2);
+        while (match != 0) {
+            uint64_t slot = base + map_mask_first(match);
+            match &= match - 1;
+            if (map->ctrl[slot] != h2) {
+                continue;
+            }
+            uint64_t idx = map->slots[slot];
+            if (map_entry_matches(map, &map->entries[idx], key_bits, hash)) {
+                *out_idx = idx;
+                *out_slot = slot;
+                return true;
+            }
+        }
+        if (map_group_match_empty(group) != 0) {
+            return false;
+        }
+        g = (g + stride) & group_mask;
+    }
+    return false;
+}
+
 static bool map_find(const SurgeMap* map, uint64_t key_bits, uint64_t* out_idx) {
     if (map == NULL) {
         return false;
     }
-    for (uint64_t i = 0; i < map->len; i++) {
-        if (map_key_eq(map, key_bits, map->entries[i].key)) {
-            if (out_idx != NULL) {
-                *out_idx = i;
+    uint64_t idx = 0;
+    uint64_t slot = 0;
+    if (!map_find_slot(map, key_bits, map_hash_key(map, key_bits), &idx, &slot)) {
+        return false;
+    }
+    if (out_idx != NULL) {
+        *out_idx = idx;
+    }
+    return true;
+}
+
+static void map_index_place(SurgeMap* map, uint64_t hash, uint64_t entry_idx) {
+    uint64_t group_mask = map->index_cap / MAP_GROUP_WIDTH - 1;
+    uint64_t g = map_h1(hash) & group_mask;
+    for (uint64_t stride = 1;; stride++) {
+        uint64_t base = g * MAP_GROUP_WIDTH;
+        uint64_t free_mask = map_group_match_free(map_group_load(map->ctrl + base));
+        if (free_mask != 0) {
+            uint64_t slot = base + map_mask_first(free_mask);
+            if (map->ctrl[slot] == MAP_CTRL_EMPTY) {
+                map->index_used++;
             }
-            return true;
+            map->ctrl[slot] = map_h2(hash);
+            map->slots[slot] = (uint32_t)entry_idx;
+            return;
         }
+        g = (g + stride) & group_mask;
+    }
+}
+
+static void map_index_free(SurgeMap* map) {
+    if (map->ctrl == NULL) {
+        return;
+    }
+    uint64_t size = map->index_cap + map->index_cap * (uint64_t)sizeof(uint32_t);
+    rt_free(map->ctrl, size, (uint64_t)alignof(uint32_t));
+    map->ctrl = NULL;
+    map->slots = NULL;
+    map->index_cap = 0;
+    map->index_used = 0;
+}
+
+// Rebuilds the index from the cached entry hashes, dropping tombstones.
+static void map_index_rebuild(SurgeMap* map, uint64_t needed) {
+    uint64_t index_cap = MAP_INDEX_MIN_CAP;
+    while (index_cap / 8 * 7 < needed) {
+        if (index_cap > (UINT64_MAX / 2) / (uint64_t)(sizeof(uint32_t) + 1)) {
+            map_panic("map capacity overflow");
+        }
+        index_cap *= 2;
+    }
+    map_index_free(map);
+    uint64_t size = index_cap + index_cap * (uint64_t)sizeof(uint32_t);
+    uint8_t* block = (uint8_t*)rt_alloc(size, (uint64_t)alignof(uint32_t));
+    if (block == NULL) {
+        map_panic("map allocation failed");
+        return;
+    }
+    memset(block, MAP_CTRL_EMPTY, (size_t)index_cap);
+    map->ctrl = block;
+    map->slots = (uint32_t*)(void*)(block + index_cap);
+    map->index_cap = index_cap;
+    map->index_used = 0;
+    for (uint64_t i = 0; i < map->len; i++) {
+        map_index_place(map, map->entries[i].hash, i);
+    }
+}
+
+static void map_index_reserve(SurgeMap* map, uint64_t needed) {
+    if (map->ctrl == NULL) {
+        if (needed > MAP_LINEAR_MAX) {
+            map_index_rebuild(map, needed);
+        }
+        return;
+    }
+    if (map->index_used + 1 > map->index_cap / 8 * 7) {
+        map_index_rebuild(map, needed);
+    }
+}
+
+static void map_index_erase(SurgeMap* map, uint64_t slot) {
+    // A group that still has an empty slot was never full, so no probe continued past it
+    // and the erased slot can become empty instead of a tombstone.
+    uint64_t base = slot - slot % MAP_GROUP_WIDTH;
+    if (map_group_match_empty(map_group_load(map->ctrl + base)) != 0) {
+        map->ctrl[slot] = MAP_CTRL_EMPTY;
+        map->index_used--;
+    } else {
+        map->ctrl[slot] = MAP_CTRL_DELETED;
     }
-    return false;
 }
 
 static void map_ensure_capacity(SurgeMap* map, uint64_t needed) {
@@ -160,6 +431,10 @@ void* rt_map_new(uint64_t key_kind) {
     map->cap = 0;
     map->key_kind = key_kind;
     map->entries = NULL;
+    map->ctrl = NULL;
+    map->slots = NULL;
+    map->index_cap = 0;
+    map->index_used = 0;
     return (void*)map;
 }
 
@@ -207,21 +482,29 @@ bool rt_map_insert(void* map_ptr, uint64_t key_bits, uint64_t value_bits, uint64
         return false;
     }
     SurgeMap* map = (SurgeMap*)map_ptr;
+    uint64_t hash = map_hash_key(map, key_bits);
     uint64_t idx = 0;
-    if (map_find(map, key_bits, &idx)) {
+    uint64_t slot = 0;
+    if (map_find_slot(map, key_bits, hash, &idx, &slot)) {
         if (out_prev != NULL) {
             *out_prev = map->entries[idx].value;
         }
         map->entries[idx].value = value_bits;
         return true;
     }
-    if (map->len == UINT64_MAX) {
+    if (map->len >= (uint64_t)UINT32_MAX) {
         map_panic("map length overflow");
     }
     map_ensure_capacity(map, map->len + 1);
-    map->entries[map->len].key = key_bits;
-    map->entries[map->len].value = value_bits;
+    map_index_reserve(map, map->len + 1);
+    idx = map->len;
+    map->entries[idx].key = key_bits;
+    map->entries[idx].value = value_bits;
+    map->entries[idx].hash = hash;
     map->len += 1;
+    if (map->ctrl != NULL) {
+        map_index_place(map, hash, idx);
+    }
     return false;
 }
 
@@ -232,18 +515,27 @@ bool rt_map_remove(void* map_ptr, uint64_t key_bits, uint64_t* out_prev) {
     }
     SurgeMap* map = (SurgeMap*)map_ptr;
     uint64_t idx = 0;
-    if (!map_find(map, key_bits, &idx)) {
+    uint64_t slot = 0;
+    if (!map_find_slot(map, key_bits, map_hash_key(map, key_bits), &idx, &slot)) {
         return false;
     }
     if (out_prev != NULL) {
         *out_prev = map->entries[idx].value;
     }
+    if (map->ctrl != NULL) {
+        map_index_erase(map, slot);
+    }
     uint64_t last = map->len - 1;
     if (idx != last) {
+        if (map->ctrl != NULL) {
+            uint64_t moved = map_slot_of_entry(map, map->entries[last].hash, last);
+            map->slots[moved] = (uint32_t)idx;
+        }
         map->entries[idx] = map->entries[last];
     }
     map->entries[last].key = 0;
     map->entries[last].value = 0;
+    map->entries[last].hash = 0;
     map->len = last;
     return true;
 }
@@ -0,0 +1,516 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
+#include "rt_async_internal.h"
+#include "rt_thread_block.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Runtime metrics.
+//
+// Counters: every thread that bumps a counter owns a metrics_thread block
+// (rt_thread_block.h) and updates it with relaxed load/store pairs, so the scheduler and
+// reactor hot paths never contend on a shared atomic. Blocks are never reset: a thread that
+// adopts an exited thread's block keeps adding to it, so the sum over all blocks is always
+// the process-wide total. Gauges (queue depths, pool sizes, live heap counts) are read
+// when a snapshot is taken.
+//
+// Snapshots render as JSON or Prometheus text. When SURGE_METRICS_FILE is set, the first
+// executor start spawns an exporter thread that rewrites the file every
+// SURGE_METRICS_INTERVAL_MS (default 1000) through a temp file and rename, so readers
+// never see a partial snapshot, and rt_exit writes a final one. SURGE_METRICS_FORMAT
+// picks json or prometheus; the default is prometheus for *.prom paths and json otherwise.
+
+enum {
+    METRICS_VERSION = 1,
+    METRICS_INTERVAL_MS_DEFAULT = 1000,
+    METRICS_GAUGES_MAX = 24,
+    METRICS_MAX = RT_METRIC_COUNTER_COUNT + METRICS_GAUGES_MAX,
+};
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE = 1,
+} metric_kind;
+
+typedef struct {
+    const char* name;
+    const char* help;
+} metric_info;
+
+typedef struct {
+    const char* name;
+    const char* help;
+    metric_kind kind;
+    uint64_t value;
+} metric_sample;
+
+typedef struct {
+    metric_sample samples[METRICS_MAX];
+    size_t len;
+} metrics_snapshot;
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+    uint8_t failed;
+} metrics_buf;
+
+typedef struct metrics_thread {
+    rt_thread_block block;
+    atomic_u64 counters[RT_METRIC_COUNTER_COUNT];
+} metrics_thread;
+
+static const metric_info metric_counters[RT_METRIC_COUNTER_COUNT] = {
+    [RT_METRIC_TASKS_CREATED] = {"tasks_created", "Tasks created, including runtime helper tasks."},
+    [RT_METRIC_TASK_POLLS] = {"task_polls", "Task polls started by the executor."},
+    [RT_METRIC_STEALS] = {"steals", "Tasks a worker took from another worker's queue."},
+    [RT_METRIC_WAKE_CALLED] = {"wake_called",
+                               "Wake requests, including ones that found nothing to do."},
+    [RT_METRIC_WAKE_ENQUEUED] = {"wake_enqueued", "Wakes that put a task back on a ready queue."},
+    [RT_METRIC_WAKE_IGNORED_COMPLETED] = {"wake_ignored_completed",
+                                          "Wakes that arrived after the task finished."},
+    [RT_METRIC_PARK_ATTEMPT] = {"park_attempt", "Attempts to park a task on a waker."},
+    [RT_METRIC_PARK_COMMITTED] = {"park_committed", "Parks that left the task waiting."},
+    [RT_METRIC_WORKER_SLEEP] = {"worker_sleep", "Times a worker parked with no work."},
+    [RT_METRIC_WORKER_WAKE] = {"worker_wake", "Times a parked worker was woken."},
+    [RT_METRIC_WORKER_SPIN] = {"worker_spin", "Idle spin phases entered by workers."},
+    [RT_METRIC_WORKER_SPIN_HIT] = {"worker_spin_hit", "Idle spin phases that found work."},
+    [RT_METRIC_CHANNEL_BLOCKING_WAIT] = {"channel_blocking_wait",
+                                         "Worker threads blocked inside a channel operation."},
+    [RT_METRIC_CHANNEL_TASK_BLOCKING_SEND] = {"channel_task_blocking_send",
+                                              "Channel sends that parked the calling task."},
+    [RT_METRIC_CHANNEL_TASK_BLOCKING_RECV] = {"channel_task_blocking_recv",
+                                              "Channel receives that parked the calling task."},
+    [RT_METRIC_CHANNEL_HANDOFF_YIELD] = {"channel_handoff_yield",
+                                         "Yields after a channel handed a value to a waiter."},
+    [RT_METRIC_COMPENSATION_STARTED] = {"compensation_started",
+                                        "Compensation workers started for blocked workers."},
+    [RT_METRIC_NET_POLL_CALLS] = {"net_poll_calls", "Network readiness polls."},
+    [RT_METRIC_NET_POLL_TIMEOUTS] = {"net_poll_timeouts", "Network polls that timed out."},
+    [RT_METRIC_NET_POLL_WAKE_FD] = {"net_poll_wake_fd", "Network polls woken by the wake fd."},
+    [RT_METRIC_NET_POLL_READY] = {"net_poll_ready", "Socket readiness events delivered."},
+    [RT_METRIC_NET_POLL_ERRORS] = {"net_poll_errors", "Network polls that failed."},
+    [RT_METRIC_NET_POLL_WAITERS] = {"net_poll_waiters", "Socket waiters seen across all polls."},
+    [RT_METRIC_NET_DIRECT_WAIT] = {"net_direct_wait",
+                                   "Socket waits served without the I/O thread."},
+    [RT_METRIC_NET_WAITER_SCAN_ENTRIES] = {"net_waiter_scan_entries",
+                                           "Waiter entries scanned to build a poll set."},
+    [RT_METRIC_NET_WAITER_NET_ENTRIES] = {"net_waiter_net_entries",
+                                          "Socket waiter entries scanned to build a poll set."},
+    [RT_METRIC_NET_POLL_REBUILDS] = {"net_poll_rebuilds", "Poll set rebuilds."},
+    [RT_METRIC_NET_POLL_ALLOCS] = {"net_poll_allocs", "Poll set allocations."},
+    [RT_METRIC_NET_POLL_DEDUP_CHECKS] = {"net_poll_dedup_checks",
+                                         "Duplicate descriptor checks while building a poll set."},
+    [RT_METRIC_NET_WAITER_COMPLETE_CALLS] = {"net_waiter_complete_calls",
+                                             "Calls that complete socket waiters."},
+    [RT_METRIC_NET_WAITER_COMPLETED] = {"net_waiter_completed", "Socket waiters completed."},
+    [RT_METRIC_NET_REACTOR_REGISTRATIONS] = {"net_reactor_registrations",
+                                             "Descriptor registrations with the reactor."},
+    [RT_METRIC_NET_REACTOR_EVENTS] = {"net_reactor_events", "Events returned by the reactor."},
+};
+
+static rt_thread_blocks metrics_threads = RT_THREAD_BLOCKS_INIT(metrics_thread, NULL);
+// Counts from threads past their TLS destructor land here with a shared fetch_add.
+static atomic_u64 metrics_orphan[RT_METRIC_COUNTER_COUNT];
+static _Thread_local rt_thread_slot tls_metrics_slot;
+
+// Set once the executor is up; gauges read as zero before that.
+static _Atomic(rt_executor*) metrics_exec;
+
+static pthread_once_t metrics_export_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t metrics_export_lock = PTHREAD_MUTEX_INITIALIZER;
+static char* metrics_export_path;
+static char* metrics_export_tmp;
+static uint8_t metrics_export_prometheus;
+static uint32_t metrics_export_interval_ms;
+
+void rt_metric_add(rt_metric_counter id, uint64_t delta) {
+    if (id >= RT_METRIC_COUNTER_COUNT) {
+        return;
+    }
+    metrics_thread* t =
+        (metrics_thread*)(void*)rt_thread_block_get(&metrics_threads, &tls_metrics_slot);
+    if (t == NULL) {
+        (void)atomic_fetch_add_explicit(&metrics_orphan[id], delta, memory_order_relaxed);
+        return;
+    }
+    rt_thread_counter_add(&t->counters[id], delta);
+}
+
+uint64_t rt_metric_total(rt_metric_counter id) {
+    if (id >= RT_METRIC_COUNTER_COUNT) {
+        return 0;
+    }
+    uint64_t total = atomic_load_explicit(&metrics_orphan[id], memory_order_relaxed);
+    for (const rt_thread_block* b = rt_thread_blocks_first(&metrics_threads); b != NULL;
+         b = b->next) {
+        const metrics_thread* t = (const metrics_thread*)(const void*)b;
+        total += atomic_load_explicit(&t->counters[id], memory_order_relaxed);
+    }
+    return total;
+}
+
+static void metrics_push(
+    metrics_snapshot* snap, const char* name, metric_kind kind, uint64_t value, const char* help) {
+    if (snap->len >= METRICS_MAX) {
+        return;
+    }
+    metric_sample* s = &snap->samples[snap->len++];
+    s->name = name;
+    s->help = help;
+    s->kind = kind;
+    s->value = value;
+}
+
+static void metrics_collect_exec(metrics_snapshot* snap) {
+    rt_executor* ex = atomic_load_explicit(&metrics_exec, memory_order_acquire);
+    uint64_t workers = 0;
+    uint64_t running = 0;
+    uint64_t channel_blocked = 0;
+    uint64_t compensation = 0;
+    uint64_t compensation_high_water = 0;
+    uint64_t inject_len = 0;
+    uint64_t local_len = 0;
+    uint64_t waiters = 0;
+    uint64_t timers = 0;
+    uint64_t blocking_live = 0;
+    uint64_t blocking_peak = 0;
+    uint64_t blocking_queued = 0;
+    if (ex != NULL) {
+        rt_lock(ex);
+        workers = ex->worker_count;
+        running = ex->running_count;
+        channel_blocked = ex->channel_blocked_workers;
+        compensation = ex->compensation_count;
+        compensation_high_water = ex->compensation_high_water;
+        inject_len = (uint64_t)mpmc_len(&ex->inject);
+        if (ex->local_queues != NULL) {
+            for (uint32_t i = 0; i < ex->worker_count; i++) {
+                local_len += (uint64_t)deque_len(&ex->local_queues[i]);
+            }
+        }
+        waiters = (uint64_t)ex->waiters_len;
+        timers = (uint64_t)ex->timers_len;
+        rt_unlock(ex);
+        if (ex->blocking_started) {
+            pthread_mutex_lock(&ex->blocking_lock);
+            blocking_live = ex->blocking_live;
+            blocking_peak = ex->blocking_peak;
+            pthread_mutex_unlock(&ex->blocking_lock);
+            blocking_queued = (uint64_t)deque_len(&ex->blocking_queue);
+        }
+    }
+    metrics_push(snap, "worker_count", METRIC_GAUGE, workers, "Executor worker threads.");
+    metrics_push(snap, "workers_running", METRIC_GAUGE, running, "Workers polling a task.");
+    metrics_push(snap,
+                 "workers_channel_blocked",
+                 METRIC_GAUGE,
+                 channel_blocked,
+                 "Workers blocked inside a channel operation.");
+    metrics_push(snap,
+                 "compensation_workers",
+                 METRIC_GAUGE,
+                 compensation,
+                 "Compensation workers currently running.");
+    metrics_push(snap,
+                 "compensation_high_water",
+                 METRIC_GAUGE,
+                 compensation_high_water,
+                 "Most compensation workers running at once.");
+    metrics_push(
+        snap, "inject_queue_len", METRIC_GAUGE, inject_len, "Tasks on the global inject queue.");
+    metrics_push(
+        snap, "local_queue_len", METRIC_GAUGE, local_len, "Tasks on worker-local ready queues.");
+    metrics_push(snap, "waiters", METRIC_GAUGE, waiters, "Tasks parked on a waker.");
+    metrics_push(snap, "timers", METRIC_GAUGE, timers, "Pending timers.");
+    metrics_push(snap, "blocking_threads", METRIC_GAUGE, blocking_live, "Blocking pool threads.");
+    metrics_push(snap,
+                 "blocking_threads_peak",
+                 METRIC_GAUGE,
+                 blocking_peak,
+                 "Most blocking pool threads alive at once.");
+    metrics_push(
+        snap, "blocking_queue_len", METRIC_GAUGE, blocking_queued, "Blocking jobs waiting to run.");
+    metrics_push(snap,
+                 "blocking_running",
+                 METRIC_GAUGE,
+                 ex != NULL ? atomic_load_explicit(&ex->blocking_running, memory_order_relaxed) : 0,
+                 "Blocking jobs running.");
+    metrics_push(
+        snap,
+        "blocking_submitted",
+        METRIC_COUNTER,
+        ex != NULL ? atomic_load_explicit(&ex->blocking_submitted, memory_order_relaxed) : 0,
+        "Blocking jobs submitted.");
+    metrics_push(
+        snap,
+        "blocking_completed",
+        METRIC_COUNTER,
+        ex != NULL ? atomic_load_explicit(&ex->blocking_completed, memory_order_relaxed) : 0,
+        "Blocking jobs completed.");
+    metrics_push(
+        snap,
+        "blocking_cancel_requested",
+        METRIC_COUNTER,
+        ex != NULL ? atomic_load_explicit(&ex->blocking_cancel_requested, memory_order_relaxed) : 0,
+        "Cancellation requests for blocking jobs.");
+    metrics_push(
+        snap,
+        "blocking_spawned",
+        METRIC_COUNTER,
+        ex != NULL ? atomic_load_explicit(&ex->blocking_spawned, memory_order_relaxed) : 0,
+        "Blocking pool threads started.");
+    metrics_push(
+        snap,
+        "blocking_retired",
+        METRIC_COUNTER,
+        ex != NULL ? atomic_load_explicit(&ex->blocking_retired, memory_order_relaxed) : 0,
+        "Blocking pool threads retired after idling.");
+}
+
+static void metrics_collect(metrics_snapshot* snap) {
+    snap->len = 0;
+    for (size_t i = 0; i < RT_METRIC_COUNTER_COUNT; i++) {
+        metrics_push(snap,
+                     metric_counters[i].name,
+                     METRIC_COUNTER,
+                     rt_metric_total((rt_metric_counter)i),
+                     metric_counters[i].help);
+    }
+    metrics_collect_exec(snap);
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t live_blocks = 0;
+    uint64_t live_bytes = 0;
+    rt_heap_counts(&allocs, &frees, &live_blocks, &live_bytes);
+    metrics_push(snap, "heap_allocs", METRIC_COUNTER, allocs, "Runtime heap allocations.");
+    metrics_push(snap, "heap_frees", METRIC_COUNTER, frees, "Runtime heap frees.");
+    metrics_push(snap, "heap_live_blocks", METRIC_GAUGE, live_blocks, "Live runtime heap blocks.");
+    metrics_push(snap, "heap_live_bytes", METRIC_GAUGE, live_bytes, "Live runtime heap bytes.");
+}
+
+static void buf_append(metrics_buf* buf, const char* text, size_t len) {
+    if (buf->failed) {
+        return;
+    }
+    if (buf->len + len + 1 > buf->cap) {
+        size_t cap = buf->cap == 0 ? 4096 : buf->cap * 2;
+        while (cap < buf->len + len + 1) {
+            cap *= 2;
+        }
+        char* next = (char*)realloc(buf->data, cap);
+        if (next == NULL) {
+            buf->failed = 1;
+            return;
+        }
+        buf->data = next;
+        buf->cap = cap;
+    }
+    memcpy(buf->data + buf->len, text, len);
+    buf->len += len;
+    buf->data[buf->len] = '\0';
+}
+
+static void buf_str(metrics_buf* buf, const char* text) {
+    buf_append(buf, text, strlen(text));
+}
+
+static void buf_u64(metrics_buf* buf, uint64_t value) {
+    char tmp[24];
+    int n = snprintf(tmp, sizeof(tmp), "%llu", (unsigned long long)value);
+    if (n > 0) {
+        buf_append(buf, tmp, (size_t)n);
+    }
+}
+
+static void metrics_render_json_kind(metrics_buf* buf,
+                                     const metrics_snapshot* snap,
+                                     metric_kind kind) {
+    int first = 1;
+    for (size_t i = 0; i < snap->len; i++) {
+        const metric_sample* s = &snap->samples[i];
+        if (s->kind != kind) {
+            continue;
+        }
+        buf_str(buf, first ? "\"" : ",\"");
+        buf_str(buf, s->name);
+        buf_str(buf, "\":");
+        buf_u64(buf, s->value);
+        first = 0;
+    }
+}
+
+static void metrics_render_json(metrics_buf* buf, const metrics_snapshot* snap) {
+    buf_str(buf, "{\"version\":");
+    buf_u64(buf, METRICS_VERSION);
+    buf_str(buf, ",\"counters\":{");
+    metrics_render_json_kind(buf, snap, METRIC_COUNTER);
+    buf_str(buf, "},\"gauges\":{");
+    metrics_render_json_kind(buf, snap, METRIC_GAUGE);
+    buf_str(buf, "}}\n");
+}
+
+static void metrics_render_prometheus(metrics_buf* buf, const metrics_snapshot* snap) {
+    for (size_t i = 0; i < snap->len; i++) {
+        const metric_sample* s = &snap->samples[i];
+        const char* suffix = s->kind == METRIC_COUNTER ? "_total" : "";
+        buf_str(buf, "# HELP surge_");
+        buf_str(buf, s->name);
+        buf_str(buf, suffix);
+        buf_str(buf, " ");
+        buf_str(buf, s->help);
+        buf_str(buf, "\n# TYPE surge_");
+        buf_str(buf, s->name);
+        buf_str(buf, suffix);
+        buf_str(buf, s->kind == METRIC_COUNTER ? " counter\nsurge_" : " gauge\nsurge_");
+        buf_str(buf, s->name);
+        buf_str(buf, suffix);
+        buf_str(buf, " ");
+        buf_u64(buf, s->value);
+        buf_str(buf, "\n");
+    }
+}
+
+static void metrics_render(metrics_buf* buf, int prometheus) {
+    metrics_snapshot snap;
+    metrics_collect(&snap);
+    if (prometheus) {
+        metrics_render_prometheus(buf, &snap);
+    } else {
+        metrics_render_json(buf, &snap);
+    }
+}
+
+static void* metrics_render_string(int prometheus) {
+    metrics_buf buf = {NULL, 0, 0, 0};
+    metrics_render(&buf, prometheus);
+    if (buf.failed) {
+        free(buf.data);
+        panic_msg("metrics: snapshot allocation failed");
+        return NULL;
+    }
+    void* out = rt_string_from_bytes((const uint8_t*)buf.data, (uint64_t)buf.len);
+    free(buf.data);
+    return out;
+}
+
+void* rt_metrics_json(void) {
+    return metrics_render_string(0);
+}
+
+void* rt_metrics_prometheus(void) {
+    return metrics_render_string(1);
+}
+
+int64_t rt_metrics_value(void* name) {
+    const uint8_t* ptr = rt_string_ptr(name);
+    uint64_t len = rt_string_len_bytes(name);
+    if (ptr == NULL || len == 0) {
+        return -1;
+    }
+    metrics_snapshot snap;
+    metrics_collect(&snap);
+    for (size_t i = 0; i < snap.len; i++) {
+        const metric_sample* s = &snap.samples[i];
+        if (strlen(s->name) == len && memcmp(s->name, ptr, (size_t)len) == 0) {
+            return s->value > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)s->value;
+        }
+    }
+    return -1;
+}
+
+static void metrics_export_write(void) {
+    metrics_buf buf = {NULL, 0, 0, 0};
+    metrics_render(&buf, metrics_export_prometheus);
+    if (buf.failed) {
+        free(buf.data);
+        return;
+    }
+    pthread_mutex_lock(&metrics_export_lock);
+    FILE* f = fopen(metrics_export_tmp, "w");
+    if (f != NULL) {
+        size_t written = fwrite(buf.data, 1, buf.len, f);
+        if (fclose(f) == 0 && written == buf.len) {
+            (void)rename(metrics_export_tmp, metrics_export_path);
+        }
+    }
+    pthread_mutex_unlock(&metrics_export_lock);
+    free(buf.data);
+}
+
+static void* metrics_export_main(void* arg) {
+    (void)arg;
+    struct timespec interval;
+    interval.tv_sec = (time_t)(metrics_export_interval_ms / 1000u);
+    interval.tv_nsec = (long)(metrics_export_interval_ms % 1000u) * 1000000L;
+    for (;;) {
+        nanosleep(&interval, NULL);
+        metrics_export_write();
+    }
+    return NULL;
+}
+
+static void metrics_export_config(void) {
+    const char* path = getenv("SURGE_METRICS_FILE");
+    if (path == NULL || path[0] == '\0') {
+        return;
+    }
+    size_t len = strlen(path);
+    char* tmp = (char*)malloc(len + sizeof(".tmp"));
+    char* copy = (char*)malloc(len + 1);
+    if (tmp == NULL || copy == NULL) {
+        free(tmp);
+        free(copy);
+        return;
+    }
+    memcpy(copy, path, len + 1);
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", sizeof(".tmp"));
+    metrics_export_interval_ms = METRICS_INTERVAL_MS_DEFAULT;
+    const char* interval = getenv("SURGE_METRICS_INTERVAL_MS");
+    if (interval != NULL && interval[0] != '\0') {
+        char* end = NULL;
+        unsigned long ms = strtoul(interval, &end, 10);
+        if (end != NULL && *end == '\0' && ms > 0 && ms <= UINT32_MAX) {
+            metrics_export_interval_ms = (uint32_t)ms;
+        }
+    }
+    const char* format = getenv("SURGE_METRICS_FORMAT");
+    if (format != NULL && strcmp(format, "prometheus") == 0) {
+        metrics_export_prometheus = 1;
+    } else if (format == NULL || strcmp(format, "json") != 0) {
+        metrics_export_prometheus = (uint8_t)(len >= 5 && strcmp(path + len - 5, ".prom") == 0);
+    }
+    metrics_export_tmp = tmp;
+    metrics_export_path = copy;
+}
+
+void rt_metrics_init(void) {
+    atomic_store_explicit(&metrics_exec, &exec_state, memory_order_release);
+    pthread_once(&metrics_export_once, metrics_export_config);
+    if (metrics_export_path == NULL) {
+        return;
+    }
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0) {
+        return;
+    }
+    (void)pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, metrics_export_main, NULL) != 0) {
+        rt_async_debug_printf("metrics: exporter thread start failed\n");
+    }
+    (void)pthread_attr_destroy(&attr);
+}
+
+void rt_metrics_export_exit(void) {
+    pthread_once(&metrics_export_once, metrics_export_config);
+    if (metrics_export_path != NULL) {
+        metrics_export_write();
+    }
+}
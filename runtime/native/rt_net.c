@@ -18,8 +18,21 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#define NET_REACTOR_EPOLL 1
+#include "rt_net_uring_linux.h"
+#define NET_REACTOR_URING 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#define NET_REACTOR_KQUEUE 1
+#endif
+
 #ifndef alignof
 #define alignof(t) __alignof__(t)
 #endif
@@ -51,6 +64,13 @@ typedef struct NetConn {
     bool closed;
 } NetConn;
 
+// Per-fd reactor state. gen changes every time the fd is forgotten, so io_uring completions
+// queued for a closed fd are not taken for readiness of a socket that reused the number.
+typedef struct NetReactorReg {
+    uint32_t gen;
+    uint8_t bits;
+} NetReactorReg;
+
 typedef struct NetPollFd {
     int fd;
     uint8_t want_read;
@@ -63,6 +83,27 @@ typedef enum {
     NET_WAIT_WRITE = 2,
 } NetWaitKind;
 
+typedef enum {
+    NET_BACKEND_UNPROBED = 0,
+    NET_BACKEND_POLL = 1,
+    NET_BACKEND_REACTOR = 2,
+} NetBackend;
+
+enum {
+    NET_REACTOR_EVENTS = 64,
+    NET_REG_READ = 1,
+    NET_REG_WRITE = 2,
+};
+
+enum {
+    // Byte counts below this share one prebuilt Success(count) result.
+    NET_COUNT_RESULTS = 16385,
+    // Byte reads up to this size go through a per-thread buffer and allocate exactly.
+    NET_READ_SCRATCH = 16384,
+    // Parts handed to one writev; the caller resumes from the returned count.
+    NET_WRITE_PARTS = 64,
+};
+
 typedef struct SurgeArrayHeader {
     uint64_t len;
     uint64_t cap;
@@ -71,24 +112,25 @@ typedef struct SurgeArrayHeader {
 
 static int net_poll_wake_read_fd = -1;
 static int net_poll_wake_write_fd = -1;
-static _Atomic uint64_t net_poll_calls_total;
-static _Atomic uint64_t net_poll_timeouts_total;
-static _Atomic uint64_t net_poll_wake_fd_total;
-static _Atomic uint64_t net_poll_ready_total;
-static _Atomic uint64_t net_poll_errors_total;
+// Reactor state is guarded by ex->lock. net_reactor_fd is also read without the lock by close
+// paths that only need to know whether persistent registrations exist at all.
+static NetBackend net_backend = NET_BACKEND_UNPROBED;
+static _Atomic int net_reactor_fd = -1;
+// Set when SURGE_NET_POLL=uring picked the io_uring reactor over epoll.
+static bool net_reactor_uring;
+#if defined(NET_REACTOR_URING)
+// Set once the ring also completes socket I/O. It stays set after a fallback to epoll so data
+// the ring already received is still read out; other modes skip ex->lock on the I/O paths.
+static _Atomic bool net_uring_io_used;
+#endif
+static NetReactorReg* net_reactor_regs;
+static size_t net_reactor_regs_cap;
+static _Atomic(void*) net_count_results[NET_COUNT_RESULTS];
+static _Thread_local uint8_t net_read_scratch[NET_READ_SCRATCH];
 static _Atomic uint64_t net_poll_timeout_last_ms;
 static _Atomic uint64_t net_poll_timeout_max_ms;
 static _Atomic uint64_t net_poll_waiters_last;
 static _Atomic uint64_t net_poll_waiters_max;
-static _Atomic uint64_t net_poll_waiters_total;
-static _Atomic uint64_t net_direct_wait_total;
-static _Atomic uint64_t net_waiter_scan_entries_total;
-static _Atomic uint64_t net_waiter_net_entries_total;
-static _Atomic uint64_t net_poll_rebuilds_total;
-static _Atomic uint64_t net_poll_allocs_total;
-static _Atomic uint64_t net_poll_dedup_checks_total;
-static _Atomic uint64_t net_waiter_complete_calls_total;
-static _Atomic uint64_t net_waiter_completed_total;
 
 #define NET_TRACE_DUMP_FORMAT                                                                      \
     "TRACE_NET reason=%s io_poll_calls=%llu io_poll_timeouts=%llu "                                \
@@ -98,35 +140,52 @@ static _Atomic uint64_t net_waiter_completed_total;
     "io_poll_waiters_total=%llu io_direct_waits=%llu "                                             \
     "io_waiter_scan_entries=%llu io_waiter_net_entries=%llu "                                      \
     "io_poll_rebuilds=%llu io_poll_allocs=%llu io_poll_dedup_checks=%llu "                         \
-    "io_waiter_complete_calls=%llu io_waiter_completed=%llu\n"
+    "io_waiter_complete_calls=%llu io_waiter_completed=%llu "                                      \
+    "io_reactor_registrations=%llu io_reactor_events=%llu io_uring_enters=%llu "                   \
+    "io_poll_backend=%s\n"
 #define NET_TRACE_DUMP_ARGS(reason)                                                                \
-    (reason), net_trace_load(&net_poll_calls_total), net_trace_load(&net_poll_timeouts_total),     \
-        net_trace_load(&net_poll_wake_fd_total), net_trace_load(&net_poll_ready_total),            \
-        net_trace_load(&net_poll_errors_total), net_trace_load(&net_poll_timeout_last_ms),         \
-        net_trace_load(&net_poll_timeout_max_ms), net_trace_load(&net_poll_waiters_last),          \
-        net_trace_load(&net_poll_waiters_max), net_trace_load(&net_poll_waiters_total),            \
-        net_trace_load(&net_direct_wait_total), net_trace_load(&net_waiter_scan_entries_total),    \
-        net_trace_load(&net_waiter_net_entries_total), net_trace_load(&net_poll_rebuilds_total),   \
-        net_trace_load(&net_poll_allocs_total), net_trace_load(&net_poll_dedup_checks_total),      \
-        net_trace_load(&net_waiter_complete_calls_total),                                          \
-        net_trace_load(&net_waiter_completed_total)
+    (reason), net_metric_load(RT_METRIC_NET_POLL_CALLS),                                           \
+        net_metric_load(RT_METRIC_NET_POLL_TIMEOUTS), net_metric_load(RT_METRIC_NET_POLL_WAKE_FD), \
+        net_metric_load(RT_METRIC_NET_POLL_READY), net_metric_load(RT_METRIC_NET_POLL_ERRORS),     \
+        net_trace_load(&net_poll_timeout_last_ms), net_trace_load(&net_poll_timeout_max_ms),       \
+        net_trace_load(&net_poll_waiters_last), net_trace_load(&net_poll_waiters_max),             \
+        net_metric_load(RT_METRIC_NET_POLL_WAITERS), net_metric_load(RT_METRIC_NET_DIRECT_WAIT),   \
+        net_metric_load(RT_METRIC_NET_WAITER_SCAN_ENTRIES),                                        \
+        net_metric_load(RT_METRIC_NET_WAITER_NET_ENTRIES),                                         \
+        net_metric_load(RT_METRIC_NET_POLL_REBUILDS), net_metric_load(RT_METRIC_NET_POLL_ALLOCS),  \
+        net_metric_load(RT_METRIC_NET_POLL_DEDUP_CHECKS),                                          \
+        net_metric_load(RT_METRIC_NET_WAITER_COMPLETE_CALLS),                                      \
+        net_metric_load(RT_METRIC_NET_WAITER_COMPLETED),                                           \
+        net_metric_load(RT_METRIC_NET_REACTOR_REGISTRATIONS),                                      \
+        net_metric_load(RT_METRIC_NET_REACTOR_EVENTS), net_reactor_enters(), net_backend_name()
+
+static const char* net_backend_name(void) {
+    if (atomic_load_explicit(&net_reactor_fd, memory_order_relaxed) < 0) {
+        return "poll";
+    }
+#if defined(NET_REACTOR_EPOLL)
+    return net_reactor_uring ? "io_uring" : "epoll";
+#elif defined(NET_REACTOR_KQUEUE)
+    return "kqueue";
+#else
+    return "poll";
+#endif
+}
 
 static unsigned long long net_trace_load(const _Atomic uint64_t* counter) {
     return (unsigned long long)atomic_load_explicit(counter, memory_order_relaxed);
 }
 
-static void net_trace_inc(_Atomic uint64_t* counter) {
-    if (!rt_exec_trace_enabled()) {
-        return;
-    }
-    (void)atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+static unsigned long long net_metric_load(rt_metric_counter id) {
+    return (unsigned long long)rt_metric_total(id);
 }
 
-static void net_trace_add(_Atomic uint64_t* counter, uint64_t value) {
-    if (!rt_exec_trace_enabled()) {
-        return;
-    }
-    (void)atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+static unsigned long long net_reactor_enters(void) {
+#if defined(NET_REACTOR_URING)
+    return (unsigned long long)net_uring_enters();
+#else
+    return 0;
+#endif
 }
 
 static void net_trace_store(_Atomic uint64_t* counter, uint64_t value) {
@@ -221,10 +280,10 @@ static void net_poll_wake_drain(void) {
 }
 
 static void complete_net_waiters(rt_executor* ex, waker_key key) {
-    net_trace_inc(&net_waiter_complete_calls_total);
+    rt_metric_inc(RT_METRIC_NET_WAITER_COMPLETE_CALLS);
     uint64_t task_id = 0;
     while (pop_waiter(ex, key, &task_id)) {
-        net_trace_inc(&net_waiter_completed_total);
+        rt_metric_inc(RT_METRIC_NET_WAITER_COMPLETED);
         const rt_task* task = get_task(ex, task_id);
         if (task == NULL || task_status_load(task) == TASK_DONE) {
             continue;
@@ -233,6 +292,379 @@ static void complete_net_waiters(rt_executor* ex, waker_key key) {
     }
 }
 
+static size_t net_waiter_count(const rt_executor* ex) {
+    return ex->waiters_by_kind[WAKER_NET_ACCEPT] + ex->waiters_by_kind[WAKER_NET_READ] +
+           ex->waiters_by_kind[WAKER_NET_WRITE];
+}
+
+static void complete_all_net_waiters(rt_executor* ex) {
+    // Wakes every parked net waiter so it re-checks its fd; used when the poller itself fails.
+    while (ex->net_wait_queues != NULL) {
+        complete_net_waiters(ex, ex->net_wait_queues->key);
+    }
+}
+
+static bool net_env_force_poll(void) {
+    const char* value = getenv("SURGE_NET_POLL");
+    return value != NULL && strcmp(value, "poll") == 0;
+}
+
+static bool net_env_want_uring(void) {
+    const char* value = getenv("SURGE_NET_POLL");
+    return value != NULL && strcmp(value, "uring") == 0;
+}
+
+static int net_reactor_create_poller(void) {
+#if defined(NET_REACTOR_EPOLL)
+    int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (net_poll_wake_init()) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = net_poll_wake_read_fd;
+        if (epoll_ctl(fd, EPOLL_CTL_ADD, net_poll_wake_read_fd, &ev) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+#elif defined(NET_REACTOR_KQUEUE)
+    int fd = kqueue();
+    if (fd < 0) {
+        return -1;
+    }
+    int flags = fcntl(fd, F_GETFD, 0);
+    if (flags >= 0) {
+        (void)fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+    }
+    if (net_poll_wake_init()) {
+        struct kevent change;
+        EV_SET(&change, (uintptr_t)net_poll_wake_read_fd, EVFILT_READ, EV_ADD, 0, 0, NULL);
+        if (kevent(fd, &change, 1, NULL, 0, NULL) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+static int net_reactor_create(void) {
+#if defined(NET_REACTOR_URING)
+    if (net_env_want_uring()) {
+        int ring = net_uring_create(net_poll_wake_init() ? net_poll_wake_read_fd : -1);
+        if (ring >= 0) {
+            net_reactor_uring = true;
+            if (net_uring_io_enabled()) {
+                atomic_store_explicit(&net_uring_io_used, true, memory_order_release);
+            }
+            return ring;
+        }
+        // Kernels without io_uring (or with it disabled) keep the epoll reactor.
+    }
+#endif
+    return net_reactor_create_poller();
+}
+
+static bool net_reactor_enabled(void) {
+    // Caller holds ex->lock. The backend is probed once; SURGE_NET_POLL=poll keeps the
+    // portable poll() loop for comparison runs and SURGE_NET_POLL=uring asks for io_uring.
+    if (net_backend == NET_BACKEND_UNPROBED) {
+        int fd = net_env_force_poll() ? -1 : net_reactor_create();
+        if (fd >= 0) {
+            atomic_store_explicit(&net_reactor_fd, fd, memory_order_relaxed);
+            net_backend = NET_BACKEND_REACTOR;
+        } else {
+            net_backend = NET_BACKEND_POLL;
+        }
+    }
+    return net_backend == NET_BACKEND_REACTOR;
+}
+
+static void net_reactor_disable(void) {
+    // Caller holds ex->lock. Registered fds stay in the kernel set, but nothing waits on it;
+    // the poll() loop sees every parked waiter through ex->net_wait_queues.
+    net_backend = NET_BACKEND_POLL;
+}
+
+#if defined(NET_REACTOR_URING)
+static void net_reactor_uring_fallback(rt_executor* ex) {
+    // Caller holds ex->lock. The ring stopped taking submissions, so polls armed in it could
+    // no longer be removed and would keep closed sockets alive. Destroying it cancels them
+    // all; the fds are registered again with epoll as their waiters re-check and park.
+    net_uring_destroy();
+    net_reactor_uring = false;
+    for (size_t i = 0; i < net_reactor_regs_cap; i++) {
+        net_reactor_regs[i].bits = 0;
+    }
+    int fd = net_reactor_create_poller();
+    atomic_store_explicit(&net_reactor_fd, fd, memory_order_relaxed);
+    if (fd < 0) {
+        net_reactor_disable();
+    }
+    // A worker may still be blocked on the old ring; the wake pipe was armed in it.
+    rt_net_wake_poll();
+    complete_all_net_waiters(ex);
+}
+#endif
+
+static bool net_reactor_ensure_regs(int fd) {
+    size_t want = (size_t)fd + 1;
+    if (want <= net_reactor_regs_cap) {
+        return true;
+    }
+    size_t next_cap = net_reactor_regs_cap == 0 ? 256 : net_reactor_regs_cap;
+    while (next_cap < want) {
+        next_cap *= 2;
+    }
+    NetReactorReg* next = rt_realloc((uint8_t*)net_reactor_regs,
+                                     (uint64_t)(net_reactor_regs_cap * sizeof(NetReactorReg)),
+                                     (uint64_t)(next_cap * sizeof(NetReactorReg)),
+                                     alignof(NetReactorReg));
+    if (next == NULL) {
+        return false;
+    }
+    memset(next + net_reactor_regs_cap,
+           0,
+           (next_cap - net_reactor_regs_cap) * sizeof(NetReactorReg));
+    net_reactor_regs = next;
+    net_reactor_regs_cap = next_cap;
+    return true;
+}
+
+static void net_reactor_watch(rt_executor* ex, int fd, NetWaitKind kind) {
+    // Caller holds ex->lock. Interest is registered edge-triggered once per fd and kept until
+    // the fd is closed; net_wait_current_task re-checks readiness before every park, so edges
+    // consumed while nobody waited are never lost.
+    if (fd < 0 || !net_reactor_enabled()) {
+        return;
+    }
+    if (!net_reactor_ensure_regs(fd)) {
+        net_reactor_disable();
+        return;
+    }
+    uint8_t want = kind == NET_WAIT_WRITE ? NET_REG_WRITE : NET_REG_READ;
+    uint8_t have = net_reactor_regs[fd].bits;
+    if ((have & want) != 0) {
+        return;
+    }
+    int rfd = atomic_load_explicit(&net_reactor_fd, memory_order_relaxed);
+#if defined(NET_REACTOR_URING)
+    if (net_reactor_uring) {
+        if (!net_uring_watch(fd, net_reactor_regs[fd].gen)) {
+            net_reactor_uring_fallback(ex);
+            return;
+        }
+        rt_metric_inc(RT_METRIC_NET_REACTOR_REGISTRATIONS);
+        net_reactor_regs[fd].bits = NET_REG_READ | NET_REG_WRITE;
+        return;
+    }
+#else
+    (void)ex;
+#endif
+#if defined(NET_REACTOR_EPOLL)
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = fd;
+    int rc = epoll_ctl(rfd, EPOLL_CTL_ADD, fd, &ev);
+    if (rc != 0 && errno == EEXIST) {
+        rc = epoll_ctl(rfd, EPOLL_CTL_MOD, fd, &ev);
+    }
+    want = NET_REG_READ | NET_REG_WRITE;
+#elif defined(NET_REACTOR_KQUEUE)
+    struct kevent change;
+    int16_t filter = want == NET_REG_WRITE ? EVFILT_WRITE : EVFILT_READ;
+    EV_SET(&change, (uintptr_t)fd, filter, EV_ADD | EV_CLEAR, 0, 0, NULL);
+    int rc = kevent(rfd, &change, 1, NULL, 0, NULL);
+#else
+    int rc = -1;
+    (void)rfd;
+#endif
+    if (rc != 0) {
+        net_reactor_disable();
+        return;
+    }
+    rt_metric_inc(RT_METRIC_NET_REACTOR_REGISTRATIONS);
+    net_reactor_regs[fd].bits = (uint8_t)(have | want);
+}
+
+static void net_reactor_forget(int fd) {
+    // Drops the persistent registration before the fd number can be reused and wakes any task
+    // still parked on it so it observes the close instead of waiting for an event that will
+    // never arrive.
+    if (fd < 0 || atomic_load_explicit(&net_reactor_fd, memory_order_relaxed) < 0) {
+        return;
+    }
+    rt_executor* ex = ensure_exec();
+    rt_lock(ex);
+    if ((size_t)fd < net_reactor_regs_cap) {
+        NetReactorReg* reg = &net_reactor_regs[fd];
+        bool registered = reg->bits != 0;
+        bool wake = registered;
+#if defined(NET_REACTOR_URING)
+        bool io = atomic_load_explicit(&net_uring_io_used, memory_order_relaxed);
+        if (net_reactor_uring || io) {
+            // Also cancels receives and accepts the ring still holds for fd.
+            if (!net_uring_forget(fd, reg->gen, registered && net_reactor_uring)) {
+                net_reactor_uring_fallback(ex);
+            }
+            reg->gen = (reg->gen + 1) & NET_URING_GEN_MASK;
+        }
+        if (registered && !net_reactor_uring) {
+            (void)epoll_ctl(atomic_load_explicit(&net_reactor_fd, memory_order_relaxed),
+                            EPOLL_CTL_DEL,
+                            fd,
+                            NULL);
+        }
+        wake = wake || io;
+#endif
+        // kqueue drops knotes on close(2) by itself.
+        if (wake) {
+            reg->bits = 0;
+            complete_net_waiters(ex, net_read_key(fd));
+            complete_net_waiters(ex, net_accept_key(fd));
+            complete_net_waiters(ex, net_write_key(fd));
+        }
+    }
+    rt_unlock(ex);
+}
+
+static int net_reactor_dispatch(rt_executor* ex, int fd, bool read_ready, bool write_ready) {
+    // Caller holds ex->lock.
+    if (fd == net_poll_wake_read_fd) {
+        net_poll_wake_drain();
+        rt_metric_inc(RT_METRIC_NET_POLL_WAKE_FD);
+        return 1;
+    }
+    int woke = 0;
+    if (read_ready) {
+        rt_metric_inc(RT_METRIC_NET_POLL_READY);
+        complete_net_waiters(ex, net_read_key(fd));
+        complete_net_waiters(ex, net_accept_key(fd));
+        woke = 1;
+    }
+    if (write_ready) {
+        rt_metric_inc(RT_METRIC_NET_POLL_READY);
+        complete_net_waiters(ex, net_write_key(fd));
+        woke = 1;
+    }
+    return woke;
+}
+
+#if defined(NET_REACTOR_URING)
+static int net_reactor_wait_uring(rt_executor* ex, int timeout_ms) {
+    // Caller holds ex->lock and has recorded the poll trace counters.
+    NetUringEvent events[NET_REACTOR_EVENTS];
+    int n = net_uring_wait(ex, timeout_ms, events, NET_REACTOR_EVENTS);
+    if (n < 0) {
+        rt_metric_inc(RT_METRIC_NET_POLL_ERRORS);
+        net_reactor_uring_fallback(ex);
+        return 1;
+    }
+    if (n == 0) {
+        rt_metric_inc(RT_METRIC_NET_POLL_TIMEOUTS);
+        return 0;
+    }
+    rt_metric_add(RT_METRIC_NET_REACTOR_EVENTS, (uint64_t)n);
+    int woke = 0;
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].fd;
+        if (fd != net_poll_wake_read_fd) {
+            if (fd < 0 || (size_t)fd >= net_reactor_regs_cap ||
+                net_reactor_regs[fd].gen != events[i].gen) {
+                // Queued before fd was closed; the number may belong to another socket now.
+                continue;
+            }
+            if (events[i].disarmed) {
+                net_reactor_regs[fd].bits = 0;
+            }
+        }
+        woke |= net_reactor_dispatch(ex, fd, events[i].read_ready, events[i].write_ready);
+    }
+    return woke;
+}
+#endif
+
+static int net_reactor_wait(rt_executor* ex, int timeout_ms) {
+    // Caller must hold ex->lock; this function releases it while waiting. Only fds that
+    // reported readiness are touched, so the cost is O(ready) rather than O(waiters).
+    size_t waiting = net_waiter_count(ex);
+    rt_metric_inc(RT_METRIC_NET_POLL_CALLS);
+    uint64_t requested_timeout_ms = net_trace_timeout_ms(timeout_ms);
+    net_trace_store(&net_poll_timeout_last_ms, requested_timeout_ms);
+    net_trace_max(&net_poll_timeout_max_ms, requested_timeout_ms);
+    net_trace_store(&net_poll_waiters_last, (uint64_t)waiting);
+    net_trace_max(&net_poll_waiters_max, (uint64_t)waiting);
+    rt_metric_add(RT_METRIC_NET_POLL_WAITERS, (uint64_t)waiting);
+
+    int rfd = atomic_load_explicit(&net_reactor_fd, memory_order_relaxed);
+#if defined(NET_REACTOR_URING)
+    if (net_reactor_uring) {
+        return net_reactor_wait_uring(ex, timeout_ms);
+    }
+#endif
+#if defined(NET_REACTOR_EPOLL)
+    struct epoll_event events[NET_REACTOR_EVENTS];
+    rt_unlock(ex);
+    int n = -1;
+    do {
+        n = epoll_wait(rfd, events, NET_REACTOR_EVENTS, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    rt_lock(ex);
+#elif defined(NET_REACTOR_KQUEUE)
+    struct kevent events[NET_REACTOR_EVENTS];
+    struct timespec ts;
+    struct timespec* tsp = NULL;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L; // NOLINT(runtime/int)
+        tsp = &ts;
+    }
+    rt_unlock(ex);
+    int n = -1;
+    do {
+        n = kevent(rfd, NULL, 0, events, NET_REACTOR_EVENTS, tsp);
+    } while (n < 0 && errno == EINTR);
+    rt_lock(ex);
+#else
+    (void)rfd;
+    int n = -1;
+    errno = ENOSYS;
+#endif
+    if (n < 0) {
+        rt_metric_inc(RT_METRIC_NET_POLL_ERRORS);
+        net_reactor_disable();
+        complete_all_net_waiters(ex);
+        return 1;
+    }
+    if (n == 0) {
+        rt_metric_inc(RT_METRIC_NET_POLL_TIMEOUTS);
+        return 0;
+    }
+    rt_metric_add(RT_METRIC_NET_REACTOR_EVENTS, (uint64_t)n);
+    int woke = 0;
+    for (int i = 0; i < n; i++) {
+#if defined(NET_REACTOR_EPOLL)
+        uint32_t revents = events[i].events;
+        bool read_ready = (revents & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) != 0;
+        bool write_ready = (revents & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0;
+        woke |= net_reactor_dispatch(ex, events[i].data.fd, read_ready, write_ready);
+#elif defined(NET_REACTOR_KQUEUE)
+        bool is_write = events[i].filter == EVFILT_WRITE;
+        bool failed = (events[i].flags & EV_ERROR) != 0;
+        woke |= net_reactor_dispatch(
+            ex, (int)events[i].ident, !is_write || failed, is_write || failed);
+#endif
+    }
+    return woke;
+}
+
 static const char* net_error_message(uint64_t code) {
     switch (code) {
         case NET_ERR_WOULD_BLOCK:
@@ -316,6 +748,26 @@ static void* net_make_success_ptr(void* payload) {
     return mem;
 }
 
+// Success(count) results are never written or freed once built, so counts that fit the
+// table are built on first use and handed out again; a racing builder keeps its own copy.
+static void* net_make_success_count(uint64_t count) {
+    if (count >= NET_COUNT_RESULTS) {
+        return net_make_success_ptr(rt_biguint_from_u64(count));
+    }
+    _Atomic(void*)* slot = &net_count_results[count];
+    void* cached = atomic_load_explicit(slot, memory_order_acquire);
+    if (cached != NULL) {
+        return cached;
+    }
+    void* built = net_make_success_ptr(rt_biguint_from_u64(count));
+    if (built != NULL) {
+        void* expected = NULL;
+        atomic_compare_exchange_strong_explicit(
+            slot, &expected, built, memory_order_acq_rel, memory_order_acquire);
+    }
+    return built;
+}
+
 static void* net_make_success_nothing(void) {
     size_t payload_align = alignof(void*);
     size_t payload_size = sizeof(NetError);
@@ -579,6 +1031,7 @@ void* rt_net_close_listener(void* listener) {
     l->closed = true;
     int fd = l->fd;
     l->fd = -1;
+    net_reactor_forget(fd);
     if (close(fd) != 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
@@ -593,21 +1046,104 @@ void* rt_net_close_conn(void* conn) {
     c->closed = true;
     int fd = c->fd;
     c->fd = -1;
+    net_reactor_forget(fd);
     if (close(fd) != 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
     return net_make_success_nothing();
 }
 
+#if defined(NET_REACTOR_URING)
+static rt_executor* net_uring_io_lock(void) {
+    // Returns the locked executor when the ring completes socket I/O, NULL otherwise.
+    if (!atomic_load_explicit(&net_uring_io_used, memory_order_acquire)) {
+        return NULL;
+    }
+    rt_executor* ex = ensure_exec();
+    if (ex != NULL) {
+        rt_lock(ex);
+    }
+    return ex;
+}
+
+static rt_executor* net_uring_io_lock_arm(void) {
+    // Like net_uring_io_lock, but probes the reactor first so the very first call that would
+    // block already leaves its request in the ring. Once epoll is chosen this costs nothing.
+    if (!atomic_load_explicit(&net_uring_io_used, memory_order_acquire) &&
+        atomic_load_explicit(&net_reactor_fd, memory_order_relaxed) >= 0) {
+        return NULL;
+    }
+    rt_executor* ex = ensure_exec();
+    if (ex == NULL) {
+        return NULL;
+    }
+    rt_lock(ex);
+    if (!net_reactor_enabled() || !atomic_load_explicit(&net_uring_io_used, memory_order_relaxed)) {
+        rt_unlock(ex);
+        return NULL;
+    }
+    return ex;
+}
+
+static void net_uring_io_unlock(rt_executor* ex) {
+    int err = errno;
+    rt_unlock(ex);
+    errno = err;
+}
+
+static uint32_t net_reactor_gen(int fd) {
+    // Caller holds ex->lock.
+    return (size_t)fd < net_reactor_regs_cap ? net_reactor_regs[fd].gen : 0;
+}
+
+static void net_uring_io_progress(rt_executor* ex) {
+    // Caller holds ex->lock. Requests are otherwise submitted and reaped only by a waiting
+    // task; a caller that retries without waiting must still see them complete.
+    if (net_reactor_uring) {
+        (void)net_reactor_wait_uring(ex, 0);
+    }
+}
+#endif
+
+// Accepts on fd, taking a connection the io_uring reactor already accepted first. An accept
+// that would block leaves one in the ring.
+static int net_accept_fd(int fd) {
+#if defined(NET_REACTOR_URING)
+    rt_executor* ex = net_uring_io_lock();
+    if (ex != NULL) {
+        int got = net_uring_accept_take(fd, net_reactor_gen(fd));
+        if (got == -1 && errno == EAGAIN) {
+            net_uring_io_progress(ex);
+            got = net_uring_accept_take(fd, net_reactor_gen(fd));
+        }
+        net_uring_io_unlock(ex);
+        if (got != NET_URING_NONE) {
+            return got;
+        }
+    }
+#endif
+    int conn = -1;
+    do {
+        conn = accept(fd, NULL, NULL);
+    } while (conn < 0 && errno == EINTR);
+#if defined(NET_REACTOR_URING)
+    if (conn < 0 && errno == EAGAIN && (ex = net_uring_io_lock_arm()) != NULL) {
+        if (net_reactor_ensure_regs(fd)) {
+            (void)net_uring_accept_arm(fd, net_reactor_gen(fd));
+        }
+        rt_unlock(ex);
+        errno = EAGAIN;
+    }
+#endif
+    return conn;
+}
+
 void* rt_net_accept(const void* listener) {
     const NetListener* l = net_listener_from_borrowed(listener);
     if (l == NULL || l->closed) {
         return net_make_error(NET_ERR_NOT_CONNECTED);
     }
-    int fd = -1;
-    do {
-        fd = accept(l->fd, NULL, NULL);
-    } while (fd < 0 && errno == EINTR);
+    int fd = net_accept_fd(l->fd);
     if (fd < 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
@@ -626,27 +1162,115 @@ void* rt_net_accept(const void* listener) {
     return net_make_success_ptr(conn);
 }
 
+static ssize_t net_read_fd(int fd, uint8_t* buf, uint64_t cap) {
+    ssize_t n = -1;
+    do {
+        n = read(fd, buf, (size_t)cap);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+// Reads fd, taking data the io_uring reactor already received first. A read that would block
+// leaves a receive in the ring, so the waiter is woken with the data rather than readiness.
+static ssize_t net_read_conn(int fd, uint8_t* buf, uint64_t cap) {
+#if defined(NET_REACTOR_URING)
+    rt_executor* ex = net_uring_io_lock();
+    if (ex != NULL) {
+        ssize_t got = net_uring_recv_take(fd, net_reactor_gen(fd), buf, cap);
+        if (got == -1 && errno == EAGAIN) {
+            net_uring_io_progress(ex);
+            got = net_uring_recv_take(fd, net_reactor_gen(fd), buf, cap);
+        }
+        net_uring_io_unlock(ex);
+        if (got != NET_URING_NONE) {
+            return got;
+        }
+    }
+#endif
+    ssize_t n = net_read_fd(fd, buf, cap);
+#if defined(NET_REACTOR_URING)
+    if (n < 0 && errno == EAGAIN && (ex = net_uring_io_lock_arm()) != NULL) {
+        if (net_reactor_ensure_regs(fd)) {
+            (void)net_uring_recv_arm(fd, net_reactor_gen(fd));
+        }
+        rt_unlock(ex);
+        errno = EAGAIN;
+    }
+#endif
+    return n;
+}
+
+// Reports whether a send the io_uring reactor started for fd is still in flight; other
+// writes must not overtake it.
+static bool net_write_pending(int fd) {
+    bool pending = false;
+#if defined(NET_REACTOR_URING)
+    rt_executor* ex = net_uring_io_lock();
+    if (ex != NULL) {
+        uint32_t gen = net_reactor_gen(fd);
+        pending = net_uring_io_state(fd, gen, NET_URING_SEND) == NET_URING_IO_PENDING;
+        if (pending) {
+            net_uring_io_progress(ex);
+            pending = net_uring_io_state(fd, gen, NET_URING_SEND) == NET_URING_IO_PENDING;
+        }
+        rt_unlock(ex);
+    }
+#else
+    (void)fd;
+#endif
+    return pending;
+}
+
+// Writes iov to fd, taking the result of a send the io_uring reactor made for an earlier
+// attempt at the same write first. A write that would block leaves a copy sending in the
+// ring; the writer waits for its completion and learns the outcome when it retries.
+static ssize_t net_write_conn(int fd, const struct iovec* iov, int count) {
+#if defined(NET_REACTOR_URING)
+    rt_executor* ex = net_uring_io_lock();
+    if (ex != NULL) {
+        ssize_t got = net_uring_send_take(fd, net_reactor_gen(fd), iov, count);
+        if (got == -1 && errno == EAGAIN) {
+            net_uring_io_progress(ex);
+            got = net_uring_send_take(fd, net_reactor_gen(fd), iov, count);
+        }
+        net_uring_io_unlock(ex);
+        if (got != NET_URING_NONE) {
+            return got;
+        }
+    }
+#endif
+    ssize_t n = -1;
+    do {
+        n = count == 1 ? write(fd, iov[0].iov_base, iov[0].iov_len) : writev(fd, iov, count);
+    } while (n < 0 && errno == EINTR);
+#if defined(NET_REACTOR_URING)
+    if (n < 0 && errno == EAGAIN && (ex = net_uring_io_lock_arm()) != NULL) {
+        if (net_reactor_ensure_regs(fd)) {
+            (void)net_uring_send_arm(fd, net_reactor_gen(fd), iov, count);
+        }
+        rt_unlock(ex);
+        errno = EAGAIN;
+    }
+#endif
+    return n;
+}
+
 void* rt_net_read(const void* conn, uint8_t* buf, uint64_t cap) {
     const NetConn* c = net_conn_from_borrowed(conn);
     if (c == NULL || c->closed) {
         return net_make_error(NET_ERR_NOT_CONNECTED);
     }
     if (cap == 0) {
-        void* count = rt_biguint_from_u64(0);
-        return net_make_success_ptr(count);
+        return net_make_success_count(0);
     }
     if (buf == NULL || cap > (uint64_t)SSIZE_MAX) {
         return net_make_error(NET_ERR_IO);
     }
-    ssize_t n = -1;
-    do {
-        n = read(c->fd, buf, (size_t)cap);
-    } while (n < 0 && errno == EINTR);
+    ssize_t n = net_read_conn(c->fd, buf, cap);
     if (n < 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
-    void* count = rt_biguint_from_u64((uint64_t)n);
-    return net_make_success_ptr(count);
+    return net_make_success_count((uint64_t)n);
 }
 
 void* rt_net_write(const void* conn, const uint8_t* buf, uint64_t len) {
@@ -655,21 +1279,17 @@ void* rt_net_write(const void* conn, const uint8_t* buf, uint64_t len) {
         return net_make_error(NET_ERR_NOT_CONNECTED);
     }
     if (len == 0) {
-        void* count = rt_biguint_from_u64(0);
-        return net_make_success_ptr(count);
+        return net_make_success_count(0);
     }
     if (buf == NULL || len > (uint64_t)SSIZE_MAX) {
         return net_make_error(NET_ERR_IO);
     }
-    ssize_t n = -1;
-    do {
-        n = write(c->fd, buf, (size_t)len);
-    } while (n < 0 && errno == EINTR);
+    struct iovec iov = {.iov_base = (void*)(uintptr_t)buf, .iov_len = (size_t)len};
+    ssize_t n = net_write_conn(c->fd, &iov, 1);
     if (n < 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
-    void* count = rt_biguint_from_u64((uint64_t)n);
-    return net_make_success_ptr(count);
+    return net_make_success_count((uint64_t)n);
 }
 
 void* rt_net_read_bytes(const void* conn, uint64_t cap) {
@@ -683,14 +1303,27 @@ void* rt_net_read_bytes(const void* conn, uint64_t cap) {
     if (cap > (uint64_t)SSIZE_MAX) {
         return net_make_error(NET_ERR_IO);
     }
+    if (cap <= NET_READ_SCRATCH) {
+        // Short reads are the common case; size the result by what arrived, not by cap.
+        ssize_t n = net_read_conn(c->fd, net_read_scratch, cap);
+        if (n < 0) {
+            return net_make_error(net_error_code_from_errno(errno));
+        }
+        if (n == 0) {
+            return net_make_success_bytes(NULL, 0, 0);
+        }
+        uint8_t* data = (uint8_t*)rt_alloc((uint64_t)n, (uint64_t)alignof(uint8_t));
+        if (data == NULL) {
+            return net_make_error(NET_ERR_IO);
+        }
+        memcpy(data, net_read_scratch, (size_t)n);
+        return net_make_success_bytes(data, (uint64_t)n, (uint64_t)n);
+    }
     uint8_t* data = (uint8_t*)rt_alloc(cap, (uint64_t)alignof(uint8_t));
     if (data == NULL) {
         return net_make_error(NET_ERR_IO);
     }
-    ssize_t n = -1;
-    do {
-        n = read(c->fd, data, (size_t)cap);
-    } while (n < 0 && errno == EINTR);
+    ssize_t n = net_read_conn(c->fd, data, cap);
     if (n < 0) {
         uint64_t code = net_error_code_from_errno(errno);
         rt_free(data, cap, (uint64_t)alignof(uint8_t));
@@ -703,6 +1336,27 @@ void* rt_net_read_bytes(const void* conn, uint64_t cap) {
     return net_make_success_bytes(data, (uint64_t)n, cap);
 }
 
+void* rt_net_read_into(const void* conn, void* array_slot, uint64_t cap) {
+    const NetConn* c = net_conn_from_borrowed(conn);
+    if (c == NULL || c->closed) {
+        return net_make_error(NET_ERR_NOT_CONNECTED);
+    }
+    if (array_slot == NULL || *(void**)array_slot == NULL || cap > (uint64_t)SSIZE_MAX) {
+        return net_make_error(NET_ERR_IO);
+    }
+    if (cap == 0) {
+        return net_make_success_count(0);
+    }
+    rt_byte_array_reserve_spare(array_slot, cap);
+    SurgeArrayHeader* header = *(SurgeArrayHeader**)array_slot;
+    ssize_t n = net_read_conn(c->fd, (uint8_t*)header->data + header->len, cap);
+    if (n < 0) {
+        return net_make_error(net_error_code_from_errno(errno));
+    }
+    header->len += (uint64_t)n;
+    return net_make_success_count((uint64_t)n);
+}
+
 void* rt_net_write_bytes(const void* conn, const void* bytes, uint64_t offset, uint64_t len) {
     const NetConn* c = net_conn_from_borrowed(conn);
     if (c == NULL || c->closed) {
@@ -714,22 +1368,129 @@ void* rt_net_write_bytes(const void* conn, const void* bytes, uint64_t offset, u
         return net_make_error(NET_ERR_IO);
     }
     if (len == 0) {
-        void* count = rt_biguint_from_u64(0);
-        return net_make_success_ptr(count);
+        return net_make_success_count(0);
     }
     const uint8_t* data = (const uint8_t*)header->data;
     if (data == NULL) {
         return net_make_error(NET_ERR_IO);
     }
+    struct iovec iov = {.iov_base = (void*)(uintptr_t)(data + offset), .iov_len = (size_t)len};
+    ssize_t n = net_write_conn(c->fd, &iov, 1);
+    if (n < 0) {
+        return net_make_error(net_error_code_from_errno(errno));
+    }
+    return net_make_success_count((uint64_t)n);
+}
+
+void* rt_net_write_vectored(const void* conn, const void* parts, uint64_t offset) {
+    const NetConn* c = net_conn_from_borrowed(conn);
+    if (c == NULL || c->closed) {
+        return net_make_error(NET_ERR_NOT_CONNECTED);
+    }
+    const SurgeArrayHeader* list = (const SurgeArrayHeader*)parts;
+    if (list == NULL || (list->len > 0 && list->data == NULL)) {
+        return net_make_error(NET_ERR_IO);
+    }
+    // Skip the first offset bytes of the concatenation, then gather what follows.
+    const SurgeArrayHeader* const* items = (const SurgeArrayHeader* const*)list->data;
+    struct iovec iov[NET_WRITE_PARTS];
+    int count = 0;
+    uint64_t skip = offset;
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < list->len && count < NET_WRITE_PARTS; i++) {
+        const SurgeArrayHeader* part = items[i];
+        if (part == NULL || part->len == 0) {
+            continue;
+        }
+        if (part->data == NULL) {
+            return net_make_error(NET_ERR_IO);
+        }
+        if (skip >= part->len) {
+            skip -= part->len;
+            continue;
+        }
+        uint64_t len = part->len - skip;
+        if (len > (uint64_t)SSIZE_MAX - total) {
+            len = (uint64_t)SSIZE_MAX - total;
+        }
+        iov[count].iov_base = (uint8_t*)part->data + skip;
+        iov[count].iov_len = (size_t)len;
+        count++;
+        skip = 0;
+        total += len;
+        if (total == (uint64_t)SSIZE_MAX) {
+            break;
+        }
+    }
+    if (skip > 0) {
+        return net_make_error(NET_ERR_IO);
+    }
+    if (count == 0) {
+        return net_make_success_count(0);
+    }
+    ssize_t n = net_write_conn(c->fd, iov, count);
+    if (n < 0) {
+        return net_make_error(net_error_code_from_errno(errno));
+    }
+    return net_make_success_count((uint64_t)n);
+}
+
+// Copies a file range through the per-thread read buffer; used where sendfile is missing
+// or refuses the descriptor pair.
+static ssize_t net_send_file_copy(int sock, int fd, uint64_t offset, uint64_t len) {
+    if (offset > (uint64_t)INT64_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t chunk = len < NET_READ_SCRATCH ? (size_t)len : (size_t)NET_READ_SCRATCH;
+    ssize_t got = -1;
+    do {
+        got = pread(fd, net_read_scratch, chunk, (off_t)offset);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        return got;
+    }
     ssize_t n = -1;
     do {
-        n = write(c->fd, data + offset, (size_t)len);
+        n = write(sock, net_read_scratch, (size_t)got);
     } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+void* rt_net_send_file(const void* conn, const void* file, uint64_t offset, uint64_t len) {
+    const NetConn* c = net_conn_from_borrowed(conn);
+    if (c == NULL || c->closed) {
+        return net_make_error(NET_ERR_NOT_CONNECTED);
+    }
+    int fd = rt_fs_file_fd(file);
+    if (fd < 0 || offset > (uint64_t)INT64_MAX) {
+        return net_make_error(NET_ERR_IO);
+    }
+    if (len == 0) {
+        return net_make_success_count(0);
+    }
+    if (len > (uint64_t)SSIZE_MAX) {
+        len = (uint64_t)SSIZE_MAX;
+    }
+    if (net_write_pending(c->fd)) {
+        return net_make_error(net_error_code_from_errno(EAGAIN));
+    }
+    ssize_t n = -1;
+#if defined(__linux__)
+    off_t pos = (off_t)offset;
+    do {
+        n = sendfile(c->fd, fd, &pos, (size_t)len);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && (errno == EINVAL || errno == ENOSYS)) {
+        n = net_send_file_copy(c->fd, fd, offset, len);
+    }
+#else
+    n = net_send_file_copy(c->fd, fd, offset, len);
+#endif
     if (n < 0) {
         return net_make_error(net_error_code_from_errno(errno));
     }
-    void* count = rt_biguint_from_u64((uint64_t)n);
-    return net_make_success_ptr(count);
+    return net_make_success_count((uint64_t)n);
 }
 
 static bool net_fd_ready_now(int fd, NetWaitKind kind) {
@@ -756,6 +1517,19 @@ static bool net_fd_ready_now(int fd, NetWaitKind kind) {
     return (pfd.revents & ready_mask) != 0;
 }
 
+#if defined(NET_REACTOR_URING)
+static NetUringIoKind net_uring_io_kind(NetWaitKind kind) {
+    switch (kind) {
+        case NET_WAIT_ACCEPT:
+            return NET_URING_ACCEPT;
+        case NET_WAIT_WRITE:
+            return NET_URING_SEND;
+        default:
+            return NET_URING_RECV;
+    }
+}
+#endif
+
 static bool net_wait_current_task(int fd, NetWaitKind kind) {
     rt_executor* ex = ensure_exec();
     if (ex == NULL) {
@@ -773,9 +1547,26 @@ static bool net_wait_current_task(int fd, NetWaitKind kind) {
         rt_unlock(ex);
         return false;
     }
-    if (fd < 0 || net_fd_ready_now(fd, kind)) {
-        rt_unlock(ex);
-        return true;
+    bool in_flight = false;
+#if defined(NET_REACTOR_URING)
+    if (fd >= 0 && atomic_load_explicit(&net_uring_io_used, memory_order_relaxed)) {
+        NetUringIoState state =
+            net_uring_io_state(fd, net_reactor_gen(fd), net_uring_io_kind(kind));
+        if (state == NET_URING_IO_READY) {
+            rt_unlock(ex);
+            return true;
+        }
+        // The completion wakes this waiter. Readiness is not checked: the bytes it would
+        // report already belong to the request in the ring.
+        in_flight = state == NET_URING_IO_PENDING;
+    }
+#endif
+    if (!in_flight) {
+        net_reactor_watch(ex, fd, kind);
+        if (fd < 0 || net_fd_ready_now(fd, kind)) {
+            rt_unlock(ex);
+            return true;
+        }
     }
     waker_key key;
     switch (kind) {
@@ -796,7 +1587,7 @@ static bool net_wait_current_task(int fd, NetWaitKind kind) {
         rt_unlock(ex);
         return true;
     }
-    net_trace_inc(&net_direct_wait_total);
+    rt_metric_inc(RT_METRIC_NET_DIRECT_WAIT);
     prepare_park(ex, task, key, 0);
     pending_key = key;
     rt_unlock(ex);
@@ -830,34 +1621,27 @@ bool rt_net_wait_writable(const void* conn) {
     return net_wait_current_task(fd, NET_WAIT_WRITE);
 }
 
-int poll_net_waiters(rt_executor* ex, int timeout_ms) {
-    // Caller must hold ex->lock; this function releases it while polling.
-    if (ex == NULL || ex->waiters_len == 0) {
-        return 0;
-    }
-    size_t cap = ex->waiters_len;
+static int net_poll_waiters_poll(rt_executor* ex, int timeout_ms) {
+    // Portable fallback: rebuilds the pollfd set from the parked net waiters on every call.
+    size_t cap = net_waiter_count(ex);
     NetPollFd* fds =
         (NetPollFd*)rt_alloc((uint64_t)cap * (uint64_t)sizeof(NetPollFd), _Alignof(NetPollFd));
     if (fds == NULL) {
         return 0;
     }
-    net_trace_inc(&net_poll_allocs_total);
-    net_trace_add(&net_waiter_scan_entries_total, ex->waiters_len);
+    rt_metric_inc(RT_METRIC_NET_POLL_ALLOCS);
     size_t count = 0;
-    for (size_t i = 0; i < ex->waiters_len; i++) {
-        waiter w = ex->waiters[i];
-        uint8_t kind = w.key.kind;
-        if (kind != WAKER_NET_ACCEPT && kind != WAKER_NET_READ && kind != WAKER_NET_WRITE) {
-            continue;
-        }
-        net_trace_inc(&net_waiter_net_entries_total);
-        int fd = (int)w.key.id;
+    for (const rt_wait_queue* q = ex->net_wait_queues; q != NULL; q = q->net_next) {
+        rt_metric_inc(RT_METRIC_NET_WAITER_SCAN_ENTRIES);
+        rt_metric_inc(RT_METRIC_NET_WAITER_NET_ENTRIES);
+        uint8_t kind = q->key.kind;
+        int fd = (int)q->key.id;
         if (fd <= 0) {
             continue;
         }
         size_t idx = count;
         for (size_t j = 0; j < count; j++) {
-            net_trace_inc(&net_poll_dedup_checks_total);
+            rt_metric_inc(RT_METRIC_NET_POLL_DEDUP_CHECKS);
             if (fds[j].fd == fd) {
                 idx = j;
                 break;
@@ -890,15 +1674,15 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
         rt_free((uint8_t*)fds, (uint64_t)cap * (uint64_t)sizeof(NetPollFd), _Alignof(NetPollFd));
         return 0;
     }
-    net_trace_inc(&net_poll_allocs_total);
-    net_trace_inc(&net_poll_rebuilds_total);
-    net_trace_inc(&net_poll_calls_total);
+    rt_metric_inc(RT_METRIC_NET_POLL_ALLOCS);
+    rt_metric_inc(RT_METRIC_NET_POLL_REBUILDS);
+    rt_metric_inc(RT_METRIC_NET_POLL_CALLS);
     uint64_t requested_timeout_ms = net_trace_timeout_ms(timeout_ms);
     net_trace_store(&net_poll_timeout_last_ms, requested_timeout_ms);
     net_trace_max(&net_poll_timeout_max_ms, requested_timeout_ms);
     net_trace_store(&net_poll_waiters_last, (uint64_t)count);
     net_trace_max(&net_poll_waiters_max, (uint64_t)count);
-    net_trace_add(&net_poll_waiters_total, (uint64_t)count);
+    rt_metric_add(RT_METRIC_NET_POLL_WAITERS, (uint64_t)count);
 
     size_t offset = 0;
     if (wake_fd >= 0) {
@@ -928,7 +1712,7 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
     } while (n < 0 && errno == EINTR);
     rt_lock(ex);
     if (n < 0) {
-        net_trace_inc(&net_poll_errors_total);
+        rt_metric_inc(RT_METRIC_NET_POLL_ERRORS);
         for (size_t i = 0; i < count; i++) {
             if (fds[i].want_read) {
                 complete_net_waiters(ex, net_read_key(fds[i].fd));
@@ -945,7 +1729,7 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
         return 1;
     }
     if (n == 0) {
-        net_trace_inc(&net_poll_timeouts_total);
+        rt_metric_inc(RT_METRIC_NET_POLL_TIMEOUTS);
         rt_free((uint8_t*)pfds,
                 (uint64_t)poll_count * (uint64_t)sizeof(struct pollfd),
                 _Alignof(struct pollfd));
@@ -956,7 +1740,7 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
     int woke = 0;
     if (wake_fd >= 0 && pfds[0].revents != 0) {
         net_poll_wake_drain();
-        net_trace_inc(&net_poll_wake_fd_total);
+        rt_metric_inc(RT_METRIC_NET_POLL_WAKE_FD);
         woke = 1;
     }
     for (size_t i = 0; i < count; i++) {
@@ -967,13 +1751,13 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
         bool read_ready = (pfds[poll_idx].revents & (POLLIN | POLLERR | POLLHUP)) != 0;
         bool write_ready = (pfds[poll_idx].revents & (POLLOUT | POLLERR | POLLHUP)) != 0;
         if (read_ready) {
-            net_trace_inc(&net_poll_ready_total);
+            rt_metric_inc(RT_METRIC_NET_POLL_READY);
             complete_net_waiters(ex, net_read_key(fds[i].fd));
             complete_net_waiters(ex, net_accept_key(fds[i].fd));
             woke = 1;
         }
         if (write_ready) {
-            net_trace_inc(&net_poll_ready_total);
+            rt_metric_inc(RT_METRIC_NET_POLL_READY);
             complete_net_waiters(ex, net_write_key(fds[i].fd));
             woke = 1;
         }
@@ -985,3 +1769,23 @@ int poll_net_waiters(rt_executor* ex, int timeout_ms) {
     rt_free((uint8_t*)fds, (uint64_t)cap * (uint64_t)sizeof(NetPollFd), _Alignof(NetPollFd));
     return woke;
 }
+
+int poll_net_waiters(rt_executor* ex, int timeout_ms) {
+    // Caller must hold ex->lock; this function releases it while polling.
+    if (ex == NULL || !has_net_waiters(ex)) {
+        return 0;
+    }
+    if (net_reactor_enabled()) {
+        return net_reactor_wait(ex, timeout_ms);
+    }
+    return net_poll_waiters_poll(ex, timeout_ms);
+}
+
+void rt_net_poll_set_changed(void) {
+    // The poll() fallback snapshots the waiter set, so a new park must interrupt it. Reactor
+    // registrations are live in the kernel and need no wakeup.
+    if (net_backend == NET_BACKEND_REACTOR) {
+        return;
+    }
+    rt_net_wake_poll();
+}
@@ -0,0 +1,1002 @@
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
+#include "rt_net_uring_linux.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define NET_URING_AVAILABLE 1
+#endif
+#endif
+
+#if defined(NET_URING_AVAILABLE) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+
+#if __has_include(<linux/version.h>)
+#include <linux/version.h>
+#endif
+#if defined(LINUX_VERSION_CODE) && defined(KERNEL_VERSION) && defined(__NR_io_uring_register)
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0)
+// 5.19 headers are the first to describe provided-buffer rings. Whether the running kernel
+// has them is only known once net_uring_create tries to register one.
+#define NET_URING_IO 1
+#endif
+#endif
+
+#ifndef POLLRDHUP
+// <poll.h> only names it under _GNU_SOURCE; the kernel value is the same on every arch.
+#define POLLRDHUP 0x2000
+#endif
+
+enum {
+    NET_URING_ENTRIES = 256,
+    NET_URING_CQ_ENTRIES = 4096,
+    // user_data carries the fd in the low 32 bits, the owner's generation above it and the
+    // request kind in the top byte.
+    NET_URING_GEN_SHIFT = 32,
+    NET_URING_TAG_SHIFT = 56,
+    NET_URING_TAG_POLL = 1,
+    NET_URING_TAG_REMOVE = 2,
+    // Receive, send and accept requests carry their NetUringOp index instead of the fd.
+    NET_URING_TAG_OP = 3,
+    NET_URING_TAG_CANCEL = 4,
+    NET_URING_SUBMIT_RETRIES = 64,
+};
+
+typedef struct NetUring {
+    int fd;
+    int wake_fd;
+    uint32_t sq_mask;
+    uint32_t sq_entries;
+    _Atomic uint32_t* sq_head;
+    _Atomic uint32_t* sq_tail;
+    uint32_t* sq_array;
+    struct io_uring_sqe* sqes;
+    uint32_t cq_mask;
+    _Atomic uint32_t* cq_head;
+    _Atomic uint32_t* cq_tail;
+    struct io_uring_cqe* cqes;
+    void* ring_mem;
+    size_t ring_size;
+    void* sqe_mem;
+    size_t sqe_size;
+    // Threads currently blocked in io_uring_enter; registrations made meanwhile are
+    // submitted right away instead of waiting for the next wait call.
+    int blocked;
+} NetUring;
+
+static NetUring net_uring = {.fd = -1, .wake_fd = -1};
+static _Atomic uint64_t net_uring_enters_total;
+
+#if defined(NET_URING_IO)
+enum {
+    NET_URING_OPS = 1024,
+    NET_URING_BUFS = 256,
+    NET_URING_BUF_SIZE = 16384,
+    NET_URING_BUF_GROUP = 0,
+    NET_URING_SEND_MAX = 65536,
+};
+
+typedef struct NetUringOp {
+    uint8_t kind;
+    bool inflight;
+    // The fd was forgotten; the completion only releases what the request holds.
+    bool orphan;
+    bool has_buf;
+    uint16_t bid;
+    int fd;
+    uint32_t gen;
+    // Completion result: bytes received, accepted fd, or -errno.
+    int32_t res;
+    // Receive: bytes already copied out. Send: bytes the kernel has taken.
+    uint32_t off;
+    uint32_t len;
+    uint8_t* data;
+    uint32_t next_free;
+} NetUringOp;
+
+typedef struct NetUringFd {
+    uint32_t gen;
+    // NetUringOp indexes; 0 means none.
+    uint32_t recv;
+    uint32_t send;
+    uint32_t accept;
+} NetUringFd;
+
+// Request state lives apart from NetUring so it survives net_uring_destroy: receives that
+// completed before the ring went away are still handed out.
+typedef struct NetUringIo {
+    bool enabled;
+    uint32_t free_head;
+    uint32_t free_next;
+    NetUringOp ops[NET_URING_OPS];
+    NetUringFd* fds;
+    size_t fds_cap;
+    struct io_uring_buf* buf_ring;
+    _Atomic uint16_t* buf_tail;
+    uint16_t buf_next;
+    uint8_t* bufs;
+} NetUringIo;
+
+static NetUringIo net_uring_io;
+#endif
+
+static int net_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int net_uring_enter(
+    unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg, size_t arg_size) {
+    return (int)syscall(
+        __NR_io_uring_enter, net_uring.fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static uint32_t net_uring_unsubmitted(void) {
+    // Entries the kernel has not consumed yet; it advances sq_head as it submits.
+    uint32_t head = atomic_load_explicit(net_uring.sq_head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(net_uring.sq_tail, memory_order_relaxed);
+    return tail - head;
+}
+
+static int net_uring_submit(void) {
+    uint32_t pending = net_uring_unsubmitted();
+    if (pending == 0) {
+        return 0;
+    }
+    int rc = -1;
+    do {
+        rc = net_uring_enter(pending, 0, 0, NULL, 0);
+    } while (rc < 0 && errno == EINTR);
+    if (rc >= 0) {
+        (void)atomic_fetch_add_explicit(&net_uring_enters_total, 1, memory_order_relaxed);
+    }
+    return rc;
+}
+
+static bool net_uring_flush(void) {
+    // Submits until the kernel has consumed every queued entry. EAGAIN and EBUSY mean the
+    // kernel is short of memory or completion space for now, so they are retried a bounded
+    // number of times; anything else leaves the ring unusable.
+    for (int attempt = 0; net_uring_unsubmitted() > 0; attempt++) {
+        if (net_uring_submit() >= 0) {
+            attempt = 0;
+            continue;
+        }
+        if ((errno != EAGAIN && errno != EBUSY) || attempt >= NET_URING_SUBMIT_RETRIES) {
+            return false;
+        }
+        (void)sched_yield();
+    }
+    return true;
+}
+
+static struct io_uring_sqe* net_uring_next_sqe(void) {
+    if (net_uring_unsubmitted() >= net_uring.sq_entries && !net_uring_flush()) {
+        return NULL;
+    }
+    uint32_t tail = atomic_load_explicit(net_uring.sq_tail, memory_order_relaxed);
+    uint32_t idx = tail & net_uring.sq_mask;
+    struct io_uring_sqe* sqe = &net_uring.sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    net_uring.sq_array[idx] = idx;
+    return sqe;
+}
+
+static void net_uring_commit_sqe(void) {
+    uint32_t tail = atomic_load_explicit(net_uring.sq_tail, memory_order_relaxed);
+    atomic_store_explicit(net_uring.sq_tail, tail + 1, memory_order_release);
+}
+
+static uint64_t net_uring_user_data(int fd, uint32_t gen, uint64_t tag) {
+    return (tag << NET_URING_TAG_SHIFT) |
+           ((uint64_t)(gen & NET_URING_GEN_MASK) << NET_URING_GEN_SHIFT) | (uint64_t)(uint32_t)fd;
+}
+
+static bool net_uring_queue_poll(int fd, uint32_t gen) {
+    struct io_uring_sqe* sqe = net_uring_next_sqe();
+    if (sqe == NULL) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    // Multishot polls are edge-triggered unless IORING_POLL_ADD_LEVEL is set, matching the
+    // EPOLLET registrations of the epoll reactor.
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN | POLLOUT | POLLRDHUP;
+    sqe->user_data = net_uring_user_data(fd, gen, NET_URING_TAG_POLL);
+    net_uring_commit_sqe();
+    return true;
+}
+
+#if defined(NET_URING_IO)
+static int net_uring_register(unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, net_uring.fd, opcode, arg, nr_args);
+}
+
+static void net_uring_buf_recycle(uint16_t bid) {
+    // The tail shares bufs[0].resv, so entries are filled field by field.
+    struct io_uring_buf* buf = &net_uring_io.buf_ring[net_uring_io.buf_next & (NET_URING_BUFS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(net_uring_io.bufs + (size_t)bid * NET_URING_BUF_SIZE);
+    buf->len = NET_URING_BUF_SIZE;
+    buf->bid = bid;
+    net_uring_io.buf_next++;
+    atomic_store_explicit(net_uring_io.buf_tail, net_uring_io.buf_next, memory_order_release);
+}
+
+static void net_uring_io_setup(void) {
+    // Completion I/O needs a provided-buffer ring so idle receives do not pin a buffer each.
+    // Without one the ring stays a readiness backend.
+    if (net_uring_io.bufs == NULL) {
+        size_t ring_size = NET_URING_BUFS * sizeof(struct io_uring_buf);
+        size_t bufs_size = (size_t)NET_URING_BUFS * NET_URING_BUF_SIZE;
+        void* ring = mmap(
+            NULL, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void* bufs = mmap(
+            NULL, bufs_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED || bufs == MAP_FAILED) {
+            if (ring != MAP_FAILED) {
+                (void)munmap(ring, ring_size);
+            }
+            if (bufs != MAP_FAILED) {
+                (void)munmap(bufs, bufs_size);
+            }
+            return;
+        }
+        net_uring_io.buf_ring = (struct io_uring_buf*)ring;
+        size_t tail_off = offsetof(struct io_uring_buf_ring, tail);
+        net_uring_io.buf_tail = (_Atomic uint16_t*)(void*)((uint8_t*)ring + tail_off);
+        net_uring_io.bufs = (uint8_t*)bufs;
+        for (uint16_t bid = 0; bid < NET_URING_BUFS; bid++) {
+            net_uring_buf_recycle(bid);
+        }
+    }
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)net_uring_io.buf_ring;
+    reg.ring_entries = NET_URING_BUFS;
+    reg.bgid = NET_URING_BUF_GROUP;
+    net_uring_io.enabled = net_uring_register(IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+}
+
+static NetUringFd* net_uring_io_fd(int fd, uint32_t gen, bool create) {
+    if (fd < 0) {
+        return NULL;
+    }
+    size_t want = (size_t)fd + 1;
+    if (want > net_uring_io.fds_cap) {
+        if (!create) {
+            return NULL;
+        }
+        size_t next_cap = net_uring_io.fds_cap == 0 ? 256 : net_uring_io.fds_cap;
+        while (next_cap < want) {
+            next_cap *= 2;
+        }
+        NetUringFd* next = rt_realloc((uint8_t*)net_uring_io.fds,
+                                      (uint64_t)(net_uring_io.fds_cap * sizeof(NetUringFd)),
+                                      (uint64_t)(next_cap * sizeof(NetUringFd)),
+                                      _Alignof(NetUringFd));
+        if (next == NULL) {
+            return NULL;
+        }
+        memset(next + net_uring_io.fds_cap,
+               0,
+               (next_cap - net_uring_io.fds_cap) * sizeof(NetUringFd));
+        net_uring_io.fds = next;
+        net_uring_io.fds_cap = next_cap;
+    }
+    NetUringFd* st = &net_uring_io.fds[fd];
+    if (st->gen != gen) {
+        // The previous owner's forget already released its requests.
+        memset(st, 0, sizeof(*st));
+        st->gen = gen;
+    }
+    return st;
+}
+
+static uint32_t net_uring_op_alloc(NetUringIoKind kind, int fd, uint32_t gen) {
+    uint32_t id = net_uring_io.free_head;
+    if (id != 0) {
+        net_uring_io.free_head = net_uring_io.ops[id].next_free;
+    } else {
+        // Index 0 stands for "no request" in NetUringFd.
+        if (net_uring_io.free_next == 0) {
+            net_uring_io.free_next = 1;
+        }
+        if (net_uring_io.free_next >= NET_URING_OPS) {
+            return 0;
+        }
+        id = net_uring_io.free_next++;
+    }
+    NetUringOp* op = &net_uring_io.ops[id];
+    memset(op, 0, sizeof(*op));
+    op->kind = (uint8_t)kind;
+    op->fd = fd;
+    op->gen = gen;
+    return id;
+}
+
+static void net_uring_op_release(uint32_t id) {
+    NetUringOp* op = &net_uring_io.ops[id];
+    if (op->has_buf) {
+        net_uring_buf_recycle(op->bid);
+    }
+    if (op->data != NULL) {
+        rt_free(op->data, op->len, 1);
+    }
+    memset(op, 0, sizeof(*op));
+    op->next_free = net_uring_io.free_head;
+    net_uring_io.free_head = id;
+}
+
+static uint64_t net_uring_op_user_data(uint32_t id) {
+    return ((uint64_t)NET_URING_TAG_OP << NET_URING_TAG_SHIFT) | id;
+}
+
+static bool net_uring_op_queue(uint32_t id) {
+    NetUringOp* op = &net_uring_io.ops[id];
+    struct io_uring_sqe* sqe = net_uring_next_sqe();
+    if (sqe == NULL) {
+        return false;
+    }
+    sqe->fd = op->fd;
+    sqe->user_data = net_uring_op_user_data(id);
+    switch ((NetUringIoKind)op->kind) {
+        case NET_URING_RECV:
+            sqe->opcode = IORING_OP_RECV;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = NET_URING_BUF_GROUP;
+            sqe->len = NET_URING_BUF_SIZE;
+            break;
+        case NET_URING_SEND:
+            sqe->opcode = IORING_OP_SEND;
+            sqe->addr = (uint64_t)(uintptr_t)(op->data + op->off);
+            sqe->len = op->len - op->off;
+            sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+            break;
+        case NET_URING_ACCEPT:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+            break;
+        default:
+            break;
+    }
+    net_uring_commit_sqe();
+    op->inflight = true;
+    return true;
+}
+
+static bool net_uring_op_complete(uint32_t id, int32_t res, uint32_t flags, NetUringEvent* ev) {
+    // Records a completion and reports whether it produced an event for the owner's waiters.
+    if (id == 0 || id >= NET_URING_OPS || !net_uring_io.ops[id].inflight) {
+        return false;
+    }
+    NetUringOp* op = &net_uring_io.ops[id];
+    op->inflight = false;
+    op->res = res;
+    if ((flags & IORING_CQE_F_BUFFER) != 0) {
+        op->has_buf = true;
+        op->bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+    int fd = op->fd;
+    uint32_t gen = op->gen;
+    bool orphan = op->orphan;
+    bool write = op->kind == NET_URING_SEND;
+    if (write && res > 0) {
+        op->off += (uint32_t)res;
+        // MSG_WAITALL sends come back short only on signals or errors; the rest is sent
+        // again while the fd still belongs to the writer.
+        if (!orphan && op->off < op->len && net_uring_op_queue(id)) {
+            return false;
+        }
+    }
+    if (orphan) {
+        if (op->kind == NET_URING_ACCEPT && res >= 0) {
+            close(res);
+        }
+        net_uring_op_release(id);
+        return false;
+    }
+    if (ev == NULL) {
+        return false;
+    }
+    ev->fd = fd;
+    ev->gen = gen;
+    ev->read_ready = !write;
+    ev->write_ready = write;
+    ev->disarmed = false;
+    return true;
+}
+
+static bool net_uring_op_cancel(uint32_t id) {
+    struct io_uring_sqe* sqe = net_uring_next_sqe();
+    if (sqe == NULL) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = net_uring_op_user_data(id);
+    sqe->user_data = (uint64_t)NET_URING_TAG_CANCEL << NET_URING_TAG_SHIFT;
+    net_uring_commit_sqe();
+    return true;
+}
+
+static bool net_uring_io_forget(NetUringFd* st) {
+    bool ok = true;
+    uint32_t ids[3] = {st->recv, st->send, st->accept};
+    for (int i = 0; i < 3; i++) {
+        uint32_t id = ids[i];
+        if (id == 0) {
+            continue;
+        }
+        NetUringOp* op = &net_uring_io.ops[id];
+        if (op->inflight) {
+            op->orphan = true;
+            ok = net_uring_op_cancel(id) && ok;
+            continue;
+        }
+        if (op->kind == NET_URING_ACCEPT && op->res >= 0) {
+            close(op->res);
+        }
+        net_uring_op_release(id);
+    }
+    st->recv = 0;
+    st->send = 0;
+    st->accept = 0;
+    return ok;
+}
+
+static void net_uring_io_teardown(void) {
+    // Closing the ring cancels what is still in flight. A send may still be reading its copy
+    // while the ring winds down, so that copy is leaked rather than freed; its writer sees EIO.
+    for (uint32_t id = 1; id < net_uring_io.free_next; id++) {
+        NetUringOp* op = &net_uring_io.ops[id];
+        if (!op->inflight) {
+            continue;
+        }
+        NetUringFd* st = op->orphan ? NULL : net_uring_io_fd(op->fd, op->gen, false);
+        if (op->kind == NET_URING_SEND) {
+            op->data = NULL;
+            if (st != NULL) {
+                op->inflight = false;
+                op->res = -EIO;
+                op->off = 0;
+                continue;
+            }
+        } else if (st != NULL) {
+            if (op->kind == NET_URING_RECV) {
+                st->recv = 0;
+            } else {
+                st->accept = 0;
+            }
+        }
+        net_uring_op_release(id);
+    }
+    net_uring_io.enabled = false;
+}
+
+static bool net_uring_io_start(uint32_t* slot, uint32_t id) {
+    if (!net_uring_op_queue(id)) {
+        net_uring_op_release(id);
+        return false;
+    }
+    *slot = id;
+    // Otherwise the request goes out with the next wait, batched with the other arms.
+    if (net_uring.blocked > 0) {
+        (void)net_uring_submit();
+    }
+    return true;
+}
+
+static bool net_uring_io_arm(int fd, uint32_t gen, NetUringIoKind kind) {
+    if (!net_uring_io.enabled || net_uring.fd < 0) {
+        return false;
+    }
+    NetUringFd* st = net_uring_io_fd(fd, gen, true);
+    if (st == NULL) {
+        return false;
+    }
+    uint32_t* slot = kind == NET_URING_RECV ? &st->recv : &st->accept;
+    if (*slot != 0) {
+        return true;
+    }
+    uint32_t id = net_uring_op_alloc(kind, fd, gen);
+    return id != 0 && net_uring_io_start(slot, id);
+}
+#endif
+
+static void net_uring_unmap(void) {
+    if (net_uring.sqe_mem != NULL && net_uring.sqe_mem != MAP_FAILED) {
+        (void)munmap(net_uring.sqe_mem, net_uring.sqe_size);
+    }
+    if (net_uring.ring_mem != NULL && net_uring.ring_mem != MAP_FAILED) {
+        (void)munmap(net_uring.ring_mem, net_uring.ring_size);
+    }
+    if (net_uring.fd >= 0) {
+        close(net_uring.fd);
+    }
+    memset(&net_uring, 0, sizeof(net_uring));
+    net_uring.fd = -1;
+    net_uring.wake_fd = -1;
+}
+
+int net_uring_create(int wake_fd) {
+    if (net_uring.fd >= 0) {
+        return net_uring.fd;
+    }
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = NET_URING_CQ_ENTRIES;
+    int fd = net_uring_setup(NET_URING_ENTRIES, &params);
+    if (fd < 0) {
+        return -1;
+    }
+    net_uring.fd = fd;
+    // Timed waits need EXT_ARG; NODROP keeps multishot completions from being lost when the
+    // completion ring fills up between waits.
+    uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        net_uring_unmap();
+        return -1;
+    }
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    net_uring.ring_size = sq_size > cq_size ? sq_size : cq_size;
+    net_uring.ring_mem = mmap(NULL,
+                              net_uring.ring_size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE,
+                              fd,
+                              IORING_OFF_SQ_RING);
+    net_uring.sqe_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    net_uring.sqe_mem = mmap(NULL,
+                             net_uring.sqe_size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             fd,
+                             IORING_OFF_SQES);
+    if (net_uring.ring_mem == MAP_FAILED || net_uring.sqe_mem == MAP_FAILED) {
+        net_uring_unmap();
+        return -1;
+    }
+    uint8_t* ring = (uint8_t*)net_uring.ring_mem;
+    net_uring.sq_head = (_Atomic uint32_t*)(void*)(ring + params.sq_off.head);
+    net_uring.sq_tail = (_Atomic uint32_t*)(void*)(ring + params.sq_off.tail);
+    net_uring.sq_mask = *(const uint32_t*)(const void*)(ring + params.sq_off.ring_mask);
+    net_uring.sq_entries = params.sq_entries;
+    net_uring.sq_array = (uint32_t*)(void*)(ring + params.sq_off.array);
+    net_uring.sqes = (struct io_uring_sqe*)net_uring.sqe_mem;
+    net_uring.cq_head = (_Atomic uint32_t*)(void*)(ring + params.cq_off.head);
+    net_uring.cq_tail = (_Atomic uint32_t*)(void*)(ring + params.cq_off.tail);
+    net_uring.cq_mask = *(const uint32_t*)(const void*)(ring + params.cq_off.ring_mask);
+    net_uring.cqes = (struct io_uring_cqe*)(void*)(ring + params.cq_off.cqes);
+    net_uring.wake_fd = wake_fd;
+    if (wake_fd >= 0 && (!net_uring_queue_poll(wake_fd, 0) || net_uring_submit() < 0)) {
+        net_uring_unmap();
+        return -1;
+    }
+#if defined(NET_URING_IO)
+    net_uring_io_setup();
+#endif
+    return fd;
+}
+
+bool net_uring_watch(int fd, uint32_t gen) {
+    if (net_uring.fd < 0 || fd < 0 || !net_uring_queue_poll(fd, gen)) {
+        return false;
+    }
+    // A blocked waiter would not see the new poll until something else woke it.
+    if (net_uring.blocked > 0 && net_uring_submit() < 0) {
+        return false;
+    }
+    return true;
+}
+
+static int net_uring_reap(NetUringEvent* events, int max_events) {
+    // With events == NULL every completion is consumed and readiness is dropped; used on
+    // teardown.
+    uint32_t head = atomic_load_explicit(net_uring.cq_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(net_uring.cq_tail, memory_order_acquire);
+    int n = 0;
+    bool rearm_wake = false;
+    while (head != tail && (events == NULL || n < max_events)) {
+        const struct io_uring_cqe* cqe = &net_uring.cqes[head & net_uring.cq_mask];
+        head++;
+        uint64_t tag = cqe->user_data >> NET_URING_TAG_SHIFT;
+#if defined(NET_URING_IO)
+        if (tag == NET_URING_TAG_OP) {
+            NetUringEvent* ev = events != NULL ? &events[n] : NULL;
+            if (net_uring_op_complete((uint32_t)cqe->user_data, cqe->res, cqe->flags, ev)) {
+                n++;
+            }
+            continue;
+        }
+#endif
+        if (tag != NET_URING_TAG_POLL || events == NULL) {
+            continue;
+        }
+        int fd = (int)(uint32_t)cqe->user_data;
+        uint32_t gen = (uint32_t)(cqe->user_data >> NET_URING_GEN_SHIFT) & NET_URING_GEN_MASK;
+        bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+        if (cqe->res == -ECANCELED) {
+            // Our own net_uring_forget; the fd is already unregistered.
+            continue;
+        }
+        if (fd == net_uring.wake_fd) {
+            rearm_wake = rearm_wake || !more;
+        }
+        NetUringEvent* ev = &events[n++];
+        ev->fd = fd;
+        ev->gen = gen;
+        ev->disarmed = !more;
+        if (cqe->res < 0) {
+            ev->read_ready = true;
+            ev->write_ready = true;
+            continue;
+        }
+        uint32_t revents = (uint32_t)cqe->res;
+        ev->read_ready = (revents & (POLLIN | POLLRDHUP | POLLERR | POLLHUP)) != 0;
+        ev->write_ready = (revents & (POLLOUT | POLLERR | POLLHUP)) != 0;
+    }
+    atomic_store_explicit(net_uring.cq_head, head, memory_order_release);
+    if (rearm_wake) {
+        (void)net_uring_queue_poll(net_uring.wake_fd, 0);
+    }
+    return n;
+}
+
+bool net_uring_forget(int fd, uint32_t gen, bool polled) {
+    // The generation keeps the removal from matching the next owner's poll, but it is still
+    // submitted immediately: until it reaches the kernel, the armed poll holds a file
+    // reference and close(2) would not release the socket. Receives and accepts in flight
+    // pin it the same way.
+    if (fd < 0) {
+        return true;
+    }
+    bool ok = true;
+#if defined(NET_URING_IO)
+    NetUringFd* st = net_uring_io_fd(fd, gen, false);
+    if (st != NULL) {
+        ok = net_uring_io_forget(st);
+    }
+#endif
+    if (net_uring.fd < 0) {
+        return true;
+    }
+    if (polled) {
+        struct io_uring_sqe* sqe = net_uring_next_sqe();
+        if (sqe == NULL) {
+            return false;
+        }
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = net_uring_user_data(fd, gen, NET_URING_TAG_POLL);
+        sqe->user_data = net_uring_user_data(fd, gen, NET_URING_TAG_REMOVE);
+        net_uring_commit_sqe();
+    }
+    return net_uring_flush() && ok;
+}
+
+void net_uring_destroy(void) {
+    // Closing the ring cancels every request still in it and drops the file references they
+    // hold. A thread blocked in io_uring_enter keeps the ring file alive until it returns and
+    // then finds net_uring.fd < 0.
+    if (net_uring.fd >= 0) {
+#if defined(NET_URING_IO)
+        // Completions already posted may carry received data or accepted fds.
+        (void)net_uring_reap(NULL, 0);
+        net_uring_io_teardown();
+#endif
+        net_uring_unmap();
+    }
+}
+
+int net_uring_wait(rt_executor* ex, int timeout_ms, NetUringEvent* events, int max_events) {
+    if (net_uring.fd < 0 || max_events <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    int n = net_uring_reap(events, max_events);
+    if (n > 0 || timeout_ms == 0) {
+        bool queued = net_uring_unsubmitted() > 0;
+        if (net_uring_submit() < 0) {
+            return -1;
+        }
+        // Requests on sockets that are already ready complete during submission.
+        return n == 0 && queued ? net_uring_reap(events, max_events) : n;
+    }
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    if (timeout_ms > 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+    }
+    uint32_t pending = net_uring_unsubmitted();
+    net_uring.blocked++;
+    rt_unlock(ex);
+    int rc = net_uring_enter(
+        pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    int err = errno;
+    rt_lock(ex);
+    net_uring.blocked--;
+    // One enter carries every registration queued since the last wait.
+    (void)atomic_fetch_add_explicit(&net_uring_enters_total, 1, memory_order_relaxed);
+    if (net_uring.fd < 0) {
+        // Destroyed while this thread was blocked; the caller has moved to another reactor.
+        return 0;
+    }
+    if (rc < 0 && err != ETIME && err != EINTR && err != EBUSY) {
+        errno = err;
+        return -1;
+    }
+    return net_uring_reap(events, max_events);
+}
+
+uint64_t net_uring_enters(void) {
+    return atomic_load_explicit(&net_uring_enters_total, memory_order_relaxed);
+}
+
+#if defined(NET_URING_IO)
+bool net_uring_io_enabled(void) {
+    return net_uring_io.enabled && net_uring.fd >= 0;
+}
+
+NetUringIoState net_uring_io_state(int fd, uint32_t gen, NetUringIoKind kind) {
+    const NetUringFd* st = net_uring_io_fd(fd, gen, false);
+    if (st == NULL) {
+        return NET_URING_IO_IDLE;
+    }
+    uint32_t id = kind == NET_URING_RECV ? st->recv
+                  : kind == NET_URING_SEND ? st->send
+                                           : st->accept;
+    if (id == 0) {
+        return NET_URING_IO_IDLE;
+    }
+    return net_uring_io.ops[id].inflight ? NET_URING_IO_PENDING : NET_URING_IO_READY;
+}
+
+ssize_t net_uring_recv_take(int fd, uint32_t gen, uint8_t* buf, uint64_t cap) {
+    NetUringFd* st = net_uring_io_fd(fd, gen, false);
+    if (st == NULL || st->recv == 0) {
+        return NET_URING_NONE;
+    }
+    uint32_t id = st->recv;
+    NetUringOp* op = &net_uring_io.ops[id];
+    if (op->inflight) {
+        errno = EAGAIN;
+        return -1;
+    }
+    if (op->res < 0) {
+        int err = -op->res;
+        st->recv = 0;
+        net_uring_op_release(id);
+        if (err == ENOBUFS) {
+            // Every ring buffer is held by unread data; this reader goes to the socket.
+            return NET_URING_NONE;
+        }
+        errno = err;
+        return -1;
+    }
+    uint32_t avail = (uint32_t)op->res - op->off;
+    size_t n = cap < avail ? (size_t)cap : (size_t)avail;
+    if (n > 0) {
+        memcpy(buf, net_uring_io.bufs + (size_t)op->bid * NET_URING_BUF_SIZE + op->off, n);
+    }
+    op->off += (uint32_t)n;
+    if (op->off >= (uint32_t)op->res) {
+        st->recv = 0;
+        net_uring_op_release(id);
+    }
+    return (ssize_t)n;
+}
+
+bool net_uring_recv_arm(int fd, uint32_t gen) {
+    return net_uring_io_arm(fd, gen, NET_URING_RECV);
+}
+
+static bool net_uring_send_matches(const NetUringOp* op, const struct iovec* iov, int count) {
+    // The retried write has to start with the bytes the ring sent for it.
+    size_t off = 0;
+    for (int i = 0; i < count && off < op->off; i++) {
+        size_t len = iov[i].iov_len < op->off - off ? iov[i].iov_len : op->off - off;
+        if (memcmp(op->data + off, iov[i].iov_base, len) != 0) {
+            return false;
+        }
+        off += len;
+    }
+    return off == op->off;
+}
+
+ssize_t net_uring_send_take(int fd, uint32_t gen, const struct iovec* iov, int count) {
+    NetUringFd* st = net_uring_io_fd(fd, gen, false);
+    if (st == NULL || st->send == 0) {
+        return NET_URING_NONE;
+    }
+    uint32_t id = st->send;
+    NetUringOp* op = &net_uring_io.ops[id];
+    if (op->inflight) {
+        errno = EAGAIN;
+        return -1;
+    }
+    ssize_t sent = (ssize_t)op->off;
+    int err = op->res < 0 ? -op->res : EIO;
+    if (sent > 0 && !net_uring_send_matches(op, iov, count)) {
+        sent = 0;
+        err = EIO;
+    }
+    st->send = 0;
+    net_uring_op_release(id);
+    if (sent == 0) {
+        errno = err;
+        return -1;
+    }
+    return sent;
+}
+
+bool net_uring_send_arm(int fd, uint32_t gen, const struct iovec* iov, int count) {
+    NetUringFd* st = net_uring_io_enabled() ? net_uring_io_fd(fd, gen, true) : NULL;
+    if (st == NULL || st->send != 0) {
+        return false;
+    }
+    size_t total = 0;
+    for (int i = 0; i < count && total < NET_URING_SEND_MAX; i++) {
+        size_t room = NET_URING_SEND_MAX - total;
+        total += iov[i].iov_len < room ? iov[i].iov_len : room;
+    }
+    uint32_t id = total > 0 ? net_uring_op_alloc(NET_URING_SEND, fd, gen) : 0;
+    uint8_t* data = id != 0 ? (uint8_t*)rt_alloc((uint64_t)total, 1) : NULL;
+    if (data == NULL) {
+        if (id != 0) {
+            net_uring_op_release(id);
+        }
+        return false;
+    }
+    size_t copied = 0;
+    for (int i = 0; i < count && copied < total; i++) {
+        size_t len = iov[i].iov_len < total - copied ? iov[i].iov_len : total - copied;
+        memcpy(data + copied, iov[i].iov_base, len);
+        copied += len;
+    }
+    NetUringOp* op = &net_uring_io.ops[id];
+    op->data = data;
+    op->len = (uint32_t)total;
+    return net_uring_io_start(&st->send, id);
+}
+
+int net_uring_accept_take(int fd, uint32_t gen) {
+    NetUringFd* st = net_uring_io_fd(fd, gen, false);
+    if (st == NULL || st->accept == 0) {
+        return NET_URING_NONE;
+    }
+    uint32_t id = st->accept;
+    if (net_uring_io.ops[id].inflight) {
+        errno = EAGAIN;
+        return -1;
+    }
+    int res = net_uring_io.ops[id].res;
+    st->accept = 0;
+    net_uring_op_release(id);
+    if (res < 0) {
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+bool net_uring_accept_arm(int fd, uint32_t gen) {
+    return net_uring_io_arm(fd, gen, NET_URING_ACCEPT);
+}
+#endif
+
+#else
+
+int net_uring_create(int wake_fd) {
+    (void)wake_fd;
+    return -1;
+}
+
+bool net_uring_watch(int fd, uint32_t gen) {
+    (void)fd;
+    (void)gen;
+    return false;
+}
+
+bool net_uring_forget(int fd, uint32_t gen, bool polled) {
+    (void)fd;
+    (void)gen;
+    (void)polled;
+    return true;
+}
+
+void net_uring_destroy(void) {
+}
+
+int net_uring_wait(rt_executor* ex, int timeout_ms, NetUringEvent* events, int max_events) {
+    (void)ex;
+    (void)timeout_ms;
+    (void)events;
+    (void)max_events;
+    errno = ENOSYS;
+    return -1;
+}
+
+uint64_t net_uring_enters(void) {
+    return 0;
+}
+
+#endif
+
+#if !defined(NET_URING_IO)
+// Without provided-buffer rings the io_uring reactor only reports readiness.
+
+bool net_uring_io_enabled(void) {
+    return false;
+}
+
+NetUringIoState net_uring_io_state(int fd, uint32_t gen, NetUringIoKind kind) {
+    (void)fd;
+    (void)gen;
+    (void)kind;
+    return NET_URING_IO_IDLE;
+}
+
+ssize_t net_uring_recv_take(int fd, uint32_t gen, uint8_t* buf, uint64_t cap) {
+    (void)fd;
+    (void)gen;
+    (void)buf;
+    (void)cap;
+    return NET_URING_NONE;
+}
+
+bool net_uring_recv_arm(int fd, uint32_t gen) {
+    (void)fd;
+    (void)gen;
+    return false;
+}
+
+ssize_t net_uring_send_take(int fd, uint32_t gen, const struct iovec* iov, int count) {
+    (void)fd;
+    (void)gen;
+    (void)iov;
+    (void)count;
+    return NET_URING_NONE;
+}
+
+bool net_uring_send_arm(int fd, uint32_t gen, const struct iovec* iov, int count) {
+    (void)fd;
+    (void)gen;
+    (void)iov;
+    (void)count;
+    return false;
+}
+
+int net_uring_accept_take(int fd, uint32_t gen) {
+    (void)fd;
+    (void)gen;
+    return NET_URING_NONE;
+}
+
+bool net_uring_accept_arm(int fd, uint32_t gen) {
+    (void)fd;
+    (void)gen;
+    return false;
+}
+
+#endif
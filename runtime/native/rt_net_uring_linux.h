@@ -0,0 +1,90 @@
+#ifndef SURGE_RUNTIME_NATIVE_RT_NET_URING_LINUX_H
+#define SURGE_RUNTIME_NATIVE_RT_NET_URING_LINUX_H
+
+#include "rt_async_internal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// io_uring readiness backend for the net reactor (SURGE_NET_POLL=uring). Every fd gets one
+// multishot poll that stays armed until net_uring_forget. Registrations are queued in the
+// submission ring and reach the kernel with the next net_uring_wait, so one park round costs
+// one io_uring_enter, unless a waiter is already blocked on the ring. Callers hold ex->lock.
+//
+// When the kernel accepts a provided-buffer ring (5.19+), socket I/O that would block is also
+// completed by the ring instead of waiting for readiness: a receive picks a ring buffer and
+// is copied out by the next read, an accept hands its fd to the next accept, and a write
+// that finds the socket full sends a copy whose result is reported to the writer's retry.
+// Each fd has at most one receive, one send and one accept in flight.
+
+// Generations are kept modulo 2^24 so they fit in user_data next to the fd.
+#define NET_URING_GEN_MASK 0xFFFFFFu
+
+typedef struct NetUringEvent {
+    int fd;
+    // Generation the fd had when its poll was armed; compare before trusting the event.
+    uint32_t gen;
+    bool read_ready;
+    bool write_ready;
+    // The kernel ended this fd's multishot poll; the next watch has to arm it again.
+    bool disarmed;
+} NetUringEvent;
+
+typedef enum {
+    NET_URING_RECV = 0,
+    NET_URING_SEND = 1,
+    NET_URING_ACCEPT = 2,
+} NetUringIoKind;
+
+typedef enum {
+    // Nothing in flight; the caller falls back to readiness.
+    NET_URING_IO_IDLE = 0,
+    // The kernel still owns the request; park until its completion event.
+    NET_URING_IO_PENDING = 1,
+    // A result is waiting to be taken.
+    NET_URING_IO_READY = 2,
+} NetUringIoState;
+
+// Returned by the take functions when the ring holds nothing for the fd.
+#define NET_URING_NONE (-2)
+
+// Sets up the ring and arms wake_fd when it is >= 0. Returns the ring fd or -1 when io_uring
+// is missing, disabled, or lacks the features this backend relies on.
+int net_uring_create(int wake_fd);
+// Arms fd's poll under generation gen, which every event it produces carries.
+bool net_uring_watch(int fd, uint32_t gen);
+// Removes the poll armed for fd under gen when polled is set and cancels its receive, send
+// and accept. Returns false when this could not be submitted; the requests then still pin
+// the socket, and only net_uring_destroy releases them.
+bool net_uring_forget(int fd, uint32_t gen, bool polled);
+// Closes the ring, cancelling every request in it. Used when the ring stops accepting work.
+// Data already received stays available to net_uring_recv_take.
+void net_uring_destroy(void);
+// Reports whether completion I/O may be started; false after net_uring_destroy.
+bool net_uring_io_enabled(void);
+NetUringIoState net_uring_io_state(int fd, uint32_t gen, NetUringIoKind kind);
+// Copies received data into buf. Returns the byte count (0 at end of stream), -1 with errno
+// (EAGAIN while the receive is in flight), or NET_URING_NONE when the socket should be read
+// directly.
+ssize_t net_uring_recv_take(int fd, uint32_t gen, uint8_t* buf, uint64_t cap);
+// Starts a receive for fd. False means the caller has to wait for readiness instead.
+bool net_uring_recv_arm(int fd, uint32_t gen);
+// Reports the send started for fd as the result of writing iov, which has to begin with the
+// bytes it sent. Returns the byte count, -1 with errno (EAGAIN while the send is in flight),
+// or NET_URING_NONE when the socket should be written directly.
+ssize_t net_uring_send_take(int fd, uint32_t gen, const struct iovec* iov, int count);
+// Starts sending a copy of up to 64 KiB of iov. False means the caller has to wait for
+// readiness instead.
+bool net_uring_send_arm(int fd, uint32_t gen, const struct iovec* iov, int count);
+// Returns an accepted nonblocking fd, -1 with errno (EAGAIN while the accept is in flight), or
+// NET_URING_NONE.
+int net_uring_accept_take(int fd, uint32_t gen);
+bool net_uring_accept_arm(int fd, uint32_t gen);
+// Submits queued registrations and waits up to timeout_ms (-1 blocks, 0 only reaps) for
+// events, releasing ex->lock around the kernel wait. Returns the event count or -1.
+int net_uring_wait(rt_executor* ex, int timeout_ms, NetUringEvent* events, int max_events);
+uint64_t net_uring_enters(void);
+
+#endif
@@ -5,17 +5,41 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <stdalign.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// String storage.
+//
+// A SurgeString is an immutable header over contiguous bytes that either follow it inline
+// or live in a shared append buffer. Concatenations of at least STRING_BUF_MIN bytes
+// produce buffer strings with spare capacity. When the left operand of a later concat ends
+// exactly at its buffer's fill mark, the concat claims spare capacity with a CAS on used and
+// copies only the right operand, so s = s + piece costs amortized O(len(piece)). Older
+// headers keep describing the same prefix, which is never rewritten; when the CAS loses
+// (something else already extended that prefix) the result is copied into a fresh buffer.
+// Because bytes are always contiguous, rt_string_ptr and rt_string_bytes_view never need
+// to flatten anything.
+
+typedef struct SurgeStringBuf {
+    _Atomic uint64_t used;
+    uint64_t cap;
+    uint8_t bytes[];
+} SurgeStringBuf;
+
 typedef struct SurgeString {
     uint64_t len_cp;
     uint64_t len_bytes;
-    uint8_t data[];
+    const uint8_t* data;
+    SurgeStringBuf* buf; // NULL for inline strings
+    uint8_t inline_data[];
 } SurgeString;
 
+// Matches the VM's stringRopeThresholdBytes: shorter results are plain inline copies.
+#define STRING_BUF_MIN 128u
+
 typedef struct SurgeBytesView {
     void* owner;
     const uint8_t* ptr;
@@ -26,120 +50,10 @@ static int is_cont(uint8_t c) {
     return (c & 0xC0) == 0x80;
 }
 
-static uint64_t count_codepoints(const uint8_t* data, uint64_t len) {
-    uint64_t count = 0;
-    uint64_t i = 0;
-    while (i < len) {
-        uint8_t c0 = data[i];
-        if (c0 < 0x80) {
-            i += 1;
-            count += 1;
-            continue;
-        }
-        if (c0 < 0xC2) {
-            i += 1;
-            count += 1;
-            continue;
-        }
-        if (c0 <= 0xDF) {
-            if (i + 1 < len && is_cont(data[i + 1])) {
-                i += 2;
-                count += 1;
-                continue;
-            }
-            i += 1;
-            count += 1;
-            continue;
-        }
-        if (c0 <= 0xEF) {
-            if (i + 2 < len && is_cont(data[i + 1]) && is_cont(data[i + 2])) {
-                uint8_t c1 = data[i + 1];
-                if ((c0 == 0xE0 && c1 < 0xA0) || (c0 == 0xED && c1 >= 0xA0)) {
-                    i += 1;
-                    count += 1;
-                    continue;
-                }
-                i += 3;
-                count += 1;
-                continue;
-            }
-            i += 1;
-            count += 1;
-            continue;
-        }
-        if (c0 <= 0xF4) {
-            if (i + 3 < len && is_cont(data[i + 1]) && is_cont(data[i + 2]) &&
-                is_cont(data[i + 3])) {
-                uint8_t c1 = data[i + 1];
-                if ((c0 == 0xF0 && c1 < 0x90) || (c0 == 0xF4 && c1 >= 0x90)) {
-                    i += 1;
-                    count += 1;
-                    continue;
-                }
-                i += 4;
-                count += 1;
-                continue;
-            }
-            i += 1;
-            count += 1;
-            continue;
-        }
-        i += 1;
-        count += 1;
-    }
-    return count;
-}
-
-bool rt_utf8_valid(const uint8_t* data, uint64_t len) {
-    if (len == 0) {
-        return true;
-    }
-    if (data == NULL) {
-        return false;
-    }
-    uint64_t i = 0;
-    while (i < len) {
-        uint8_t c0 = data[i];
-        if (c0 < 0x80) {
-            i += 1;
-            continue;
-        }
-        if (c0 < 0xC2) {
-            return false;
-        }
-        if (c0 <= 0xDF) {
-            if (i + 1 >= len || !is_cont(data[i + 1])) {
-                return false;
-            }
-            i += 2;
-            continue;
-        }
-        if (c0 <= 0xEF) {
-            if (i + 2 >= len || !is_cont(data[i + 1]) || !is_cont(data[i + 2])) {
-                return false;
-            }
-            uint8_t c1 = data[i + 1];
-            if ((c0 == 0xE0 && c1 < 0xA0) || (c0 == 0xED && c1 >= 0xA0)) {
-                return false;
-            }
-            i += 3;
-            continue;
-        }
-        if (c0 <= 0xF4) {
-            if (i + 3 >= len || !is_cont(data[i + 1]) || !is_cont(data[i + 2]) ||
-                !is_cont(data[i + 3])) {
-                return false;
-            }
-            uint8_t c1 = data[i + 1];
-            if ((c0 == 0xF0 && c1 < 0x90) || (c0 == 0xF4 && c1 >= 0x90)) {
-                return false;
-            }
-            i += 4;
-            continue;
-        }
-        return false;
-    }
-    return true;
+static bool string_is_ascii(const SurgeString* str) {
+    // Every codepoint is one byte exactly when the counts match (malformed bytes count as
+    // one codepoint each), so codepoint and byte offsets coincide.
+    return str->len_cp == str->len_bytes;
 }
 
 static uint32_t decode_utf8_at(const uint8_t* data, uint64_t len, uint64_t idx, uint64_t* advance) {
@@ -269,29 +183,154 @@ static void range_bounds(const SurgeRange* r, int64_t length, int64_t* start, in
     *end = end64;
 }
 
-void* rt_string_from_bytes(const uint8_t* ptr, uint64_t len) {
-    uint64_t bytes = len;
-    uint64_t count = 0;
-    if (ptr != NULL && len > 0) {
-        count = count_codepoints(ptr, len);
-    }
-    // TODO: apply NFC normalization once a lightweight C implementation is available.
+static void string_panic(const char* msg) {
+    rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
+}
+
+static SurgeString* string_alloc_inline(uint64_t bytes, uint64_t cp, const char* range_msg) {
+    // Returns a NUL-terminated inline string whose bytes the caller fills in.
     size_t max_payload = SIZE_MAX - sizeof(SurgeString) - 1;
     if (bytes > (uint64_t)max_payload) {
-        const char* msg = "string from_bytes length out of range";
-        rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
+        string_panic(range_msg);
+        return NULL;
     }
     size_t total = sizeof(SurgeString) + (size_t)bytes + 1;
     SurgeString* s = (SurgeString*)rt_alloc((uint64_t)total, (uint64_t)alignof(SurgeString));
     if (s == NULL) {
         return NULL;
     }
-    s->len_cp = count;
+    s->len_cp = cp;
+    s->len_bytes = bytes;
+    s->data = s->inline_data;
+    s->buf = NULL;
+    s->inline_data[bytes] = 0;
+    return s;
+}
+
+static SurgeString*
+string_alloc_buffered(SurgeStringBuf* buf, const uint8_t* data, uint64_t bytes, uint64_t cp) {
+    SurgeString* s =
+        (SurgeString*)rt_alloc((uint64_t)sizeof(SurgeString), (uint64_t)alignof(SurgeString));
+    if (s == NULL) {
+        return NULL;
+    }
+    s->len_cp = cp;
     s->len_bytes = bytes;
+    s->data = data;
+    s->buf = buf;
+    return s;
+}
+
+static SurgeStringBuf* string_buf_alloc(uint64_t bytes, const char* range_msg) {
+    // Room for bytes plus as much again, so a chain of appends grows geometrically.
+    uint64_t max_cap = (uint64_t)(SIZE_MAX - sizeof(SurgeStringBuf));
+    if (bytes > max_cap) {
+        string_panic(range_msg);
+        return NULL;
+    }
+    uint64_t cap = bytes <= max_cap / 2 ? bytes * 2 : max_cap;
+    SurgeStringBuf* buf = (SurgeStringBuf*)rt_alloc((uint64_t)sizeof(SurgeStringBuf) + cap,
+                                                    (uint64_t)alignof(SurgeStringBuf));
+    if (buf == NULL) {
+        return NULL;
+    }
+    atomic_init(&buf->used, 0);
+    buf->cap = cap;
+    return buf;
+}
+
+static bool string_try_extend(const SurgeString* left, uint64_t extra) {
+    // Claims extra bytes right after left in its buffer; true when the caller may write them.
+    SurgeStringBuf* buf = left->buf;
+    if (buf == NULL) {
+        return false;
+    }
+    uint64_t end = (uint64_t)(left->data - buf->bytes) + left->len_bytes;
+    if (buf->cap - end < extra) {
+        return false;
+    }
+    uint64_t expected = end;
+    return atomic_compare_exchange_strong_explicit(
+        &buf->used, &expected, end + extra, memory_order_relaxed, memory_order_relaxed);
+}
+
+static SurgeString* string_join_parts(const SurgeString* const* parts, size_t count) {
+    uint64_t total_bytes = 0;
+    uint64_t total_cp = 0;
+    size_t nonempty = 0;
+    const SurgeString* only = NULL;
+    for (size_t i = 0; i < count; i++) {
+        const SurgeString* part = parts[i];
+        if (part == NULL || part->len_bytes == 0) {
+            continue;
+        }
+        if (part->len_bytes > UINT64_MAX - total_bytes) {
+            string_panic("string concat length out of range");
+            return NULL;
+        }
+        total_bytes += part->len_bytes;
+        total_cp += part->len_cp;
+        nonempty++;
+        only = part;
+    }
+    if (nonempty == 1) {
+        // Strings are immutable, so a lone non-empty operand is the result.
+        return (SurgeString*)(uintptr_t)only;
+    }
+
+    const SurgeString* first = count > 0 ? parts[0] : NULL;
+    if (first != NULL && first->len_bytes > 0 &&
+        string_try_extend(first, total_bytes - first->len_bytes)) {
+        uint8_t* dst = (uint8_t*)(uintptr_t)first->data + first->len_bytes;
+        for (size_t i = 1; i < count; i++) {
+            if (parts[i] != NULL && parts[i]->len_bytes > 0) {
+                rt_memcpy(dst, parts[i]->data, parts[i]->len_bytes);
+                dst += parts[i]->len_bytes;
+            }
+        }
+        return string_alloc_buffered(first->buf, first->data, total_bytes, total_cp);
+    }
+
+    SurgeString* out = NULL;
+    uint8_t* dst = NULL;
+    if (total_bytes >= STRING_BUF_MIN) {
+        SurgeStringBuf* buf = string_buf_alloc(total_bytes, "string concat length out of range");
+        if (buf == NULL) {
+            return NULL;
+        }
+        atomic_store_explicit(&buf->used, total_bytes, memory_order_relaxed);
+        out = string_alloc_buffered(buf, buf->bytes, total_bytes, total_cp);
+        dst = buf->bytes;
+    } else {
+        out = string_alloc_inline(total_bytes, total_cp, "string concat length out of range");
+        dst = out == NULL ? NULL : out->inline_data;
+    }
+    if (out == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (parts[i] != NULL && parts[i]->len_bytes > 0) {
+            rt_memcpy(dst, parts[i]->data, parts[i]->len_bytes);
+            dst += parts[i]->len_bytes;
+        }
+    }
+    return out;
+}
+
+void* rt_string_from_bytes(const uint8_t* ptr, uint64_t len) {
+    uint64_t bytes = len;
+    uint64_t count = 0;
+    if (ptr != NULL && len > 0) {
+        count = rt_utf8_count(ptr, len);
+    }
+    // TODO: apply NFC normalization once a lightweight C implementation is available.
+    SurgeString* s = string_alloc_inline(bytes, count, "string from_bytes length out of range");
+    if (s == NULL) {
+        return NULL;
+    }
     if (bytes > 0 && ptr != NULL) {
-        rt_memcpy(s->data, ptr, bytes);
+        rt_memcpy(s->inline_data, ptr, bytes);
     }
-    s->data[bytes] = 0;
     return (void*)s;
 }
 
@@ -348,6 +387,10 @@ uint32_t rt_string_index(void* s, int64_t index) {
     }
     uint64_t i = 0;
     uint64_t count = 0;
+    if (string_is_ascii(str)) {
+        i = (uint64_t)idx;
+        count = (uint64_t)idx;
+    }
     while (i < str->len_bytes) {
         uint64_t advance = 1;
         uint32_t cp = decode_utf8_at(str->data, str->len_bytes, i, &advance);
@@ -382,8 +425,12 @@ void* rt_string_slice(void* s, void* r) {
     if (start > end) {
         start = end;
     }
-    uint64_t byte_start = byte_offset_for_cp(str->data, str->len_bytes, (uint64_t)start);
-    uint64_t byte_end = byte_offset_for_cp(str->data, str->len_bytes, (uint64_t)end);
+    uint64_t byte_start = (uint64_t)start;
+    uint64_t byte_end = (uint64_t)end;
+    if (!string_is_ascii(str)) {
+        byte_start = byte_offset_for_cp(str->data, str->len_bytes, (uint64_t)start);
+        byte_end = byte_offset_for_cp(str->data, str->len_bytes, (uint64_t)end);
+    }
     if (byte_end < byte_start) {
         byte_end = byte_start;
     }
@@ -410,41 +457,22 @@ void* rt_string_bytes_view(void* s) {
 }
 
 void* rt_string_concat(void* a, void* b) {
-    SurgeString* left = NULL;
-    SurgeString* right = NULL;
+    const SurgeString* parts[2] = {NULL, NULL};
     if (a != NULL) {
-        left = *(SurgeString**)a;
+        parts[0] = *(SurgeString**)a;
     }
     if (b != NULL) {
-        right = *(SurgeString**)b;
+        parts[1] = *(SurgeString**)b;
     }
-    uint64_t left_bytes = left ? left->len_bytes : 0;
-    uint64_t right_bytes = right ? right->len_bytes : 0;
-    uint64_t left_cp = left ? left->len_cp : 0;
-    uint64_t right_cp = right ? right->len_cp : 0;
+    return (void*)string_join_parts(parts, 2);
+}
 
-    uint64_t total_bytes = left_bytes + right_bytes;
-    uint64_t total_cp = left_cp + right_cp;
-    size_t max_payload = SIZE_MAX - sizeof(SurgeString) - 1;
-    if (total_bytes > (uint64_t)max_payload) {
-        const char* msg = "string concat length out of range";
-        rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
-    }
-    size_t total = sizeof(SurgeString) + (size_t)total_bytes + 1;
-    SurgeString* out = (SurgeString*)rt_alloc((uint64_t)total, (uint64_t)alignof(SurgeString));
-    if (out == NULL) {
-        return NULL;
+void* rt_string_concat_n(void* parts, uint64_t count) {
+    // parts holds count string values; empty when count is 0.
+    if (parts == NULL || count == 0) {
+        return string_join_parts(NULL, 0);
     }
-    out->len_cp = total_cp;
-    out->len_bytes = total_bytes;
-    if (left_bytes > 0 && left != NULL) {
-        rt_memcpy(out->data, left->data, left_bytes);
-    }
-    if (right_bytes > 0 && right != NULL) {
-        rt_memcpy(out->data + left_bytes, right->data, right_bytes);
-    }
-    out->data[total_bytes] = 0;
-    return (void*)out;
+    return (void*)string_join_parts((const SurgeString* const*)parts, (size_t)count);
 }
 
 void* rt_string_repeat(void* s, int64_t count) {
@@ -474,23 +502,15 @@ void* rt_string_repeat(void* s, int64_t count) {
     }
     uint64_t total_bytes = unit_bytes * (uint64_t)count;
     uint64_t total_cp = unit_cp * (uint64_t)count;
-    size_t max_payload = SIZE_MAX - sizeof(SurgeString) - 1;
-    if (total_bytes > (uint64_t)max_payload) {
-        const char* msg = "string repeat length out of range";
-        rt_panic_numeric((const uint8_t*)msg, (uint64_t)strlen(msg));
-    }
-    size_t total = sizeof(SurgeString) + (size_t)total_bytes + 1;
-    SurgeString* out = (SurgeString*)rt_alloc((uint64_t)total, (uint64_t)alignof(SurgeString));
+    SurgeString* out =
+        string_alloc_inline(total_bytes, total_cp, "string repeat length out of range");
     if (out == NULL) {
         return NULL;
     }
-    out->len_cp = total_cp;
-    out->len_bytes = total_bytes;
     for (int64_t i = 0; i < count; i++) {
         uint64_t offset = (uint64_t)i * unit_bytes;
-        rt_memcpy(out->data + offset, str->data, unit_bytes);
+        rt_memcpy(out->inline_data + offset, str->data, unit_bytes);
     }
-    out->data[total_bytes] = 0;
     return (void*)out;
 }
 
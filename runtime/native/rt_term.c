@@ -606,6 +606,8 @@ static void term_restore_at_exit(void) {
     rt_term_set_raw_mode(false);
     rt_term_show_cursor();
     rt_term_exit_alt_screen();
+    // This handler can run after the buffer's own atexit flush, so drain what it wrote.
+    rt_flush_stdout();
 }
 
 void rt_term_enter_alt_screen(void) {
@@ -708,6 +710,7 @@ void rt_term_write(const void* bytes) {
 }
 
 void rt_term_flush(void) {
+    rt_flush_stdout();
     int fd = term_tty_fd();
     if (fd >= 0) {
         tcdrain(fd);
@@ -1051,6 +1054,8 @@ static bool term_read_event_spec(TermEventSpec* out) {
 }
 
 void* rt_term_read_event(void) {
+    // A frame drawn before waiting for input must be on screen while the read blocks.
+    rt_flush_stdout();
     TermEventSpec spec = {0};
     if (!term_read_event_spec(&spec)) {
         spec.kind = TERM_EVENT_KIND_EOF;
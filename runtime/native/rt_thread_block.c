@@ -0,0 +1,74 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L // NOLINT(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+#endif
+
+#include "rt_thread_block.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum { THREAD_BLOCK_CACHE_LINE = 64 };
+
+// Guards lazy creation of each set's TLS key.
+static pthread_mutex_t thread_block_key_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void thread_block_exit(void* arg) {
+    rt_thread_block* block = (rt_thread_block*)arg;
+    if (block == NULL) {
+        return;
+    }
+    if (block->set->retire != NULL) {
+        block->set->retire(block);
+    }
+    block->owner->block = NULL;
+    block->owner->exited = 1;
+    block->owner = NULL;
+    atomic_store_explicit(&block->in_use, 0, memory_order_release);
+}
+
+static void thread_block_key_init(rt_thread_blocks* set) {
+    if (atomic_load_explicit(&set->key_ready, memory_order_acquire)) {
+        return;
+    }
+    pthread_mutex_lock(&thread_block_key_lock);
+    if (!atomic_load_explicit(&set->key_ready, memory_order_relaxed)) {
+        (void)pthread_key_create(&set->key, thread_block_exit);
+        atomic_store_explicit(&set->key_ready, 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&thread_block_key_lock);
+}
+
+rt_thread_block* rt_thread_block_attach(rt_thread_blocks* set, rt_thread_slot* slot) {
+    thread_block_key_init(set);
+    rt_thread_block* block = atomic_load_explicit(&set->head, memory_order_acquire);
+    for (; block != NULL; block = block->next) {
+        uint8_t expected = 0;
+        if (atomic_compare_exchange_strong_explicit(
+                &block->in_use, &expected, 1, memory_order_acq_rel, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (block == NULL) {
+        // Cache-line aligned so two threads' blocks never share a line. This uses libc
+        // directly: rt_alloc keeps its own counters in a set.
+        size_t size = (set->size + THREAD_BLOCK_CACHE_LINE - 1) &
+                      ~(size_t)(THREAD_BLOCK_CACHE_LINE - 1);
+        void* mem = NULL;
+        if (posix_memalign(&mem, THREAD_BLOCK_CACHE_LINE, size) != 0 || mem == NULL) {
+            return NULL;
+        }
+        memset(mem, 0, size);
+        block = (rt_thread_block*)mem;
+        block->set = set;
+        atomic_store_explicit(&block->in_use, 1, memory_order_relaxed);
+        rt_thread_block* head = atomic_load_explicit(&set->head, memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(
+            &set->head, &head, block, memory_order_release, memory_order_relaxed));
+    }
+    block->owner = slot;
+    slot->block = block;
+    (void)pthread_setspecific(set->key, block);
+    return block;
+}
@@ -0,0 +1,70 @@
+#ifndef SURGE_RUNTIME_NATIVE_RT_THREAD_BLOCK_H
+#define SURGE_RUNTIME_NATIVE_RT_THREAD_BLOCK_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-thread blocks.
+//
+// Hot counters live in one block per thread, so threads never contend on a shared cache
+// line, and readers sum the blocks on the set's list. A thread claims its block on first
+// use, adopting one that an exited thread left behind before allocating a new one, so a set
+// holds at most as many blocks as there were live threads at once. Blocks are cache-line
+// aligned, zeroed when allocated, and never freed. When a thread exits, the set's retire
+// hook runs on it and the block is released for adoption; code that runs later on that
+// thread (another TLS destructor, say) gets NULL and has to use shared fallbacks.
+
+typedef struct rt_thread_blocks rt_thread_blocks;
+typedef struct rt_thread_slot rt_thread_slot;
+
+// Header every block type starts with.
+typedef struct rt_thread_block {
+    struct rt_thread_block* next;
+    rt_thread_blocks* set;
+    rt_thread_slot* owner;
+    _Atomic uint8_t in_use;
+} rt_thread_block;
+
+// One thread's handle on a set; declare it _Thread_local and leave it zeroed.
+struct rt_thread_slot {
+    rt_thread_block* block;
+    uint8_t exited;
+};
+
+struct rt_thread_blocks {
+    size_t size;
+    // Runs on the exiting thread before its block can be adopted; may be NULL.
+    void (*retire)(rt_thread_block* block);
+    _Atomic(rt_thread_block*) head;
+    _Atomic uint8_t key_ready;
+    pthread_key_t key;
+};
+
+#define RT_THREAD_BLOCKS_INIT(type, retire_fn) {.size = sizeof(type), .retire = (retire_fn)}
+
+// Slow path of rt_thread_block_get.
+rt_thread_block* rt_thread_block_attach(rt_thread_blocks* set, rt_thread_slot* slot);
+
+// Returns the calling thread's block, or NULL after the thread's exit hook has run or
+// when no block could be allocated.
+static inline rt_thread_block* rt_thread_block_get(rt_thread_blocks* set, rt_thread_slot* slot) {
+    if (slot->block != NULL || slot->exited) {
+        return slot->block;
+    }
+    return rt_thread_block_attach(set, slot);
+}
+
+static inline const rt_thread_block* rt_thread_blocks_first(rt_thread_blocks* set) {
+    return atomic_load_explicit(&set->head, memory_order_acquire);
+}
+
+// Adds delta to a counter in the calling thread's own block.
+static inline void rt_thread_counter_add(_Atomic uint64_t* counter, uint64_t delta) {
+    // Only the owning thread writes its block, so a load/store pair is enough.
+    atomic_store_explicit(
+        counter, atomic_load_explicit(counter, memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+#endif
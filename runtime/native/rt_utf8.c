@@ -0,0 +1,460 @@
+#include "rt.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// UTF-8 validation and codepoint counting.
+//
+// utf8_scan validates and counts in one pass. The vector kernels follow the
+// Keiser-Lemire lookup scheme: three 16-entry nibble tables classify every byte pair, and a
+// saturating subtract marks the bytes that must continue a 3- or 4-byte sequence. Blocks
+// that are pure ASCII (with an ASCII predecessor) skip the classification. The trailing
+// partial block is copied into a zero-padded buffer, so a sequence cut off at the end shows
+// up as a too-short error instead of needing a separate carry check.
+//
+// x86-64 picks AVX2 or SSE4.1 at run time; aarch64 always has NEON; every other target uses
+// the scalar loops. Counting for invalid input keeps the lenient rule decode_utf8_at uses
+// (every malformed byte is one codepoint), so it falls back to utf8_count_lenient.
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UTF8_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define UTF8_NEON 1
+#include <arm_neon.h>
+#endif
+
+enum {
+    UTF8_TOO_SHORT = 1 << 0,
+    UTF8_TOO_LONG = 1 << 1,
+    UTF8_OVERLONG_3 = 1 << 2,
+    UTF8_TOO_LARGE = 1 << 3,
+    UTF8_SURROGATE = 1 << 4,
+    UTF8_OVERLONG_2 = 1 << 5,
+    UTF8_TOO_LARGE_1000 = 1 << 6,
+    UTF8_OVERLONG_4 = 1 << 6,
+    UTF8_TWO_CONTS = 1 << 7,
+    UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS,
+};
+
+#if defined(UTF8_X86) || defined(UTF8_NEON)
+// Indexed by the high nibble of the previous byte.
+static const uint8_t utf8_byte1_high[16] = {
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TOO_LONG,
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    UTF8_TWO_CONTS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+};
+
+// Indexed by the low nibble of the previous byte.
+static const uint8_t utf8_byte1_low[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+};
+
+// Indexed by the high nibble of the current byte.
+static const uint8_t utf8_byte2_high[16] = {
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+        UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT,
+};
+#endif
+
+static int utf8_is_cont(uint8_t c) {
+    return (c & 0xC0) == 0x80;
+}
+
+static uint64_t utf8_ascii_prefix(const uint8_t* data, uint64_t len) {
+    // Length of the leading run of ASCII bytes, checked a word at a time.
+    uint64_t i = 0;
+    while (i + 8 <= len) {
+        uint64_t word = 0;
+        memcpy(&word, data + i, sizeof(word));
+        if ((word & UINT64_C(0x8080808080808080)) != 0) {
+            break;
+        }
+        i += 8;
+    }
+    while (i < len && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+static uint64_t utf8_count_lenient(const uint8_t* data, uint64_t len) {
+    uint64_t count = 0;
+    uint64_t i = 0;
+    while (i < len) {
+        uint8_t c0 = data[i];
+        if (c0 < 0x80) {
+            uint64_t run = utf8_ascii_prefix(data + i, len - i);
+            i += run;
+            count += run;
+            continue;
+        }
+        if (c0 < 0xC2) {
+            i += 1;
+            count += 1;
+            continue;
+        }
+        if (c0 <= 0xDF) {
+            if (i + 1 < len && utf8_is_cont(data[i + 1])) {
+                i += 2;
+                count += 1;
+                continue;
+            }
+            i += 1;
+            count += 1;
+            continue;
+        }
+        if (c0 <= 0xEF) {
+            if (i + 2 < len && utf8_is_cont(data[i + 1]) && utf8_is_cont(data[i + 2])) {
+                uint8_t c1 = data[i + 1];
+                if ((c0 == 0xE0 && c1 < 0xA0) || (c0 == 0xED && c1 >= 0xA0)) {
+                    i += 1;
+                    count += 1;
+                    continue;
+                }
+                i += 3;
+                count += 1;
+                continue;
+            }
+            i += 1;
+            count += 1;
+            continue;
+        }
+        if (c0 <= 0xF4) {
+            if (i + 3 < len && utf8_is_cont(data[i + 1]) && utf8_is_cont(data[i + 2]) &&
+                utf8_is_cont(data[i + 3])) {
+                uint8_t c1 = data[i + 1];
+                if ((c0 == 0xF0 && c1 < 0x90) || (c0 == 0xF4 && c1 >= 0x90)) {
+                    i += 1;
+                    count += 1;
+                    continue;
+                }
+                i += 4;
+                count += 1;
+                continue;
+            }
+            i += 1;
+            count += 1;
+            continue;
+        }
+        i += 1;
+        count += 1;
+    }
+    return count;
+}
+
+static bool utf8_scan_scalar(const uint8_t* data, uint64_t len, uint64_t* out_count) {
+    uint64_t count = 0;
+    uint64_t i = 0;
+    while (i < len) {
+        uint8_t c0 = data[i];
+        if (c0 < 0x80) {
+            uint64_t run = utf8_ascii_prefix(data + i, len - i);
+            i += run;
+            count += run;
+            continue;
+        }
+        if (c0 < 0xC2) {
+            return false;
+        }
+        if (c0 <= 0xDF) {
+            if (i + 1 >= len || !utf8_is_cont(data[i + 1])) {
+                return false;
+            }
+            i += 2;
+            count++;
+            continue;
+        }
+        if (c0 <= 0xEF) {
+            if (i + 2 >= len || !utf8_is_cont(data[i + 1]) || !utf8_is_cont(data[i + 2])) {
+                return false;
+            }
+            uint8_t c1 = data[i + 1];
+            if ((c0 == 0xE0 && c1 < 0xA0) || (c0 == 0xED && c1 >= 0xA0)) {
+                return false;
+            }
+            i += 3;
+            count++;
+            continue;
+        }
+        if (c0 <= 0xF4) {
+            if (i + 3 >= len || !utf8_is_cont(data[i + 1]) || !utf8_is_cont(data[i + 2]) ||
+                !utf8_is_cont(data[i + 3])) {
+                return false;
+            }
+            uint8_t c1 = data[i + 1];
+            if ((c0 == 0xF0 && c1 < 0x90) || (c0 == 0xF4 && c1 >= 0x90)) {
+                return false;
+            }
+            i += 4;
+            count++;
+            continue;
+        }
+        return false;
+    }
+    *out_count = count;
+    return true;
+}
+
+#ifdef UTF8_X86
+__attribute__((target("sse4.1"))) static __m128i utf8_sse_lookup(const uint8_t* table,
+                                                                 __m128i idx) {
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(const void*)table), idx);
+}
+
+__attribute__((target("sse4.1"))) static __m128i utf8_sse_check(__m128i input, __m128i prev) {
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    __m128i prev1_high = _mm_and_si128(_mm_srli_epi16(prev1, 4), low_mask);
+    __m128i prev1_low = _mm_and_si128(prev1, low_mask);
+    __m128i input_high = _mm_and_si128(_mm_srli_epi16(input, 4), low_mask);
+    __m128i special = _mm_and_si128(_mm_and_si128(utf8_sse_lookup(utf8_byte1_high, prev1_high),
+                                                  utf8_sse_lookup(utf8_byte1_low, prev1_low)),
+                                    utf8_sse_lookup(utf8_byte2_high, input_high));
+    __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23, special);
+}
+
+__attribute__((target("sse4.1"))) static uint64_t utf8_sse_lead_bytes(__m128i input) {
+    // Bytes that start a codepoint, i.e. everything but 0x80..0xBF.
+    __m128i lead = _mm_cmpgt_epi8(input, _mm_set1_epi8(-65));
+    return (uint64_t)__builtin_popcount((unsigned)_mm_movemask_epi8(lead));
+}
+
+__attribute__((target("sse4.1"))) static bool
+utf8_scan_sse(const uint8_t* data, uint64_t len, uint64_t* out_count) {
+    __m128i prev = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    bool prev_ascii = true;
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i*)(const void*)(data + i));
+        bool ascii = _mm_movemask_epi8(input) == 0;
+        if (ascii && prev_ascii) {
+            count += 16;
+        } else {
+            error = _mm_or_si128(error, utf8_sse_check(input, prev));
+            count += utf8_sse_lead_bytes(input);
+        }
+        prev = input;
+        prev_ascii = ascii;
+    }
+    uint8_t tail[16] = {0};
+    uint64_t rest = len - i;
+    memcpy(tail, data + i, (size_t)rest);
+    __m128i input = _mm_loadu_si128((const __m128i*)(const void*)tail);
+    error = _mm_or_si128(error, utf8_sse_check(input, prev));
+    count += utf8_sse_lead_bytes(input) - (16 - rest);
+    if (!_mm_testz_si128(error, error)) {
+        return false;
+    }
+    *out_count = count;
+    return true;
+}
+
+__attribute__((target("avx2"))) static __m256i utf8_avx2_lookup(const uint8_t* table,
+                                                                __m256i idx) {
+    __m128i t = _mm_loadu_si128((const __m128i*)(const void*)table);
+    return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(t), idx);
+}
+
+__attribute__((target("avx2"))) static __m256i utf8_avx2_check(__m256i input, __m256i prev) {
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    // Lane-crossing shift: pair each 128-bit lane with the one before it.
+    __m256i carried = _mm256_permute2x128_si256(prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    __m256i prev1_high = _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_mask);
+    __m256i prev1_low = _mm256_and_si256(prev1, low_mask);
+    __m256i input_high = _mm256_and_si256(_mm256_srli_epi16(input, 4), low_mask);
+    __m256i special =
+        _mm256_and_si256(_mm256_and_si256(utf8_avx2_lookup(utf8_byte1_high, prev1_high),
+                                          utf8_avx2_lookup(utf8_byte1_low, prev1_low)),
+                         utf8_avx2_lookup(utf8_byte2_high, input_high));
+    __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must23 =
+        _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must23, special);
+}
+
+__attribute__((target("avx2"))) static uint64_t utf8_avx2_lead_bytes(__m256i input) {
+    __m256i lead = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65));
+    return (uint64_t)__builtin_popcount((unsigned)_mm256_movemask_epi8(lead));
+}
+
+__attribute__((target("avx2"))) static bool
+utf8_scan_avx2(const uint8_t* data, uint64_t len, uint64_t* out_count) {
+    __m256i prev = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    bool prev_ascii = true;
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i input = _mm256_loadu_si256((const __m256i*)(const void*)(data + i));
+        bool ascii = _mm256_movemask_epi8(input) == 0;
+        if (ascii && prev_ascii) {
+            count += 32;
+        } else {
+            error = _mm256_or_si256(error, utf8_avx2_check(input, prev));
+            count += utf8_avx2_lead_bytes(input);
+        }
+        prev = input;
+        prev_ascii = ascii;
+    }
+    uint8_t tail[32] = {0};
+    uint64_t rest = len - i;
+    memcpy(tail, data + i, (size_t)rest);
+    __m256i input = _mm256_loadu_si256((const __m256i*)(const void*)tail);
+    error = _mm256_or_si256(error, utf8_avx2_check(input, prev));
+    count += utf8_avx2_lead_bytes(input) - (32 - rest);
+    if (!_mm256_testz_si256(error, error)) {
+        return false;
+    }
+    *out_count = count;
+    return true;
+}
+#endif
+
+#ifdef UTF8_NEON
+static uint8x16_t utf8_neon_check(uint8x16_t input, uint8x16_t prev) {
+    const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+    uint8x16_t prev1 = vextq_u8(prev, input, 15);
+    uint8x16_t special =
+        vandq_u8(vandq_u8(vqtbl1q_u8(vld1q_u8(utf8_byte1_high), vshrq_n_u8(prev1, 4)),
+                          vqtbl1q_u8(vld1q_u8(utf8_byte1_low), vandq_u8(prev1, low_mask))),
+                 vqtbl1q_u8(vld1q_u8(utf8_byte2_high), vshrq_n_u8(input, 4)));
+    uint8x16_t prev2 = vextq_u8(prev, input, 14);
+    uint8x16_t prev3 = vextq_u8(prev, input, 13);
+    uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+    uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+    uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+    return veorq_u8(must23, special);
+}
+
+static uint64_t utf8_neon_lead_bytes(uint8x16_t input) {
+    uint8x16_t lead = vcgtq_s8(vreinterpretq_s8_u8(input), vdupq_n_s8(-65));
+    return (uint64_t)vaddvq_u8(vshrq_n_u8(lead, 7));
+}
+
+static bool utf8_scan_neon(const uint8_t* data, uint64_t len, uint64_t* out_count) {
+    uint8x16_t prev = vdupq_n_u8(0);
+    uint8x16_t error = vdupq_n_u8(0);
+    bool prev_ascii = true;
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t input = vld1q_u8(data + i);
+        bool ascii = vmaxvq_u8(input) < 0x80;
+        if (ascii && prev_ascii) {
+            count += 16;
+        } else {
+            error = vorrq_u8(error, utf8_neon_check(input, prev));
+            count += utf8_neon_lead_bytes(input);
+        }
+        prev = input;
+        prev_ascii = ascii;
+    }
+    uint8_t tail[16] = {0};
+    uint64_t rest = len - i;
+    memcpy(tail, data + i, (size_t)rest);
+    uint8x16_t input = vld1q_u8(tail);
+    error = vorrq_u8(error, utf8_neon_check(input, prev));
+    count += utf8_neon_lead_bytes(input) - (16 - rest);
+    if (vmaxvq_u8(error) != 0) {
+        return false;
+    }
+    *out_count = count;
+    return true;
+}
+#endif
+
+static bool utf8_scan(const uint8_t* data, uint64_t len, uint64_t* out_count) {
+    // Short inputs are not worth a padded vector block.
+    if (len < 16) {
+        return utf8_scan_scalar(data, len, out_count);
+    }
+#if defined(UTF8_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return utf8_scan_avx2(data, len, out_count);
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return utf8_scan_sse(data, len, out_count);
+    }
+#elif defined(UTF8_NEON)
+    return utf8_scan_neon(data, len, out_count);
+#endif
+    return utf8_scan_scalar(data, len, out_count);
+}
+
+bool rt_utf8_valid(const uint8_t* data, uint64_t len) {
+    if (len == 0) {
+        return true;
+    }
+    if (data == NULL) {
+        return false;
+    }
+    uint64_t count = 0;
+    return utf8_scan(data, len, &count);
+}
+
+uint64_t rt_utf8_count(const uint8_t* data, uint64_t len) {
+    if (data == NULL || len == 0) {
+        return 0;
+    }
+    uint64_t count = 0;
+    if (utf8_scan(data, len, &count)) {
+        return count;
+    }
+    return utf8_count_lenient(data, len);
+}
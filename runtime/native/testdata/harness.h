@@ -0,0 +1,62 @@
+#ifndef SURGE_RUNTIME_NATIVE_TESTDATA_HARNESS_H
+#define SURGE_RUNTIME_NATIVE_TESTDATA_HARNESS_H
+
+// Shared setup for the C harnesses that internal/vm tests link against the runtime sources.
+//
+// A harness includes the runtime header it drives and then this file, which defines the
+// symbols rt_entry.c and the generated program would otherwise provide. A harness that runs
+// real user tasks or blocking jobs defines HARNESS_POLL_CALL or HARNESS_BLOCKING_CALL before
+// the include and supplies its own dispatcher.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int rt_argc = 0;
+char** rt_argv_raw = NULL;
+
+#ifndef HARNESS_POLL_CALL
+void __surge_poll_call(uint64_t id) {
+    (void)id;
+}
+#endif
+
+#ifndef HARNESS_BLOCKING_CALL
+uint64_t __surge_blocking_call(uint64_t id, void* state) {
+    (void)id;
+    (void)state;
+    return 0;
+}
+#endif
+
+static inline int fail(const char* msg) {
+    if (msg != NULL) {
+        fputs(msg, stderr);
+        fputc('\n', stderr);
+    }
+    return 1;
+}
+
+#ifdef SURGE_RUNTIME_NATIVE_RT_ASYNC_INTERNAL_H
+// harness_task_new registers a bare user task with the next free id, the way task creation
+// does before a poll function is attached, so a harness can park and wake it by hand. The
+// caller holds the executor lock if other threads may touch ex->tasks.
+static inline rt_task* harness_task_new(rt_executor* ex, uint8_t status) {
+    uint64_t id = ex->next_id++;
+    ensure_task_cap(ex, id);
+    rt_task* task = (rt_task*)rt_alloc(sizeof(rt_task), _Alignof(rt_task));
+    if (task == NULL) {
+        return NULL;
+    }
+    memset(task, 0, sizeof(*task));
+    task->id = id;
+    task->kind = TASK_KIND_USER;
+    task_status_store(task, status);
+    atomic_store_explicit(&task->handle_refs, 1, memory_order_relaxed);
+    ex->tasks[id] = task;
+    return task;
+}
+#endif
+
+#endif
@@ -0,0 +1,127 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+fixture="$root/benchmarks/native/bignum_arith"
+report="${SURGE_BIGNUM_BENCH_REPORT:-$root/build/benchmarks/native-bignum.md}"
+repeats="${SURGE_BIGNUM_BENCH_REPEATS:-3}"
+karatsuba_values="${SURGE_BIGNUM_BENCH_KARATSUBA:-16 24 32 48 64}"
+toom3_values="${SURGE_BIGNUM_BENCH_TOOM3:-100 150 200 300 400}"
+bz_values="${SURGE_BIGNUM_BENCH_BZ:-32 48 64 96 128}"
+surge="${SURGE:-$root/surge}"
+
+fail() {
+	echo "bench_native_bignum: $*" >&2
+	exit 1
+}
+
+[[ "$repeats" =~ ^[1-9][0-9]*$ ]] || fail "SURGE_BIGNUM_BENCH_REPEATS must be a positive integer"
+
+if [[ ! -x "$surge" ]]; then
+	surge="$(command -v surge || true)"
+fi
+[[ -n "$surge" && -x "$surge" ]] || fail "surge binary not found; run 'make build' or set SURGE=/path/to/surge"
+command -v python3 >/dev/null || fail "python3 not found"
+
+export SURGE_STDLIB="${SURGE_BIGNUM_BENCH_STDLIB:-$root}"
+
+build_log="$(mktemp)"
+rows="$(mktemp)"
+trap 'rm -f "$build_log" "$rows"' EXIT
+
+if ! "$surge" build --release "$fixture" >"$build_log" 2>&1; then
+	cat "$build_log" >&2
+	fail "failed to build $fixture"
+fi
+
+built_path="$(awk '/^built / { print $2 }' "$build_log" | tail -n 1)"
+[[ -n "$built_path" ]] || fail "cannot find built binary in surge output"
+if [[ "$built_path" != /* ]]; then
+	if [[ -x "$root/$built_path" ]]; then
+		built_path="$root/$built_path"
+	else
+		built_path="$fixture/$built_path"
+	fi
+fi
+[[ -x "$built_path" ]] || fail "built binary not executable: $built_path"
+
+# Each sweep moves one threshold and leaves the others at their runtime defaults.
+run_sweep() {
+	local knob="$1"
+	local values="$2"
+	local value
+	for value in $values; do
+		[[ "$value" =~ ^[1-9][0-9]*$ ]] || fail "$knob values must be positive integers"
+		for i in $(seq 1 "$repeats"); do
+			out="$(env "$knob=$value" "$built_path")"
+			echo "$knob=$value run=$i"
+			echo "$out"
+			sed -n 's/^bignum op=\([a-z]*\) bits=\([0-9]*\) rounds=[0-9]* us=\([0-9]*\).*/\1 \2 \3/p' <<<"$out" |
+				while read -r op bits us; do
+					printf '%s %s %s %s %s\n' "$knob" "$value" "$op" "$bits" "$us" >>"$rows"
+				done
+		done
+	done
+}
+
+run_sweep SURGE_BIGNUM_KARATSUBA "$karatsuba_values"
+run_sweep SURGE_BIGNUM_TOOM3 "$toom3_values"
+run_sweep SURGE_BIGNUM_BZ "$bz_values"
+[[ -s "$rows" ]] || fail "cannot parse benchmark output"
+
+mkdir -p "$(dirname "$report")"
+python3 - "$rows" "$report" "$("$surge" version --full | tr '\n' ' ' | sed 's/[[:space:]]*$//')" "$repeats" <<'PY'
+import collections
+import datetime as dt
+import statistics
+import sys
+
+rows_path, report_path, surge_version, repeats = sys.argv[1:5]
+samples = collections.defaultdict(list)
+knobs = []
+values = collections.defaultdict(list)
+columns = []
+with open(rows_path, "r", encoding="utf-8") as f:
+    for line in f:
+        knob, value, op, bits, us = line.split()
+        value = int(value)
+        key = (op, int(bits))
+        samples[(knob, value, key)].append(int(us))
+        if knob not in knobs:
+            knobs.append(knob)
+        if value not in values[knob]:
+            values[knob].append(value)
+        if key not in columns:
+            columns.append(key)
+
+best = []
+with open(report_path, "w", encoding="utf-8") as f:
+    generated = dt.datetime.now(dt.timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+    f.write("# Native bignum threshold sweep\n\n")
+    f.write(f"Generated: {generated}\n\n")
+    f.write("## Environment\n\n")
+    f.write(f"- surge: {surge_version}\n")
+    f.write("- fixture: benchmarks/native/bignum_arith\n")
+    f.write(f"- repeats: {repeats}\n\n")
+    f.write("Thresholds are in 64-bit words. Cells are median microseconds per fixture row.\n\n")
+    for knob in knobs:
+        f.write(f"## {knob}\n\n")
+        f.write("| value | " + " | ".join(f"{op} {bits}b" for op, bits in columns) + " | total |\n")
+        f.write("| ---: |" + " ---: |" * (len(columns) + 1) + "\n")
+        totals = {}
+        for value in values[knob]:
+            cells = []
+            total = 0
+            for key in columns:
+                vals = samples.get((knob, value, key))
+                median = statistics.median(vals) if vals else 0
+                total += median
+                cells.append(f"{median:.0f}")
+            totals[value] = total
+            f.write(f"| {value} | " + " | ".join(cells) + f" | {total:.0f} |\n")
+        winner = min(totals, key=totals.get)
+        best.append(f"{knob}={winner}")
+        f.write(f"\nFastest total: {knob}={winner}\n\n")
+
+print(" ".join(best) + f" report={report_path}")
+PY
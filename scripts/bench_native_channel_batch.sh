@@ -0,0 +1,108 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+fixture="$root/benchmarks/native/channel_batch"
+report="${SURGE_CHANNEL_BATCH_BENCH_REPORT:-$root/build/benchmarks/native-channel-batch.md}"
+repeats="${SURGE_CHANNEL_BATCH_BENCH_REPEATS:-3}"
+threads="${SURGE_CHANNEL_BATCH_BENCH_THREADS:-1 4}"
+surge="${SURGE:-$root/surge}"
+
+fail() {
+	echo "bench_native_channel_batch: $*" >&2
+	exit 1
+}
+
+[[ "$repeats" =~ ^[1-9][0-9]*$ ]] || fail "SURGE_CHANNEL_BATCH_BENCH_REPEATS must be a positive integer"
+
+if [[ ! -x "$surge" ]]; then
+	surge="$(command -v surge || true)"
+fi
+[[ -n "$surge" && -x "$surge" ]] || fail "surge binary not found; run 'make build' or set SURGE=/path/to/surge"
+command -v python3 >/dev/null || fail "python3 not found"
+
+export SURGE_STDLIB="${SURGE_CHANNEL_BATCH_BENCH_STDLIB:-$root}"
+
+build_log="$(mktemp)"
+rows="$(mktemp)"
+trap 'rm -f "$build_log" "$rows"' EXIT
+
+if ! "$surge" build --release "$fixture" >"$build_log" 2>&1; then
+	cat "$build_log" >&2
+	fail "failed to build $fixture"
+fi
+
+built_path="$(awk '/^built / { print $2 }' "$build_log" | tail -n 1)"
+[[ -n "$built_path" ]] || fail "cannot find built binary in surge output"
+if [[ "$built_path" != /* ]]; then
+	if [[ -x "$root/$built_path" ]]; then
+		built_path="$root/$built_path"
+	else
+		built_path="$fixture/$built_path"
+	fi
+fi
+[[ -x "$built_path" ]] || fail "built binary not executable: $built_path"
+
+for n in $threads; do
+	[[ "$n" =~ ^[1-9][0-9]*$ ]] || fail "SURGE_CHANNEL_BATCH_BENCH_THREADS values must be positive integers"
+	for i in $(seq 1 "$repeats"); do
+		out="$(SURGE_THREADS="$n" "$built_path")"
+		echo "SURGE_THREADS=$n run=$i"
+		echo "$out"
+		grep -q 'checksum mismatch' <<<"$out" && fail "fixture reported a checksum mismatch"
+		sed -n 's/^channel_batch mode=\([a-z_]*\) capacity=\([0-9]*\) producers=\([0-9]*\) values=\([0-9]*\) us=\([0-9]*\).*/\1 \2 \3 \4 \5/p' <<<"$out" |
+			while read -r mode capacity producers values us; do
+				printf '%s %s %s %s %s %s\n' "$n" "$mode" "$capacity" "$producers" "$values" "$us" >>"$rows"
+			done
+	done
+done
+[[ -s "$rows" ]] || fail "cannot parse benchmark output"
+
+mkdir -p "$(dirname "$report")"
+python3 - "$rows" "$report" "$("$surge" version --full | tr '\n' ' ' | sed 's/[[:space:]]*$//')" "$repeats" <<'PY'
+import collections
+import datetime as dt
+import statistics
+import sys
+
+rows_path, report_path, surge_version, repeats = sys.argv[1:5]
+samples = collections.defaultdict(list)
+shapes = []
+values = {}
+with open(rows_path, "r", encoding="utf-8") as f:
+    for line in f:
+        threads, mode, capacity, producers, count, us = line.split()
+        shape = (int(threads), int(capacity), int(producers))
+        samples[(shape, mode)].append(int(us))
+        values[shape] = int(count)
+        if shape not in shapes:
+            shapes.append(shape)
+
+with open(report_path, "w", encoding="utf-8") as f:
+    generated = dt.datetime.now(dt.timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+    f.write("# Native channel batch benchmark\n\n")
+    f.write(f"Generated: {generated}\n\n")
+    f.write("## Environment\n\n")
+    f.write(f"- surge: {surge_version}\n")
+    f.write("- fixture: benchmarks/native/channel_batch\n")
+    f.write(f"- repeats: {repeats}\n\n")
+    f.write("`single` receives every value with a blocking recv. `batch` receives the first\n")
+    f.write("value of each batch with recv and drains the rest with `try_recv_many`.\n")
+    f.write("`send_many` drains the same way and also sends in batches with `send_many`.\n")
+    f.write("Cells are median nanoseconds per value; speedups are against `single`.\n\n")
+    f.write("| threads | capacity | producers | single | batch | send_many | batch speedup | send_many speedup |\n")
+    f.write("| ---: | ---: | ---: | ---: | ---: | ---: | ---: | ---: |\n")
+    for shape in shapes:
+        cells = []
+        for mode in ("single", "batch", "send_many"):
+            vals = samples.get((shape, mode))
+            cells.append(statistics.median(vals) * 1000 / values[shape] if vals else 0)
+        speedups = [f"{cells[0] / cell:.2f}x" if cells[0] and cell else "n/a" for cell in cells[1:]]
+        threads, capacity, producers = shape
+        f.write(
+            f"| {threads} | {capacity} | {producers} | {cells[0]:.1f} | {cells[1]:.1f} | {cells[2]:.1f} "
+            f"| {speedups[0]} | {speedups[1]} |\n"
+        )
+
+print(f"report={report_path}")
+PY
@@ -0,0 +1,115 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+report="${SURGE_LTO_BENCH_REPORT:-$root/build/benchmarks/native-lto.md}"
+repeats="${SURGE_LTO_BENCH_REPEATS:-5}"
+lto="${SURGE_LTO_BENCH_MODE:-thin}"
+fixtures="${SURGE_LTO_BENCH_FIXTURES:-byte_ranges channel_request_reply}"
+surge="${SURGE:-$root/surge}"
+
+fail() {
+	echo "bench_native_lto: $*" >&2
+	exit 1
+}
+
+[[ "$repeats" =~ ^[1-9][0-9]*$ ]] || fail "SURGE_LTO_BENCH_REPEATS must be a positive integer"
+[[ "$lto" == "thin" || "$lto" == "full" ]] || fail "SURGE_LTO_BENCH_MODE must be thin or full"
+
+if [[ ! -x "$surge" ]]; then
+	surge="$(command -v surge || true)"
+fi
+[[ -n "$surge" && -x "$surge" ]] || fail "surge binary not found; run 'make build' or set SURGE=/path/to/surge"
+command -v python3 >/dev/null || fail "python3 not found"
+
+export SURGE_STDLIB="${SURGE_LTO_BENCH_STDLIB:-$root}"
+
+work="$(mktemp -d)"
+rows="$work/rows"
+trap 'rm -rf "$work"' EXIT
+
+# build_fixture <fixture> <mode> copies the binary out of target/ so the next
+# build of the same fixture does not overwrite it.
+build_fixture() {
+	local fixture="$1"
+	local mode="$2"
+	local dir="$root/benchmarks/native/$fixture"
+	local log="$work/$fixture-$mode.log"
+	if ! "$surge" build --release "--lto=$mode" "$dir" >"$log" 2>&1; then
+		cat "$log" >&2
+		fail "failed to build $fixture with --lto=$mode"
+	fi
+	local built_path
+	built_path="$(awk '/^built / { print $2 }' "$log" | tail -n 1)"
+	[[ -n "$built_path" ]] || fail "cannot find built binary in surge output"
+	if [[ "$built_path" != /* ]]; then
+		if [[ -x "$root/$built_path" ]]; then
+			built_path="$root/$built_path"
+		else
+			built_path="$dir/$built_path"
+		fi
+	fi
+	[[ -x "$built_path" ]] || fail "built binary not executable: $built_path"
+	cp "$built_path" "$work/$fixture-$mode"
+}
+
+for fixture in $fixtures; do
+	build_fixture "$fixture" off
+	build_fixture "$fixture" "$lto"
+	for i in $(seq 1 "$repeats"); do
+		for mode in off "$lto"; do
+			out="$("$work/$fixture-$mode")"
+			echo "$fixture lto=$mode run=$i"
+			echo "$out"
+			# byte_ranges prints name_us=N; channel_request_reply prints | name | iterations | us | ns/op |.
+			{
+				sed -n 's/^\([a-z_]*\)_us=\([0-9][0-9]*\).*/\1 \2/p' <<<"$out"
+				sed -n 's/^| \([a-z_]*\) | [0-9][0-9]* | \([0-9][0-9]*\) | [0-9-]* |$/\1 \2/p' <<<"$out"
+			} | while read -r metric us; do
+				printf '%s %s %s %s\n' "$fixture" "$metric" "$mode" "$us" >>"$rows"
+			done
+		done
+	done
+done
+[[ -s "$rows" ]] || fail "cannot parse benchmark output"
+
+mkdir -p "$(dirname "$report")"
+python3 - "$rows" "$report" "$("$surge" version --full | tr '\n' ' ' | sed 's/[[:space:]]*$//')" "$repeats" "$lto" <<'PY'
+import collections
+import datetime as dt
+import statistics
+import sys
+
+rows_path, report_path, surge_version, repeats, lto = sys.argv[1:6]
+samples = collections.defaultdict(list)
+metrics = []
+with open(rows_path, "r", encoding="utf-8") as f:
+    for line in f:
+        fixture, metric, mode, us = line.split()
+        samples[(fixture, metric, mode)].append(int(us))
+        if (fixture, metric) not in metrics:
+            metrics.append((fixture, metric))
+
+with open(report_path, "w", encoding="utf-8") as f:
+    generated = dt.datetime.now(dt.timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+    f.write("# Native LTO benchmark\n\n")
+    f.write(f"Generated: {generated}\n\n")
+    f.write("## Environment\n\n")
+    f.write(f"- surge: {surge_version}\n")
+    f.write(f"- lto: {lto}\n")
+    f.write(f"- repeats: {repeats}\n\n")
+    f.write("Cells are median microseconds per fixture row.\n\n")
+    f.write(f"| fixture | row | default us | lto={lto} us | speedup |\n")
+    f.write("| --- | --- | ---: | ---: | ---: |\n")
+    for fixture, metric in metrics:
+        base = samples.get((fixture, metric, "off"))
+        opt = samples.get((fixture, metric, lto))
+        if not base or not opt:
+            continue
+        b = statistics.median(base)
+        o = statistics.median(opt)
+        speedup = f"{b / o:.2f}x" if o else "n/a"
+        f.write(f"| {fixture} | {metric} | {b:.0f} | {o:.0f} | {speedup} |\n")
+
+print(f"report={report_path}")
+PY